@@ -10,6 +10,14 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/qgemm.cpp
   ${MLAS_SRC_DIR}/qdwconv.cpp
   ${MLAS_SRC_DIR}/convolve.cpp
+  ${MLAS_SRC_DIR}/convolve_winograd.cpp
+  ${MLAS_SRC_DIR}/layernorm.cpp
+  ${MLAS_SRC_DIR}/flashattn.cpp
+  ${MLAS_SRC_DIR}/halfgemm.cpp
+  ${MLAS_SRC_DIR}/sqnbitgemm.cpp
+  ${MLAS_SRC_DIR}/sparsegemm.cpp
+  ${MLAS_SRC_DIR}/gelu.cpp
+  ${MLAS_SRC_DIR}/reduce.cpp
   ${MLAS_SRC_DIR}/convsym.cpp
   ${MLAS_SRC_DIR}/pooling.cpp
   ${MLAS_SRC_DIR}/transpose.cpp
@@ -127,6 +135,11 @@ function(setup_mlas_source_for_windows)
       ${MLAS_SRC_DIR}/qgemm_kernel_sse.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_sse41.cpp
       ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/layernorm_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/cvtfp16_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/sparsegemm_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/gelu_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/reduce_avx512f.cpp
       ${MLAS_SRC_DIR}/amd64/QgemmU8S8KernelAvx2.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8U8KernelAvx2.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8X8KernelAvx2.asm
@@ -453,8 +466,15 @@ else()
           ${MLAS_SRC_DIR}/x86_64/ErfKernelFma3.S
           ${MLAS_SRC_DIR}/intrinsics/avx2/qladd_avx2.cpp
           ${MLAS_SRC_DIR}/intrinsics/avx2/qdwconv_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/layernorm_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/cvtfp16_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/sqnbitgemm_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/sparsegemm_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/gelu_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/reduce_avx2.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
+        set_source_files_properties(${MLAS_SRC_DIR}/intrinsics/avx2/cvtfp16_avx2.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mfma -mf16c")
 
         set(mlas_platform_srcs_avx512f
           ${MLAS_SRC_DIR}/x86_64/DgemmKernelAvx512F.S
@@ -463,6 +483,11 @@ else()
           ${MLAS_SRC_DIR}/x86_64/SpoolKernelAvx512F.S
           ${MLAS_SRC_DIR}/x86_64/TransKernelAvx512F.S
           ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/layernorm_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/cvtfp16_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/sparsegemm_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/gelu_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/reduce_avx512f.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
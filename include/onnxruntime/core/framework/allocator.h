@@ -17,20 +17,26 @@ struct OrtArenaCfg {
                   arena_extend_strategy(-1),
                   initial_chunk_size_bytes(-1),
                   max_dead_bytes_per_chunk(-1),
-                  initial_growth_chunk_size_bytes(-1) {}
+                  initial_growth_chunk_size_bytes(-1),
+                  thread_local_cache_bytes(-1),
+                  thread_local_cache_max_alloc_bytes(-1) {}
   OrtArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
               int max_dead_bytes_per_chunk, int initial_growth_chunk_size_bytes)
       : max_mem(max_mem),
         arena_extend_strategy(arena_extend_strategy),
         initial_chunk_size_bytes(initial_chunk_size_bytes),
         max_dead_bytes_per_chunk(max_dead_bytes_per_chunk),
-        initial_growth_chunk_size_bytes(initial_growth_chunk_size_bytes) {}
+        initial_growth_chunk_size_bytes(initial_growth_chunk_size_bytes),
+        thread_local_cache_bytes(-1),
+        thread_local_cache_max_alloc_bytes(-1) {}
 
   size_t max_mem;                       // use 0 to allow ORT to choose the default
   int arena_extend_strategy;            // use -1 to allow ORT to choose the default, 0 = kNextPowerOfTwo, 1 = kSameAsRequested
   int initial_chunk_size_bytes;         // use -1 to allow ORT to choose the default
   int max_dead_bytes_per_chunk;         // use -1 to allow ORT to choose the default
   int initial_growth_chunk_size_bytes;  // use -1 to allow ORT to choose the default
+  int thread_local_cache_bytes;            // use -1 to allow ORT to choose the default (disabled), 0 = disabled
+  int thread_local_cache_max_alloc_bytes;  // use -1 to allow ORT to choose the default
 };
 
 namespace onnxruntime {
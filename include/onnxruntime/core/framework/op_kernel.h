@@ -116,6 +116,22 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to let the pre-packed buffers of a constant initializer that PrePack() produced in an
+  // earlier session be used without calling PrePack(), e.g. when they were saved with the session cache.
+  // PrePack() is not called on this kernel for the tensor in that case, so the kernel has to set the state PrePack()
+  // would have set other than the buffers, which are then passed to UseSharedPrePackedBuffers().
+  // @param tensor: The initialized constant tensor the buffers were packed from
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param buffer_sizes: The sizes of the saved buffers, in the order PrePack() stored them
+  // @param can_use_saved_buffers: Set it to true if the kernel can use saved buffers of these sizes. The kernel must
+  //                               not change its state if it sets it to false, as PrePack() is called instead.
+  virtual Status PrepareForSavedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                                 const std::vector<size_t>& /*buffer_sizes*/,
+                                                 /*out*/ bool& can_use_saved_buffers) {
+    can_use_saved_buffers = false;
+    return Status::OK();
+  }
+
   const OrtMemoryInfo& Allocator(int id, OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
@@ -202,6 +202,12 @@ class OpKernelContext {
     return true;
   }
 
+  /**
+  Returns the number of output tensors of this node allocated from an allocator rather than placed in a buffer of the
+  memory pattern so far.
+  */
+  size_t NumDynamicAllocations() const { return num_dynamic_allocations_; }
+
  protected:
 
   OpKernelContext(concurrency::ThreadPool* threadpool, const logging::Logger& logger);
@@ -236,6 +242,8 @@ class OpKernelContext {
   int node_input_start_index_{-1};
   int node_implicit_input_start_index_{-1};
   int node_output_start_index_{-1};
+
+  size_t num_dynamic_allocations_{0};
 };
 
 // Fetching output tensor without shape is not allowed except when it already exists
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/framework/config_options.h"
 #include "core/framework/execution_provider.h"
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/ort_value.h"
@@ -12,6 +13,10 @@
 
 namespace onnxruntime {
 
+namespace concurrency {
+class ThreadPool;
+}
+
 class OrtValueNameIdxMap;
 class FuncManager;
 class DataTransferManager;
@@ -26,7 +31,9 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
                         const IExecutionProvider& execution_provider,
                         const std::unordered_map<int, OrtValue>& constant_initialized_tensors,
                         const OrtValueNameIdxMap& mlvalue_name_idx_map,
-                        const DataTransferManager& data_transfer_mgr);
+                        const DataTransferManager& data_transfer_mgr,
+                        const ConfigOptions& config_options,
+                        concurrency::ThreadPool* thread_pool = nullptr);
 
   OpKernelInfo(const OpKernelInfo& other);
 
@@ -40,6 +47,12 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
 
   const DataTransferManager& GetDataTransferManager() const noexcept;
 
+  // The config options of the session creating the kernel.
+  const ConfigOptions& GetConfigOptions() const noexcept;
+
+  // The intra-op thread pool of the session creating the kernel. May be null.
+  concurrency::ThreadPool* GetThreadPool() const noexcept;
+
   const onnxruntime::Node& node() const noexcept;
 
   bool TryGetConstantInput(int input_index, const Tensor** constant_input_value) const;
@@ -56,6 +69,8 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
   const std::unordered_map<int, OrtValue>& constant_initialized_tensors_;
   const OrtValueNameIdxMap& ort_value_name_idx_map_;
   const DataTransferManager& data_transfer_mgr_;
+  const ConfigOptions& config_options_;
+  concurrency::ThreadPool* const thread_pool_;
   ProtoHelperNodeContext proto_helper_context_;
 };
 
@@ -7,6 +7,8 @@
 #include <atomic>
 #include "core/session/onnxruntime_c_api.h"
 #include "core/framework/config_options.h"
+#include "core/framework/ortdevice.h"
+#include "core/framework/ortmemoryinfo.h"
 
 /**
  * Configuration information for a Run call.
@@ -27,6 +29,13 @@ struct OrtRunOptions {
   // So it is possible that only some of the nodes are executed.
   bool only_execute_path_to_fetches = false;
 
+  // Optional caller owned buffer on scratch_buffer_location. It is used in place of the buffer a Run allocates for
+  // the intermediate tensors that the memory pattern places on that location. The Run fails if it is too small.
+  // Set with OrtApis::RunOptionsSetScratchBuffer.
+  void* scratch_buffer = nullptr;
+  size_t scratch_buffer_size = 0;
+  OrtMemoryInfo scratch_buffer_location;
+
 #ifdef ENABLE_TRAINING
   // Set to 'true' to run in training mode.
   bool training_mode = true;
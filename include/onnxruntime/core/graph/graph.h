@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <limits>
 #include <memory>
 #include <string>
@@ -610,6 +611,11 @@ class Node {
 
   // Reference to the function template defined in the model.
   const FunctionTemplate* func_template_ = nullptr;
+
+  // Summaries of what the type and shape inference of this node read from its inputs and outputs when it last
+  // succeeded, or empty. Resolve skips the inference while the summaries stay the same.
+  std::string inference_inputs_summary_;
+  std::string inference_outputs_summary_;
 #endif
 
   // Execution priority, lower value for higher priority
@@ -1002,6 +1008,23 @@ class Graph {
   destination Node must execute after the source node. The control edge allows this ordering to occur.
   */
   bool AddControlEdge(NodeIndex src_node_index, NodeIndex dst_node_index);
+
+  /** Function called with the graph and the index of a Node that was added to it or removed from it,
+  or whose edges were added or removed. */
+  using NodeChangeRecorder = std::function<void(const Graph& graph, NodeIndex node_index)>;
+
+  /** Sets the function recording the changes to the Nodes of this Graph and of its subgraphs, or clears it if empty.
+  Set it on the main graph. The edges rebuilt by Resolve are not recorded. */
+  void SetNodeChangeRecorder(NodeChangeRecorder recorder) {
+    node_change_recorder_ = std::move(recorder);
+  }
+
+  /** Sets whether Resolve skips the type and shape inference of unchanged nodes even if
+  ResolveOptions::skip_unchanged_inference is false, so that it also applies to the Resolve calls made with the
+  default options, e.g. by the graph transformers. Set it on the main graph. */
+  void SetSkipUnchangedInference(bool skip_unchanged_inference) noexcept {
+    skip_unchanged_inference_ = skip_unchanged_inference;
+  }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
   /** Mark the Graph as needing Resolve() to be called.
@@ -1249,6 +1272,12 @@ class Graph {
     // Whether to set that no proto sync is required after resolving.
     // Useful for resolving right after loading from a GraphProto.
     bool no_proto_sync_required = false;
+    // Whether to skip the type and shape inference of the nodes for which nothing it reads changed since it last
+    // ran. Changes are detected by comparing a summary of the bytes the inference reads, so only the nodes whose
+    // inputs changed and the nodes downstream of them are inferred again. The summaries are kept on the nodes and
+    // include the data of small constant initializer inputs. Off by default, which runs the inference of every node.
+    // See also SetSkipUnchangedInference.
+    bool skip_unchanged_inference = false;
   };
 
   /**
@@ -1538,6 +1567,11 @@ class Graph {
   // @returns false if node_index was invalid.
   bool ReleaseNode(NodeIndex node_index);
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // Passes the node of this graph to the node change recorder of the main graph, if set.
+  void RecordNodeChange(NodeIndex node_index) const;
+#endif
+
   Node& CreateFusedSubGraphNode(const IndexedSubGraph& sub_graph, const std::string& fused_node_name);
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
@@ -1586,6 +1620,15 @@ class Graph {
   // in some case, a fused sub-graph will happens multiple times in one model, we use a map
   // to store reusable-schema in lookup.
   InlinedHashMap<std::string, std::reference_wrapper<ONNX_NAMESPACE::OpSchema>> reusable_fused_schema_map_;
+
+  // op schemas found in schema_registry_, keyed by domain, op type and opset version.
+  InlinedHashMap<std::string, const ONNX_NAMESPACE::OpSchema*> op_schema_cache_;
+
+  // records the changes to the nodes of this graph and its subgraphs. only set on the main graph.
+  NodeChangeRecorder node_change_recorder_;
+
+  // see SetSkipUnchangedInference. only set on the main graph.
+  bool skip_unchanged_inference_ = false;
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
   // Graph nodes.
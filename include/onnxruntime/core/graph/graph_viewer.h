@@ -36,6 +36,15 @@ class GraphViewer {
   */
   explicit GraphViewer(const Graph& graph, const IndexedSubGraph& filter_info);
 
+  /** Tag to construct a GraphViewer that does not sort the nodes. */
+  struct UnorderedTag {};
+
+  /**
+  Construct a GraphViewer from the provided Graph instance without sorting the nodes, to look up nodes and
+  initializers when only a few nodes are visited. GetNodesInTopologicalOrder and GetRootNodes return no nodes.
+  */
+  GraphViewer(const Graph& graph, UnorderedTag);
+
   /** Gets the Graph name. */
   const std::string& Name() const noexcept;
 
@@ -193,7 +202,7 @@ class GraphViewer {
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphViewer);
-  GraphViewer(const Graph& graph, const IndexedSubGraph* filter_info);
+  GraphViewer(const Graph& graph, const IndexedSubGraph* filter_info, bool sort_nodes = true);
 
   const Graph* graph_;
   ConstGraphNodes graph_nodes_;
@@ -3,6 +3,7 @@
 
 #pragma once
 #include <string>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/inlined_containers.h"
@@ -11,6 +12,10 @@
 
 namespace onnxruntime {
 
+/** Nodes of a graph and of its subgraphs, keyed by the graph they belong to.
+The graphs that contain a subgraph with nodes have an entry too, which may be empty. */
+using NodesToVisit = InlinedHashMap<const Graph*, InlinedHashSet<NodeIndex>>;
+
 /**
 @class GraphTransformer
 
@@ -40,8 +45,23 @@ class GraphTransformer {
   */
   common::Status Apply(Graph& graph, bool& modified, const logging::Logger& logger) const;
 
+  /** Apply the transformation where it may match because the given nodes of the Graph or of its subgraphs changed.
+  Transformers that do not look for matches node by node apply the transformation to the whole Graph.
+  @param[out] modified Set to true if the Graph was modified.
+  @returns Status with success or error information.
+  */
+  common::Status ApplyToNodes(Graph& graph, const NodesToVisit& nodes, bool& modified,
+                              const logging::Logger& logger) const;
+
   virtual bool ShouldOnlyApplyOnce() const { return false; }
 
+  /** Gets the op types of the nodes this transformer looks for matches at. A match may involve the nodes within
+  MatchRadius edges of such a node, but no node further away. Empty if matches may start at nodes of any op type. */
+  virtual std::vector<std::string> TargetOpTypes() const { return {}; }
+
+  /** Gets the number of edges between the node a match starts at and the node of the match furthest from it. */
+  virtual int MatchRadius() const { return 2; }
+
  protected:
   /** Helper method to call ApplyImpl on any subgraphs in the Node. */
   common::Status Recurse(Node& node, bool& modified, int graph_level, const logging::Logger& logger) const {
@@ -54,6 +74,20 @@ class GraphTransformer {
     return Status::OK();
   }
 
+  /** Helper method to call ApplyToNodesImpl on the subgraphs in the Node that have nodes to visit. */
+  common::Status RecurseToNodes(Node& node, const NodesToVisit& nodes, bool& modified, int graph_level,
+                                const logging::Logger& logger) const {
+    int subgraph_level = ++graph_level;
+    for (auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+      auto& subgraph = *entry.second;
+      if (nodes.find(&subgraph) != nodes.end()) {
+        ORT_RETURN_IF_ERROR(ApplyToNodesImpl(subgraph, nodes, modified, subgraph_level, logger));
+      }
+    }
+
+    return Status::OK();
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphTransformer);
 
@@ -67,6 +101,14 @@ class GraphTransformer {
   virtual common::Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger)
       const = 0;
 
+  // Apply the transform only at the given nodes of the graph, and call RecurseToNodes for the Nodes with subgraphs.
+  // The default applies the transform to the whole graph.
+  virtual common::Status ApplyToNodesImpl(Graph& graph, const NodesToVisit& nodes, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+    ORT_UNUSED_PARAMETER(nodes);
+    return ApplyImpl(graph, modified, graph_level, logger);
+  }
+
   const std::string name_;
   const InlinedHashSet<std::string_view> compatible_provider_types_;
 };
@@ -53,6 +53,9 @@ class RuleBasedGraphTransformer : public GraphTransformer {
   /** Returns the total number of rules that are registered in this transformer. */
   size_t RulesCount() const;
 
+  /** Gets the op types the rules are registered for, or none if a rule is evaluated on nodes of any op type. */
+  std::vector<std::string> TargetOpTypes() const override;
+
  protected:
   /** Applies the given set of rewrite rules on the Node of this Graph.
       @param[in] graph The Graph.
@@ -77,6 +80,14 @@ class RuleBasedGraphTransformer : public GraphTransformer {
 
   // Performs a single top-down traversal of the graph and applies all registered rules.
   common::Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  // Same as ApplyImpl, but only applies the rules to the given nodes.
+  common::Status ApplyToNodesImpl(Graph& graph, const NodesToVisit& nodes, bool& modified, int graph_level,
+                                  const logging::Logger& logger) const override;
+
+  // Applies the rules to the nodes of the graph in topological order, or only to the given nodes if not null.
+  common::Status ApplyRules(Graph& graph, const NodesToVisit* nodes, bool& modified, int graph_level,
+                            const logging::Logger& logger) const;
 };
 
 }  // namespace onnxruntime
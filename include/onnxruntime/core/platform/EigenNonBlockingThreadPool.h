@@ -32,7 +32,9 @@
 #pragma warning(disable : 4127)
 #pragma warning(disable : 4805)
 #endif
+#include <algorithm>
 #include <memory>
+#include <vector>
 #include "unsupported/Eigen/CXX11/ThreadPool"
 
 #if defined(__GNUC__)
@@ -329,6 +331,9 @@ class ExtendedThreadPoolInterface : public Eigen::ThreadPoolInterface {
   // two loops execute in series in a parallel section. ]
   virtual void RunInParallel(std::function<void(unsigned idx)> fn,
                              unsigned n, std::ptrdiff_t block_size) = 0;
+
+  // Schedule fn on the queue of the calling thread if it is one of the pool's workers.
+  virtual void ScheduleLocal(std::function<void()> fn) = 0;
   virtual void StartProfiling() = 0;
   virtual std::string StopProfiling() = 0;
 };
@@ -750,6 +755,26 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       ComputeCoprimes(i, &all_coprimes_.back());
     }
 
+    // Group the workers by NUMA node if they span more than one node.
+    if (thread_options.numa_nodes.size() >= num_threads_) {
+      int max_node = 0;
+      for (auto i = 0u; i < num_threads_; i++) {
+        max_node = std::max(max_node, thread_options.numa_nodes[i]);
+      }
+      std::vector<int> worker_node(num_threads_);
+      std::vector<std::vector<unsigned>> node_workers(static_cast<size_t>(max_node) + 1);
+      for (auto i = 0u; i < num_threads_; i++) {
+        // a thread with an unknown node is treated as being on node 0
+        worker_node[i] = std::max(thread_options.numa_nodes[i], 0);
+        node_workers[worker_node[i]].push_back(i);
+      }
+      if (std::count_if(node_workers.begin(), node_workers.end(),
+                        [](const std::vector<unsigned>& workers) { return !workers.empty(); }) > 1) {
+        worker_node_ = std::move(worker_node);
+        node_workers_ = std::move(node_workers);
+      }
+    }
+
     worker_data_.resize(num_threads_);
     for (auto i = 0u; i < num_threads_; i++) {
       worker_data_[i].thread.reset(env_.CreateThread(name, i, WorkerLoop, this, thread_options));
@@ -788,6 +813,32 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     }
   }
 
+  // As Schedule(fn), except that work scheduled from one of this pool's own workers is
+  // pushed onto that worker's queue, keeping it local to the producer (e.g., a node's
+  // consumers in the DataflowExecutor).  Another worker, on the same node if it has one,
+  // is woken so that it can steal the work if the producer stays busy.  Work scheduled
+  // from outside the pool goes to a random queue as with Schedule(fn).
+
+  void ScheduleLocal(std::function<void()> fn) override {
+    PerThread* pt = GetPerThread();
+    if (pt->pool != this) {
+      Schedule(std::move(fn));
+      return;
+    }
+
+    Queue& q = worker_data_[pt->thread_id].queue;
+    fn = q.PushBack(std::move(fn));
+    if (!fn) {
+      // The queue accepted the work; ensure that another thread can pick it up
+      if (num_threads_ > 1) {
+        worker_data_[RandomOtherWorker(pt)].EnsureAwake();
+      }
+    } else {
+      // Run the work directly if the queue rejected the work
+      fn();
+    }
+  }
+
   //......................................................................
   //
   // Parallel sections
@@ -1281,6 +1332,21 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return -1;
   }
 
+  // One more than the largest NUMA node id of the workers if they span more than one node, or 1 otherwise.
+  int NumNumaNodes() const {
+    return node_workers_.empty() ? 1 : static_cast<int>(node_workers_.size());
+  }
+
+  // Returns the NUMA node of the calling thread if it is a worker of this pool and the pool spans more than one
+  // node. Returns -1 otherwise.
+  int CurrentNumaNode() const {
+    const int thread_id = CurrentThreadId();
+    if (thread_id == -1 || worker_node_.empty()) {
+      return -1;
+    }
+    return worker_node_[thread_id];
+  }
+
   void EnableSpinning() {
     spin_loop_status_ = SpinLoopStatus::kBusy;
   }
@@ -1453,6 +1519,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   const bool set_denormal_as_zero_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
+  // NUMA node of each worker and the workers of each node. Both are empty unless the workers span more than one node.
+  std::vector<int> worker_node_;
+  std::vector<std::vector<unsigned>> node_workers_;
   std::atomic<unsigned> blocked_;  // Count of blocked workers, used as a termination condition
   std::atomic<bool> done_;
 
@@ -1602,10 +1671,29 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   // is that the thread is busy with other work, and we will avoid
   // "snatching" work from a thread which is just about to notice the
   // work itself.
+  //
+  // If the workers span more than one NUMA node, the workers of the
+  // thief's node are tried first, as their work is more likely to use
+  // memory local to the node.  A TRY_ONE attempt only tries a worker
+  // of the same node, and a TRY_ALL attempt falls back to the workers
+  // of all the nodes.
 
   Task Steal(StealAttemptKind steal_kind) {
     PerThread* pt = GetPerThread();
-    unsigned size = num_threads_;
+    if (!node_workers_.empty()) {
+      const std::vector<unsigned>& local_workers = node_workers_[worker_node_[pt->thread_id]];
+      Task t = StealFromWorkers(pt, local_workers.data(), static_cast<unsigned>(local_workers.size()), steal_kind);
+      if (t || steal_kind == StealAttemptKind::TRY_ONE) {
+        return t;
+      }
+    }
+
+    return StealFromWorkers(pt, nullptr, num_threads_, steal_kind);
+  }
+
+  // Tries to steal from the workers with the given indices, or from
+  // workers [0, size) if workers is null.
+  Task StealFromWorkers(PerThread* pt, const unsigned* workers, unsigned size, StealAttemptKind steal_kind) {
     unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
     unsigned r = Rand(&pt->rand);
     unsigned inc = all_coprimes_[size - 1][r % all_coprimes_[size - 1].size()];
@@ -1613,8 +1701,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
     for (unsigned i = 0; i < num_attempts; i++) {
       assert(victim < size);
-      if (worker_data_[victim].GetStatus() == WorkerData::ThreadStatus::Active) {
-        Task t = worker_data_[victim].queue.PopBack();
+      WorkerData& td = worker_data_[workers ? workers[victim] : victim];
+      if (td.GetStatus() == WorkerData::ThreadStatus::Active) {
+        Task t = td.queue.PopBack();
         if (t) {
           return t;
         }
@@ -1628,6 +1717,24 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return Task();
   }
 
+  // Returns a random worker other than the calling worker, preferring the
+  // workers on its NUMA node.  Falls back to the other workers of the pool
+  // if the calling worker is alone on its node.  Requires num_threads_ > 1.
+  unsigned RandomOtherWorker(PerThread* pt) {
+    const unsigned self = static_cast<unsigned>(pt->thread_id);
+    if (!node_workers_.empty()) {
+      const std::vector<unsigned>& local_workers = node_workers_[worker_node_[self]];
+      const unsigned size = static_cast<unsigned>(local_workers.size());
+      if (size > 1) {
+        // draw from all but the last worker, standing in the last one for the caller
+        unsigned victim = local_workers[Rand(&pt->rand) % (size - 1)];
+        return victim == self ? local_workers[size - 1] : victim;
+      }
+    }
+    unsigned victim = Rand(&pt->rand) % (num_threads_ - 1);
+    return victim == self ? num_threads_ - 1 : victim;
+  }
+
   int NonEmptyQueueIndex() {
     PerThread* pt = GetPerThread();
     const unsigned size = static_cast<unsigned>(worker_data_.size());
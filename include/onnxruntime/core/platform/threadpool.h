@@ -235,6 +235,18 @@ class ThreadPool {
     }
   }
 
+  // As Schedule, except that fn() is queued on the calling thread's own queue if the caller is one of the
+  // pool's threads, from where other threads can steal it.  This keeps work that consumes the caller's
+  // results on the same thread, e.g. the ready consumers of a node in the dataflow executor.
+  static void ScheduleLocal(ThreadPool* tp,
+                            std::function<void()> fn) {
+    if (tp) {
+      tp->ScheduleLocal(fn);
+    } else {
+      fn();
+    }
+  }
+
   // ParallelFor shards the "total" units of work assuming each unit of work
   // having roughly "cost_per_unit" cost, in cycles. Each unit of work is
   // indexed 0, 1, ..., total - 1. Each shard contains 1 or more units of work
@@ -361,6 +373,19 @@ class ThreadPool {
   // working in combination with the thread initiating the loop.
   static int DegreeOfParallelism(const ThreadPool* tp);
 
+  // Return one more than the largest NUMA node id of the threads of the pool if they span more than one
+  // node, or 1 otherwise, including when the pool does not know the NUMA node of its threads (see
+  // ThreadOptions::numa_nodes).
+  static int NumNumaNodes(const ThreadPool* tp);
+
+  // Return the NUMA node of the calling thread if it is a thread of the pool spanning more than one NUMA
+  // node, or -1 otherwise.  The thread entering a parallel loop is not a thread of the pool.
+  static int CurrentNumaNode(const ThreadPool* tp);
+
+  // Return true if kernels should keep a copy of their prepacked weights on each NUMA node spanned by the
+  // threads of the pool (see ThreadOptions::replicate_weights_per_numa_node).
+  static bool ShouldReplicateWeightsPerNumaNode(const ThreadPool* tp);
+
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(ThreadPool);
 
   // StartProfiling and StopProfiling are not to be consumed as public-facing API
@@ -412,6 +437,8 @@ class ThreadPool {
 
   void Schedule(std::function<void()> fn);
 
+  void ScheduleLocal(std::function<void()> fn);
+
   void StartProfiling();
 
   std::string StopProfiling();
@@ -594,6 +594,16 @@ typedef OrtCustomThreadHandle (*OrtCustomCreateThreadFn)(void* ort_custom_thread
 */
 typedef void (*OrtCustomJoinThreadFn)(OrtCustomThreadHandle ort_custom_thread_handle);
 
+/** \brief Callback function for OrtApi::RunAsync
+*
+* \param[in] user_data The user_data passed to OrtApi::RunAsync
+* \param[in] outputs The output array passed to OrtApi::RunAsync, holding the outputs of the run. nullptr if the run failed.
+* \param[in] num_outputs Number of elements in outputs. 0 if the run failed.
+* \param[in] status nullptr if the run succeeded, otherwise the error. The callback owns it and must release it with
+*                   OrtApi::ReleaseStatus.
+*/
+typedef void (*OrtRunAsyncCallbackFn)(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status);
+
 /** \brief The C API
 *
 * All C API functions are defined inside this structure as pointers to functions.
@@ -2638,6 +2648,11 @@ struct OrtApi {
   *  Only relevant if arena strategy is `kNextPowerOfTwo`. Use -1 to allow ORT to choose the default.
   *  Ultimately, the allocation size is determined by the allocation memory request.
   *  Further allocation sizes are governed by the arena extend strategy.
+  * "thread_local_cache_bytes": Maximum number of free bytes each thread may keep in a thread-local cache in front
+  *  of the arena. Allocations and frees of cached sizes on the same thread then avoid the arena lock.
+  *  Use 0 or -1 to disable the cache. Default is disabled.
+  * "thread_local_cache_max_alloc_bytes": Largest allocation served by the thread-local cache.
+  *  Use -1 to allow ORT to choose the default.
   *
   * \param[in] arena_config_keys Keys to configure the arena
   * \param[in] arena_config_values Values to configure the arena
@@ -3574,7 +3589,132 @@ struct OrtApi {
   *  \since Version 1.14
   */
   void(ORT_API_CALL* MemoryInfoGetDeviceType)(_In_ const OrtMemoryInfo* ptr, _Out_ OrtMemoryInfoDeviceType* out);
-  
+
+  /** \brief Set a caller owned scratch buffer for OrtApi::Run calls made with these run options
+  *
+  * With memory pattern optimization enabled, a Run places the intermediate tensors of the model on each device in
+  * a single buffer that it allocates, sized from the shapes of the inputs. The scratch buffer, on the device described
+  * by `mem_info`, is used instead and the Run does not allocate the buffer for that device. Use
+  * OrtApi::SessionGetScratchBufferSize to get the required size, which is 0 until the first Run with inputs of the
+  * same shapes has generated the memory pattern. A Run without a memory pattern for the shapes of its inputs
+  * allocates as usual and generates it. A Run with one fails with ORT_INVALID_ARGUMENT if the scratch buffer is
+  * smaller than the required size, or if the memory pattern places nothing on the device of the buffer but does on
+  * another device.
+  *
+  * Memory patterns are only used in sequential execution mode. A Run in parallel execution mode with a scratch buffer
+  * set fails with ORT_INVALID_ARGUMENT.
+  *
+  * The buffer must be aligned to 256 bytes. It must stay valid and must not be used by any other Run call until
+  * the Run calls using it return, so concurrent Run calls each need their own OrtRunOptions and buffer.
+  *
+  * \param[in] options
+  * \param[in] mem_info Location of the buffer, e.g. from OrtApi::CreateCpuMemoryInfo for CPU memory.
+  *                     Not used if buffer is nullptr.
+  * \param[in] buffer The buffer, or nullptr to stop using a scratch buffer.
+  * \param[in] buffer_size Size of the buffer in bytes.
+  *
+  * \snippet{doc} snippets.dox OrtStatus Return Value
+  *
+  * \since Version 1.14.
+  */
+  ORT_API2_STATUS(RunOptionsSetScratchBuffer, _Inout_ OrtRunOptions* options, _In_opt_ const OrtMemoryInfo* mem_info,
+                  _In_opt_ void* buffer, size_t buffer_size);
+
+  /** \brief Get the size of the scratch buffer a Run with the given inputs needs on a device
+  *
+  * The size is that of the memory pattern for the shapes of the inputs. The pattern is generated by the first Run
+  * with inputs of these shapes, or during session initialization for a model with static shapes if the
+  * "session.static_memory_planning" session config entry is set.
+  *
+  * \param[in] session
+  * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names, in the order they are
+  *                        passed to OrtApi::Run.
+  * \param[in] inputs Array of ::OrtValue%s of the input values
+  * \param[in] input_len Number of elements in the input_names and inputs arrays
+  * \param[in] mem_info Location of the scratch buffer
+  * \param[out] size Required size in bytes. 0 if the session does not use memory patterns for these inputs, or if
+  *                  no pattern has been generated for their shapes yet.
+  *
+  * \snippet{doc} snippets.dox OrtStatus Return Value
+  *
+  * \since Version 1.14.
+  */
+  ORT_API2_STATUS(SessionGetScratchBufferSize, _In_ const OrtSession* session,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                  _In_ const OrtMemoryInfo* mem_info, _Out_ size_t* size);
+
+  /** \brief Run the model asynchronously
+  *
+  * Queues the run and returns without waiting for it. The session runs the queued requests in order, on threads
+  * dedicated to them that are created by the first call, each running one request at a time. Their number is set by
+  * the "session.run_async_threads" session config entry (kOrtSessionOptionsConfigRunAsyncThreads) and defaults to
+  * the number of threads of the intra-op thread pool of the session. When a run completes, `callback` is called from
+  * one of these threads.
+  *
+  * The inputs are referenced by the request, so the input_names and input arrays can be released once this returns.
+  * `run_options` and the `output` array must remain valid until the callback is called.
+  *
+  * If the session is released while requests are queued, they are not run and their callback is called with an
+  * error. Releasing the session waits for the runs in progress.
+  *
+  * \param[in] session
+  * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+  * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+  * \param[in] input Array of ::OrtValue%s of the input values
+  * \param[in] input_len Number of elements in the input_names and inputs arrays
+  * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+  * \param[in] output_names_len Number of elements in the output_names and outputs array
+  * \param[out] output Array of ::OrtValue%s that the outputs are stored in, and passed to the callback. This can
+  *   also be an array of nullptr values, in this case ::OrtValue objects will be allocated and pointers to them set
+  *   into the `output` array.
+  * \param[in] callback Called when the run completes
+  * \param[in] user_data Passed to the callback
+  *
+  * \snippet{doc} snippets.dox OrtStatus Return Value
+  *
+  * \since Version 1.14.
+  */
+  ORT_API2_STATUS(RunAsync, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Inout_updates_all_(output_names_len) OrtValue** output,
+                  _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data);
+
+  /** \brief Get the per operator metrics of the session
+  *
+  * Returns, for each node of the main graph and each op type, the number of runs, their total time, a latency
+  * histogram summarized as percentiles and the number of output allocations not served by a memory pattern, as
+  * accumulated since the session was created or the metrics were last reset. The metrics are a JSON object:
+  * {"op_types": [{"name", "count", "total_ns", "p50_ns", "p90_ns", "p99_ns", "max_ns", "allocations"}, ...],
+  *  "nodes": [{"name", "op_type", "count", "total_ns", "p50_ns", "p90_ns", "p99_ns", "max_ns", "allocations"}, ...]}
+  *
+  * Requires the session config entry "session.enable_op_metrics" to be "1".
+  *
+  * \param[in] session
+  * \param[in] allocator Used to allocate the returned string
+  * \param[out] out Set to the null terminated JSON string. Free it with `allocator`.
+  *
+  * \snippet{doc} snippets.dox OrtStatus Return Value
+  *
+  * \since Version 1.14.
+  */
+  ORT_API2_STATUS(SessionGetOpMetrics, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Clear the per operator metrics of the session
+  *
+  * Requires the session config entry "session.enable_op_metrics" to be "1".
+  *
+  * \param[in] session
+  *
+  * \snippet{doc} snippets.dox OrtStatus Return Value
+  *
+  * \since Version 1.14.
+  */
+  ORT_API2_STATUS(SessionResetOpMetrics, _Inout_ OrtSession* session);
+
 
 #ifdef __cplusplus
   OrtApi(const OrtApi&)=delete; // Prevent users from accidentally copying the API structure, it should always be passed as a pointer
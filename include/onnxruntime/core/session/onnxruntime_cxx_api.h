@@ -410,6 +410,14 @@ struct RunOptions : detail::Base<OrtRunOptions> {
    * Wraps OrtApi::RunOptionsUnsetTerminate
    */
   RunOptions& UnsetTerminate();
+
+  /** \brief Use a caller owned buffer for the intermediate tensors of Session::Run calls using this instance
+   *
+   * See Session::GetScratchBufferSize for the required size, which is 0 until the first Run with the same input
+   * shapes. A Run fails if the buffer is smaller than that. Not supported in parallel execution mode.
+   * Wraps OrtApi::RunOptionsSetScratchBuffer
+   */
+  RunOptions& SetScratchBuffer(const OrtMemoryInfo* mem_info, void* buffer, size_t buffer_size);
 };
 
 /** \brief Options object used when creating a new Session object
@@ -610,9 +618,25 @@ struct ConstSessionImpl : Base<T> {
   uint64_t GetProfilingStartTimeNs() const;                                 ///< Wraps OrtApi::SessionGetProfilingStartTimeNs
   ModelMetadata GetModelMetadata() const;                                   ///< Wraps OrtApi::SessionGetModelMetadata
 
+  /** \brief Returns the per operator metrics of the session as JSON.
+   *
+   * \param allocator to allocate memory for the string returned
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   *  The OrtAllocator instances must be valid at the point of memory release.
+   */
+  AllocatedStringPtr GetOpMetricsAllocated(OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetOpMetrics
+
   TypeInfo GetInputTypeInfo(size_t index) const;                   ///< Wraps OrtApi::SessionGetInputTypeInfo
   TypeInfo GetOutputTypeInfo(size_t index) const;                  ///< Wraps OrtApi::SessionGetOutputTypeInfo
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;  ///< Wraps OrtApi::SessionGetOverridableInitializerTypeInfo
+
+  /** \brief Returns the size of the scratch buffer a Run with the given inputs needs on a device
+   *
+   * 0 if no memory pattern is available for the shapes of the inputs yet, e.g. before the first Run with them.
+   * Wraps OrtApi::SessionGetScratchBufferSize
+   */
+  size_t GetScratchBufferSize(const char* const* input_names, const Value* input_values, size_t input_count,
+                              const OrtMemoryInfo* mem_info) const;
 };
 
 template <typename T>
@@ -647,6 +671,27 @@ struct SessionImpl : ConstSessionImpl<T> {
            const char* const* output_names, Value* output_values, size_t output_count);
 
   void Run(const RunOptions& run_options, const IoBinding&);  ///< Wraps OrtApi::RunWithBinding
+
+  /** \brief Queue a run of the model and return without waiting for it
+   *
+   * Wraps OrtApi::RunAsync
+   *
+   * \param[in] run_options Must remain valid until the callback is called
+   * \param[in] input_names Array of null terminated strings of length input_count that is the list of input names
+   * \param[in] input_values Array of Value objects of length input_count that is the list of input values
+   * \param[in] input_count Number of inputs (the size of the input_names & input_values arrays)
+   * \param[in] output_names Array of C style strings of length output_count that is the list of output names
+   * \param[out] output_values Array of Value objects of length output_count that the outputs are stored in.
+   *                           Must remain valid until the callback is called.
+   * \param[in] output_count Number of outputs (the size of the output_names & output_values arrays)
+   * \param[in] callback Called with user_data, output_values and the status of the run when it completes
+   * \param[in] user_data Passed to the callback
+   */
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                const char* const* output_names, Value* output_values, size_t output_count, OrtRunAsyncCallbackFn callback,
+                void* user_data);
+
+  void ResetOpMetrics();  ///< Wraps OrtApi::SessionResetOpMetrics
 };
 
 }  // namespace detail
@@ -454,6 +454,11 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::SetScratchBuffer(const OrtMemoryInfo* mem_info, void* buffer, size_t buffer_size) {
+  ThrowOnError(GetApi().RunOptionsSetScratchBuffer(p_, mem_info, buffer, buffer_size));
+  return *this;
+}
+
 namespace detail {
 
 template <typename T>
@@ -728,6 +733,13 @@ inline AllocatedStringPtr ConstSessionImpl<T>::EndProfilingAllocated(OrtAllocato
   return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
 }
 
+template <typename T>
+inline AllocatedStringPtr ConstSessionImpl<T>::GetOpMetricsAllocated(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(GetApi().SessionGetOpMetrics(this->p_, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
 template <typename T>
 inline uint64_t ConstSessionImpl<T>::GetProfilingStartTimeNs() const {
   uint64_t out;
@@ -763,6 +775,17 @@ inline TypeInfo ConstSessionImpl<T>::GetOverridableInitializerTypeInfo(size_t in
   return TypeInfo{out};
 }
 
+template <typename T>
+inline size_t ConstSessionImpl<T>::GetScratchBufferSize(const char* const* input_names, const Value* input_values,
+                                                        size_t input_count, const OrtMemoryInfo* mem_info) const {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  size_t out;
+  ThrowOnError(GetApi().SessionGetScratchBufferSize(this->p_, input_names, ort_input_values, input_count, mem_info,
+                                                    &out));
+  return out;
+}
+
 template <typename T>
 inline std::vector<Value> SessionImpl<T>::Run(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
                                               const char* const* output_names, size_t output_count) {
@@ -788,6 +811,22 @@ inline void SessionImpl<T>::Run(const RunOptions& run_options, const IoBinding&
   ThrowOnError(GetApi().RunWithBinding(this->p_, run_options, io_binding));
 }
 
+template <typename T>
+inline void SessionImpl<T>::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                                     const char* const* output_names, Value* output_values, size_t output_count,
+                                     OrtRunAsyncCallbackFn callback, void* user_data) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(GetApi().RunAsync(this->p_, run_options, input_names, ort_input_values, input_count, output_names, output_count,
+                                 ort_output_values, callback, user_data));
+}
+
+template <typename T>
+inline void SessionImpl<T>::ResetOpMetrics() {
+  ThrowOnError(GetApi().SessionResetOpMetrics(this->p_));
+}
+
 }  // namespace detail
 
 inline SessionOptions::SessionOptions() {
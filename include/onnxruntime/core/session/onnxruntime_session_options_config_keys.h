@@ -61,6 +61,23 @@ static const char* const kOrtSessionOptionsEnableQuantQDQCleanup = "session.enab
 // GeluApproximation has side effects which may change the inference results. It is disabled by default due to this.
 static const char* const kOrtSessionOptionsEnableGeluApproximation = "optimization.enable_gelu_approximation";
 
+// Enable or disable incremental graph transformation. "0": disable; "1": enable. The default is "0".
+// After the first pass over the graph, graph transformers are only applied again to the nodes near the nodes the
+// previous transformations changed, and only if they look for matches at nodes of those op types.
+// The changed nodes are those added or removed, or whose edges were added or removed. This speeds up the
+// optimization of large models, but transformations that match on attribute values, on inputs replaced without
+// changing the edges or on the content of initializers changed by another transformation may not be applied again.
+static const char* const kOrtSessionOptionsConfigIncrementalGraphTransformation =
+    "optimization.incremental_graph_transformation";
+
+// "1": when the graph is resolved again after a graph transformation, skip the type and shape inference of the nodes
+// for which nothing the inference reads changed since it last ran, so only the changed nodes and those downstream of
+// them are inferred again. A summary of the inputs of the inference is kept on each node, including the data of its
+// small constant initializer inputs, which uses up to about 8 KB per such input.
+// "0": infer every node on each resolve. The default.
+static const char* const kOrtSessionOptionsConfigResolveSkipUnchangedInference =
+    "optimization.resolve_skip_unchanged_inference";
+
 // Enable or disable using device allocator for allocating initialized tensor memory. "1": enable; "0": disable. The default is "0".
 // Using device allocators means the memory allocation is made using malloc/new.
 static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "session.use_device_allocator_for_initializers";
@@ -142,3 +159,144 @@ static const char* const kOrtSessionOptionsConfigForceSpinningStop = "session.fo
 // "0": in some cases warnings will be logged but processing will continue. The default.
 // May be useful to expose bugs in models.
 static const char* const kOrtSessionOptionsConfigStrictShapeTypeInference = "session.strict_shape_type_inference";
+
+// "1": use the dataflow executor when the execution mode is ORT_PARALLEL. Nodes are scheduled from
+// dependency counts precomputed in the execution plan, a finishing node runs one ready consumer inline and
+// hands the rest to the inter-op thread pool, where idle threads can steal them.
+// "0": use the default parallel executor.
+// Has no effect unless the execution mode is ORT_PARALLEL and an inter-op thread pool is available.
+static const char* const kOrtSessionOptionsConfigUseDataflowExecutor = "session.use_dataflow_executor";
+
+// Controls how input shapes are mapped to cached memory patterns when memory pattern optimization is enabled.
+// "": one pattern per exact set of input shapes. The default.
+// "pow2": round each input dim up to the next power of two, e.g. sequence lengths 33 to 64 share a pattern.
+// "16,32,64,128": round each input dim up to the next listed value. Dims above the last value are used as is.
+// A shared pattern is sized by the largest request seen in its bucket and grows on the next run if a request
+// does not fit. Ignored in training builds.
+static const char* const kOrtSessionOptionsConfigMemoryPatternBuckets = "session.memory_pattern_buckets";
+
+// Maximum number of memory patterns cached per graph. The least recently used pattern is dropped when the limit
+// is reached. "0" means no limit. The default.
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheSize = "session.memory_pattern_cache_size";
+
+// "1": if every intermediate tensor has a static shape, assign all of them an offset in a single buffer per device
+// during session initialization, instead of planning the memory pattern from the first run. Each run then makes one
+// allocation per device for its intermediate tensors. Graphs with a dynamic intermediate shape are not affected.
+// "0": plan the memory pattern at run time. The default.
+// Has no effect unless memory pattern optimization is enabled.
+static const char* const kOrtSessionOptionsConfigStaticMemoryPlanning = "session.static_memory_planning";
+
+// Number of threads running the requests of OrtApi::RunAsync, each running one request at a time.
+// The threads are dedicated to the session and created by its first RunAsync call. The default is the number of
+// threads of the intra-op thread pool the session uses, including the calling thread, so 1 if it has none.
+static const char* const kOrtSessionOptionsConfigRunAsyncThreads = "session.run_async_threads";
+
+// Merge concurrent Run calls into batches of up to this many rows, i.e. the sum of the first dims of their inputs.
+// The inputs of the requests in a batch are concatenated along their first dim, the batch runs once and each output
+// is split along its first dim between the requests. Requests are not batched unless every input and output of the
+// model has the same named dynamic dim first. Only requests whose inputs are all tensors in CPU memory, whose outputs
+// are not pre-allocated and whose run options are the same other than the terminate flag are merged.
+// "0": no batching. The default.
+static const char* const kOrtSessionOptionsConfigBatchingMaxBatchSize = "session.batching.max_batch_size";
+
+// Maximum time in microseconds the first request of a batch waits for other requests to fill it. The default is
+// "1000".
+static const char* const kOrtSessionOptionsConfigBatchingMaxWaitUs = "session.batching.max_wait_us";
+
+// "1": merge requests whose inputs differ in dims other than the batch dim by padding them with zeros to the largest
+// value in the batch, and crop the outputs back to the dims of each request. Only applied to models whose nodes are
+// all elementwise and whose output dims follow named input dims, in which the padding can not change the results.
+// Other models only merge requests whose inputs have the same dims.
+// "0": only merge requests whose inputs have the same dims other than the batch dim. The default.
+static const char* const kOrtSessionOptionsConfigBatchingPadRaggedDims = "session.batching.pad_ragged_dims";
+
+// "1": if the processors span more than one NUMA node, spread the threads of the intra-op thread pool over the nodes
+// in contiguous blocks, bind each thread to a processor of its node, and have idle threads steal work from threads of
+// their own node before the other nodes. If the affinity of the threads is set, the node of each thread is the node
+// of its processor. The topology is read from sysfs on Linux. On other platforms the option has no effect.
+// "0": treat all the processors the same. The default.
+// Applies only to the per-session intra-op thread pool.
+static const char* const kOrtSessionOptionsConfigIntraOpNumaAware = "session.intra_op.numa_aware";
+
+// "1": the fp32 MatMul, Gemm and FusedGemm kernels keep a copy of their prepacked dense weights on each NUMA node
+// spanned by the intra-op thread pool, so each thread reads the copy local to its node. This uses one copy of the
+// prepacked weights per node. Other kernels, including the fp16, sparse and quantized ones, keep a single copy.
+// Has no effect unless "session.intra_op.numa_aware" is "1".
+// "0": keep a single copy. The default.
+static const char* const kOrtSessionOptionsConfigNumaReplicatePrepackedWeights =
+    "session.intra_op.numa_replicate_prepacked_weights";
+
+// "1": keep a latency histogram and a count of the output allocations not served by a memory pattern for each node
+// of the main graph and for each op type, recorded on every run by the sequential and parallel executors. The cost is
+// two clock reads and a few atomic increments per node. Query them with OrtApi::SessionGetOpMetrics and clear them with
+// OrtApi::SessionResetOpMetrics. The time spent in a subgraph is included in the node that runs it.
+// "0": do not record metrics. The default.
+static const char* const kOrtSessionOptionsConfigEnableOpMetrics = "session.enable_op_metrics";
+
+// "1": keep the constant CPU initializers that have raw data in the model, and the weights kernels pre-pack from them,
+// in a process wide store shared by all the sessions with this option. Sessions of models with identical weights,
+// found by a hash of the raw data of the initializer and its type and dims, share a single copy. A weight is freed when
+// the last session using it is released.
+// The weights must not be modified in place, so this should not be used for training.
+// "0": each session keeps its own copy of its weights. The default.
+static const char* const kOrtSessionOptionsConfigShareWeightsAcrossSessions = "session.share_weights_across_sessions";
+
+// Minimum fraction of zero weights, in [0, 1], for the CPU MatMul kernel to pre-pack a constant 2D float weight in the
+// MLAS sparse format, which skips the zeros. Zeros in rows of 4 consecutive output columns (1x4 blocks, as left by
+// block pruning) are skipped at a lower cost than unstructured zeros, so the kernel picks the format with the lower
+// estimated cost and uses it if the cost is below that of a weight with this fraction of zero 1x4 blocks.
+// The sparse format is faster than the dense one for weights with at least 50% of zero 1x4 blocks or 75% of
+// unstructured zeros. Has no effect if pre-packing is disabled.
+// "0": always pre-pack in the dense format. The default.
+static const char* const kOrtSessionOptionsConfigMatMulSparseWeightThreshold = "session.matmul_sparse_weight_threshold";
+
+// "1": when the CPU MatMul and Gemm kernels for float are created for an input shape that is static in the model,
+// time a set of candidate blocking and threading parameters for the MLAS SGEMM on the intra-op thread pool and keep
+// the fastest. Each distinct shape and thread count is tuned once per process. This lengthens session creation.
+// "0": use the default MLAS heuristics. The default.
+static const char* const kOrtSessionOptionsConfigGemmAutotune = "session.gemm_autotune";
+
+// Path of a file that caches the parameters found by "session.gemm_autotune" across processes. The entries are
+// keyed by processor model, so the file can be shared by machines with different processors. It is read on the first
+// use of a given path and rewritten as new shapes are tuned. Has no effect unless "session.gemm_autotune" is "1".
+static const char* const kOrtSessionOptionsConfigGemmAutotuneCacheFile = "session.gemm_autotune_cache_file";
+
+// Directory of a cache of optimized models. When an ONNX model loaded from a file or from bytes is initialized, the
+// session looks for a cache file keyed by a hash of the model bytes and of the external data files of its
+// initializers, the ORT version, the graph optimization level,
+// the disabled optimizers, the free dimension overrides, the other config entries, the execution providers and their
+// options, and the processor. If there is one, the session memory maps it and uses the optimized graph and kernel
+// assignments it holds, skipping graph optimization and partitioning, and its initializers refer to the mapped file.
+// Otherwise the optimized model is written to the cache as an ORT format model.
+// The weights the CPU kernels of the main graph pre-pack are written next to the cache file, and the kernels that
+// support it use them from the mapped file instead of pre-packing again. Other weights are pre-packed at each
+// initialization. Models with nodes compiled by an execution provider and sessions with external initializers added
+// through the session options are not cached.
+static const char* const kOrtSessionOptionsConfigOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// "1": spread the work of session state finalization over the intra-op thread pool. The CPU initializers are
+// deserialized, or their external data read, concurrently, the kernels of the CPU execution provider are created
+// concurrently, and the kernels of different nodes pre-pack their weights concurrently. This applies to the main graph
+// and to each subgraph. The constructors and PrePack implementations of custom op kernels registered for the CPU
+// execution provider in a custom domain are still called from the calling thread. Kernels are created sequentially
+// when "session.gemm_autotune" is "1" so the timings are not disturbed.
+// "0": finalize the session state on the calling thread. The default.
+static const char* const kOrtSessionOptionsConfigParallelInitialization = "session.parallel_initialization";
+
+// "1": when an ONNX model is loaded from a file, memory map the file instead of reading it, and make the initializers
+// with more than 127 bytes of raw data in the file refer to it in place. Initializers placed on the CPU then use the
+// mapped pages instead of a private copy, so their memory is backed by the file, can be dropped under memory pressure
+// and paged in again when used, and is shared with other processes mapping the same file. External data files are
+// memory mapped in either case. The file is kept mapped until the session is destroyed. Raw data that is not aligned
+// for its element type is still copied. Has no effect when the session saves the optimized model with
+// "optimized_model_filepath".
+// "0": read the model file. The default.
+static const char* const kOrtSessionOptionsConfigUseMmapForInitializers = "session.use_mmap_for_initializers";
+
+// "1": the CPU Conv and FusedConv kernels for float pre-pack the filters of 3x3 convolutions with unit strides and
+// dilations and at least 32 input channels and filters per group for the Winograd algorithm that MLAS selects for
+// them. Both the F(4x4,3x3) and F(2x2,3x3) transforms of the filter are kept, with a copy of the filter for the input
+// shapes that use another algorithm, in place of the filter initializer. This takes about 6.8 times the memory of the
+// filter and saves transforming it on each run.
+// "0": transform the filter into the working buffer on each run that uses the Winograd algorithm. The default.
+static const char* const kOrtSessionOptionsConfigConvWinogradPrepack = "session.conv_winograd_prepack";
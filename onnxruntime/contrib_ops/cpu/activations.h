@@ -69,24 +69,18 @@ class Gelu : public OpKernel {
     int64_t elem_count = input->Shape().Size();
     constexpr int64_t length_per_task = 4096;  // this number comes from FastGelu.
     int64_t task_count = (elem_count + length_per_task - 1) / length_per_task;
+
+    MLAS_ACTIVATION activation;
+    activation.ActivationKind = MlasGeluErfActivation;
+
     concurrency::ThreadPool::TryBatchParallelFor(
         tp, static_cast<int32_t>(task_count),
         [&](ptrdiff_t task_idx) {
           const auto start = task_idx * length_per_task;
-          const T* p_input = input_data + start;
-          T* p_output = output_data + start;
           int64_t count = std::min(length_per_task, elem_count - start);
 
-          for (int64_t i = 0; i < count; i++) {
-            T value = p_input[i];
-            p_output[i] = value * static_cast<T>(M_SQRT1_2);
-          }
-
-          MlasComputeErf(p_output, p_output, count);
-
-          for (int64_t i = 0; i < count; i++) {
-            p_output[i] = 0.5f * p_input[i] * (p_output[i] + 1.0f);
-          }
+          MlasComputeBiasActivation(&activation, input_data + start, nullptr, output_data + start,
+                                    1, static_cast<size_t>(count));
         },
         0);
     return Status::OK();
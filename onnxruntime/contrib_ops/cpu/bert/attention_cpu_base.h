@@ -42,6 +42,19 @@ class AttentionCPUBase : public AttentionBase {
     // Total sequence length including that of past state: S* = S' + S
     const int all_sequence_length = past_sequence_length + sequence_length;
 
+    bool has_unidirectional = (is_unidirectional_ && sequence_length > 1);
+
+    // The fused kernel streams K and V through an online softmax and never materializes the BxNxSxS* scores.
+    // It supports masks that only depend on the key position, i.e. everything except 3D/4D masks and extra_add_qk.
+    if constexpr (std::is_same<T, float>::value) {
+      if (extra_add_qk == nullptr && (mask_index == nullptr || mask_index->Shape().NumDimensions() <= 2)) {
+        return ApplyFlashAttention(Q, K, V, mask_index, past, present, output->MutableData<T>(),
+                                   batch_size, sequence_length, past_sequence_length,
+                                   qk_head_size == 0 ? v_head_size : qk_head_size, v_head_size,
+                                   has_unidirectional, allocator, tp);
+      }
+    }
+
     // Compute the attention score. It does 2 things:
     //         I. attention_probs(B, N, S, S*) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S*, H -> B, N, H, S*) +
     //                                           1 x mask_data(B, N, S, S*)
@@ -50,8 +63,6 @@ class AttentionCPUBase : public AttentionBase {
     auto attention_probs = allocator->Alloc(bytes);
     BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
 
-    bool has_unidirectional = (is_unidirectional_ && sequence_length > 1);
-
     void* mask_data = nullptr;
     if (mask_index != nullptr || has_unidirectional) {
       size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * all_sequence_length * sizeof(T);
@@ -92,6 +103,89 @@ class AttentionCPUBase : public AttentionBase {
   }
 
  private:
+  // Computes the attention with the fused MLAS kernel. K and V are first concatenated with the past state into
+  // the present state (if requested) so the kernel can stream over all S* keys. The 1D or 2D mask is converted to an
+  // additive key bias of shape BxS* and a unidirectional mask is applied by the kernel itself.
+  Status ApplyFlashAttention(const float* Q,              // Q data. Its size is BxNxSxH
+                             const float* K,              // K data. Its size is BxNxSxH
+                             const float* V,              // V value with size BxNxSxH
+                             const Tensor* mask_index,    // 1D or 2D mask index. nullptr if no mask
+                             const Tensor* past,          // past state
+                             Tensor* present,             // present state
+                             float* output,               // output data with size BxSxNxH
+                             int batch_size,              // batch size
+                             int sequence_length,         // sequence length
+                             int past_sequence_length,    // sequence length of past state
+                             int qk_head_size,            // head size of Q and K
+                             int v_head_size,             // head size of V
+                             bool has_unidirectional,     // has unidirectional mask
+                             AllocatorPtr allocator,      // allocator for temporary buffers
+                             ThreadPool* tp) const {
+    const int all_sequence_length = past_sequence_length + sequence_length;
+    const int loop_len = batch_size * num_heads_;
+
+    const float* past_data = past != nullptr ? past->Data<float>() : nullptr;
+    float* present_data = present != nullptr ? present->MutableData<float>() : nullptr;
+
+    const float* k = K;
+    const float* v = V;
+
+    if (present_data != nullptr) {
+      // Concatenate past_K and K, then past_V and V: (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
+      const size_t k_past_chunk_length = static_cast<size_t>(past_sequence_length) * qk_head_size;
+      const size_t k_present_chunk_length = k_past_chunk_length + static_cast<size_t>(sequence_length) * qk_head_size;
+      const size_t v_past_chunk_length = static_cast<size_t>(past_sequence_length) * v_head_size;
+      const size_t v_present_chunk_length = v_past_chunk_length + static_cast<size_t>(sequence_length) * v_head_size;
+
+      const float* past_v_data = past_data != nullptr ? past_data + loop_len * v_past_chunk_length : nullptr;
+      float* present_v_data = present_data + loop_len * v_present_chunk_length;
+
+      const double cost = static_cast<double>(k_present_chunk_length + v_present_chunk_length);
+      ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          ConcatStateChunk(past_data, K + (k_present_chunk_length - k_past_chunk_length) * i, present_data,
+                           k_past_chunk_length, k_present_chunk_length, i);
+          ConcatStateChunk(past_v_data, V + (v_present_chunk_length - v_past_chunk_length) * i, present_v_data,
+                           v_past_chunk_length, v_present_chunk_length, i);
+        }
+      });
+
+      k = present_data;
+      v = present_v_data;
+    }
+
+    // Convert the mask to an additive bias per key position: (B)xS*. PrepareMask produces the
+    // SxS* mask of a single query row when called with a sequence length of 1.
+    void* key_bias = nullptr;
+    if (mask_index != nullptr) {
+      size_t key_bias_bytes = SafeInt<size_t>(batch_size) * all_sequence_length * sizeof(float);
+      key_bias = allocator->Alloc(key_bias_bytes);
+      memset(key_bias, 0, key_bias_bytes);
+      PrepareMask(mask_index->Data<int32_t>(), mask_index->Shape().GetDims(), static_cast<float*>(key_bias),
+                  false, batch_size, 1, all_sequence_length - 1);
+    }
+    BufferUniquePtr key_bias_buffer(key_bias, BufferDeleter(std::move(allocator)));
+
+    MLAS_FLASH_ATTENTION_PARAMETERS params;
+    params.BatchCount = static_cast<size_t>(batch_size);
+    params.HeadCount = static_cast<size_t>(num_heads_);
+    params.SequenceLength = static_cast<size_t>(sequence_length);
+    params.KvSequenceLength = static_cast<size_t>(all_sequence_length);
+    params.QkHeadSize = static_cast<size_t>(qk_head_size);
+    params.VHeadSize = static_cast<size_t>(v_head_size);
+    params.Scale = 1.0f / sqrt(static_cast<float>(qk_head_size));
+    params.Causal = has_unidirectional;
+    params.Query = Q;
+    params.Key = k;
+    params.Value = v;
+    params.KeyBias = static_cast<const float*>(key_bias);
+    params.Output = output;
+
+    MlasFlashAttention(&params, tp);
+
+    return Status::OK();
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  I. attention_probs(B, N, S, S*) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S*, H -> B, N, H, S*) +
   //                                    1 x mask_data(B, N, S, S*)
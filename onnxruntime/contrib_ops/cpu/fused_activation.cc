@@ -17,6 +17,22 @@ common::Status GetFusedActivationAttr(const OpKernelInfo& info, MLAS_ACTIVATION&
       activation.ActivationKind = MlasTanhActivation;
     } else if (activation_type == "Sigmoid") {
       activation.ActivationKind = MlasLogisticActivation;
+    } else if (activation_type == "Gelu") {
+      activation.ActivationKind = MlasGeluErfActivation;
+    } else if (activation_type == "FastGelu") {
+      activation.ActivationKind = MlasGeluTanhActivation;
+    } else if (activation_type == "QuickGelu") {
+      // x * Sigmoid(alpha * x). SiLU/Swish is the case alpha = 1.
+      activation.ActivationKind = MlasSwishActivation;
+      std::vector<float> activation_params;
+      if (info.GetAttrs<float>("activation_params", activation_params).IsOK()) {
+        if (activation_params.size() != 1) {
+          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "activation_params count mismatch");
+        }
+        activation.Parameters.Swish.alpha = activation_params[0];
+      } else {
+        activation.Parameters.Swish.alpha = 1.702f;
+      }
     } else {
       // The remaining activation types have additional parameters to be pulled out.
       size_t activation_params_count;
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/gemm.h"
+#include "contrib_ops/cpu/fused_activation.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -20,7 +21,15 @@ class FusedGemm final : public Gemm<T> {
         attrs[p.first.substr(ACTIVATION_NAME_PREFIX_LEN)] = p.second;
       }
     }
-    ORT_THROW_IF_ERROR(functors::ElementWiseRangedTransform<T>::Create(activation, attrs, this->activation_));
+    if (activation == "Gelu" || activation == "FastGelu" || activation == "QuickGelu") {
+      // These activations are applied by MLAS while each block of the output is still in the cache. Their
+      // parameters are read from activation_params, the same as FusedConv.
+      MLAS_ACTIVATION mlas_activation;
+      ORT_THROW_IF_ERROR(GetFusedActivationAttr(info, mlas_activation));
+      this->mlas_activation_ = mlas_activation;
+    } else {
+      ORT_THROW_IF_ERROR(functors::ElementWiseRangedTransform<T>::Create(activation, attrs, this->activation_));
+    }
   }
 };
 
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class MatMulNBits final : public OpKernel {
+ public:
+  MatMulNBits(const OpKernelInfo& info) : OpKernel(info) {
+    int64_t k;
+    int64_t n;
+    int64_t block_size;
+    ORT_ENFORCE(info.GetAttr<int64_t>("K", &k).IsOK());
+    ORT_ENFORCE(info.GetAttr<int64_t>("N", &n).IsOK());
+    ORT_ENFORCE(info.GetAttr<int64_t>("block_size", &block_size).IsOK());
+    const int64_t bits = info.GetAttrOrDefault<int64_t>("bits", 4);
+
+    K_ = gsl::narrow<size_t>(k);
+    N_ = gsl::narrow<size_t>(n);
+    block_size_ = gsl::narrow<size_t>(block_size);
+    nbits_ = gsl::narrow<size_t>(bits);
+
+    ORT_ENFORCE(MlasIsSQNBitGemmAvailable(nbits_, block_size_),
+                "MatMulNBits does not support bits=", nbits_, " with block_size=", block_size_);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  size_t K_;
+  size_t N_;
+  size_t block_size_;
+  size_t nbits_;
+};
+
+Status MatMulNBits::Compute(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(1);
+  const Tensor* scales = ctx->Input<Tensor>(2);
+  const Tensor* zero_points = ctx->Input<Tensor>(3);
+
+  const TensorShape& a_shape = a->Shape();
+  ORT_RETURN_IF_NOT(a_shape.NumDimensions() >= 1, "Input A must have at least one dimension.");
+  ORT_RETURN_IF_NOT(gsl::narrow<size_t>(a_shape[a_shape.NumDimensions() - 1]) == K_,
+                    "The last dimension of input A must be K=", K_, ". Got shape ", a_shape);
+
+  size_t quant_b_data_size;
+  size_t quant_b_scale_count;
+  size_t quant_b_zero_point_size;
+  MlasSQNBitGemmQuantBSizes(nbits_, block_size_, N_, K_, &quant_b_data_size, &quant_b_scale_count,
+                            &quant_b_zero_point_size);
+
+  ORT_RETURN_IF_NOT(gsl::narrow<size_t>(b->Shape().Size()) == quant_b_data_size,
+                    "Input B has ", b->Shape().Size(), " bytes, expected ", quant_b_data_size);
+  ORT_RETURN_IF_NOT(gsl::narrow<size_t>(scales->Shape().Size()) == quant_b_scale_count,
+                    "Input scales has ", scales->Shape().Size(), " elements, expected ", quant_b_scale_count);
+  ORT_RETURN_IF_NOT(zero_points == nullptr || gsl::narrow<size_t>(zero_points->Shape().Size()) == quant_b_zero_point_size,
+                    "Input zero_points has ", zero_points ? zero_points->Shape().Size() : 0,
+                    " bytes, expected ", quant_b_zero_point_size);
+
+  TensorShapeVector y_dims = a_shape.AsShapeVector();
+  y_dims.back() = gsl::narrow<int64_t>(N_);
+  Tensor* y = ctx->Output(0, TensorShape(y_dims));
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  // All leading dimensions of A are flattened into the rows of a single multiply.
+  const size_t M = gsl::narrow<size_t>(a_shape.SizeToDimension(a_shape.NumDimensions() - 1));
+
+  MLAS_SQNBIT_GEMM_DATA_PARAMS data;
+  data.A = a->Data<float>();
+  data.lda = K_;
+  data.QuantBData = b->Data<uint8_t>();
+  data.QuantBScale = scales->Data<float>();
+  data.QuantBZeroPoint = zero_points ? zero_points->Data<uint8_t>() : nullptr;
+  data.Bias = nullptr;
+  data.C = y->MutableData<float>();
+  data.ldc = N_;
+
+  MlasSQNBitGemmBatch(M, N_, K_, nbits_, block_size_, &data, 1, ctx->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    MatMulNBits,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    MatMulNBits);
+
+}  // namespace contrib
+}  // namespace onnxruntime
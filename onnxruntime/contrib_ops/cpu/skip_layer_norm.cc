@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
@@ -98,6 +99,13 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
 
   T* output_data = output->MutableData<T>();
 
+  if constexpr (std::is_same<T, float>::value) {
+    MlasSkipLayerNorm(input_data, skip_data, bias_data, gamma_data, beta_data, output_data,
+                      static_cast<size_t>(task_count), static_cast<size_t>(hidden_size), epsilon_,
+                      p_ctx->GetOperatorThreadPool());
+    return Status::OK();
+  }
+
   concurrency::ThreadPool::TryBatchParallelFor(
       p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
       [&](ptrdiff_t task_idx) {
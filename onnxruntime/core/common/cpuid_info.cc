@@ -45,6 +45,10 @@
 #endif  // CPUINFO_SUPPORTED
 
 
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
 namespace onnxruntime {
 
 #ifdef CPUIDINFO_ARCH_X86
@@ -81,8 +85,31 @@ void CPUIDInfo::X86Init() {
   GetCPUID(0, data);
 
   int num_IDs = data[0];
+
+  char vendor[13] = {};
+  std::memcpy(vendor, &data[1], 4);
+  std::memcpy(vendor + 4, &data[3], 4);
+  std::memcpy(vendor + 8, &data[2], 4);
+
   if (num_IDs >= 1) {
     GetCPUID(1, data);
+
+    // Display family and model as documented by the vendors: the extended fields only apply to
+    // the families that use them.
+    const uint32_t signature = static_cast<uint32_t>(data[0]);
+    uint32_t family = (signature >> 8) & 0xf;
+    uint32_t model = (signature >> 4) & 0xf;
+    const uint32_t stepping = signature & 0xf;
+    if (family == 0xf) {
+      family += (signature >> 20) & 0xff;
+    }
+    if (family == 0x6 || family >= 0xf) {
+      model |= ((signature >> 16) & 0xf) << 4;
+    }
+    std::ostringstream key;
+    key << vendor << std::hex << "-" << family << "-" << model << "-" << stepping;
+    cpu_model_key_ = key.str();
+
     if (data[2] & (1 << 27)) {
       constexpr int AVX_MASK = 0x6;
       constexpr int AVX512_MASK = 0xE6;
@@ -110,6 +137,23 @@ void CPUIDInfo::X86Init() {
 
 #endif /* CPUIDINFO_ARCH_X86 */
 
+std::string CPUIDInfo::CoreUarchsToModelKey() const {
+  std::vector<uint32_t> uarchs(core_uarchs_);
+  std::sort(uarchs.begin(), uarchs.end());
+  uarchs.erase(std::unique(uarchs.begin(), uarchs.end()), uarchs.end());
+
+  if (uarchs.empty()) {
+    return "unknown";
+  }
+
+  std::ostringstream key;
+  key << "uarch" << std::hex;
+  for (size_t i = 0; i < uarchs.size(); i++) {
+    key << (i == 0 ? "-" : "+") << uarchs[i];
+  }
+  return key.str();
+}
+
 #if defined(CPUIDINFO_ARCH_ARM)
 #ifdef __linux__
 
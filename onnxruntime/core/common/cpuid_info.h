@@ -27,6 +27,13 @@ class CPUIDInfo {
   // ARM
   bool HasArmNeonDot() const { return has_arm_neon_dot_; }
 
+  /**
+   * @return string identifying the processor model, e.g. the vendor, family, model and stepping
+   *         on x86 or the core micro-architectures on ARM. Used to key caches of parameters
+   *         tuned for the processor.
+  */
+  const std::string& GetCpuModelKey() const { return cpu_model_key_; }
+
   uint32_t GetCurrentCoreIdx() const;
 
   /**
@@ -96,6 +103,9 @@ class CPUIDInfo {
 #endif /* (arm or arm64) and windows */
 #endif
 
+    if (cpu_model_key_.empty()) {
+      cpu_model_key_ = CoreUarchsToModelKey();
+    }
   }
   bool has_avx_{false};
   bool has_avx2_{false};
@@ -115,6 +125,10 @@ class CPUIDInfo {
 
   bool has_arm_neon_dot_{false};
 
+  std::string cpu_model_key_;
+
+  std::string CoreUarchsToModelKey() const;
+
 #ifdef CPUIDINFO_ARCH_X86
 
   void X86Init();
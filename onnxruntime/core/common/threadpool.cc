@@ -389,6 +389,11 @@ ThreadPool::ThreadPool(Env* env,
       assert(thread_options_.affinity.size() >= size_t(threads_to_create));
     }
 
+    if (!thread_options_.numa_nodes.empty()) {
+      // Remove the NUMA node of the caller thread, matching the affinity
+      thread_options_.numa_nodes.erase(thread_options_.numa_nodes.begin());
+    }
+
     extended_eigen_threadpool_ =
         std::make_unique<ThreadPoolTempl<Env> >(name,
                                                 threads_to_create,
@@ -479,6 +484,14 @@ void ThreadPool::Schedule(std::function<void()> fn) {
   }
 }
 
+void ThreadPool::ScheduleLocal(std::function<void()> fn) {
+  if (underlying_threadpool_) {
+    underlying_threadpool_->ScheduleLocal(std::move(fn));
+  } else {
+    fn();
+  }
+}
+
 void ThreadPool::StartProfiling() {
   if (underlying_threadpool_) {
     underlying_threadpool_->StartProfiling();
@@ -649,6 +662,24 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   }
 }
 
+int ThreadPool::NumNumaNodes(const concurrency::ThreadPool* tp) {
+  if (tp && tp->extended_eigen_threadpool_) {
+    return tp->extended_eigen_threadpool_->NumNumaNodes();
+  }
+  return 1;
+}
+
+int ThreadPool::CurrentNumaNode(const concurrency::ThreadPool* tp) {
+  if (tp && tp->extended_eigen_threadpool_) {
+    return tp->extended_eigen_threadpool_->CurrentNumaNode();
+  }
+  return -1;
+}
+
+bool ThreadPool::ShouldReplicateWeightsPerNumaNode(const concurrency::ThreadPool* tp) {
+  return tp && tp->thread_options_.replicate_weights_per_numa_node && NumNumaNodes(tp) > 1;
+}
+
 void ThreadPool::StartProfiling(concurrency::ThreadPool* tp) {
   if (tp) {
     tp->StartProfiling();
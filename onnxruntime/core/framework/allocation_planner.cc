@@ -1217,6 +1217,51 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // Record, for every node in the plan, how many upstream edges it waits on and which nodes consume its outputs.
+  // The DataflowExecutor uses this to schedule nodes without walking the graph edges during a run.
+  void ComputeNodeDependencies() {
+    const size_t num_nodes = graph_viewer_.MaxNodeIndex();
+    InlinedVector<bool> in_plan(num_nodes, false);
+    for (const auto& step : plan_.execution_plan) {
+      in_plan[step.node_index] = true;
+    }
+
+    plan_.node_dependency_counts.assign(num_nodes, 0);
+    plan_.downstream_offsets.assign(num_nodes + 1, 0);
+
+    // count the edges first so the consumer lists can be laid out contiguously
+    for (const auto& step : plan_.execution_plan) {
+      const Node& node = *graph_viewer_.GetNode(step.node_index);
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+        const NodeIndex consumer = it->GetNode().Index();
+        if (in_plan[consumer]) {
+          ++plan_.node_dependency_counts[consumer];
+          ++plan_.downstream_offsets[step.node_index + 1];
+        }
+      }
+    }
+
+    for (size_t i = 0; i < num_nodes; ++i) {
+      plan_.downstream_offsets[i + 1] += plan_.downstream_offsets[i];
+    }
+
+    plan_.downstream_nodes.resize(plan_.downstream_offsets[num_nodes]);
+    for (const auto& step : plan_.execution_plan) {
+      const Node& node = *graph_viewer_.GetNode(step.node_index);
+      size_t pos = plan_.downstream_offsets[step.node_index];
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+        const NodeIndex consumer = it->GetNode().Index();
+        if (in_plan[consumer]) {
+          plan_.downstream_nodes[pos++] = consumer;
+        }
+      }
+
+      if (plan_.node_dependency_counts[step.node_index] == 0) {
+        plan_.root_nodes.push_back(step.node_index);
+      }
+    }
+  }
+
   // Convert information in a freelist (about which ml-value becomes free when) into
   // a deallocation plan in the format required in an ExecutionPlan
   void GenerateDeallocationPlan() {
@@ -1320,6 +1365,9 @@ Status PlannerImpl::CreatePlan() {
   // Determine nodes that need fence check. This needs to be done after ComputeUseCounts and ComputeReusePlan.
   ORT_RETURN_IF_ERROR(ComputeFenceCheck());
 
+  // Record the node dependencies used for dataflow scheduling.
+  ComputeNodeDependencies();
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Adjust the allocate and lifetime intervals for all ml-values, based on their allocation kind.
   AdjustInplaceLifeIntervals();
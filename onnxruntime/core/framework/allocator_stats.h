@@ -23,6 +23,14 @@ struct AllocatorStats {
                                   // unknown.
   int64_t bytes_limit;
 
+  // Thread-local cache statistics (Relevant only for arena based allocators with a thread-local cache)
+  int64_t num_thread_caches;           // Number of threads that have a cache.
+  int64_t thread_cache_hits;           // Allocations served from a thread cache without taking the arena lock.
+  int64_t thread_cache_misses;         // Allocations of a cacheable size that went to the arena.
+  int64_t thread_cache_flushes;        // Number of times a thread cache returned chunks to the arena.
+  int64_t thread_cache_bytes;          // Free bytes held by all thread caches. Included in bytes_in_use.
+  int64_t max_thread_cache_bytes;      // Free bytes held by the fullest thread cache.
+
   AllocatorStats() { Clear(); }
 
   void Clear() {
@@ -35,6 +43,12 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_thread_caches = 0;
+    this->thread_cache_hits = 0;
+    this->thread_cache_misses = 0;
+    this->thread_cache_flushes = 0;
+    this->thread_cache_bytes = 0;
+    this->max_thread_cache_bytes = 0;
   }
 
   std::string DebugString() const {
@@ -48,6 +62,14 @@ struct AllocatorStats {
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
        << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+    if (this->num_thread_caches > 0) {
+      ss << "NumThreadCaches:          " << this->num_thread_caches << "\n"
+         << "ThreadCacheHits:          " << this->thread_cache_hits << "\n"
+         << "ThreadCacheMisses:        " << this->thread_cache_misses << "\n"
+         << "ThreadCacheFlushes:       " << this->thread_cache_flushes << "\n"
+         << "ThreadCacheBytes:         " << this->thread_cache_bytes << "\n"
+         << "MaxThreadCacheBytes:      " << this->max_thread_cache_bytes << "\n";
+    }
     return ss.str();
   }
 };
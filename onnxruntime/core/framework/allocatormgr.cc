@@ -39,6 +39,12 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
     int initial_growth_chunk_size_bytes = info.arena_cfg.initial_growth_chunk_size_bytes == -1
                                               ? BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES
                                               : info.arena_cfg.initial_growth_chunk_size_bytes;
+    int thread_local_cache_bytes = info.arena_cfg.thread_local_cache_bytes == -1
+                                       ? BFCArena::DEFAULT_THREAD_LOCAL_CACHE_BYTES
+                                       : info.arena_cfg.thread_local_cache_bytes;
+    int thread_local_cache_max_alloc_bytes = info.arena_cfg.thread_local_cache_max_alloc_bytes == -1
+                                                 ? BFCArena::DEFAULT_THREAD_LOCAL_CACHE_MAX_ALLOC_BYTES
+                                                 : info.arena_cfg.thread_local_cache_max_alloc_bytes;
     ArenaExtendStrategy arena_extend_str;
     switch (info.arena_cfg.arena_extend_strategy) {
       case static_cast<int>(ArenaExtendStrategy::kSameAsRequested):
@@ -59,7 +65,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                                    arena_extend_str,
                                                    initial_chunk_size_bytes,
                                                    max_dead_bytes_per_chunk,
-                                                   initial_growth_chunk_size_bytes));
+                                                   initial_growth_chunk_size_bytes,
+                                                   thread_local_cache_bytes,
+                                                   thread_local_cache_max_alloc_bytes));
   } else {
     return device_allocator;
   }
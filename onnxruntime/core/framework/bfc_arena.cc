@@ -3,15 +3,101 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include "core/common/inlined_containers.h"
+#include <algorithm>
+#include <atomic>
 #include <type_traits>
 
 namespace onnxruntime {
+
+// A thread's cache of free chunks for one arena, in the spirit of the tcmalloc
+// front end.
+//
+// Cacheable requests are rounded up to a size class. A chunk of that size is
+// taken from the arena on a miss and is then held by the cache until it is
+// returned: Free() on the owning thread puts it on the free list of its size
+// class and the next allocation of that class reuses it, neither touching the
+// arena lock. Once the free lists exceed thread_local_cache_bytes, half of the
+// cached bytes are returned to the arena under a single lock acquisition.
+// Every kTrimInterval frees, the chunks of each size class that were not
+// needed since the previous trim (the low-water mark of its free list) are
+// returned as well, so a cache does not keep memory the thread stopped using.
+// When the thread exits, its cache is released.
+//
+// A chunk freed by another thread is found through Chunk::thread_cache under
+// the arena lock and pushed to the owning cache. The cache mutex is taken by
+// other threads only in that case and for stats or Shrink(), so it is normally
+// uncontended.
+class BFCArena::ThreadCache {
+ public:
+  static constexpr int64_t kTrimInterval = 1024;
+
+  explicit ThreadCache(size_t num_size_classes) : free_lists(num_size_classes), low_water(num_size_classes) {}
+
+  OrtMutex mutex;
+
+  // free chunks per size class
+  std::vector<std::vector<void*>> free_lists;
+  // smallest size of each free list since the last trim
+  std::vector<size_t> low_water;
+  // every chunk held by this cache, free or handed out, and its size class
+  InlinedHashMap<void*, size_t> chunks;
+  size_t free_bytes = 0;
+  int64_t frees_since_trim = 0;
+
+  int64_t hits = 0;
+  int64_t misses = 0;
+  int64_t flushes = 0;
+};
+
+namespace {
+std::atomic<uint64_t> next_arena_id{1};
+
+// Arenas with a thread-local cache by id. The mutex is held while an exiting
+// thread releases its caches, so an arena cannot be destroyed meanwhile. It is
+// taken before any lock of the arena.
+struct LiveArenas {
+  OrtMutex mutex;
+  InlinedHashMap<uint64_t, BFCArena*> arenas;
+};
+
+LiveArenas& GetLiveArenas() {
+  // never destroyed, as threads may exit after static destruction has started
+  static LiveArenas* live_arenas = new LiveArenas();
+  return *live_arenas;
+}
+}  // namespace
+
+struct BFCArena::ThreadCacheMap {
+  ~ThreadCacheMap() {
+    auto& live_arenas = GetLiveArenas();
+    std::lock_guard<OrtMutex> lock(live_arenas.mutex);
+    for (const auto& entry : caches) {
+      // the cache was destroyed with its arena if the arena is gone
+      auto it = live_arenas.arenas.find(entry.first);
+      if (it != live_arenas.arenas.end()) {
+        it->second->ReleaseThreadCache(entry.second);
+      }
+    }
+  }
+
+  InlinedHashMap<uint64_t, ThreadCache*> caches;
+};
+
+// static
+BFCArena::ThreadCacheMap& BFCArena::CurrentThreadCaches() {
+  thread_local ThreadCacheMap thread_caches;
+  return thread_caches;
+}
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
-                   int initial_growth_chunk_size_bytes)
+                   int initial_growth_chunk_size_bytes,
+                   int thread_local_cache_bytes,
+                   int thread_local_cache_max_alloc_bytes)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -22,11 +108,29 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       next_allocation_id_(1),
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
-      initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes) {
+      initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
+      thread_local_cache_bytes_(thread_local_cache_bytes > 0 && thread_local_cache_max_alloc_bytes > 0
+                                    ? static_cast<size_t>(thread_local_cache_bytes)
+                                    : 0),
+      thread_local_cache_max_alloc_bytes_(thread_local_cache_bytes_ > 0
+                                              ? static_cast<size_t>(thread_local_cache_max_alloc_bytes)
+                                              : 0),
+      num_thread_cache_size_classes_(thread_local_cache_bytes_ > 0
+                                         ? ThreadCacheSizeClass(RoundedBytes(thread_local_cache_max_alloc_bytes_)) + 1
+                                         : 0),
+      arena_id_(next_arena_id++) {
+  if (thread_local_cache_bytes_ != 0) {
+    auto& live_arenas = GetLiveArenas();
+    std::lock_guard<OrtMutex> lock(live_arenas.mutex);
+    live_arenas.arenas.emplace(arena_id_, this);
+  }
+
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
+                     << " thread_local_cache_bytes: " << thread_local_cache_bytes_
+                     << " thread_local_cache_max_alloc_bytes: " << thread_local_cache_max_alloc_bytes_
                      << " memory limit: " << total_memory
                      << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
 
@@ -74,6 +178,13 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
 }
 
 BFCArena::~BFCArena() {
+  if (thread_local_cache_bytes_ != 0) {
+    // waits for any exiting thread that is releasing its cache of this arena
+    auto& live_arenas = GetLiveArenas();
+    std::lock_guard<OrtMutex> lock(live_arenas.mutex);
+    live_arenas.arenas.erase(arena_id_);
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -255,9 +366,205 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_local_cache_bytes_ != 0 && size != 0 && size <= thread_local_cache_max_alloc_bytes_) {
+    return AllocateFromThreadCache(size);
+  }
+
   return AllocateRawInternal(size, false);
 }
 
+// Size classes are the multiples of kMinAllocationSize up to 1KB, then 4 classes
+// per power of two, so at most 25% of a cached chunk is unused.
+size_t BFCArena::ThreadCacheSizeClass(size_t rounded_bytes) {
+  constexpr size_t kLinearClassesEnd = 4 * kMinAllocationSize;
+  if (rounded_bytes <= kLinearClassesEnd) {
+    return rounded_bytes / kMinAllocationSize - 1;
+  }
+
+  // rounded_bytes is in (2^k, 2^(k+1)]
+  const size_t k = static_cast<size_t>(Log2FloorNonZero(rounded_bytes - 1));
+  const size_t step = size_t{1} << (k - 2);
+  const size_t sub_class = (rounded_bytes - (size_t{1} << k) + step - 1) / step;  // 1..4
+  return 4 + (k - 10) * 4 + sub_class - 1;
+}
+
+// static
+size_t BFCArena::ThreadCacheSizeClassBytes(size_t size_class) {
+  if (size_class < 4) {
+    return (size_class + 1) * kMinAllocationSize;
+  }
+
+  const size_t k = 10 + (size_class - 4) / 4;
+  const size_t sub_class = (size_class - 4) % 4 + 1;
+  return (size_t{1} << k) + sub_class * (size_t{1} << (k - 2));
+}
+
+BFCArena::ThreadCache* BFCArena::GetThreadCache(bool create) {
+  auto& thread_caches = CurrentThreadCaches().caches;
+  auto it = thread_caches.find(arena_id_);
+  if (it != thread_caches.end()) {
+    return it->second;
+  }
+
+  if (!create) {
+    return nullptr;
+  }
+
+  // the cache is owned by the arena so that it can be flushed by other threads
+  std::lock_guard<OrtMutex> lock(thread_caches_lock_);
+  thread_caches_.push_back(std::make_unique<ThreadCache>(num_thread_cache_size_classes_));
+  ThreadCache* cache = thread_caches_.back().get();
+  thread_caches.emplace(arena_id_, cache);
+  return cache;
+}
+
+void* BFCArena::AllocateFromThreadCache(size_t size) {
+  ThreadCache* cache = GetThreadCache(true);
+  const size_t size_class = ThreadCacheSizeClass(RoundedBytes(size));
+  const size_t class_bytes = ThreadCacheSizeClassBytes(size_class);
+
+  {
+    std::lock_guard<OrtMutex> lock(cache->mutex);
+    auto& free_list = cache->free_lists[size_class];
+    if (!free_list.empty()) {
+      void* ptr = free_list.back();
+      free_list.pop_back();
+      cache->free_bytes -= class_bytes;
+      cache->low_water[size_class] = std::min(cache->low_water[size_class], free_list.size());
+      ++cache->hits;
+      return ptr;
+    }
+
+    ++cache->misses;
+  }
+
+  // don't hold the cache mutex while taking the arena lock. nothing else knows ptr until we return it.
+  void* ptr = AllocateRawInternal(class_bytes, false, cache);
+
+  std::lock_guard<OrtMutex> lock(cache->mutex);
+  cache->chunks.emplace(ptr, size_class);
+  return ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* ptr) {
+  ThreadCache* cache = GetThreadCache(false);
+  if (cache == nullptr) {
+    return false;
+  }
+
+  std::lock_guard<OrtMutex> lock(cache->mutex);
+  auto it = cache->chunks.find(ptr);
+  if (it == cache->chunks.end()) {
+    return false;
+  }
+
+  PushToThreadCache(*cache, ptr, it->second);
+  return true;
+}
+
+void BFCArena::PushToThreadCache(ThreadCache& cache, void* ptr, size_t size_class) {
+  cache.free_lists[size_class].push_back(ptr);
+  cache.free_bytes += ThreadCacheSizeClassBytes(size_class);
+  if (cache.free_bytes > thread_local_cache_bytes_) {
+    ReturnToArena(cache, thread_local_cache_bytes_ / 2);
+  }
+
+  if (++cache.frees_since_trim >= ThreadCache::kTrimInterval) {
+    TrimThreadCache(cache);
+  }
+}
+
+void BFCArena::ReturnToArena(ThreadCache& cache, size_t target_bytes) {
+  if (cache.free_bytes <= target_bytes) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  // return the largest chunks first as they are the most useful to other threads
+  for (size_t size_class = cache.free_lists.size(); size_class-- > 0 && cache.free_bytes > target_bytes;) {
+    auto& free_list = cache.free_lists[size_class];
+    while (!free_list.empty() && cache.free_bytes > target_bytes) {
+      ReturnChunkToArena(cache, size_class);
+    }
+
+    cache.low_water[size_class] = std::min(cache.low_water[size_class], free_list.size());
+  }
+
+  ++cache.flushes;
+}
+
+void BFCArena::TrimThreadCache(ThreadCache& cache) {
+  cache.frees_since_trim = 0;
+
+  // only take the arena lock if there is something to return
+  std::unique_lock<OrtMutex> lock(lock_, std::defer_lock);
+  for (size_t size_class = 0; size_class < cache.free_lists.size(); ++size_class) {
+    // chunks below the low-water mark were not allocated since the last trim
+    size_t num_unused = cache.low_water[size_class];
+    if (num_unused > 0) {
+      if (!lock.owns_lock()) {
+        lock.lock();
+      }
+
+      for (; num_unused > 0; --num_unused) {
+        ReturnChunkToArena(cache, size_class);
+      }
+    }
+
+    cache.low_water[size_class] = cache.free_lists[size_class].size();
+  }
+
+  if (lock.owns_lock()) {
+    ++cache.flushes;
+  }
+}
+
+void BFCArena::ReturnChunkToArena(ThreadCache& cache, size_t size_class) {
+  auto& free_list = cache.free_lists[size_class];
+  void* ptr = free_list.back();
+  free_list.pop_back();
+  cache.chunks.erase(ptr);
+  cache.free_bytes -= ThreadCacheSizeClassBytes(size_class);
+
+  ChunkHandle h = region_manager_.get_handle(ptr);
+  ORT_ENFORCE(h != kInvalidChunkHandle);
+  ChunkFromHandle(h)->thread_cache = nullptr;
+  FreeAndMaybeCoalesce(h);
+}
+
+void BFCArena::FlushThreadCaches() {
+  std::lock_guard<OrtMutex> caches_lock(thread_caches_lock_);
+  for (auto& cache : thread_caches_) {
+    std::lock_guard<OrtMutex> lock(cache->mutex);
+    ReturnToArena(*cache, 0);
+  }
+}
+
+void BFCArena::ReleaseThreadCache(ThreadCache* cache) {
+  std::lock_guard<OrtMutex> caches_lock(thread_caches_lock_);
+  {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    ReturnToArena(*cache, 0);
+
+    std::lock_guard<OrtMutex> lock(lock_);
+    // the chunks still handed out are freed to the arena directly from now on
+    for (const auto& chunk : cache->chunks) {
+      ChunkFromHandle(region_manager_.get_handle(chunk.first))->thread_cache = nullptr;
+    }
+
+    // keep the counts of the cache for GetStats
+    stats_.num_allocs += cache->hits;
+    stats_.thread_cache_hits += cache->hits;
+    stats_.thread_cache_misses += cache->misses;
+    stats_.thread_cache_flushes += cache->flushes;
+  }
+
+  auto it = std::find_if(thread_caches_.begin(), thread_caches_.end(),
+                         [cache](const std::unique_ptr<ThreadCache>& c) { return c.get() == cache; });
+  ORT_ENFORCE(it != thread_caches_.end());
+  thread_caches_.erase(it);
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -295,7 +602,8 @@ size_t BFCArena::AllocatedSize(const void* ptr) {
 }
 
 void* BFCArena::AllocateRawInternal(size_t num_bytes,
-                                    bool dump_log_on_failure) {
+                                    bool dump_log_on_failure,
+                                    ThreadCache* thread_cache) {
   if (num_bytes == 0) {
     LOGS_DEFAULT(VERBOSE) << "tried to allocate 0 bytes";
     return nullptr;
@@ -309,9 +617,16 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
   std::lock_guard<OrtMutex> lock(lock_);
+  auto set_thread_cache = [this, thread_cache](void* chunk_ptr) {
+    if (thread_cache != nullptr) {
+      ChunkFromHandle(region_manager_.get_handle(chunk_ptr))->thread_cache = thread_cache;
+    }
+    return chunk_ptr;
+  };
+
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
   if (ptr != nullptr) {
-    return ptr;
+    return set_thread_cache(ptr);
   }
 
   LOGS_DEFAULT(INFO) << "Extending BFCArena for " << device_allocator_->Info().name
@@ -322,7 +637,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   if (status.IsOK()) {
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
     if (ptr != nullptr) {
-      return ptr;
+      return set_thread_cache(ptr);
     } else {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                                "Failed to find a free memory block despite calling Extend. rounded_bytes=",
@@ -343,8 +658,24 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 }
 
 void BFCArena::GetStats(AllocatorStats* stats) {
-  std::lock_guard<OrtMutex> lock(lock_);
-  *stats = stats_;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    *stats = stats_;
+  }
+
+  std::lock_guard<OrtMutex> caches_lock(thread_caches_lock_);
+  for (auto& cache : thread_caches_) {
+    std::lock_guard<OrtMutex> lock(cache->mutex);
+    // allocations served by the cache did not reach the arena
+    stats->num_allocs += cache->hits;
+    stats->num_thread_caches += 1;
+    stats->thread_cache_hits += cache->hits;
+    stats->thread_cache_misses += cache->misses;
+    stats->thread_cache_flushes += cache->flushes;
+    stats->thread_cache_bytes += static_cast<int64_t>(cache->free_bytes);
+    stats->max_thread_cache_bytes = std::max(stats->max_thread_cache_bytes,
+                                             static_cast<int64_t>(cache->free_bytes));
+  }
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -432,6 +763,34 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (thread_local_cache_bytes_ == 0) {
+    FreeToArena(p);
+    return;
+  }
+
+  if (FreeToThreadCache(p)) {
+    return;
+  }
+
+  // frees p unless it was allocated from the cache of another thread, so that only those frees take
+  // thread_caches_lock_
+  if (FreeToArena(p) == nullptr) {
+    return;
+  }
+
+  // the owning cache may have been released since the arena lock was dropped, so the owner is read again while
+  // thread_caches_lock_ keeps the caches alive. the chunk stays held by that cache while in use, so it can be
+  // pushed there after releasing the arena lock.
+  std::lock_guard<OrtMutex> caches_lock(thread_caches_lock_);
+  ThreadCache* owner = FreeToArena(p);
+  if (owner != nullptr) {
+    std::lock_guard<OrtMutex> lock(owner->mutex);
+    PushToThreadCache(*owner, p, owner->chunks.at(p));
+  }
+}
+
+BFCArena::ThreadCache* BFCArena::FreeToArena(void* p) {
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -439,12 +798,24 @@ void BFCArena::Free(void* p) {
     stats_.bytes_in_use -= it->second;
     stats_.total_allocated_bytes -= it->second;
     reserved_chunks_.erase(it);
-  } else {
-    DeallocateRawInternal(p);
+    return nullptr;
+  }
+
+  BFCArena::ChunkHandle h = region_manager_.get_handle(p);
+  ORT_ENFORCE(h != kInvalidChunkHandle);
+  ThreadCache* owner = ChunkFromHandle(h)->thread_cache;
+  if (owner == nullptr) {
+    FreeAndMaybeCoalesce(h);
   }
+
+  return owner;
 }
 
 Status BFCArena::Shrink() {
+  if (thread_local_cache_bytes_ != 0) {
+    FlushThreadCaches();
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
@@ -19,6 +19,7 @@ limitations under the License.
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
@@ -50,6 +51,11 @@ namespace onnxruntime {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// Optionally, allocations up to thread_local_cache_max_alloc_bytes are served
+// from a per-thread cache of free chunks that sits in front of the arena, so
+// that a thread re-allocating sizes it freed recently does not take the arena
+// lock. See ThreadCache in bfc_arena.cc.
 class BFCArena : public IAllocator {
  public:
   static const ArenaExtendStrategy DEFAULT_ARENA_EXTEND_STRATEGY = ArenaExtendStrategy::kNextPowerOfTwo;
@@ -57,13 +63,17 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_MAX_DEAD_BYTES_PER_CHUNK = 128 * 1024 * 1024;
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int DEFAULT_THREAD_LOCAL_CACHE_BYTES = 0;  // disabled
+  static const int DEFAULT_THREAD_LOCAL_CACHE_MAX_ALLOC_BYTES = 256 * 1024;
 
   BFCArena(std::unique_ptr<IAllocator> resource_allocator,
            size_t total_memory,
            ArenaExtendStrategy arena_extend_strategy = DEFAULT_ARENA_EXTEND_STRATEGY,
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
-           int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES);
+           int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+           int thread_local_cache_bytes = DEFAULT_THREAD_LOCAL_CACHE_BYTES,
+           int thread_local_cache_max_alloc_bytes = DEFAULT_THREAD_LOCAL_CACHE_MAX_ALLOC_BYTES);
 
   ~BFCArena() override;
 
@@ -76,6 +86,7 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks held free in thread-local caches are returned to the arena first.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -97,9 +108,41 @@ class BFCArena : public IAllocator {
   size_t AllocatedSize(const void* ptr);
 
  private:
-  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
+  class ThreadCache;
+  // The caches of the current thread by arena id, released when the thread exits.
+  struct ThreadCacheMap;
+  static ThreadCacheMap& CurrentThreadCaches();
+
+  // If thread_cache is not null the returned chunk is marked as held by that cache.
+  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure, ThreadCache* thread_cache = nullptr);
   void DeallocateRawInternal(void* ptr);
 
+  // Thread-local cache. Lock order: thread_caches_lock_, then ThreadCache::mutex, then lock_.
+  ThreadCache* GetThreadCache(bool create);
+  void* AllocateFromThreadCache(size_t size);
+  // Returns false if ptr is not held by the cache of the calling thread.
+  bool FreeToThreadCache(void* ptr);
+  // Requires cache.mutex to be held.
+  void PushToThreadCache(ThreadCache& cache, void* ptr, size_t size_class);
+  // Returns free chunks of the cache to the arena until it holds at most target_bytes.
+  // Requires cache.mutex to be held.
+  void ReturnToArena(ThreadCache& cache, size_t target_bytes);
+  // Returns the free chunks that the cache did not need since the last trim.
+  // Requires cache.mutex to be held.
+  void TrimThreadCache(ThreadCache& cache);
+  // Requires cache.mutex and lock_ to be held.
+  void ReturnChunkToArena(ThreadCache& cache, size_t size_class);
+  void FlushThreadCaches();
+  // Called when the thread owning the cache exits. Returns its free chunks to the arena, lets the chunks it
+  // handed out be freed to the arena directly, and destroys it.
+  void ReleaseThreadCache(ThreadCache* cache);
+  // Frees p to the arena unless a thread-local cache holds it, in which case that cache is returned.
+  ThreadCache* FreeToArena(void* p);
+
+  // Size classes of the thread-local cache.
+  size_t ThreadCacheSizeClass(size_t rounded_bytes);
+  static size_t ThreadCacheSizeClassBytes(size_t size_class);
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -143,6 +186,11 @@ class BFCArena : public IAllocator {
     // What bin are we in?
     BinNum bin_num = kInvalidBinNum;
 
+    // The thread-local cache holding this chunk, if any. Such a chunk is in
+    // use as far as the arena is concerned, whether or not the cache has
+    // handed it out.
+    ThreadCache* thread_cache = nullptr;
+
     bool in_use() const { return allocation_id != -1; }
 
     std::string DebugString(BFCArena* a, bool recurse) {
@@ -474,6 +522,18 @@ class BFCArena : public IAllocator {
   // is to be considered for shrinkage or not.
   bool consider_first_allocation_region_for_shrinkage_;
 
+  // Maximum free bytes held by each thread-local cache. 0 disables the cache.
+  const size_t thread_local_cache_bytes_;
+  const size_t thread_local_cache_max_alloc_bytes_;
+  const size_t num_thread_cache_size_classes_;
+
+  // Identifies this arena in the thread_local cache lookup. Never reused, so
+  // entries left behind by a destroyed arena are never matched.
+  const uint64_t arena_id_;
+
+  OrtMutex thread_caches_lock_;
+  std::vector<std::unique_ptr<ThreadCache>> thread_caches_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef __GNUC__
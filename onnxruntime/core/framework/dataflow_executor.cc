@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/dataflow_executor.h"
+
+#include <memory>
+#include <sstream>
+#include <vector>
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/allocation_planner.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/parallel_execution_utils.h"
+#include "core/framework/session_state.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+DataflowExecutor::DataflowExecutor(const SessionState& session_state, const bool& terminate_flag)
+    : terminate_flag_(terminate_flag), executor_pool_(session_state.GetInterOpThreadPool()) {
+}
+
+Status DataflowExecutor::Execute(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
+                                 gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
+                                 std::vector<OrtValue>& fetches,
+                                 const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                                 const logging::Logger& logger) {
+  TimePoint tp;
+  const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  if (is_profiler_enabled) {
+    tp = session_state.Profiler().Start();
+  }
+
+  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  const auto& dependency_counts = exec_plan.node_dependency_counts;
+
+  root_frame_ = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                                 fetch_allocators, session_state);
+
+  pending_inputs_ = std::make_unique<std::atomic<int>[]>(dependency_counts.size());
+  for (size_t i = 0, end = dependency_counts.size(); i < end; ++i) {
+    pending_inputs_[i].store(dependency_counts[i], std::memory_order_relaxed);
+  }
+
+  InlinedVector<NodeIndex> root_nodes;
+  root_nodes.reserve(exec_plan.root_nodes.size());
+  for (auto node_index : exec_plan.root_nodes) {
+    if (session_state.GetKernel(node_index) != nullptr) {
+      root_nodes.push_back(node_index);
+    }
+  }
+
+  if (!root_nodes.empty()) {
+    // account for all the root tasks up front so the count cannot reach zero while they are being scheduled
+    outstanding_tasks_.store(static_cast<int>(root_nodes.size()), std::memory_order_relaxed);
+    for (size_t i = 1; i < root_nodes.size(); ++i) {
+      ScheduleNodes(root_nodes[i], session_state, logger);
+    }
+
+    // the calling thread takes part in the execution instead of just waiting for it
+    RunNodes(root_nodes[0], session_state, logger);
+
+    std::unique_lock<OrtMutex> lock(complete_mutex_);
+    complete_cv_.wait(lock, [this]() { return completed_; });
+  }
+
+  if (!errors_.empty()) {
+    Status status;
+    if (errors_.size() == 1) {
+      status = errors_.front();
+    } else {
+      std::stringstream ss;
+      ss << "Multiple errors were found.";
+      for (const auto& s : errors_) {
+        ss << '\n'
+           << s;
+      }
+
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ss.str());
+    }
+
+    LOGS(logger, ERROR) << status;
+    return status;
+  }
+
+  VLOGS(logger, 1) << "Fetching output.";
+  // ExecutionFrame::Finalize will update 'fetches' with the final output
+  ORT_RETURN_IF_ERROR(root_frame_->GetOutputs(fetches));
+  VLOGS(logger, 1) << "Done execution.";
+
+  ORT_RETURN_IF_ERROR(parallel_execution_utils::UpdateMemoryPatterns(session_state, *root_frame_, feeds));
+
+  if (is_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "DataflowExecutor::Execute", tp);
+  }
+
+  return Status::OK();
+}
+
+void DataflowExecutor::RunNodes(NodeIndex node_index, const SessionState& session_state,
+                                const logging::Logger& logger) {
+  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+
+  auto create_exception_message = [&session_state](NodeIndex failed_node_index, const std::exception* ex) {
+    const auto* node = session_state.GetGraphViewer().GetNode(failed_node_index);
+
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running nodes starting at ", node->OpType(),
+                           " node '", node->Name(), "'. ",
+                           ex ? ex->what() : "Unknown exception was caught by catch-all handler.");
+  };
+
+  bool keep_running = true;
+
+  // Avoid context switching if possible.
+  while (keep_running) {
+    keep_running = false;
+
+    // no point running more nodes once any node has failed
+    if (has_errors_.load(std::memory_order_relaxed)) {
+      break;
+    }
+
+    Status status;
+    ORT_TRY {
+      status = parallel_execution_utils::ExecuteNode(session_state, *root_frame_, node_index, terminate_flag_, logger);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = create_exception_message(node_index, &ex);
+      });
+    }
+    ORT_CATCH(...) {
+      // catch node processing failure exceptions here to prevent app crash.
+      status = create_exception_message(node_index, nullptr);
+    }
+
+    if (!status.IsOK()) {
+      RecordError(status);
+      break;
+    }
+
+    const NodeIndex finished_node_index = node_index;
+    for (NodeIndex consumer : exec_plan.DownstreamNodes(finished_node_index)) {
+      // acq_rel so the outputs written by every producer are visible to whichever thread runs the consumer
+      if (pending_inputs_[consumer].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (!keep_running) {
+          node_index = consumer;
+          keep_running = true;
+        } else {
+          ScheduleNodes(consumer, session_state, logger);
+        }
+      }
+    }
+  }
+
+  FinishTask();
+}
+
+void DataflowExecutor::ScheduleNodes(NodeIndex node_index, const SessionState& session_state,
+                                     const logging::Logger& logger) {
+  outstanding_tasks_.fetch_add(1, std::memory_order_relaxed);
+
+  // queue on the current worker so the consumer is likely to run where its inputs are still in cache
+  onnxruntime::concurrency::ThreadPool::ScheduleLocal(executor_pool_, [this, node_index, &session_state, &logger]() {
+    RunNodes(node_index, session_state, logger);
+  });
+}
+
+void DataflowExecutor::RecordError(const Status& status) {
+  has_errors_.store(true, std::memory_order_relaxed);
+  std::lock_guard<OrtMutex> lock(errors_mutex_);
+  errors_.push_back(status);
+}
+
+void DataflowExecutor::FinishTask() {
+  if (outstanding_tasks_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    {
+      std::lock_guard<OrtMutex> lock(complete_mutex_);
+      completed_ = true;
+    }
+
+    complete_cv_.notify_all();
+  }
+}
+}  // namespace onnxruntime
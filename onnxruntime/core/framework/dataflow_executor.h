@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/iexecutor.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/session_state.h"
+#include "core/graph/graph_viewer.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class ExecutionFrame;
+
+// Executor for ExecutionMode::ORT_PARALLEL that schedules nodes by dataflow.
+//
+// Each node has an atomic counter initialized from the dependency counts precomputed in the
+// SequentialExecutionPlan. When a node finishes, the counters of its consumers are decremented without locking.
+// The first consumer that becomes ready runs inline on the finishing thread, and any others are pushed to that
+// thread's queue in the inter-op thread pool, where idle workers can steal them. Completion is tracked with an
+// atomic count of in-flight tasks, so the only lock is taken once at the end of the run to wake the caller.
+class DataflowExecutor : public IExecutor {
+ public:
+  DataflowExecutor(const SessionState& session_state, const bool& terminate_flag = false);
+
+  common::Status Execute(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
+                         gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
+                         std::vector<OrtValue>& fetches,
+                         const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                         const logging::Logger& logger) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DataflowExecutor);
+
+  // Run the node and then keep running ready consumers on the current thread until none are left.
+  void RunNodes(NodeIndex node_index, const SessionState& session_state, const logging::Logger& logger);
+
+  void ScheduleNodes(NodeIndex node_index, const SessionState& session_state, const logging::Logger& logger);
+
+  void RecordError(const Status& status);
+
+  void FinishTask();
+
+  std::unique_ptr<ExecutionFrame> root_frame_;
+  std::unique_ptr<std::atomic<int>[]> pending_inputs_;
+  std::atomic<int> outstanding_tasks_{0};
+  std::atomic<bool> has_errors_{false};
+
+  OrtMutex errors_mutex_;
+  std::vector<Status> errors_;  // protected by errors_mutex_
+
+  OrtMutex complete_mutex_;
+  OrtCondVar complete_cv_;
+  bool completed_{false};  // protected by complete_mutex_
+
+  const bool& terminate_flag_;
+  onnxruntime::concurrency::ThreadPool* const executor_pool_{};
+};
+}  // namespace onnxruntime
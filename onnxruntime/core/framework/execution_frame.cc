@@ -3,6 +3,7 @@
 
 #include "core/framework/execution_frame.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/framework/mem_pattern_planner.h"
@@ -136,13 +137,20 @@ OrtValue* IExecutionFrame::GetMutableNodeInputOrOutputMLValue(int index) {
   return const_cast<OrtValue*>(GetNodeInputOrOutputMLValue(index));
 }
 
+namespace {
+// Tensors the frames on this thread allocated from an allocator rather than placed in a buffer of the memory pattern.
+// A value is created on the thread that asks for it, so the change across one creation counts that value alone,
+// whatever the other threads of the parallel and dataflow executors allocate at the same time.
+thread_local size_t t_num_dynamic_allocations = 0;
+}  // namespace
+
 // TO DO: make it thread safe
 // This method is not thread safe!
 // Return S_OK and nullptr if index map to an value that is an unused optional input/output
 
 Status IExecutionFrame::GetOrCreateNodeOutputMLValue(const int output_index, int output_arg_index,
                                                      const TensorShape* shape, OrtValue*& p_ort_value,
-                                                     const Node& node) {
+                                                     const Node& node, size_t* num_dynamic_allocations) {
   auto status = Status::OK();
   int ort_value_idx = GetNodeIdxToMLValueIdx(output_arg_index);
 
@@ -172,7 +180,11 @@ Status IExecutionFrame::GetOrCreateNodeOutputMLValue(const int output_index, int
       if (shape != nullptr && IsOutput(ort_value_idx)) {
         VerifyOutputSizes(output_index, node, *shape);
       }
+      const size_t begin_dynamic_allocations = t_num_dynamic_allocations;
       status = CreateNodeOutputMLValueImpl(*p_ort_value, ort_value_idx, shape);
+      if (num_dynamic_allocations != nullptr) {
+        *num_dynamic_allocations += t_num_dynamic_allocations - begin_dynamic_allocations;
+      }
     }
   }
 
@@ -332,10 +344,40 @@ bool IExecutionFrame::IsOutput(int ort_value_idx) const {
   return std::find(fetch_mlvalue_idxs_.begin(), fetch_mlvalue_idxs_.end(), ort_value_idx) != fetch_mlvalue_idxs_.end();
 }
 
+// Checks that the memory pattern of a run can place its intermediate tensors in the scratch buffer the caller supplied.
+static Status CheckScratchBuffer(const ScratchBuffer& scratch_buffer, const MemoryPatternGroup& mem_patterns) {
+  std::ostringstream required;
+  for (size_t i = 0; i < mem_patterns.locations.size(); i++) {
+    const auto& location = mem_patterns.locations[i];
+    const size_t peak_size = mem_patterns.patterns[i].PeakSize();
+    if (location == scratch_buffer.location) {
+      if (scratch_buffer.size < peak_size) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The scratch buffer of ", scratch_buffer.size,
+                               " bytes is too small. The memory pattern of the run requires ", peak_size,
+                               " bytes on ", location.ToString(), ".");
+      }
+
+      return Status::OK();
+    }
+
+    if (peak_size > 0) {
+      required << " " << peak_size << " bytes on " << location.ToString() << ".";
+    }
+  }
+
+  if (required.tellp() > 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The memory pattern of the run places nothing on the location",
+                           " of the scratch buffer, ", scratch_buffer.location.ToString(), ". It requires",
+                           required.str());
+  }
+
+  return Status::OK();
+}
+
 ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
                                gsl::span<const int> fetch_mlvalue_idxs, gsl::span<const OrtValue> fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                               const SessionState& session_state)
+                               const SessionState& session_state, const ScratchBuffer* scratch_buffer)
     : IExecutionFrame(session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo(), fetch_mlvalue_idxs),
       session_state_(session_state),
       mem_patterns_(nullptr) {
@@ -387,11 +429,19 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
-      // if no existing patterns, generate one in this execution frame
-      if (!mem_patterns_) {
+      bool needs_planning = false;
+      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_, needs_planning);
+      // if no existing patterns, or the existing ones were too small for a request in the same bucket,
+      // generate one in this execution frame
+      if (needs_planning) {
         planner_.emplace(*session_state.GetExecutionPlan());
-      } else {
+      }
+
+      if (mem_patterns_ && scratch_buffer != nullptr && scratch_buffer->buffer != nullptr) {
+        scratch_buffer_status_ = CheckScratchBuffer(*scratch_buffer, *mem_patterns_);
+      }
+
+      if (mem_patterns_) {
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
         buffers_.reserve(mem_patterns_->locations.size());
@@ -420,12 +470,19 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
               // Memory dynamically allocated when executing kernels is not recorded using this field.
               static_activation_memory_sizes_in_byte_[location.name] = peak_size;
 #endif
-              buffer = alloc->Alloc(peak_size);
-              // handle allocator that doesn't throw
-              if (buffer == nullptr) {
-                // INFO level as this may fire on every run and there may not be much a user can do
-                LOGS(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
-                                                    << location.ToString() << " returned nullptr";
+              if (scratch_buffer != nullptr && scratch_buffer->buffer != nullptr && scratch_buffer_status_.IsOK() &&
+                  scratch_buffer->location == location) {
+                buffer = scratch_buffer->buffer;
+                // the caller owns the buffer, so it is not freed with the frame
+                alloc = nullptr;
+              } else {
+                buffer = alloc->Alloc(peak_size);
+                // handle allocator that doesn't throw
+                if (buffer == nullptr) {
+                  // INFO level as this may fire on every run and there may not be much a user can do
+                  LOGS(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
+                                                      << location.ToString() << " returned nullptr";
+                }
               }
             }
             ORT_CATCH(const OnnxRuntimeException& ex) {
@@ -512,6 +569,7 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
   // if we have pre-calculated memory pattern, and the ort_value is not output mlvalue
   // try to allocated on pre-allocated big chunk.
   const auto& per_alloc_plan = GetAllocationPlan(ort_value_index);
+  size_t trace_size = size;
 
   if (mem_patterns_ && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput &&
       per_alloc_plan.alloc_kind != AllocKind::kAllocatedExternally) {
@@ -520,24 +578,28 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       auto block = pattern->GetBlock(ort_value_index);
       // if block not found, fall back to default behavior
       if (block) {
+        // if the pattern is being re-planned, keep the value at least as large as it was in the previous one
+        // so that the new pattern fits every request seen so far.
+        trace_size = std::max(size, block->size_);
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // the block is reserved for this value for its whole lifetime, so a larger block can be used as is.
+          // with memory pattern buckets that is the common case, as the pattern is sized for the largest request.
+          if (block->size_ >= size) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
                 shape);
+            TraceAllocate(ort_value_index, trace_size);
             return status;
           } else {
             // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
             // fed in, so use VERBOSE as the log level as it's expected.
-            // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
-            // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
             LOGS(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
                                                    << ", block in memory pattern size is: " << block->size_
                                                    << " but the actually size is: " << size
                                                    << ", fall back to default allocation behavior";
+            mem_pattern_too_small_.store(true, std::memory_order_relaxed);
           }
         }
         // else { we couldn't allocate the large block for the buffer so we didn't insert an entry }
@@ -548,12 +610,13 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
   // no memory pattern, or the pattern is not correct.
   if (!alloc) alloc = GetAllocator(location);
   Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
+  ++t_num_dynamic_allocations;
 
   // trace the memory allocation.
   // don't trace the memory allocation on string tensors, as it need
   // placement new, we don't support it in memory pattern optimization.
   if (!utils::IsDataTypeString(element_type)) {
-    TraceAllocate(ort_value_index, size);
+    TraceAllocate(ort_value_index, trace_size);
   }
 
   {
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <unordered_map>
@@ -68,8 +70,11 @@ class IExecutionFrame {
   // This method is not thread safe!
   // Return S_OK and nullptr if index map to an value that is an unused optional input/output
   // Shape is required for tensors but not traditional ML values.
+  // If num_dynamic_allocations is not null, it is increased by the number of tensors allocated from an allocator
+  // rather than placed in a buffer of the memory pattern to create the value.
   Status GetOrCreateNodeOutputMLValue(const int index, int output_arg_index, const TensorShape* shape,
-                                      OrtValue*& p_ort_value, const Node& node);
+                                      OrtValue*& p_ort_value, const Node& node,
+                                      size_t* num_dynamic_allocations = nullptr);
 
   // This function try retrieve the inferred shapes for the given NodeArg index.
   // If the retrieval is successful, this function returns true and false otherwise.
@@ -136,7 +141,9 @@ class ExecutionFrame final : public IExecutionFrame {
                  gsl::span<const int> fetch_mlvalue_idxs, gsl::span<const OrtValue> fetches,
                  // optional custom allocators. key is index in fetches
                  const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                 const SessionState& session_state);
+                 const SessionState& session_state,
+                 // optional caller owned buffer for the memory pattern
+                 const ScratchBuffer* scratch_buffer = nullptr);
 
   ~ExecutionFrame() override;
 
@@ -158,6 +165,17 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_.has_value();
   }
 
+  // INVALID_ARGUMENT if the caller supplied a scratch buffer that the memory pattern of the run cannot use, as it is
+  // too small or on a location the pattern places nothing on. The run fails rather than allocating without notice.
+  const Status& GetScratchBufferStatus() const {
+    return scratch_buffer_status_;
+  }
+
+  // true if a value did not fit in its block of the cached memory pattern
+  bool IsMemoryPatternTooSmall() const {
+    return mem_pattern_too_small_.load(std::memory_order_relaxed);
+  }
+
   // This function try retrieve the inferred shapes for the given NodeArg index.
   // If the retrival is sucessful, this function returns true and false otherwise.
   bool TryGetInferredShape(int index, TensorShape& shape) const override;
@@ -218,7 +236,14 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  // Shared with the session state cache so it stays valid if the cached entry is replaced or evicted.
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
+
+  // Set if a value did not fit in its block of mem_patterns_ and had to use the default allocation.
+  // Atomic as the threads of the parallel and dataflow executors set it concurrently.
+  std::atomic<bool> mem_pattern_too_small_{false};
+
+  Status scratch_buffer_status_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
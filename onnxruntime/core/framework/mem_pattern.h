@@ -20,6 +20,7 @@ struct MemoryBlock {
 
 class MemoryPattern {
   friend class MemPatternPlanner;
+  friend class StaticMemoryPlanner;
 
  public:
   MemoryPattern() = default;
@@ -70,4 +71,12 @@ struct MemoryPatternGroup {
     return nullptr;
   }
 };
+
+// Caller owned memory used as the buffer of the memory pattern on location instead of allocating one for the run.
+// Only used if it is at least as large as the pattern.
+struct ScratchBuffer {
+  void* buffer{nullptr};
+  size_t size{0};
+  OrtMemoryInfo location;
+};
 }  // namespace onnxruntime
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/common/hash_combine.h"
+#include "core/common/parse_string.h"
+#include "core/common/string_utils.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+Status MemoryPatternCacheOptions::ParseBuckets(const std::string& config, BucketKind& bucket_kind,
+                                               std::vector<int64_t>& bucket_boundaries) {
+  bucket_boundaries.clear();
+
+  if (config.empty()) {
+    bucket_kind = BucketKind::kNone;
+    return Status::OK();
+  }
+
+  if (config == "pow2") {
+    bucket_kind = BucketKind::kPowerOfTwo;
+    return Status::OK();
+  }
+
+  for (const auto& value_str : utils::SplitString(config, ",")) {
+    int64_t value = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(value_str, value) && value > 0,
+                      "Invalid memory pattern bucket boundary '", value_str, "' in '", config,
+                      "'. Expected 'pow2' or a comma separated list of positive integers.");
+    ORT_RETURN_IF_NOT(bucket_boundaries.empty() || value > bucket_boundaries.back(),
+                      "Memory pattern bucket boundaries must be increasing: ", config);
+    bucket_boundaries.push_back(value);
+  }
+
+  bucket_kind = BucketKind::kList;
+  return Status::OK();
+}
+
+int64_t MemoryPatternCache::RoundUpDim(int64_t dim) const {
+  switch (options_.bucket_kind) {
+    case MemoryPatternCacheOptions::BucketKind::kPowerOfTwo: {
+      if (dim <= 1) {
+        return dim;
+      }
+
+      int64_t rounded = 1;
+      while (rounded < dim && rounded <= std::numeric_limits<int64_t>::max() / 2) {
+        rounded <<= 1;
+      }
+
+      return rounded < dim ? dim : rounded;
+    }
+    case MemoryPatternCacheOptions::BucketKind::kList: {
+      const auto& boundaries = options_.bucket_boundaries;
+      auto it = std::lower_bound(boundaries.cbegin(), boundaries.cend(), dim);
+      return it == boundaries.cend() ? dim : *it;
+    }
+    default:
+      return dim;
+  }
+}
+
+int64_t MemoryPatternCache::CalculateKey(gsl::span<const OrtValue> tensor_inputs) const {
+  size_t key = 0;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    // include the rank so that e.g. {2, 3},{4} and {2},{3, 4} differ
+    HashCombine(dims.size(), key);
+    for (auto dim : dims) {
+      HashCombine(RoundUpDim(dim), key);
+    }
+  }
+
+  return static_cast<int64_t>(key);
+}
+
+void MemoryPatternCache::Touch(Entry& entry) {
+  lru_.splice(lru_.begin(), lru_, entry.lru_position);
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Find(int64_t key, bool& needs_planning) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++stats_.misses;
+    needs_planning = true;
+    return nullptr;
+  }
+
+  Entry& entry = it->second;
+  Touch(entry);
+
+  if (entry.too_small) {
+    ++stats_.misses;
+    needs_planning = true;
+  } else {
+    ++stats_.hits;
+    needs_planning = false;
+  }
+
+  return entry.patterns;
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Peek(int64_t key) const {
+  auto it = entries_.find(key);
+  if (it == entries_.end() || it->second.too_small) {
+    return nullptr;
+  }
+
+  return it->second.patterns;
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Insert(int64_t key, MemoryPatternGroup patterns) {
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    Entry& entry = it->second;
+    // Do not replace a usable entry. Another run in the same bucket may have planned it concurrently.
+    if (entry.too_small) {
+      entry.patterns = std::make_shared<const MemoryPatternGroup>(std::move(patterns));
+      entry.too_small = false;
+    }
+
+    Touch(entry);
+    return entry.patterns;
+  }
+
+  if (options_.max_entries != 0 && entries_.size() >= options_.max_entries) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+    ++stats_.evictions;
+  }
+
+  lru_.push_front(key);
+  Entry& entry = entries_[key];
+  entry.patterns = std::make_shared<const MemoryPatternGroup>(std::move(patterns));
+  entry.lru_position = lru_.begin();
+  return entry.patterns;
+}
+
+void MemoryPatternCache::MarkTooSmall(int64_t key) {
+  auto it = entries_.find(key);
+  if (it != entries_.end() && !it->second.too_small) {
+    it->second.too_small = true;
+    ++stats_.regrowths;
+  }
+}
+
+MemoryPatternCacheStats MemoryPatternCache::GetStats() const {
+  MemoryPatternCacheStats stats = stats_;
+  stats.num_entries = entries_.size();
+  return stats;
+}
+
+}  // namespace onnxruntime
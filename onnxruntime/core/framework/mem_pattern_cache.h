@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+
+// How the dims of the feeds are mapped to a memory pattern cache key.
+struct MemoryPatternCacheOptions {
+  enum class BucketKind {
+    kNone,        // exact shapes
+    kPowerOfTwo,  // round each dim up to the next power of two
+    kList,        // round each dim up to the next value in bucket_boundaries. larger dims are used as is.
+  };
+
+  BucketKind bucket_kind{BucketKind::kNone};
+  std::vector<int64_t> bucket_boundaries;
+
+  // maximum number of cached patterns. 0 means no limit.
+  size_t max_entries{0};
+
+  // Parse the value of the kOrtSessionOptionsConfigMemoryPatternBuckets config entry:
+  //   "" (exact shapes), "pow2", or a comma separated list of increasing positive values such as "16,32,64,128".
+  static Status ParseBuckets(const std::string& config, BucketKind& bucket_kind,
+                             std::vector<int64_t>& bucket_boundaries);
+};
+
+struct MemoryPatternCacheStats {
+  uint64_t hits{0};       // lookups that found a usable pattern
+  uint64_t misses{0};     // lookups that had to plan a pattern
+  uint64_t evictions{0};  // patterns dropped to stay within max_entries
+  uint64_t regrowths{0};  // bucket patterns that were too small for a request and are re-planned
+  size_t num_entries{0};
+};
+
+/*
+Cache of the MemoryPatternGroup generated for a set of input shapes.
+
+With bucketing, every request whose dims round up to the same values shares a pattern. The pattern is planned from
+the first request in the bucket, so a later, larger request in the bucket may not fit. When that happens the
+pattern is marked as too small and the next request in the bucket plans a new one, tracing each tensor at no less
+than its size in the previous pattern. The pattern therefore only grows and settles at the largest request seen.
+
+Entries are shared_ptr so that an ExecutionFrame can keep using a pattern that is replaced or evicted while it runs.
+Not thread-safe. SessionState serializes access.
+*/
+class MemoryPatternCache {
+ public:
+  MemoryPatternCache() = default;
+
+  void SetOptions(MemoryPatternCacheOptions options) { options_ = std::move(options); }
+  const MemoryPatternCacheOptions& Options() const { return options_; }
+
+  bool UsesBuckets() const { return options_.bucket_kind != MemoryPatternCacheOptions::BucketKind::kNone; }
+
+  int64_t RoundUpDim(int64_t dim) const;
+
+  // All inputs must be Tensors.
+  int64_t CalculateKey(gsl::span<const OrtValue> tensor_inputs) const;
+
+  // Returns the cached patterns for the key, or nullptr. needs_planning is set if the caller should trace the
+  // allocations of this run and call Insert with the result: either there was no entry, or the entry is too small.
+  std::shared_ptr<const MemoryPatternGroup> Find(int64_t key, bool& needs_planning);
+
+  // Returns the cached patterns for the key if they are usable, without counting a lookup.
+  std::shared_ptr<const MemoryPatternGroup> Peek(int64_t key) const;
+
+  // Add patterns for the key. An existing entry is only replaced if it was marked as too small.
+  std::shared_ptr<const MemoryPatternGroup> Insert(int64_t key, MemoryPatternGroup patterns);
+
+  void MarkTooSmall(int64_t key);
+
+  MemoryPatternCacheStats GetStats() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+    std::list<int64_t>::iterator lru_position;
+    bool too_small{false};
+  };
+
+  void Touch(Entry& entry);
+
+  MemoryPatternCacheOptions options_;
+  InlinedHashMap<int64_t, Entry> entries_;
+  // most recently used key at the front
+  std::list<int64_t> lru_;
+  MemoryPatternCacheStats stats_;
+};
+
+}  // namespace onnxruntime
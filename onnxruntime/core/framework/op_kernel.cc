@@ -77,7 +77,8 @@ OrtValue* OpKernelContext::OutputMLValue(int index, const TensorShape& shape) {
   //I believe it's a false alarm.
 
   OrtValue* p_ml_value = nullptr;
-  Status status = execution_frame_->GetOrCreateNodeOutputMLValue(index, GetOutputArgIndex(index), &shape, p_ml_value, kernel_->Node());
+  Status status = execution_frame_->GetOrCreateNodeOutputMLValue(index, GetOutputArgIndex(index), &shape, p_ml_value, kernel_->Node(),
+                                                                 &num_dynamic_allocations_);
   ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
   return p_ml_value;
 }
@@ -151,7 +152,8 @@ Fence_t OpKernelContext::OutputFence(int index) const {
 OrtValue* OpKernelContext::GetOrCreateOutputMLValue(int index) {
   auto output_arg_index = GetOutputArgIndex(index);
   OrtValue* value = nullptr;
-  auto status = execution_frame_->GetOrCreateNodeOutputMLValue(index, output_arg_index, nullptr, value, kernel_->Node());
+  auto status = execution_frame_->GetOrCreateNodeOutputMLValue(index, output_arg_index, nullptr, value, kernel_->Node(),
+                                                               &num_dynamic_allocations_);
   ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
   return value;
 }
@@ -13,7 +13,9 @@ OpKernelInfo::OpKernelInfo(const onnxruntime::Node& node,
                            const IExecutionProvider& execution_provider,
                            const std::unordered_map<int, OrtValue>& constant_initialized_tensors,
                            const OrtValueNameIdxMap& ort_value_name_idx_map,
-                           const DataTransferManager& data_transfer_mgr)
+                           const DataTransferManager& data_transfer_mgr,
+                           const ConfigOptions& config_options,
+                           concurrency::ThreadPool* thread_pool)
     : OpNodeProtoHelper(&proto_helper_context_),
       node_(node),
       kernel_def_(kernel_def),
@@ -21,11 +23,13 @@ OpKernelInfo::OpKernelInfo(const onnxruntime::Node& node,
       constant_initialized_tensors_(constant_initialized_tensors),
       ort_value_name_idx_map_(ort_value_name_idx_map),
       data_transfer_mgr_(data_transfer_mgr),
+      config_options_(config_options),
+      thread_pool_(thread_pool),
       proto_helper_context_(node) {}
 
 OpKernelInfo::OpKernelInfo(const OpKernelInfo& other)
     : OpKernelInfo(other.node_, other.kernel_def_, *other.execution_provider_, other.constant_initialized_tensors_,
-                   other.ort_value_name_idx_map_, other.data_transfer_mgr_) {}
+                   other.ort_value_name_idx_map_, other.data_transfer_mgr_, other.config_options_, other.thread_pool_) {}
 
 const OrtMemoryInfo& OpKernelInfo::GetMemoryInfo(int device_id, OrtMemType mem_type) const {
   AllocatorPtr alloc = GetAllocator(device_id, mem_type);
@@ -49,6 +53,14 @@ const DataTransferManager& OpKernelInfo::GetDataTransferManager() const noexcept
   return data_transfer_mgr_;
 }
 
+const ConfigOptions& OpKernelInfo::GetConfigOptions() const noexcept {
+  return config_options_;
+}
+
+concurrency::ThreadPool* OpKernelInfo::GetThreadPool() const noexcept {
+  return thread_pool_;
+}
+
 const onnxruntime::Node& OpKernelInfo::node() const noexcept {
   return node_;
 }
@@ -0,0 +1,227 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <unordered_map>
+
+#include "core/graph/graph_viewer.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace onnxruntime {
+
+namespace {
+
+// value must be non-zero
+int FloorLog2(uint64_t value) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return static_cast<int>(index);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32))) {
+    return static_cast<int>(index) + 32;
+  }
+  _BitScanReverse(&index, static_cast<unsigned long>(value));
+  return static_cast<int>(index);
+#else
+  return 63 - __builtin_clzll(value);
+#endif
+}
+
+void WriteJsonString(std::ostream& os, const std::string& str) {
+  os << '"';
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          static constexpr char kHexDigits[] = "0123456789abcdef";
+          os << "\\u00" << kHexDigits[(c >> 4) & 0xf] << kHexDigits[c & 0xf];
+        } else {
+          os << c;
+        }
+    }
+  }
+  os << '"';
+}
+
+}  // namespace
+
+size_t LatencyHistogram::GetBucketIndex(uint64_t value) noexcept {
+  if (value < kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+
+  if (value >= (uint64_t{1} << kMaxValueBits)) {
+    return kNumBuckets - 1;
+  }
+
+  const int exponent = FloorLog2(value);
+
+  // the sub bucket is given by the kSubBucketBits bits following the highest set bit
+  const int shift = exponent - kSubBucketBits;
+  return static_cast<size_t>(shift + 1) * kSubBuckets + static_cast<size_t>((value >> shift) - kSubBuckets);
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t index) noexcept {
+  if (index < kSubBuckets) {
+    return index;
+  }
+
+  const int shift = static_cast<int>(index / kSubBuckets) - 1;
+  const uint64_t lower_bound = (kSubBuckets + index % kSubBuckets) << shift;
+  return lower_bound + (uint64_t{1} << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t latency_ns) noexcept {
+  buckets_[GetBucketIndex(latency_ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_.fetch_add(latency_ns, std::memory_order_relaxed);
+
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (latency_ns > max && !max_.compare_exchange_weak(max, latency_ns, std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const noexcept {
+  // the buckets are read one at a time, so use their sum rather than count_ in case of concurrent recording
+  std::array<uint64_t, kNumBuckets> counts;
+  uint64_t count = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    count += counts[i];
+  }
+
+  if (count == 0) {
+    return 0;
+  }
+
+  const auto rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100.0 * count)));
+  uint64_t cumulative_count = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    cumulative_count += counts[i];
+    if (cumulative_count >= rank) {
+      return std::min(GetBucketUpperBound(i), Max());
+    }
+  }
+
+  return Max();
+}
+
+void LatencyHistogram::Reset() noexcept {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+
+  count_.store(0, std::memory_order_relaxed);
+  total_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+void OpMetrics::Entry::Record(uint64_t latency_ns, size_t num_allocations) noexcept {
+  latency.Record(latency_ns);
+  if (num_allocations > 0) {
+    allocations.fetch_add(num_allocations, std::memory_order_relaxed);
+  }
+}
+
+OpMetrics::OpMetrics(const GraphViewer& graph_viewer) {
+  nodes_.resize(graph_viewer.MaxNodeIndex());
+  std::unordered_map<std::string, Entry*> op_types;
+  for (const auto& node : graph_viewer.Nodes()) {
+    Entry*& op_type_entry = op_types[node.OpType()];
+    if (op_type_entry == nullptr) {
+      op_types_.push_back(std::make_unique<Entry>(node.OpType()));
+      op_type_entry = op_types_.back().get();
+    }
+
+    auto name = node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name();
+    nodes_[node.Index()] = std::make_unique<NodeEntry>(NodeEntry{std::make_unique<Entry>(std::move(name)),
+                                                                 op_type_entry});
+  }
+}
+
+void OpMetrics::RecordNode(NodeIndex node_index, uint64_t latency_ns, size_t num_allocations) noexcept {
+  if (node_index >= nodes_.size() || !nodes_[node_index]) {
+    return;
+  }
+
+  NodeEntry& node = *nodes_[node_index];
+  node.entry->Record(latency_ns, num_allocations);
+  node.op_type_entry->Record(latency_ns, num_allocations);
+}
+
+void OpMetrics::Reset() noexcept {
+  for (auto& node : nodes_) {
+    if (node) {
+      node->entry->latency.Reset();
+      node->entry->allocations.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  for (auto& op_type : op_types_) {
+    op_type->latency.Reset();
+    op_type->allocations.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::string OpMetrics::ToJson() const {
+  std::ostringstream ss;
+  const auto write_metrics = [&ss](const Entry& entry) {
+    const auto& latency = entry.latency;
+    ss << ", \"count\": " << latency.Count()
+       << ", \"total_ns\": " << latency.Total()
+       << ", \"p50_ns\": " << latency.GetPercentile(50)
+       << ", \"p90_ns\": " << latency.GetPercentile(90)
+       << ", \"p99_ns\": " << latency.GetPercentile(99)
+       << ", \"max_ns\": " << latency.Max()
+       << ", \"allocations\": " << entry.allocations.load(std::memory_order_relaxed) << "}";
+  };
+
+  ss << "{\"op_types\": [";
+  bool first = true;
+  for (const auto& op_type : op_types_) {
+    if (op_type->latency.Count() == 0) {
+      continue;
+    }
+
+    ss << (first ? "" : ", ") << "{\"name\": ";
+    WriteJsonString(ss, op_type->name);
+    write_metrics(*op_type);
+    first = false;
+  }
+
+  ss << "], \"nodes\": [";
+  first = true;
+  for (const auto& node : nodes_) {
+    if (!node || node->entry->latency.Count() == 0) {
+      continue;
+    }
+
+    ss << (first ? "" : ", ") << "{\"name\": ";
+    WriteJsonString(ss, node->entry->name);
+    ss << ", \"op_type\": ";
+    WriteJsonString(ss, node->op_type_entry->name);
+    write_metrics(*node->entry);
+    first = false;
+  }
+
+  ss << "]}";
+  return ss.str();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+
+/*
+Histogram of latencies in nanoseconds that can be recorded to concurrently without locking.
+
+Buckets are log-linear as in HdrHistogram: each power of two range is split into kSubBuckets buckets of equal width,
+so a recorded value is known within 1 / kSubBuckets of its value. Values from 2^40 ns (about 18 minutes) up go to the
+last bucket.
+*/
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+  static constexpr int kMaxValueBits = 40;
+  static constexpr size_t kNumBuckets = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+  LatencyHistogram() = default;
+
+  void Record(uint64_t latency_ns) noexcept;
+
+  // Returns the largest value of the bucket the percentile falls in, where percentile is in [0, 100].
+  // Returns 0 if nothing was recorded.
+  uint64_t GetPercentile(double percentile) const noexcept;
+
+  uint64_t Count() const noexcept { return count_.load(std::memory_order_relaxed); }
+  uint64_t Total() const noexcept { return total_.load(std::memory_order_relaxed); }
+  uint64_t Max() const noexcept { return max_.load(std::memory_order_relaxed); }
+
+  // Values recorded concurrently with Reset may be partially kept.
+  void Reset() noexcept;
+
+  static size_t GetBucketIndex(uint64_t value) noexcept;
+  static uint64_t GetBucketUpperBound(size_t index) noexcept;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LatencyHistogram);
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> total_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+/*
+Always-on, low overhead metrics of the nodes of a graph: a latency histogram and the number of output allocations
+that were not served by a memory pattern, for each node and for each op type.
+
+The entries for all the nodes are created up front so that recording only updates atomic counters.
+*/
+class OpMetrics {
+ public:
+  explicit OpMetrics(const GraphViewer& graph_viewer);
+
+  void RecordNode(NodeIndex node_index, uint64_t latency_ns, size_t num_allocations) noexcept;
+
+  void Reset() noexcept;
+
+  // Returns the metrics as JSON:
+  // {"op_types": [{"name", "count", "total_ns", "p50_ns", "p90_ns", "p99_ns", "max_ns", "allocations"}, ...],
+  //  "nodes": [{"name", "op_type", "count", ...}, ...]}
+  // Entries that were not recorded since the last reset are omitted.
+  std::string ToJson() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OpMetrics);
+
+  struct Entry {
+    explicit Entry(std::string name) : name(std::move(name)) {}
+
+    void Record(uint64_t latency_ns, size_t num_allocations) noexcept;
+
+    const std::string name;
+    LatencyHistogram latency;
+    std::atomic<uint64_t> allocations{0};
+  };
+
+  struct NodeEntry {
+    std::unique_ptr<Entry> entry;
+    Entry* op_type_entry;
+  };
+
+  // indexed by node index. null for indices without a node.
+  std::vector<std::unique_ptr<NodeEntry>> nodes_;
+  std::vector<std::unique_ptr<Entry>> op_types_;
+};
+
+}  // namespace onnxruntime
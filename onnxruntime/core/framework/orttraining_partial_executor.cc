@@ -504,6 +504,9 @@ Status PartialExecutor::Execute(const SessionState& session_state, gsl::span<con
       ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
     }
+  } else if (frame.IsMemoryPatternTooSmall()) {
+    // re-plan the pattern on the next run in this bucket
+    session_state.MarkMemoryPatternGroupTooSmall(feeds);
   }
 
   if (is_profiler_enabled) {
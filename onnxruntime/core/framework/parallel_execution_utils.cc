@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/parallel_execution_utils.h"
+
+#include <chrono>
+#include <sstream>
+
+#include "core/framework/execution_frame.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/op_metrics.h"
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace parallel_execution_utils {
+
+Status ExecuteNode(const SessionState& session_state, ExecutionFrame& frame, NodeIndex node_index,
+                   const bool& terminate_flag, const logging::Logger& logger) {
+  if (terminate_flag) {
+    LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+  }
+
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  TimePoint sync_time_begin;
+  TimePoint kernel_begin_time;
+
+  const auto* p_op_kernel = session_state.GetKernel(node_index);
+  const auto& node = *graph_viewer.GetNode(node_index);
+
+  // if a kernel has been added in the session state, it better be NON-null.
+  if (p_op_kernel == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Got nullptr from GetKernel for node: ", node.Name());
+  }
+
+  OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, logger, terminate_flag);
+
+  if (f_profiler_enabled) {
+    sync_time_begin = session_state.Profiler().Start();
+  }
+
+  // sync before compute
+  int queue_id = p_op_kernel->KernelDef().ExecQueueId();
+  if (exec_plan.NodeHasFence(node_index)) {
+    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.InputFence(input_index);
+      if (fence) {
+        auto execution_provider_type = node.GetExecutionProviderType();
+        if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
+          execution_provider_type = kCpuExecutionProvider;
+        }
+        fence->BeforeUsingAsInput(execution_provider_type, queue_id);
+      }
+    }
+
+    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+      if (fence) {
+        auto execution_provider_type = node.GetExecutionProviderType();
+        if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
+          execution_provider_type = kCpuExecutionProvider;
+        }
+        fence->BeforeUsingAsInput(execution_provider_type, queue_id);
+      }
+    }
+
+    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+      Fence_t fence = op_kernel_context.OutputFence(output_index);
+      if (fence) {
+        fence->BeforeUsingAsOutput(node.GetExecutionProviderType(), queue_id);
+      }
+    }
+  }
+
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_fence_before",
+                                                   sync_time_begin,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()}});
+    concurrency::ThreadPool::StartProfiling(session_state.GetThreadPool());
+    kernel_begin_time = session_state.Profiler().Start();
+  }
+
+  // call compute on the kernel
+  VLOGS(logger, 1) << "Computing kernel: " << node.Name();
+
+  OpMetrics* const op_metrics = session_state.GetOpMetrics();
+  std::chrono::steady_clock::time_point metrics_begin_time;
+  size_t metrics_begin_allocations = 0;
+  if (op_metrics) {
+    metrics_begin_allocations = op_kernel_context.NumDynamicAllocations();
+    metrics_begin_time = std::chrono::steady_clock::now();
+  }
+
+  Status status;
+  ORT_TRY {
+#ifdef ENABLE_TRAINING
+    if (p_op_kernel->KernelDef().AllocateInputsContiguously()) {
+      ORT_RETURN_IF_ERROR(utils::VerifyInputTensorsAllocatedContiguously(&op_kernel_context));
+    }
+#endif
+
+    status = p_op_kernel->Compute(&op_kernel_context);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
+
+  if (!status.IsOK()) {
+    std::ostringstream ss;
+    ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
+       << "' Status Message: " << status.ErrorMessage();
+    const auto msg_string = ss.str();
+    LOGS(logger, ERROR) << msg_string;
+    return Status(status.Category(), status.Code(), msg_string);
+  }
+
+  if (op_metrics) {
+    const auto latency = std::chrono::steady_clock::now() - metrics_begin_time;
+    op_metrics->RecordNode(node_index,
+                           static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()),
+                           op_kernel_context.NumDynamicAllocations() - metrics_begin_allocations);
+  }
+
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_kernel_time",
+                                                   kernel_begin_time,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()},
+                                                    {"provider", p_op_kernel->KernelDef().Provider()},
+                                                    {"thread_scheduling_stats", concurrency::ThreadPool::StopProfiling(session_state.GetThreadPool())}});
+
+    sync_time_begin = session_state.Profiler().Start();
+  }
+
+  // sync after compute for outputs
+  if (exec_plan.NodeHasFence(node_index)) {
+    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.InputFence(input_index);
+      if (fence) {
+        fence->AfterUsedAsInput(queue_id);
+      }
+    }
+
+    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+      if (fence) {
+        fence->AfterUsedAsInput(queue_id);
+      }
+    }
+
+    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+      Fence_t fence = op_kernel_context.OutputFence(output_index);
+      if (fence) {
+        fence->AfterUsedAsOutput(queue_id);
+      }
+    }
+  }
+
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_fence_after",
+                                                   sync_time_begin,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()}});
+  }
+
+  return Status::OK();
+}
+
+Status UpdateMemoryPatterns(const SessionState& session_state, ExecutionFrame& frame,
+                            gsl::span<const OrtValue> feeds) {
+  if (frame.HasMemoryPatternPlanner()) {
+    bool all_tensors = true;
+    for (const auto& feed : feeds) {
+      if (!(feed.IsTensor())) {
+        all_tensors = false;
+        break;
+      }
+    }
+
+    if (all_tensors) {
+      MemoryPatternGroup mem_patterns;
+      ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns));
+      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
+    }
+  } else if (frame.IsMemoryPatternTooSmall()) {
+    // re-plan the pattern on the next run in this bucket
+    session_state.MarkMemoryPatternGroupTooSmall(feeds);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace parallel_execution_utils
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/ort_value.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class ExecutionFrame;
+class SessionState;
+
+// Steps shared by the executors of ExecutionMode::ORT_PARALLEL, ParallelExecutor and DataflowExecutor.
+namespace parallel_execution_utils {
+
+// Runs the kernel of a node: waits on the fences of its inputs and outputs, computes it and signals the fences,
+// recording the profiler events of each step. Exceptions thrown by the kernel are returned as an error status.
+common::Status ExecuteNode(const SessionState& session_state, ExecutionFrame& frame, NodeIndex node_index,
+                           const bool& terminate_flag, const logging::Logger& logger);
+
+// Caches the memory pattern that the run planned for its feeds once the run has succeeded, or marks the cached pattern
+// as too small if the run outgrew it.
+common::Status UpdateMemoryPatterns(const SessionState& session_state, ExecutionFrame& frame,
+                                    gsl::span<const OrtValue> feeds);
+
+}  // namespace parallel_execution_utils
+}  // namespace onnxruntime
@@ -11,9 +11,8 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/parallel_execution_utils.h"
 #include "core/framework/session_state.h"
-#include "core/framework/op_kernel_context_internal.h"
-#include "core/framework/utils.h"
 #include "core/platform/threadpool.h"
 
 namespace onnxruntime {
@@ -81,21 +80,7 @@ Status ParallelExecutor::Execute(const SessionState& session_state, gsl::span<co
   ORT_RETURN_IF_ERROR(root_frame_->GetOutputs(fetches));
   VLOGS(logger, 1) << "Done execution.";
 
-  if (root_frame_->HasMemoryPatternPlanner()) {
-    bool all_tensors = true;
-    for (const auto& feed : feeds) {
-      if (!(feed.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
-    }
-
-    if (all_tensors) {
-      MemoryPatternGroup mem_patterns;
-      ORT_RETURN_IF_ERROR(root_frame_->GeneratePatterns(mem_patterns));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
-    }
-  }
+  ORT_RETURN_IF_ERROR(parallel_execution_utils::UpdateMemoryPatterns(session_state, *root_frame_, feeds));
 
   if (is_profiler_enabled) {
     session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
@@ -114,143 +99,15 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   size_t node_index = p_node_index;
   bool keep_running = true;
   const auto& graph_viewer = session_state.GetGraphViewer();
-  TimePoint sync_time_begin;
-  TimePoint kernel_begin_time;
-  const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
-  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
 
   // Avoid context switching if possible.
   while (keep_running) {
-    // TODO: Convert RunNodeAsync return Status.
-    // to also handle exception propagation
-    if (terminate_flag_) {
-      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
-      ORT_THROW("Exiting due to terminate flag being set to true.");
-    }
-
-    const auto* p_op_kernel = session_state.GetKernel(node_index);
-    const auto& node = *graph_viewer.GetNode(node_index);
-
-    // if a kernel has been added in the session state, it better be NON-null.
-    if (p_op_kernel == nullptr) {
-      ORT_THROW("Got nullptr from GetKernel for node: ", node.Name());
-    }
-
-    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
-
-    if (f_profiler_enabled) {
-      sync_time_begin = session_state.Profiler().Start();
-    }
-    // sync before compute
-    int queue_id = p_op_kernel->KernelDef().ExecQueueId();
-    if (exec_plan.NodeHasFence(node_index)) {
-      for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.InputFence(input_index);
-        if (fence) {
-          auto execution_provider_type = node.GetExecutionProviderType();
-          if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
-            execution_provider_type = kCpuExecutionProvider;
-          }
-          fence->BeforeUsingAsInput(execution_provider_type, queue_id);
-        }
-      }
-
-      for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
-        if (fence) {
-          auto execution_provider_type = node.GetExecutionProviderType();
-          if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
-            execution_provider_type = kCpuExecutionProvider;
-          }
-          fence->BeforeUsingAsInput(execution_provider_type, queue_id);
-        }
-      }
-
-      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
-        Fence_t fence = op_kernel_context.OutputFence(output_index);
-        if (fence) {
-          fence->BeforeUsingAsOutput(node.GetExecutionProviderType(), queue_id);
-        }
-      }
-    }
-
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_fence_before",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
-      concurrency::ThreadPool::StartProfiling(session_state.GetThreadPool());
-      kernel_begin_time = session_state.Profiler().Start();
-    }
-
-    // call compute on the kernel
-    VLOGS(logger, 1) << "Computing kernel: " << node.Name();
-
-    // Execute the kernel.
-    ORT_TRY {
-#ifdef ENABLE_TRAINING
-      if (p_op_kernel->KernelDef().AllocateInputsContiguously()) {
-        ORT_RETURN_IF_ERROR(utils::VerifyInputTensorsAllocatedContiguously(&op_kernel_context));
-      }
-#endif
-
-      status = p_op_kernel->Compute(&op_kernel_context);
-    }
-    ORT_CATCH(const std::exception& ex) {
-      ORT_HANDLE_EXCEPTION([&]() {
-        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
-      });
-    }
-
+    status = parallel_execution_utils::ExecuteNode(session_state, *root_frame_, node_index, terminate_flag_, logger);
     if (!status.IsOK()) {
-      std::ostringstream ss;
-      ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
-         << "' Status Message: " << status.ErrorMessage();
-      const auto msg_string = ss.str();
-      LOGS(logger, ERROR) << msg_string;
-      status = Status(status.Category(), status.Code(), msg_string);
       break;
     }
 
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()},
-                                                      {"provider", p_op_kernel->KernelDef().Provider()},
-                                                      {"thread_scheduling_stats", concurrency::ThreadPool::StopProfiling(session_state.GetThreadPool())}});
-
-      sync_time_begin = session_state.Profiler().Start();
-    }
-    // sync after compute for outputs
-    if (exec_plan.NodeHasFence(node_index)) {
-      for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.InputFence(input_index);
-        if (fence) {
-          fence->AfterUsedAsInput(queue_id);
-        }
-      }
-
-      for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
-        if (fence) {
-          fence->AfterUsedAsInput(queue_id);
-        }
-      }
-
-      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
-        Fence_t fence = op_kernel_context.OutputFence(output_index);
-        if (fence) {
-          fence->AfterUsedAsOutput(queue_id);
-        }
-      }
-    }
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_fence_after",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
-    }
+    const auto& node = *graph_viewer.GetNode(node_index);
 
     //std::cout << "Run async node finish: " << p_node_index << std::endl;
 
@@ -2,6 +2,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 #include "core/framework/run_options.h"
+#include "core/framework/allocator.h"
 #include "core/session/onnxruntime_c_api.h"
 #include "core/session/ort_apis.h"
 #include "core/framework/error_code_helper.h"
@@ -56,6 +57,28 @@ ORT_API_STATUS_IMPL(OrtApis::RunOptionsUnsetTerminate, _Inout_ OrtRunOptions* op
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetScratchBuffer, _Inout_ OrtRunOptions* options,
+                    _In_opt_ const OrtMemoryInfo* mem_info, _In_opt_ void* buffer, size_t buffer_size) {
+  if (buffer == nullptr) {
+    options->scratch_buffer = nullptr;
+    options->scratch_buffer_size = 0;
+    return nullptr;
+  }
+
+  if (mem_info == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "mem_info is required for a scratch buffer.");
+  }
+
+  if (reinterpret_cast<uintptr_t>(buffer) % onnxruntime::kAllocAlignment != 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Scratch buffer must be aligned to 256 bytes.");
+  }
+
+  options->scratch_buffer = buffer;
+  options->scratch_buffer_size = buffer_size;
+  options->scratch_buffer_location = *mem_info;
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(OrtApis::AddRunConfigEntry, _Inout_ OrtRunOptions* options,
                     _In_z_ const char* config_key, _In_z_ const char* config_value) {
   return onnxruntime::ToOrtStatus(options->config_options.AddConfigEntry(config_key, config_value));
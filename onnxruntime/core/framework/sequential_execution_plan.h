@@ -125,6 +125,17 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   // to_be_freed: vector elements represent indices of ml-values to be freed (as described above)
   InlinedVector<OrtValueIndex> to_be_freed;
 
+  // Node dependency information used by the DataflowExecutor, precomputed so that a run does not need to walk
+  // the graph edges. Both node_dependency_counts and downstream_offsets are indexed by node index.
+  //   node_dependency_counts[n]: number of input edges of node n coming from nodes in this plan.
+  //   downstream_nodes[downstream_offsets[n] .. downstream_offsets[n + 1]): the consumers of node n, one entry per
+  //   edge, so a node becomes ready once it has been notified node_dependency_counts[n] times.
+  //   root_nodes: nodes with no dependencies, in execution order.
+  InlinedVector<int> node_dependency_counts;
+  InlinedVector<size_t> downstream_offsets;
+  InlinedVector<onnxruntime::NodeIndex> downstream_nodes;
+  InlinedVector<onnxruntime::NodeIndex> root_nodes;
+
   const OrtMemoryInfo& GetLocation(size_t ort_value_index) const override {
     return allocation_plan[ort_value_index].location;
   }
@@ -146,6 +157,12 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   bool NodeHasFence(onnxruntime::NodeIndex node_index) const {
     return node_has_fence[node_index];
   }
+
+  // Consumers of a given node. Each consumer appears once per edge between the two nodes.
+  gsl::span<const onnxruntime::NodeIndex> DownstreamNodes(onnxruntime::NodeIndex node_index) const {
+    return gsl::make_span(downstream_nodes.data() + downstream_offsets[node_index],
+                          downstream_offsets[node_index + 1] - downstream_offsets[node_index]);
+  }
 };
 
 // Output details of an execution plan:
@@ -13,6 +13,7 @@
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/op_metrics.h"
 #include "core/framework/utils.h"
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
@@ -147,6 +148,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
                                    const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                    const logging::Logger& logger) {
   const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  OpMetrics* const op_metrics = session_state.GetOpMetrics();
   TimePoint tp;
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
@@ -160,7 +162,9 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
     tp = session_state.Profiler().Start();
   }
 
-  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state,
+                       scratch_buffer_};
+  ORT_RETURN_IF_ERROR(frame.GetScratchBufferStatus());
 
 #if !defined(ORT_MINIMAL_BUILD)
   const auto* const to_be_executed_nodes = session_state.GetToBeExecutedNodes(fetch_mlvalue_idxs);
@@ -324,6 +328,13 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
                                node_name_for_profiling, input_type_shape);
     }
 
+    std::chrono::steady_clock::time_point metrics_begin_time;
+    size_t metrics_begin_allocations = 0;
+    if (op_metrics) {
+      metrics_begin_allocations = op_kernel_context.NumDynamicAllocations();
+      metrics_begin_time = std::chrono::steady_clock::now();
+    }
+
     Status compute_status;
     {
 #ifdef CONCURRENCY_VISUALIZER
@@ -370,6 +381,13 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
       return Status(compute_status.Category(), compute_status.Code(), msg_string);
     }
 
+    if (op_metrics) {
+      const auto latency = std::chrono::steady_clock::now() - metrics_begin_time;
+      op_metrics->RecordNode(node_index,
+                             static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()),
+                             op_kernel_context.NumDynamicAllocations() - metrics_begin_allocations);
+    }
+
     if (is_profiler_enabled) {
       // Calculate total output sizes for this operation.
       CalculateTotalOutputSizes(&op_kernel_context, total_output_sizes, node_name_for_profiling, output_type_shape);
@@ -501,6 +519,9 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
       ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
     }
+  } else if (frame.IsMemoryPatternTooSmall()) {
+    // re-plan the pattern on the next run in this bucket
+    session_state.MarkMemoryPatternGroupTooSmall(feeds);
   }
 
   if (is_profiler_enabled) {
@@ -18,8 +18,11 @@
 namespace onnxruntime {
 class SequentialExecutor : public IExecutor {
  public:
-  SequentialExecutor(const bool& terminate_flag = false, const bool only_execute_path_to_fetches = false)
-      : terminate_flag_{terminate_flag}, only_execute_path_to_fetches_(only_execute_path_to_fetches) {}
+  SequentialExecutor(const bool& terminate_flag = false, const bool only_execute_path_to_fetches = false,
+                     const ScratchBuffer* scratch_buffer = nullptr)
+      : terminate_flag_{terminate_flag},
+        only_execute_path_to_fetches_(only_execute_path_to_fetches),
+        scratch_buffer_(scratch_buffer) {}
 
   common::Status Execute(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
                          gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
@@ -31,5 +34,7 @@ class SequentialExecutor : public IExecutor {
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
   const bool& terminate_flag_;
   const bool only_execute_path_to_fetches_;
+  // optional caller owned buffer for the memory pattern
+  const ScratchBuffer* scratch_buffer_;
 };
 }  // namespace onnxruntime
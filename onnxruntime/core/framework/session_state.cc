@@ -3,6 +3,7 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/platform/ort_mutex.h"
@@ -153,7 +154,20 @@ const KernelCreateInfo& SessionState::GetNodeKernelCreateInfo(NodeIndex node_ind
   return *entry->second;
 }
 
-Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager) {
+// Whether the kernel of the node can be created, and can pre-pack, concurrently with other kernels. Only the kernels
+// ORT implements for the CPU execution provider are known to allow it, not custom op kernels in other domains.
+static bool CanInitializeKernelConcurrently(const Node& node) {
+  if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+    return false;
+  }
+
+  const auto& domain = node.Domain();
+  return domain == kOnnxDomain || domain == kMLDomain || domain == kMSDomain || domain == kMSNchwcDomain ||
+         domain == kMSInternalNHWCDomain;
+}
+
+Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager,
+                                   concurrency::ThreadPool* thread_pool) {
   const auto& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
     size_t max_nodeid = 0;
@@ -162,7 +176,8 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1);
-    for (const auto& node : nodes) {
+
+    auto create_kernel = [this, &kernel_registry_manager](const Node& node) -> Status {
       // construct and save the kernels
       const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
 
@@ -171,7 +186,28 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
       const IExecutionProvider& exec_provider = *execution_providers_.Get(exec_provider_name);
 
       // assumes vector is already resize()'ed to the number of nodes in the graph
-      ORT_RETURN_IF_ERROR(kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]));
+      return kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]);
+    };
+
+    // the kernels that allow it are created on the thread pool, each writing its own slot of session_kernels_
+    const bool create_concurrently = concurrency::ThreadPool::ShouldParallelize(thread_pool);
+    if (create_concurrently) {
+      InlinedVector<const Node*> concurrent_nodes;
+      for (const auto& node : nodes) {
+        if (CanInitializeKernelConcurrently(node)) {
+          concurrent_nodes.push_back(&node);
+        }
+      }
+
+      ORT_RETURN_IF_ERROR(session_state_utils::RunConcurrently(
+          thread_pool, concurrent_nodes.size(),
+          [&concurrent_nodes, &create_kernel](size_t index) { return create_kernel(*concurrent_nodes[index]); }));
+    }
+
+    for (const auto& node : nodes) {
+      if (!create_concurrently || !CanInitializeKernelConcurrently(node)) {
+        ORT_RETURN_IF_ERROR(create_kernel(node));
+      }
     }
   }
   node_index_info_.emplace(*graph_viewer_, ort_value_name_idx_map_);
@@ -287,6 +323,12 @@ static Status KernelUseSharedPrePackedBuffers(OpKernel& kernel, int input_idx,
   return Status::OK();
 }
 
+// static
+std::string SessionState::GetSavedPrePackedWeightsKey(const Node& node, int input_idx,
+                                                      const std::string& initializer_name) {
+  return MakeString(node.Index(), "/", node.Name(), "/", input_idx, "/", initializer_name);
+}
+
 static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
                                                      const PrePackedWeights& pre_packed_weights) {
   std::ostringstream ss_1;
@@ -297,141 +339,312 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
   return ss_1.str();
 }
 
+namespace {
+
+// A constant initializer the kernel of a node is offered to pre-pack, and the outcome.
+struct PrePackInput {
+  int input_idx;
+  const std::string* input_name;
+  SessionState* session_state;  // the session state holding the initializer, which may be an outer scope one
+  int ort_value_idx;
+  const Tensor* tensor;
+  bool is_shared_initializer;
+  bool is_weight_store_initializer;
+
+  bool is_packed = false;
+  bool used_shared_pre_packed_weights = false;
+  bool used_saved_pre_packed_weights = false;
+  std::shared_ptr<const PrePackedWeights> weight_store_prepacked_weights;
+  // the pre-packed weights kept to be saved, see SessionState::SetKeepPrePackedWeightsToSave
+  std::unique_ptr<PrePackedWeights> prepacked_weights_to_save;
+};
+
+struct NodePrePackInputs {
+  const Node* node;
+  OpKernel* kernel;
+  InlinedVector<PrePackInput> inputs;
+};
+
+}  // namespace
+
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
-                                                       const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
-                                        bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
-    for (auto& node : GetGraphViewer().Nodes()) {
-      auto kernel = GetMutableKernel(node.Index());
-      int input_idx = 0;
-      for (auto& input_def : node.InputDefs()) {
-        if (input_def->Exists()) {
-          const std::string& input_name = input_def->Name();
-          SessionState* st = this;
-          // subgraph can use the value from outer scope,
-          // so it needs to check if current node uses constant initialized tensor from current and outer graphs
-          do {
-            int ort_value_idx;
-            if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
-              std::unordered_map<int, OrtValue>& constant_initialized_tensors = st->constant_initialized_tensors_;
-
-              if (constant_initialized_tensors.count(ort_value_idx)) {
-                bool is_packed = false;
-                const Tensor& const_initialized_tensor = constant_initialized_tensors[ort_value_idx].Get<Tensor>();
-
-                auto iter = initializers_to_share_map.find(input_name);
-                bool is_shared_initializer = (iter != initializers_to_share_map.end());
-
-                // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
-                if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
-                    node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
-
-                  AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
-                  ORT_ENFORCE(allocator_for_caching.get() != nullptr);
-
-                  PrePackedWeights weights_to_be_filled_in;
-                  // The reason we invoke PrePack() before looking into the container for any pre-packed weight
-                  // cached by another instance of the same op_type (for the same constant initializer) is because
-                  // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
-                  // weight with the pre-packed weight generated by this instance of the same op_type because other static
-                  // properties of the node like node attributes could play a role in the pre-packed weights' contents.
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
-                                                      is_packed,
-                                                      &weights_to_be_filled_in));
-
-                  if (is_packed) {
-                    // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
-                    ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
-                                " doesn't have an implementation that can cache computed pre-packed weights");
-
-                    const auto& op_type = node.OpType();
-
-                    // Sanity check
-                    // TODO: Check if some version of the ONNX IR allows op_type to be empty
-                    ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
-
-                    // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
-                    // that we just got by invoking PrePack() on this kernel.
-
-                    const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
-                                                                                                           weights_to_be_filled_in);
-
-                    bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
-
-                    if (container_contains_packed_weight) {
-                      LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
-                                          << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
-
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-
-                      ++used_shared_pre_packed_weights_counter_;
-                    } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
-
-                      if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
-                        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
-                      }
-
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-                    }
-                  }
-
-                } else {  // caching of pre-packed weights' turned OFF
-                  AllocatorPtr session_cpu_alloc = kernel->Info().GetAllocator(0, OrtMemType::OrtMemTypeDefault);
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
-                                                      session_cpu_alloc,  // use allocator tied to this session
-                                                      is_packed,
-                                                      nullptr  // no caching required
-                                                      ));
-                }
-                if (is_packed) {
-                  ++number_of_prepacks_counter_;
-
-                  if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
-                    // release the constant initialized tensor
-                    st->initialized_tensors_.erase(ort_value_idx);
-                    constant_initialized_tensors.erase(ort_value_idx);
-                  }
-                }
-              }
-              // stop searching in 2 cases:
-              // 1. value is not from OuterScope
-              // 2. value is from OuterScope and the current OuterScope has the value
-              if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
-                break;
-              }
+                                                       const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map,
+                                                       concurrency::ThreadPool* thread_pool) {
+  // 1. find the constant initializers consumed by each node.
+  // an initializer is only released once all the nodes consuming it are done with it, so the tensors stay valid
+  // while the kernels pre-pack, which lets the kernels of different nodes pre-pack concurrently.
+  std::vector<NodePrePackInputs> nodes_to_prepack;
+  for (auto& node : GetGraphViewer().Nodes()) {
+    NodePrePackInputs node_inputs{&node, GetMutableKernel(node.Index()), {}};
+    int input_idx = 0;
+    for (auto& input_def : node.InputDefs()) {
+      if (input_def->Exists()) {
+        const std::string& input_name = input_def->Name();
+        SessionState* st = this;
+        // subgraph can use the value from outer scope,
+        // so it needs to check if current node uses constant initialized tensor from current and outer graphs
+        do {
+          int ort_value_idx;
+          if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
+            auto constant_initialized_tensor = st->constant_initialized_tensors_.find(ort_value_idx);
+            if (constant_initialized_tensor != st->constant_initialized_tensors_.end()) {
+              node_inputs.inputs.push_back(
+                  PrePackInput{input_idx, &input_name, st, ort_value_idx,
+                               &constant_initialized_tensor->second.Get<Tensor>(),
+                               initializers_to_share_map.find(input_name) != initializers_to_share_map.end(),
+                               st->weight_store_initializer_ids_.count(ort_value_idx) > 0});
+            }
+            // stop searching in 2 cases:
+            // 1. value is not from OuterScope
+            // 2. value is from OuterScope and the current OuterScope has the value
+            if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
+              break;
+            }
+          }
+          st = st->Parent();
+        } while (st);
+      }
+      input_idx++;
+    }
+
+    if (!node_inputs.inputs.empty()) {
+      nodes_to_prepack.push_back(std::move(node_inputs));
+    }
+  }
+
+  // 2. let the kernels pre-pack.
+  auto prepack_node = [this](NodePrePackInputs& node_inputs,
+                             bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
+    const Node& node = *node_inputs.node;
+    OpKernel* kernel = node_inputs.kernel;
+    for (auto& input : node_inputs.inputs) {
+      const Tensor& const_initialized_tensor = *input.tensor;
+      const int input_idx = input.input_idx;
+      bool is_packed = false;
+
+      // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
+      if (input.is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+          node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
+
+        AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
+        ORT_ENFORCE(allocator_for_caching.get() != nullptr);
+
+        PrePackedWeights weights_to_be_filled_in;
+        // The reason we invoke PrePack() before looking into the container for any pre-packed weight
+        // cached by another instance of the same op_type (for the same constant initializer) is because
+        // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
+        // weight with the pre-packed weight generated by this instance of the same op_type because other static
+        // properties of the node like node attributes could play a role in the pre-packed weights' contents.
+        ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
+                                            is_packed,
+                                            &weights_to_be_filled_in));
+
+        if (is_packed) {
+          // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
+          ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
+                      " doesn't have an implementation that can cache computed pre-packed weights");
+
+          const auto& op_type = node.OpType();
+
+          // Sanity check
+          // TODO: Check if some version of the ONNX IR allows op_type to be empty
+          ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
+
+          // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
+          // that we just got by invoking PrePack() on this kernel.
+
+          const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
+                                                                                                 weights_to_be_filled_in);
+
+          bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
+
+          if (container_contains_packed_weight) {
+            LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: "
+                                << *input.input_name << " used in the node: " << node.Name()
+                                << " which is of op type: " << node.OpType();
+
+            ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                node.Name()));
+
+            input.used_shared_pre_packed_weights = true;
+          } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
+
+            if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
+              return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
             }
-            st = st->Parent();
-          } while (st);
+
+            ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                node.Name()));
+          }
+        }
+
+      } else if (input.is_weight_store_initializer &&
+                 node.GetExecutionProviderType() == kCpuExecutionProvider) {  // share across sessions
+        SharedWeightStore& weight_store = SharedWeightStore::Instance();
+        PrePackedWeights weights_to_be_filled_in;
+        ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, weight_store.GetAllocator(),
+                                            is_packed,
+                                            &weights_to_be_filled_in));
+
+        // a kernel that can not share its pre-packed weights keeps them and fills in nothing
+        if (is_packed && !weights_to_be_filled_in.buffers_.empty()) {
+          const auto key = GenerateKeyForPrepackedWeightsMap(node.OpType(), weights_to_be_filled_in);
+          bool is_shared = false;
+          auto prepacked_weights = weight_store.GetOrAddPrePackedWeights(
+              key, std::move(weights_to_be_filled_in), is_shared);
+          ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, *prepacked_weights,
+                                                              node.Name()));
+
+          input.used_shared_pre_packed_weights = is_shared;
+          input.weight_store_prepacked_weights = std::move(prepacked_weights);
+        }
+      } else {  // caching of pre-packed weights' turned OFF
+        const bool is_cpu_node = node.GetExecutionProviderType() == kCpuExecutionProvider;
+        auto saved_weights = is_cpu_node && input.session_state == this
+                                 ? saved_prepacked_weights_.find(
+                                       GetSavedPrePackedWeightsKey(node, input_idx, *input.input_name))
+                                 : saved_prepacked_weights_.end();
+        if (saved_weights != saved_prepacked_weights_.end()) {
+          // pre-packed by an earlier session. the kernel restores the rest of the state PrePack would have set.
+          bool can_use_saved_buffers = false;
+          ORT_RETURN_IF_ERROR(kernel->PrepareForSavedPrePackedBuffers(const_initialized_tensor, input_idx,
+                                                                      saved_weights->second.buffer_sizes_,
+                                                                      can_use_saved_buffers));
+          if (can_use_saved_buffers) {
+            ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, saved_weights->second,
+                                                                node.Name()));
+            is_packed = true;
+            input.used_saved_pre_packed_weights = true;
+          }
+        }
+
+        if (!input.used_saved_pre_packed_weights) {
+          AllocatorPtr session_cpu_alloc = kernel->Info().GetAllocator(0, OrtMemType::OrtMemTypeDefault);
+          if (keep_prepacked_weights_to_save_ && is_cpu_node && input.session_state == this) {
+            // the session state owns the buffers so that they can be saved, and the kernel uses them like shared ones
+            auto prepacked_weights = std::make_unique<PrePackedWeights>();
+            ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, session_cpu_alloc, is_packed,
+                                                prepacked_weights.get()));
+
+            // a kernel that can not share its pre-packed weights keeps them and fills in nothing
+            if (is_packed && !prepacked_weights->buffers_.empty()) {
+              ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, *prepacked_weights,
+                                                                  node.Name()));
+              input.prepacked_weights_to_save = std::move(prepacked_weights);
+            }
+          } else {
+            ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                                session_cpu_alloc,  // use allocator tied to this session
+                                                is_packed,
+                                                nullptr  // no caching required
+                                                ));
+          }
         }
-        input_idx++;
       }
+
+      input.is_packed = is_packed;
     }
 
     return Status::OK();
   };
 
+  // 3. update the statistics and release the initializers that all their consumers pre-packed.
+  // called for each node once it pre-packed, so that the initializers are released as early as possible.
+  // not thread safe: the concurrent pre-packing below serializes the calls.
+  auto finish_node = [this, &constant_initializers_use_count](NodePrePackInputs& node_inputs) {
+    for (auto& input : node_inputs.inputs) {
+      if (input.used_shared_pre_packed_weights) {
+        ++used_shared_pre_packed_weights_counter_;
+      }
+
+      if (input.used_saved_pre_packed_weights) {
+        ++used_saved_pre_packed_weights_counter_;
+      }
+
+      if (input.prepacked_weights_to_save) {
+        const std::string weights_key = GenerateKeyForPrepackedWeightsMap(node_inputs.node->OpType(),
+                                                                         *input.prepacked_weights_to_save);
+        prepacked_weights_to_save_.push_back(
+            SavedPrePackedWeights{GetSavedPrePackedWeightsKey(*node_inputs.node, input.input_idx, *input.input_name),
+                                  weights_key, std::move(input.prepacked_weights_to_save)});
+      }
+
+      if (input.weight_store_prepacked_weights) {
+        if (input.used_shared_pre_packed_weights) {
+          ++shared_weight_stats_.num_shared_prepacked_weights;
+          for (const auto buffer_size : input.weight_store_prepacked_weights->buffer_sizes_) {
+            shared_weight_stats_.shared_prepacked_weight_bytes += buffer_size;
+          }
+        }
+
+        weight_store_prepacked_weights_.push_back(std::move(input.weight_store_prepacked_weights));
+      }
+
+      if (input.is_packed) {
+        ++number_of_prepacks_counter_;
+
+        auto use_count = constant_initializers_use_count.find(*input.input_name);
+        if (use_count != constant_initializers_use_count.end() && use_count->second > 0 && --use_count->second == 0) {
+          // release the constant initialized tensor
+          input.session_state->initialized_tensors_.erase(input.ort_value_idx);
+          input.session_state->constant_initialized_tensors_.erase(input.ort_value_idx);
+        }
+      }
+    }
+  };
+
   bool should_cache_prepacked_weights_for_shared_initializers = (prepacked_weights_container_ != nullptr);
 
   if (should_cache_prepacked_weights_for_shared_initializers) {
     // serialize calls to the method that looks up the container, calls UseCachedPrePackedWeight/PrePack
     // and writes pre-packed weights to the container
     std::lock_guard<onnxruntime::OrtMutex> l(prepacked_weights_container_->mutex_);
-    return prepacked_constant_weights(true);
+    for (auto& node_inputs : nodes_to_prepack) {
+      ORT_RETURN_IF_ERROR(prepack_node(node_inputs, true));
+      finish_node(node_inputs);
+    }
   } else {
-    return prepacked_constant_weights(false);
-  }
-}
+    // each kernel only pre-packs into its own state, so the kernels of different nodes can do it concurrently.
+    // each node is finished as soon as it pre-packed, so at most one original per thread is held alongside its
+    // packed copy, plus the initializers shared with nodes that are still pre-packing.
+    const bool prepack_concurrently = concurrency::ThreadPool::ShouldParallelize(thread_pool);
+    if (prepack_concurrently) {
+      InlinedVector<NodePrePackInputs*> concurrent_nodes;
+      for (auto& node_inputs : nodes_to_prepack) {
+        if (CanInitializeKernelConcurrently(*node_inputs.node)) {
+          concurrent_nodes.push_back(&node_inputs);
+        }
+      }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
-  for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+      OrtMutex finish_node_mutex;
+      ORT_RETURN_IF_ERROR(session_state_utils::RunConcurrently(
+          thread_pool, concurrent_nodes.size(),
+          [&concurrent_nodes, &prepack_node, &finish_node, &finish_node_mutex](size_t index) {
+            auto& node_inputs = *concurrent_nodes[index];
+            ORT_RETURN_IF_ERROR(prepack_node(node_inputs, false));
+
+            // the other threads only read the tensors of their own nodes, which are not released until those
+            // nodes are finished too
+            std::lock_guard<OrtMutex> lock(finish_node_mutex);
+            finish_node(node_inputs);
+            return Status::OK();
+          }));
+    }
+
+    for (auto& node_inputs : nodes_to_prepack) {
+      if (!prepack_concurrently || !CanInitializeKernelConcurrently(*node_inputs.node)) {
+        ORT_RETURN_IF_ERROR(prepack_node(node_inputs, false));
+        finish_node(node_inputs);
+      }
+    }
   }
-  return key;
+
+  // the kernels hold on to the saved buffers they use
+  saved_prepacked_weights_.clear();
+
+  return Status::OK();
 }
 
 #ifdef ENABLE_TRAINING
@@ -656,26 +869,33 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// MemoryPatternGroup is cached. It is inserted upon creation and only replaced if it was found to be too small
+// for a request in the same bucket.
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
+    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes,
+    bool& needs_planning) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  if (static_mem_patterns_) {
+    // planned at initialization and valid for any input shapes
+    needs_planning = false;
+    return static_mem_patterns_;
+  }
+
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+  int64_t key = mem_patterns_.CalculateKey(tensor_inputs);
+  auto patterns = mem_patterns_.Find(key, needs_planning);
+  if (patterns == nullptr) {
 #ifdef ENABLE_TRAINING
     MemoryPatternGroup mem_patterns;
     InlinedHashMap<int, TensorShape> inferred_shapes;
     if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
+      patterns = mem_patterns_.Insert(key, std::move(mem_patterns));
       auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
       out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+      needs_planning = false;
+      return patterns;
     }
 #else
     ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
@@ -687,7 +907,188 @@ const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
   if (patt_hit != shape_patterns_.cend()) {
     out_inferred_shapes = &patt_hit->second;
   }
-  return &it->second;
+  return patterns;
+}
+
+void SessionState::MarkMemoryPatternGroupTooSmall(gsl::span<const OrtValue> tensor_inputs) const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  // with exact shapes a misfit comes from data dependent sizes, e.g. NonZero. re-planning would not settle.
+  if (mem_patterns_.UsesBuckets()) {
+    mem_patterns_.MarkTooSmall(mem_patterns_.CalculateKey(tensor_inputs));
+  }
+}
+
+void SessionState::SetMemoryPatternCacheOptions(const MemoryPatternCacheOptions& options) {
+  MemoryPatternCacheOptions cache_options = options;
+#ifdef ENABLE_TRAINING
+  // patterns generated ahead of execution come with shapes inferred from the exact input shapes
+  if (cache_options.bucket_kind != MemoryPatternCacheOptions::BucketKind::kNone) {
+    LOGS(logger_, WARNING) << "Memory pattern bucketing is not supported in training builds and is ignored.";
+    cache_options.bucket_kind = MemoryPatternCacheOptions::BucketKind::kNone;
+    cache_options.bucket_boundaries.clear();
+  }
+#endif
+
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  mem_patterns_.SetOptions(std::move(cache_options));
+}
+
+MemoryPatternCacheStats SessionState::GetMemoryPatternCacheStats() const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  return mem_patterns_.GetStats();
+}
+
+SharedWeightStats SessionState::GetSharedWeightStats() const {
+  SharedWeightStats stats = shared_weight_stats_;
+  for (const auto& node_subgraphs : subgraph_session_states_) {
+    for (const auto& attr_subgraph : node_subgraphs.second) {
+      const auto subgraph_stats = attr_subgraph.second->GetSharedWeightStats();
+      stats.num_shared_initializers += subgraph_stats.num_shared_initializers;
+      stats.shared_initializer_bytes += subgraph_stats.shared_initializer_bytes;
+      stats.num_shared_prepacked_weights += subgraph_stats.num_shared_prepacked_weights;
+      stats.shared_prepacked_weight_bytes += subgraph_stats.shared_prepacked_weight_bytes;
+    }
+  }
+
+  return stats;
+}
+
+size_t SessionState::GetMemoryPatternPeakSize(gsl::span<const OrtValue> tensor_inputs,
+                                              const OrtMemoryInfo& location) const {
+  std::shared_ptr<const MemoryPatternGroup> patterns = static_mem_patterns_;
+  if (!patterns) {
+    std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+    patterns = mem_patterns_.Peek(mem_patterns_.CalculateKey(tensor_inputs));
+  }
+
+  const auto* pattern = patterns ? patterns->GetPatterns(location) : nullptr;
+  return pattern ? pattern->PeakSize() : 0;
+}
+
+namespace {
+// Returns false if the shape of the tensor is not fully known ahead of execution.
+bool TryGetStaticTensorSize(const NodeArg& arg, MLDataType element_type, size_t& size) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  size_t len = 1;
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value() || dim.dim_value() < 0 ||
+        !IAllocator::CalcMemSizeForArray(len, static_cast<size_t>(dim.dim_value()), &len)) {
+      return false;
+    }
+  }
+
+  return IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(len, element_type->Size(), &size);
+}
+}  // namespace
+
+Status SessionState::GenerateStaticMemoryPatterns() {
+  if (!enable_mem_pattern_) {
+    return Status::OK();
+  }
+
+  const auto* exe_plan = GetExecutionPlan();
+  ORT_ENFORCE(exe_plan);
+
+  NodeHashMap<OrtMemoryInfo, StaticMemoryPlanner> planners;
+  // values in the order a run allocates them, to compare with the pattern MemPatternPlanner traces
+  InlinedVector<std::pair<size_t, int>> allocation_order;
+  InlinedHashMap<int, size_t> sizes;
+
+  for (int ort_value_idx = 0, end = static_cast<int>(exe_plan->allocation_plan.size()); ort_value_idx < end;
+       ++ort_value_idx) {
+    const auto& per_value_plan = exe_plan->allocation_plan[ort_value_idx];
+    if (per_value_plan.alloc_kind != AllocKind::kAllocate) {
+      continue;
+    }
+
+    // other types are not allocated from the memory pattern
+    const auto* ml_type = per_value_plan.value_type;
+    if (ml_type == nullptr || !ml_type->IsTensorType()) {
+      continue;
+    }
+
+    const auto* element_type = static_cast<const TensorTypeBase*>(ml_type)->GetElementType();
+    if (utils::IsDataTypeString(element_type)) {
+      continue;
+    }
+
+    std::string name;
+    ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetName(ort_value_idx, name));
+    const auto* arg = graph_viewer_->GetNodeArg(name);
+    size_t size = 0;
+    if (arg == nullptr || !TryGetStaticTensorSize(*arg, element_type, size)) {
+      LOGS(logger_, VERBOSE) << "Shape of " << name << " is not static. Skipping static memory planning.";
+      return Status::OK();
+    }
+
+    if (!per_value_plan.program_counter.HasValidEntries()) {
+      LOGS(logger_, VERBOSE) << "Lifetime of " << name << " is unknown. Skipping static memory planning.";
+      return Status::OK();
+    }
+
+    planners[per_value_plan.location].AddValue(ort_value_idx, size, per_value_plan.program_counter);
+    allocation_order.emplace_back(per_value_plan.program_counter.Starts().front(), ort_value_idx);
+    sizes[ort_value_idx] = size;
+  }
+
+  if (planners.empty()) {
+    return Status::OK();
+  }
+
+  // trace the values as a run would. a value is allocated when its node runs and freed after the last node
+  // that uses its buffer.
+  std::sort(allocation_order.begin(), allocation_order.end());
+  OrtValuePatternPlanner mem_pattern_planner(*exe_plan);
+  auto next_allocation = allocation_order.cbegin();
+  for (size_t program_counter = 0; program_counter < exe_plan->execution_plan.size(); ++program_counter) {
+    for (; next_allocation != allocation_order.cend() && next_allocation->first == program_counter;
+         ++next_allocation) {
+      ORT_RETURN_IF_ERROR(mem_pattern_planner.TraceAllocation(next_allocation->second,
+                                                              sizes[next_allocation->second]));
+    }
+
+    const auto& node_plan = exe_plan->execution_plan[program_counter];
+    for (int index = node_plan.free_from_index; index <= node_plan.free_to_index; ++index) {
+      auto ort_value_idx = exe_plan->to_be_freed[index];
+      if (sizes.find(ort_value_idx) != sizes.cend()) {
+        ORT_RETURN_IF_ERROR(mem_pattern_planner.TraceFree(ort_value_idx));
+      }
+    }
+  }
+
+  MemoryPatternGroup traced_patterns;
+  ORT_RETURN_IF_ERROR(mem_pattern_planner.GeneratePatterns(traced_patterns));
+
+  // the greedy placement is a heuristic. keep the traced pattern for a location in the rare case it is smaller.
+  MemoryPatternGroup static_patterns;
+  StaticMemoryPlanSummary summary;
+  summary.num_planned_values = sizes.size();
+  for (auto& entry : planners) {
+    MemoryPattern pattern = entry.second.GenerateMemPattern();
+    const auto* traced = traced_patterns.GetPatterns(entry.first);
+    const size_t traced_peak_size = traced ? traced->PeakSize() : 0;
+    summary.mem_pattern_planner_peak_size += traced_peak_size;
+    if (traced != nullptr && traced_peak_size < pattern.PeakSize()) {
+      const auto index = static_cast<size_t>(traced - traced_patterns.patterns.data());
+      pattern = std::move(traced_patterns.patterns[index]);
+    }
+
+    summary.peak_size += pattern.PeakSize();
+    static_patterns.locations.push_back(entry.first);
+    static_patterns.patterns.push_back(std::move(pattern));
+  }
+
+  LOGS(logger_, INFO) << "Static memory plan for " << summary.num_planned_values << " values: peak size "
+                      << summary.peak_size << " bytes. MemPatternPlanner: "
+                      << summary.mem_pattern_planner_peak_size << " bytes.";
+
+  static_mem_patterns_ = std::make_shared<const MemoryPatternGroup>(std::move(static_patterns));
+  static_mem_plan_summary_ = summary;
+  return Status::OK();
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -716,11 +1117,10 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  int64_t key = mem_patterns_.CalculateKey(tensor_inputs);
+  // Existing usable patterns are kept. Running frames hold their own reference, so replacing is safe.
+  mem_patterns_.Insert(key, std::move(mem_patterns));
   return Status::OK();
 }
 
@@ -915,6 +1315,7 @@ Status SessionState::CreateSubgraphSessionState() {
 
       // Pass fused function manager to subgraph
       subgraph_session_state->fused_funcs_mgr_.SetFusedFuncs(fused_funcs_mgr_);
+      subgraph_session_state->mem_patterns_.SetOptions(mem_patterns_.Options());
 
       // recurse
       ORT_RETURN_IF_ERROR(subgraph_session_state->CreateSubgraphSessionState());
@@ -1228,6 +1629,29 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                   });
   }
 
+  // the phases of finalization are reported to the profiler for each graph
+  const bool is_profiler_enabled = profiler_.IsEnabled();
+  TimePoint phase_start_time;
+  auto start_phase = [this, is_profiler_enabled, &phase_start_time]() {
+    if (is_profiler_enabled) {
+      phase_start_time = profiler_.Start();
+    }
+  };
+  auto end_phase = [this, is_profiler_enabled, &phase_start_time](const std::string& phase_name) {
+    if (is_profiler_enabled) {
+      profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, phase_name, phase_start_time,
+                                      {{"graph", graph_viewer_->Name()}});
+    }
+  };
+
+  // the initializers are deserialized, and the kernels created and pre-packed, on the intra-op thread pool if enabled
+  concurrency::ThreadPool* initialization_thread_pool =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelInitialization, "0") == "1"
+          ? thread_pool_
+          : nullptr;
+
+  start_phase();
+
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
@@ -1245,6 +1669,8 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   GetMemoryProfiler()->Init(GetExecutionPlan(), GetOrtValueNameIdxMap());
 #endif
 
+  end_phase("execution_planning");
+
   // Memory pattern tracer allocates all initializers on a single contiguous
   // buffer. This has the effect of reducing memory fragmentation.
   // Further more, NCCL kernels require initializers to be allocated
@@ -1282,6 +1708,14 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
 
 #endif
 
+  // constant initializers and their pre-packed forms are shared with other sessions through the process wide store
+  SharedWeightStore* shared_weight_store = nullptr;
+  if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigShareWeightsAcrossSessions, "0") == "1") {
+    shared_weight_store = &SharedWeightStore::Instance();
+  }
+
+  start_phase();
+
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
@@ -1295,7 +1729,11 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
             }
             return Status::OK();
           },
-          logger_, data_transfer_mgr_, *p_seq_exec_plan_, session_options, memory_profile_func));
+          logger_, data_transfer_mgr_, *p_seq_exec_plan_, session_options, memory_profile_func,
+          shared_weight_store, &weight_store_initializer_ids_, &shared_weight_stats_,
+          initialization_thread_pool));
+
+  end_phase("initializers_saving");
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
@@ -1309,15 +1747,27 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
     CleanInitializedTensorsFromGraph();
   }
 
-  ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
+  config_options_ = session_options.config_options;
+
+  // kernels that tune GEMMs when they are created time the candidates on the thread pool, so they are created one at
+  // a time
+  const bool gemm_autotune =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigGemmAutotune, "0") == "1";
+
+  start_phase();
+  ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager, gemm_autotune ? nullptr : initialization_thread_pool));
+  end_phase("kernels_creation");
 
 #ifndef ENABLE_TRAINING
   const auto disable_prepacking =
       session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0");
 
   if (disable_prepacking != "1") {
+    start_phase();
     ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensors(constant_initializers_use_count,
-                                                          session_options.initializers_to_share_map));
+                                                          session_options.initializers_to_share_map,
+                                                          initialization_thread_pool));
+    end_phase("weights_prepacking");
   }
 #endif
 
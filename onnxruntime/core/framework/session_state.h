@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <map>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -24,10 +25,13 @@
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/shared_weight_store.h"
+#include "core/framework/static_memory_planner.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/platform/ort_mutex.h"
@@ -54,6 +58,7 @@ class KernelDef;
 class OpKernel;
 class NodeIndexInfo;
 struct SequentialExecutionPlan;
+class OpMetrics;
 struct MemoryPatternGroup;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 class MemoryInfo;
@@ -203,6 +208,14 @@ class SessionState {
   */
   profiling::Profiler& Profiler() const noexcept { return profiler_; }
 
+  // Metrics of the nodes of the graph, recorded by the SequentialExecutor, ParallelExecutor and DataflowExecutor.
+  // null if they are not collected.
+  OpMetrics* GetOpMetrics() const noexcept { return op_metrics_; }
+
+  void SetOpMetrics(OpMetrics* op_metrics) noexcept {
+    op_metrics_ = op_metrics;
+  }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   MemoryProfiler* GetMemoryProfiler() const noexcept { return memory_profiler_; }
 
@@ -219,11 +232,15 @@ class SessionState {
   made under mutex being held. In inference scenarios,
   it is not mutable, we do not obtain a lock and simply get a pointer
   w/o copying a hashtable
+  needs_planning is set if the caller should trace its allocations and call UpdateMemoryPatternGroupCache,
+  either because nothing is cached or because the cached pattern was too small. It may be set while
+  a pattern is returned.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      const InlinedHashMap<int, TensorShape>*& inferred_shapes,
+      bool& needs_planning) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -233,8 +250,87 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Record that the cached memory pattern for the given input shapes was too small for a request sharing its bucket,
+  so that the next request re-plans it. Only used when the memory pattern cache buckets input dims.
+  */
+  void MarkMemoryPatternGroupTooSmall(gsl::span<const OrtValue> tensor_inputs) const;
+
+  /**
+  Configure the bucketing and size limit of the memory pattern cache. Applies to subgraphs created afterwards.
+  */
+  void SetMemoryPatternCacheOptions(const MemoryPatternCacheOptions& options);
+
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
+  /**
+  Get the weights of this session state and its subgraphs that are shared with other sessions through the
+  SharedWeightStore. Empty unless kOrtSessionOptionsConfigShareWeightsAcrossSessions is set.
+  */
+  SharedWeightStats GetSharedWeightStats() const;
+
+  /**
+  Get the size of the buffer the memory pattern for the given inputs uses on location, which is the size a
+  ScratchBuffer for a run with these inputs needs. Returns 0 if no usable pattern has been generated for the input
+  shapes yet. All inputs must be Tensors, in the order they are passed to the executor.
+  */
+  size_t GetMemoryPatternPeakSize(gsl::span<const OrtValue> tensor_inputs, const OrtMemoryInfo& location) const;
+
+  /**
+  Plan the memory of all activations ahead of execution if every tensor shape in the graph is known.
+  On success every run uses the generated pattern, so each location needs a single allocation per run.
+  Nothing is planned if the memory pattern is disabled or a shape is not static. Must be called after
+  ResolveMemoryPatternFlag.
+  */
+  Status GenerateStaticMemoryPatterns();
+
+  /**
+  Sizes of the static memory plan. Empty if GenerateStaticMemoryPatterns did not plan anything.
+  */
+  const StaticMemoryPlanSummary& GetStaticMemoryPlanSummary() const { return static_mem_plan_summary_; }
+
   bool GetUseDeterministicCompute() const { return use_deterministic_compute_; }
 
+  /**
+  The pre-packed weights of a constant initializer input of a node, saved with the session cache so that later
+  sessions can use them without calling OpKernel::PrePack. key identifies the node, input and initializer within the
+  graph, see GetSavedPrePackedWeightsKey. weights_key identifies the content like the keys of PrepackedWeightsContainer.
+  */
+  struct SavedPrePackedWeights {
+    std::string key;
+    std::string weights_key;
+    std::unique_ptr<PrePackedWeights> weights;
+  };
+
+  static std::string GetSavedPrePackedWeightsKey(const Node& node, int input_idx, const std::string& initializer_name);
+
+  /**
+  Let the CPU kernels of this graph that implement OpKernel::PrepareForSavedPrePackedBuffers use the given pre-packed
+  weights, keyed by GetSavedPrePackedWeightsKey, instead of pre-packing their constant initializers. The buffers are
+  not owned and must stay valid for the lifetime of the session. Subgraphs are not covered.
+  */
+  void SetSavedPrePackedWeights(InlinedHashMap<std::string, PrePackedWeights> saved_prepacked_weights) {
+    saved_prepacked_weights_ = std::move(saved_prepacked_weights);
+  }
+
+  /**
+  Keep the weights the CPU kernels of this graph pre-pack from their constant initializers in this session state,
+  rather than in the kernels, so that GetPrePackedWeightsToSave returns them. Subgraphs are not covered.
+  */
+  void SetKeepPrePackedWeightsToSave(bool keep_prepacked_weights_to_save) {
+    keep_prepacked_weights_to_save_ = keep_prepacked_weights_to_save;
+  }
+
+  const std::vector<SavedPrePackedWeights>& GetPrePackedWeightsToSave() const {
+    return prepacked_weights_to_save_;
+  }
+
+  /**
+  Use the DataflowExecutor rather than the ParallelExecutor when running with ExecutionMode::ORT_PARALLEL.
+  */
+  void SetUseDataflowExecutor(bool use_dataflow_executor) { use_dataflow_executor_ = use_dataflow_executor; }
+  bool GetUseDataflowExecutor() const { return use_dataflow_executor_; }
+
   /**
   Get enable memory pattern flag
   */
@@ -294,6 +390,9 @@ class SessionState {
 
   const DataTransferManager& GetDataTransferMgr() const noexcept { return data_transfer_mgr_; }
 
+  // Config options of the session, passed to the kernels through OpKernelInfo. Set by FinalizeSessionState.
+  const ConfigOptions& GetConfigOptions() const noexcept { return config_options_; }
+
   InlinedVector<BufferUniquePtr>& GetMutableWeightsBuffers() noexcept { return weights_buffers_; }
 
   const NodeIndexInfo& GetNodeIndexInfo() const;
@@ -321,6 +420,10 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedSavedPrePackedWeightCounter() const {
+    return used_saved_pre_packed_weights_counter_;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -347,8 +450,10 @@ class SessionState {
   // Populate OrtValueNameIdxMap and create the graph viewer.
   void CreateGraphInfo();
 
-  // create kernels using info in kernel_create_info_map_
-  Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
+  // create kernels using info in kernel_create_info_map_.
+  // if thread_pool is not null the kernels that can be created concurrently are created on it.
+  Status CreateKernels(const KernelRegistryManager& custom_registry_manager,
+                       concurrency::ThreadPool* thread_pool = nullptr);
 
   // remove TensorProto versions of initializers from Graph instance
   // (replaced byOrtValue instances in initialized_tensors_)
@@ -357,9 +462,12 @@ class SessionState {
   /**
    * Prepack the constant initialized tensors for better performance.
    * The original constant initialized tensors will be removed to save memory.
+   * If thread_pool is not null, the kernels of different nodes pre-pack on it concurrently unless the pre-packed
+   * weights are cached in a shared container.
    */
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
-                                           const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
+                                           const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map,
+                                           concurrency::ThreadPool* thread_pool = nullptr);
 
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
@@ -467,6 +575,7 @@ class SessionState {
 
   const logging::Logger& logger_;
   profiling::Profiler& profiler_;
+  OpMetrics* op_metrics_{nullptr};
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   MemoryProfiler* memory_profiler_;
@@ -478,8 +587,10 @@ class SessionState {
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
+  mutable MemoryPatternCache mem_patterns_;
+  // pattern planned at initialization for a graph with static shapes. used for every run if set.
+  std::shared_ptr<const MemoryPatternGroup> static_mem_patterns_;
+  StaticMemoryPlanSummary static_mem_plan_summary_;
   // This is mutable under mutex in training scenarios so execution frame would make a copy
   // of the value when created.
 #ifdef ENABLE_TRAINING
@@ -499,8 +610,11 @@ class SessionState {
 
   const DataTransferManager& data_transfer_mgr_;
 
+  ConfigOptions config_options_;
+
   bool use_deterministic_compute_;
   bool enable_mem_reuse_;
+  bool use_dataflow_executor_ = false;
   std::optional<NodeIndexInfo> node_index_info_;
 
   // Container to store pre-packed weights to share between sessions.
@@ -538,6 +652,24 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times pre-packed weights saved by an earlier session were used instead of pre-packing
+  size_t used_saved_pre_packed_weights_counter_ = 0;
+
+  // see SetSavedPrePackedWeights. cleared once the kernels took the buffers.
+  InlinedHashMap<std::string, PrePackedWeights> saved_prepacked_weights_;
+
+  // see SetKeepPrePackedWeightsToSave. the kernels use the buffers, so they are kept for the lifetime of the session.
+  bool keep_prepacked_weights_to_save_ = false;
+  std::vector<SavedPrePackedWeights> prepacked_weights_to_save_;
+
+  // ort value ids of the initializers held by the SharedWeightStore
+  InlinedHashSet<int> weight_store_initializer_ids_;
+
+  // pre-packed weights held by the SharedWeightStore that are used by the kernels
+  std::vector<std::shared_ptr<const PrePackedWeights>> weight_store_prepacked_weights_;
+
+  SharedWeightStats shared_weight_stats_;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
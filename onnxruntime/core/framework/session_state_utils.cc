@@ -20,12 +20,14 @@
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_weight_store.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/bfc_arena.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/framework/mem_buffer.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/threadpool.h"
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 #include "core/framework/memory_info.h"
 #endif
@@ -113,6 +115,9 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Internal error. The preallocated buffer is too small. Requires ",
                              p_tensor->SizeInBytes(), ", Got ", m->GetLen());
     }
+  } else if (alloc->Info().device.Type() == OrtDevice::CPU && utils::HasExternalData(tensor_proto)) {
+    // the tensor is replaced by one using the external data below, so allocating its buffer would only grow the arena
+    p_tensor = std::make_unique<Tensor>(type, TensorShape({0}), alloc);
   } else {
     if (use_device_allocator_for_initializers) {
       void* tensor_buffer = nullptr;
@@ -185,6 +190,29 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   return common::Status::OK();
 }
 
+common::Status RunConcurrently(concurrency::ThreadPool* thread_pool, size_t count,
+                               const std::function<common::Status(size_t index)>& fn) {
+  std::vector<Status> statuses(count);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(count), [&statuses, &fn](std::ptrdiff_t i) {
+        const auto index = static_cast<size_t>(i);
+        ORT_TRY {
+          statuses[index] = fn(index);
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            statuses[index] = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+          });
+        }
+      });
+
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  return Status::OK();
+}
+
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const AllocatorPtr& default_cpu_alloc,
@@ -195,7 +223,11 @@ common::Status SaveInitializedTensors(
     const logging::Logger& logger, const DataTransferManager& data_transfer_mgr,
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
-    const MemoryProfileFunction& memory_profile_func) {
+    const MemoryProfileFunction& memory_profile_func,
+    SharedWeightStore* shared_weight_store,
+    InlinedHashSet<int>* shared_weight_store_ids,
+    SharedWeightStats* shared_weight_stats,
+    concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
@@ -228,10 +260,25 @@ common::Status SaveInitializedTensors(
     return retval;
   };
 
+  // Determine if an initializer is held by the process wide weight store. Only constant initializers on CPU are, as
+  // the buffer is shared with other sessions.
+  auto use_shared_weight_store = [shared_weight_store, &graph, &exec_plan](const std::string& name,
+                                                                          int ort_value_index,
+                                                                          const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+    return shared_weight_store != nullptr &&
+           graph.IsConstantInitializer(name, /* check_outer_scope */ false) &&
+#if !defined(DISABLE_SPARSE_TENSORS)
+           !graph.GetGraph().IsSparseInitializer(name) &&
+#endif
+           exec_plan.GetLocation(ort_value_index).device.Type() == OrtDevice::CPU &&
+           SharedWeightStore::CanShareInitializer(tensor_proto);
+  };
+
   // 1. first plan the memory
   const InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   InlinedHashMap<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
   InlinedHashSet<int> user_supplied_initializer_ids;  // set containing the ort value ids of all user supplied initializers
+  InlinedHashSet<int> weight_store_initializer_ids;   // set containing the ort value ids of initializers in the store
 
   id_to_initialized_tensor.reserve(initialized_tensor_set.size());
   user_supplied_initializer_ids.reserve(initialized_tensor_set.size());
@@ -241,6 +288,8 @@ common::Status SaveInitializedTensors(
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
     if (use_user_supplied_initializer(entry.first)) {
       user_supplied_initializer_ids.insert(ort_value_index);
+    } else if (use_shared_weight_store(entry.first, ort_value_index, *entry.second)) {
+      weight_store_initializer_ids.insert(ort_value_index);
     }
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
@@ -252,7 +301,8 @@ common::Status SaveInitializedTensors(
   auto initialized_tensors_to_allocate = id_to_initialized_tensor;
   for (int ort_value_index : initializer_allocation_order) {
     const auto entry = initialized_tensors_to_allocate.find(ort_value_index);
-    if (!(utils::HasExternalData(*entry->second) && exec_plan.GetLocation(ort_value_index).device.Type() == OrtDevice::CPU)) {
+    if (!(utils::HasExternalData(*entry->second) && exec_plan.GetLocation(ort_value_index).device.Type() == OrtDevice::CPU) &&
+        weight_store_initializer_ids.find(ort_value_index) == weight_store_initializer_ids.end()) {
       // can not trace string tensor
       ORT_ENFORCE(entry != initialized_tensors_to_allocate.end() &&
                   entry->second->data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING);
@@ -262,8 +312,9 @@ common::Status SaveInitializedTensors(
   }
 
   for (const auto& entry : initialized_tensors_to_allocate) {
-    // We don't want to trace shared initializers since their memory is provided by the user
-    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
+    // We don't want to trace shared initializers since their memory is provided by the user or the weight store
+    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end() ||
+        weight_store_initializer_ids.find(entry.first) != weight_store_initializer_ids.end()) {
       continue;
     }
     if (entry.second->data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
@@ -289,7 +340,45 @@ common::Status SaveInitializedTensors(
 
   OrtCallback deleter{nullptr, nullptr};
 
+  const bool use_device_allocator_for_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+
   // 3. create weight tensors based on weights buffer
+  struct InitializerValue {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    bool from_weight_store;
+    std::optional<MemBuffer> m;
+    AllocatorPtr alloc;
+    OrtValue ort_value;
+    bool concurrent = false;
+    bool is_shared = false;
+    bool created = false;
+  };
+
+  auto create_initializer = [&](InitializerValue& initializer) -> Status {
+    if (initializer.from_weight_store) {
+      ORT_RETURN_IF_ERROR(shared_weight_store->GetOrAddInitializer(*initializer.tensor_proto, initializer.ort_value,
+                                                                   initializer.is_shared));
+    } else {
+      Status st = DeserializeTensorProto(env, graph_loc, *initializer.tensor_proto,
+                                         (initializer.m.has_value()) ? &*initializer.m : nullptr, initializer.alloc,
+                                         default_cpu_alloc, initializer.ort_value, data_transfer_mgr,
+                                         use_device_allocator_for_initializers);
+      if (!st.IsOK()) {
+        std::ostringstream oss;
+        oss << "Deserialize tensor " << initializer.tensor_proto->name() << " failed." << st.ErrorMessage();
+        return Status(st.Category(), st.Code(), oss.str());
+      }
+    }
+
+    initializer.created = true;
+    return Status::OK();
+  };
+
+  InlinedVector<InitializerValue> initializers;
+  initializers.reserve(id_to_initialized_tensor.size());
+
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
     const std::string& name = entry.second->name();
@@ -299,28 +388,46 @@ common::Status SaveInitializedTensors(
       continue;
     }
 
-    OrtValue ort_value;
+    InitializerValue& initializer = initializers.emplace_back(
+        InitializerValue{ort_value_index, entry.second,
+                         weight_store_initializer_ids.find(ort_value_index) != weight_store_initializer_ids.end()});
 
-    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
-      ort_value = *(session_options.initializers_to_share_map.at(name));
+    if (user_supplied_initializer_ids.find(ort_value_index) != user_supplied_initializer_ids.end()) {
+      initializer.ort_value = *(session_options.initializers_to_share_map.at(name));
+      initializer.created = true;
       LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
-    } else {
-      const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
+      continue;
+    }
 
-      std::optional<MemBuffer> m;
-      AllocatorPtr alloc;
+    if (!initializer.from_weight_store) {
       // TODO: if the tensor need be copied, does it have enough room?
-      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
-      bool use_device_allocator_for_initializers =
-          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, initializer.m, initializer.alloc));
+    }
 
-      Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
-                                         default_cpu_alloc, ort_value, data_transfer_mgr,
-                                         use_device_allocator_for_initializers);
-      if (!st.IsOK()) {
-        std::ostringstream oss;
-        oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-        return Status(st.Category(), st.Code(), oss.str());
+    // initializers copied to another device are created on the calling thread
+    initializer.concurrent = thread_pool != nullptr &&
+                             exec_plan.GetLocation(ort_value_index).device.Type() == OrtDevice::CPU;
+  }
+
+  auto save_initializer = [&](InitializerValue& initializer) -> Status {
+    int ort_value_index = initializer.ort_value_index;
+    const std::string& name = initializer.tensor_proto->name();
+
+    if (!initializer.created) {
+      ORT_RETURN_IF_ERROR(create_initializer(initializer));
+    }
+
+    if (initializer.from_weight_store) {
+      if (initializer.is_shared) {
+        VLOGS(logger, 1) << "Using initializer with name (" << name << ") from the shared weight store.";
+        if (shared_weight_stats != nullptr) {
+          ++shared_weight_stats->num_shared_initializers;
+          shared_weight_stats->shared_initializer_bytes += initializer.ort_value.Get<Tensor>().SizeInBytes();
+        }
+      }
+
+      if (shared_weight_store_ids != nullptr) {
+        shared_weight_store_ids->insert(ort_value_index);
       }
     }
 
@@ -333,10 +440,41 @@ common::Status SaveInitializedTensors(
     const bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
 #if !defined(DISABLE_SPARSE_TENSORS)
     const bool sparse = graph.GetGraph().IsSparseInitializer(name);
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, sparse));
+    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, initializer.ort_value, deleter, constant, sparse));
 #else
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, false));
+    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, initializer.ort_value, deleter, constant, false));
 #endif
+
+    return Status::OK();
+  };
+
+  // the initializers are created and saved in batches, the concurrent ones of a batch first. save_tensor_func may
+  // release the TensorProto of an initializer, so the size of a batch is bounded to limit the memory holding both.
+  constexpr size_t kMaxConcurrentBatchBytes = size_t{256} * 1024 * 1024;
+  size_t batch_begin = 0;
+  while (batch_begin < initializers.size()) {
+    InlinedVector<InitializerValue*> concurrent_initializers;
+    size_t batch_bytes = 0;
+    size_t batch_end = batch_begin;
+    for (; batch_end < initializers.size() && batch_bytes < kMaxConcurrentBatchBytes; ++batch_end) {
+      if (initializers[batch_end].concurrent) {
+        concurrent_initializers.push_back(&initializers[batch_end]);
+        batch_bytes += initializers[batch_end].tensor_proto->ByteSizeLong();
+      }
+    }
+
+    if (!concurrent_initializers.empty()) {
+      ORT_RETURN_IF_ERROR(RunConcurrently(thread_pool, concurrent_initializers.size(),
+                                          [&concurrent_initializers, &create_initializer](size_t index) {
+                                            return create_initializer(*concurrent_initializers[index]);
+                                          }));
+    }
+
+    for (size_t i = batch_begin; i < batch_end; ++i) {
+      ORT_RETURN_IF_ERROR(save_initializer(initializers[i]));
+    }
+
+    batch_begin = batch_end;
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
@@ -21,6 +21,8 @@ class GraphViewer;
 class OrtValueNameIdxMap;
 class DataTransferManager;
 class NodeArg;
+class SharedWeightStore;
+struct SharedWeightStats;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 class MemoryInfo;
 #endif
@@ -29,11 +31,23 @@ namespace logging {
 class Logger;
 }
 
+namespace concurrency {
+class ThreadPool;
+}
+
 namespace session_state_utils {
 using SaveTensorFunction = std::function<Status(const std::string& name, int idx, const OrtValue& value,
                                                 const OrtCallback& d, bool constant, bool sparse)>;
 using MemoryProfileFunction = std::function<void(ITensorAllocator& planner)>;
 
+// Calls fn for each index in [0, count) on the thread pool, or on the calling thread if thread_pool is null.
+// Exceptions thrown by fn are converted to a status. Returns the error with the lowest index, if any.
+common::Status RunConcurrently(concurrency::ThreadPool* thread_pool, size_t count,
+                               const std::function<common::Status(size_t index)>& fn);
+
+// Creates the OrtValue instances of the initializers and passes each one to save_tensor_func.
+// If thread_pool is not null, the initializers planned on CPU are deserialized on it concurrently.
+// save_tensor_func is always called on the calling thread.
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const AllocatorPtr& default_cpu_memory_info,
@@ -44,8 +58,12 @@ common::Status SaveInitializedTensors(
     const DataTransferManager& data_transfer_mgr,
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
-    const MemoryProfileFunction& memory_profile_func);
-    
+    const MemoryProfileFunction& memory_profile_func,
+    SharedWeightStore* shared_weight_store = nullptr,
+    InlinedHashSet<int>* shared_weight_store_ids = nullptr,
+    SharedWeightStats* shared_weight_stats = nullptr,
+    concurrency::ThreadPool* thread_pool = nullptr);
+
 common::Status SaveInputOutputNamesToNodeMapping(const GraphViewer& graph,
                                                  SessionState& session_state,
                                                  gsl::span<const NodeArg* const> implicit_inputs);
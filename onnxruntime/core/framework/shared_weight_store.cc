@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_weight_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "core/framework/endian.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+
+std::string GetInitializerKey(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  const std::string& raw_data = tensor_proto.raw_data();
+
+  // MurmurHash3 takes an int length so hash large buffers in chunks, seeding each chunk with the previous hash
+  constexpr size_t kMaxChunkSize = size_t{1} << 30;
+  uint32_t hash[4] = {0, 0, 0, 0};
+  for (size_t offset = 0; offset < raw_data.size(); offset += kMaxChunkSize) {
+    const size_t chunk_size = std::min(kMaxChunkSize, raw_data.size() - offset);
+    MurmurHash3::x86_128(raw_data.data() + offset, static_cast<int>(chunk_size), hash[0], &hash);
+  }
+
+  std::ostringstream ss;
+  ss << tensor_proto.data_type() << ":";
+  for (const auto dim : tensor_proto.dims()) {
+    ss << dim << ",";
+  }
+
+  ss << raw_data.size() << ":" << std::hex << hash[0] << "." << hash[1] << "." << hash[2] << "." << hash[3];
+  return ss.str();
+}
+
+bool HaveSameBuffers(const PrePackedWeights& a, const PrePackedWeights& b) {
+  if (a.buffer_sizes_ != b.buffer_sizes_) {
+    return false;
+  }
+
+  for (size_t i = 0; i < a.buffers_.size(); ++i) {
+    if ((a.buffers_[i] == nullptr) != (b.buffers_[i] == nullptr) ||
+        (a.buffers_[i] != nullptr && memcmp(a.buffers_[i].get(), b.buffers_[i].get(), a.buffer_sizes_[i]) != 0)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
+struct SharedWeightStore::InitializerEntry {
+  std::unique_ptr<Tensor> tensor;
+
+  bool HasData(const std::string& raw_data) const {
+    return tensor->SizeInBytes() == raw_data.size() &&
+           memcmp(tensor->DataRaw(), raw_data.data(), raw_data.size()) == 0;
+  }
+};
+
+SharedWeightStore::SharedWeightStore() : allocator_(std::make_shared<CPUAllocator>()) {
+}
+
+SharedWeightStore& SharedWeightStore::Instance() {
+  static SharedWeightStore instance;
+  return instance;
+}
+
+bool SharedWeightStore::CanShareInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  // the raw data is compared to the tensor data on a hit, which requires them to have the same byte order
+  return endian::native == endian::little &&
+         utils::HasRawData(tensor_proto) && !utils::HasExternalData(tensor_proto) &&
+         tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING;
+}
+
+common::Status SharedWeightStore::GetOrAddInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                      OrtValue& value, bool& is_shared) {
+  ORT_RETURN_IF_NOT(CanShareInitializer(tensor_proto), "Initializer ", tensor_proto.name(),
+                    " can not be shared between sessions.");
+
+  const std::string& raw_data = tensor_proto.raw_data();
+  const std::string key = GetInitializerKey(tensor_proto);
+
+  std::shared_ptr<InitializerEntry> entry;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = initializers_.find(key);
+    if (it != initializers_.end()) {
+      entry = it->second.lock();
+    }
+  }
+
+  is_shared = entry && entry->HasData(raw_data);
+  if (!is_shared) {
+    // deserialize without holding the lock as the initializer can be large
+    const auto* type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+    auto new_entry = std::make_shared<InitializerEntry>();
+    new_entry->tensor = std::make_unique<Tensor>(type, utils::GetTensorShapeFromTensorProto(tensor_proto), allocator_);
+    ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(Env::Default(), ORT_TSTR(""), tensor_proto, *new_entry->tensor));
+
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto& stored_entry = initializers_[key];
+    entry = stored_entry.lock();
+    if (entry && entry->HasData(raw_data)) {
+      // added by another session in the meantime
+      is_shared = true;
+    } else {
+      entry = std::move(new_entry);
+      // on a hash collision the other initializer keeps the entry
+      if (stored_entry.expired()) {
+        stored_entry = entry;
+      }
+
+      for (auto it = initializers_.begin(); it != initializers_.end();) {
+        it = it->second.expired() ? initializers_.erase(it) : std::next(it);
+      }
+    }
+  }
+
+  // the value holds a reference to the entry, which frees the buffer once all the values sharing it are released
+  const Tensor& tensor = *entry->tensor;
+  auto view = std::make_unique<Tensor>(tensor.DataType(), tensor.Shape(), const_cast<void*>(tensor.DataRaw()),
+                                       tensor.Location());
+  const auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  value.Init(view.release(), ml_tensor, [entry](void* p) { delete static_cast<Tensor*>(p); });
+  return Status::OK();
+}
+
+std::shared_ptr<const PrePackedWeights> SharedWeightStore::GetOrAddPrePackedWeights(
+    const std::string& key, PrePackedWeights&& prepacked_weights, bool& is_shared) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& stored_weights = prepacked_[key];
+  auto weights = stored_weights.lock();
+  is_shared = weights != nullptr && HaveSameBuffers(*weights, prepacked_weights);
+  if (!is_shared) {
+    // on a hash collision the other weights keep the entry
+    const bool store = weights == nullptr;
+    weights = std::make_shared<const PrePackedWeights>(std::move(prepacked_weights));
+    if (store) {
+      stored_weights = weights;
+    }
+
+    for (auto it = prepacked_.begin(); it != prepacked_.end();) {
+      it = it->second.expired() ? prepacked_.erase(it) : std::next(it);
+    }
+  }
+
+  return weights;
+}
+
+size_t SharedWeightStore::NumInitializers() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return static_cast<size_t>(std::count_if(initializers_.cbegin(), initializers_.cend(),
+                                           [](const auto& entry) { return !entry.second.expired(); }));
+}
+
+size_t SharedWeightStore::NumPrePackedWeights() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return static_cast<size_t>(std::count_if(prepacked_.cbegin(), prepacked_.cend(),
+                                           [](const auto& entry) { return !entry.second.expired(); }));
+}
+
+}  // namespace onnxruntime
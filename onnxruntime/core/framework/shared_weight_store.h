@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Weights of a session that are shared with other sessions through the SharedWeightStore.
+struct SharedWeightStats {
+  // initializers whose buffer was already loaded by another session, or by another initializer of this session
+  uint64_t num_shared_initializers{0};
+  uint64_t shared_initializer_bytes{0};
+  // pre-packed weights that were already created by another kernel of this or another session
+  uint64_t num_shared_prepacked_weights{0};
+  uint64_t shared_prepacked_weight_bytes{0};
+};
+
+/*
+Process wide store of constant initializers and their pre-packed forms, so that sessions of models that have weights in
+common, e.g. fine-tuned variants of a model, keep a single copy of them in memory.
+
+Initializers are keyed by their type, dims and a hash of their raw data. A hit is only used if the data is identical.
+Pre-packed weights are keyed like in PrepackedWeightsContainer, by the op type and a hash of the pre-packed buffers.
+
+The store does not own the weights: an entry lives as long as an OrtValue returned for it, or a pointer to its pre-packed
+weights, is held by a session.
+*/
+class SharedWeightStore {
+ public:
+  static SharedWeightStore& Instance();
+
+  // Returns true if the initializer can be held by the store: it has raw data in the TensorProto, rather than in an
+  // external file or in the typed data fields, and is not a string tensor.
+  static bool CanShareInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+  // Sets value to a CPU tensor with the data of tensor_proto, using the buffer of an identical initializer in the store
+  // if there is one, in which case is_shared is set to true. Otherwise the buffer is allocated and added to the store.
+  // CanShareInitializer must be true for tensor_proto. The tensor must not be modified.
+  common::Status GetOrAddInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto, OrtValue& value,
+                                     bool& is_shared);
+
+  // Returns the pre-packed weights with the given key if there are some in the store, in which case is_shared is set to
+  // true. Otherwise prepacked_weights is added to the store and returned.
+  // The buffers of prepacked_weights must have been allocated with GetAllocator().
+  std::shared_ptr<const PrePackedWeights> GetOrAddPrePackedWeights(const std::string& key,
+                                                                   PrePackedWeights&& prepacked_weights,
+                                                                   bool& is_shared);
+
+  // Allocator for the buffers held by the store.
+  const AllocatorPtr& GetAllocator() const { return allocator_; }
+
+  // Number of initializers and pre-packed weights in the store that are used by a session.
+  size_t NumInitializers() const;
+  size_t NumPrePackedWeights() const;
+
+ private:
+  SharedWeightStore();
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedWeightStore);
+
+  struct InitializerEntry;
+
+  const AllocatorPtr allocator_;
+
+  mutable OrtMutex mutex_;
+  // expired entries are removed when an entry is added
+  std::unordered_map<std::string, std::weak_ptr<InitializerEntry>> initializers_;      // GUARDED_BY(mutex_)
+  std::unordered_map<std::string, std::weak_ptr<const PrePackedWeights>> prepacked_;  // GUARDED_BY(mutex_)
+};
+
+}  // namespace onnxruntime
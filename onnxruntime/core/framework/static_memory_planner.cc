@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/static_memory_planner.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "core/common/safeint.h"
+
+namespace onnxruntime {
+
+void StaticMemoryPlanner::AddValue(int ort_value_idx, size_t size,
+                                   const AllocPlanPerValue::ProgramCounter& counter) {
+  ORT_ENFORCE(counter.HasValidEntries(), "Value ", ort_value_idx, " has no valid lifetime.");
+  values_.push_back(Value{ort_value_idx, size, &counter});
+}
+
+bool StaticMemoryPlanner::OverlappingTimeSchedules(const AllocPlanPerValue::ProgramCounter& counter1,
+                                                   const AllocPlanPerValue::ProgramCounter& counter2) {
+  const auto& starts_1 = counter1.Starts();
+  const auto& ends_1 = counter1.Ends();
+  const auto& starts_2 = counter2.Starts();
+  const auto& ends_2 = counter2.Ends();
+
+  size_t index_1 = 0;
+  size_t index_2 = 0;
+  while (index_1 < starts_1.size() && index_2 < starts_2.size()) {
+    if (starts_1[index_1] <= starts_2[index_2]) {
+      if (ends_1[index_1] >= starts_2[index_2]) {
+        return true;
+      }
+      ++index_1;
+    } else {
+      if (ends_2[index_2] >= starts_1[index_1]) {
+        return true;
+      }
+      ++index_2;
+    }
+  }
+
+  return false;
+}
+
+MemoryPattern StaticMemoryPlanner::GenerateMemPattern() const {
+  // largest first. ties are broken by the first start and then the index so the result is deterministic.
+  std::vector<size_t> order(values_.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+    const Value& a = values_[lhs];
+    const Value& b = values_[rhs];
+    if (a.size != b.size) {
+      return a.size > b.size;
+    }
+
+    if (a.counter->Starts().front() != b.counter->Starts().front()) {
+      return a.counter->Starts().front() < b.counter->Starts().front();
+    }
+
+    return a.ort_value_idx < b.ort_value_idx;
+  });
+
+  struct PlacedValue {
+    const Value* value;
+    MemoryBlock block;
+  };
+
+  std::vector<PlacedValue> placed;
+  placed.reserve(values_.size());
+  std::vector<const PlacedValue*> conflicts;
+  SafeInt<size_t> peak_size{0};
+
+  MemoryPattern pattern;
+  pattern.patterns_.reserve(values_.size());
+
+  for (size_t i : order) {
+    const Value& value = values_[i];
+    if (value.size == 0) {
+      pattern.patterns_.insert_or_assign(value.ort_value_idx, MemoryBlock(0, 0));
+      continue;
+    }
+
+    // blocks that can not be shared with this value, in order of their offset
+    conflicts.clear();
+    for (const auto& other : placed) {
+      if (OverlappingTimeSchedules(*value.counter, *other.value->counter)) {
+        conflicts.push_back(&other);
+      }
+    }
+
+    std::sort(conflicts.begin(), conflicts.end(), [](const PlacedValue* a, const PlacedValue* b) {
+      return a->block < b->block;
+    });
+
+    // best fit among the gaps between the conflicting blocks, otherwise on top of them
+    size_t current = 0;
+    size_t waste_bytes = std::numeric_limits<size_t>::max();
+    size_t best_offset = 0;
+    bool best_offset_found = false;
+    for (const auto* other : conflicts) {
+      if (other->block.offset_ > current) {
+        auto gap = other->block.offset_ - current;
+        if (gap >= value.size && (gap - value.size) < waste_bytes) {
+          waste_bytes = gap - value.size;
+          best_offset = current;
+          best_offset_found = true;
+        }
+      }
+
+      current = std::max(current, other->block.offset_ + other->block.size_);
+    }
+
+    if (!best_offset_found) {
+      best_offset = current;
+    }
+
+    peak_size = std::max(peak_size, SafeInt<size_t>(best_offset) + value.size);
+    placed.push_back(PlacedValue{&value, MemoryBlock(best_offset, value.size)});
+    pattern.patterns_.insert_or_assign(value.ort_value_idx, placed.back().block);
+  }
+
+  pattern.peak_size_ = peak_size;
+  return pattern;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/sequential_execution_plan.h"
+
+namespace onnxruntime {
+
+// Result of planning the activations of a graph ahead of execution, summed over all locations.
+struct StaticMemoryPlanSummary {
+  size_t num_planned_values{0};
+  // peak size of the offsets assigned by the StaticMemoryPlanner
+  size_t peak_size{0};
+  // peak size MemPatternPlanner reaches when tracing the same values in execution order
+  size_t mem_pattern_planner_peak_size{0};
+};
+
+/*
+Assigns an offset in a single buffer to every value of a location whose size and lifetime are known before the
+first run, e.g. the activations of a graph with static shapes.
+
+Unlike MemPatternPlanner, which places each allocation as it is traced and can not move it later, all values are
+known up front. They are placed largest first, each in the smallest gap between the already placed values whose
+lifetimes overlap it (greedy by size). Small values fill the holes left between large ones, so the peak is usually
+lower than the traced pattern, and never depends on the order of allocation within a step.
+
+Lifetimes are the program counters of the SequentialExecutionPlan. A buffer reused by several values has multiple
+start/end pairs and other values may be placed in the gaps between them.
+*/
+class StaticMemoryPlanner {
+ public:
+  StaticMemoryPlanner() = default;
+
+  // counter must outlive the planner.
+  void AddValue(int ort_value_idx, size_t size, const AllocPlanPerValue::ProgramCounter& counter);
+
+  MemoryPattern GenerateMemPattern() const;
+
+  // Returns true if there is an intersection between the time schedules. Ends are inclusive.
+  static bool OverlappingTimeSchedules(const AllocPlanPerValue::ProgramCounter& counter1,
+                                       const AllocPlanPerValue::ProgramCounter& counter2);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(StaticMemoryPlanner);
+
+  struct Value {
+    int ort_value_idx;
+    size_t size;
+    const AllocPlanPerValue::ProgramCounter* counter;
+  };
+
+  std::vector<Value> values_;
+};
+
+}  // namespace onnxruntime
@@ -10,6 +10,7 @@
 
 #include "core/common/logging/logging.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/framework/endian.h"
 #include "core/framework/endian_utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
@@ -173,6 +174,13 @@ static Status ReadExternalDataForTensor(const ONNX_NAMESPACE::TensorProto& tenso
       tensor_byte_size));
 
   unpacked_tensor.resize(tensor_byte_size);
+  if (external_file_path == onnxruntime::utils::kTensorProtoMemoryAddressTag) {
+    // the data is already in memory, e.g. in the memory mapped model file
+    const auto* data = reinterpret_cast<const uint8_t*>(file_offset);
+    std::copy_n(data, static_cast<size_t>(tensor_byte_size), unpacked_tensor.data());
+    return Status::OK();
+  }
+
   ORT_RETURN_IF_ERROR(onnxruntime::Env::Default().ReadFileIntoBuffer(
       external_file_path.c_str(),
       file_offset,
@@ -1345,5 +1353,280 @@ Status UnpackInitializerData(const ONNX_NAMESPACE::TensorProto& initializer,
   return UnpackInitializerData(initializer, Path(), unpacked_tensor);
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+namespace {
+
+// Reads the fields of a serialized protobuf message, keeping the payload of length delimited fields as a view
+// of the serialized bytes.
+class ProtobufFieldReader {
+ public:
+  explicit ProtobufFieldReader(gsl::span<const uint8_t> bytes) : bytes_(bytes) {}
+
+  // Reads the next field. payload is only set for length delimited fields.
+  // Returns false at the end of the message or if the message is malformed, which Failed() tells apart.
+  bool Next(int& field_number, bool& is_length_delimited, gsl::span<const uint8_t>& payload) {
+    if (failed_ || position_ == bytes_.size()) {
+      return false;
+    }
+
+    uint64_t tag = 0;
+    if (!ReadVarint(tag)) {
+      return Fail();
+    }
+
+    field_number = static_cast<int>(tag >> 3);
+    is_length_delimited = false;
+    switch (tag & 7) {
+      case 0: {  // varint
+        uint64_t value = 0;
+        if (!ReadVarint(value)) {
+          return Fail();
+        }
+        break;
+      }
+      case 1:  // 64-bit
+        if (!Skip(8)) {
+          return Fail();
+        }
+        break;
+      case 2: {  // length delimited
+        uint64_t length = 0;
+        if (!ReadVarint(length) || length > bytes_.size() - position_) {
+          return Fail();
+        }
+        payload = bytes_.subspan(position_, static_cast<size_t>(length));
+        position_ += static_cast<size_t>(length);
+        is_length_delimited = true;
+        break;
+      }
+      case 5:  // 32-bit
+        if (!Skip(4)) {
+          return Fail();
+        }
+        break;
+      default:  // groups are not used by ONNX
+        return Fail();
+    }
+
+    return true;
+  }
+
+  bool Failed() const { return failed_; }
+
+ private:
+  bool ReadVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (position_ == bytes_.size()) {
+        return false;
+      }
+      const uint8_t byte = bytes_[position_++];
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Skip(size_t count) {
+    if (count > bytes_.size() - position_) {
+      return false;
+    }
+    position_ += count;
+    return true;
+  }
+
+  bool Fail() {
+    failed_ = true;
+    return false;
+  }
+
+  gsl::span<const uint8_t> bytes_;
+  size_t position_ = 0;
+  bool failed_ = false;
+};
+
+// An initializer and the bytes of its raw data in the serialized model.
+using InitializerRawData = std::vector<std::pair<TensorProto*, gsl::span<const uint8_t>>>;
+
+bool FindInitializerRawData(gsl::span<const uint8_t> graph_bytes, GraphProto& graph,
+                            InitializerRawData& initializer_raw_data);
+
+// Finds the raw data of the initializers of the subgraphs in the attributes of a node.
+// The n-th serialized attribute is the n-th attribute of the parsed node, and likewise for the subgraphs.
+bool FindSubgraphInitializerRawData(gsl::span<const uint8_t> node_bytes, NodeProto& node,
+                                    InitializerRawData& initializer_raw_data) {
+  ProtobufFieldReader node_reader(node_bytes);
+  int field_number = 0;
+  bool is_length_delimited = false;
+  gsl::span<const uint8_t> payload;
+  int attribute_index = 0;
+  while (node_reader.Next(field_number, is_length_delimited, payload)) {
+    if (!is_length_delimited || field_number != NodeProto::kAttributeFieldNumber) {
+      continue;
+    }
+
+    if (attribute_index == node.attribute_size()) {
+      return false;
+    }
+
+    AttributeProto& attribute = *node.mutable_attribute(attribute_index++);
+    ProtobufFieldReader attribute_reader(payload);
+    gsl::span<const uint8_t> graph_bytes;
+    bool has_graph = false;
+    int graph_index = 0;
+    while (attribute_reader.Next(field_number, is_length_delimited, graph_bytes)) {
+      if (!is_length_delimited) {
+        continue;
+      }
+
+      if (field_number == AttributeProto::kGFieldNumber) {
+        // the parser merges repeated occurrences of a singular message, which a view cannot follow
+        if (has_graph || !attribute.has_g() ||
+            !FindInitializerRawData(graph_bytes, *attribute.mutable_g(), initializer_raw_data)) {
+          return false;
+        }
+        has_graph = true;
+      } else if (field_number == AttributeProto::kGraphsFieldNumber) {
+        if (graph_index == attribute.graphs_size() ||
+            !FindInitializerRawData(graph_bytes, *attribute.mutable_graphs(graph_index++), initializer_raw_data)) {
+          return false;
+        }
+      }
+    }
+
+    if (attribute_reader.Failed() || has_graph != attribute.has_g() || graph_index != attribute.graphs_size()) {
+      return false;
+    }
+  }
+
+  return !node_reader.Failed() && attribute_index == node.attribute_size();
+}
+
+// Finds the raw data of the initializers of a graph and of its subgraphs.
+bool FindInitializerRawData(gsl::span<const uint8_t> graph_bytes, GraphProto& graph,
+                            InitializerRawData& initializer_raw_data) {
+  ProtobufFieldReader graph_reader(graph_bytes);
+  int field_number = 0;
+  bool is_length_delimited = false;
+  gsl::span<const uint8_t> payload;
+  int node_index = 0;
+  int initializer_index = 0;
+  while (graph_reader.Next(field_number, is_length_delimited, payload)) {
+    if (!is_length_delimited) {
+      continue;
+    }
+
+    if (field_number == GraphProto::kNodeFieldNumber) {
+      if (node_index == graph.node_size() ||
+          !FindSubgraphInitializerRawData(payload, *graph.mutable_node(node_index++), initializer_raw_data)) {
+        return false;
+      }
+    } else if (field_number == GraphProto::kInitializerFieldNumber) {
+      if (initializer_index == graph.initializer_size()) {
+        return false;
+      }
+
+      TensorProto& initializer = *graph.mutable_initializer(initializer_index++);
+      ProtobufFieldReader tensor_reader(payload);
+      gsl::span<const uint8_t> raw_data;
+      gsl::span<const uint8_t> field_payload;
+      bool has_raw_data = false;
+      while (tensor_reader.Next(field_number, is_length_delimited, field_payload)) {
+        // the parser keeps the last occurrence of a bytes field
+        if (is_length_delimited && field_number == TensorProto::kRawDataFieldNumber) {
+          raw_data = field_payload;
+          has_raw_data = true;
+        }
+      }
+
+      if (tensor_reader.Failed()) {
+        return false;
+      }
+
+      if (has_raw_data && initializer.has_raw_data() && !HasExternalData(initializer) &&
+          initializer.raw_data().size() == raw_data.size()) {
+        initializer_raw_data.emplace_back(&initializer, raw_data);
+      }
+    }
+  }
+
+  return !graph_reader.Failed() && node_index == graph.node_size() &&
+         initializer_index == graph.initializer_size();
+}
+
+}  // namespace
+
+Status UseModelBytesForInitializers(gsl::span<const uint8_t> model_bytes, ModelProto& model_proto,
+                                    size_t& num_initializers) {
+  num_initializers = 0;
+
+  // raw data is little endian and is converted when it is unpacked on other hosts
+  if constexpr (endian::native != endian::little) {
+    return Status::OK();
+  }
+
+  InitializerRawData initializer_raw_data;
+  ProtobufFieldReader model_reader(model_bytes);
+  int field_number = 0;
+  bool is_length_delimited = false;
+  gsl::span<const uint8_t> payload;
+  bool has_graph = false;
+  bool matches = true;
+  while (matches && model_reader.Next(field_number, is_length_delimited, payload)) {
+    if (is_length_delimited && field_number == ModelProto::kGraphFieldNumber) {
+      matches = !has_graph && model_proto.has_graph() &&
+                FindInitializerRawData(payload, *model_proto.mutable_graph(), initializer_raw_data);
+      has_graph = true;
+    }
+  }
+
+  if (!matches || model_reader.Failed() || has_graph != model_proto.has_graph()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The model bytes do not match the parsed model.");
+  }
+
+  for (auto& [initializer, raw_data] : initializer_raw_data) {
+    // as for ORT format models, small initializers keep their copy
+    if (raw_data.size() <= 127) {
+      continue;
+    }
+
+    // the data is used in place, so it must be aligned for its element type
+    size_t num_elements = 1;
+    for (const auto dim : initializer->dims()) {
+      num_elements = dim >= 0 ? num_elements * static_cast<size_t>(dim) : 0;
+    }
+
+    if (num_elements == 0 || raw_data.size() % num_elements != 0 ||
+        reinterpret_cast<uintptr_t>(raw_data.data()) % (raw_data.size() / num_elements) != 0) {
+      continue;
+    }
+
+    static_assert(sizeof(void*) <= sizeof(ExternalDataInfo::OFFSET_TYPE));
+    auto offset = gsl::narrow<ExternalDataInfo::OFFSET_TYPE>(reinterpret_cast<intptr_t>(raw_data.data()));
+
+    initializer->clear_external_data();
+    ONNX_NAMESPACE::StringStringEntryProto* entry = initializer->mutable_external_data()->Add();
+    entry->set_key("location");
+    entry->set_value(ToUTF8String(kTensorProtoMemoryAddressTag));
+    entry = initializer->mutable_external_data()->Add();
+    entry->set_key("offset");
+    entry->set_value(std::to_string(offset));
+    entry = initializer->mutable_external_data()->Add();
+    entry->set_key("length");
+    entry->set_value(std::to_string(raw_data.size()));
+    initializer->set_data_location(TensorProto_DataLocation_EXTERNAL);
+
+    // release the copy made by the parser
+    std::string().swap(*initializer->mutable_raw_data());
+    initializer->clear_raw_data();
+    ++num_initializers;
+  }
+
+  return Status::OK();
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 }  // namespace utils
 }  // namespace onnxruntime
@@ -90,6 +90,17 @@ common::Status GetExtDataFromTensorProto(const Env& env, const ORTCHAR_T* model_
                                          void*& ext_data_buf, SafeInt<size_t>& ext_data_len,
                                          OrtCallback& ext_data_deleter);
 
+#if !defined(ORT_MINIMAL_BUILD)
+// Makes the initializers of the graph of model_proto and of its subgraphs refer to their raw data in model_bytes,
+// the serialized model that model_proto was parsed from, instead of holding a copy of it.
+// The data is referred to with kTensorProtoMemoryAddressTag, so model_bytes must outlive the initializers.
+// Only raw data larger than 127 bytes and aligned for its element type is used in place.
+// num_initializers is set to the number of initializers that refer to model_bytes.
+common::Status UseModelBytesForInitializers(gsl::span<const uint8_t> model_bytes,
+                                            ONNX_NAMESPACE::ModelProto& model_proto,
+                                            size_t& num_initializers);
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 // Convert the AttributeProto from a Constant node into a TensorProto that can be used as an initializer
 // If AttributeProto contains a TensorProto, this tensor proto is converted as is including the case when the
 // the data location is external. i.e. it does not load the external data.
@@ -7,6 +7,7 @@
 
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
+#include "core/framework/dataflow_executor.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
@@ -523,20 +524,29 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
                                        gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
                                        const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                        ExecutionMode execution_mode, const bool& terminate_flag,
-                                       const logging::Logger& logger, const bool only_execute_path_to_fetches = false) {
+                                       const logging::Logger& logger, const bool only_execute_path_to_fetches = false,
+                                       const ScratchBuffer* scratch_buffer = nullptr) {
   // avoid memory allocations
   std::optional<SequentialExecutor> seq_executor;
   std::optional<ParallelExecutor> par_executor;
+  std::optional<DataflowExecutor> dataflow_executor;
   IExecutor* p_exec = nullptr;
   if (execution_mode == ExecutionMode::ORT_SEQUENTIAL) {
-    seq_executor.emplace(terminate_flag, only_execute_path_to_fetches);
+    seq_executor.emplace(terminate_flag, only_execute_path_to_fetches, scratch_buffer);
     p_exec = &seq_executor.value();
   } else if (execution_mode == ExecutionMode::ORT_PARALLEL) {
     auto* p_inter_op_thread_pool = session_state.GetInterOpThreadPool();
     if (!p_inter_op_thread_pool) {
       LOGS(logger, WARNING) << "Only one thread was configured for parallel execution. Hence will use sequential execution.";
-      seq_executor.emplace(terminate_flag, only_execute_path_to_fetches);
+      seq_executor.emplace(terminate_flag, only_execute_path_to_fetches, scratch_buffer);
       p_exec = &seq_executor.value();
+    } else if (scratch_buffer != nullptr) {
+      // memory patterns are only planned for sequential execution, so the parallel executors have no use for it
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "A scratch buffer cannot be used in parallel execution mode.");
+    } else if (session_state.GetUseDataflowExecutor()) {
+      dataflow_executor.emplace(session_state, terminate_flag);
+      p_exec = &dataflow_executor.value();
     } else {
       par_executor.emplace(session_state, terminate_flag);
       p_exec = &par_executor.value();
@@ -601,14 +611,16 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             FeedsFetchesManager& feeds_fetches_manager,
                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
                             ExecutionMode execution_mode, const bool& terminate_flag,
-                            const logging::Logger& logger, bool only_execute_path_to_fetches) {
+                            const logging::Logger& logger, bool only_execute_path_to_fetches,
+                            const ScratchBuffer* scratch_buffer) {
   ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
 
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
   FinalizeFeedFetchCopyInfo(feeds_fetches_manager, feeds, fetches);
 
   auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
-                                 execution_mode, terminate_flag, logger, only_execute_path_to_fetches);
+                                 execution_mode, terminate_flag, logger, only_execute_path_to_fetches,
+                                 scratch_buffer);
 
   return status;
 }
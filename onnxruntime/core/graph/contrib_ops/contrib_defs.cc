@@ -1348,6 +1348,11 @@ activation and leaky_relu_alpha.)DOC")
                                     "",
                                     AttributeProto::FLOAT,
                                     OPTIONAL_VALUE)
+                                .Attr(
+                                    "activation_params",
+                                    "Parameters of the Gelu, FastGelu and QuickGelu activations, as in FusedConv.",
+                                    AttributeProto::FLOATS,
+                                    OPTIONAL_VALUE)
                                 .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
                                   propagateElemTypeFromInputToOutput(ctx, 0, 0);
                                   if (hasNInputShapes(ctx, 2)) {
@@ -392,6 +392,70 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           ONNX_NAMESPACE::matmulShapeInference(ctx, 0, 1);
         }));
 
+constexpr const char* MatMulNBits_ver1_doc = R"DOC(
+MatMulNBits performs a matrix multiplication where the right-hand-side matrix (weights) is quantized to N bits.
+
+The weight matrix B of shape [K, N] is quantized blockwise along the K dimension: each column is split into
+k_blocks = ceil(K / block_size) blocks of block_size elements, and every block has its own scale and optional zero point.
+A quantized element q of a block dequantizes to (q - zero_point) * scale.
+
+Input B is stored as a uint8 tensor of shape [N, k_blocks, blob_size] with blob_size = block_size * bits / 8. For 4-bit
+quantization, two consecutive elements share a byte with the first element in the low nibble. The last block of a
+column is padded with its zero point when K is not a multiple of block_size.
+
+Input scales has shape [N * k_blocks]. The optional input zero_points has shape [N * ceil(k_blocks * bits / 8)], with
+the 4-bit zero points of two consecutive blocks packed in a byte like the elements. The default zero point is
+2^(bits - 1).
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    MatMulNBits, 1,
+    OpSchema()
+        .SetDoc(MatMulNBits_ver1_doc)
+        .Attr("K", "Size of each input feature, i.e. the number of rows of the weight matrix.",
+              AttributeProto::INT)
+        .Attr("N", "Size of each output feature, i.e. the number of columns of the weight matrix.",
+              AttributeProto::INT)
+        .Attr("bits", "Number of bits used for a quantized weight element. Must be 4 or 8.",
+              AttributeProto::INT, static_cast<int64_t>(4))
+        .Attr("block_size",
+              "Number of weight elements along the K dimension that share a scale and zero point. "
+              "Must be a power of 2 and not smaller than 16.",
+              AttributeProto::INT)
+        .Input(0, "A", "The input tensor, not quantized. Its last dimension must be K.", "T1")
+        .Input(1, "B", "Quantized weights of shape [N, k_blocks, blob_size].", "T2")
+        .Input(2, "scales", "Quantization scales of the weight blocks, one per block.", "T1")
+        .Input(3, "zero_points", "Quantization zero points of the weight blocks, packed like B.", "T2",
+               OpSchema::Optional)
+        .Output(0, "Y", "Tensor with the shape of A, except the last dimension is N.", "T1")
+        .TypeConstraint("T1", {"tensor(float)"}, "Constrain input A, scales and output Y to float tensors.")
+        .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain quantized weight types to uint8.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 0);
+
+          if (!hasInputShape(ctx, 0)) {
+            return;
+          }
+
+          const auto& a_shape = getInputShape(ctx, 0);
+          if (a_shape.dim_size() == 0) {
+            fail_shape_inference("Input A must have at least one dimension.");
+          }
+
+          const int64_t n = getAttribute(ctx, "N", static_cast<int64_t>(-1));
+          if (n <= 0) {
+            fail_shape_inference("Attribute N must be positive.");
+          }
+
+          ONNX_NAMESPACE::TensorShapeProto y_shape;
+          for (int i = 0; i < a_shape.dim_size() - 1; ++i) {
+            *y_shape.add_dim() = a_shape.dim(i);
+          }
+          y_shape.add_dim()->set_dim_value(n);
+
+          updateOutputShape(ctx, 0, y_shape);
+        }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     MatMulIntegerToFloat, 1,
     OpSchema()
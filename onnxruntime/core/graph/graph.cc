@@ -3,11 +3,13 @@
 
 #include "core/graph/graph.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
 #include <numeric>
 #include <stack>
+#include <type_traits>
 #include <queue>
 
 #include "core/common/common.h"
@@ -175,6 +177,213 @@ static std::string GenerateSchemaKey(const IndexedSubGraph& subgraph_ptr) {
                       subgraph_ptr.GetMetaDef()->name, "_",
                       subgraph_ptr.GetMetaDef()->since_version);
 }
+
+// Tensors with up to this many elements are summarized by value, as type and shape inference may read their data.
+// Inference only reads shape-like data, e.g. the shape input of Reshape, so larger tensors are summarized by their
+// type, dims and address.
+static constexpr int64_t kMaxInferenceDataElements = 1024;
+
+// The summaries are the bytes of what they cover rather than a hash of it, so that two different summaries never
+// compare equal. Variable length values are prefixed with their size to keep the summaries unambiguous.
+template <typename T>
+static void AppendToSummary(const T& value, std::string& summary) {
+  static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be appended as bytes");
+  summary.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void AppendBytesToSummary(std::string_view bytes, std::string& summary) {
+  AppendToSummary(bytes.size(), summary);
+  summary.append(bytes.data(), bytes.size());
+}
+
+static void SummarizeTensorProto(const TensorProto& tensor, std::string& summary) {
+  AppendToSummary(tensor.data_type(), summary);
+  AppendToSummary(tensor.dims_size(), summary);
+  int64_t num_elements = 1;
+  for (const auto dim : tensor.dims()) {
+    AppendToSummary(dim, summary);
+    num_elements = dim >= 0 && num_elements <= kMaxInferenceDataElements ? num_elements * dim : -1;
+  }
+
+  if (num_elements < 0 || num_elements > kMaxInferenceDataElements) {
+    AppendToSummary(&tensor, summary);
+    return;
+  }
+
+  // the data is copied from where it is stored. only one of the fields holds it.
+  auto summarize_field = [&summary](const auto& field) {
+    AppendToSummary(field.size(), summary);
+    if (!field.empty()) {
+      summary.append(reinterpret_cast<const char*>(field.data()), field.size() * sizeof(*field.data()));
+    }
+  };
+
+  AppendToSummary(static_cast<int>(tensor.data_location()), summary);
+  AppendBytesToSummary(tensor.raw_data(), summary);
+  summarize_field(tensor.float_data());
+  summarize_field(tensor.int32_data());
+  summarize_field(tensor.int64_data());
+  summarize_field(tensor.double_data());
+  summarize_field(tensor.uint64_data());
+  AppendToSummary(tensor.string_data_size(), summary);
+  for (const auto& str : tensor.string_data()) {
+    AppendBytesToSummary(str, summary);
+  }
+  AppendToSummary(tensor.external_data_size(), summary);
+  for (const auto& entry : tensor.external_data()) {
+    AppendBytesToSummary(entry.key(), summary);
+    AppendBytesToSummary(entry.value(), summary);
+  }
+}
+
+static bool SummarizeTypeProto(const TypeProto& type, std::string& summary) {
+  auto summarize_shape = [&summary](bool has_shape, const TensorShapeProto& shape) {
+    AppendToSummary(has_shape, summary);
+    AppendToSummary(shape.dim_size(), summary);
+    for (const auto& dim : shape.dim()) {
+      AppendToSummary(static_cast<int>(dim.value_case()), summary);
+      if (utils::HasDimValue(dim)) {
+        AppendToSummary(dim.dim_value(), summary);
+      } else if (utils::HasDimParam(dim)) {
+        AppendBytesToSummary(dim.dim_param(), summary);
+      }
+    }
+  };
+
+  AppendToSummary(static_cast<int>(type.value_case()), summary);
+  switch (type.value_case()) {
+    case TypeProto::kTensorType:
+      AppendToSummary(type.tensor_type().elem_type(), summary);
+      summarize_shape(type.tensor_type().has_shape(), type.tensor_type().shape());
+      return true;
+    case TypeProto::kSparseTensorType:
+      AppendToSummary(type.sparse_tensor_type().elem_type(), summary);
+      summarize_shape(type.sparse_tensor_type().has_shape(), type.sparse_tensor_type().shape());
+      return true;
+    case TypeProto::kSequenceType:
+      return SummarizeTypeProto(type.sequence_type().elem_type(), summary);
+    case TypeProto::kOptionalType:
+      return SummarizeTypeProto(type.optional_type().elem_type(), summary);
+    case TypeProto::kMapType:
+      AppendToSummary(type.map_type().key_type(), summary);
+      return SummarizeTypeProto(type.map_type().value_type(), summary);
+    default:
+      return false;
+  }
+}
+
+static void SummarizeAttribute(const AttributeProto& attr, std::string& summary) {
+  AppendBytesToSummary(attr.name(), summary);
+  AppendToSummary(static_cast<int>(attr.type()), summary);
+  AppendBytesToSummary(attr.ref_attr_name(), summary);
+  switch (attr.type()) {
+    case AttributeProto_AttributeType_FLOAT:
+      AppendToSummary(attr.f(), summary);
+      break;
+    case AttributeProto_AttributeType_INT:
+      AppendToSummary(attr.i(), summary);
+      break;
+    case AttributeProto_AttributeType_STRING:
+      AppendBytesToSummary(attr.s(), summary);
+      break;
+    case AttributeProto_AttributeType_TENSOR:
+      SummarizeTensorProto(attr.t(), summary);
+      break;
+    case AttributeProto_AttributeType_FLOATS:
+      AppendToSummary(attr.floats_size(), summary);
+      for (const auto f : attr.floats()) {
+        AppendToSummary(f, summary);
+      }
+      break;
+    case AttributeProto_AttributeType_INTS:
+      AppendToSummary(attr.ints_size(), summary);
+      for (const auto i : attr.ints()) {
+        AppendToSummary(i, summary);
+      }
+      break;
+    case AttributeProto_AttributeType_STRINGS:
+      AppendToSummary(attr.strings_size(), summary);
+      for (const auto& str : attr.strings()) {
+        AppendBytesToSummary(str, summary);
+      }
+      break;
+    default:
+      AppendBytesToSummary(attr.SerializeAsString(), summary);
+      break;
+  }
+}
+
+// Summarizes what the type and shape inference of the node reads from the node and its inputs: the op, the
+// attributes, the types and shapes of the inputs and the data of the constant initializer inputs.
+// Returns false if the inference of the node always has to run, which is the case for nodes with subgraphs.
+static bool SummarizeInferenceInputs(const Graph& graph, const Node& node, const Graph::ResolveOptions& options,
+                                     std::string& summary) {
+  summary.clear();
+  if (node.ContainsSubgraph()) {
+    return false;
+  }
+
+  AppendToSummary(node.Op(), summary);
+  AppendToSummary(node.SinceVersion(), summary);
+  AppendToSummary(options.override_types, summary);
+
+  AppendToSummary(node.InputArgCount().size(), summary);
+  for (const int arg_count : node.InputArgCount()) {
+    AppendToSummary(arg_count, summary);
+  }
+
+  AppendToSummary(node.InputDefs().size(), summary);
+  for (const NodeArg* input_def : node.InputDefs()) {
+    AppendToSummary(input_def, summary);
+    if (!input_def->Exists()) {
+      continue;
+    }
+
+    const TypeProto* type = input_def->TypeAsProto();
+    if (type == nullptr || !SummarizeTypeProto(*type, summary)) {
+      return false;
+    }
+
+    const TensorProto* initializer = graph.GetConstantInitializer(input_def->Name(), true);
+    AppendToSummary(initializer != nullptr, summary);
+    if (initializer != nullptr) {
+      SummarizeTensorProto(*initializer, summary);
+    }
+  }
+
+  // the attributes are unordered, so they are summarized in the order of their names
+  std::vector<const AttributeProto*> attributes;
+  attributes.reserve(node.GetAttributes().size());
+  for (const auto& attr : node.GetAttributes()) {
+    attributes.push_back(&attr.second);
+  }
+  std::sort(attributes.begin(), attributes.end(),
+            [](const AttributeProto* a, const AttributeProto* b) { return a->name() < b->name(); });
+  AppendToSummary(attributes.size(), summary);
+  for (const AttributeProto* attr : attributes) {
+    SummarizeAttribute(*attr, summary);
+  }
+
+  return true;
+}
+
+// Summarizes the current types and shapes of the outputs of the node, which its inference merges with.
+// Returns false if they can not be summarized.
+static bool SummarizeInferenceOutputs(const Node& node, std::string& summary) {
+  summary.clear();
+  AppendToSummary(node.OutputDefs().size(), summary);
+  for (const NodeArg* output_def : node.OutputDefs()) {
+    AppendToSummary(output_def, summary);
+    const TypeProto* type = output_def->TypeAsProto();
+    AppendToSummary(type != nullptr, summary);
+    if (type != nullptr && !SummarizeTypeProto(*type, summary)) {
+      summary.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -1468,6 +1677,11 @@ void Graph::AddEdge(NodeIndex src_node_index, NodeIndex dst_node_index, int src_
 
   nodes_[src_node_index]->MutableRelationships().output_edges.insert(Node::EdgeEnd(*nodes_[dst_node_index], src_arg_slot, dst_arg_slot));
   nodes_[dst_node_index]->MutableRelationships().input_edges.insert(Node::EdgeEnd(*nodes_[src_node_index], src_arg_slot, dst_arg_slot));
+
+#if !defined(ORT_MINIMAL_BUILD)
+  RecordNodeChange(src_node_index);
+  RecordNodeChange(dst_node_index);
+#endif
 }
 
 void Graph::RemoveEdge(NodeIndex src_node_index, NodeIndex dst_node_index, int src_arg_slot, int dst_arg_slot) {
@@ -1508,6 +1722,11 @@ void Graph::RemoveEdge(NodeIndex src_node_index, NodeIndex dst_node_index, int s
 
   nodes_[dst_node_index]->MutableRelationships().input_edges.erase(Node::EdgeEnd(*nodes_[src_node_index], src_arg_slot, dst_arg_slot));
   nodes_[src_node_index]->MutableRelationships().output_edges.erase(Node::EdgeEnd(*nodes_[dst_node_index], src_arg_slot, dst_arg_slot));
+
+#if !defined(ORT_MINIMAL_BUILD)
+  RecordNodeChange(src_node_index);
+  RecordNodeChange(dst_node_index);
+#endif
 }
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
@@ -2478,16 +2697,21 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
     lsc.output_names.insert(std::string(input));
   }
 
+  // reused for the summaries of all nodes to avoid reallocating them
+  std::string inputs_summary;
+  std::string outputs_summary;
+
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
 
-    NodeProto node_proto;
-    node.ToProto(node_proto);
     const auto& node_name = node.Name();
 
     if (!node.Op()) {
       {
+        NodeProto node_proto;
+        node.ToProto(node_proto);
+
         auto status = Status::OK();
         ORT_TRY {
           checker::check_node(node_proto, ctx, lsc);
@@ -2559,11 +2783,23 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+    // the inference is skipped if nothing it reads changed since it last ran for the node. the inference of the
+    // nodes downstream runs again only if that of a node changes the types or shapes of its outputs.
+    // the inference does not change the inputs, so only the outputs are summarized again after it ran.
+    const bool can_skip_inference = options.skip_unchanged_inference &&
+                                    SummarizeInferenceInputs(*this, node, options, inputs_summary);
+    if (!can_skip_inference || inputs_summary != node.inference_inputs_summary_ ||
+        !SummarizeInferenceOutputs(node, outputs_summary) || outputs_summary != node.inference_outputs_summary_) {
+      node.inference_inputs_summary_.clear();
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+      if (can_skip_inference && SummarizeInferenceOutputs(node, node.inference_outputs_summary_)) {
+        node.inference_inputs_summary_ = inputs_summary;
+      }
+    }
 
     // Accumulate output names of the iterated Node
-    for (auto& output_name : node_proto.output()) {
-      lsc.output_names.insert(output_name);
+    for (const auto* output_def : node.OutputDefs()) {
+      lsc.output_names.insert(output_def->Name());
     }
   }
 
@@ -2675,6 +2911,14 @@ Status Graph::Resolve(const ResolveOptions& options) {
     return parent_graph_->Resolve(options);
   }
 
+#if !defined(ORT_MINIMAL_BUILD)
+  if (skip_unchanged_inference_ && !options.skip_unchanged_inference) {
+    ResolveOptions skip_options = options;
+    skip_options.skip_unchanged_inference = true;
+    return Resolve(skip_options);
+  }
+#endif
+
   // find all subgraphs including nested ones.
   std::vector<Graph*> all_subgraphs;
   FindAllSubgraphs(all_subgraphs);
@@ -2688,14 +2932,27 @@ Status Graph::Resolve(const ResolveOptions& options) {
     return Status::OK();
   }
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // the edges rebuilt below are not changes to the nodes
+  NodeChangeRecorder node_change_recorder = std::move(node_change_recorder_);
+  node_change_recorder_ = nullptr;
+#endif
+
   // init all graph/subgraphs. non-recursive so call via ForThisAndAllSubgraphs.
   auto init_func = [](Graph& graph) { return graph.InitInputsInitializersOutputs(); };
-  ORT_RETURN_IF_ERROR(ForThisAndAllSubgraphs(all_subgraphs, init_func));
+  Status status = ForThisAndAllSubgraphs(all_subgraphs, init_func);
 
   std::unordered_set<std::string> outer_scope_node_args_consumed;
 
   // recursively build connections between nodes in this graph and all subgraphs
-  ORT_RETURN_IF_ERROR(BuildConnections(outer_scope_node_args_consumed));
+  if (status.IsOK()) {
+    status = BuildConnections(outer_scope_node_args_consumed);
+  }
+
+#if !defined(ORT_MINIMAL_BUILD)
+  node_change_recorder_ = std::move(node_change_recorder);
+#endif
+  ORT_RETURN_IF_ERROR(status);
   ORT_ENFORCE(outer_scope_node_args_consumed.empty(),
               "Shouldn't be possible to have NodeArgs that haven't been handled already.");
 
@@ -3737,7 +3994,19 @@ bool Graph::SetOpSchemaFromRegistryForNode(Node& node) {
       return nullptr;
     }
     const auto max_inclusive_version = domain_to_version_it->second;
-    return schema_registry_->GetSchema(node.OpType(), max_inclusive_version, node.Domain());
+
+    // only found schemas are cached as schemas may be registered later
+    std::string key = MakeString(node.Domain(), ":", node.OpType(), ":", max_inclusive_version);
+    const auto cached_it = op_schema_cache_.find(key);
+    if (cached_it != op_schema_cache_.end()) {
+      return cached_it->second;
+    }
+
+    const auto* schema = schema_registry_->GetSchema(node.OpType(), max_inclusive_version, node.Domain());
+    if (schema != nullptr) {
+      op_schema_cache_.emplace(std::move(key), schema);
+    }
+    return schema;
   }();
 
   if (node.op_) {
@@ -3781,6 +4050,10 @@ gsl::not_null<Node*> Graph::AllocateNode() {
   ++num_of_nodes_;
   GraphResolveNeeded(true);
 
+#if !defined(ORT_MINIMAL_BUILD)
+  RecordNodeChange(node->Index());
+#endif
+
   return gsl::not_null<Node*>{node};
 }
 
@@ -3796,11 +4069,27 @@ bool Graph::ReleaseNode(NodeIndex index) {
     --num_of_nodes_;
     GraphProtoSyncNeeded(true);
     GraphResolveNeeded(true);
+#if !defined(ORT_MINIMAL_BUILD)
+    RecordNodeChange(index);
+#endif
   }
 
   return true;
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+void Graph::RecordNodeChange(NodeIndex node_index) const {
+  const Graph* main_graph = this;
+  while (main_graph->parent_graph_ != nullptr) {
+    main_graph = main_graph->parent_graph_;
+  }
+
+  if (main_graph->node_change_recorder_) {
+    main_graph->node_change_recorder_(*this, node_index);
+  }
+}
+#endif
+
 Node& Graph::CreateFusedSubGraphNode(const IndexedSubGraph& sub_graph, const std::string& fused_node_name) {
   const auto* func_meta_def = sub_graph.GetMetaDef();
   ORT_ENFORCE(nullptr != func_meta_def);
@@ -49,40 +49,46 @@ GraphViewer::GraphViewer(const Graph& graph, const IndexedSubGraph& filter_info)
     : GraphViewer(graph, &filter_info) {
 }
 
-GraphViewer::GraphViewer(const Graph& graph, const IndexedSubGraph* filter_info)
+GraphViewer::GraphViewer(const Graph& graph, UnorderedTag)
+    : GraphViewer(graph, nullptr, false) {
+}
+
+GraphViewer::GraphViewer(const Graph& graph, const IndexedSubGraph* filter_info, bool sort_nodes)
     : graph_{&graph},
       // we can setup the filter here if needed. filtered_node_indices_ will have been populated by the time it's used
       graph_nodes_{graph_->FilteredNodes(
           filter_info ? [this](NodeIndex idx) { return filtered_node_indices_.count(idx) == 0; }
                       : ConstGraphNodes::NodeFilterFunc(nullptr))},
       filter_info_{filter_info} {
-  std::vector<const Node*> leaf_nodes;
-  for (auto& node : graph_->Nodes()) {
-    // This is a leaf node (without any output node)
-    if (node.OutputNodesBegin() == node.OutputNodesEnd()) {
-      leaf_nodes.push_back(&node);
-    }
-    // This is a root node (without any input node)
-    if (node.InputEdgesBegin() == node.InputEdgesEnd()) {
-      root_nodes_.push_back(node.Index());
+  if (sort_nodes) {
+    std::vector<const Node*> leaf_nodes;
+    for (auto& node : graph_->Nodes()) {
+      // This is a leaf node (without any output node)
+      if (node.OutputNodesBegin() == node.OutputNodesEnd()) {
+        leaf_nodes.push_back(&node);
+      }
+      // This is a root node (without any input node)
+      if (node.InputEdgesBegin() == node.InputEdgesEnd()) {
+        root_nodes_.push_back(node.Index());
+      }
     }
-  }
 
-  graph.ReverseDFSFrom(
-      leaf_nodes,
-      nullptr,
-      [this](const Node* n) {
-        nodes_in_topological_order_.push_back(n->Index());
-      },
-      NodeCompare());
+    graph.ReverseDFSFrom(
+        leaf_nodes,
+        nullptr,
+        [this](const Node* n) {
+          nodes_in_topological_order_.push_back(n->Index());
+        },
+        NodeCompare());
 
 #if !defined(ORT_MINIMAL_BUILD)
-  graph.KahnsTopologicalSort(
-      [this](const Node* n) {
-        nodes_in_topological_order_with_priority_.push_back(n->Index());
-      },
-      PriorityNodeCompare());
+    graph.KahnsTopologicalSort(
+        [this](const Node* n) {
+          nodes_in_topological_order_with_priority_.push_back(n->Index());
+        },
+        PriorityNodeCompare());
 #endif
+  }
 
   if (filter_info_) {
     // validate. if something is off here it's a bug in our code
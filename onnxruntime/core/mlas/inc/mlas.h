@@ -142,6 +142,9 @@ enum MLAS_ACTIVATION_KIND {
     MlasLogisticActivation,
     MlasClipActivation,
     MlasHardSigmoidActivation,
+    MlasGeluErfActivation,
+    MlasGeluTanhActivation,
+    MlasSwishActivation,
 };
 
 struct MLAS_ACTIVATION {
@@ -158,6 +161,9 @@ struct MLAS_ACTIVATION {
             float alpha;
             float beta;
         } HardSigmoid;
+        struct {
+            float alpha;
+        } Swish;
         float Values[2];
     } Parameters;
 };
@@ -173,12 +179,68 @@ MlasActivation(
     size_t ldc
     );
 
+/**
+ * @brief Add a bias vector to each row of the input matrix and apply an
+ *        activation function in a single pass.
+ *
+ * The GELU (erf and tanh forms) and Swish activations use dedicated fused
+ * kernels. Other activation kinds add the bias and then use MlasActivation.
+ *
+ * @param Activation  Supplies the parameters for the activation.
+ * @param Input       Supplies the input matrix of M rows of N elements.
+ * @param Bias        Supplies the optional bias vector of N elements.
+ * @param Output      Supplies the output matrix, which may alias the input.
+ * @param M           Supplies the number of rows.
+ * @param N           Supplies the number of elements per row.
+ */
+void
+MLASCALL
+MlasComputeBiasActivation(
+    const MLAS_ACTIVATION* Activation,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t M,
+    size_t N
+    );
+
 //
 // Matrix/matrix multiply routines.
 // C := alpha * op(A) * op(B) + beta * C
 // op(X) = X or op(X) = transpose(X) or op(X) = conjg(transpose(X))
 //
 
+/**
+ * @brief Override the blocking and threading heuristics of the single
+ *        precision gemm functions, for example with the result of timing
+ *        candidates for a given problem shape. Zero values select the
+ *        default heuristics. Values that are not supported for the operation
+ *        are ignored.
+ */
+struct MLAS_SGEMM_TUNING_PARAMS {
+    size_t StrideN = 0;       /**< N dimension of the B panel, a multiple of 16. Unused if B is pre-packed */
+    size_t StrideK = 0;       /**< K dimension of the B panel. Unused if B is pre-packed */
+    size_t ThreadCountM = 0;  /**< Number of partitions of each operation along the M dimension */
+    size_t ThreadCountN = 0;  /**< Number of partitions of each operation along the N dimension */
+};
+
+/**
+ * @brief Returns the largest product StrideN * StrideK supported by
+ *        MLAS_SGEMM_TUNING_PARAMS. StrideK is further limited to
+ *        MlasSgemmTuningMaximumStrideK() if matrix A is transposed.
+ */
+size_t
+MLASCALL
+MlasSgemmTuningMaximumPanelSize(
+    void
+    );
+
+size_t
+MLASCALL
+MlasSgemmTuningMaximumStrideK(
+    void
+    );
+
 /**
  * @brief Supply matrices data information to single precision gemm functions
  */
@@ -192,6 +254,10 @@ struct MLAS_SGEMM_DATA_PARAMS {
     float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
     float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
     bool BIsPacked = false;   /**< Whether B is pre-packed */
+    const float* const* BNumaReplicas = nullptr; /**< Optional copies of B indexed by NUMA node, read by the threads of each node instead of B */
+    size_t BNumaReplicaCount = 0;                /**< Supplies the number of entries in BNumaReplicas */
+    const MLAS_ACTIVATION* Activation = nullptr; /**< Optional activation applied to each block of C after it is computed */
+    const MLAS_SGEMM_TUNING_PARAMS* Tuning = nullptr; /**< Optional blocking and threading overrides. The partition of the first entry of a batch applies to the whole batch */
 };
 
 /**
@@ -734,6 +800,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -766,6 +833,13 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t OutputTileSize;
+            size_t TileCount;
+            size_t TileBlockSize;
+            size_t FilterBufferSize;
+            const float* PackedFilter;
+        } Winograd;
     } u;
 };
 
@@ -799,6 +873,39 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Winograd convolution routines.
+//
+// MlasConvPrepare selects MlasConvAlgorithmWinograd for 3x3 convolutions with
+// unit strides and dilations and enough channels to amortize the transforms,
+// using F(4x4,3x3) or F(2x2,3x3) depending on the output size. MlasConv then
+// transforms the filter into the last u.Winograd.FilterBufferSize elements of
+// the working buffer, unless u.Winograd.PackedFilter is set by the caller after
+// MlasConvPrepare to a filter packed by MlasConvWinogradPackFilter with the
+// same u.Winograd.OutputTileSize. In that case, the working buffer only needs
+// WorkingBufferSize - u.Winograd.FilterBufferSize elements.
+//
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t OutputTileSize,
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels
+    );
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t OutputTileSize,
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* PackedFilter
+    );
+
 void
 MLASCALL
 MlasConvDepthwise(
@@ -996,6 +1103,146 @@ MlasComputeSoftmax(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Reduction routines.
+//
+// MlasReduceRows reduces each of the Rows contiguous rows of RowLength
+// elements to a single value. MlasReduceColumns reduces Batch matrices of
+// Rows x Columns elements along their rows, producing Columns values per
+// matrix: the strided outer axis and "keep last axis" layouts of a reduction.
+// The arg variants produce the index of the maximum or minimum element
+// instead, with ties resolved to the first index unless SelectLastIndex.
+//
+// Sums are accumulated in fixed blocks whose partial results are combined in
+// order, so the output does not depend on the number of threads. A NaN is
+// only propagated by the maximum and minimum reductions if it is the first
+// element reduced, matching a scalar loop of "if (x > acc) acc = x".
+//
+
+enum MLAS_REDUCE_KIND {
+    MlasReduceSum,
+    MlasReduceMaximum,
+    MlasReduceMinimum,
+};
+
+void
+MLASCALL
+MlasReduceRows(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t Rows,
+    size_t RowLength,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasReduceColumns(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t Batch,
+    size_t Rows,
+    size_t Columns,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasArgReduceRows(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    int64_t* Output,
+    size_t Rows,
+    size_t RowLength,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasArgReduceColumns(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    int64_t* Output,
+    size_t Batch,
+    size_t Rows,
+    size_t Columns,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Layer normalization routines.
+//
+
+void
+MLASCALL
+MlasLayerNorm(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t RowCount,
+    size_t RowSize,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasSkipLayerNorm(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Fused multi-head attention.
+//
+// MlasFlashAttention computes Softmax(Scale * Q x K' + KeyBias) x V for each
+// batch and head by streaming blocks of keys and values through an online
+// softmax, so the SequenceLength x KvSequenceLength score matrix is never
+// materialized. Query, Key and Value are laid out as [B][N][S][H] and
+// [B][N][S*][H]; the output is written as [B][S][N][VHeadSize]. KeyBias is an
+// optional additive [B][S*] bias broadcast over the query rows and heads. If
+// Causal is set, query row s only attends to keys up to s + (S* - S).
+//
+
+struct MLAS_FLASH_ATTENTION_PARAMETERS {
+    size_t BatchCount;
+    size_t HeadCount;
+    size_t SequenceLength;
+    size_t KvSequenceLength;
+    size_t QkHeadSize;
+    size_t VHeadSize;
+    float Scale;
+    bool Causal;
+    const float* Query;
+    const float* Key;
+    const float* Value;
+    const float* KeyBias;
+    float* Output;
+};
+
+void
+MLASCALL
+MlasFlashAttention(
+    const MLAS_FLASH_ATTENTION_PARAMETERS* Parameters,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasComputeTanh(
@@ -1007,6 +1254,10 @@ MlasComputeTanh(
 //
 // Half-precision floating-point routines.
 //
+// MLAS_FP16 holds the bits of an IEEE 754 half precision value.
+//
+
+typedef uint16_t MLAS_FP16;
 
 extern "C"
 void
@@ -1017,6 +1268,336 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    );
+
+//
+// Half precision matrix/matrix multiply routines.
+// C := alpha * A * op(B) + beta * C
+//
+// The matrices are stored as half precision values and the products are
+// accumulated in single precision, so only the storage and the memory traffic
+// are halved. Matrix B may be prepacked with MlasHalfGemmPackB, which keeps
+// the packed weights in half precision.
+//
+
+/**
+ * @brief Supply matrices data information to half precision gemm functions
+ */
+struct MLAS_HALF_GEMM_DATA_PARAMS {
+    const MLAS_FP16* A = nullptr; /**< Supplies the address of matrix A */
+    size_t lda = 0;               /**< Supplies the first dimension of matrix A. */
+    const void* B = nullptr;      /**< Supplies the address of matrix B, or the buffer from MlasHalfGemmPackB */
+    size_t ldb = 0;               /**< Supplies the first dimension of matrix B. */
+    MLAS_FP16* C = nullptr;       /**< Supplies the address of matrix C */
+    size_t ldc = 0;               /**< Supplies the first dimension of matrix C. */
+    float alpha = 1.0f;           /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
+    float beta = 0.0f;            /**< Supplies the scalar beta multiplier (see SGEMM definition) */
+    bool BIsPacked = false;       /**< Whether B is pre-packed */
+};
+
+/**
+ * @brief  Batched half precision matrix/matrix multiply operation
+ *
+ * @param TransB     Supplies the transpose operation for matrix B. Ignored if
+                     matrix B is pre-packed.
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+                     of rows of matrix B.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasHalfGemmBatch(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+inline
+void
+MlasHalfGemm(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_HALF_GEMM_DATA_PARAMS& Data,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasHalfGemmBatch(TransB, M, N, K, &Data, 1, ThreadPool);
+}
+
+size_t
+MLASCALL
+MlasHalfGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasHalfGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const MLAS_FP16* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+//
+// Blockwise quantized weight matrix/matrix multiply routines.
+// C := A * B + Bias
+//
+// Matrix A and matrix C are single precision. Matrix B is a weight matrix of
+// K rows and N columns that is stored column by column as blocks of BlkLen
+// unsigned integers of BlkBitWidth bits. Each block has a single precision
+// scale and an optional zero point, and an element dequantizes as
+// (Quantized - ZeroPoint) * Scale. The default zero point is the midpoint of
+// the integer range, 2^(BlkBitWidth - 1).
+//
+// For each column, QuantBData holds BlockCountK = ceil(K / BlkLen) blocks of
+// BlkLen * BlkBitWidth / 8 bytes. 4-bit elements are packed two per byte with
+// the even element in the low nibble. The last block of a column is padded
+// when K is not a multiple of BlkLen. QuantBScale holds BlockCountK scales per
+// column. QuantBZeroPoint holds BlockCountK zero points per column, packed two
+// per byte for 4-bit quantization and padded to a whole byte per column.
+//
+
+/**
+ * @brief Supply matrices data information to blockwise quantized weight gemm functions
+ */
+struct MLAS_SQNBIT_GEMM_DATA_PARAMS {
+    const float* A = nullptr;                  /**< Supplies the address of matrix A */
+    size_t lda = 0;                            /**< Supplies the first dimension of matrix A. */
+    const uint8_t* QuantBData = nullptr;       /**< Supplies the address of the quantized blocks of matrix B */
+    const float* QuantBScale = nullptr;        /**< Supplies the address of the block scales of matrix B */
+    const uint8_t* QuantBZeroPoint = nullptr;  /**< Supplies the address of the block zero points of matrix B, optional */
+    const float* Bias = nullptr;               /**< Supplies the address of the bias vector of N values, optional */
+    float* C = nullptr;                        /**< Supplies the address of matrix C */
+    size_t ldc = 0;                            /**< Supplies the first dimension of matrix C. */
+};
+
+/**
+ * @brief Determines whether the blockwise quantized weight gemm supports the
+ *        quantization parameters.
+ *
+ * @param BlkBitWidth Supplies the number of bits per quantized element, 4 or 8.
+ * @param BlkLen      Supplies the number of elements per block, a power of two
+ *                    from 16 to 256.
+ */
+bool
+MLASCALL
+MlasIsSQNBitGemmAvailable(
+    size_t BlkBitWidth,
+    size_t BlkLen
+    );
+
+/**
+ * @brief  Batched matrix/matrix multiply with a blockwise quantized matrix B
+ *
+ * @param M           Supplies the number of rows of matrix A and matrix C.
+ * @param N           Supplies the number of columns of matrix B and matrix C.
+ * @param K           Supplies the number of columns of matrix A and the number
+                      of rows of matrix B.
+ * @param BlkBitWidth Supplies the number of bits per quantized element.
+ * @param BlkLen      Supplies the number of elements per block.
+ * @param Data        A array of matrices data parameters
+ * @param BatchSize   Supplies number of multiplications in this batch
+ * @param ThreadPool  Supplies the thread pool object to use, else nullptr if the
+                      base library threading support should be used.
+ */
+void
+MLASCALL
+MlasSQNBitGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const MLAS_SQNBIT_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief Computes the buffer sizes of a blockwise quantized matrix B.
+ *
+ * @param BlkBitWidth                Supplies the number of bits per quantized element.
+ * @param BlkLen                     Supplies the number of elements per block.
+ * @param N                          Supplies the number of columns of matrix B.
+ * @param K                          Supplies the number of rows of matrix B.
+ * @param QuantBDataSizeInBytes      Receives the size of the quantized blocks.
+ * @param QuantBScaleCount           Receives the number of block scales.
+ * @param QuantBZeroPointSizeInBytes Receives the size of the block zero points.
+ */
+void
+MLASCALL
+MlasSQNBitGemmQuantBSizes(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    size_t N,
+    size_t K,
+    size_t* QuantBDataSizeInBytes,
+    size_t* QuantBScaleCount,
+    size_t* QuantBZeroPointSizeInBytes
+    );
+
+/**
+ * @brief Quantizes a single precision matrix B to the blockwise layout.
+ *
+ * @param BlkBitWidth     Supplies the number of bits per quantized element.
+ * @param BlkLen          Supplies the number of elements per block.
+ * @param B               Supplies the address of matrix B, K rows of N values.
+ * @param ldb             Supplies the first dimension of matrix B.
+ * @param N               Supplies the number of columns of matrix B.
+ * @param K               Supplies the number of rows of matrix B.
+ * @param QuantBData      Receives the quantized blocks.
+ * @param QuantBScale     Receives the block scales.
+ * @param QuantBZeroPoint Receives the block zero points, or nullptr to quantize
+                          symmetrically around the default zero point.
+ */
+void
+MLASCALL
+MlasSQNBitGemmQuantizeB(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const float* B,
+    size_t ldb,
+    size_t N,
+    size_t K,
+    uint8_t* QuantBData,
+    float* QuantBScale,
+    uint8_t* QuantBZeroPoint
+    );
+
+//
+// Sparse single precision matrix/matrix multiply routines.
+//
+// Matrix B is packed once in a compressed format that only keeps its nonzero
+// blocks. A block is a single row of BlkN consecutive columns, so BlkN=1 packs
+// unstructured sparse weights and BlkN=4 packs weights pruned in 1x4 blocks.
+// The multiply vectorizes over the rows of matrix A, so its cost is
+// proportional to the number of nonzero blocks of matrix B.
+//
+
+/**
+ * @brief Supply matrices data information to sparse gemm functions
+ */
+struct MLAS_SGEMM_SPARSE_DATA_PARAMS {
+    const float* A = nullptr;        /**< Supplies the address of matrix A */
+    size_t lda = 0;                  /**< Supplies the first dimension of matrix A. */
+    const void* PackedB = nullptr;   /**< Supplies the address of matrix B packed by MlasGemmSparsePackB */
+    float* C = nullptr;              /**< Supplies the address of matrix C */
+    size_t ldc = 0;                  /**< Supplies the first dimension of matrix C. */
+    float alpha = 1.0f;              /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
+};
+
+/**
+ * @brief Counts the blocks of matrix B that have a nonzero element.
+ *
+ * @param TransB Supplies the transpose operation for matrix B.
+ * @param BlkN   Supplies the number of columns per block, 1 or 4.
+ * @param N      Supplies the number of columns of matrix B.
+ * @param K      Supplies the number of rows of matrix B.
+ * @param B      Supplies the address of matrix B.
+ * @param ldb    Supplies the first dimension of matrix B.
+ */
+size_t
+MLASCALL
+MlasGemmSparseCountBlocks(
+    CBLAS_TRANSPOSE TransB,
+    size_t BlkN,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+/**
+ * @brief Computes the size in bytes of matrix B packed by MlasGemmSparsePackB.
+ *
+ * @param TransB Supplies the transpose operation for matrix B.
+ * @param BlkN   Supplies the number of columns per block, 1 or 4.
+ * @param N      Supplies the number of columns of matrix B.
+ * @param K      Supplies the number of rows of matrix B.
+ * @param B      Supplies the address of matrix B.
+ * @param ldb    Supplies the first dimension of matrix B.
+ */
+size_t
+MLASCALL
+MlasGemmSparsePackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t BlkN,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+/**
+ * @brief Packs the nonzero blocks of matrix B.
+ *
+ * @param TransB  Supplies the transpose operation for matrix B.
+ * @param BlkN    Supplies the number of columns per block, 1 or 4.
+ * @param N       Supplies the number of columns of matrix B.
+ * @param K       Supplies the number of rows of matrix B.
+ * @param B       Supplies the address of matrix B.
+ * @param ldb     Supplies the first dimension of matrix B.
+ * @param PackedB Supplies the address of the packed buffer, with the size
+ *                returned by MlasGemmSparsePackBSize and aligned to
+ *                MlasGetPreferredBufferAlignment.
+ */
+void
+MLASCALL
+MlasGemmSparsePackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t BlkN,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+/**
+ * @brief  Batched single precision matrix/matrix multiply with a sparse
+ *         packed matrix B: C = alpha * A * B
+ *
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+                     of rows of matrix B.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasGemmSparseBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_SPARSE_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Transpose routines.
 //
@@ -1039,6 +1620,15 @@ MlasTranspose(
     size_t N
     );
 
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t M,
+    size_t N
+    );
+
 void
 MLASCALL
 MlasTranspose(
@@ -509,5 +509,31 @@ Return Value:
             MlasActivationKernel<MlasHardSigmoidActivation>(Activation, Buffer, Bias, M, N, ldc);
             break;
         }
+
+        case MlasGeluErfActivation:
+        case MlasGeluTanhActivation:
+        case MlasSwishActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+#if defined(MLAS_TARGET_AMD64)
+            MLAS_BIAS_ACTIVATION_FLOAT_KERNEL* BiasActivationKernel = GetMlasPlatform().BiasActivationF32Kernel;
+#else
+            MLAS_BIAS_ACTIVATION_FLOAT_KERNEL* BiasActivationKernel = MlasBiasActivationF32Kernel;
+#endif
+
+            if (N == ldc) {
+                BiasActivationKernel(Activation, Buffer, nullptr, Buffer, M * N);
+            } else {
+                while (M-- > 0) {
+                    BiasActivationKernel(Activation, Buffer, nullptr, Buffer, N);
+                    Buffer += ldc;
+                }
+            }
+
+            break;
+        }
     }
 }
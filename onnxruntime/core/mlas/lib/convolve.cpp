@@ -902,6 +902,18 @@ Return Value:
         return;
     }
 
+    //
+    // The Winograd algorithm iterates over the groups and batches itself, so
+    // that the filter of a group is transformed once.
+    //
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+
+        MlasConvWinograd(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+
+        return;
+    }
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
     if (Algorithm == MlasConvAlgorithmDepthwise) {
@@ -1001,6 +1013,9 @@ Return Value:
 
                     break;
                 }
+
+                default:
+                    break;
             }
 
             //
@@ -1210,6 +1225,14 @@ Return Value:
         }
     }
 
+    //
+    // Detect 3x3 convolutions that are faster with the Winograd algorithm.
+    //
+
+    if (MlasConvWinogradPrepare(Parameters, WorkingBufferSize, ThreadPool)) {
+        return;
+    }
+
     if (FilterCount > OutputSize) {
 
         //
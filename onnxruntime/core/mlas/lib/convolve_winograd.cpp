@@ -0,0 +1,914 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convolve_winograd.cpp
+
+Abstract:
+
+    This module implements the Winograd minimal filtering algorithm for 3x3
+    convolutions with unit strides and dilations.
+
+    The output is divided in tiles of OutputTileSize x OutputTileSize elements
+    that are computed from input tiles of TileSize x TileSize elements, with
+    TileSize = OutputTileSize + 2. F(2x2,3x3) and F(4x4,3x3) are supported.
+
+    For each block of tiles, the input tiles are transformed to the Winograd
+    domain, multiplied with the transformed filter using TileSize * TileSize
+    independent GEMMs that reduce over the input channels, and transformed back
+    to the output:
+
+        Y = AT * [(G * g * GT) . (BT * d * B)] * A
+
+    The transforms are those of "Fast Algorithms for Convolutional Neural
+    Networks" (Lavin & Gray, 2015).
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the minimum number of input channels and filters for which the
+// Winograd algorithm is selected. Below this, the cost of the transforms is
+// not amortized by the reduction of the multiplications.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS         32
+
+//
+// Define the minimum output height and width for which the Winograd algorithm
+// is selected and the minimum output height and width for which F(4x4,3x3) is
+// used instead of F(2x2,3x3).
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_OUTPUT_SIZE      4
+#define MLAS_CONV_WINOGRAD_F4_MINIMUM_OUTPUT_SIZE   8
+
+//
+// Define the target number of elements of the transformed input and output
+// tiles of a tile block, and the range of the number of tiles in a block.
+//
+
+#define MLAS_CONV_WINOGRAD_TILE_BLOCK_ELEMENTS      (128 * 1024)
+#define MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK       8
+#define MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK       64
+
+//
+// Define the one dimensional transforms of F(2,3) and F(4,3). The two
+// dimensional transforms are computed by applying them to the columns and
+// then to the rows of a tile.
+//
+
+struct MLAS_CONV_WINOGRAD_F2X3
+{
+    static constexpr size_t OutputTileSize = 2;
+    static constexpr size_t TileSize = 4;
+
+    //
+    // Computes BT * d.
+    //
+
+    MLAS_FORCEINLINE
+    static
+    void
+    InputTransform(
+        const float* d,
+        size_t ldd,
+        float* v,
+        size_t ldv
+        )
+    {
+        const float d0 = d[0];
+        const float d1 = d[ldd];
+        const float d2 = d[2 * ldd];
+        const float d3 = d[3 * ldd];
+
+        v[0] = d0 - d2;
+        v[ldv] = d1 + d2;
+        v[2 * ldv] = d2 - d1;
+        v[3 * ldv] = d1 - d3;
+    }
+
+    //
+    // Computes G * g.
+    //
+
+    MLAS_FORCEINLINE
+    static
+    void
+    FilterTransform(
+        const float* g,
+        size_t ldg,
+        float* u,
+        size_t ldu
+        )
+    {
+        const float g0 = g[0];
+        const float g1 = g[ldg];
+        const float g2 = g[2 * ldg];
+
+        u[0] = g0;
+        u[ldu] = 0.5f * (g0 + g1 + g2);
+        u[2 * ldu] = 0.5f * (g0 - g1 + g2);
+        u[3 * ldu] = g2;
+    }
+
+    //
+    // Computes AT * m.
+    //
+
+    MLAS_FORCEINLINE
+    static
+    void
+    OutputTransform(
+        const float* m,
+        size_t ldm,
+        float* y,
+        size_t ldy
+        )
+    {
+        const float m0 = m[0];
+        const float m1 = m[ldm];
+        const float m2 = m[2 * ldm];
+        const float m3 = m[3 * ldm];
+
+        y[0] = m0 + m1 + m2;
+        y[ldy] = m1 - m2 - m3;
+    }
+};
+
+struct MLAS_CONV_WINOGRAD_F4X3
+{
+    static constexpr size_t OutputTileSize = 4;
+    static constexpr size_t TileSize = 6;
+
+    MLAS_FORCEINLINE
+    static
+    void
+    InputTransform(
+        const float* d,
+        size_t ldd,
+        float* v,
+        size_t ldv
+        )
+    {
+        const float d0 = d[0];
+        const float d1 = d[ldd];
+        const float d2 = d[2 * ldd];
+        const float d3 = d[3 * ldd];
+        const float d4 = d[4 * ldd];
+        const float d5 = d[5 * ldd];
+
+        v[0] = 4.0f * d0 - 5.0f * d2 + d4;
+        v[ldv] = d3 + d4 - 4.0f * (d1 + d2);
+        v[2 * ldv] = d4 - d3 + 4.0f * (d1 - d2);
+        v[3 * ldv] = d4 - d2 + 2.0f * (d3 - d1);
+        v[4 * ldv] = d4 - d2 + 2.0f * (d1 - d3);
+        v[5 * ldv] = 4.0f * d1 - 5.0f * d3 + d5;
+    }
+
+    MLAS_FORCEINLINE
+    static
+    void
+    FilterTransform(
+        const float* g,
+        size_t ldg,
+        float* u,
+        size_t ldu
+        )
+    {
+        const float g0 = g[0];
+        const float g1 = g[ldg];
+        const float g2 = g[2 * ldg];
+
+        u[0] = g0 / 4.0f;
+        u[ldu] = -(g0 + g1 + g2) / 6.0f;
+        u[2 * ldu] = -(g0 - g1 + g2) / 6.0f;
+        u[3 * ldu] = g0 / 24.0f + g1 / 12.0f + g2 / 6.0f;
+        u[4 * ldu] = g0 / 24.0f - g1 / 12.0f + g2 / 6.0f;
+        u[5 * ldu] = g2;
+    }
+
+    MLAS_FORCEINLINE
+    static
+    void
+    OutputTransform(
+        const float* m,
+        size_t ldm,
+        float* y,
+        size_t ldy
+        )
+    {
+        const float m0 = m[0];
+        const float m1 = m[ldm];
+        const float m2 = m[2 * ldm];
+        const float m3 = m[3 * ldm];
+        const float m4 = m[4 * ldm];
+        const float m5 = m[5 * ldm];
+
+        const float s12 = m1 + m2;
+        const float d12 = m1 - m2;
+        const float s34 = m3 + m4;
+        const float d34 = m3 - m4;
+
+        y[0] = m0 + s12 + s34;
+        y[ldy] = d12 + 2.0f * d34;
+        y[2 * ldy] = s12 + 4.0f * s34;
+        y[3 * ldy] = d12 + 8.0f * d34 + m5;
+    }
+};
+
+//
+// Define the parameters to execute the tile blocks of a convolution operation
+// on worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* Filter;
+    float* WorkingBuffer;
+    float* Output;
+    size_t TileBlockCount;
+    size_t InputBatchStride;
+    size_t OutputBatchStride;
+};
+
+template<typename WinogradKernel>
+void
+MlasConvWinogradPackFilterGroup(
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the filter of a group to the Winograd domain.
+
+Arguments:
+
+    FilterCount - Supplies the number of filters of the group.
+
+    InputChannels - Supplies the number of input channels of the group.
+
+    Filter - Supplies the filter tensor of the group, with a shape of
+        [FilterCount, InputChannels, 3, 3].
+
+    PackedFilter - Receives the transformed filter, with a shape of
+        [TileSize * TileSize, FilterCount, InputChannels].
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t TileSize = WinogradKernel::TileSize;
+
+    const size_t ElementStride = FilterCount * InputChannels;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            const float* g = Filter + (f * InputChannels + c) * 9;
+            float* u = PackedFilter + f * InputChannels + c;
+            float Temp[TileSize * 3];
+
+            for (size_t j = 0; j < 3; j++) {
+                WinogradKernel::FilterTransform(g + j, 3, Temp + j, 3);
+            }
+
+            for (size_t i = 0; i < TileSize; i++) {
+                WinogradKernel::FilterTransform(Temp + i * 3, 1,
+                    u + i * TileSize * ElementStride, ElementStride);
+            }
+        }
+    }
+}
+
+template<typename WinogradKernel>
+void
+MlasConvWinogradTileBlock(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float* WorkingBuffer,
+    float* Output,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of output tiles of a convolution operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the batch and group.
+
+    Filter - Supplies the transformed filter of the group.
+
+    WorkingBuffer - Supplies the working buffer of the thread.
+
+    Output - Supplies the output tensor of the batch and group.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t OutputTileSize = WinogradKernel::OutputTileSize;
+    constexpr size_t TileSize = WinogradKernel::TileSize;
+    constexpr size_t TileElements = TileSize * TileSize;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+
+    const size_t TileCountWidth = (OutputWidth + OutputTileSize - 1) / OutputTileSize;
+
+    const float Beta = Parameters->Beta;
+
+    //
+    // The transformed input tiles have a shape of
+    // [TileElements, InputChannels, TileBlockSize] and the transformed output
+    // tiles have a shape of [TileElements, FilterCount, TileBlockSize].
+    //
+
+    float* TransformedInput = WorkingBuffer;
+    float* TransformedOutput = WorkingBuffer + TileElements * InputChannels * TileBlockSize;
+
+    const size_t InputElementStride = InputChannels * TileBlockSize;
+    const size_t OutputElementStride = FilterCount * TileBlockSize;
+
+    //
+    // Transform the input tiles.
+    //
+
+    for (size_t t = 0; t < TileCount; t++) {
+
+        const size_t TileIndex = TileStart + t;
+        const size_t TileRow = TileIndex / TileCountWidth;
+        const size_t TileColumn = TileIndex % TileCountWidth;
+
+        //
+        // Compute the origin of the input tile, which is negative for the
+        // tiles that overlap the padding.
+        //
+
+        const ptrdiff_t ih0 = ptrdiff_t(TileRow * OutputTileSize) - ptrdiff_t(PaddingTop);
+        const ptrdiff_t iw0 = ptrdiff_t(TileColumn * OutputTileSize) - ptrdiff_t(PaddingLeft);
+
+        const bool IsInterior = ih0 >= 0 && iw0 >= 0 &&
+            size_t(ih0) + TileSize <= InputHeight && size_t(iw0) + TileSize <= InputWidth;
+
+        const float* input = Input;
+        float* v = TransformedInput + t;
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            float Tile[TileElements];
+            const float* d;
+            size_t ldd;
+
+            if (IsInterior) {
+
+                d = input + size_t(ih0) * InputWidth + size_t(iw0);
+                ldd = InputWidth;
+
+            } else {
+
+                for (size_t i = 0; i < TileSize; i++) {
+
+                    const ptrdiff_t ih = ih0 + ptrdiff_t(i);
+
+                    for (size_t j = 0; j < TileSize; j++) {
+
+                        const ptrdiff_t iw = iw0 + ptrdiff_t(j);
+
+                        if (ih >= 0 && size_t(ih) < InputHeight && iw >= 0 && size_t(iw) < InputWidth) {
+                            Tile[i * TileSize + j] = input[size_t(ih) * InputWidth + size_t(iw)];
+                        } else {
+                            Tile[i * TileSize + j] = 0.0f;
+                        }
+                    }
+                }
+
+                d = Tile;
+                ldd = TileSize;
+            }
+
+            float Temp[TileElements];
+
+            for (size_t j = 0; j < TileSize; j++) {
+                WinogradKernel::InputTransform(d + j, ldd, Temp + j, TileSize);
+            }
+
+            for (size_t i = 0; i < TileSize; i++) {
+                WinogradKernel::InputTransform(Temp + i * TileSize, 1,
+                    v + i * TileSize * InputElementStride, InputElementStride);
+            }
+
+            input += InputSize;
+            v += TileBlockSize;
+        }
+    }
+
+    //
+    // Multiply the transformed filter and input tiles for each element of the
+    // tiles.
+    //
+
+    for (size_t e = 0; e < TileElements; e++) {
+
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCount,
+            InputChannels, 1.0f, Filter + e * FilterCount * InputChannels,
+            InputChannels, TransformedInput + e * InputElementStride, TileBlockSize,
+            0.0f, TransformedOutput + e * OutputElementStride, TileBlockSize);
+    }
+
+    //
+    // Transform the output tiles and store the elements that are within the
+    // output tensor.
+    //
+
+    for (size_t t = 0; t < TileCount; t++) {
+
+        const size_t TileIndex = TileStart + t;
+        const size_t oh0 = (TileIndex / TileCountWidth) * OutputTileSize;
+        const size_t ow0 = (TileIndex % TileCountWidth) * OutputTileSize;
+
+        const size_t RowCount = std::min(OutputTileSize, OutputHeight - oh0);
+        const size_t ColumnCount = std::min(OutputTileSize, OutputWidth - ow0);
+
+        const float* m = TransformedOutput + t;
+        float* output = Output + oh0 * OutputWidth + ow0;
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            float Temp[OutputTileSize * TileSize];
+            float Tile[OutputTileSize * OutputTileSize];
+
+            for (size_t j = 0; j < TileSize; j++) {
+                WinogradKernel::OutputTransform(m + j * OutputElementStride,
+                    TileSize * OutputElementStride, Temp + j, TileSize);
+            }
+
+            for (size_t i = 0; i < OutputTileSize; i++) {
+                WinogradKernel::OutputTransform(Temp + i * TileSize, 1,
+                    Tile + i * OutputTileSize, 1);
+            }
+
+            for (size_t i = 0; i < RowCount; i++) {
+
+                float* y = output + i * OutputWidth;
+
+                if (Beta == 0.0f) {
+
+                    for (size_t j = 0; j < ColumnCount; j++) {
+                        y[j] = Tile[i * OutputTileSize + j];
+                    }
+
+                } else {
+
+                    for (size_t j = 0; j < ColumnCount; j++) {
+                        y[j] = Tile[i * OutputTileSize + j] + Beta * y[j];
+                    }
+                }
+            }
+
+            m += TileBlockSize;
+            output += OutputSize;
+        }
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute the tile blocks of
+    the batches of a group of a convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t TileSize = Parameters->u.Winograd.OutputTileSize + 2;
+    const size_t TileCount = Parameters->u.Winograd.TileCount;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+
+    //
+    // Compute the range of tile blocks of all the batches to use for this
+    // thread.
+    //
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, Parameters->ThreadCount,
+        Parameters->BatchCount * WorkBlock->TileBlockCount, &WorkIndex, &WorkRemaining);
+
+    float* WorkingBuffer = WorkBlock->WorkingBuffer + size_t(Index) * TileSize * TileSize *
+        (Parameters->InputChannels + Parameters->FilterCount) * TileBlockSize;
+
+    for (size_t WorkEnd = WorkIndex + WorkRemaining; WorkIndex < WorkEnd; WorkIndex++) {
+
+        const size_t batch = WorkIndex / WorkBlock->TileBlockCount;
+        const size_t TileStart = (WorkIndex % WorkBlock->TileBlockCount) * TileBlockSize;
+        const size_t TileBlockCount = std::min(TileBlockSize, TileCount - TileStart);
+
+        const float* Input = WorkBlock->Input + batch * WorkBlock->InputBatchStride;
+        float* Output = WorkBlock->Output + batch * WorkBlock->OutputBatchStride;
+
+        if (Parameters->u.Winograd.OutputTileSize == 4) {
+            MlasConvWinogradTileBlock<MLAS_CONV_WINOGRAD_F4X3>(Parameters, Input,
+                WorkBlock->Filter, WorkingBuffer, Output, TileStart, TileBlockCount);
+        } else {
+            MlasConvWinogradTileBlock<MLAS_CONV_WINOGRAD_F2X3>(Parameters, Input,
+                WorkBlock->Filter, WorkingBuffer, Output, TileStart, TileBlockCount);
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t OutputTileSize,
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of elements of a filter transformed by
+    MlasConvWinogradPackFilter.
+
+Arguments:
+
+    OutputTileSize - Supplies the output tile size of the Winograd algorithm,
+        either 2 or 4.
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    InputChannels - Supplies the number of input channels per group.
+
+Return Value:
+
+    Returns the number of elements of the packed filter, or zero if the output
+    tile size is not supported or if the Winograd algorithm is not selected for
+    convolutions with this number of filters and input channels.
+
+--*/
+{
+    if (OutputTileSize != 2 && OutputTileSize != 4) {
+        return 0;
+    }
+
+    if (InputChannels < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS ||
+        FilterCount < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+        return 0;
+    }
+
+    const size_t TileSize = OutputTileSize + 2;
+
+    return GroupCount * TileSize * TileSize * FilterCount * InputChannels;
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t OutputTileSize,
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a 3x3 filter to the Winograd domain, so that it can
+    be reused by the convolutions that use the Winograd algorithm with the
+    same output tile size.
+
+Arguments:
+
+    OutputTileSize - Supplies the output tile size of the Winograd algorithm,
+        either 2 or 4.
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    Filter - Supplies the filter tensor, with a shape of
+        [GroupCount * FilterCount, InputChannels, 3, 3].
+
+    PackedFilter - Receives the packed filter. The buffer must have the number
+        of elements returned by MlasConvWinogradPackFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterGroupSize = FilterCount * InputChannels * 9;
+    const size_t PackedFilterGroupSize =
+        (OutputTileSize + 2) * (OutputTileSize + 2) * FilterCount * InputChannels;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        if (OutputTileSize == 4) {
+            MlasConvWinogradPackFilterGroup<MLAS_CONV_WINOGRAD_F4X3>(FilterCount,
+                InputChannels, Filter, PackedFilter);
+        } else {
+            MlasConvWinogradPackFilterGroup<MLAS_CONV_WINOGRAD_F2X3>(FilterCount,
+                InputChannels, Filter, PackedFilter);
+        }
+
+        Filter += FilterGroupSize;
+        PackedFilter += PackedFilterGroupSize;
+    }
+}
+
+bool
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the Winograd algorithm for a convolution operation if
+    it is supported and expected to be faster than the GEMM based algorithms,
+    and computes the parameters for it.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the Winograd algorithm was selected, else false.
+
+--*/
+{
+    if (Parameters->Dimensions != 2 ||
+        Parameters->KernelShape[0] != 3 || Parameters->KernelShape[1] != 3 ||
+        Parameters->StrideShape[0] != 1 || Parameters->StrideShape[1] != 1 ||
+        Parameters->DilationShape[0] != 1 || Parameters->DilationShape[1] != 1) {
+        return false;
+    }
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+
+    if (InputChannels < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS ||
+        FilterCount < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS ||
+        OutputHeight < MLAS_CONV_WINOGRAD_MINIMUM_OUTPUT_SIZE ||
+        OutputWidth < MLAS_CONV_WINOGRAD_MINIMUM_OUTPUT_SIZE) {
+        return false;
+    }
+
+    //
+    // Use the larger tiles, which need fewer multiplications, unless the output
+    // is too small for them to be mostly filled.
+    //
+
+    const size_t OutputTileSize =
+        (OutputHeight >= MLAS_CONV_WINOGRAD_F4_MINIMUM_OUTPUT_SIZE &&
+         OutputWidth >= MLAS_CONV_WINOGRAD_F4_MINIMUM_OUTPUT_SIZE) ? 4 : 2;
+    const size_t TileSize = OutputTileSize + 2;
+    const size_t TileElements = TileSize * TileSize;
+
+    const size_t TileCount = MlasDivRoundup(OutputHeight, OutputTileSize) *
+        MlasDivRoundup(OutputWidth, OutputTileSize);
+
+    //
+    // Size the tile blocks so that the transformed input and output tiles of a
+    // block stay in the cache of the thread.
+    //
+
+    size_t TileBlockSize = MLAS_CONV_WINOGRAD_TILE_BLOCK_ELEMENTS /
+        (TileElements * (InputChannels + FilterCount));
+
+    TileBlockSize = std::max<size_t>(TileBlockSize, MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK);
+    TileBlockSize = std::min<size_t>(TileBlockSize, MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK);
+    TileBlockSize = std::min(TileBlockSize, TileCount);
+
+    const size_t TileBlockCount = MlasDivRoundup(TileCount, TileBlockSize);
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // multiplications in the Winograd domain.
+    //
+
+    ptrdiff_t TargetThreadCount;
+    const size_t WorkCount = Parameters->BatchCount * TileBlockCount;
+
+    double Complexity = double(FilterCount) * double(InputChannels) * double(TileCount) *
+        double(TileElements) * double(Parameters->BatchCount);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= WorkCount) {
+        TargetThreadCount = ptrdiff_t(WorkCount);
+    }
+
+    Parameters->ThreadCount = TargetThreadCount;
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->u.Winograd.OutputTileSize = OutputTileSize;
+    Parameters->u.Winograd.TileCount = TileCount;
+    Parameters->u.Winograd.TileBlockSize = TileBlockSize;
+    Parameters->u.Winograd.FilterBufferSize = TileElements * FilterCount * InputChannels;
+    Parameters->u.Winograd.PackedFilter = nullptr;
+
+    //
+    // The transformed filter of the current group is stored after the
+    // transformed tiles of the threads, unless the filter is packed.
+    //
+
+    *WorkingBufferSize = size_t(TargetThreadCount) * TileElements *
+        (InputChannels + FilterCount) * TileBlockSize + Parameters->u.Winograd.FilterBufferSize;
+
+    return true;
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation using the Winograd
+    algorithm.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor. It is not used if the parameters
+        supply a packed filter.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare, less the filter buffer size if the
+        parameters supply a packed filter.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t OutputTileSize = Parameters->u.Winograd.OutputTileSize;
+    const size_t TileSize = OutputTileSize + 2;
+
+    const size_t InputGroupSize = InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = FilterCount * InputChannels * 9;
+    const size_t PackedFilterGroupSize = Parameters->u.Winograd.FilterBufferSize;
+
+    const size_t BatchCount = Parameters->BatchCount;
+    const size_t GroupCount = Parameters->GroupCount;
+
+    const float* PackedFilter = Parameters->u.Winograd.PackedFilter;
+    float* FilterBuffer = WorkingBuffer + size_t(Parameters->ThreadCount) * TileSize * TileSize *
+        (InputChannels + FilterCount) * Parameters->u.Winograd.TileBlockSize;
+
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.TileBlockCount = MlasDivRoundup(Parameters->u.Winograd.TileCount,
+        Parameters->u.Winograd.TileBlockSize);
+
+    WorkBlock.InputBatchStride = GroupCount * InputGroupSize;
+    WorkBlock.OutputBatchStride = GroupCount * OutputGroupSize;
+
+    //
+    // Iterate over each group and execute the tile blocks of all the batches
+    // at once, so that the filter of a group is transformed once.
+    //
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        if (PackedFilter != nullptr) {
+            WorkBlock.Filter = PackedFilter + group * PackedFilterGroupSize;
+        } else {
+            MlasConvWinogradPackFilter(OutputTileSize, 1, FilterCount, InputChannels,
+                Filter + group * FilterGroupSize, FilterBuffer);
+            WorkBlock.Filter = FilterBuffer;
+        }
+
+        WorkBlock.Input = Input + group * InputGroupSize;
+        WorkBlock.Output = Output + group * OutputGroupSize;
+
+        MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount,
+            ThreadPool);
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        const float* bias = (Bias != nullptr) ? Bias + group * FilterCount : nullptr;
+
+        for (size_t batch = 0; batch < BatchCount; batch++) {
+            MlasActivation(Parameters->Activation, WorkBlock.Output + batch * WorkBlock.OutputBatchStride,
+                bias, FilterCount, OutputSize, OutputSize);
+        }
+    }
+}
@@ -0,0 +1,340 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    flashattn.cpp
+
+Abstract:
+
+    This module implements a fused multi-head attention operation.
+
+    Each worker processes a block of query rows for one batch and head. The
+    keys and values are streamed in blocks: the scores for a block are
+    computed into a small cache resident buffer, folded into running row
+    maximums and sums (online softmax), and the exponentiated scores are
+    immediately multiplied by the value block and accumulated into the output
+    rows. Previously accumulated output rows are rescaled whenever a row
+    maximum increases, and the rows are divided by the row sums at the end.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of query rows and key/value rows processed per block. The
+// score block is sized to stay resident in the cache.
+//
+
+#define MLAS_FLASH_ATTENTION_QUERY_BLOCK            64
+#define MLAS_FLASH_ATTENTION_KV_BLOCK               128
+
+//
+// Define the parameters to execute segments of a fused attention operation on
+// worker threads.
+//
+
+struct MLAS_FLASH_ATTENTION_WORK_BLOCK {
+    const MLAS_FLASH_ATTENTION_PARAMETERS* Parameters;
+    ptrdiff_t ThreadCount;
+    size_t QueryBlockCount;
+    size_t WorkCount;
+};
+
+void
+MlasFlashAttentionQueryBlock(
+    const MLAS_FLASH_ATTENTION_PARAMETERS* Parameters,
+    size_t BatchIndex,
+    size_t HeadIndex,
+    size_t QueryStart,
+    size_t QueryCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the attention output for a block of query rows of
+    a single batch and head.
+
+Arguments:
+
+    Parameters - Supplies the attention parameters.
+
+    BatchIndex - Supplies the batch index.
+
+    HeadIndex - Supplies the head index.
+
+    QueryStart - Supplies the index of the first query row.
+
+    QueryCount - Supplies the number of query rows, no more than
+        MLAS_FLASH_ATTENTION_QUERY_BLOCK.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Scores[MLAS_FLASH_ATTENTION_QUERY_BLOCK * MLAS_FLASH_ATTENTION_KV_BLOCK], 64);
+    float RowMaximum[MLAS_FLASH_ATTENTION_QUERY_BLOCK];
+    float RowSum[MLAS_FLASH_ATTENTION_QUERY_BLOCK];
+    float RowCorrection[MLAS_FLASH_ATTENTION_QUERY_BLOCK];
+
+    const size_t HeadCount = Parameters->HeadCount;
+    const size_t SequenceLength = Parameters->SequenceLength;
+    const size_t KvSequenceLength = Parameters->KvSequenceLength;
+    const size_t QkHeadSize = Parameters->QkHeadSize;
+    const size_t VHeadSize = Parameters->VHeadSize;
+    const size_t PastSequenceLength = KvSequenceLength - SequenceLength;
+    const size_t HeadIndexFlat = BatchIndex * HeadCount + HeadIndex;
+
+    const float* Query = Parameters->Query + (HeadIndexFlat * SequenceLength + QueryStart) * QkHeadSize;
+    const float* Key = Parameters->Key + HeadIndexFlat * KvSequenceLength * QkHeadSize;
+    const float* Value = Parameters->Value + HeadIndexFlat * KvSequenceLength * VHeadSize;
+    const float* KeyBias = (Parameters->KeyBias != nullptr) ?
+        Parameters->KeyBias + BatchIndex * KvSequenceLength : nullptr;
+
+    //
+    // The output is laid out as [B][S][N][VHeadSize], so consecutive query
+    // rows are separated by all of the heads.
+    //
+
+    const size_t ldo = HeadCount * VHeadSize;
+    float* Output = Parameters->Output + ((BatchIndex * SequenceLength + QueryStart) * HeadCount + HeadIndex) * VHeadSize;
+
+    for (size_t r = 0; r < QueryCount; r++) {
+        RowMaximum[r] = std::numeric_limits<float>::lowest();
+        RowSum[r] = 0.0f;
+    }
+
+    //
+    // Determine the number of key/value rows visible to the last query row of
+    // this block.
+    //
+
+    size_t KvLimit = KvSequenceLength;
+
+    if (Parameters->Causal) {
+        KvLimit = std::min(KvSequenceLength, PastSequenceLength + QueryStart + QueryCount);
+    }
+
+    for (size_t KvStart = 0; KvStart < KvLimit; KvStart += MLAS_FLASH_ATTENTION_KV_BLOCK) {
+
+        const size_t KvCount = std::min(size_t(MLAS_FLASH_ATTENTION_KV_BLOCK), KvLimit - KvStart);
+
+        //
+        // Compute the scaled scores for this block: Scores = Scale * Q x K'.
+        //
+
+        MlasSgemmOperation(CblasNoTrans, CblasTrans, QueryCount, KvCount, QkHeadSize,
+            Parameters->Scale, Query, QkHeadSize, Key + KvStart * QkHeadSize, QkHeadSize,
+            0.0f, Scores, KvCount);
+
+        //
+        // Fold each score row into the running softmax state. The scores are
+        // replaced by their exponentials relative to the updated row maximum.
+        //
+
+        for (size_t r = 0; r < QueryCount; r++) {
+
+            float* s = Scores + r * KvCount;
+            size_t ValidCount = KvCount;
+
+            if (Parameters->Causal) {
+                size_t RowLimit = PastSequenceLength + QueryStart + r + 1;
+                ValidCount = (RowLimit > KvStart) ? std::min(KvCount, RowLimit - KvStart) : 0;
+            }
+
+            if (ValidCount == 0) {
+                std::fill_n(s, KvCount, 0.0f);
+                RowCorrection[r] = 1.0f;
+                continue;
+            }
+
+            if (KeyBias != nullptr) {
+                for (size_t c = 0; c < ValidCount; c++) {
+                    s[c] += KeyBias[KvStart + c];
+                }
+            }
+
+#if defined(MLAS_TARGET_AMD64)
+            float Maximum = GetMlasPlatform().ReduceMaximumF32Kernel(s, ValidCount);
+#else
+            float Maximum = MlasReduceMaximumF32Kernel(s, ValidCount);
+#endif
+            Maximum = std::max(Maximum, RowMaximum[r]);
+            float NegativeMaximum = -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+            float Sum = GetMlasPlatform().ComputeSumExpF32Kernel(s, s, ValidCount, &NegativeMaximum);
+#else
+            float Sum = MlasComputeSumExpF32Kernel(s, s, ValidCount, &NegativeMaximum);
+#endif
+
+            std::fill_n(s + ValidCount, KvCount - ValidCount, 0.0f);
+
+            float Correction = (KvStart == 0) ? 0.0f : std::exp(RowMaximum[r] - Maximum);
+
+            RowMaximum[r] = Maximum;
+            RowSum[r] = RowSum[r] * Correction + Sum;
+            RowCorrection[r] = Correction;
+        }
+
+        //
+        // Rescale the previously accumulated output rows and accumulate the
+        // contribution of this block: Output += Scores x V.
+        //
+
+        float beta = 0.0f;
+
+        if (KvStart != 0) {
+
+            for (size_t r = 0; r < QueryCount; r++) {
+
+                const float Correction = RowCorrection[r];
+
+                if (Correction != 1.0f) {
+                    float* o = Output + r * ldo;
+                    for (size_t h = 0; h < VHeadSize; h++) {
+                        o[h] *= Correction;
+                    }
+                }
+            }
+
+            beta = 1.0f;
+        }
+
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, QueryCount, VHeadSize, KvCount,
+            1.0f, Scores, KvCount, Value + KvStart * VHeadSize, VHeadSize,
+            beta, Output, ldo);
+    }
+
+    //
+    // Normalize the output rows by the softmax denominators.
+    //
+
+    for (size_t r = 0; r < QueryCount; r++) {
+
+        const float Scale = 1.0f / RowSum[r];
+        float* o = Output + r * ldo;
+
+        for (size_t h = 0; h < VHeadSize; h++) {
+            o[h] *= Scale;
+        }
+    }
+}
+
+void
+MlasFlashAttentionThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    fused attention operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_FLASH_ATTENTION_WORK_BLOCK*)Context;
+    const MLAS_FLASH_ATTENTION_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->WorkCount, &WorkIndex, &WorkRemaining);
+
+    const size_t QueryBlockCount = WorkBlock->QueryBlockCount;
+
+    while (WorkRemaining > 0) {
+
+        const size_t HeadIndexFlat = WorkIndex / QueryBlockCount;
+        const size_t QueryStart = (WorkIndex % QueryBlockCount) * MLAS_FLASH_ATTENTION_QUERY_BLOCK;
+        const size_t QueryCount = std::min(size_t(MLAS_FLASH_ATTENTION_QUERY_BLOCK),
+            Parameters->SequenceLength - QueryStart);
+
+        MlasFlashAttentionQueryBlock(Parameters, HeadIndexFlat / Parameters->HeadCount,
+            HeadIndexFlat % Parameters->HeadCount, QueryStart, QueryCount);
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasFlashAttention(
+    const MLAS_FLASH_ATTENTION_PARAMETERS* Parameters,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a fused multi-head attention operation without
+    materializing the attention score matrix.
+
+Arguments:
+
+    Parameters - Supplies the attention parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Parameters->SequenceLength == 0 || Parameters->VHeadSize == 0) {
+        return;
+    }
+
+    MLAS_FLASH_ATTENTION_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.QueryBlockCount = (Parameters->SequenceLength + MLAS_FLASH_ATTENTION_QUERY_BLOCK - 1) /
+        MLAS_FLASH_ATTENTION_QUERY_BLOCK;
+    WorkBlock.WorkCount = Parameters->BatchCount * Parameters->HeadCount * WorkBlock.QueryBlockCount;
+
+    //
+    // Limit the number of threads to the number of query blocks and try to
+    // keep each thread busy with a minimum number of multiplies.
+    //
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > WorkBlock.WorkCount) {
+        ThreadCount = ptrdiff_t(WorkBlock.WorkCount);
+    }
+
+    const double Complexity = double(Parameters->BatchCount) * double(Parameters->HeadCount) *
+        double(Parameters->SequenceLength) * double(Parameters->KvSequenceLength) *
+        double(Parameters->QkHeadSize + Parameters->VHeadSize);
+
+    const double TargetThreadCount = (Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    if (double(ThreadCount) > TargetThreadCount) {
+        ThreadCount = ptrdiff_t(TargetThreadCount);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasFlashAttentionThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
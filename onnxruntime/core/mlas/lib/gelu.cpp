@@ -0,0 +1,191 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gelu.cpp
+
+Abstract:
+
+    This module implements routines to add a bias vector and apply the GELU
+    (erf and tanh forms) or Swish activation in a single pass.
+
+    The implementation below targets the base instruction set (typically
+    SSE2) while the intrinsics implementations target newer instruction sets
+    (such as AVX2 and AVX512F).
+
+--*/
+
+#include "gelu.h"
+
+//
+// Vector operations for the shared kernel templates.
+//
+
+struct MLAS_BIAS_ACTIVATION_OPS_FLOAT32X4 {
+
+    typedef MLAS_FLOAT32X4 FloatVector;
+
+    static constexpr size_t VectorLength = 4;
+
+    static FloatVector Broadcast(float Value) { return MlasBroadcastFloat32x4(Value); }
+
+    static FloatVector Load(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+
+    static void Store(float* Buffer, FloatVector Vector) { MlasStoreFloat32x4(Buffer, Vector); }
+
+    static FloatVector Add(FloatVector v1, FloatVector v2) { return MlasAddFloat32x4(v1, v2); }
+
+    static FloatVector Subtract(FloatVector v1, FloatVector v2) { return MlasSubtractFloat32x4(v1, v2); }
+
+    static FloatVector Multiply(FloatVector v1, FloatVector v2) { return MlasMultiplyFloat32x4(v1, v2); }
+
+    static FloatVector MultiplyAdd(FloatVector v1, FloatVector v2, FloatVector v3) { return MlasMultiplyAddFloat32x4(v1, v2, v3); }
+
+    static FloatVector Divide(FloatVector v1, FloatVector v2) { return MlasDivideFloat32x4(v1, v2); }
+
+    static FloatVector Minimum(FloatVector v1, FloatVector v2) { return MlasMinimumFloat32x4(v1, v2); }
+
+    static FloatVector Maximum(FloatVector v1, FloatVector v2) { return MlasMaximumFloat32x4(v1, v2); }
+
+    static FloatVector And(FloatVector v1, FloatVector v2) { return MlasAndFloat32x4(v1, v2); }
+
+    static FloatVector AndNot(FloatVector v1, FloatVector v2) { return MlasAndNotFloat32x4(v1, v2); }
+
+    static FloatVector Or(FloatVector v1, FloatVector v2) { return MlasOrFloat32x4(v1, v2); }
+
+    static FloatVector Xor(FloatVector v1, FloatVector v2) { return MlasXorFloat32x4(v1, v2); }
+
+    static FloatVector GreaterThan(FloatVector v1, FloatVector v2) { return MlasGreaterThanFloat32x4(v1, v2); }
+
+    static FloatVector PowerOf2(FloatVector Vector) { return MlasPowerOf2Float32x4(Vector); }
+};
+
+void
+MLASCALL
+MlasBiasActivationF32Kernel(
+    const MLAS_ACTIVATION* Activation,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the optional bias vector to the input vector and
+    applies the GELU or Swish activation.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Input - Supplies the input vector.
+
+    Bias - Supplies the optional bias vector.
+
+    Output - Supplies the output vector. The output may alias the input.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasBiasActivationDispatch<MLAS_BIAS_ACTIVATION_OPS_FLOAT32X4>(Activation, Input, Bias, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeBiasActivation(
+    const MLAS_ACTIVATION* Activation,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine adds a bias vector to each row of the input matrix and
+    applies an activation function.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Input - Supplies the input matrix of M rows of N elements.
+
+    Bias - Supplies the optional bias vector of N elements.
+
+    Output - Supplies the output matrix. The output may alias the input.
+
+    M - Supplies the number of rows.
+
+    N - Supplies the number of elements per row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_ACTIVATION_KIND ActivationKind = Activation->ActivationKind;
+
+    if (ActivationKind == MlasGeluErfActivation || ActivationKind == MlasGeluTanhActivation ||
+        ActivationKind == MlasSwishActivation) {
+
+#if defined(MLAS_TARGET_AMD64)
+        MLAS_BIAS_ACTIVATION_FLOAT_KERNEL* BiasActivationKernel = GetMlasPlatform().BiasActivationF32Kernel;
+#else
+        MLAS_BIAS_ACTIVATION_FLOAT_KERNEL* BiasActivationKernel = MlasBiasActivationF32Kernel;
+#endif
+
+        while (M-- > 0) {
+            BiasActivationKernel(Activation, Input, Bias, Output, N);
+            Input += N;
+            Output += N;
+        }
+
+        return;
+    }
+
+    //
+    // Add the bias vector or copy the input to the output, then apply the
+    // activation in place.
+    //
+
+    for (size_t m = 0; m < M; m++) {
+
+        const float* input = Input + m * N;
+        float* output = Output + m * N;
+
+        if (Bias != nullptr) {
+
+            size_t n = 0;
+
+            for (; n + 4 <= N; n += 4) {
+                MlasStoreFloat32x4(output + n, MlasAddFloat32x4(MlasLoadFloat32x4(input + n),
+                                                                MlasLoadFloat32x4(Bias + n)));
+            }
+
+            for (; n < N; n++) {
+                output[n] = input[n] + Bias[n];
+            }
+
+        } else if (input != output) {
+
+            std::copy_n(input, N, output);
+        }
+    }
+
+    MlasActivation(Activation, Output, nullptr, M, N, N);
+}
@@ -0,0 +1,406 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gelu.h
+
+Abstract:
+
+    This module contains the templates shared by the kernels that add an
+    optional bias vector and apply a GELU or Swish activation in one pass.
+
+    The templates are parameterized by a structure of vector operations so
+    that the same algorithm is instantiated for the base instruction set and
+    for the wider AVX2 and AVX512F vectors in the intrinsics source files.
+
+    The error function follows the algorithm of erf.cpp. The exponential
+    function used by the tanh form of GELU and by Swish uses the same
+    polynomial, with the input range reduced so that the scale by the power
+    of two never leaves the normal range.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+//
+// Bundles the constants used by the templates below.
+//
+
+struct MLAS_BIAS_ACTIVATION_CONSTANTS {
+    static constexpr float ErfUpperAbsRange = 3.925f;
+    static constexpr float ErfSplitBoundary = 0.921875f;
+    static constexpr float ErfSMALL_P0 = -5.99104969e-4f;
+    static constexpr float ErfSMALL_P1 = 4.99339588e-3f;
+    static constexpr float ErfSMALL_P2 = -2.67667342e-2f;
+    static constexpr float ErfSMALL_P3 = 1.12818025e-1f;
+    static constexpr float ErfSMALL_P4 = -3.76124859e-1f;
+    static constexpr float ErfSMALL_P5_Minus_One = 1.28379151e-1f;
+    static constexpr float ErfBIG_P0 = 1.72948930e-5f;
+    static constexpr float ErfBIG_P1 = -3.83208680e-4f;
+    static constexpr float ErfBIG_P2 = 3.88393435e-3f;
+    static constexpr float ErfBIG_P3 = -2.42545605e-2f;
+    static constexpr float ErfBIG_P4 = 1.06777847e-1f;
+    static constexpr float ErfBIG_P5 = 6.34846687e-1f;
+    static constexpr float ErfBIG_P6_Minus_One = 1.28717512e-1f;
+
+    static constexpr float Exp_UpperRange = 88.0f;
+    static constexpr float Exp_LowerRange = -87.0f;
+    static constexpr float Exp_Log2Reciprocal = 1.44269504088896341f;
+    static constexpr float Exp_log2_hi = -6.93145752e-1f;
+    static constexpr float Exp_log2_lo = -1.42860677e-6f;
+    static constexpr float Exp_P0 = 1.38319808e-3f;
+    static constexpr float Exp_P1 = 8.37550033e-3f;
+    static constexpr float Exp_P2 = 4.16689515e-2f;
+    static constexpr float Exp_P3 = 1.66664466e-1f;
+    static constexpr float Exp_P4 = 4.99999851e-1f;
+    static constexpr float Exp_P5 = 1.00000000e+0f;
+    static constexpr float Exp_P6 = 1.00000000e+0f;
+    static constexpr float Exp_C = 1.25829120e+7f;
+
+    static constexpr float SquareRootHalf = 0.70710678118654752f;
+
+    //
+    // GELU(x) = 0.5 * x * (1 + tanh(u)) = x / (1 + exp(-2 * u)) with
+    // u = sqrt(2 / pi) * (x + 0.044715 * x^3).
+    //
+
+    static constexpr float GeluTanhNegTwoSqrt2OverPi = -1.59576912160573071f;
+    static constexpr float GeluTanhNegTwoSqrt2OverPiTimesCoeff = -0.07135481627159482f;
+};
+
+template<typename Ops>
+MLAS_FORCEINLINE
+typename Ops::FloatVector
+MlasBiasActivationExp(
+    typename Ops::FloatVector Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for each element of the
+    vector.
+
+Arguments:
+
+    Value - Supplies the input vector.
+
+Return Value:
+
+    Returns the exponential function of each element.
+
+--*/
+{
+    using C = MLAS_BIAS_ACTIVATION_CONSTANTS;
+
+    Value = Ops::Minimum(Ops::Broadcast(C::Exp_UpperRange), Value);
+    Value = Ops::Maximum(Ops::Broadcast(C::Exp_LowerRange), Value);
+
+    const auto ExpC = Ops::Broadcast(C::Exp_C);
+    auto r = Ops::MultiplyAdd(Ops::Broadcast(C::Exp_Log2Reciprocal), Value, ExpC);
+    r = Ops::Subtract(r, ExpC);
+
+    auto fx = Ops::MultiplyAdd(r, Ops::Broadcast(C::Exp_log2_hi), Value);
+    fx = Ops::MultiplyAdd(r, Ops::Broadcast(C::Exp_log2_lo), fx);
+
+    auto y = Ops::Broadcast(C::Exp_P0);
+    y = Ops::MultiplyAdd(y, fx, Ops::Broadcast(C::Exp_P1));
+    y = Ops::MultiplyAdd(y, fx, Ops::Broadcast(C::Exp_P2));
+    y = Ops::MultiplyAdd(y, fx, Ops::Broadcast(C::Exp_P3));
+    y = Ops::MultiplyAdd(y, fx, Ops::Broadcast(C::Exp_P4));
+    y = Ops::MultiplyAdd(y, fx, Ops::Broadcast(C::Exp_P5));
+    y = Ops::MultiplyAdd(y, fx, Ops::Broadcast(C::Exp_P6));
+
+    return Ops::Multiply(y, Ops::PowerOf2(r));
+}
+
+template<typename Ops>
+MLAS_FORCEINLINE
+typename Ops::FloatVector
+MlasBiasActivationErf(
+    typename Ops::FloatVector Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the error function for each element of the vector.
+
+Arguments:
+
+    Value - Supplies the input vector.
+
+Return Value:
+
+    Returns the error function of each element.
+
+--*/
+{
+    using C = MLAS_BIAS_ACTIVATION_CONSTANTS;
+
+    const auto NegZero = Ops::Broadcast(-0.0f);
+    const auto SignMask = Ops::And(Value, NegZero);
+    auto AbsValue = Ops::AndNot(NegZero, Value);
+    AbsValue = Ops::Minimum(Ops::Broadcast(C::ErfUpperAbsRange), AbsValue);
+    const auto SquareValue = Ops::Multiply(AbsValue, AbsValue);
+
+    auto r_small = Ops::Broadcast(C::ErfSMALL_P0);
+    r_small = Ops::MultiplyAdd(r_small, SquareValue, Ops::Broadcast(C::ErfSMALL_P1));
+    r_small = Ops::MultiplyAdd(r_small, SquareValue, Ops::Broadcast(C::ErfSMALL_P2));
+    r_small = Ops::MultiplyAdd(r_small, SquareValue, Ops::Broadcast(C::ErfSMALL_P3));
+    r_small = Ops::MultiplyAdd(r_small, SquareValue, Ops::Broadcast(C::ErfSMALL_P4));
+    r_small = Ops::MultiplyAdd(r_small, SquareValue, Ops::Broadcast(C::ErfSMALL_P5_Minus_One));
+    r_small = Ops::MultiplyAdd(r_small, AbsValue, AbsValue);
+    const auto SplitMask = Ops::GreaterThan(AbsValue, Ops::Broadcast(C::ErfSplitBoundary));
+    r_small = Ops::AndNot(SplitMask, r_small);
+
+    AbsValue = Ops::And(SplitMask, AbsValue);
+    auto r_big = Ops::Broadcast(C::ErfBIG_P0);
+    r_big = Ops::MultiplyAdd(r_big, AbsValue, Ops::Broadcast(C::ErfBIG_P1));
+    r_big = Ops::MultiplyAdd(r_big, AbsValue, Ops::Broadcast(C::ErfBIG_P2));
+    r_big = Ops::MultiplyAdd(r_big, AbsValue, Ops::Broadcast(C::ErfBIG_P3));
+    r_big = Ops::MultiplyAdd(r_big, AbsValue, Ops::Broadcast(C::ErfBIG_P4));
+    r_big = Ops::MultiplyAdd(r_big, AbsValue, Ops::Broadcast(C::ErfBIG_P5));
+    r_big = Ops::MultiplyAdd(r_big, AbsValue, Ops::Broadcast(C::ErfBIG_P6_Minus_One));
+    r_big = Ops::MultiplyAdd(r_big, AbsValue, AbsValue);
+
+    //
+    // 1.0 - exp(-r_big), where the input is bounded by the clamped absolute
+    // value so the exponential stays in range.
+    //
+
+    auto y = MlasBiasActivationExp<Ops>(Ops::Xor(r_big, NegZero));
+    y = Ops::Subtract(Ops::Broadcast(1.0f), y);
+    y = Ops::And(SplitMask, y);
+
+    y = Ops::Or(r_small, y);
+    return Ops::Or(y, SignMask);
+}
+
+template<typename Ops, MLAS_ACTIVATION_KIND ActivationKind>
+MLAS_FORCEINLINE
+typename Ops::FloatVector
+MlasBiasActivationCompute(
+    typename Ops::FloatVector Value,
+    typename Ops::FloatVector Alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the activation function to each element of the
+    vector.
+
+Arguments:
+
+    Value - Supplies the input vector.
+
+    Alpha - Supplies the broadcast Swish scale, unused by the GELU forms.
+
+Return Value:
+
+    Returns the activated vector.
+
+--*/
+{
+    using C = MLAS_BIAS_ACTIVATION_CONSTANTS;
+
+    if constexpr (ActivationKind == MlasGeluErfActivation) {
+
+        MLAS_UNREFERENCED_PARAMETER(Alpha);
+
+        const auto ErfValue = MlasBiasActivationErf<Ops>(
+            Ops::Multiply(Value, Ops::Broadcast(C::SquareRootHalf)));
+        const auto HalfValue = Ops::Multiply(Value, Ops::Broadcast(0.5f));
+
+        return Ops::MultiplyAdd(HalfValue, ErfValue, HalfValue);
+
+    } else {
+
+        typename Ops::FloatVector Exponent;
+
+        if constexpr (ActivationKind == MlasGeluTanhActivation) {
+
+            MLAS_UNREFERENCED_PARAMETER(Alpha);
+
+            const auto SquareValue = Ops::Multiply(Value, Value);
+            Exponent = Ops::MultiplyAdd(SquareValue,
+                Ops::Broadcast(C::GeluTanhNegTwoSqrt2OverPiTimesCoeff),
+                Ops::Broadcast(C::GeluTanhNegTwoSqrt2OverPi));
+            Exponent = Ops::Multiply(Exponent, Value);
+
+        } else {
+
+            static_assert(ActivationKind == MlasSwishActivation);
+
+            Exponent = Ops::Multiply(Value, Ops::Xor(Alpha, Ops::Broadcast(-0.0f)));
+        }
+
+        const auto Denominator = Ops::Add(Ops::Broadcast(1.0f),
+            MlasBiasActivationExp<Ops>(Exponent));
+
+        return Ops::Divide(Value, Denominator);
+    }
+}
+
+template<typename Ops, MLAS_ACTIVATION_KIND ActivationKind, bool AddBias>
+void
+MlasBiasActivationKernel(
+    const MLAS_ACTIVATION* Activation,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the optional bias vector to the input vector and
+    applies the activation function.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Input - Supplies the input vector.
+
+    Bias - Supplies the bias vector, used if AddBias is true.
+
+    Output - Supplies the output vector. The output may alias the input.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorLength = Ops::VectorLength;
+
+    const auto Alpha = Ops::Broadcast(
+        (ActivationKind == MlasSwishActivation) ? Activation->Parameters.Swish.alpha : 0.0f);
+
+    while (N >= VectorLength) {
+
+        auto Value = Ops::Load(Input);
+
+        if constexpr (AddBias) {
+            Value = Ops::Add(Value, Ops::Load(Bias));
+            Bias += VectorLength;
+        }
+
+        Ops::Store(Output, MlasBiasActivationCompute<Ops, ActivationKind>(Value, Alpha));
+
+        Input += VectorLength;
+        Output += VectorLength;
+        N -= VectorLength;
+    }
+
+    if (N > 0) {
+
+        //
+        // Process the remaining elements through a temporary vector so that
+        // the remainder uses the same approximation as the vector loop.
+        //
+
+        MLAS_DECLSPEC_ALIGN(float Buffer[VectorLength], 64);
+
+        for (size_t n = 0; n < VectorLength; n++) {
+            float Value = 0.0f;
+            if (n < N) {
+                Value = Input[n];
+                if constexpr (AddBias) {
+                    Value += Bias[n];
+                }
+            }
+            Buffer[n] = Value;
+        }
+
+        Ops::Store(Buffer, MlasBiasActivationCompute<Ops, ActivationKind>(Ops::Load(Buffer), Alpha));
+
+        std::copy_n(Buffer, N, Output);
+    }
+}
+
+template<typename Ops>
+void
+MlasBiasActivationDispatch(
+    const MLAS_ACTIVATION* Activation,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the kernel instantiation for the activation kind and
+    the presence of the bias vector.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation. The kind must be
+        one of MlasGeluErfActivation, MlasGeluTanhActivation or
+        MlasSwishActivation.
+
+    Input - Supplies the input vector.
+
+    Bias - Supplies the optional bias vector.
+
+    Output - Supplies the output vector.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Activation->ActivationKind) {
+
+        case MlasGeluErfActivation:
+        {
+            if (Bias != nullptr) {
+                MlasBiasActivationKernel<Ops, MlasGeluErfActivation, true>(Activation, Input, Bias, Output, N);
+            } else {
+                MlasBiasActivationKernel<Ops, MlasGeluErfActivation, false>(Activation, Input, Bias, Output, N);
+            }
+            break;
+        }
+
+        case MlasGeluTanhActivation:
+        {
+            if (Bias != nullptr) {
+                MlasBiasActivationKernel<Ops, MlasGeluTanhActivation, true>(Activation, Input, Bias, Output, N);
+            } else {
+                MlasBiasActivationKernel<Ops, MlasGeluTanhActivation, false>(Activation, Input, Bias, Output, N);
+            }
+            break;
+        }
+
+        case MlasSwishActivation:
+        {
+            if (Bias != nullptr) {
+                MlasBiasActivationKernel<Ops, MlasSwishActivation, true>(Activation, Input, Bias, Output, N);
+            } else {
+                MlasBiasActivationKernel<Ops, MlasSwishActivation, false>(Activation, Input, Bias, Output, N);
+            }
+            break;
+        }
+
+        default:
+        {
+            throw std::invalid_argument("Unsupported activation kind for bias activation kernel");
+        }
+    }
+}
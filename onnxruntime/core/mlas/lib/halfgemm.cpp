@@ -0,0 +1,832 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm.cpp
+
+Abstract:
+
+    This module implements the half precision matrix/matrix multiply operation
+    and the half precision conversion routines.
+
+    The matrices are stored as half precision values. Each worker converts
+    cache sized blocks of matrix A and matrix B to single precision and runs
+    the single precision kernels over the blocks, so the products are
+    accumulated in single precision. A prepacked matrix B uses the same
+    layout as MlasGemmPackB, so a block of the packed buffer converts to a
+    block that the kernels consume directly.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows of matrix A and the number of columns of matrix B
+// converted to single precision per block. The K dimension is blocked by
+// MLAS_SGEMM_PACKED_STRIDEK to match the layout of a packed matrix B.
+//
+
+#define MLAS_HALF_GEMM_STRIDEM                      64
+#define MLAS_HALF_GEMM_STRIDEN                      64
+
+MLAS_FORCEINLINE
+float
+MlasHalfToFloat(
+    MLAS_FP16 Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a half precision value to a single precision value.
+
+Arguments:
+
+    Value - Supplies the half precision value.
+
+Return Value:
+
+    Returns the single precision value.
+
+--*/
+{
+    const uint32_t ShiftedExponent = 0x7C00 << 13;
+    const float DenormalMagic = MlasFp32FromBits(113 << 23);
+
+    uint32_t Bits = (uint32_t(Value) & 0x7FFF) << 13;
+    const uint32_t Exponent = Bits & ShiftedExponent;
+
+    Bits += (127 - 15) << 23;
+
+    if (Exponent == ShiftedExponent) {
+
+        //
+        // Infinity or NaN.
+        //
+
+        Bits += (128 - 16) << 23;
+
+    } else if (Exponent == 0) {
+
+        //
+        // Zero or denormal: renormalize through a floating point subtract.
+        //
+
+        Bits += 1 << 23;
+        Bits = MlasBitsOfFp32(MlasFp32FromBits(Bits) - DenormalMagic);
+    }
+
+    return MlasFp32FromBits(Bits | ((uint32_t(Value) & 0x8000) << 16));
+}
+
+MLAS_FORCEINLINE
+MLAS_FP16
+MlasFloatToHalf(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision value to a half precision value
+    rounding to nearest even.
+
+Arguments:
+
+    Value - Supplies the single precision value.
+
+Return Value:
+
+    Returns the half precision value.
+
+--*/
+{
+    const uint32_t Infinity = 255 << 23;
+    const uint32_t HalfOverflow = (127 + 16) << 23;
+    const float DenormalMagic = MlasFp32FromBits(((127 - 15) + (23 - 10) + 1) << 23);
+
+    uint32_t Bits = MlasBitsOfFp32(Value);
+    const uint32_t Sign = Bits & 0x80000000;
+    Bits ^= Sign;
+
+    uint32_t Result;
+
+    if (Bits >= HalfOverflow) {
+
+        //
+        // Overflow to infinity, or propagate a quiet NaN.
+        //
+
+        Result = (Bits > Infinity) ? 0x7E00 : 0x7C00;
+
+    } else if (Bits < (113 << 23)) {
+
+        //
+        // The result is a half precision denormal or zero: let the floating
+        // point add perform the rounding.
+        //
+
+        Result = MlasBitsOfFp32(MlasFp32FromBits(Bits) + DenormalMagic) - MlasBitsOfFp32(DenormalMagic);
+
+    } else {
+
+        const uint32_t MantissaOdd = (Bits >> 13) & 1;
+
+        Bits -= (127 - 15) << 23;
+        Bits += 0xFFF + MantissaOdd;
+
+        Result = Bits >> 13;
+    }
+
+    return MLAS_FP16(Result | (Sign >> 16));
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernel(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision values to single
+    precision values.
+
+Arguments:
+
+    Source - Supplies the half precision values.
+
+    Destination - Supplies the single precision values.
+
+    Count - Supplies the number of values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS) && !defined(_MSC_VER)
+
+    while (Count >= 4) {
+        float16x4_t HalfVector = vreinterpret_f16_u16(vld1_u16(Source));
+        vst1q_f32(Destination, vcvt_f32_f16(HalfVector));
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+#endif
+
+    for (size_t n = 0; n < Count; n++) {
+        Destination[n] = MlasHalfToFloat(Source[n]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernel(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to half
+    precision values.
+
+Arguments:
+
+    Source - Supplies the single precision values.
+
+    Destination - Supplies the half precision values.
+
+    Count - Supplies the number of values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS) && !defined(_MSC_VER)
+
+    while (Count >= 4) {
+        float16x4_t HalfVector = vcvt_f16_f32(vld1q_f32(Source));
+        vst1_u16(Destination, vreinterpret_u16_f16(HalfVector));
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+#endif
+
+    for (size_t n = 0; n < Count; n++) {
+        Destination[n] = MlasFloatToHalf(Source[n]);
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertToFloat(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().ConvertHalfToFloatKernel(Source, Destination, Count);
+#else
+    MlasConvertHalfToFloatKernel(Source, Destination, Count);
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertToHalf(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().ConvertFloatToHalfKernel(Source, Destination, Count);
+#else
+    MlasConvertFloatToHalfKernel(Source, Destination, Count);
+#endif
+}
+
+//
+// The Windows x64 build implements this routine in assembly.
+//
+
+#if !(defined(_WIN32) && defined(MLAS_TARGET_AMD64))
+
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision values to single
+    precision values.
+
+Arguments:
+
+    Source - Supplies the half precision values.
+
+    Destination - Supplies the single precision values.
+
+    Count - Supplies the number of values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasHalfGemmConvertToFloat(Source, Destination, Count);
+}
+
+#endif
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to half
+    precision values, rounding to nearest even.
+
+Arguments:
+
+    Source - Supplies the single precision values.
+
+    Destination - Supplies the half precision values.
+
+    Count - Supplies the number of values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasHalfGemmConvertToHalf(Source, Destination, Count);
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelLoop(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine steps through the rows of the converted blocks calling the
+    single precision kernel until all rows have been processed.
+
+Arguments:
+
+    A - Supplies the address of the converted block of matrix A.
+
+    B - Supplies the address of the converted block of matrix B. The block is
+        in the layout produced by MlasGemmPackB.
+
+    C - Supplies the address of the single precision output block.
+
+    CountK - Supplies the number of columns of the A block and rows of the B
+        block.
+
+    CountM - Supplies the number of rows of the A block and the output block.
+
+    CountN - Supplies the number of columns of the B block and the output
+        block.
+
+    lda - Supplies the first dimension of the A block.
+
+    ldc - Supplies the first dimension of the output block.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    ZeroMode - Supplies true if the output block must be zero initialized,
+        else false if the output block is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountM > 0) {
+
+        size_t RowsHandled;
+
+#if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_POWER)
+        RowsHandled = GetMlasPlatform().GemmFloatKernel(A, B, C, CountK, CountM, CountN, lda, ldc, alpha, ZeroMode);
+#else
+        if (ZeroMode) {
+            RowsHandled = MlasSgemmKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        } else {
+            RowsHandled = MlasSgemmKernelAdd(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        }
+#endif
+
+        C += ldc * RowsHandled;
+        A += lda * RowsHandled;
+        CountM -= RowsHandled;
+    }
+}
+
+void
+MlasHalfGemmOperation(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    size_t AlignedN,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    const MLAS_FP16* A,
+    MLAS_FP16* C
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the half precision matrix/matrix multiply
+    operation for a range of columns of the output matrix.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for an unpacked matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column of matrix B and matrix C.
+
+    RangeCountN - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    AlignedN - Supplies the aligned number of columns of a packed matrix B.
+
+    Data - Supplies the matrices data parameters.
+
+    A - Supplies the address of the first row of matrix A.
+
+    C - Supplies the address of the first row and column of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelA[MLAS_HALF_GEMM_STRIDEM * MLAS_SGEMM_PACKED_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_HALF_GEMM_STRIDEN * MLAS_SGEMM_PACKED_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelC[MLAS_HALF_GEMM_STRIDEM * MLAS_HALF_GEMM_STRIDEN], 64);
+    float RowC[MLAS_HALF_GEMM_STRIDEN];
+
+    const size_t lda = Data->lda;
+    const size_t ldb = Data->ldb;
+    const size_t ldc = Data->ldc;
+    const float alpha = Data->alpha;
+    const float beta = Data->beta;
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        const size_t SliceStartN = RangeStartN + n;
+
+        CountN = std::min(RangeCountN - n, size_t(MLAS_HALF_GEMM_STRIDEN));
+
+        //
+        // Step through each slice of matrix A along the M dimension.
+        //
+
+        size_t CountM;
+
+        for (size_t m = 0; m < M; m += CountM) {
+
+            CountM = std::min(M - m, size_t(MLAS_HALF_GEMM_STRIDEM));
+
+            //
+            // Step through each slice of matrix B along the K dimension,
+            // accumulating the products into the single precision block.
+            //
+
+            size_t CountK;
+
+            for (size_t k = 0; k < K; k += CountK) {
+
+                CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
+
+                for (size_t r = 0; r < CountM; r++) {
+                    MlasHalfGemmConvertToFloat(A + (m + r) * lda + k, PanelA + r * CountK, CountK);
+                }
+
+                if (Data->BIsPacked) {
+
+                    //
+                    // The packed buffer stores the columns of each K slice in
+                    // contiguous blocks of MLAS_SGEMM_STRIDEN_THREAD_ALIGN
+                    // columns, so the block converts as a single run.
+                    //
+
+                    const size_t AlignedCountN = (CountN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) &
+                        ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+                    const MLAS_FP16* pb = (const MLAS_FP16*)Data->B + AlignedN * k + CountK * SliceStartN;
+
+                    MlasHalfGemmConvertToFloat(pb, PanelB, CountK * AlignedCountN);
+
+                    MlasHalfGemmKernelLoop(PanelA, PanelB, PanelC, CountK, CountM, CountN,
+                        CountK, CountN, alpha, k == 0);
+
+                } else {
+
+                    const MLAS_FP16* B = (const MLAS_FP16*)Data->B;
+
+                    if (TransB == CblasNoTrans) {
+                        for (size_t kk = 0; kk < CountK; kk++) {
+                            MlasHalfGemmConvertToFloat(B + (k + kk) * ldb + SliceStartN,
+                                PanelB + kk * CountN, CountN);
+                        }
+                    } else {
+                        for (size_t nn = 0; nn < CountN; nn++) {
+                            MlasHalfGemmConvertToFloat(B + (SliceStartN + nn) * ldb + k,
+                                PanelB + nn * CountK, CountK);
+                        }
+                    }
+
+                    MlasSgemmOperation(CblasNoTrans, TransB, CountM, CountN, CountK, alpha,
+                        PanelA, CountK, PanelB, (TransB == CblasNoTrans) ? CountN : CountK,
+                        (k == 0) ? 0.0f : 1.0f, PanelC, CountN);
+                }
+            }
+
+            //
+            // Handle an empty inner dimension.
+            //
+
+            if (K == 0) {
+                std::fill_n(PanelC, CountM * CountN, 0.0f);
+            }
+
+            //
+            // Apply beta and store the block to the output matrix.
+            //
+
+            for (size_t r = 0; r < CountM; r++) {
+
+                float* pc = PanelC + r * CountN;
+                MLAS_FP16* c = C + (m + r) * ldc + n;
+
+                if (beta != 0.0f) {
+
+                    MlasHalfGemmConvertToFloat(c, RowC, CountN);
+
+                    for (size_t nn = 0; nn < CountN; nn++) {
+                        pc[nn] += beta * RowC[nn];
+                    }
+                }
+
+                MlasHalfGemmConvertToHalf(pc, c, CountN);
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasHalfGemmBatch(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the batched half precision matrix/matrix multiply
+    operation.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B. Ignored if matrix
+        B is pre-packed.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    Data - Supplies an array of matrices data parameters.
+
+    BatchSize - Supplies the number of multiplications in this batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads. The N dimension is
+    // partitioned in units of MLAS_SGEMM_STRIDEN_THREAD_ALIGN columns so
+    // that each thread starts on a block of a packed matrix B.
+    //
+
+    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    const size_t AlignedN = BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+
+    if (N > M) {
+
+        if (size_t(ThreadsPerGemm) > BlockedN) {
+            ThreadsPerGemm = ptrdiff_t(BlockedN);
+        }
+
+        ThreadCountM = 1;
+        ThreadCountN = ThreadsPerGemm;
+
+    } else {
+
+        if (size_t(ThreadsPerGemm) > M) {
+            ThreadsPerGemm = ptrdiff_t(M);
+        }
+
+        ThreadCountM = ThreadsPerGemm;
+        ThreadCountN = 1;
+    }
+
+    MlasTrySimpleParallel(ThreadPool,
+        ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
+        [=](ptrdiff_t tid)
+    {
+        const MLAS_HALF_GEMM_DATA_PARAMS* DataParams = &Data[tid / ThreadsPerGemm];
+        const ptrdiff_t ThreadId = tid % ThreadsPerGemm;
+        const ptrdiff_t ThreadIdM = ThreadId / ThreadCountN;
+        const ptrdiff_t ThreadIdN = ThreadId % ThreadCountN;
+
+        size_t RangeStartM;
+        size_t RangeCountM;
+
+        MlasPartitionWork(ThreadIdM, ThreadCountM, M, &RangeStartM, &RangeCountM);
+
+        size_t RangeStartN;
+        size_t RangeCountN;
+
+        MlasPartitionWork(ThreadIdN, ThreadCountN, BlockedN, &RangeStartN, &RangeCountN);
+
+        RangeStartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+        RangeCountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+        MlasHalfGemmOperation(TransB, RangeCountM, RangeStartN, RangeCountN, K, AlignedN,
+            DataParams, DataParams->A + RangeStartM * DataParams->lda,
+            DataParams->C + RangeStartM * DataParams->ldc + RangeStartN);
+    });
+}
+
+size_t
+MLASCALL
+MlasHalfGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed half precision
+    matrix B buffer.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes for the packed matrix B buffer.
+
+--*/
+{
+    const size_t AlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    const size_t BytesRequired = AlignedN * K * sizeof(MLAS_FP16);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired = (BytesRequired + BufferAlignment - 1) &
+        ~(BufferAlignment - 1);
+
+    return AlignedBytesRequired;
+}
+
+void
+MLASCALL
+MlasHalfGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const MLAS_FP16* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the contents of half precision matrix B to the
+    destination buffer. The destination buffer should be sized based on
+    MlasHalfGemmPackBSize().
+
+    The packed buffer has the layout of MlasGemmPackB with the values stored
+    in half precision. Each K slice is packed a block of columns at a time
+    through a single precision buffer.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN_THREAD_ALIGN * MLAS_SGEMM_PACKED_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(float PackedPanelB[MLAS_SGEMM_STRIDEN_THREAD_ALIGN * MLAS_SGEMM_PACKED_STRIDEK], 64);
+
+    const size_t AlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
+
+        MLAS_FP16* pd = (MLAS_FP16*)PackedB + AlignedN * k;
+
+        //
+        // Step through each block of columns of the slice. Each block packs
+        // to CountK * MLAS_SGEMM_STRIDEN_THREAD_ALIGN values.
+        //
+
+        size_t CountN;
+
+        for (size_t n = 0; n < N; n += CountN) {
+
+            CountN = std::min(N - n, size_t(MLAS_SGEMM_STRIDEN_THREAD_ALIGN));
+
+            if (TransB == CblasNoTrans) {
+                for (size_t kk = 0; kk < CountK; kk++) {
+                    MlasHalfGemmConvertToFloat(B + (k + kk) * ldb + n, PanelB + kk * CountN, CountN);
+                }
+            } else {
+                for (size_t nn = 0; nn < CountN; nn++) {
+                    MlasHalfGemmConvertToFloat(B + (n + nn) * ldb + k, PanelB + nn * CountK, CountK);
+                }
+            }
+
+            MlasGemmPackB(TransB, CountN, CountK, PanelB,
+                (TransB == CblasNoTrans) ? CountN : CountK, PackedPanelB);
+
+            MlasHalfGemmConvertToHalf(PackedPanelB, pd + CountK * n,
+                CountK * MLAS_SGEMM_STRIDEN_THREAD_ALIGN);
+        }
+    }
+}
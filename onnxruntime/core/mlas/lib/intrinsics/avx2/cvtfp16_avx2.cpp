@@ -0,0 +1,120 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvtfp16_avx2.cpp
+
+Abstract:
+
+    This module implements the kernels to convert between half precision and
+    single precision values using the F16C instructions.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernelF16C(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision values to single
+    precision values.
+
+Arguments:
+
+    Source - Supplies the half precision values.
+
+    Destination - Supplies the single precision values.
+
+    Count - Supplies the number of values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 16) {
+        __m128i HalfVector0 = _mm_loadu_si128((const __m128i*)Source);
+        __m128i HalfVector1 = _mm_loadu_si128((const __m128i*)(Source + 8));
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(HalfVector0));
+        _mm256_storeu_ps(Destination + 8, _mm256_cvtph_ps(HalfVector1));
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count >= 8) {
+        __m128i HalfVector = _mm_loadu_si128((const __m128i*)Source);
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(HalfVector));
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+        MlasConvertHalfToFloatKernel(Source, Destination, Count);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernelF16C(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to half
+    precision values, rounding to nearest even.
+
+Arguments:
+
+    Source - Supplies the single precision values.
+
+    Destination - Supplies the half precision values.
+
+    Count - Supplies the number of values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 16) {
+        __m128i HalfVector0 = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        __m128i HalfVector1 = _mm256_cvtps_ph(_mm256_loadu_ps(Source + 8), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)Destination, HalfVector0);
+        _mm_storeu_si128((__m128i*)(Destination + 8), HalfVector1);
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count >= 8) {
+        __m128i HalfVector = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)Destination, HalfVector);
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+        MlasConvertFloatToHalfKernel(Source, Destination, Count);
+    }
+}
@@ -0,0 +1,103 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gelu_avx2.cpp
+
+Abstract:
+
+    This module implements routines to add a bias vector and apply the GELU
+    (erf and tanh forms) or Swish activation in a single pass using AVX2 and
+    FMA3 intrinsics.
+
+--*/
+
+#include "../../gelu.h"
+
+//
+// Vector operations for the shared kernel templates.
+//
+
+struct MLAS_BIAS_ACTIVATION_OPS_AVX2 {
+
+    typedef __m256 FloatVector;
+
+    static constexpr size_t VectorLength = 8;
+
+    static FloatVector Broadcast(float Value) { return _mm256_set1_ps(Value); }
+
+    static FloatVector Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+
+    static void Store(float* Buffer, FloatVector Vector) { _mm256_storeu_ps(Buffer, Vector); }
+
+    static FloatVector Add(FloatVector v1, FloatVector v2) { return _mm256_add_ps(v1, v2); }
+
+    static FloatVector Subtract(FloatVector v1, FloatVector v2) { return _mm256_sub_ps(v1, v2); }
+
+    static FloatVector Multiply(FloatVector v1, FloatVector v2) { return _mm256_mul_ps(v1, v2); }
+
+    static FloatVector MultiplyAdd(FloatVector v1, FloatVector v2, FloatVector v3) { return _mm256_fmadd_ps(v1, v2, v3); }
+
+    static FloatVector Divide(FloatVector v1, FloatVector v2) { return _mm256_div_ps(v1, v2); }
+
+    static FloatVector Minimum(FloatVector v1, FloatVector v2) { return _mm256_min_ps(v1, v2); }
+
+    static FloatVector Maximum(FloatVector v1, FloatVector v2) { return _mm256_max_ps(v1, v2); }
+
+    static FloatVector And(FloatVector v1, FloatVector v2) { return _mm256_and_ps(v1, v2); }
+
+    static FloatVector AndNot(FloatVector v1, FloatVector v2) { return _mm256_andnot_ps(v1, v2); }
+
+    static FloatVector Or(FloatVector v1, FloatVector v2) { return _mm256_or_ps(v1, v2); }
+
+    static FloatVector Xor(FloatVector v1, FloatVector v2) { return _mm256_xor_ps(v1, v2); }
+
+    static FloatVector GreaterThan(FloatVector v1, FloatVector v2) { return _mm256_cmp_ps(v1, v2, _CMP_GT_OQ); }
+
+    static FloatVector PowerOf2(FloatVector Vector)
+    {
+        __m256i emm0 = _mm256_add_epi32(_mm256_cvtps_epi32(Vector), _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(emm0, 23));
+    }
+};
+
+void
+MLASCALL
+MlasBiasActivationF32KernelAvx2(
+    const MLAS_ACTIVATION* Activation,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the optional bias vector to the input vector and
+    applies the GELU or Swish activation.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Input - Supplies the input vector.
+
+    Bias - Supplies the optional bias vector.
+
+    Output - Supplies the output vector. The output may alias the input.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasBiasActivationDispatch<MLAS_BIAS_ACTIVATION_OPS_AVX2>(Activation, Input, Bias, Output, N);
+}
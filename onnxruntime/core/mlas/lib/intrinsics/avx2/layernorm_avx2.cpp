@@ -0,0 +1,226 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel to normalize a single row for layer
+    normalization using AVX2 and FMA3 intrinsics.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddFloat32x8(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_movehdup_ps(Vector128));
+    return _mm_cvtss_f32(Vector128);
+}
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx2(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* MeanValue,
+    float* InvStdDevValue
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes a single row using AVX2 and FMA3 instructions.
+
+    Refer to MlasLayerNormF32Kernel for the argument descriptions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool HasResidual = (Skip != nullptr || SkipBias != nullptr);
+    const float* Source = HasResidual ? Output : Input;
+    float Mean = 0.0f;
+
+    //
+    // Pass 1: add the residual terms and accumulate the row sum.
+    //
+
+    if (!Simplified || HasResidual) {
+
+        const float* input = Input;
+        const float* skip = Skip;
+        const float* skip_bias = SkipBias;
+        float* output = Output;
+        size_t n = N;
+
+        __m256 SumVector0 = _mm256_setzero_ps();
+        __m256 SumVector1 = _mm256_setzero_ps();
+
+        while (n >= 16) {
+
+            __m256 Vector0 = _mm256_loadu_ps(input);
+            __m256 Vector1 = _mm256_loadu_ps(input + 8);
+
+            if (skip != nullptr) {
+                Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(skip));
+                Vector1 = _mm256_add_ps(Vector1, _mm256_loadu_ps(skip + 8));
+                skip += 16;
+            }
+
+            if (skip_bias != nullptr) {
+                Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(skip_bias));
+                Vector1 = _mm256_add_ps(Vector1, _mm256_loadu_ps(skip_bias + 8));
+                skip_bias += 16;
+            }
+
+            if (HasResidual) {
+                _mm256_storeu_ps(output, Vector0);
+                _mm256_storeu_ps(output + 8, Vector1);
+            }
+
+            SumVector0 = _mm256_add_ps(SumVector0, Vector0);
+            SumVector1 = _mm256_add_ps(SumVector1, Vector1);
+
+            input += 16;
+            output += 16;
+            n -= 16;
+        }
+
+        float Sum = MlasReduceAddFloat32x8(_mm256_add_ps(SumVector0, SumVector1));
+
+        while (n > 0) {
+
+            float Value = *input++;
+
+            if (skip != nullptr) {
+                Value += *skip++;
+            }
+
+            if (skip_bias != nullptr) {
+                Value += *skip_bias++;
+            }
+
+            if (HasResidual) {
+                *output = Value;
+            }
+
+            Sum += Value;
+
+            output++;
+            n -= 1;
+        }
+
+        if (!Simplified) {
+            Mean = Sum / float(N);
+        }
+    }
+
+    //
+    // Pass 2: accumulate the squared deviations from the mean while the row
+    // is resident in the cache.
+    //
+
+    __m256 MeanVector = _mm256_set1_ps(Mean);
+    float InvStdDev;
+
+    {
+        const float* source = Source;
+        size_t n = N;
+
+        __m256 SumVector0 = _mm256_setzero_ps();
+        __m256 SumVector1 = _mm256_setzero_ps();
+
+        while (n >= 16) {
+
+            __m256 Vector0 = _mm256_sub_ps(_mm256_loadu_ps(source), MeanVector);
+            __m256 Vector1 = _mm256_sub_ps(_mm256_loadu_ps(source + 8), MeanVector);
+
+            SumVector0 = _mm256_fmadd_ps(Vector0, Vector0, SumVector0);
+            SumVector1 = _mm256_fmadd_ps(Vector1, Vector1, SumVector1);
+
+            source += 16;
+            n -= 16;
+        }
+
+        float Sum = MlasReduceAddFloat32x8(_mm256_add_ps(SumVector0, SumVector1));
+
+        while (n > 0) {
+
+            float Value = *source++ - Mean;
+
+            Sum += Value * Value;
+
+            n -= 1;
+        }
+
+        InvStdDev = 1.0f / std::sqrt(Sum / float(N) + Epsilon);
+    }
+
+    //
+    // Pass 3: normalize the row and apply the scale and bias.
+    //
+
+    {
+        __m256 InvStdDevVector = _mm256_set1_ps(InvStdDev);
+        const float* source = Source;
+        float* output = Output;
+        size_t n = N;
+
+        while (n >= 8) {
+
+            __m256 Vector = _mm256_sub_ps(_mm256_loadu_ps(source), MeanVector);
+            __m256 ScaleVector = _mm256_mul_ps(_mm256_loadu_ps(Scale), InvStdDevVector);
+
+            if (Bias != nullptr) {
+                Vector = _mm256_fmadd_ps(Vector, ScaleVector, _mm256_loadu_ps(Bias));
+                Bias += 8;
+            } else {
+                Vector = _mm256_mul_ps(Vector, ScaleVector);
+            }
+
+            _mm256_storeu_ps(output, Vector);
+
+            source += 8;
+            Scale += 8;
+            output += 8;
+            n -= 8;
+        }
+
+        while (n > 0) {
+
+            float Value = (*source++ - Mean) * (*Scale++ * InvStdDev);
+
+            if (Bias != nullptr) {
+                Value += *Bias++;
+            }
+
+            *output++ = Value;
+
+            n -= 1;
+        }
+    }
+
+    *MeanValue = Mean;
+    *InvStdDevValue = InvStdDev;
+}
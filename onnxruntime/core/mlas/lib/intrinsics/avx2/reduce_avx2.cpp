@@ -0,0 +1,217 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce_avx2.cpp
+
+Abstract:
+
+    This module implements routines to reduce the rows or the columns of
+    single precision matrices to their sum, maximum or minimum, or to the
+    index of their maximum or minimum, using AVX2 intrinsics.
+
+--*/
+
+#include "../../reduce.h"
+
+//
+// Vector operations for the shared kernel templates.
+//
+
+struct MLAS_REDUCE_OPS_AVX2 {
+
+    typedef __m256 FloatVector;
+
+    static constexpr size_t VectorLength = 8;
+
+    static FloatVector Broadcast(float Value) { return _mm256_set1_ps(Value); }
+
+    static FloatVector Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+
+    static void Store(float* Buffer, FloatVector Vector) { _mm256_storeu_ps(Buffer, Vector); }
+
+    static FloatVector Add(FloatVector v1, FloatVector v2) { return _mm256_add_ps(v1, v2); }
+
+    static FloatVector Minimum(FloatVector v1, FloatVector v2) { return _mm256_min_ps(v1, v2); }
+
+    static FloatVector Maximum(FloatVector v1, FloatVector v2) { return _mm256_max_ps(v1, v2); }
+
+    static FloatVector GreaterThan(FloatVector v1, FloatVector v2) { return _mm256_cmp_ps(v1, v2, _CMP_GT_OQ); }
+
+    static FloatVector GreaterThanOrEqual(FloatVector v1, FloatVector v2) { return _mm256_cmp_ps(v1, v2, _CMP_GE_OQ); }
+
+    static FloatVector Blend(FloatVector v1, FloatVector v2, FloatVector Mask) { return _mm256_blendv_ps(v1, v2, Mask); }
+};
+
+float
+MLASCALL
+MlasReduceRowF32KernelAvx2(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t N,
+    float Initial
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a vector and combines the result with an initial
+    value.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process.
+
+    Initial - Supplies the value to combine with the elements.
+
+Return Value:
+
+    Returns the reduced value.
+
+--*/
+{
+    return MlasReduceRowDispatch<MLAS_REDUCE_OPS_AVX2>(ReduceKind, Input, N, Initial);
+}
+
+void
+MLASCALL
+MlasReduceColumnsF32KernelAvx2(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    bool Accumulate
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the columns of a matrix along the rows.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input matrix.
+
+    Output - Supplies the output vector of Columns elements.
+
+    Rows - Supplies the number of rows to reduce, which must be nonzero.
+
+    Columns - Supplies the number of columns to reduce.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    Accumulate - Supplies true to combine the reduced rows with the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasReduceColumnsDispatch<MLAS_REDUCE_OPS_AVX2>(ReduceKind, Input, Output, Rows, Columns, ldInput, Accumulate);
+}
+
+ptrdiff_t
+MLASCALL
+MlasArgReduceRowF32KernelAvx2(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    size_t N,
+    float* Value
+    )
+/*++
+
+Routine Description:
+
+    This routine finds the index of the maximum or minimum element of a
+    vector, continuing a search that found the supplied value so far.
+
+Arguments:
+
+    ReduceKind - Supplies MlasReduceMaximum or MlasReduceMinimum.
+
+    SelectLastIndex - Supplies true to select the last index of ties.
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process, which must be less than
+        2^24.
+
+    Value - Supplies the best value found so far, and receives the best value
+        found including the input vector.
+
+Return Value:
+
+    Returns the index of the selected element of the input vector, or -1 if
+    no element of the input vector replaces the supplied value.
+
+--*/
+{
+    return MlasArgReduceRowDispatch<MLAS_REDUCE_OPS_AVX2>(ReduceKind, SelectLastIndex, Input, N, Value);
+}
+
+void
+MLASCALL
+MlasArgReduceColumnsF32KernelAvx2(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    float* Values,
+    int64_t* Indices,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    int64_t RowBase
+    )
+/*++
+
+Routine Description:
+
+    This routine continues the search for the index of the maximum or
+    minimum element of the columns of a matrix.
+
+Arguments:
+
+    ReduceKind - Supplies MlasReduceMaximum or MlasReduceMinimum.
+
+    SelectLastIndex - Supplies true to select the last index of ties.
+
+    Input - Supplies the input matrix.
+
+    Values - Supplies the best values found so far, and receives the best
+        values found including the input rows.
+
+    Indices - Receives the row index of the best value for each column that
+        selects an element of the input rows.
+
+    Rows - Supplies the number of rows to process, which must be less than
+        2^24.
+
+    Columns - Supplies the number of columns to process.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    RowBase - Supplies the row index of the first input row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasArgReduceColumnsDispatch<MLAS_REDUCE_OPS_AVX2>(ReduceKind, SelectLastIndex, Input, Values, Indices,
+        Rows, Columns, ldInput, RowBase);
+}
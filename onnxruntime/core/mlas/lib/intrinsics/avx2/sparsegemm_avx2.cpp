@@ -0,0 +1,366 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision matrix/matrix
+    multiply operation with a sparse matrix B using AVX2 and FMA3 intrinsics.
+
+    The kernel accumulates each column of matrix C in vectors of rows, so the
+    columns are collected in groups of 8 and transposed in registers to store
+    whole vectors to the rows of matrix C.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of columns of matrix C transposed and stored together.
+//
+
+#define MLAS_SGEMM_SPARSE_COLUMN_GROUP              8
+
+template<size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSparseMultiplyAdd(
+    const float* a,
+    __m256 ValueB,
+    __m256& Accumulator0,
+    __m256& Accumulator1
+    )
+{
+    Accumulator0 = _mm256_fmadd_ps(_mm256_load_ps(a), ValueB, Accumulator0);
+
+    if constexpr (VectorCount == 2) {
+        Accumulator1 = _mm256_fmadd_ps(_mm256_load_ps(a + 8), ValueB, Accumulator1);
+    }
+}
+
+template<size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSparseStoreColumn(
+    float* Tile,
+    __m256 AlphaBroadcast,
+    __m256 Accumulator0,
+    __m256 Accumulator1
+    )
+{
+    _mm256_store_ps(Tile, _mm256_mul_ps(Accumulator0, AlphaBroadcast));
+
+    if constexpr (VectorCount == 2) {
+        _mm256_store_ps(Tile + 8, _mm256_mul_ps(Accumulator1, AlphaBroadcast));
+    }
+}
+
+template<size_t BlkN, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSparseComputePanel(
+    const float* PanelA,
+    size_t FirstBlock,
+    size_t LastBlock,
+    const uint16_t* BlockRowIndex,
+    const float* BlockValues,
+    __m256 AlphaBroadcast,
+    float* Tile
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a transposed tile of matrix A by the group of
+    blocks of a panel and stores the BlkN columns of the result to a tile of
+    columns of MLAS_SGEMM_SPARSE_STRIDEM values.
+
+    A panel of single columns accumulates 4 blocks at a time into independent
+    accumulators, so that the group is not bound by the latency of a single
+    chain of multiply/add instructions.
+
+Arguments:
+
+    PanelA - Supplies the address of the transposed tile of matrix A.
+
+    FirstBlock - Supplies the index of the first block of the group.
+
+    LastBlock - Supplies the index past the last block of the group.
+
+    BlockRowIndex - Supplies the row index of each block.
+
+    BlockValues - Supplies the BlkN values of each block.
+
+    AlphaBroadcast - Supplies the scalar multiplier broadcast to a vector.
+
+    Tile - Supplies the address of the first column of the output tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    __m256 Accumulator00 = _mm256_setzero_ps();
+    __m256 Accumulator01 = _mm256_setzero_ps();
+    __m256 Accumulator10 = _mm256_setzero_ps();
+    __m256 Accumulator11 = _mm256_setzero_ps();
+    __m256 Accumulator20 = _mm256_setzero_ps();
+    __m256 Accumulator21 = _mm256_setzero_ps();
+    __m256 Accumulator30 = _mm256_setzero_ps();
+    __m256 Accumulator31 = _mm256_setzero_ps();
+
+    size_t i = FirstBlock;
+
+    if constexpr (BlkN == 4) {
+
+        for (; i < LastBlock; i++) {
+
+            const float* a = PanelA + size_t(BlockRowIndex[i]) * MLAS_SGEMM_SPARSE_STRIDEM;
+            const float* b = BlockValues + i * 4;
+
+            MlasSgemmSparseMultiplyAdd<VectorCount>(a, _mm256_broadcast_ss(b + 0), Accumulator00, Accumulator01);
+            MlasSgemmSparseMultiplyAdd<VectorCount>(a, _mm256_broadcast_ss(b + 1), Accumulator10, Accumulator11);
+            MlasSgemmSparseMultiplyAdd<VectorCount>(a, _mm256_broadcast_ss(b + 2), Accumulator20, Accumulator21);
+            MlasSgemmSparseMultiplyAdd<VectorCount>(a, _mm256_broadcast_ss(b + 3), Accumulator30, Accumulator31);
+        }
+
+    } else {
+
+        for (; i + 4 <= LastBlock; i += 4) {
+
+            MlasSgemmSparseMultiplyAdd<VectorCount>(PanelA + size_t(BlockRowIndex[i + 0]) * MLAS_SGEMM_SPARSE_STRIDEM,
+                _mm256_broadcast_ss(BlockValues + i + 0), Accumulator00, Accumulator01);
+            MlasSgemmSparseMultiplyAdd<VectorCount>(PanelA + size_t(BlockRowIndex[i + 1]) * MLAS_SGEMM_SPARSE_STRIDEM,
+                _mm256_broadcast_ss(BlockValues + i + 1), Accumulator10, Accumulator11);
+            MlasSgemmSparseMultiplyAdd<VectorCount>(PanelA + size_t(BlockRowIndex[i + 2]) * MLAS_SGEMM_SPARSE_STRIDEM,
+                _mm256_broadcast_ss(BlockValues + i + 2), Accumulator20, Accumulator21);
+            MlasSgemmSparseMultiplyAdd<VectorCount>(PanelA + size_t(BlockRowIndex[i + 3]) * MLAS_SGEMM_SPARSE_STRIDEM,
+                _mm256_broadcast_ss(BlockValues + i + 3), Accumulator30, Accumulator31);
+        }
+
+        for (; i < LastBlock; i++) {
+            MlasSgemmSparseMultiplyAdd<VectorCount>(PanelA + size_t(BlockRowIndex[i]) * MLAS_SGEMM_SPARSE_STRIDEM,
+                _mm256_broadcast_ss(BlockValues + i), Accumulator00, Accumulator01);
+        }
+
+        Accumulator00 = _mm256_add_ps(_mm256_add_ps(Accumulator00, Accumulator10), _mm256_add_ps(Accumulator20, Accumulator30));
+        Accumulator01 = _mm256_add_ps(_mm256_add_ps(Accumulator01, Accumulator11), _mm256_add_ps(Accumulator21, Accumulator31));
+    }
+
+    MlasSgemmSparseStoreColumn<VectorCount>(Tile, AlphaBroadcast, Accumulator00, Accumulator01);
+
+    if constexpr (BlkN == 4) {
+        MlasSgemmSparseStoreColumn<VectorCount>(Tile + 1 * MLAS_SGEMM_SPARSE_STRIDEM, AlphaBroadcast, Accumulator10, Accumulator11);
+        MlasSgemmSparseStoreColumn<VectorCount>(Tile + 2 * MLAS_SGEMM_SPARSE_STRIDEM, AlphaBroadcast, Accumulator20, Accumulator21);
+        MlasSgemmSparseStoreColumn<VectorCount>(Tile + 3 * MLAS_SGEMM_SPARSE_STRIDEM, AlphaBroadcast, Accumulator30, Accumulator31);
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasSgemmSparseTranspose8x8(
+    __m256 Rows[8]
+    )
+{
+    const __m256 t0 = _mm256_unpacklo_ps(Rows[0], Rows[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(Rows[0], Rows[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(Rows[2], Rows[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(Rows[2], Rows[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(Rows[4], Rows[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(Rows[4], Rows[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(Rows[6], Rows[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(Rows[6], Rows[7]);
+
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    Rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    Rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    Rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    Rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    Rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    Rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    Rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    Rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+template<size_t BlkN, size_t VectorCount>
+void
+MlasSgemmSparseKernelAvx2Impl(
+    const float* PanelA,
+    size_t CountM,
+    const size_t* GroupOffsets,
+    const uint16_t* BlockRowIndex,
+    const float* BlockValues,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a transposed tile of matrix A by the groups of
+    blocks of a range of panels of the packed matrix B. The rows of matrix A
+    are held in VectorCount vectors of 8 elements.
+
+Arguments:
+
+    See MlasSgemmSparseKernelAvx2.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Tile[MLAS_SGEMM_SPARSE_COLUMN_GROUP * MLAS_SGEMM_SPARSE_STRIDEM], 32);
+
+    const __m256 AlphaBroadcast = _mm256_set1_ps(alpha);
+
+    for (size_t n = 0; n < CountN; n += MLAS_SGEMM_SPARSE_COLUMN_GROUP) {
+
+        const size_t CountColumns = std::min(CountN - n, size_t(MLAS_SGEMM_SPARSE_COLUMN_GROUP));
+        const size_t CountPanels = (CountColumns + BlkN - 1) / BlkN;
+        const size_t* Offsets = GroupOffsets + n / BlkN;
+
+        for (size_t p = 0; p < CountPanels; p++) {
+            MlasSgemmSparseComputePanel<BlkN, VectorCount>(PanelA, Offsets[p], Offsets[p + 1],
+                BlockRowIndex, BlockValues, AlphaBroadcast, Tile + p * BlkN * MLAS_SGEMM_SPARSE_STRIDEM);
+        }
+
+        for (size_t p = CountPanels * BlkN; p < MLAS_SGEMM_SPARSE_COLUMN_GROUP; p++) {
+            for (size_t v = 0; v < VectorCount; v++) {
+                _mm256_store_ps(Tile + p * MLAS_SGEMM_SPARSE_STRIDEM + v * 8, _mm256_setzero_ps());
+            }
+        }
+
+        //
+        // Transpose the columns of the tile to rows of matrix C.
+        //
+
+        const __m256i ColumnMask = _mm256_cmpgt_epi32(_mm256_set1_epi32(int32_t(CountColumns)),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+        for (size_t v = 0; v < VectorCount; v++) {
+
+            __m256 Rows[8];
+
+            for (size_t j = 0; j < 8; j++) {
+                Rows[j] = _mm256_load_ps(Tile + j * MLAS_SGEMM_SPARSE_STRIDEM + v * 8);
+            }
+
+            MlasSgemmSparseTranspose8x8(Rows);
+
+            const size_t CountRows = std::min(CountM - std::min(CountM, v * 8), size_t(8));
+
+            for (size_t j = 0; j < CountRows; j++) {
+
+                float* c = C + (v * 8 + j) * ldc + n;
+
+                if (CountColumns == MLAS_SGEMM_SPARSE_COLUMN_GROUP) {
+                    if (!ZeroMode) {
+                        Rows[j] = _mm256_add_ps(Rows[j], _mm256_loadu_ps(c));
+                    }
+                    _mm256_storeu_ps(c, Rows[j]);
+                } else {
+                    if (!ZeroMode) {
+                        Rows[j] = _mm256_add_ps(Rows[j], _mm256_maskload_ps(c, ColumnMask));
+                    }
+                    _mm256_maskstore_ps(c, ColumnMask, Rows[j]);
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasSgemmSparseKernelAvx2(
+    size_t BlkN,
+    const float* PanelA,
+    size_t CountM,
+    const size_t* GroupOffsets,
+    const uint16_t* BlockRowIndex,
+    const float* BlockValues,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a transposed tile of matrix A by the groups of
+    blocks of a range of panels of the packed matrix B.
+
+Arguments:
+
+    BlkN - Supplies the number of columns per block.
+
+    PanelA - Supplies the address of the transposed tile of matrix A: rows of
+        MLAS_SGEMM_SPARSE_STRIDEM values, zero padded past CountM.
+
+    CountM - Supplies the number of rows of matrix A and matrix C to process.
+
+    GroupOffsets - Supplies the index of the first block of each panel of the
+        range, followed by the index past the last block of the last panel.
+
+    BlockRowIndex - Supplies the row index of each block in the tile.
+
+    BlockValues - Supplies the BlkN values of each block.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountN - Supplies the number of columns of matrix C to process.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static_assert(MLAS_SGEMM_SPARSE_STRIDEM == 16, "kernel assumes two vectors of rows");
+
+    if (BlkN == 4) {
+        if (CountM > 8) {
+            MlasSgemmSparseKernelAvx2Impl<4, 2>(PanelA, CountM, GroupOffsets, BlockRowIndex, BlockValues,
+                C, ldc, CountN, alpha, ZeroMode);
+        } else {
+            MlasSgemmSparseKernelAvx2Impl<4, 1>(PanelA, CountM, GroupOffsets, BlockRowIndex, BlockValues,
+                C, ldc, CountN, alpha, ZeroMode);
+        }
+    } else {
+        if (CountM > 8) {
+            MlasSgemmSparseKernelAvx2Impl<1, 2>(PanelA, CountM, GroupOffsets, BlockRowIndex, BlockValues,
+                C, ldc, CountN, alpha, ZeroMode);
+        } else {
+            MlasSgemmSparseKernelAvx2Impl<1, 1>(PanelA, CountM, GroupOffsets, BlockRowIndex, BlockValues,
+                C, ldc, CountN, alpha, ZeroMode);
+        }
+    }
+}
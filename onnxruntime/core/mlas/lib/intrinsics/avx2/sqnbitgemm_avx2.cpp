@@ -0,0 +1,476 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_avx2.cpp
+
+Abstract:
+
+    This module implements the kernels for the blockwise quantized weight
+    matrix multiply using AVX2 and FMA3 intrinsics: a kernel to multiply a
+    single row of matrix A that expands the quantized elements to single
+    precision in registers, and a kernel to dequantize panels of matrix B.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddFloat32x8(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_movehdup_ps(Vector128));
+    return _mm_cvtss_f32(Vector128);
+}
+
+template<size_t BlkBitWidth>
+MLAS_FORCEINLINE
+void
+MlasSQNBitLoad16Values(
+    const uint8_t* BlkData,
+    __m256& Values0,
+    __m256& Values1
+    )
+/*++
+
+Routine Description:
+
+    This routine expands 16 consecutive quantized elements to single precision.
+
+Arguments:
+
+    BlkData - Supplies the address of the quantized elements.
+
+    Values0 - Receives elements 0 to 7.
+
+    Values1 - Receives elements 8 to 15.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    __m128i Bytes;
+
+    if constexpr (BlkBitWidth == 4) {
+
+        //
+        // Split each byte into its low and high nibble and interleave the
+        // nibbles back into element order.
+        //
+
+        const __m128i LowMask = _mm_set1_epi8(0x0F);
+        const __m128i Packed = _mm_loadl_epi64((const __m128i*)BlkData);
+        const __m128i Low = _mm_and_si128(Packed, LowMask);
+        const __m128i High = _mm_and_si128(_mm_srli_epi16(Packed, 4), LowMask);
+
+        Bytes = _mm_unpacklo_epi8(Low, High);
+
+    } else {
+
+        Bytes = _mm_loadu_si128((const __m128i*)BlkData);
+    }
+
+    Values0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(Bytes));
+    Values1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(Bytes, 8)));
+}
+
+template<size_t BlkBitWidth>
+MLAS_FORCEINLINE
+uint32_t
+MlasSQNBitGetValue(
+    const uint8_t* BlkData,
+    size_t Index
+    )
+{
+    if constexpr (BlkBitWidth == 4) {
+        return (BlkData[Index / 2] >> ((Index & 1) * 4)) & 0x0F;
+    } else {
+        return BlkData[Index];
+    }
+}
+
+template<size_t BlkBitWidth>
+void
+MlasSQNBitGemmM1KernelAvx2(
+    size_t BlkLen,
+    const float* A,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t K,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    const size_t BlkDataSize = BlkLen * BlkBitWidth / 8;
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = (BlkBitWidth == 4) ? (BlockCountK + 1) / 2 : BlockCountK;
+    const float DefaultZeroPoint = float(1u << (BlkBitWidth - 1));
+
+    for (size_t n = 0; n < CountN; n++) {
+
+        const uint8_t* b = QuantBData + n * StrideQuantBData;
+        const float* s = QuantBScale + n * BlockCountK;
+        const uint8_t* zp = (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * StrideQuantBZeroPoint : nullptr;
+
+        __m256 Accumulator0 = _mm256_setzero_ps();
+        __m256 Accumulator1 = _mm256_setzero_ps();
+        float RemainderAccumulator = 0.0f;
+
+        for (size_t k = 0, BlockIndex = 0; k < K; k += BlkLen, BlockIndex++) {
+
+            const size_t CountK = std::min(K - k, BlkLen);
+            const float ZeroPoint = (zp != nullptr) ?
+                float(MlasSQNBitGetValue<BlkBitWidth>(zp, BlockIndex)) : DefaultZeroPoint;
+            const uint8_t* BlkData = b + BlockIndex * BlkDataSize;
+            const float* a = A + k;
+
+            const __m256 ZeroPointBroadcast = _mm256_set1_ps(ZeroPoint);
+
+            __m256 BlockAccumulator0 = _mm256_setzero_ps();
+            __m256 BlockAccumulator1 = _mm256_setzero_ps();
+
+            size_t kk = 0;
+
+            for (; kk + 16 <= CountK; kk += 16) {
+
+                __m256 Values0;
+                __m256 Values1;
+
+                MlasSQNBitLoad16Values<BlkBitWidth>(BlkData + kk * BlkBitWidth / 8, Values0, Values1);
+
+                Values0 = _mm256_sub_ps(Values0, ZeroPointBroadcast);
+                Values1 = _mm256_sub_ps(Values1, ZeroPointBroadcast);
+
+                BlockAccumulator0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + kk), Values0, BlockAccumulator0);
+                BlockAccumulator1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + kk + 8), Values1, BlockAccumulator1);
+            }
+
+            const __m256 ScaleBroadcast = _mm256_set1_ps(s[BlockIndex]);
+
+            Accumulator0 = _mm256_fmadd_ps(BlockAccumulator0, ScaleBroadcast, Accumulator0);
+            Accumulator1 = _mm256_fmadd_ps(BlockAccumulator1, ScaleBroadcast, Accumulator1);
+
+            //
+            // Only the last block of a column can be partial.
+            //
+
+            if (kk < CountK) {
+
+                float BlockRemainder = 0.0f;
+
+                for (; kk < CountK; kk++) {
+                    BlockRemainder += a[kk] * (float(MlasSQNBitGetValue<BlkBitWidth>(BlkData, kk)) - ZeroPoint);
+                }
+
+                RemainderAccumulator += BlockRemainder * s[BlockIndex];
+            }
+        }
+
+        float Output = MlasReduceAddFloat32x8(_mm256_add_ps(Accumulator0, Accumulator1)) + RemainderAccumulator;
+
+        if (Bias != nullptr) {
+            Output += Bias[n];
+        }
+
+        C[n] = Output;
+    }
+}
+
+void
+MLASCALL
+MlasSQ4BitGemmM1KernelAvx2(
+    size_t BlkLen,
+    const float* A,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t K,
+    size_t BlockCountK,
+    const float* Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a single row of matrix A by a range of columns of
+    a 4-bit blockwise quantized matrix B using AVX2 and FMA3 instructions.
+
+    Refer to MlasSQ4BitGemmM1Kernel for the argument descriptions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSQNBitGemmM1KernelAvx2<4>(BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, K,
+        BlockCountK, Bias);
+}
+
+void
+MLASCALL
+MlasSQ8BitGemmM1KernelAvx2(
+    size_t BlkLen,
+    const float* A,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t K,
+    size_t BlockCountK,
+    const float* Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a single row of matrix A by a range of columns of
+    an 8-bit blockwise quantized matrix B using AVX2 and FMA3 instructions.
+
+    Refer to MlasSQ4BitGemmM1Kernel for the argument descriptions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSQNBitGemmM1KernelAvx2<8>(BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, K,
+        BlockCountK, Bias);
+}
+
+MLAS_FORCEINLINE
+void
+MlasTranspose8x8Float32x8(
+    __m256 Rows[8]
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes an 8x8 tile held in registers.
+
+Arguments:
+
+    Rows - Supplies the rows of the tile and receives the columns.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m256 t0 = _mm256_unpacklo_ps(Rows[0], Rows[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(Rows[0], Rows[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(Rows[2], Rows[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(Rows[2], Rows[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(Rows[4], Rows[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(Rows[4], Rows[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(Rows[6], Rows[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(Rows[6], Rows[7]);
+
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    Rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    Rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    Rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    Rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    Rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    Rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    Rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    Rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+template<size_t BlkBitWidth>
+void
+MlasSQNBitGemmDequantizeBAvx2(
+    size_t BlkLen,
+    float* FpData,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    size_t CountN,
+    size_t StartK,
+    size_t CountK,
+    size_t BlockCountK
+    )
+{
+    static_assert(MLAS_SGEMM_PACKED_B_WIDTH == 16, "the panel is stored in groups of 16 columns");
+
+    const size_t BlkDataSize = BlkLen * BlkBitWidth / 8;
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = (BlkBitWidth == 4) ? (BlockCountK + 1) / 2 : BlockCountK;
+    const float DefaultZeroPoint = float(1u << (BlkBitWidth - 1));
+    const size_t AlignedCountN = (CountN + 15) & ~size_t(15);
+
+    //
+    // The values of a column are consecutive along K in the quantized blocks
+    // but interleaved with the other columns of its group in the panel, so
+    // the columns are dequantized 8 at a time and tiles of 8 rows by 8
+    // columns are transposed in registers before they are stored.
+    //
+
+    for (size_t n = 0; n < AlignedCountN; n += 8) {
+
+        float* d = FpData + (n / 16) * 16 * CountK + (n % 16);
+        const size_t CountColumns = (n < CountN) ? std::min(CountN - n, size_t(8)) : 0;
+
+        for (size_t k = 0; k < CountK; k += BlkLen) {
+
+            const size_t BlockIndex = (StartK + k) / BlkLen;
+            const size_t CountBlockK = std::min(CountK - k, BlkLen);
+
+            const uint8_t* BlkData[8];
+            float Scale[8];
+            float ZeroPoint[8];
+
+            for (size_t j = 0; j < CountColumns; j++) {
+                const uint8_t* zp = (QuantBZeroPoint != nullptr) ?
+                    QuantBZeroPoint + (n + j) * StrideQuantBZeroPoint : nullptr;
+                BlkData[j] = QuantBData + (n + j) * StrideQuantBData + BlockIndex * BlkDataSize;
+                Scale[j] = QuantBScale[(n + j) * BlockCountK + BlockIndex];
+                ZeroPoint[j] = (zp != nullptr) ?
+                    float(MlasSQNBitGetValue<BlkBitWidth>(zp, BlockIndex)) : DefaultZeroPoint;
+            }
+
+            size_t kk = 0;
+
+            if (CountColumns == 8) {
+
+                for (; kk + 16 <= CountBlockK; kk += 16) {
+
+                    __m256 Values0[8];
+                    __m256 Values1[8];
+
+                    //
+                    // Fold the zero point into the scaled value: (q - zp) * s
+                    // is computed as q * s - zp * s.
+                    //
+
+                    for (size_t j = 0; j < 8; j++) {
+
+                        const __m256 ScaleBroadcast = _mm256_set1_ps(Scale[j]);
+                        const __m256 OffsetBroadcast = _mm256_set1_ps(-ZeroPoint[j] * Scale[j]);
+
+                        MlasSQNBitLoad16Values<BlkBitWidth>(BlkData[j] + kk * BlkBitWidth / 8, Values0[j], Values1[j]);
+
+                        Values0[j] = _mm256_fmadd_ps(Values0[j], ScaleBroadcast, OffsetBroadcast);
+                        Values1[j] = _mm256_fmadd_ps(Values1[j], ScaleBroadcast, OffsetBroadcast);
+                    }
+
+                    MlasTranspose8x8Float32x8(Values0);
+                    MlasTranspose8x8Float32x8(Values1);
+
+                    float* dk = d + (k + kk) * 16;
+
+                    for (size_t i = 0; i < 8; i++) {
+                        _mm256_storeu_ps(dk + i * 16, Values0[i]);
+                        _mm256_storeu_ps(dk + (i + 8) * 16, Values1[i]);
+                    }
+                }
+            }
+
+            //
+            // Handle the rows of a partial block and the columns of a partial
+            // group, zero-padding the columns past CountN.
+            //
+
+            for (; kk < CountBlockK; kk++) {
+
+                float* dk = d + (k + kk) * 16;
+
+                for (size_t j = 0; j < 8; j++) {
+                    dk[j] = (j < CountColumns) ?
+                        (float(MlasSQNBitGetValue<BlkBitWidth>(BlkData[j], kk)) - ZeroPoint[j]) * Scale[j] : 0.0f;
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasSQ4BitGemmDequantizeBKernelAvx2(
+    size_t BlkLen,
+    float* FpData,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    size_t CountN,
+    size_t StartK,
+    size_t CountK,
+    size_t BlockCountK
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a panel of a 4-bit blockwise quantized matrix B
+    using AVX2 and FMA3 instructions.
+
+    Refer to MlasSQ4BitGemmDequantizeBKernel for the argument descriptions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSQNBitGemmDequantizeBAvx2<4>(BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN,
+        StartK, CountK, BlockCountK);
+}
+
+void
+MLASCALL
+MlasSQ8BitGemmDequantizeBKernelAvx2(
+    size_t BlkLen,
+    float* FpData,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    size_t CountN,
+    size_t StartK,
+    size_t CountK,
+    size_t BlockCountK
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a panel of an 8-bit blockwise quantized matrix B
+    using AVX2 and FMA3 instructions.
+
+    Refer to MlasSQ4BitGemmDequantizeBKernel for the argument descriptions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSQNBitGemmDequantizeBAvx2<8>(BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN,
+        StartK, CountK, BlockCountK);
+}
@@ -0,0 +1,123 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvtfp16_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernels to convert between half precision and
+    single precision values using AVX512F intrinsics.
+
+    N.B. The zero masked forms of the conversion intrinsics are used to avoid
+    the uninitialized source operand of the unmasked forms.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernelAvx512F(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision values to single
+    precision values.
+
+Arguments:
+
+    Source - Supplies the half precision values.
+
+    Destination - Supplies the single precision values.
+
+    Count - Supplies the number of values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 32) {
+        __m256i HalfVector0 = _mm256_loadu_si256((const __m256i*)Source);
+        __m256i HalfVector1 = _mm256_loadu_si256((const __m256i*)(Source + 16));
+        _mm512_storeu_ps(Destination, _mm512_maskz_cvtph_ps(__mmask16(0xFFFF), HalfVector0));
+        _mm512_storeu_ps(Destination + 16, _mm512_maskz_cvtph_ps(__mmask16(0xFFFF), HalfVector1));
+        Source += 32;
+        Destination += 32;
+        Count -= 32;
+    }
+
+    if (Count >= 16) {
+        __m256i HalfVector = _mm256_loadu_si256((const __m256i*)Source);
+        _mm512_storeu_ps(Destination, _mm512_maskz_cvtph_ps(__mmask16(0xFFFF), HalfVector));
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count > 0) {
+        MlasConvertHalfToFloatKernelF16C(Source, Destination, Count);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernelAvx512F(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to half
+    precision values, rounding to nearest even.
+
+Arguments:
+
+    Source - Supplies the single precision values.
+
+    Destination - Supplies the half precision values.
+
+    Count - Supplies the number of values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 32) {
+        __m256i HalfVector0 = _mm512_maskz_cvtps_ph(__mmask16(0xFFFF), _mm512_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        __m256i HalfVector1 = _mm512_maskz_cvtps_ph(__mmask16(0xFFFF), _mm512_loadu_ps(Source + 16), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256((__m256i*)Destination, HalfVector0);
+        _mm256_storeu_si256((__m256i*)(Destination + 16), HalfVector1);
+        Source += 32;
+        Destination += 32;
+        Count -= 32;
+    }
+
+    if (Count >= 16) {
+        __m256i HalfVector = _mm512_maskz_cvtps_ph(__mmask16(0xFFFF), _mm512_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256((__m256i*)Destination, HalfVector);
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count > 0) {
+        MlasConvertFloatToHalfKernelF16C(Source, Destination, Count);
+    }
+}
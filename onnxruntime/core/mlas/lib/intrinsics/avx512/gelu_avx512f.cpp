@@ -0,0 +1,122 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gelu_avx512f.cpp
+
+Abstract:
+
+    This module implements routines to add a bias vector and apply the GELU
+    (erf and tanh forms) or Swish activation in a single pass using AVX512F
+    intrinsics.
+
+    The bitwise operations are done on integer vectors because the floating
+    point forms require AVX512DQ.
+
+--*/
+
+#include "../../gelu.h"
+
+//
+// Vector operations for the shared kernel templates.
+//
+
+struct MLAS_BIAS_ACTIVATION_OPS_AVX512F {
+
+    typedef __m512 FloatVector;
+
+    static constexpr size_t VectorLength = 16;
+
+    static FloatVector Broadcast(float Value) { return _mm512_set1_ps(Value); }
+
+    static FloatVector Load(const float* Buffer) { return _mm512_loadu_ps(Buffer); }
+
+    static void Store(float* Buffer, FloatVector Vector) { _mm512_storeu_ps(Buffer, Vector); }
+
+    static FloatVector Add(FloatVector v1, FloatVector v2) { return _mm512_add_ps(v1, v2); }
+
+    static FloatVector Subtract(FloatVector v1, FloatVector v2) { return _mm512_sub_ps(v1, v2); }
+
+    static FloatVector Multiply(FloatVector v1, FloatVector v2) { return _mm512_mul_ps(v1, v2); }
+
+    static FloatVector MultiplyAdd(FloatVector v1, FloatVector v2, FloatVector v3) { return _mm512_fmadd_ps(v1, v2, v3); }
+
+    static FloatVector Divide(FloatVector v1, FloatVector v2) { return _mm512_div_ps(v1, v2); }
+
+    static FloatVector Minimum(FloatVector v1, FloatVector v2) { return _mm512_min_ps(v1, v2); }
+
+    static FloatVector Maximum(FloatVector v1, FloatVector v2) { return _mm512_max_ps(v1, v2); }
+
+    static FloatVector And(FloatVector v1, FloatVector v2)
+    {
+        return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(v1), _mm512_castps_si512(v2)));
+    }
+
+    static FloatVector AndNot(FloatVector v1, FloatVector v2)
+    {
+        return _mm512_castsi512_ps(_mm512_andnot_si512(_mm512_castps_si512(v1), _mm512_castps_si512(v2)));
+    }
+
+    static FloatVector Or(FloatVector v1, FloatVector v2)
+    {
+        return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(v1), _mm512_castps_si512(v2)));
+    }
+
+    static FloatVector Xor(FloatVector v1, FloatVector v2)
+    {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(v1), _mm512_castps_si512(v2)));
+    }
+
+    static FloatVector GreaterThan(FloatVector v1, FloatVector v2)
+    {
+        __mmask16 Mask = _mm512_cmp_ps_mask(v1, v2, _CMP_GT_OQ);
+        return _mm512_castsi512_ps(_mm512_maskz_set1_epi32(Mask, -1));
+    }
+
+    static FloatVector PowerOf2(FloatVector Vector)
+    {
+        __m512i emm0 = _mm512_add_epi32(_mm512_cvtps_epi32(Vector), _mm512_set1_epi32(127));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(emm0, 23));
+    }
+};
+
+void
+MLASCALL
+MlasBiasActivationF32KernelAvx512F(
+    const MLAS_ACTIVATION* Activation,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the optional bias vector to the input vector and
+    applies the GELU or Swish activation.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Input - Supplies the input vector.
+
+    Bias - Supplies the optional bias vector.
+
+    Output - Supplies the output vector. The output may alias the input.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasBiasActivationDispatch<MLAS_BIAS_ACTIVATION_OPS_AVX512F>(Activation, Input, Bias, Output, N);
+}
@@ -0,0 +1,210 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernel to normalize a single row for layer
+    normalization using AVX512F intrinsics.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddFloat32x16(
+    __m512 Vector
+    )
+{
+    //
+    // Spill the vector and fold the halves with 256-bit operations. This avoids
+    // the 512-bit extract intrinsics that some compilers warn about.
+    //
+
+    MLAS_DECLSPEC_ALIGN(float Buffer[16], 64);
+
+    _mm512_store_ps(Buffer, Vector);
+
+    __m256 Vector256 = _mm256_add_ps(_mm256_load_ps(Buffer), _mm256_load_ps(Buffer + 8));
+    __m128 Vector128 = _mm_add_ps(_mm256_castps256_ps128(Vector256), _mm256_extractf128_ps(Vector256, 1));
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_movehdup_ps(Vector128));
+    return _mm_cvtss_f32(Vector128);
+}
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx512F(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* MeanValue,
+    float* InvStdDevValue
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes a single row using AVX512F instructions. The
+    partial vector at the end of the row is handled with masked loads and
+    stores.
+
+    Refer to MlasLayerNormF32Kernel for the argument descriptions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool HasResidual = (Skip != nullptr || SkipBias != nullptr);
+    const float* Source = HasResidual ? Output : Input;
+    float Mean = 0.0f;
+
+    //
+    // Pass 1: add the residual terms and accumulate the row sum.
+    //
+
+    if (!Simplified || HasResidual) {
+
+        __m512 SumVector0 = _mm512_setzero_ps();
+        __m512 SumVector1 = _mm512_setzero_ps();
+        size_t n = 0;
+
+        while (n + 32 <= N) {
+
+            __m512 Vector0 = _mm512_loadu_ps(Input + n);
+            __m512 Vector1 = _mm512_loadu_ps(Input + n + 16);
+
+            if (Skip != nullptr) {
+                Vector0 = _mm512_add_ps(Vector0, _mm512_loadu_ps(Skip + n));
+                Vector1 = _mm512_add_ps(Vector1, _mm512_loadu_ps(Skip + n + 16));
+            }
+
+            if (SkipBias != nullptr) {
+                Vector0 = _mm512_add_ps(Vector0, _mm512_loadu_ps(SkipBias + n));
+                Vector1 = _mm512_add_ps(Vector1, _mm512_loadu_ps(SkipBias + n + 16));
+            }
+
+            if (HasResidual) {
+                _mm512_storeu_ps(Output + n, Vector0);
+                _mm512_storeu_ps(Output + n + 16, Vector1);
+            }
+
+            SumVector0 = _mm512_add_ps(SumVector0, Vector0);
+            SumVector1 = _mm512_add_ps(SumVector1, Vector1);
+
+            n += 32;
+        }
+
+        while (n < N) {
+
+            size_t Remaining = N - n;
+            __mmask16 Mask = (Remaining >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << Remaining) - 1);
+
+            __m512 Vector = _mm512_maskz_loadu_ps(Mask, Input + n);
+
+            if (Skip != nullptr) {
+                Vector = _mm512_add_ps(Vector, _mm512_maskz_loadu_ps(Mask, Skip + n));
+            }
+
+            if (SkipBias != nullptr) {
+                Vector = _mm512_add_ps(Vector, _mm512_maskz_loadu_ps(Mask, SkipBias + n));
+            }
+
+            if (HasResidual) {
+                _mm512_mask_storeu_ps(Output + n, Mask, Vector);
+            }
+
+            SumVector0 = _mm512_add_ps(SumVector0, Vector);
+
+            n += 16;
+        }
+
+        float Sum = MlasReduceAddFloat32x16(_mm512_add_ps(SumVector0, SumVector1));
+
+        if (!Simplified) {
+            Mean = Sum / float(N);
+        }
+    }
+
+    //
+    // Pass 2: accumulate the squared deviations from the mean while the row
+    // is resident in the cache.
+    //
+
+    __m512 MeanVector = _mm512_set1_ps(Mean);
+    float InvStdDev;
+
+    {
+        __m512 SumVector0 = _mm512_setzero_ps();
+        __m512 SumVector1 = _mm512_setzero_ps();
+        size_t n = 0;
+
+        while (n + 32 <= N) {
+
+            __m512 Vector0 = _mm512_sub_ps(_mm512_loadu_ps(Source + n), MeanVector);
+            __m512 Vector1 = _mm512_sub_ps(_mm512_loadu_ps(Source + n + 16), MeanVector);
+
+            SumVector0 = _mm512_fmadd_ps(Vector0, Vector0, SumVector0);
+            SumVector1 = _mm512_fmadd_ps(Vector1, Vector1, SumVector1);
+
+            n += 32;
+        }
+
+        while (n < N) {
+
+            size_t Remaining = N - n;
+            __mmask16 Mask = (Remaining >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << Remaining) - 1);
+
+            __m512 Vector = _mm512_maskz_sub_ps(Mask, _mm512_maskz_loadu_ps(Mask, Source + n), MeanVector);
+
+            SumVector0 = _mm512_fmadd_ps(Vector, Vector, SumVector0);
+
+            n += 16;
+        }
+
+        float Sum = MlasReduceAddFloat32x16(_mm512_add_ps(SumVector0, SumVector1));
+
+        InvStdDev = 1.0f / std::sqrt(Sum / float(N) + Epsilon);
+    }
+
+    //
+    // Pass 3: normalize the row and apply the scale and bias.
+    //
+
+    __m512 InvStdDevVector = _mm512_set1_ps(InvStdDev);
+
+    for (size_t n = 0; n < N; n += 16) {
+
+        size_t Remaining = N - n;
+        __mmask16 Mask = (Remaining >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << Remaining) - 1);
+
+        __m512 Vector = _mm512_sub_ps(_mm512_maskz_loadu_ps(Mask, Source + n), MeanVector);
+        __m512 ScaleVector = _mm512_mul_ps(_mm512_maskz_loadu_ps(Mask, Scale + n), InvStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector = _mm512_fmadd_ps(Vector, ScaleVector, _mm512_maskz_loadu_ps(Mask, Bias + n));
+        } else {
+            Vector = _mm512_mul_ps(Vector, ScaleVector);
+        }
+
+        _mm512_mask_storeu_ps(Output + n, Mask, Vector);
+    }
+
+    *MeanValue = Mean;
+    *InvStdDevValue = InvStdDev;
+}
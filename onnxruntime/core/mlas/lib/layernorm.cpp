@@ -0,0 +1,635 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute layer normalization and skip
+    layer normalization over the rows of a matrix.
+
+    Each row is normalized with a fused two-pass algorithm: the first pass
+    optionally adds the residual and bias terms and accumulates the row sum,
+    the second pass accumulates the squared deviations from the mean while
+    the row is still resident in the cache, and the final pass applies the
+    scale and bias.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a layer normalization
+// operation on worker threads.
+//
+
+struct MLAS_LAYERNORM_WORK_BLOCK {
+    ptrdiff_t ThreadCountN;
+    const float* Input;
+    const float* Skip;
+    const float* SkipBias;
+    const float* Scale;
+    const float* Bias;
+    float* Output;
+    float* Mean;
+    float* InvStdDev;
+    size_t RowCount;
+    size_t RowSize;
+    float Epsilon;
+    bool Simplified;
+};
+
+MLAS_FORCEINLINE
+float
+MlasLayerNormAccumulateRow(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sum of the elements of a row after optionally
+    adding the residual and bias terms. If either term is supplied, the
+    combined row is stored to the output buffer for use by the later passes.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Skip - Optionally supplies the residual row.
+
+    SkipBias - Optionally supplies the bias added to the residual row.
+
+    Output - Supplies the output row.
+
+    N - Supplies the number of elements in the row.
+
+Return Value:
+
+    Returns the sum of the (combined) row.
+
+--*/
+{
+    const bool StoreOutput = (Skip != nullptr || SkipBias != nullptr);
+
+    MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumVector1 = MlasZeroFloat32x4();
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+        MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + 4);
+
+        if (Skip != nullptr) {
+            Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Skip));
+            Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(Skip + 4));
+            Skip += 8;
+        }
+
+        if (SkipBias != nullptr) {
+            Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(SkipBias));
+            Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(SkipBias + 4));
+            SkipBias += 8;
+        }
+
+        if (StoreOutput) {
+            MlasStoreFloat32x4(Output, Vector0);
+            MlasStoreFloat32x4(Output + 4, Vector1);
+        }
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Vector0);
+        SumVector1 = MlasAddFloat32x4(SumVector1, Vector1);
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+
+    while (N > 0) {
+
+        float Value = *Input++;
+
+        if (Skip != nullptr) {
+            Value += *Skip++;
+        }
+
+        if (SkipBias != nullptr) {
+            Value += *SkipBias++;
+        }
+
+        if (StoreOutput) {
+            *Output = Value;
+        }
+
+        Sum += Value;
+
+        Output++;
+        N -= 1;
+    }
+
+    return Sum;
+}
+
+MLAS_FORCEINLINE
+float
+MlasLayerNormSumSquaresRow(
+    const float* Input,
+    size_t N,
+    float Mean
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sum of the squared deviations of the elements
+    of a row from the supplied mean.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    N - Supplies the number of elements in the row.
+
+    Mean - Supplies the mean of the row, or zero to compute the sum of
+        squares for the simplified (RMS) normalization.
+
+Return Value:
+
+    Returns the sum of the squared deviations.
+
+--*/
+{
+    MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(Mean);
+    MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumVector1 = MlasZeroFloat32x4();
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input), MeanVector);
+        MLAS_FLOAT32X4 Vector1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + 4), MeanVector);
+
+        SumVector0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SumVector0);
+        SumVector1 = MlasMultiplyAddFloat32x4(Vector1, Vector1, SumVector1);
+
+        Input += 8;
+        N -= 8;
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+
+    while (N > 0) {
+
+        float Value = *Input++ - Mean;
+
+        Sum += Value * Value;
+
+        N -= 1;
+    }
+
+    return Sum;
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormOutputRow(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float Mean,
+    float InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes a row and applies the scale and optional bias.
+
+Arguments:
+
+    Input - Supplies the input row. This may alias the output row.
+
+    Scale - Supplies the scale vector.
+
+    Bias - Optionally supplies the bias vector.
+
+    Output - Supplies the output row.
+
+    N - Supplies the number of elements in the row.
+
+    Mean - Supplies the mean of the row.
+
+    InvStdDev - Supplies the reciprocal of the standard deviation of the row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(Mean);
+    MLAS_FLOAT32X4 InvStdDevVector = MlasBroadcastFloat32x4(InvStdDev);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input), MeanVector);
+        MLAS_FLOAT32X4 ScaleVector = MlasMultiplyFloat32x4(MlasLoadFloat32x4(Scale), InvStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector = MlasMultiplyAddFloat32x4(Vector, ScaleVector, MlasLoadFloat32x4(Bias));
+            Bias += 4;
+        } else {
+            Vector = MlasMultiplyFloat32x4(Vector, ScaleVector);
+        }
+
+        MlasStoreFloat32x4(Output, Vector);
+
+        Input += 4;
+        Scale += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        float Value = (*Input++ - Mean) * (*Scale++ * InvStdDev);
+
+        if (Bias != nullptr) {
+            Value += *Bias++;
+        }
+
+        *Output++ = Value;
+
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasLayerNormF32Kernel(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* MeanValue,
+    float* InvStdDevValue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to normalize a single row.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Skip - Optionally supplies the residual row added to the input row.
+
+    SkipBias - Optionally supplies the bias added to the input row.
+
+    Scale - Supplies the scale vector.
+
+    Bias - Optionally supplies the bias vector.
+
+    Output - Supplies the output row.
+
+    N - Supplies the number of elements in the row.
+
+    Epsilon - Supplies the value added to the variance for numerical
+        stability.
+
+    Simplified - Supplies true to compute the simplified (RMS) normalization
+        that does not subtract the mean.
+
+    MeanValue - Receives the mean of the row.
+
+    InvStdDevValue - Receives the reciprocal of the standard deviation of the
+        row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* Source = (Skip != nullptr || SkipBias != nullptr) ? Output : Input;
+    float Mean = 0.0f;
+
+    if (!Simplified || Source != Input) {
+
+        float Sum = MlasLayerNormAccumulateRow(Input, Skip, SkipBias, Output, N);
+
+        if (!Simplified) {
+            Mean = Sum / float(N);
+        }
+    }
+
+    float Variance = MlasLayerNormSumSquaresRow(Source, N, Mean) / float(N);
+    float InvStdDev = 1.0f / std::sqrt(Variance + Epsilon);
+
+    MlasLayerNormOutputRow(Source, Scale, Bias, Output, N, Mean, InvStdDev);
+
+    *MeanValue = Mean;
+    *InvStdDevValue = InvStdDev;
+}
+
+void
+MlasLayerNormThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    layer normalization operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_LAYERNORM_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the row dimension.
+    //
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->RowCount, &n, &CountN);
+
+    const size_t RowSize = WorkBlock->RowSize;
+
+    const float* Input = WorkBlock->Input + n * RowSize;
+    const float* Skip = (WorkBlock->Skip != nullptr) ? WorkBlock->Skip + n * RowSize : nullptr;
+    float* Output = WorkBlock->Output + n * RowSize;
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_LAYERNORM_FLOAT_KERNEL* LayerNormKernel = GetMlasPlatform().LayerNormF32Kernel;
+#else
+    MLAS_LAYERNORM_FLOAT_KERNEL* LayerNormKernel = MlasLayerNormF32Kernel;
+#endif
+
+    while (CountN > 0) {
+
+        float Mean;
+        float InvStdDev;
+
+        LayerNormKernel(Input, Skip, WorkBlock->SkipBias, WorkBlock->Scale,
+            WorkBlock->Bias, Output, RowSize, WorkBlock->Epsilon,
+            WorkBlock->Simplified, &Mean, &InvStdDev);
+
+        if (WorkBlock->Mean != nullptr) {
+            WorkBlock->Mean[n] = Mean;
+        }
+
+        if (WorkBlock->InvStdDev != nullptr) {
+            WorkBlock->InvStdDev[n] = InvStdDev;
+        }
+
+        Input += RowSize;
+        if (Skip != nullptr) {
+            Skip += RowSize;
+        }
+        Output += RowSize;
+
+        n++;
+        CountN--;
+    }
+}
+
+void
+MlasLayerNormExecute(
+    MLAS_LAYERNORM_WORK_BLOCK* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine partitions a layer normalization operation across the thread
+    pool.
+
+Arguments:
+
+    WorkBlock - Supplies the work block describing the operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t RowCount = WorkBlock->RowCount;
+
+    if (RowCount == 0 || WorkBlock->RowSize == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Limit the number of threads to the number of rows and try to
+    // keep each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    ptrdiff_t ThreadCountN = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCountN) > RowCount) {
+        ThreadCountN = ptrdiff_t(RowCount);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((RowCount * WorkBlock->RowSize) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCountN) > BlockCount) {
+        ThreadCountN = ptrdiff_t(BlockCount);
+    }
+
+    WorkBlock->ThreadCountN = ThreadCountN;
+
+    MlasExecuteThreaded(MlasLayerNormThreaded, WorkBlock, ThreadCountN, ThreadPool);
+}
+
+void
+MLASCALL
+MlasLayerNorm(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t RowCount,
+    size_t RowSize,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of each row of the input
+    matrix.
+
+        Output = (Input - Mean) / sqrt(Variance + Epsilon) * Scale + Bias
+
+    For the simplified (RMS) normalization, the mean is not subtracted and
+    the variance is replaced by the mean of the squares.
+
+Arguments:
+
+    Input - Supplies the input matrix of RowCount rows by RowSize columns.
+
+    Scale - Supplies the scale vector of RowSize elements.
+
+    Bias - Optionally supplies the bias vector of RowSize elements.
+
+    Output - Supplies the output matrix.
+
+    Mean - Optionally receives the mean of each row.
+
+    InvStdDev - Optionally receives the reciprocal of the standard deviation
+        of each row.
+
+    RowCount - Supplies the number of rows.
+
+    RowSize - Supplies the number of elements in each row.
+
+    Epsilon - Supplies the value added to the variance for numerical
+        stability.
+
+    Simplified - Supplies true to compute the simplified (RMS) normalization.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_LAYERNORM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Skip = nullptr;
+    WorkBlock.SkipBias = nullptr;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.Mean = Mean;
+    WorkBlock.InvStdDev = InvStdDev;
+    WorkBlock.RowCount = RowCount;
+    WorkBlock.RowSize = RowSize;
+    WorkBlock.Epsilon = Epsilon;
+    WorkBlock.Simplified = Simplified;
+
+    MlasLayerNormExecute(&WorkBlock, ThreadPool);
+}
+
+void
+MLASCALL
+MlasSkipLayerNorm(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of each row of the input
+    matrix after adding the residual matrix and optional residual bias.
+
+        Output = LayerNorm(Input + Skip + SkipBias) * Scale + Bias
+
+Arguments:
+
+    Input - Supplies the input matrix of RowCount rows by RowSize columns.
+
+    Skip - Supplies the residual matrix with the same shape as the input.
+
+    SkipBias - Optionally supplies the residual bias vector of RowSize
+        elements.
+
+    Scale - Supplies the scale vector of RowSize elements.
+
+    Bias - Optionally supplies the bias vector of RowSize elements.
+
+    Output - Supplies the output matrix. This may not alias the input or
+        residual matrices.
+
+    RowCount - Supplies the number of rows.
+
+    RowSize - Supplies the number of elements in each row.
+
+    Epsilon - Supplies the value added to the variance for numerical
+        stability.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_LAYERNORM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Skip = Skip;
+    WorkBlock.SkipBias = SkipBias;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.Mean = nullptr;
+    WorkBlock.InvStdDev = nullptr;
+    WorkBlock.RowCount = RowCount;
+    WorkBlock.RowSize = RowSize;
+    WorkBlock.Epsilon = Epsilon;
+    WorkBlock.Simplified = false;
+
+    MlasLayerNormExecute(&WorkBlock, ThreadPool);
+}
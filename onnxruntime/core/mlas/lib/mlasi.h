@@ -198,6 +198,18 @@ enum MlasUArch {
 #define MLAS_DGEMM_STRIDEN                          64
 #define MLAS_DGEMM_STRIDEK                          128
 
+//
+// Define the number of columns of matrix B that are interleaved per row of a
+// buffer packed by MlasSgemmCopyPackB or MlasSgemmTransposePackB. Columns
+// past the end of matrix B are zero-padded to this width.
+//
+
+#if defined(MLAS_TARGET_WASM_SCALAR)
+#define MLAS_SGEMM_PACKED_B_WIDTH                   4
+#else
+#define MLAS_SGEMM_PACKED_B_WIDTH                   16
+#endif
+
 //
 // Define the alignment for segmenting a GEMM operation across multiple
 // threads.
@@ -211,6 +223,15 @@ enum MlasUArch {
 #define MLAS_DGEMM_STRIDEN_THREAD_ALIGN             8
 #define MLAS_QGEMM_STRIDEN_THREAD_ALIGN             16
 
+//
+// Define the tile dimensions of matrix A for the sparse SGEMM kernels. The
+// kernels read a tile of matrix A transposed to MLAS_SGEMM_SPARSE_STRIDEK rows
+// of MLAS_SGEMM_SPARSE_STRIDEM values.
+//
+
+#define MLAS_SGEMM_SPARSE_STRIDEM                   16
+#define MLAS_SGEMM_SPARSE_STRIDEK                   256
+
 //
 // Define the prototypes of the platform optimized routines.
 //
@@ -469,6 +490,138 @@ void
     const float* Parameters
     );
 
+typedef
+void
+(MLASCALL MLAS_LAYERNORM_FLOAT_KERNEL)(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* MeanValue,
+    float* InvStdDevValue
+    );
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_HALF_TO_FLOAT_KERNEL)(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_FLOAT_TO_HALF_KERNEL)(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    );
+
+typedef
+void
+(MLASCALL MLAS_SQNBIT_GEMM_M1_KERNEL)(
+    size_t BlkLen,
+    const float* A,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t K,
+    size_t BlockCountK,
+    const float* Bias
+    );
+
+typedef
+void
+(MLASCALL MLAS_SQNBIT_GEMM_DEQUANTIZE_B_KERNEL)(
+    size_t BlkLen,
+    float* FpData,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    size_t CountN,
+    size_t StartK,
+    size_t CountK,
+    size_t BlockCountK
+    );
+
+typedef
+void
+(MLASCALL MLAS_SGEMM_SPARSE_KERNEL)(
+    size_t BlkN,
+    const float* PanelA,
+    size_t CountM,
+    const size_t* GroupOffsets,
+    const uint16_t* BlockRowIndex,
+    const float* BlockValues,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    bool ZeroMode
+    );
+
+typedef
+void
+(MLASCALL MLAS_BIAS_ACTIVATION_FLOAT_KERNEL)(
+    const MLAS_ACTIVATION* Activation,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N
+    );
+
+typedef
+float
+(MLASCALL MLAS_REDUCE_ROW_FLOAT_KERNEL)(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t N,
+    float Initial
+    );
+
+typedef
+void
+(MLASCALL MLAS_REDUCE_COLUMNS_FLOAT_KERNEL)(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    bool Accumulate
+    );
+
+typedef
+ptrdiff_t
+(MLASCALL MLAS_ARG_REDUCE_ROW_FLOAT_KERNEL)(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    size_t N,
+    float* Value
+    );
+
+typedef
+void
+(MLASCALL MLAS_ARG_REDUCE_COLUMNS_FLOAT_KERNEL)(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    float* Values,
+    int64_t* Indices,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    int64_t RowBase
+    );
+
 typedef
 float
 (MLASCALL MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL)(
@@ -676,6 +829,59 @@ extern "C" {
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx;
 #endif
 
+    MLAS_LAYERNORM_FLOAT_KERNEL MlasLayerNormF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_LAYERNORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx2;
+    MLAS_LAYERNORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx512F;
+#endif
+
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernel;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernelF16C;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernelF16C;
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernelAvx512F;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernelAvx512F;
+#endif
+
+    MLAS_SQNBIT_GEMM_M1_KERNEL MlasSQ4BitGemmM1Kernel;
+    MLAS_SQNBIT_GEMM_M1_KERNEL MlasSQ8BitGemmM1Kernel;
+    MLAS_SQNBIT_GEMM_DEQUANTIZE_B_KERNEL MlasSQ4BitGemmDequantizeBKernel;
+    MLAS_SQNBIT_GEMM_DEQUANTIZE_B_KERNEL MlasSQ8BitGemmDequantizeBKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_SQNBIT_GEMM_M1_KERNEL MlasSQ4BitGemmM1KernelAvx2;
+    MLAS_SQNBIT_GEMM_M1_KERNEL MlasSQ8BitGemmM1KernelAvx2;
+    MLAS_SQNBIT_GEMM_DEQUANTIZE_B_KERNEL MlasSQ4BitGemmDequantizeBKernelAvx2;
+    MLAS_SQNBIT_GEMM_DEQUANTIZE_B_KERNEL MlasSQ8BitGemmDequantizeBKernelAvx2;
+#endif
+
+    MLAS_SGEMM_SPARSE_KERNEL MlasSgemmSparseKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_SGEMM_SPARSE_KERNEL MlasSgemmSparseKernelAvx2;
+    MLAS_SGEMM_SPARSE_KERNEL MlasSgemmSparseKernelAvx512F;
+#endif
+
+    MLAS_BIAS_ACTIVATION_FLOAT_KERNEL MlasBiasActivationF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_BIAS_ACTIVATION_FLOAT_KERNEL MlasBiasActivationF32KernelAvx2;
+    MLAS_BIAS_ACTIVATION_FLOAT_KERNEL MlasBiasActivationF32KernelAvx512F;
+#endif
+
+    MLAS_REDUCE_ROW_FLOAT_KERNEL MlasReduceRowF32Kernel;
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL MlasReduceColumnsF32Kernel;
+    MLAS_ARG_REDUCE_ROW_FLOAT_KERNEL MlasArgReduceRowF32Kernel;
+    MLAS_ARG_REDUCE_COLUMNS_FLOAT_KERNEL MlasArgReduceColumnsF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_REDUCE_ROW_FLOAT_KERNEL MlasReduceRowF32KernelAvx2;
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL MlasReduceColumnsF32KernelAvx2;
+    MLAS_ARG_REDUCE_ROW_FLOAT_KERNEL MlasArgReduceRowF32KernelAvx2;
+    MLAS_ARG_REDUCE_COLUMNS_FLOAT_KERNEL MlasArgReduceColumnsF32KernelAvx2;
+    MLAS_REDUCE_ROW_FLOAT_KERNEL MlasReduceRowF32KernelAvx512F;
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL MlasReduceColumnsF32KernelAvx512F;
+    MLAS_ARG_REDUCE_ROW_FLOAT_KERNEL MlasArgReduceRowF32KernelAvx512F;
+    MLAS_ARG_REDUCE_COLUMNS_FLOAT_KERNEL MlasArgReduceColumnsF32KernelAvx512F;
+#endif
+
 }
 
 //
@@ -722,7 +928,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_TUNING_PARAMS* Tuning = nullptr
     );
 
 //
@@ -877,6 +1084,19 @@ struct MLAS_PLATFORM {
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeLogSoftmaxOutputF32Kernel;
     MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL* ReduceMaximumF32Kernel;
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL* ReduceMinimumMaximumF32Kernel;
+    MLAS_LAYERNORM_FLOAT_KERNEL* LayerNormF32Kernel;
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL* ConvertHalfToFloatKernel;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL* ConvertFloatToHalfKernel;
+    MLAS_SQNBIT_GEMM_M1_KERNEL* SQ4BitGemmM1Kernel;
+    MLAS_SQNBIT_GEMM_M1_KERNEL* SQ8BitGemmM1Kernel;
+    MLAS_SQNBIT_GEMM_DEQUANTIZE_B_KERNEL* SQ4BitGemmDequantizeBKernel;
+    MLAS_SQNBIT_GEMM_DEQUANTIZE_B_KERNEL* SQ8BitGemmDequantizeBKernel;
+    MLAS_SGEMM_SPARSE_KERNEL* SgemmSparseKernel;
+    MLAS_BIAS_ACTIVATION_FLOAT_KERNEL* BiasActivationF32Kernel;
+    MLAS_REDUCE_ROW_FLOAT_KERNEL* ReduceRowF32Kernel;
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL* ReduceColumnsF32Kernel;
+    MLAS_ARG_REDUCE_ROW_FLOAT_KERNEL* ArgReduceRowF32Kernel;
+    MLAS_ARG_REDUCE_COLUMNS_FLOAT_KERNEL* ArgReduceColumnsF32Kernel;
     MLAS_QUANTIZE_LINEAR_S8_KERNEL* QuantizeLinearS8Kernel;
     MLAS_QUANTIZE_LINEAR_U8_KERNEL* QuantizeLinearU8Kernel;
     uint32_t NchwcBlockSize;
@@ -950,6 +1170,20 @@ MlasGetMaximumThreadCount(
 #endif
 }
 
+inline
+ptrdiff_t
+MlasGetCurrentNumaNode(
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
+    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+    return -1;
+#else
+    return onnxruntime::concurrency::ThreadPool::CurrentNumaNode(ThreadPool);
+#endif
+}
+
 inline
 void
 MlasPartitionWork(
@@ -1021,6 +1255,28 @@ MlasFp32FromBits(
 #pragma warning(pop)
 #endif
 
+//
+// Winograd convolution routines.
+//
+
+bool
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
 void
@@ -1736,6 +1992,23 @@ MlasGreaterThanFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
 #endif
 }
 
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasGreaterThanOrEqualFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_f32_u32(vcgeq_f32(Vector1, Vector2));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_cmpge_ps(Vector1, Vector2);
+#elif defined(MLAS_WASM_SIMD_INTRINSICS)
+    return wasm_f32x4_ge(Vector1, Vector2);
+#elif defined(MLAS_VSX_INTRINSICS)
+    return MLAS_FLOAT32X4(vec_cmpge(Vector1, Vector2));
+#else
+    return Vector1 >= Vector2;
+#endif
+}
+
 MLAS_FORCEINLINE
 MLAS_FLOAT32X4
 MlasAndFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
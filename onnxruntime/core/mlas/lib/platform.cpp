@@ -182,6 +182,19 @@ Return Value:
     this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
     this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
+    this->LayerNormF32Kernel = MlasLayerNormF32Kernel;
+    this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernel;
+    this->ConvertFloatToHalfKernel = MlasConvertFloatToHalfKernel;
+    this->SQ4BitGemmM1Kernel = MlasSQ4BitGemmM1Kernel;
+    this->SQ8BitGemmM1Kernel = MlasSQ8BitGemmM1Kernel;
+    this->SQ4BitGemmDequantizeBKernel = MlasSQ4BitGemmDequantizeBKernel;
+    this->SQ8BitGemmDequantizeBKernel = MlasSQ8BitGemmDequantizeBKernel;
+    this->SgemmSparseKernel = MlasSgemmSparseKernel;
+    this->BiasActivationF32Kernel = MlasBiasActivationF32Kernel;
+    this->ReduceRowF32Kernel = MlasReduceRowF32Kernel;
+    this->ReduceColumnsF32Kernel = MlasReduceColumnsF32Kernel;
+    this->ArgReduceRowF32Kernel = MlasArgReduceRowF32Kernel;
+    this->ArgReduceColumnsF32Kernel = MlasArgReduceColumnsF32Kernel;
     this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
     this->QLinearAddU8Kernel = MlasQLinearAddU8Kernel;
     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8Kernel;
@@ -285,6 +298,27 @@ Return Value:
                 this->ConvDepthwiseS8S8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, int8_t>;
                 this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, uint8_t>;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx2;
+                this->SQ4BitGemmM1Kernel = MlasSQ4BitGemmM1KernelAvx2;
+                this->SQ8BitGemmM1Kernel = MlasSQ8BitGemmM1KernelAvx2;
+                this->SQ4BitGemmDequantizeBKernel = MlasSQ4BitGemmDequantizeBKernelAvx2;
+                this->SQ8BitGemmDequantizeBKernel = MlasSQ8BitGemmDequantizeBKernelAvx2;
+                this->SgemmSparseKernel = MlasSgemmSparseKernelAvx2;
+                this->BiasActivationF32Kernel = MlasBiasActivationF32KernelAvx2;
+                this->ReduceRowF32Kernel = MlasReduceRowF32KernelAvx2;
+                this->ReduceColumnsF32Kernel = MlasReduceColumnsF32KernelAvx2;
+                this->ArgReduceRowF32Kernel = MlasArgReduceRowF32KernelAvx2;
+                this->ArgReduceColumnsF32Kernel = MlasArgReduceColumnsF32KernelAvx2;
+
+                //
+                // Check if the processor supports the F16C conversion
+                // instructions.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernelF16C;
+                    this->ConvertFloatToHalfKernel = MlasConvertFloatToHalfKernelF16C;
+                }
 
                 //
                 // Check if the processor supports Hybrid core architecture.
@@ -333,6 +367,15 @@ Return Value:
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
                     this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
                     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
+                    this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx512F;
+                    this->SgemmSparseKernel = MlasSgemmSparseKernelAvx512F;
+                    this->BiasActivationF32Kernel = MlasBiasActivationF32KernelAvx512F;
+                    this->ReduceRowF32Kernel = MlasReduceRowF32KernelAvx512F;
+                    this->ReduceColumnsF32Kernel = MlasReduceColumnsF32KernelAvx512F;
+                    this->ArgReduceRowF32Kernel = MlasArgReduceRowF32KernelAvx512F;
+                    this->ArgReduceColumnsF32Kernel = MlasArgReduceColumnsF32KernelAvx512F;
+                    this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernelAvx512F;
+                    this->ConvertFloatToHalfKernel = MlasConvertFloatToHalfKernelAvx512F;
                     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx512F;
                     this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx512F;
                     this->NchwcBlockSize = 16;
@@ -0,0 +1,862 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce.cpp
+
+Abstract:
+
+    This module implements routines to reduce the rows or the columns of
+    single precision matrices to their sum, maximum or minimum, or to the
+    index of their maximum or minimum.
+
+    The kernels below target the base instruction set (typically SSE2 or
+    NEON) while the intrinsics implementations target newer instruction sets
+    (such as AVX2 and AVX512F).
+
+    On ARM64 the kernels below are the NEON kernels: MLAS_FLOAT32X4 maps to
+    float32x4_t and the routines call them directly, as there is no other
+    instruction set to select at runtime. The NEON maximum and minimum
+    instructions propagate a NaN from either operand (FMAX, FMIN) or ignore
+    it (FMAXNM, FMINNM), so neither matches the scalar loops and the
+    comparison and select forms are used instead.
+
+    Long reductions are split into blocks whose boundaries only depend on the
+    shape of the reduction. The blocks are reduced by the same kernels and
+    their partial results combined in the same order whether or not they are
+    computed on separate threads, so the output does not depend on the
+    number of threads.
+
+--*/
+
+#include "reduce.h"
+
+//
+// Vector operations for the shared kernel templates.
+//
+
+struct MLAS_REDUCE_OPS_FLOAT32X4 {
+
+    typedef MLAS_FLOAT32X4 FloatVector;
+
+    static constexpr size_t VectorLength = 4;
+
+    static FloatVector Broadcast(float Value) { return MlasBroadcastFloat32x4(Value); }
+
+    static FloatVector Load(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+
+    static void Store(float* Buffer, FloatVector Vector) { MlasStoreFloat32x4(Buffer, Vector); }
+
+    static FloatVector Add(FloatVector v1, FloatVector v2) { return MlasAddFloat32x4(v1, v2); }
+
+    static FloatVector GreaterThan(FloatVector v1, FloatVector v2) { return MlasGreaterThanFloat32x4(v1, v2); }
+
+    static FloatVector GreaterThanOrEqual(FloatVector v1, FloatVector v2) { return MlasGreaterThanOrEqualFloat32x4(v1, v2); }
+
+    static FloatVector Blend(FloatVector v1, FloatVector v2, FloatVector Mask) { return MlasBlendFloat32x4(v1, v2, Mask); }
+
+    //
+    // The SSE forms return the second operand if either operand is a NaN.
+    // Other instruction sets propagate a NaN, so select by comparison.
+    //
+
+    static FloatVector Maximum(FloatVector v1, FloatVector v2)
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+        return MlasMaximumFloat32x4(v1, v2);
+#else
+        return MlasBlendFloat32x4(v2, v1, MlasGreaterThanFloat32x4(v1, v2));
+#endif
+    }
+
+    static FloatVector Minimum(FloatVector v1, FloatVector v2)
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+        return MlasMinimumFloat32x4(v1, v2);
+#else
+        return MlasBlendFloat32x4(v2, v1, MlasGreaterThanFloat32x4(v2, v1));
+#endif
+    }
+};
+
+float
+MLASCALL
+MlasReduceRowF32Kernel(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t N,
+    float Initial
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a vector and combines the result with an initial
+    value.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process.
+
+    Initial - Supplies the value to combine with the elements.
+
+Return Value:
+
+    Returns the reduced value.
+
+--*/
+{
+    return MlasReduceRowDispatch<MLAS_REDUCE_OPS_FLOAT32X4>(ReduceKind, Input, N, Initial);
+}
+
+void
+MLASCALL
+MlasReduceColumnsF32Kernel(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    bool Accumulate
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the columns of a matrix along the rows.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input matrix.
+
+    Output - Supplies the output vector of Columns elements.
+
+    Rows - Supplies the number of rows to reduce, which must be nonzero.
+
+    Columns - Supplies the number of columns to reduce.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    Accumulate - Supplies true to combine the reduced rows with the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasReduceColumnsDispatch<MLAS_REDUCE_OPS_FLOAT32X4>(ReduceKind, Input, Output, Rows, Columns, ldInput, Accumulate);
+}
+
+ptrdiff_t
+MLASCALL
+MlasArgReduceRowF32Kernel(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    size_t N,
+    float* Value
+    )
+/*++
+
+Routine Description:
+
+    This routine finds the index of the maximum or minimum element of a
+    vector, continuing a search that found the supplied value so far.
+
+Arguments:
+
+    ReduceKind - Supplies MlasReduceMaximum or MlasReduceMinimum.
+
+    SelectLastIndex - Supplies true to select the last index of ties.
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process, which must be less than
+        2^24.
+
+    Value - Supplies the best value found so far, and receives the best value
+        found including the input vector.
+
+Return Value:
+
+    Returns the index of the selected element of the input vector, or -1 if
+    no element of the input vector replaces the supplied value.
+
+--*/
+{
+    return MlasArgReduceRowDispatch<MLAS_REDUCE_OPS_FLOAT32X4>(ReduceKind, SelectLastIndex, Input, N, Value);
+}
+
+void
+MLASCALL
+MlasArgReduceColumnsF32Kernel(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    float* Values,
+    int64_t* Indices,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    int64_t RowBase
+    )
+/*++
+
+Routine Description:
+
+    This routine continues the search for the index of the maximum or
+    minimum element of the columns of a matrix.
+
+Arguments:
+
+    ReduceKind - Supplies MlasReduceMaximum or MlasReduceMinimum.
+
+    SelectLastIndex - Supplies true to select the last index of ties.
+
+    Input - Supplies the input matrix.
+
+    Values - Supplies the best values found so far, and receives the best
+        values found including the input rows.
+
+    Indices - Receives the row index of the best value for each column that
+        selects an element of the input rows.
+
+    Rows - Supplies the number of rows to process, which must be less than
+        2^24.
+
+    Columns - Supplies the number of columns to process.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    RowBase - Supplies the row index of the first input row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasArgReduceColumnsDispatch<MLAS_REDUCE_OPS_FLOAT32X4>(ReduceKind, SelectLastIndex, Input, Values, Indices,
+        Rows, Columns, ldInput, RowBase);
+}
+
+//
+// Define the parameters used to split and to partition the reductions.
+//
+// A row is reduced in at most MLAS_REDUCE_MAXIMUM_BLOCK_COUNT blocks of at
+// least MLAS_REDUCE_MINIMUM_ROW_BLOCK_SIZE elements, and the rows reduced by
+// MlasReduceColumns in at most MLAS_REDUCE_MAXIMUM_BLOCK_COUNT blocks of at
+// least MLAS_REDUCE_MINIMUM_COLUMNS_ROW_BLOCK_SIZE rows. The partial results
+// of the blocks reduced by other threads are kept on the stack of the calling
+// thread in a buffer of MLAS_REDUCE_MAXIMUM_PARTIAL_COUNT elements.
+//
+
+constexpr size_t MLAS_REDUCE_MAXIMUM_BLOCK_COUNT = 64;
+constexpr size_t MLAS_REDUCE_MINIMUM_ROW_BLOCK_SIZE = 16384;
+constexpr size_t MLAS_REDUCE_MINIMUM_COLUMNS_ROW_BLOCK_SIZE = 256;
+constexpr size_t MLAS_REDUCE_MAXIMUM_PARTIAL_COUNT = 4096;
+constexpr size_t MLAS_REDUCE_COLUMN_TILE_SIZE = 128;
+constexpr size_t MLAS_REDUCE_MINIMUM_ELEMENTS_PER_THREAD = 16384;
+
+//
+// The arg reduction kernels track indices in floating point lanes, so split
+// the reduced axis in chunks with exactly representable indices.
+//
+
+constexpr size_t MLAS_ARG_REDUCE_MAXIMUM_CHUNK_SIZE = size_t(1) << 22;
+
+MLAS_FORCEINLINE
+size_t
+MlasReduceBlockSize(
+    size_t Length,
+    size_t MinimumBlockSize
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the size of the blocks that split a reduction.
+
+Arguments:
+
+    Length - Supplies the length of the reduced axis.
+
+    MinimumBlockSize - Supplies the minimum size of a block.
+
+Return Value:
+
+    Returns the block size, which only depends on the arguments.
+
+--*/
+{
+    size_t BlockSize = MlasDivRoundup(Length, MLAS_REDUCE_MAXIMUM_BLOCK_COUNT);
+
+    return std::max(BlockSize, MinimumBlockSize);
+}
+
+MLAS_FORCEINLINE
+ptrdiff_t
+MlasReduceThreadCount(
+    size_t WorkCount,
+    size_t ElementCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of threads to use for a reduction.
+
+Arguments:
+
+    WorkCount - Supplies the number of independent work items.
+
+    ElementCount - Supplies the total number of elements to reduce.
+
+    ThreadPool - Supplies the thread pool object to use.
+
+Return Value:
+
+    Returns the number of threads, limited by the number of work items and
+    by a minimum number of elements per thread.
+
+--*/
+{
+    size_t ThreadCount = size_t(MlasGetMaximumThreadCount(ThreadPool));
+
+    ThreadCount = std::min(ThreadCount, ElementCount / MLAS_REDUCE_MINIMUM_ELEMENTS_PER_THREAD + 1);
+    ThreadCount = std::min(ThreadCount, WorkCount);
+
+    return ptrdiff_t(std::max(ThreadCount, size_t(1)));
+}
+
+void
+MLASCALL
+MlasReduceRows(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t Rows,
+    size_t RowLength,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces each row of a matrix to a single value.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input matrix of Rows x RowLength elements.
+
+    Output - Supplies the output vector of Rows elements.
+
+    Rows - Supplies the number of rows.
+
+    RowLength - Supplies the number of elements of each row, which must be
+        nonzero unless ReduceKind is MlasReduceSum.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Rows == 0) {
+        return;
+    }
+
+    if (RowLength == 0) {
+        if (ReduceKind != MlasReduceSum) {
+            throw std::invalid_argument("Cannot reduce an empty row");
+        }
+        std::fill_n(Output, Rows, 0.0f);
+        return;
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_REDUCE_ROW_FLOAT_KERNEL* ReduceRowKernel = GetMlasPlatform().ReduceRowF32Kernel;
+#else
+    MLAS_REDUCE_ROW_FLOAT_KERNEL* ReduceRowKernel = MlasReduceRowF32Kernel;
+#endif
+
+    const size_t BlockSize = MlasReduceBlockSize(RowLength, MLAS_REDUCE_MINIMUM_ROW_BLOCK_SIZE);
+    const size_t BlockCount = MlasDivRoundup(RowLength, BlockSize);
+
+    //
+    // Sums start from negative zero, which is the identity of addition. The
+    // maximum and minimum start from the first element of the row.
+    //
+
+    auto RowInitial = [&](const float* Row) -> float {
+        return (ReduceKind == MlasReduceSum) ? -0.0f : Row[0];
+    };
+
+    //
+    // Reduce the blocks of the rows on separate threads if there are fewer
+    // rows than threads and the partial results fit the buffer.
+    //
+
+    const size_t PartialCount = Rows * BlockCount;
+
+    const ptrdiff_t ThreadCount = MlasReduceThreadCount(PartialCount, Rows * RowLength, ThreadPool);
+
+    if (BlockCount > 1 && size_t(ThreadCount) > Rows && PartialCount <= MLAS_REDUCE_MAXIMUM_PARTIAL_COUNT) {
+
+        float Partials[MLAS_REDUCE_MAXIMUM_PARTIAL_COUNT];
+
+        MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+            size_t WorkIndex;
+            size_t WorkRemaining;
+
+            MlasPartitionWork(tid, ThreadCount, PartialCount, &WorkIndex, &WorkRemaining);
+
+            while (WorkRemaining-- > 0) {
+
+                const size_t Row = WorkIndex / BlockCount;
+                const size_t Block = WorkIndex % BlockCount;
+                const float* input = Input + Row * RowLength;
+                const size_t Offset = Block * BlockSize;
+
+                Partials[WorkIndex] = ReduceRowKernel(ReduceKind, input + Offset,
+                    std::min(BlockSize, RowLength - Offset), RowInitial(input));
+
+                WorkIndex++;
+            }
+        });
+
+        for (size_t Row = 0; Row < Rows; Row++) {
+
+            const float* partials = Partials + Row * BlockCount;
+            float Accumulator = partials[0];
+
+            for (size_t Block = 1; Block < BlockCount; Block++) {
+                if (ReduceKind == MlasReduceSum) {
+                    Accumulator = MlasReduceCombineScalar<MlasReduceSum>(partials[Block], Accumulator);
+                } else if (ReduceKind == MlasReduceMaximum) {
+                    Accumulator = MlasReduceCombineScalar<MlasReduceMaximum>(partials[Block], Accumulator);
+                } else {
+                    Accumulator = MlasReduceCombineScalar<MlasReduceMinimum>(partials[Block], Accumulator);
+                }
+            }
+
+            Output[Row] = Accumulator;
+        }
+
+        return;
+    }
+
+    MlasTrySimpleParallel(ThreadPool, std::min(ThreadCount, ptrdiff_t(Rows)), [&](ptrdiff_t tid) {
+
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, std::min(ThreadCount, ptrdiff_t(Rows)), Rows, &WorkIndex, &WorkRemaining);
+
+        while (WorkRemaining-- > 0) {
+
+            const float* input = Input + WorkIndex * RowLength;
+            float Accumulator = RowInitial(input);
+
+            for (size_t Offset = 0; Offset < RowLength; Offset += BlockSize) {
+                Accumulator = ReduceRowKernel(ReduceKind, input + Offset,
+                    std::min(BlockSize, RowLength - Offset), Accumulator);
+            }
+
+            Output[WorkIndex] = Accumulator;
+
+            WorkIndex++;
+        }
+    });
+}
+
+void
+MLASCALL
+MlasReduceColumns(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t Batch,
+    size_t Rows,
+    size_t Columns,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the columns of a batch of matrices along the rows.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input matrices of Rows x Columns elements.
+
+    Output - Supplies the output matrix of Batch x Columns elements.
+
+    Batch - Supplies the number of matrices.
+
+    Rows - Supplies the number of rows of each matrix, which must be nonzero
+        unless ReduceKind is MlasReduceSum.
+
+    Columns - Supplies the number of columns of each matrix.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Batch == 0 || Columns == 0) {
+        return;
+    }
+
+    if (Rows == 0) {
+        if (ReduceKind != MlasReduceSum) {
+            throw std::invalid_argument("Cannot reduce an empty column");
+        }
+        std::fill_n(Output, Batch * Columns, 0.0f);
+        return;
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL* ReduceColumnsKernel = GetMlasPlatform().ReduceColumnsF32Kernel;
+#else
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL* ReduceColumnsKernel = MlasReduceColumnsF32Kernel;
+#endif
+
+    const size_t BlockSize = MlasReduceBlockSize(Rows, MLAS_REDUCE_MINIMUM_COLUMNS_ROW_BLOCK_SIZE);
+    const size_t BlockCount = MlasDivRoundup(Rows, BlockSize);
+    const size_t TileCount = MlasDivRoundup(Columns, MLAS_REDUCE_COLUMN_TILE_SIZE);
+    const size_t ElementCount = Batch * Rows * Columns;
+
+    //
+    // Reduce the blocks of rows on separate threads if there are fewer column
+    // tiles than threads and the partial results fit the buffer. The first
+    // block is reduced to the output and the others to the buffer, where the
+    // maximum and minimum are seeded by the first row so that the combined
+    // result matches reducing the blocks in sequence.
+    //
+
+    const size_t TileWorkCount = Batch * TileCount;
+    const size_t PartialCount = Batch * (BlockCount - 1) * Columns;
+
+    ptrdiff_t ThreadCount = MlasReduceThreadCount(TileWorkCount * BlockCount, ElementCount, ThreadPool);
+
+    if (BlockCount > 1 && size_t(ThreadCount) > TileWorkCount && PartialCount <= MLAS_REDUCE_MAXIMUM_PARTIAL_COUNT) {
+
+        float Partials[MLAS_REDUCE_MAXIMUM_PARTIAL_COUNT];
+
+        const size_t WorkCount = TileWorkCount * BlockCount;
+
+        MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+            size_t WorkIndex;
+            size_t WorkRemaining;
+
+            MlasPartitionWork(tid, ThreadCount, WorkCount, &WorkIndex, &WorkRemaining);
+
+            while (WorkRemaining-- > 0) {
+
+                const size_t Block = WorkIndex % BlockCount;
+                const size_t Tile = (WorkIndex / BlockCount) % TileCount;
+                const size_t b = WorkIndex / (BlockCount * TileCount);
+
+                const size_t Column = Tile * MLAS_REDUCE_COLUMN_TILE_SIZE;
+                const size_t TileColumns = std::min(MLAS_REDUCE_COLUMN_TILE_SIZE, Columns - Column);
+                const size_t Row = Block * BlockSize;
+                const float* input = Input + b * Rows * Columns + Column;
+
+                if (Block == 0) {
+
+                    ReduceColumnsKernel(ReduceKind, input, Output + b * Columns + Column,
+                        std::min(BlockSize, Rows), TileColumns, Columns, false);
+
+                } else {
+
+                    float* partial = Partials + (b * (BlockCount - 1) + (Block - 1)) * Columns + Column;
+                    bool Accumulate = false;
+
+                    if (ReduceKind != MlasReduceSum) {
+                        std::copy_n(input, TileColumns, partial);
+                        Accumulate = true;
+                    }
+
+                    ReduceColumnsKernel(ReduceKind, input + Row * Columns, partial,
+                        std::min(BlockSize, Rows - Row), TileColumns, Columns, Accumulate);
+                }
+
+                WorkIndex++;
+            }
+        });
+
+        ThreadCount = std::min(ThreadCount, ptrdiff_t(TileWorkCount));
+
+        MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+            size_t WorkIndex;
+            size_t WorkRemaining;
+
+            MlasPartitionWork(tid, ThreadCount, TileWorkCount, &WorkIndex, &WorkRemaining);
+
+            while (WorkRemaining-- > 0) {
+
+                const size_t Tile = WorkIndex % TileCount;
+                const size_t b = WorkIndex / TileCount;
+
+                const size_t Column = Tile * MLAS_REDUCE_COLUMN_TILE_SIZE;
+                const size_t TileColumns = std::min(MLAS_REDUCE_COLUMN_TILE_SIZE, Columns - Column);
+
+                for (size_t Block = 1; Block < BlockCount; Block++) {
+                    const float* partial = Partials + (b * (BlockCount - 1) + (Block - 1)) * Columns + Column;
+                    ReduceColumnsKernel(ReduceKind, partial, Output + b * Columns + Column, 1, TileColumns,
+                        Columns, true);
+                }
+
+                WorkIndex++;
+            }
+        });
+
+        return;
+    }
+
+    ThreadCount = std::min(ThreadCount, ptrdiff_t(TileWorkCount));
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, ThreadCount, TileWorkCount, &WorkIndex, &WorkRemaining);
+
+        while (WorkRemaining-- > 0) {
+
+            const size_t Tile = WorkIndex % TileCount;
+            const size_t b = WorkIndex / TileCount;
+
+            const size_t Column = Tile * MLAS_REDUCE_COLUMN_TILE_SIZE;
+            const size_t TileColumns = std::min(MLAS_REDUCE_COLUMN_TILE_SIZE, Columns - Column);
+            const float* input = Input + b * Rows * Columns + Column;
+            float* output = Output + b * Columns + Column;
+
+            for (size_t Row = 0; Row < Rows; Row += BlockSize) {
+                ReduceColumnsKernel(ReduceKind, input + Row * Columns, output, std::min(BlockSize, Rows - Row),
+                    TileColumns, Columns, Row > 0);
+            }
+
+            WorkIndex++;
+        }
+    });
+}
+
+void
+MLASCALL
+MlasArgReduceRows(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    int64_t* Output,
+    size_t Rows,
+    size_t RowLength,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine finds the index of the maximum or minimum element of each row
+    of a matrix.
+
+Arguments:
+
+    ReduceKind - Supplies MlasReduceMaximum or MlasReduceMinimum.
+
+    SelectLastIndex - Supplies true to select the last index of ties, else
+        the first index is selected.
+
+    Input - Supplies the input matrix of Rows x RowLength elements.
+
+    Output - Supplies the output vector of Rows indices.
+
+    Rows - Supplies the number of rows.
+
+    RowLength - Supplies the number of elements of each row, which must be
+        nonzero.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Rows == 0) {
+        return;
+    }
+
+    if (RowLength == 0) {
+        throw std::invalid_argument("Cannot reduce an empty row");
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_ARG_REDUCE_ROW_FLOAT_KERNEL* ArgReduceRowKernel = GetMlasPlatform().ArgReduceRowF32Kernel;
+#else
+    MLAS_ARG_REDUCE_ROW_FLOAT_KERNEL* ArgReduceRowKernel = MlasArgReduceRowF32Kernel;
+#endif
+
+    const ptrdiff_t ThreadCount = MlasReduceThreadCount(Rows, Rows * RowLength, ThreadPool);
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, ThreadCount, Rows, &WorkIndex, &WorkRemaining);
+
+        while (WorkRemaining-- > 0) {
+
+            const float* input = Input + WorkIndex * RowLength;
+            float Value = input[0];
+            int64_t Index = 0;
+
+            for (size_t Offset = 0; Offset < RowLength; Offset += MLAS_ARG_REDUCE_MAXIMUM_CHUNK_SIZE) {
+
+                const ptrdiff_t ChunkIndex = ArgReduceRowKernel(ReduceKind, SelectLastIndex, input + Offset,
+                    std::min(MLAS_ARG_REDUCE_MAXIMUM_CHUNK_SIZE, RowLength - Offset), &Value);
+
+                if (ChunkIndex >= 0) {
+                    Index = int64_t(Offset) + ChunkIndex;
+                }
+            }
+
+            Output[WorkIndex] = Index;
+
+            WorkIndex++;
+        }
+    });
+}
+
+void
+MLASCALL
+MlasArgReduceColumns(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    int64_t* Output,
+    size_t Batch,
+    size_t Rows,
+    size_t Columns,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine finds the row index of the maximum or minimum element of the
+    columns of a batch of matrices.
+
+Arguments:
+
+    ReduceKind - Supplies MlasReduceMaximum or MlasReduceMinimum.
+
+    SelectLastIndex - Supplies true to select the last index of ties, else
+        the first index is selected.
+
+    Input - Supplies the input matrices of Rows x Columns elements.
+
+    Output - Supplies the output matrix of Batch x Columns indices.
+
+    Batch - Supplies the number of matrices.
+
+    Rows - Supplies the number of rows of each matrix, which must be nonzero.
+
+    Columns - Supplies the number of columns of each matrix.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Batch == 0 || Columns == 0) {
+        return;
+    }
+
+    if (Rows == 0) {
+        throw std::invalid_argument("Cannot reduce an empty column");
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_ARG_REDUCE_COLUMNS_FLOAT_KERNEL* ArgReduceColumnsKernel = GetMlasPlatform().ArgReduceColumnsF32Kernel;
+#else
+    MLAS_ARG_REDUCE_COLUMNS_FLOAT_KERNEL* ArgReduceColumnsKernel = MlasArgReduceColumnsF32Kernel;
+#endif
+
+    const size_t TileCount = MlasDivRoundup(Columns, MLAS_REDUCE_COLUMN_TILE_SIZE);
+    const size_t WorkCount = Batch * TileCount;
+
+    const ptrdiff_t ThreadCount = MlasReduceThreadCount(WorkCount, Batch * Rows * Columns, ThreadPool);
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, ThreadCount, WorkCount, &WorkIndex, &WorkRemaining);
+
+        MLAS_DECLSPEC_ALIGN(float Values[MLAS_REDUCE_COLUMN_TILE_SIZE], 64);
+
+        while (WorkRemaining-- > 0) {
+
+            const size_t Tile = WorkIndex % TileCount;
+            const size_t b = WorkIndex / TileCount;
+
+            const size_t Column = Tile * MLAS_REDUCE_COLUMN_TILE_SIZE;
+            const size_t TileColumns = std::min(MLAS_REDUCE_COLUMN_TILE_SIZE, Columns - Column);
+            const float* input = Input + b * Rows * Columns + Column;
+            int64_t* output = Output + b * Columns + Column;
+
+            //
+            // Start the search from the first row.
+            //
+
+            std::copy_n(input, TileColumns, Values);
+            std::fill_n(output, TileColumns, int64_t(0));
+
+            for (size_t Row = 1; Row < Rows; Row += MLAS_ARG_REDUCE_MAXIMUM_CHUNK_SIZE) {
+                ArgReduceColumnsKernel(ReduceKind, SelectLastIndex, input + Row * Columns, Values, output,
+                    std::min(MLAS_ARG_REDUCE_MAXIMUM_CHUNK_SIZE, Rows - Row), TileColumns, Columns, int64_t(Row));
+            }
+
+            WorkIndex++;
+        }
+    });
+}
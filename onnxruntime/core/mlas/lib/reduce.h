@@ -0,0 +1,722 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce.h
+
+Abstract:
+
+    This module contains the templates shared by the kernels that reduce the
+    rows or the columns of a single precision matrix to their sum, maximum or
+    minimum, or to the index of their maximum or minimum.
+
+    The templates are parameterized by a structure of vector operations so
+    that the same algorithm is instantiated for the base instruction set and
+    for the wider AVX2 and AVX512F vectors in the intrinsics source files.
+
+    The maximum and minimum operations of the structure must return their
+    second operand if either operand is a NaN, so that a NaN only propagates
+    when it seeds the accumulator. The index of an element is tracked in a
+    floating point lane, which is exact for fewer than 2^24 elements.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+//
+// Ascending lane indices, loaded to seed the index vectors of the arg
+// reduction kernels.
+//
+
+inline constexpr float MlasReduceLaneIndices[16] = {
+    0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+    8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f,
+};
+
+template<MLAS_REDUCE_KIND ReduceKind>
+MLAS_FORCEINLINE
+float
+MlasReduceCombineScalar(
+    float Value,
+    float Accumulator
+    )
+{
+    if constexpr (ReduceKind == MlasReduceSum) {
+        return Accumulator + Value;
+    } else if constexpr (ReduceKind == MlasReduceMaximum) {
+        return (Value > Accumulator) ? Value : Accumulator;
+    } else {
+        return (Value < Accumulator) ? Value : Accumulator;
+    }
+}
+
+template<typename Ops, MLAS_REDUCE_KIND ReduceKind>
+MLAS_FORCEINLINE
+typename Ops::FloatVector
+MlasReduceCombine(
+    typename Ops::FloatVector Value,
+    typename Ops::FloatVector Accumulator
+    )
+{
+    if constexpr (ReduceKind == MlasReduceSum) {
+        return Ops::Add(Accumulator, Value);
+    } else if constexpr (ReduceKind == MlasReduceMaximum) {
+        return Ops::Maximum(Value, Accumulator);
+    } else {
+        return Ops::Minimum(Value, Accumulator);
+    }
+}
+
+template<typename Ops, MLAS_REDUCE_KIND ReduceKind>
+float
+MlasReduceRowKernel(
+    const float* Input,
+    size_t N,
+    float Initial
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a vector and combines the result with an initial
+    value.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process.
+
+    Initial - Supplies the value to combine with the elements. Sums are
+        accumulated separately and added to the initial value.
+
+Return Value:
+
+    Returns the reduced value.
+
+--*/
+{
+    constexpr size_t VectorLength = Ops::VectorLength;
+
+    const float Seed = (ReduceKind == MlasReduceSum) ? 0.0f : Initial;
+
+    auto Accumulator0 = Ops::Broadcast(Seed);
+    auto Accumulator1 = Accumulator0;
+    auto Accumulator2 = Accumulator0;
+    auto Accumulator3 = Accumulator0;
+
+    while (N >= VectorLength * 4) {
+
+        Accumulator0 = MlasReduceCombine<Ops, ReduceKind>(Ops::Load(Input), Accumulator0);
+        Accumulator1 = MlasReduceCombine<Ops, ReduceKind>(Ops::Load(Input + VectorLength), Accumulator1);
+        Accumulator2 = MlasReduceCombine<Ops, ReduceKind>(Ops::Load(Input + VectorLength * 2), Accumulator2);
+        Accumulator3 = MlasReduceCombine<Ops, ReduceKind>(Ops::Load(Input + VectorLength * 3), Accumulator3);
+
+        Input += VectorLength * 4;
+        N -= VectorLength * 4;
+    }
+
+    while (N >= VectorLength) {
+
+        Accumulator0 = MlasReduceCombine<Ops, ReduceKind>(Ops::Load(Input), Accumulator0);
+
+        Input += VectorLength;
+        N -= VectorLength;
+    }
+
+    Accumulator0 = MlasReduceCombine<Ops, ReduceKind>(Accumulator1, Accumulator0);
+    Accumulator2 = MlasReduceCombine<Ops, ReduceKind>(Accumulator3, Accumulator2);
+    Accumulator0 = MlasReduceCombine<Ops, ReduceKind>(Accumulator2, Accumulator0);
+
+    MLAS_DECLSPEC_ALIGN(float Buffer[VectorLength], 64);
+
+    Ops::Store(Buffer, Accumulator0);
+
+    float Accumulator = Buffer[0];
+
+    for (size_t n = 1; n < VectorLength; n++) {
+        Accumulator = MlasReduceCombineScalar<ReduceKind>(Buffer[n], Accumulator);
+    }
+
+    while (N > 0) {
+        Accumulator = MlasReduceCombineScalar<ReduceKind>(*Input++, Accumulator);
+        N--;
+    }
+
+    if constexpr (ReduceKind == MlasReduceSum) {
+        return Initial + Accumulator;
+    } else {
+        return Accumulator;
+    }
+}
+
+template<typename Ops, MLAS_REDUCE_KIND ReduceKind, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasReduceColumnsBlock(
+    const float* Input,
+    float* Output,
+    size_t Rows,
+    size_t ldInput,
+    bool Accumulate
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces VectorCount vectors of columns along the rows.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    Output - Supplies the output vectors.
+
+    Rows - Supplies the number of rows to reduce, which must be nonzero.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    Accumulate - Supplies true to combine the reduced rows with the output.
+        Sums of the rows are accumulated separately and added to the output,
+        while the maximum and minimum are seeded by the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorLength = Ops::VectorLength;
+
+    typename Ops::FloatVector Accumulator[VectorCount];
+
+    size_t Row = 0;
+
+    if (Accumulate && ReduceKind != MlasReduceSum) {
+
+        for (size_t i = 0; i < VectorCount; i++) {
+            Accumulator[i] = Ops::Load(Output + i * VectorLength);
+        }
+
+    } else {
+
+        for (size_t i = 0; i < VectorCount; i++) {
+            Accumulator[i] = Ops::Load(Input + i * VectorLength);
+        }
+
+        Row = 1;
+    }
+
+    for (; Row < Rows; Row++) {
+
+        const float* input = Input + Row * ldInput;
+
+        for (size_t i = 0; i < VectorCount; i++) {
+            Accumulator[i] = MlasReduceCombine<Ops, ReduceKind>(Ops::Load(input + i * VectorLength), Accumulator[i]);
+        }
+    }
+
+    if (Accumulate && ReduceKind == MlasReduceSum) {
+
+        for (size_t i = 0; i < VectorCount; i++) {
+            Accumulator[i] = Ops::Add(Ops::Load(Output + i * VectorLength), Accumulator[i]);
+        }
+    }
+
+    for (size_t i = 0; i < VectorCount; i++) {
+        Ops::Store(Output + i * VectorLength, Accumulator[i]);
+    }
+}
+
+template<typename Ops, MLAS_REDUCE_KIND ReduceKind>
+void
+MlasReduceColumnsKernel(
+    const float* Input,
+    float* Output,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    bool Accumulate
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the columns of a matrix along the rows. Each column
+    is reduced in the order of the rows.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    Output - Supplies the output vector of Columns elements.
+
+    Rows - Supplies the number of rows to reduce, which must be nonzero.
+
+    Columns - Supplies the number of columns to reduce.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    Accumulate - Supplies true to combine the reduced rows with the output,
+        see MlasReduceColumnsBlock.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorLength = Ops::VectorLength;
+
+    while (Columns >= VectorLength * 4) {
+
+        MlasReduceColumnsBlock<Ops, ReduceKind, 4>(Input, Output, Rows, ldInput, Accumulate);
+
+        Input += VectorLength * 4;
+        Output += VectorLength * 4;
+        Columns -= VectorLength * 4;
+    }
+
+    while (Columns >= VectorLength) {
+
+        MlasReduceColumnsBlock<Ops, ReduceKind, 1>(Input, Output, Rows, ldInput, Accumulate);
+
+        Input += VectorLength;
+        Output += VectorLength;
+        Columns -= VectorLength;
+    }
+
+    for (size_t Column = 0; Column < Columns; Column++) {
+
+        size_t Row = 0;
+        float Accumulator;
+
+        if (Accumulate && ReduceKind != MlasReduceSum) {
+            Accumulator = Output[Column];
+        } else {
+            Accumulator = Input[Column];
+            Row = 1;
+        }
+
+        for (; Row < Rows; Row++) {
+            Accumulator = MlasReduceCombineScalar<ReduceKind>(Input[Row * ldInput + Column], Accumulator);
+        }
+
+        if (Accumulate && ReduceKind == MlasReduceSum) {
+            Accumulator = Output[Column] + Accumulator;
+        }
+
+        Output[Column] = Accumulator;
+    }
+}
+
+template<bool IsMaximum, bool SelectLastIndex>
+MLAS_FORCEINLINE
+bool
+MlasArgReduceSelectScalar(
+    float Value,
+    float Best
+    )
+{
+    if constexpr (IsMaximum) {
+        return SelectLastIndex ? (Value >= Best) : (Value > Best);
+    } else {
+        return SelectLastIndex ? (Value <= Best) : (Value < Best);
+    }
+}
+
+template<typename Ops, bool IsMaximum, bool SelectLastIndex>
+MLAS_FORCEINLINE
+auto
+MlasArgReduceSelect(
+    typename Ops::FloatVector Value,
+    typename Ops::FloatVector Best
+    )
+{
+    if constexpr (IsMaximum) {
+        return SelectLastIndex ? Ops::GreaterThanOrEqual(Value, Best) : Ops::GreaterThan(Value, Best);
+    } else {
+        return SelectLastIndex ? Ops::GreaterThanOrEqual(Best, Value) : Ops::GreaterThan(Best, Value);
+    }
+}
+
+template<typename Ops, bool IsMaximum, bool SelectLastIndex>
+ptrdiff_t
+MlasArgReduceRowKernel(
+    const float* Input,
+    size_t N,
+    float* Value
+    )
+/*++
+
+Routine Description:
+
+    This routine finds the index of the maximum or minimum element of a
+    vector, continuing a search that found the supplied value so far.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements to process, which must be less than
+        2^24.
+
+    Value - Supplies the best value found so far, and receives the best value
+        found including the input vector.
+
+Return Value:
+
+    Returns the index of the selected element of the input vector, or -1 if
+    no element of the input vector replaces the supplied value.
+
+--*/
+{
+    constexpr size_t VectorLength = Ops::VectorLength;
+
+    float BestValue = *Value;
+    ptrdiff_t BestIndex = -1;
+    size_t Index = 0;
+
+    if (N >= VectorLength) {
+
+        auto Best = Ops::Broadcast(BestValue);
+        auto BestIndexVector = Ops::Broadcast(-1.0f);
+        auto IndexVector = Ops::Load(MlasReduceLaneIndices);
+        const auto Increment = Ops::Broadcast(float(VectorLength));
+
+        do {
+
+            const auto Vector = Ops::Load(Input + Index);
+            const auto Mask = MlasArgReduceSelect<Ops, IsMaximum, SelectLastIndex>(Vector, Best);
+
+            Best = Ops::Blend(Best, Vector, Mask);
+            BestIndexVector = Ops::Blend(BestIndexVector, IndexVector, Mask);
+            IndexVector = Ops::Add(IndexVector, Increment);
+
+            Index += VectorLength;
+
+        } while (Index + VectorLength <= N);
+
+        MLAS_DECLSPEC_ALIGN(float LaneValue[VectorLength], 64);
+        MLAS_DECLSPEC_ALIGN(float LaneIndex[VectorLength], 64);
+
+        Ops::Store(LaneValue, Best);
+        Ops::Store(LaneIndex, BestIndexVector);
+
+        //
+        // A lane that selected an element holds a value that replaces the
+        // supplied value. Combine the lanes so that ties select the first or
+        // the last index.
+        //
+
+        for (size_t n = 0; n < VectorLength; n++) {
+
+            if (LaneIndex[n] < 0.0f) {
+                continue;
+            }
+
+            const ptrdiff_t LaneElementIndex = ptrdiff_t(LaneIndex[n]);
+
+            bool Replace;
+
+            if (BestIndex < 0) {
+                Replace = true;
+            } else if (LaneValue[n] == BestValue) {
+                Replace = SelectLastIndex ? (LaneElementIndex > BestIndex) : (LaneElementIndex < BestIndex);
+            } else {
+                Replace = MlasArgReduceSelectScalar<IsMaximum, false>(LaneValue[n], BestValue);
+            }
+
+            if (Replace) {
+                BestValue = LaneValue[n];
+                BestIndex = LaneElementIndex;
+            }
+        }
+    }
+
+    for (; Index < N; Index++) {
+
+        if (MlasArgReduceSelectScalar<IsMaximum, SelectLastIndex>(Input[Index], BestValue)) {
+            BestValue = Input[Index];
+            BestIndex = ptrdiff_t(Index);
+        }
+    }
+
+    *Value = BestValue;
+
+    return BestIndex;
+}
+
+template<typename Ops, bool IsMaximum, bool SelectLastIndex, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasArgReduceColumnsBlock(
+    const float* Input,
+    float* Values,
+    int64_t* Indices,
+    size_t Rows,
+    size_t ldInput,
+    int64_t RowBase
+    )
+/*++
+
+Routine Description:
+
+    This routine continues the search for the index of the maximum or
+    minimum element of VectorCount vectors of columns.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    Values - Supplies the best values found so far, and receives the best
+        values found including the input rows.
+
+    Indices - Receives the row index of the best value for each column that
+        selects an element of the input rows.
+
+    Rows - Supplies the number of rows to process, which must be less than
+        2^24.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    RowBase - Supplies the row index of the first input row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorLength = Ops::VectorLength;
+
+    typename Ops::FloatVector Best[VectorCount];
+    typename Ops::FloatVector BestIndex[VectorCount];
+
+    for (size_t i = 0; i < VectorCount; i++) {
+        Best[i] = Ops::Load(Values + i * VectorLength);
+        BestIndex[i] = Ops::Broadcast(-1.0f);
+    }
+
+    auto RowIndex = Ops::Broadcast(0.0f);
+    const auto Increment = Ops::Broadcast(1.0f);
+
+    for (size_t Row = 0; Row < Rows; Row++) {
+
+        const float* input = Input + Row * ldInput;
+
+        for (size_t i = 0; i < VectorCount; i++) {
+
+            const auto Vector = Ops::Load(input + i * VectorLength);
+            const auto Mask = MlasArgReduceSelect<Ops, IsMaximum, SelectLastIndex>(Vector, Best[i]);
+
+            Best[i] = Ops::Blend(Best[i], Vector, Mask);
+            BestIndex[i] = Ops::Blend(BestIndex[i], RowIndex, Mask);
+        }
+
+        RowIndex = Ops::Add(RowIndex, Increment);
+    }
+
+    MLAS_DECLSPEC_ALIGN(float LaneIndex[VectorLength], 64);
+
+    for (size_t i = 0; i < VectorCount; i++) {
+
+        Ops::Store(Values + i * VectorLength, Best[i]);
+        Ops::Store(LaneIndex, BestIndex[i]);
+
+        for (size_t n = 0; n < VectorLength; n++) {
+            if (LaneIndex[n] >= 0.0f) {
+                Indices[i * VectorLength + n] = RowBase + int64_t(LaneIndex[n]);
+            }
+        }
+    }
+}
+
+template<typename Ops, bool IsMaximum, bool SelectLastIndex>
+void
+MlasArgReduceColumnsKernel(
+    const float* Input,
+    float* Values,
+    int64_t* Indices,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    int64_t RowBase
+    )
+/*++
+
+Routine Description:
+
+    This routine continues the search for the index of the maximum or
+    minimum element of the columns of a matrix.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    Values - Supplies the best values found so far, and receives the best
+        values found including the input rows.
+
+    Indices - Receives the row index of the best value for each column that
+        selects an element of the input rows.
+
+    Rows - Supplies the number of rows to process, which must be less than
+        2^24.
+
+    Columns - Supplies the number of columns to process.
+
+    ldInput - Supplies the first dimension of the input matrix.
+
+    RowBase - Supplies the row index of the first input row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorLength = Ops::VectorLength;
+
+    while (Columns >= VectorLength * 4) {
+
+        MlasArgReduceColumnsBlock<Ops, IsMaximum, SelectLastIndex, 4>(Input, Values, Indices, Rows, ldInput, RowBase);
+
+        Input += VectorLength * 4;
+        Values += VectorLength * 4;
+        Indices += VectorLength * 4;
+        Columns -= VectorLength * 4;
+    }
+
+    while (Columns >= VectorLength) {
+
+        MlasArgReduceColumnsBlock<Ops, IsMaximum, SelectLastIndex, 1>(Input, Values, Indices, Rows, ldInput, RowBase);
+
+        Input += VectorLength;
+        Values += VectorLength;
+        Indices += VectorLength;
+        Columns -= VectorLength;
+    }
+
+    for (size_t Column = 0; Column < Columns; Column++) {
+
+        for (size_t Row = 0; Row < Rows; Row++) {
+
+            const float Value = Input[Row * ldInput + Column];
+
+            if (MlasArgReduceSelectScalar<IsMaximum, SelectLastIndex>(Value, Values[Column])) {
+                Values[Column] = Value;
+                Indices[Column] = RowBase + int64_t(Row);
+            }
+        }
+    }
+}
+
+//
+// Dispatch the reduction kind to the kernel instantiations.
+//
+
+template<typename Ops>
+float
+MlasReduceRowDispatch(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    size_t N,
+    float Initial
+    )
+{
+    switch (ReduceKind) {
+        case MlasReduceSum:
+            return MlasReduceRowKernel<Ops, MlasReduceSum>(Input, N, Initial);
+        case MlasReduceMaximum:
+            return MlasReduceRowKernel<Ops, MlasReduceMaximum>(Input, N, Initial);
+        case MlasReduceMinimum:
+            return MlasReduceRowKernel<Ops, MlasReduceMinimum>(Input, N, Initial);
+        default:
+            throw std::invalid_argument("Unsupported reduction kind");
+    }
+}
+
+template<typename Ops>
+void
+MlasReduceColumnsDispatch(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    bool Accumulate
+    )
+{
+    switch (ReduceKind) {
+        case MlasReduceSum:
+            MlasReduceColumnsKernel<Ops, MlasReduceSum>(Input, Output, Rows, Columns, ldInput, Accumulate);
+            break;
+        case MlasReduceMaximum:
+            MlasReduceColumnsKernel<Ops, MlasReduceMaximum>(Input, Output, Rows, Columns, ldInput, Accumulate);
+            break;
+        case MlasReduceMinimum:
+            MlasReduceColumnsKernel<Ops, MlasReduceMinimum>(Input, Output, Rows, Columns, ldInput, Accumulate);
+            break;
+        default:
+            throw std::invalid_argument("Unsupported reduction kind");
+    }
+}
+
+template<typename Ops>
+ptrdiff_t
+MlasArgReduceRowDispatch(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    size_t N,
+    float* Value
+    )
+{
+    if (ReduceKind == MlasReduceMaximum) {
+        return SelectLastIndex ? MlasArgReduceRowKernel<Ops, true, true>(Input, N, Value)
+                               : MlasArgReduceRowKernel<Ops, true, false>(Input, N, Value);
+    } else if (ReduceKind == MlasReduceMinimum) {
+        return SelectLastIndex ? MlasArgReduceRowKernel<Ops, false, true>(Input, N, Value)
+                               : MlasArgReduceRowKernel<Ops, false, false>(Input, N, Value);
+    } else {
+        throw std::invalid_argument("Unsupported arg reduction kind");
+    }
+}
+
+template<typename Ops>
+void
+MlasArgReduceColumnsDispatch(
+    MLAS_REDUCE_KIND ReduceKind,
+    bool SelectLastIndex,
+    const float* Input,
+    float* Values,
+    int64_t* Indices,
+    size_t Rows,
+    size_t Columns,
+    size_t ldInput,
+    int64_t RowBase
+    )
+{
+    if (ReduceKind == MlasReduceMaximum) {
+        if (SelectLastIndex) {
+            MlasArgReduceColumnsKernel<Ops, true, true>(Input, Values, Indices, Rows, Columns, ldInput, RowBase);
+        } else {
+            MlasArgReduceColumnsKernel<Ops, true, false>(Input, Values, Indices, Rows, Columns, ldInput, RowBase);
+        }
+    } else if (ReduceKind == MlasReduceMinimum) {
+        if (SelectLastIndex) {
+            MlasArgReduceColumnsKernel<Ops, false, true>(Input, Values, Indices, Rows, Columns, ldInput, RowBase);
+        } else {
+            MlasArgReduceColumnsKernel<Ops, false, false>(Input, Values, Indices, Rows, Columns, ldInput, RowBase);
+        }
+    } else {
+        throw std::invalid_argument("Unsupported arg reduction kind");
+    }
+}
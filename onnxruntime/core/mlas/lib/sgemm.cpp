@@ -1079,6 +1079,65 @@ Return Value:
     return C;
 }
 
+MLAS_FORCEINLINE
+bool
+MlasSgemmTuningHasValidStrides(
+    const MLAS_SGEMM_TUNING_PARAMS* Tuning,
+    CBLAS_TRANSPOSE TransA
+    )
+/*++
+
+Routine Description:
+
+    This routine determines whether the tuning parameters supply B panel
+    strides that fit the local buffers of MlasSgemmOperation.
+
+Arguments:
+
+    Tuning - Supplies the optional tuning parameters.
+
+    TransA - Supplies the transpose operation for matrix A.
+
+Return Value:
+
+    Returns true if the strides of the tuning parameters should be used.
+
+--*/
+{
+    if (Tuning == nullptr || Tuning->StrideN == 0 || Tuning->StrideK == 0) {
+        return false;
+    }
+
+    if (Tuning->StrideN % 16 != 0 ||
+        Tuning->StrideN > MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK / Tuning->StrideK) {
+        return false;
+    }
+
+    //
+    // The A panel used for transposing is sized for the default K stride.
+    //
+
+    return TransA == CblasNoTrans || Tuning->StrideK <= MLAS_SGEMM_STRIDEK;
+}
+
+size_t
+MLASCALL
+MlasSgemmTuningMaximumPanelSize(
+    void
+    )
+{
+    return MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK;
+}
+
+size_t
+MLASCALL
+MlasSgemmTuningMaximumStrideK(
+    void
+    )
+{
+    return MLAS_SGEMM_STRIDEK;
+}
+
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -1093,7 +1152,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_TUNING_PARAMS* Tuning
     )
 /*++
 
@@ -1131,6 +1191,9 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Tuning - Optionally supplies the strides of the B panel to use instead of
+        the default heuristic.
+
 Return Value:
 
     None.
@@ -1223,7 +1286,12 @@ Return Value:
     size_t StrideN = MLAS_SGEMM_STRIDEN;
     size_t StrideK = MLAS_SGEMM_STRIDEK;
 
-    if (N >= K) {
+    if (MlasSgemmTuningHasValidStrides(Tuning, TransA)) {
+
+        StrideN = Tuning->StrideN;
+        StrideK = Tuning->StrideK;
+
+    } else if (N >= K) {
 
         while (StrideK / 2 >= K) {
             StrideN *= 2;
@@ -1549,9 +1617,198 @@ Return Value:
         const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc,
+            DataParams->Tuning);
+    }
+
+    //
+    // Apply the optional activation while the block of matrix C computed by
+    // this thread is still resident in the cache.
+    //
+
+    if (DataParams->Activation != nullptr && RangeCountM > 0 && RangeCountN > 0) {
+        MlasActivation(DataParams->Activation, C, nullptr, RangeCountM, RangeCountN, ldc);
+    }
+}
+const MLAS_SGEMM_DATA_PARAMS*
+MlasSgemmSelectNumaLocalB(
+    const MLAS_SGEMM_DATA_PARAMS* DataParams,
+    MLAS_SGEMM_DATA_PARAMS* NumaLocalDataParams,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the copy of matrix B on the NUMA node of the worker
+    thread, if there is one.
+
+Arguments:
+
+    DataParams - Supplies the data position and layout of the matrices.
+
+    NumaLocalDataParams - Supplies the storage for the parameters that refer
+        to the local copy of matrix B.
+
+    ThreadPool - Supplies the thread pool running the worker thread.
+
+Return Value:
+
+    Returns the parameters to use for the operation.
+
+--*/
+{
+    if (DataParams->BNumaReplicaCount > 0) {
+
+        const ptrdiff_t NumaNode = MlasGetCurrentNumaNode(ThreadPool);
+
+        if (NumaNode >= 0 && size_t(NumaNode) < DataParams->BNumaReplicaCount &&
+            DataParams->BNumaReplicas[NumaNode] != nullptr) {
+            *NumaLocalDataParams = *DataParams;
+            NumaLocalDataParams->B = DataParams->BNumaReplicas[NumaNode];
+            return NumaLocalDataParams;
+        }
+    }
+
+    return DataParams;
+}
+
+void
+MlasSgemmBatchThreaded(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    operations of a batched SGEMM, each as a whole.
+
+    If matrix B fits in a single local packed panel, the panel is reused by
+    the consecutive operations that share matrix B, such as the operations
+    of a batch that broadcasts matrix B.
+
+Arguments:
+
+    TransA - Supplies the transpose operation on A matrix
+
+    TransB - Supplies the transpose operation on B matrix
+
+    M, N, K - Supplies the shape of the multiplication
+
+    Data - Supplies the data position and layout of the matrices of the
+        operations in the range.
+
+    BatchCount - Supplies the number of operations in the range.
+
+    ThreadPool - Supplies the thread pool running the worker thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    //
+    // A single row of matrix A does not reference the data from matrix B
+    // multiple times, so the single row kernels are used instead.
+    //
+
+    const size_t AlignedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) &
+        ~(size_t(MLAS_SGEMM_STRIDEN_THREAD_ALIGN) - 1);
+
+    const bool UsePanel = M > 1 && N > 0 && K > 0 &&
+        AlignedN * K <= MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK &&
+        (TransA == CblasNoTrans || K <= MLAS_SGEMM_STRIDEK);
+
+    const float* PanelSourceB = nullptr;
+    size_t PanelSourceLdb = 0;
+
+    for (size_t BatchIdx = 0; BatchIdx < BatchCount; BatchIdx++) {
+
+        const MLAS_SGEMM_DATA_PARAMS* DataParams = &Data[BatchIdx];
+
+        if (DataParams->BIsPacked || !UsePanel) {
+
+            MLAS_SGEMM_DATA_PARAMS NumaLocalDataParams;
+
+            DataParams = MlasSgemmSelectNumaLocalB(DataParams, &NumaLocalDataParams, ThreadPool);
+
+            MlasSgemmThreaded(1, 1, TransA, TransB, M, N, K, DataParams, 0);
+            continue;
+        }
+
+        const float* B = DataParams->B;
+        const size_t ldb = DataParams->ldb;
+
+        //
+        // Copy or transpose matrix B to the local packed buffer unless it
+        // already holds the same matrix.
+        //
+
+        if (B != PanelSourceB || ldb != PanelSourceLdb) {
+
+            if (TransB == CblasNoTrans) {
+                MlasSgemmCopyPackB(PanelB, B, ldb, N, K);
+            } else {
+                MlasSgemmTransposePackB(PanelB, B, ldb, N, K);
+            }
+
+            PanelSourceB = B;
+            PanelSourceLdb = ldb;
+        }
+
+        const float alpha = DataParams->alpha;
+        const float beta = DataParams->beta;
+        const size_t lda = DataParams->lda;
+        const size_t ldc = DataParams->ldc;
+        float* C = DataParams->C;
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        }
+
+        const bool ZeroMode = (beta == 0.0f);
+
+        if (TransA == CblasNoTrans) {
+
+            MlasSgemmKernelLoop(DataParams->A, PanelB, C, K, M, N, lda, ldc, alpha, ZeroMode);
+
+        } else {
+
+            const float* a = DataParams->A;
+            float* c = C;
+            size_t RowsRemaining = M;
+
+            while (RowsRemaining > 0) {
+
+                size_t RowsTransposed = std::min(RowsRemaining, size_t(MLAS_SGEMM_TRANSA_ROWS));
+
+                MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, K);
+
+                RowsRemaining -= RowsTransposed;
+                a += RowsTransposed;
+
+                c = MlasSgemmKernelLoop(PanelA, PanelB, c, K, RowsTransposed, N, K, ldc, alpha, ZeroMode);
+            }
+        }
+
+        if (DataParams->Activation != nullptr) {
+            MlasActivation(DataParams->Activation, C, nullptr, M, N, ldc);
+        }
     }
 }
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(push)
 // Chance of arithmetic overflow could be reduced
@@ -1572,11 +1829,12 @@ MlasGemmBatch(
 {
 
     //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
+    // Compute the number of target threads given the complexity of the batch
+    // of SGEMM operations. Small requests should run using the single
+    // threaded path.
     //
 
-    const double Complexity = double(M) * double(N) * double(K);
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchSize);
 
     ptrdiff_t TargetThreadCount;
 
@@ -1592,8 +1850,41 @@ MlasGemmBatch(
         TargetThreadCount = MaximumThreadCount;
     }
 
+    const MLAS_SGEMM_TUNING_PARAMS* Tuning = Data[0].Tuning;
+
+    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    const bool UseTunedPartition = Tuning != nullptr &&
+        Tuning->ThreadCountM > 0 && Tuning->ThreadCountN > 0 &&
+        Tuning->ThreadCountM <= std::max(M, size_t(1)) && Tuning->ThreadCountN <= BlockedN &&
+        Tuning->ThreadCountM * Tuning->ThreadCountN <= size_t(MaximumThreadCount);
+
+    //
+    // Segment the batch across the threads if there are enough operations to
+    // keep the threads busy. Each thread runs a contiguous range of whole
+    // operations, which avoids the scheduling cost of many small work items
+    // and lets consecutive operations share a packed panel of matrix B.
+    //
+
+    if (!UseTunedPartition && BatchSize > 1 && size_t(TargetThreadCount) <= BatchSize) {
+
+        MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [=](ptrdiff_t tid)
+        {
+            size_t BatchStart;
+            size_t BatchCount;
+
+            MlasPartitionWork(tid, TargetThreadCount, BatchSize, &BatchStart, &BatchCount);
+
+            MlasSgemmBatchThreaded(TransA, TransB, M, N, K, Data + BatchStart,
+                BatchCount, ThreadPool);
+        });
+
+        return;
+    }
+
     //
-    // Segment the operation across multiple threads.
+    // Segment each operation across multiple threads.
     //
     // N.B. Currently, the operation is segmented as a 1D partition, which
     // works okay for operations involving skinny matrices.
@@ -1603,10 +1894,18 @@ MlasGemmBatch(
     ptrdiff_t ThreadCountM;
     ptrdiff_t ThreadCountN;
 
-    if (N > M) {
+    if (UseTunedPartition) {
 
-        const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
-            MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+        //
+        // Use the partition supplied by the tuning parameters, which may also
+        // split the operation along both dimensions.
+        //
+
+        ThreadCountM = ptrdiff_t(Tuning->ThreadCountM);
+        ThreadCountN = ptrdiff_t(Tuning->ThreadCountN);
+        ThreadsPerGemm = ThreadCountM * ThreadCountN;
+
+    } else if (N > M) {
 
         if (size_t(ThreadsPerGemm) > BlockedN) {
             ThreadsPerGemm = ptrdiff_t(BlockedN);
@@ -1631,8 +1930,13 @@ MlasGemmBatch(
     {
         ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
         ptrdiff_t ThreadIdx = tid % ThreadsPerGemm;
+        MLAS_SGEMM_DATA_PARAMS NumaLocalDataParams;
+
+        const MLAS_SGEMM_DATA_PARAMS* DataParams =
+            MlasSgemmSelectNumaLocalB(&(Data[GemmIdx]), &NumaLocalDataParams, ThreadPool);
+
         MlasSgemmThreaded(ThreadCountM, ThreadCountN,
-            TransA, TransB, M, N, K, &(Data[GemmIdx]), ThreadIdx);
+            TransA, TransB, M, N, K, DataParams, ThreadIdx);
     });
 }
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -0,0 +1,632 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with a sparse matrix B.
+
+    Matrix B is packed to the blocks of a single row of BlkN columns that have
+    a nonzero element. The blocks are grouped by panels of BlkN columns and by
+    MLAS_SGEMM_SPARSE_STRIDEK rows, so that each group multiplies a tile of
+    matrix A transposed to MLAS_SGEMM_SPARSE_STRIDEK rows of
+    MLAS_SGEMM_SPARSE_STRIDEM values. The kernels vectorize over the rows of
+    matrix A, so a block costs the same whatever the sparsity pattern of the
+    other columns.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the header of a packed matrix B. The header is followed by the array
+// of ChunkCountK * PanelCount + 1 offsets of the first block of each group,
+// the array of the row index of each block relative to its group and, aligned
+// to MLAS_SGEMM_SPARSE_VALUES_ALIGNMENT bytes, the BlkN values of each block.
+//
+
+struct MLAS_SGEMM_SPARSE_PACKED_B {
+    size_t BlkN;
+    size_t N;
+    size_t K;
+    size_t BlockCount;
+};
+
+#define MLAS_SGEMM_SPARSE_VALUES_ALIGNMENT          64
+
+struct MLAS_SGEMM_SPARSE_PACKED_B_LAYOUT {
+    size_t PanelCount;
+    size_t ChunkCountK;
+    const size_t* GroupOffsets;
+    const uint16_t* BlockRowIndex;
+    const float* BlockValues;
+};
+
+MLAS_FORCEINLINE
+void
+MlasGemmSparseValidateBlkN(
+    size_t BlkN
+    )
+{
+    if (BlkN != 1 && BlkN != 4) {
+#ifdef MLAS_NO_EXCEPTION
+        abort();
+#else
+        throw std::invalid_argument("Unsupported sparse block size");
+#endif
+    }
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasGemmSparseValuesOffset(
+    size_t PanelCount,
+    size_t ChunkCountK,
+    size_t BlockCount
+    )
+{
+    size_t Offset = sizeof(MLAS_SGEMM_SPARSE_PACKED_B);
+
+    Offset += (ChunkCountK * PanelCount + 1) * sizeof(size_t);
+    Offset += BlockCount * sizeof(uint16_t);
+
+    return (Offset + MLAS_SGEMM_SPARSE_VALUES_ALIGNMENT - 1) & ~size_t(MLAS_SGEMM_SPARSE_VALUES_ALIGNMENT - 1);
+}
+
+MLAS_FORCEINLINE
+MLAS_SGEMM_SPARSE_PACKED_B_LAYOUT
+MlasGemmSparseGetLayout(
+    const MLAS_SGEMM_SPARSE_PACKED_B* Header
+    )
+{
+    MLAS_SGEMM_SPARSE_PACKED_B_LAYOUT Layout;
+
+    Layout.PanelCount = (Header->N + Header->BlkN - 1) / Header->BlkN;
+    Layout.ChunkCountK = (Header->K + MLAS_SGEMM_SPARSE_STRIDEK - 1) / MLAS_SGEMM_SPARSE_STRIDEK;
+    Layout.GroupOffsets = reinterpret_cast<const size_t*>(Header + 1);
+    Layout.BlockRowIndex = reinterpret_cast<const uint16_t*>(
+        Layout.GroupOffsets + Layout.ChunkCountK * Layout.PanelCount + 1);
+    Layout.BlockValues = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(Header) +
+        MlasGemmSparseValuesOffset(Layout.PanelCount, Layout.ChunkCountK, Header->BlockCount));
+
+    return Layout;
+}
+
+MLAS_FORCEINLINE
+float
+MlasGemmSparseGetB(
+    CBLAS_TRANSPOSE TransB,
+    const float* B,
+    size_t ldb,
+    size_t k,
+    size_t n
+    )
+{
+    return (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+}
+
+MLAS_FORCEINLINE
+bool
+MlasGemmSparseIsBlockNonZero(
+    CBLAS_TRANSPOSE TransB,
+    size_t BlkN,
+    size_t N,
+    const float* B,
+    size_t ldb,
+    size_t k,
+    size_t n
+    )
+{
+    const size_t CountN = std::min(N - n, BlkN);
+
+    for (size_t nn = 0; nn < CountN; nn++) {
+        if (MlasGemmSparseGetB(TransB, B, ldb, k, n + nn) != 0.0f) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+MLASCALL
+MlasSgemmSparseKernel(
+    size_t BlkN,
+    const float* PanelA,
+    size_t CountM,
+    const size_t* GroupOffsets,
+    const uint16_t* BlockRowIndex,
+    const float* BlockValues,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a transposed tile of matrix A by the groups of
+    blocks of a range of panels of the packed matrix B.
+
+Arguments:
+
+    BlkN - Supplies the number of columns per block.
+
+    PanelA - Supplies the address of the transposed tile of matrix A: rows of
+        MLAS_SGEMM_SPARSE_STRIDEM values, zero padded past CountM.
+
+    CountM - Supplies the number of rows of matrix A and matrix C to process.
+
+    GroupOffsets - Supplies the index of the first block of each panel of the
+        range, followed by the index past the last block of the last panel.
+
+    BlockRowIndex - Supplies the row index of each block in the tile.
+
+    BlockValues - Supplies the BlkN values of each block.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountN - Supplies the number of columns of matrix C to process.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < CountN; n++) {
+
+        const size_t Panel = n / BlkN;
+        const size_t nn = n % BlkN;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            float Accumulator = 0.0f;
+
+            for (size_t i = GroupOffsets[Panel]; i < GroupOffsets[Panel + 1]; i++) {
+                Accumulator += PanelA[BlockRowIndex[i] * MLAS_SGEMM_SPARSE_STRIDEM + m] * BlockValues[i * BlkN + nn];
+            }
+
+            float* c = C + m * ldc + n;
+
+            *c = ZeroMode ? Accumulator * alpha : *c + Accumulator * alpha;
+        }
+    }
+}
+
+void
+MlasGemmSparseOperation(
+    size_t K,
+    const MLAS_SGEMM_SPARSE_DATA_PARAMS* Data,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartPanel,
+    size_t RangeCountPanel
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the sparse matrix/matrix multiply operation for a
+    range of rows and panels of matrix C.
+
+Arguments:
+
+    K - Supplies the number of columns of matrix A and rows of matrix B.
+
+    Data - Supplies the matrices data parameters.
+
+    RangeStartM - Supplies the first row of matrix C to compute.
+
+    RangeCountM - Supplies the number of rows of matrix C to compute.
+
+    RangeStartPanel - Supplies the first panel of matrix C to compute.
+
+    RangeCountPanel - Supplies the number of panels of matrix C to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* Header = static_cast<const MLAS_SGEMM_SPARSE_PACKED_B*>(Data->PackedB);
+    const MLAS_SGEMM_SPARSE_PACKED_B_LAYOUT Layout = MlasGemmSparseGetLayout(Header);
+
+    const size_t BlkN = Header->BlkN;
+    const size_t N = Header->N;
+    const size_t lda = Data->lda;
+    const size_t ldc = Data->ldc;
+
+    const float* A = Data->A + RangeStartM * lda;
+    float* C = Data->C + RangeStartM * ldc;
+
+    //
+    // Handle the special case of an empty K dimension.
+    //
+
+    if (K == 0) {
+
+        const size_t StartN = RangeStartPanel * BlkN;
+        const size_t CountN = std::min(N - StartN, RangeCountPanel * BlkN);
+
+        for (size_t m = 0; m < RangeCountM; m++) {
+            std::fill_n(C + m * ldc + StartN, CountN, 0.0f);
+        }
+
+        return;
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_SGEMM_SPARSE_KERNEL* SparseKernel = GetMlasPlatform().SgemmSparseKernel;
+#else
+    MLAS_SGEMM_SPARSE_KERNEL* SparseKernel = MlasSgemmSparseKernel;
+#endif
+
+    MLAS_DECLSPEC_ALIGN(float PanelA[MLAS_SGEMM_SPARSE_STRIDEK * MLAS_SGEMM_SPARSE_STRIDEM], 64);
+
+    for (size_t ChunkK = 0; ChunkK < Layout.ChunkCountK; ChunkK++) {
+
+        const size_t StartK = ChunkK * MLAS_SGEMM_SPARSE_STRIDEK;
+        const size_t CountK = std::min(K - StartK, size_t(MLAS_SGEMM_SPARSE_STRIDEK));
+
+        for (size_t m = 0; m < RangeCountM; m += MLAS_SGEMM_SPARSE_STRIDEM) {
+
+            const size_t CountM = std::min(RangeCountM - m, size_t(MLAS_SGEMM_SPARSE_STRIDEM));
+
+            //
+            // Transpose the tile of matrix A, padding the rows past CountM
+            // with zeros so the kernels can load whole vectors.
+            //
+
+            for (size_t k = 0; k < CountK; k++) {
+
+                const float* a = A + m * lda + StartK + k;
+                float* d = PanelA + k * MLAS_SGEMM_SPARSE_STRIDEM;
+
+                size_t mm = 0;
+
+                for (; mm < CountM; mm++) {
+                    d[mm] = a[mm * lda];
+                }
+
+                for (; mm < MLAS_SGEMM_SPARSE_STRIDEM; mm++) {
+                    d[mm] = 0.0f;
+                }
+            }
+
+            const size_t StartN = RangeStartPanel * BlkN;
+
+            SparseKernel(BlkN, PanelA, CountM,
+                Layout.GroupOffsets + ChunkK * Layout.PanelCount + RangeStartPanel,
+                Layout.BlockRowIndex, Layout.BlockValues, C + m * ldc + StartN, ldc,
+                std::min(N - StartN, RangeCountPanel * BlkN), Data->alpha, ChunkK == 0);
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmSparseCountBlocks(
+    CBLAS_TRANSPOSE TransB,
+    size_t BlkN,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine counts the blocks of matrix B that have a nonzero element.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    BlkN - Supplies the number of columns per block.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the number of nonzero blocks.
+
+--*/
+{
+    MlasGemmSparseValidateBlkN(BlkN);
+
+    size_t BlockCount = 0;
+
+    for (size_t k = 0; k < K; k++) {
+        for (size_t n = 0; n < N; n += BlkN) {
+            if (MlasGemmSparseIsBlockNonZero(TransB, BlkN, N, B, ldb, k, n)) {
+                BlockCount++;
+            }
+        }
+    }
+
+    return BlockCount;
+}
+
+size_t
+MLASCALL
+MlasGemmSparsePackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t BlkN,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the size in bytes of matrix B packed by
+    MlasGemmSparsePackB.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    BlkN - Supplies the number of columns per block.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    const size_t BlockCount = MlasGemmSparseCountBlocks(TransB, BlkN, N, K, B, ldb);
+    const size_t PanelCount = (N + BlkN - 1) / BlkN;
+    const size_t ChunkCountK = (K + MLAS_SGEMM_SPARSE_STRIDEK - 1) / MLAS_SGEMM_SPARSE_STRIDEK;
+
+    return MlasGemmSparseValuesOffset(PanelCount, ChunkCountK, BlockCount) + BlockCount * BlkN * sizeof(float);
+}
+
+void
+MLASCALL
+MlasGemmSparsePackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t BlkN,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the nonzero blocks of matrix B.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    BlkN - Supplies the number of columns per block.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    auto* Header = static_cast<MLAS_SGEMM_SPARSE_PACKED_B*>(PackedB);
+
+    Header->BlkN = BlkN;
+    Header->N = N;
+    Header->K = K;
+    Header->BlockCount = MlasGemmSparseCountBlocks(TransB, BlkN, N, K, B, ldb);
+
+    const MLAS_SGEMM_SPARSE_PACKED_B_LAYOUT Layout = MlasGemmSparseGetLayout(Header);
+
+    size_t* GroupOffsets = const_cast<size_t*>(Layout.GroupOffsets);
+    uint16_t* BlockRowIndex = const_cast<uint16_t*>(Layout.BlockRowIndex);
+    float* BlockValues = const_cast<float*>(Layout.BlockValues);
+
+    size_t Block = 0;
+
+    for (size_t ChunkK = 0; ChunkK < Layout.ChunkCountK; ChunkK++) {
+
+        const size_t StartK = ChunkK * MLAS_SGEMM_SPARSE_STRIDEK;
+        const size_t CountK = std::min(K - StartK, size_t(MLAS_SGEMM_SPARSE_STRIDEK));
+
+        for (size_t Panel = 0; Panel < Layout.PanelCount; Panel++) {
+
+            const size_t StartN = Panel * BlkN;
+            const size_t CountN = std::min(N - StartN, BlkN);
+
+            *GroupOffsets++ = Block;
+
+            for (size_t k = 0; k < CountK; k++) {
+
+                if (!MlasGemmSparseIsBlockNonZero(TransB, BlkN, N, B, ldb, StartK + k, StartN)) {
+                    continue;
+                }
+
+                BlockRowIndex[Block] = uint16_t(k);
+
+                float* Values = BlockValues + Block * BlkN;
+
+                for (size_t nn = 0; nn < BlkN; nn++) {
+                    Values[nn] = (nn < CountN) ? MlasGemmSparseGetB(TransB, B, ldb, StartK + k, StartN + nn) : 0.0f;
+                }
+
+                Block++;
+            }
+        }
+    }
+
+    *GroupOffsets = Block;
+}
+
+void
+MLASCALL
+MlasGemmSparseBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_SPARSE_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the batched single precision matrix/matrix
+    multiply operation with a sparse packed matrix B.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    Data - Supplies an array of matrices data parameters.
+
+    BatchSize - Supplies the number of multiplications in this batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    const auto* Header = static_cast<const MLAS_SGEMM_SPARSE_PACKED_B*>(Data->PackedB);
+    const size_t BlkN = Header->BlkN;
+    const size_t PanelCount = (N + BlkN - 1) / BlkN;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation, which is proportional to the number of nonzero blocks.
+    //
+
+    const double Complexity = double(M) * double(Header->BlockCount) * double(BlkN) + double(M) * double(N);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads. The M dimension is
+    // partitioned in tiles of MLAS_SGEMM_SPARSE_STRIDEM rows and the N
+    // dimension in panels.
+    //
+
+    const size_t BlockedM = (M + MLAS_SGEMM_SPARSE_STRIDEM - 1) / MLAS_SGEMM_SPARSE_STRIDEM;
+
+    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+
+    if (PanelCount > BlockedM) {
+
+        if (size_t(ThreadsPerGemm) > PanelCount) {
+            ThreadsPerGemm = ptrdiff_t(PanelCount);
+        }
+
+        ThreadCountM = 1;
+        ThreadCountN = ThreadsPerGemm;
+
+    } else {
+
+        if (size_t(ThreadsPerGemm) > BlockedM) {
+            ThreadsPerGemm = ptrdiff_t(BlockedM);
+        }
+
+        ThreadCountM = ThreadsPerGemm;
+        ThreadCountN = 1;
+    }
+
+    MlasTrySimpleParallel(ThreadPool,
+        ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
+        [=](ptrdiff_t tid)
+    {
+        const MLAS_SGEMM_SPARSE_DATA_PARAMS* DataParams = &Data[tid / ThreadsPerGemm];
+        const ptrdiff_t ThreadId = tid % ThreadsPerGemm;
+        const ptrdiff_t ThreadIdM = ThreadId / ThreadCountN;
+        const ptrdiff_t ThreadIdN = ThreadId % ThreadCountN;
+
+        size_t RangeStartM;
+        size_t RangeCountM;
+
+        MlasPartitionWork(ThreadIdM, ThreadCountM, BlockedM, &RangeStartM, &RangeCountM);
+
+        RangeStartM *= MLAS_SGEMM_SPARSE_STRIDEM;
+        RangeCountM *= MLAS_SGEMM_SPARSE_STRIDEM;
+
+        RangeCountM = std::min(M - RangeStartM, RangeCountM);
+
+        size_t RangeStartPanel;
+        size_t RangeCountPanel;
+
+        MlasPartitionWork(ThreadIdN, ThreadCountN, PanelCount, &RangeStartPanel, &RangeCountPanel);
+
+        MlasGemmSparseOperation(K, DataParams, RangeStartM, RangeCountM, RangeStartPanel, RangeCountPanel);
+    });
+}
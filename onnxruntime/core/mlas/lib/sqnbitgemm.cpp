@@ -0,0 +1,945 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with a blockwise quantized weight matrix B.
+
+    A single row of matrix A is multiplied by a kernel that dequantizes the
+    blocks of matrix B in registers, so matrix B is only ever read from memory
+    in its quantized form. This is the memory bandwidth bound case of token
+    generation in decoder models.
+
+    Multiple rows of matrix A are multiplied by dequantizing cache sized
+    panels of matrix B straight into the packed layout of the single
+    precision kernels, so that each dequantized panel is reused across all
+    of the rows without being copied again.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the dimensions of the panels of matrix B dequantized for multiple
+// rows of matrix A. MLAS_SQNBIT_GEMM_STRIDEK must be a multiple of every
+// supported block length and MLAS_SQNBIT_GEMM_STRIDEN a multiple of
+// MLAS_SGEMM_PACKED_B_WIDTH, so that a panel padded to the packed width fits.
+//
+
+#define MLAS_SQNBIT_GEMM_STRIDEN                    64
+#define MLAS_SQNBIT_GEMM_STRIDEK                    256
+
+//
+// Define the minimum and maximum supported block lengths.
+//
+
+#define MLAS_SQNBIT_GEMM_MINIMUM_BLKLEN             16
+#define MLAS_SQNBIT_GEMM_MAXIMUM_BLKLEN             256
+
+MLAS_FORCEINLINE
+size_t
+MlasQNBitBlkDataSizeInBytes(
+    size_t BlkBitWidth,
+    size_t BlkLen
+    )
+{
+    return BlkLen * BlkBitWidth / 8;
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasQNBitZeroPointsForBlksSizeInBytes(
+    size_t BlkBitWidth,
+    size_t BlockCountK
+    )
+{
+    return (BlkBitWidth == 4) ? (BlockCountK + 1) / 2 : BlockCountK;
+}
+
+template<size_t BlkBitWidth>
+MLAS_FORCEINLINE
+uint32_t
+MlasQNBitGetValue(
+    const uint8_t* BlkData,
+    size_t Index
+    )
+{
+    if constexpr (BlkBitWidth == 4) {
+        return (BlkData[Index / 2] >> ((Index & 1) * 4)) & 0x0F;
+    } else {
+        return BlkData[Index];
+    }
+}
+
+template<size_t BlkBitWidth>
+MLAS_FORCEINLINE
+float
+MlasQNBitGetZeroPoint(
+    const uint8_t* QuantBZeroPoint,
+    size_t BlockIndex
+    )
+{
+    if (QuantBZeroPoint == nullptr) {
+        return float(1u << (BlkBitWidth - 1));
+    }
+
+    return float(MlasQNBitGetValue<BlkBitWidth>(QuantBZeroPoint, BlockIndex));
+}
+
+template<size_t BlkBitWidth>
+void
+MlasSQNBitGemmM1KernelImpl(
+    size_t BlkLen,
+    const float* A,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t K,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes(BlkBitWidth, BlockCountK);
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+
+    for (size_t n = 0; n < CountN; n++) {
+
+        const uint8_t* b = QuantBData + n * StrideQuantBData;
+        const float* s = QuantBScale + n * BlockCountK;
+        const uint8_t* zp = (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * StrideQuantBZeroPoint : nullptr;
+
+        float Accumulator = 0.0f;
+
+        for (size_t k = 0, BlockIndex = 0; k < K; k += BlkLen, BlockIndex++) {
+
+            const size_t CountK = std::min(K - k, BlkLen);
+            const float ZeroPoint = MlasQNBitGetZeroPoint<BlkBitWidth>(zp, BlockIndex);
+            const uint8_t* BlkData = b + BlockIndex * BlkDataSize;
+
+            float BlockAccumulator = 0.0f;
+
+            for (size_t kk = 0; kk < CountK; kk++) {
+                const float Value = float(MlasQNBitGetValue<BlkBitWidth>(BlkData, kk)) - ZeroPoint;
+                BlockAccumulator += A[k + kk] * Value;
+            }
+
+            Accumulator += BlockAccumulator * s[BlockIndex];
+        }
+
+        C[n] = (Bias != nullptr) ? Accumulator + Bias[n] : Accumulator;
+    }
+}
+
+void
+MLASCALL
+MlasSQ4BitGemmM1Kernel(
+    size_t BlkLen,
+    const float* A,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t K,
+    size_t BlockCountK,
+    const float* Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a single row of matrix A by a range of columns of
+    a 4-bit blockwise quantized matrix B.
+
+Arguments:
+
+    BlkLen - Supplies the number of elements per block.
+
+    A - Supplies the address of the row of matrix A.
+
+    QuantBData - Supplies the address of the quantized blocks of the first
+        column of matrix B.
+
+    QuantBScale - Supplies the address of the block scales of the first column
+        of matrix B.
+
+    QuantBZeroPoint - Supplies the address of the block zero points of the
+        first column of matrix B, else nullptr to use the default zero point.
+
+    C - Supplies the address of the output row.
+
+    CountN - Supplies the number of columns of matrix B to process.
+
+    K - Supplies the number of columns of matrix A and rows of matrix B.
+
+    BlockCountK - Supplies the number of blocks per column of matrix B.
+
+    Bias - Supplies the address of the bias values for the columns, else
+        nullptr.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSQNBitGemmM1KernelImpl<4>(BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, K,
+        BlockCountK, Bias);
+}
+
+void
+MLASCALL
+MlasSQ8BitGemmM1Kernel(
+    size_t BlkLen,
+    const float* A,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t K,
+    size_t BlockCountK,
+    const float* Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a single row of matrix A by a range of columns of
+    an 8-bit blockwise quantized matrix B.
+
+    Refer to MlasSQ4BitGemmM1Kernel for the argument descriptions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSQNBitGemmM1KernelImpl<8>(BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, K,
+        BlockCountK, Bias);
+}
+
+template<size_t BlkBitWidth>
+void
+MlasSQNBitGemmDequantizeBImpl(
+    size_t BlkLen,
+    float* FpData,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    size_t CountN,
+    size_t StartK,
+    size_t CountK,
+    size_t BlockCountK
+    )
+{
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes(BlkBitWidth, BlockCountK);
+    const size_t AlignedCountN = (CountN + MLAS_SGEMM_PACKED_B_WIDTH - 1) &
+        ~(size_t(MLAS_SGEMM_PACKED_B_WIDTH) - 1);
+
+    for (size_t n = 0; n < AlignedCountN; n++) {
+
+        float* d = FpData + (n / MLAS_SGEMM_PACKED_B_WIDTH) * MLAS_SGEMM_PACKED_B_WIDTH * CountK +
+            (n % MLAS_SGEMM_PACKED_B_WIDTH);
+
+        if (n >= CountN) {
+
+            for (size_t k = 0; k < CountK; k++) {
+                d[k * MLAS_SGEMM_PACKED_B_WIDTH] = 0.0f;
+            }
+
+            continue;
+        }
+
+        const uint8_t* b = QuantBData + n * StrideQuantBData;
+        const float* s = QuantBScale + n * BlockCountK;
+        const uint8_t* zp = (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * StrideQuantBZeroPoint : nullptr;
+
+        for (size_t k = 0; k < CountK; k += BlkLen) {
+
+            const size_t BlockIndex = (StartK + k) / BlkLen;
+            const size_t CountBlockK = std::min(CountK - k, BlkLen);
+            const float Scale = s[BlockIndex];
+            const float ZeroPoint = MlasQNBitGetZeroPoint<BlkBitWidth>(zp, BlockIndex);
+            const uint8_t* BlkData = b + BlockIndex * BlkDataSize;
+
+            for (size_t kk = 0; kk < CountBlockK; kk++) {
+                d[(k + kk) * MLAS_SGEMM_PACKED_B_WIDTH] =
+                    (float(MlasQNBitGetValue<BlkBitWidth>(BlkData, kk)) - ZeroPoint) * Scale;
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasSQ4BitGemmDequantizeBKernel(
+    size_t BlkLen,
+    float* FpData,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    size_t CountN,
+    size_t StartK,
+    size_t CountK,
+    size_t BlockCountK
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a panel of a 4-bit blockwise quantized matrix B.
+    The panel is stored in the layout of MlasSgemmCopyPackB, so that the
+    single precision kernels can use it directly: the columns are grouped by
+    MLAS_SGEMM_PACKED_B_WIDTH, each group is stored as CountK rows of that
+    many values, and the columns past CountN are zero-padded to a multiple of
+    the width.
+
+Arguments:
+
+    BlkLen - Supplies the number of elements per block.
+
+    FpData - Supplies the address of the dequantized panel, with room for
+        CountN rounded up to a multiple of MLAS_SGEMM_PACKED_B_WIDTH columns.
+
+    QuantBData - Supplies the address of the quantized blocks of the first
+        column of the panel.
+
+    QuantBScale - Supplies the address of the block scales of the first column
+        of the panel.
+
+    QuantBZeroPoint - Supplies the address of the block zero points of the
+        first column of the panel, else nullptr to use the default zero point.
+
+    CountN - Supplies the number of columns of the panel.
+
+    StartK - Supplies the first row of the panel, a multiple of BlkLen.
+
+    CountK - Supplies the number of rows of the panel.
+
+    BlockCountK - Supplies the number of blocks per column of matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSQNBitGemmDequantizeBImpl<4>(BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN,
+        StartK, CountK, BlockCountK);
+}
+
+void
+MLASCALL
+MlasSQ8BitGemmDequantizeBKernel(
+    size_t BlkLen,
+    float* FpData,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    size_t CountN,
+    size_t StartK,
+    size_t CountK,
+    size_t BlockCountK
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a panel of an 8-bit blockwise quantized matrix B.
+
+    Refer to MlasSQ4BitGemmDequantizeBKernel for the argument descriptions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSQNBitGemmDequantizeBImpl<8>(BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN,
+        StartK, CountK, BlockCountK);
+}
+
+MLAS_FORCEINLINE
+void
+MlasSQNBitGemmKernelLoop(
+    const float* A,
+    const float* PanelB,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine steps through the rows of matrix A and matrix C calling the
+    single precision kernel with a dequantized panel of matrix B, like
+    MlasSgemmKernelLoop.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    PanelB - Supplies the address of the panel of matrix B, dequantized in
+        the packed layout of the single precision kernels.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns of matrix A and rows of the panel.
+
+    CountM - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the panel and matrix C.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if matrix C is overwritten, else false if the
+        product is accumulated into matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountM > 0) {
+
+        size_t RowsHandled;
+
+#if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_POWER)
+        RowsHandled = GetMlasPlatform().GemmFloatKernel(A, PanelB, C, CountK, CountM, CountN, lda, ldc, 1.0f,
+            ZeroMode);
+#else
+        if (ZeroMode) {
+            RowsHandled = MlasSgemmKernelZero(A, PanelB, C, CountK, CountM, CountN, lda, ldc, 1.0f);
+        } else {
+            RowsHandled = MlasSgemmKernelAdd(A, PanelB, C, CountK, CountM, CountN, lda, ldc, 1.0f);
+        }
+#endif
+
+        C += ldc * RowsHandled;
+        A += lda * RowsHandled;
+        CountM -= RowsHandled;
+    }
+}
+
+template<size_t BlkBitWidth>
+void
+MlasSQNBitGemmOperation(
+    size_t BlkLen,
+    size_t K,
+    const MLAS_SQNBIT_GEMM_DATA_PARAMS* Data,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the blockwise quantized weight matrix/matrix
+    multiply operation for a range of rows and columns of matrix C.
+
+Arguments:
+
+    BlkLen - Supplies the number of elements per block.
+
+    K - Supplies the number of columns of matrix A and rows of matrix B.
+
+    Data - Supplies the matrices data parameters.
+
+    RangeStartM - Supplies the first row of matrix C to compute.
+
+    RangeCountM - Supplies the number of rows of matrix C to compute.
+
+    RangeStartN - Supplies the first column of matrix C to compute.
+
+    RangeCountN - Supplies the number of columns of matrix C to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes(BlkBitWidth, BlockCountK);
+
+    const size_t lda = Data->lda;
+    const size_t ldc = Data->ldc;
+
+    const float* A = Data->A + RangeStartM * lda;
+    const uint8_t* QuantBData = Data->QuantBData + RangeStartN * StrideQuantBData;
+    const float* QuantBScale = Data->QuantBScale + RangeStartN * BlockCountK;
+    const uint8_t* QuantBZeroPoint = (Data->QuantBZeroPoint != nullptr) ?
+        Data->QuantBZeroPoint + RangeStartN * StrideQuantBZeroPoint : nullptr;
+    const float* Bias = (Data->Bias != nullptr) ? Data->Bias + RangeStartN : nullptr;
+    float* C = Data->C + RangeStartM * ldc + RangeStartN;
+
+    //
+    // Handle the special case of an empty K dimension.
+    //
+
+    if (K == 0) {
+
+        for (size_t m = 0; m < RangeCountM; m++) {
+            for (size_t n = 0; n < RangeCountN; n++) {
+                C[m * ldc + n] = (Bias != nullptr) ? Bias[n] : 0.0f;
+            }
+        }
+
+        return;
+    }
+
+    //
+    // Multiply a single row with the kernel that dequantizes in registers.
+    //
+
+    if (RangeCountM == 1) {
+
+#if defined(MLAS_TARGET_AMD64)
+        MLAS_SQNBIT_GEMM_M1_KERNEL* M1Kernel = (BlkBitWidth == 4) ?
+            GetMlasPlatform().SQ4BitGemmM1Kernel : GetMlasPlatform().SQ8BitGemmM1Kernel;
+#else
+        MLAS_SQNBIT_GEMM_M1_KERNEL* M1Kernel = (BlkBitWidth == 4) ?
+            MlasSQ4BitGemmM1Kernel : MlasSQ8BitGemmM1Kernel;
+#endif
+
+        M1Kernel(BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, RangeCountN, K, BlockCountK, Bias);
+
+        return;
+    }
+
+    //
+    // Multiply multiple rows by dequantizing panels of matrix B in the packed
+    // layout of the single precision kernels, which then use them as is.
+    //
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_SQNBIT_GEMM_DEQUANTIZE_B_KERNEL* DequantizeBKernel = (BlkBitWidth == 4) ?
+        GetMlasPlatform().SQ4BitGemmDequantizeBKernel : GetMlasPlatform().SQ8BitGemmDequantizeBKernel;
+#else
+    MLAS_SQNBIT_GEMM_DEQUANTIZE_B_KERNEL* DequantizeBKernel = (BlkBitWidth == 4) ?
+        MlasSQ4BitGemmDequantizeBKernel : MlasSQ8BitGemmDequantizeBKernel;
+#endif
+
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SQNBIT_GEMM_STRIDEN * MLAS_SQNBIT_GEMM_STRIDEK], 16 * sizeof(float));
+
+    for (size_t n = 0; n < RangeCountN; n += MLAS_SQNBIT_GEMM_STRIDEN) {
+
+        const size_t CountN = std::min(RangeCountN - n, size_t(MLAS_SQNBIT_GEMM_STRIDEN));
+
+        for (size_t k = 0; k < K; k += MLAS_SQNBIT_GEMM_STRIDEK) {
+
+            const size_t CountK = std::min(K - k, size_t(MLAS_SQNBIT_GEMM_STRIDEK));
+
+            DequantizeBKernel(BlkLen, PanelB,
+                QuantBData + n * StrideQuantBData,
+                QuantBScale + n * BlockCountK,
+                (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * StrideQuantBZeroPoint : nullptr,
+                CountN, k, CountK, BlockCountK);
+
+            MlasSQNBitGemmKernelLoop(A + k, PanelB, C + n, CountK, RangeCountM, CountN, lda, ldc, k == 0);
+        }
+
+        if (Bias != nullptr) {
+            for (size_t m = 0; m < RangeCountM; m++) {
+                float* c = C + m * ldc + n;
+                for (size_t nn = 0; nn < CountN; nn++) {
+                    c[nn] += Bias[n + nn];
+                }
+            }
+        }
+    }
+}
+
+bool
+MLASCALL
+MlasIsSQNBitGemmAvailable(
+    size_t BlkBitWidth,
+    size_t BlkLen
+    )
+/*++
+
+Routine Description:
+
+    This routine determines whether the blockwise quantized weight matrix
+    multiply supports the quantization parameters.
+
+Arguments:
+
+    BlkBitWidth - Supplies the number of bits per quantized element.
+
+    BlkLen - Supplies the number of elements per block.
+
+Return Value:
+
+    Returns true if the parameters are supported, else false.
+
+--*/
+{
+    if (BlkBitWidth != 4 && BlkBitWidth != 8) {
+        return false;
+    }
+
+    if (BlkLen < MLAS_SQNBIT_GEMM_MINIMUM_BLKLEN || BlkLen > MLAS_SQNBIT_GEMM_MAXIMUM_BLKLEN ||
+        (BlkLen & (BlkLen - 1)) != 0) {
+        return false;
+    }
+
+    return true;
+}
+
+void
+MLASCALL
+MlasSQNBitGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const MLAS_SQNBIT_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the batched matrix/matrix multiply operation with
+    a blockwise quantized matrix B.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    BlkBitWidth - Supplies the number of bits per quantized element.
+
+    BlkLen - Supplies the number of elements per block.
+
+    Data - Supplies an array of matrices data parameters.
+
+    BatchSize - Supplies the number of multiplications in this batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (!MlasIsSQNBitGemmAvailable(BlkBitWidth, BlkLen)) {
+#ifdef MLAS_NO_EXCEPTION
+        abort();
+#else
+        throw std::invalid_argument("Unsupported blockwise quantization parameters");
+#endif
+    }
+
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads. The N dimension is
+    // partitioned in units of MLAS_SGEMM_STRIDEN_THREAD_ALIGN columns.
+    // A single row is always partitioned along the N dimension so that the
+    // threads share the reads of the quantized matrix B.
+    //
+
+    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+
+    if (N > M) {
+
+        if (size_t(ThreadsPerGemm) > BlockedN) {
+            ThreadsPerGemm = ptrdiff_t(BlockedN);
+        }
+
+        ThreadCountM = 1;
+        ThreadCountN = ThreadsPerGemm;
+
+    } else {
+
+        if (size_t(ThreadsPerGemm) > M) {
+            ThreadsPerGemm = ptrdiff_t(M);
+        }
+
+        ThreadCountM = ThreadsPerGemm;
+        ThreadCountN = 1;
+    }
+
+    MlasTrySimpleParallel(ThreadPool,
+        ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
+        [=](ptrdiff_t tid)
+    {
+        const MLAS_SQNBIT_GEMM_DATA_PARAMS* DataParams = &Data[tid / ThreadsPerGemm];
+        const ptrdiff_t ThreadId = tid % ThreadsPerGemm;
+        const ptrdiff_t ThreadIdM = ThreadId / ThreadCountN;
+        const ptrdiff_t ThreadIdN = ThreadId % ThreadCountN;
+
+        size_t RangeStartM;
+        size_t RangeCountM;
+
+        MlasPartitionWork(ThreadIdM, ThreadCountM, M, &RangeStartM, &RangeCountM);
+
+        size_t RangeStartN;
+        size_t RangeCountN;
+
+        MlasPartitionWork(ThreadIdN, ThreadCountN, BlockedN, &RangeStartN, &RangeCountN);
+
+        RangeStartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+        RangeCountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+        if (BlkBitWidth == 4) {
+            MlasSQNBitGemmOperation<4>(BlkLen, K, DataParams, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+        } else {
+            MlasSQNBitGemmOperation<8>(BlkLen, K, DataParams, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+        }
+    });
+}
+
+void
+MLASCALL
+MlasSQNBitGemmQuantBSizes(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    size_t N,
+    size_t K,
+    size_t* QuantBDataSizeInBytes,
+    size_t* QuantBScaleCount,
+    size_t* QuantBZeroPointSizeInBytes
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the buffer sizes of a blockwise quantized matrix B.
+
+Arguments:
+
+    BlkBitWidth - Supplies the number of bits per quantized element.
+
+    BlkLen - Supplies the number of elements per block.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    QuantBDataSizeInBytes - Receives the size of the quantized blocks.
+
+    QuantBScaleCount - Receives the number of block scales.
+
+    QuantBZeroPointSizeInBytes - Receives the size of the block zero points.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+
+    *QuantBDataSizeInBytes = N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    *QuantBScaleCount = N * BlockCountK;
+    *QuantBZeroPointSizeInBytes = N * MlasQNBitZeroPointsForBlksSizeInBytes(BlkBitWidth, BlockCountK);
+}
+
+void
+MLASCALL
+MlasSQNBitGemmQuantizeB(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const float* B,
+    size_t ldb,
+    size_t N,
+    size_t K,
+    uint8_t* QuantBData,
+    float* QuantBScale,
+    uint8_t* QuantBZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes a single precision matrix B to the blockwise
+    layout consumed by MlasSQNBitGemmBatch.
+
+    With zero points, each block is quantized asymmetrically over the range
+    of its values extended to include zero. Without zero points, each block
+    is quantized symmetrically around the default zero point.
+
+Arguments:
+
+    BlkBitWidth - Supplies the number of bits per quantized element.
+
+    BlkLen - Supplies the number of elements per block.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    QuantBData - Receives the quantized blocks.
+
+    QuantBScale - Receives the block scales.
+
+    QuantBZeroPoint - Receives the block zero points, else nullptr to quantize
+        symmetrically.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (!MlasIsSQNBitGemmAvailable(BlkBitWidth, BlkLen)) {
+#ifdef MLAS_NO_EXCEPTION
+        abort();
+#else
+        throw std::invalid_argument("Unsupported blockwise quantization parameters");
+#endif
+    }
+
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes(BlkBitWidth, BlockCountK);
+    const int32_t MaximumValue = (1 << BlkBitWidth) - 1;
+    const int32_t DefaultZeroPoint = 1 << (BlkBitWidth - 1);
+
+    if (QuantBZeroPoint != nullptr) {
+        std::fill_n(QuantBZeroPoint, N * StrideQuantBZeroPoint, uint8_t(0));
+    }
+
+    for (size_t n = 0; n < N; n++) {
+
+        for (size_t BlockIndex = 0; BlockIndex < BlockCountK; BlockIndex++) {
+
+            const size_t StartK = BlockIndex * BlkLen;
+            const size_t CountK = std::min(K - StartK, BlkLen);
+
+            float Minimum = 0.0f;
+            float Maximum = 0.0f;
+
+            for (size_t kk = 0; kk < CountK; kk++) {
+                const float Value = B[(StartK + kk) * ldb + n];
+                Minimum = std::min(Minimum, Value);
+                Maximum = std::max(Maximum, Value);
+            }
+
+            float Scale;
+            int32_t ZeroPoint;
+
+            if (QuantBZeroPoint != nullptr) {
+                Scale = (Maximum - Minimum) / float(MaximumValue);
+                ZeroPoint = (Scale != 0.0f) ? int32_t(std::nearbyint(-Minimum / Scale)) : 0;
+                ZeroPoint = std::min(std::max(ZeroPoint, int32_t(0)), MaximumValue);
+            } else {
+                Scale = std::max(-Minimum, Maximum) / float(DefaultZeroPoint - 1);
+                ZeroPoint = DefaultZeroPoint;
+            }
+
+            const float ReciprocalScale = (Scale != 0.0f) ? 1.0f / Scale : 0.0f;
+
+            QuantBScale[n * BlockCountK + BlockIndex] = Scale;
+
+            if (QuantBZeroPoint != nullptr) {
+                uint8_t* zp = QuantBZeroPoint + n * StrideQuantBZeroPoint;
+                if (BlkBitWidth == 4) {
+                    zp[BlockIndex / 2] |= uint8_t(ZeroPoint << ((BlockIndex & 1) * 4));
+                } else {
+                    zp[BlockIndex] = uint8_t(ZeroPoint);
+                }
+            }
+
+            uint8_t* BlkData = QuantBData + (n * BlockCountK + BlockIndex) * BlkDataSize;
+
+            std::fill_n(BlkData, BlkDataSize, uint8_t(0));
+
+            for (size_t kk = 0; kk < CountK; kk++) {
+
+                int32_t Quantized = int32_t(std::nearbyint(B[(StartK + kk) * ldb + n] * ReciprocalScale)) + ZeroPoint;
+                Quantized = std::min(std::max(Quantized, int32_t(0)), MaximumValue);
+
+                if (BlkBitWidth == 4) {
+                    BlkData[kk / 2] |= uint8_t(Quantized << ((kk & 1) * 4));
+                } else {
+                    BlkData[kk] = uint8_t(Quantized);
+                }
+            }
+
+            //
+            // Pad a partial block with the zero point so the padding
+            // dequantizes to zero.
+            //
+
+            for (size_t kk = CountK; kk < BlkLen; kk++) {
+                if (BlkBitWidth == 4) {
+                    BlkData[kk / 2] |= uint8_t(ZeroPoint << ((kk & 1) * 4));
+                } else {
+                    BlkData[kk] = uint8_t(ZeroPoint);
+                }
+            }
+        }
+    }
+}
@@ -19,6 +19,9 @@ class BiasDropoutFusion : public GraphTransformer {
       : GraphTransformer("BiasDropoutFusion", compatible_execution_providers) {}
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  std::vector<std::string> TargetOpTypes() const override { return {"Add"}; }
+  int MatchRadius() const override { return 2; }
 };
 
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <limits>
+#include <set>
 
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/utils.h"
@@ -90,9 +91,31 @@ static bool ConstantFoldShapeNode(Graph& graph, Node& node) {
 }
 
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  return FoldNodes(graph, nullptr, modified, graph_level, logger);
+}
+
+Status ConstantFolding::ApplyToNodesImpl(Graph& graph, const NodesToVisit& nodes, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  return FoldNodes(graph, &nodes, modified, graph_level, logger);
+}
+
+Status ConstantFolding::FoldNodes(Graph& graph, const NodesToVisit* nodes, bool& modified, int graph_level,
+                                  const logging::Logger& logger) const {
   bool have_updated_nodes = false;
-  GraphViewer graph_viewer(graph);
-  auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the whole graph is visited in topological order. the given nodes are visited in the order of their indices,
+  // together with the consumers of the nodes folded, which may become foldable in turn.
+  std::vector<NodeIndex> order;
+  std::set<NodeIndex> pending;
+  if (nodes) {
+    const auto it = nodes->find(&graph);
+    if (it == nodes->end()) {
+      return Status::OK();
+    }
+    pending.insert(it->second.begin(), it->second.end());
+  } else {
+    order = GraphViewer(graph).GetNodesInTopologicalOrder();
+  }
 
 #if !defined(DISABLE_SPARSE_TENSORS)
   std::function<bool(const std::string&)> is_sparse_initializer_check = [&graph](const std::string& name) -> bool {
@@ -100,7 +123,15 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
   };
 #endif
 
-  for (NodeIndex i : order) {
+  for (size_t position = 0; nodes ? !pending.empty() : position < order.size(); ++position) {
+    NodeIndex i = 0;
+    if (nodes) {
+      i = *pending.begin();
+      pending.erase(pending.begin());
+    } else {
+      i = order[position];
+    }
+
     auto* node = graph.GetNode(i);
     if (!node) {
       continue;
@@ -111,7 +142,8 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       continue;
     }
 
-    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+    ORT_RETURN_IF_ERROR(nodes ? RecurseToNodes(*node, *nodes, modified, graph_level, logger)
+                              : Recurse(*node, modified, graph_level, logger));
 
     // Updating a node may allow shape inferencing to infer output shapes of following nodes,
     // so re-run the shape inferencing. use have_updated_nodes as that only applies to this Graph
@@ -237,6 +269,12 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         graph_utils::RemoveNodesWithOneOutputBottomUp(graph, input_node);
       }
 
+      if (nodes) {
+        for (auto it = node->OutputNodesBegin(), end = node->OutputNodesEnd(); it != end; ++it) {
+          pending.insert(it->Index());
+        }
+      }
+
       // Remove the output edges of the constant node and then remove the node itself.
       graph_utils::RemoveNodeOutputEdges(graph, *node);
       graph.RemoveNode(node->Index());
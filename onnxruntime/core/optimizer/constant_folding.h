@@ -30,6 +30,15 @@ class ConstantFolding : public GraphTransformer {
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
+  // nodes of any op type may be folded, so only the given nodes are visited
+  Status ApplyToNodesImpl(Graph& graph, const NodesToVisit& nodes, bool& modified, int graph_level,
+                          const logging::Logger& logger) const override;
+
+  // folds the nodes of the graph in topological order, or only the given nodes and the consumers of those folded if
+  // not null
+  Status FoldNodes(Graph& graph, const NodesToVisit* nodes, bool& modified, int graph_level,
+                   const logging::Logger& logger) const;
+
   bool skip_dequantize_linear_;
   const InlinedHashSet<std::string> excluded_initializers_;
   const IExecutionProvider& execution_provider_;
@@ -89,6 +89,21 @@ class ConvActivation : public NodeSelector {
       return false;
     };
 
+    // The GELU activations are computed by MLAS after the convolution. FastGelu is only fused without its
+    // optional bias input.
+    auto is_supported_cpu_ep_gelu_activation = [](const Node& activation_node) {
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(activation_node, "Gelu", {1}, kMSDomain)) {
+        return true;
+      }
+
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(activation_node, "FastGelu", {1}, kMSDomain)) {
+        const auto& input_defs = activation_node.InputDefs();
+        return input_defs.size() < 2 || !input_defs[1]->Exists();
+      }
+
+      return false;
+    };
+
     if (!ConvFusionDataTypeCheck(node)) {
       return std::nullopt;
     }
@@ -100,7 +115,8 @@ class ConvActivation : public NodeSelector {
       }
     } else if (node_ep.empty() || node_ep == kCpuExecutionProvider) {
       if (!is_supported_non_cuda_ep_activation(*next_node) &&
-          !graph_utils::IsSupportedOptypeVersionAndDomain(*next_node, "HardSigmoid", {6})) {
+          !graph_utils::IsSupportedOptypeVersionAndDomain(*next_node, "HardSigmoid", {6}) &&
+          !is_supported_cpu_ep_gelu_activation(*next_node)) {
         return std::nullopt;
       }
     } else {
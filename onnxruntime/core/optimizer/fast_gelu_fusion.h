@@ -31,6 +31,9 @@ class FastGeluFusion : public GraphTransformer {
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
+  std::vector<std::string> TargetOpTypes() const override { return {"Mul", "Pow"}; }
+  int MatchRadius() const override { return 8; }
+
 private:
   MatchResult CheckFirstFormula(Graph& graph, Node& node, InlinedVector<std::reference_wrapper<Node>>& nodes_to_fuse) const;
 
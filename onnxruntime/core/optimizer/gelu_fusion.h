@@ -22,6 +22,9 @@ class GeluFusion : public GraphTransformer {
       : GraphTransformer("GeluFusion", compatible_execution_providers) {}
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  std::vector<std::string> TargetOpTypes() const override { return {"Div"}; }
+  int MatchRadius() const override { return 4; }
 };
 
 }  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
 
 using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::common;
@@ -18,6 +19,12 @@ bool IsSupportedOptypeVersionAndDomain(const Node& node, const std::string& op_t
           graph_utils::MatchesOpSetDomain(node, domain));
 }
 
+// FastGelu can add a bias before the activation, which FusedGemm does not support.
+bool HasOptionalBias(const Node& node) {
+  const auto& input_defs = node.InputDefs();
+  return input_defs.size() > 1 && input_defs[1]->Exists();
+}
+
 // If the op has multiple versions, here we require it must have a single implementation that can work across all the
 // versions. Because in the fusion, we discarded the op version information.
 bool IsFusableActivation(const Node& node) {
@@ -33,6 +40,8 @@ bool IsFusableActivation(const Node& node) {
 #ifndef DISABLE_CONTRIB_OPS
          IsSupportedOptypeVersionAndDomain(node, "ScaledTanh", {1}, kOnnxDomain) ||
          IsSupportedOptypeVersionAndDomain(node, "ParametricSoftplus", {1}, kOnnxDomain) ||
+         IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain) ||
+         (IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain) && !HasOptionalBias(node)) ||
 #endif
          IsSupportedOptypeVersionAndDomain(node, "ThresholdedRelu", {1, 10}, kOnnxDomain);
 }
@@ -56,6 +65,11 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
       continue;
     }
 
+    // FusedGemm is only implemented for float.
+    if (!optimizer_utils::IsSupportedDataType(node, std::array<std::string_view, 1>{"tensor(float)"})) {
+      continue;
+    }
+
     const Node& next_node = *(node.OutputNodesBegin());
     if (!IsFusableActivation(next_node) || next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
       continue;
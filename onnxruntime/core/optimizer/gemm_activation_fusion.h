@@ -13,6 +13,9 @@ class GemmActivationFusion : public GraphTransformer {
       : GraphTransformer("GemmActivationFusion", compatible_execution_providers) {}
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  std::vector<std::string> TargetOpTypes() const override { return {"Gemm"}; }
+  int MatchRadius() const override { return 1; }
 };
 
 }  // namespace onnxruntime
@@ -25,4 +25,18 @@ Status GraphTransformer::Apply(Graph& graph, bool& modified, const logging::Logg
   return status;
 }
 
+Status GraphTransformer::ApplyToNodes(Graph& graph, const NodesToVisit& nodes, bool& modified,
+                                      const logging::Logger& logger) const {
+  ORT_RETURN_IF_ERROR(ApplyToNodesImpl(graph, nodes, modified, 0, logger));
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // see Apply
+  if (modified) {
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+#endif
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
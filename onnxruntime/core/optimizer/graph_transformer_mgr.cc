@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/graph_transformer_mgr.h"
+
+#include <algorithm>
+#include <vector>
+
 #include "core/optimizer/rule_based_graph_transformer.h"
 
 using namespace onnxruntime;
@@ -9,6 +13,61 @@ using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
+namespace {
+
+// Edges between the nodes near the changed nodes and the closest changed node, keyed by graph and node.
+using DistancesToChanges = InlinedHashMap<const Graph*, InlinedHashMap<NodeIndex, int>>;
+
+// Finds the nodes within max_edges edges of the changed nodes. The nodes containing the subgraphs with changed nodes
+// are changed too.
+DistancesToChanges FindNodesNearChanges(const NodesToVisit& changed, int max_edges) {
+  DistancesToChanges distances;
+  for (const auto& [graph, indices] : changed) {
+    auto& graph_distances = distances[graph];
+    for (const NodeIndex index : indices) {
+      graph_distances[index] = 0;
+    }
+    for (const Graph* subgraph = graph; subgraph->ParentNode() != nullptr; subgraph = subgraph->ParentGraph()) {
+      distances[subgraph->ParentGraph()][subgraph->ParentNode()->Index()] = 0;
+    }
+  }
+
+  for (auto& [graph, graph_distances] : distances) {
+    std::vector<NodeIndex> frontier;
+    frontier.reserve(graph_distances.size());
+    for (const auto& entry : graph_distances) {
+      frontier.push_back(entry.first);
+    }
+
+    for (int edges = 1; edges <= max_edges && !frontier.empty(); ++edges) {
+      std::vector<NodeIndex> next;
+      auto visit = [&graph_distances, &next, edges](NodeIndex index) {
+        if (graph_distances.emplace(index, edges).second) {
+          next.push_back(index);
+        }
+      };
+
+      for (const NodeIndex index : frontier) {
+        const Node* node = graph->GetNode(index);
+        if (node == nullptr) {
+          continue;
+        }
+        for (auto it = node->InputNodesBegin(), end = node->InputNodesEnd(); it != end; ++it) {
+          visit(it->Index());
+        }
+        for (auto it = node->OutputNodesBegin(), end = node->OutputNodesEnd(); it != end; ++it) {
+          visit(it->Index());
+        }
+      }
+      frontier = std::move(next);
+    }
+  }
+
+  return distances;
+}
+
+}  // namespace
+
 common::Status GraphTransformerManager::SetSteps(unsigned steps) {
   steps_ = steps;
   return Status::OK();
@@ -19,12 +78,21 @@ common::Status GraphTransformerManager::GetSteps(unsigned& steps) const {
   return Status::OK();
 }
 
+common::Status GraphTransformerManager::SetUseWorklist(bool use_worklist) {
+  use_worklist_ = use_worklist;
+  return Status::OK();
+}
+
 common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, TransformerLevel level, const logging::Logger& logger) const {
   const auto& transformers = level_to_transformer_map_.find(level);
   if (transformers == level_to_transformer_map_.end()) {
     return Status::OK();
   }
 
+  if (use_worklist_) {
+    return ApplyTransformersWithWorklist(graph, transformers->second, logger);
+  }
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
     for (const auto& transformer : transformers->second) {
@@ -43,6 +111,112 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
   return Status::OK();
 }
 
+common::Status GraphTransformerManager::ApplyTransformersWithWorklist(
+    Graph& graph, gsl::span<const std::unique_ptr<GraphTransformer>> transformers,
+    const logging::Logger& logger) const {
+  // the graph records the nodes the transformers change
+  NodesToVisit changed_nodes;
+  graph.SetNodeChangeRecorder([&changed_nodes](const Graph& changed_graph, NodeIndex index) {
+    changed_nodes[&changed_graph].insert(index);
+  });
+
+  const auto status = ApplyTransformerStepsWithWorklist(graph, transformers, changed_nodes, logger);
+  graph.SetNodeChangeRecorder(nullptr);
+  return status;
+}
+
+common::Status GraphTransformerManager::ApplyTransformerStepsWithWorklist(
+    Graph& graph, gsl::span<const std::unique_ptr<GraphTransformer>> transformers, NodesToVisit& changed_nodes,
+    const logging::Logger& logger) const {
+  // one index from op type to the transformers targeting it routes the changed nodes to the transformers
+  InlinedHashMap<std::string, InlinedVector<size_t>> op_type_to_transformers;
+  InlinedVector<size_t> any_op_type_transformers;
+  InlinedVector<int> match_radii;
+  int max_match_radius = 0;
+  for (size_t i = 0; i < transformers.size(); ++i) {
+    match_radii.push_back(transformers[i]->MatchRadius());
+    max_match_radius = std::max(max_match_radius, match_radii.back());
+    const auto op_types = transformers[i]->TargetOpTypes();
+    if (op_types.empty()) {
+      any_op_type_transformers.push_back(i);
+    }
+    for (const auto& op_type : op_types) {
+      op_type_to_transformers[op_type].push_back(i);
+    }
+  }
+
+  // the nodes each transformer is to visit, for the changes since it was last applied
+  std::vector<NodesToVisit> worklists(transformers.size());
+  auto add_to_worklist = [&worklists](size_t i, const Graph* graph, NodeIndex index) {
+    auto& worklist = worklists[i];
+    worklist[graph].insert(index);
+    // let the transformer reach the subgraph through the nodes containing it
+    for (; graph->ParentGraph() != nullptr; graph = graph->ParentGraph()) {
+      worklist[graph->ParentGraph()].insert(graph->ParentNode()->Index());
+    }
+  };
+
+  for (unsigned step = 0; step < steps_; ++step) {
+    bool graph_changed = false;
+    for (size_t i = 0; i < transformers.size(); ++i) {
+      const auto& transformer = transformers[i];
+      if (step > 0 && transformer->ShouldOnlyApplyOnce())
+        continue;
+
+      bool modified = false;
+      if (step == 0) {
+        worklists[i].clear();
+        ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified, logger));
+      } else {
+        if (worklists[i].empty()) {
+          continue;
+        }
+
+        const NodesToVisit nodes = std::move(worklists[i]);
+        worklists[i].clear();
+        ORT_RETURN_IF_ERROR(transformer->ApplyToNodes(graph, nodes, modified, logger));
+      }
+
+      if (!modified) {
+        changed_nodes.clear();
+        continue;
+      }
+
+      graph_changed = true;
+      for (const auto& [changed_graph, distances] : FindNodesNearChanges(changed_nodes, max_match_radius)) {
+        for (const auto& [index, distance] : distances) {
+          const Node* node = changed_graph->GetNode(index);
+          if (node == nullptr) {
+            continue;
+          }
+
+          for (const size_t j : any_op_type_transformers) {
+            if (distance <= match_radii[j]) {
+              add_to_worklist(j, changed_graph, index);
+            }
+          }
+          const auto it = op_type_to_transformers.find(node->OpType());
+          if (it != op_type_to_transformers.end()) {
+            for (const size_t j : it->second) {
+              if (distance <= match_radii[j]) {
+                add_to_worklist(j, changed_graph, index);
+              }
+            }
+          }
+        }
+      }
+
+      changed_nodes.clear();
+    }
+
+    if (!graph_changed) {
+      break;
+    }
+  }
+
+  return Status::OK();
+}
+
 common::Status GraphTransformerManager::Register(std::unique_ptr<GraphTransformer> transformer, TransformerLevel level) {
   const auto& name = transformer->Name();
   if (transformers_info_.find(name) != transformers_info_.end()) {
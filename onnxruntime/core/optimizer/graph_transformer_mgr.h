@@ -24,18 +24,35 @@ class GraphTransformerManager {
   // Get the maximum number of graph transformation steps
   common::Status GetSteps(unsigned& steps) const;
 
+  // Set whether ApplyTransformers uses a worklist after the first step
+  common::Status SetUseWorklist(bool use_worklist);
+
   // Register a transformer with a level.
   common::Status Register(std::unique_ptr<GraphTransformer> transformer, TransformerLevel level);
 
-  // Apply all transformers registered for the given level on the given graph
+  // Apply all transformers registered for the given level on the given graph.
+  // Each step applies the transformers to the whole graph, until a step leaves the graph unchanged.
+  // With a worklist, the steps after the first apply a transformer only to the nodes of its target op types
+  // that changed, or are near nodes that changed, since it was last applied, and skip it if there are none.
   common::Status ApplyTransformers(Graph& graph, TransformerLevel level, const logging::Logger& logger) const;
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphTransformerManager);
 
+  common::Status ApplyTransformersWithWorklist(Graph& graph,
+                                               gsl::span<const std::unique_ptr<GraphTransformer>> transformers,
+                                               const logging::Logger& logger) const;
+
+  common::Status ApplyTransformerStepsWithWorklist(Graph& graph,
+                                                   gsl::span<const std::unique_ptr<GraphTransformer>> transformers,
+                                                   NodesToVisit& changed_nodes,
+                                                   const logging::Logger& logger) const;
+
   // maximum number of graph transformation steps
   unsigned steps_;
 
+  bool use_worklist_ = false;
+
   InlinedHashMap<TransformerLevel, InlinedVector<std::unique_ptr<GraphTransformer>>> level_to_transformer_map_;
   InlinedHashMap<std::string, GraphTransformer*> transformers_info_;
 };
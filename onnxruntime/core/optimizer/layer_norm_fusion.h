@@ -22,6 +22,9 @@ class LayerNormFusion : public GraphTransformer {
       : GraphTransformer("LayerNormFusion", compatible_execution_providers) {}
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  std::vector<std::string> TargetOpTypes() const override { return {"ReduceMean"}; }
+  int MatchRadius() const override { return 7; }
 };
 
 /**
@@ -39,6 +42,9 @@ class SimplifiedLayerNormFusion : public GraphTransformer {
       : GraphTransformer("SimplifiedLayerNormFusion", compatible_execution_providers) {}
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  std::vector<std::string> TargetOpTypes() const override { return {"Pow"}; }
+  int MatchRadius() const override { return 7; }
 };
 
 }  // namespace onnxruntime
@@ -13,6 +13,9 @@ class MatMulAddFusion : public GraphTransformer {
       : GraphTransformer("MatMulAddFusion", compatible_execution_providers) {}
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  std::vector<std::string> TargetOpTypes() const override { return {"MatMul"}; }
+  int MatchRadius() const override { return 1; }
 };
 
 }  // namespace onnxruntime
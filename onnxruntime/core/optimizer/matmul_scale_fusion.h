@@ -32,6 +32,9 @@ class MatMulScaleFusion : public GraphTransformer {
         excluded_initializer_names_{excluded_initializer_names} {
   }
 
+  std::vector<std::string> TargetOpTypes() const override { return {"MatMul", "FusedMatMul"}; }
+  int MatchRadius() const override { return 1; }
+
  private:
   Status ApplyImpl(
       Graph& graph, bool& modified,
@@ -309,6 +309,12 @@ Status MatmulTransposeFusion::ApplyImpl(Graph& graph, bool& modified, int graph_
       continue;
     }
 
+    // The CPU FusedMatMul kernel is only implemented for float, although MatMul also supports float16.
+    if (node.GetExecutionProviderType() == kCpuExecutionProvider &&
+        left_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+      continue;
+    }
+
     bool is_trans_left = false;
     bool is_trans_batch_left = false;
     Node* left = nullptr;
@@ -140,12 +140,14 @@ static Status TryCreateKernel(const Node& node,
   const KernelCreateInfo* kernel_create_info = nullptr;
   ORT_RETURN_IF_ERROR(kernel_registry.TryFindKernel(node, execution_provider.Type(), kernel_type_str_resolver,
                                                     &kernel_create_info));
+  static const ConfigOptions kEmptyConfigOptions;
   OpKernelInfo kernel_info(node,
                            *kernel_create_info->kernel_def,
                            execution_provider,
                            constant_initialized_tensors,
                            ort_value_name_idx_map,
-                           data_transfer_mgr);
+                           data_transfer_mgr,
+                           kEmptyConfigOptions);
   return kernel_create_info->kernel_create_func(funcs_mgr, kernel_info, op_kernel);
 }
 
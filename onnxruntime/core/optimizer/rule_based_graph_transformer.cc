@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/rule_based_graph_transformer.h"
+
+#include <algorithm>
+
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/rewrite_rule.h"
 
@@ -40,8 +43,34 @@ Status RuleBasedGraphTransformer::ApplyRulesOnNode(Graph& graph, Node& node,
 }
 
 Status RuleBasedGraphTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
-  GraphViewer graph_viewer(graph);
-  auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  return ApplyRules(graph, nullptr, modified, graph_level, logger);
+}
+
+Status RuleBasedGraphTransformer::ApplyToNodesImpl(Graph& graph, const NodesToVisit& nodes, bool& modified,
+                                                   int graph_level, const logging::Logger& logger) const {
+  return ApplyRules(graph, &nodes, modified, graph_level, logger);
+}
+
+Status RuleBasedGraphTransformer::ApplyRules(Graph& graph, const NodesToVisit* nodes, bool& modified, int graph_level,
+                                             const logging::Logger& logger) const {
+  const InlinedHashSet<NodeIndex>* nodes_in_graph = nullptr;
+  if (nodes) {
+    const auto it = nodes->find(&graph);
+    if (it == nodes->end()) {
+      return Status::OK();
+    }
+    nodes_in_graph = &it->second;
+  }
+
+  // the given nodes are visited in the order of their indices, as sorting the whole graph topologically would cost
+  // more than visiting them
+  std::vector<NodeIndex> order;
+  if (nodes_in_graph) {
+    order.assign(nodes_in_graph->begin(), nodes_in_graph->end());
+    std::sort(order.begin(), order.end());
+  } else {
+    order = GraphViewer(graph).GetNodesInTopologicalOrder();
+  }
 
   for (NodeIndex i : order) {
     auto* node = graph.GetNode(i);
@@ -53,7 +82,7 @@ Status RuleBasedGraphTransformer::ApplyImpl(Graph& graph, bool& modified, int gr
     // Initialize the effect of rules on this node to denote that the graph has not yet been modified
     // by the rule application on the current node.
     auto rule_effect = RuleEffect::kNone;
- 
+
     if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
       continue;
     }
@@ -81,7 +110,8 @@ Status RuleBasedGraphTransformer::ApplyImpl(Graph& graph, bool& modified, int gr
     }
 
     if (rule_effect != RuleEffect::kRemovedCurrentNode) {
-      ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+      ORT_RETURN_IF_ERROR(nodes ? RecurseToNodes(*node, *nodes, modified, graph_level, logger)
+                                : Recurse(*node, modified, graph_level, logger));
     }
   }
 
@@ -92,4 +122,16 @@ size_t RuleBasedGraphTransformer::RulesCount() const {
   return rules_.size();
 }
 
+std::vector<std::string> RuleBasedGraphTransformer::TargetOpTypes() const {
+  std::vector<std::string> op_types;
+  if (any_op_type_rules_.empty()) {
+    op_types.reserve(op_type_to_rules_.size());
+    for (const auto& entry : op_type_to_rules_) {
+      op_types.push_back(entry.first);
+    }
+  }
+
+  return op_types;
+}
+
 }  // namespace onnxruntime
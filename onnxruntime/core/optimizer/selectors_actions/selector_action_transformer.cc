@@ -6,6 +6,7 @@
 #include <cassert>
 #include <algorithm>
 #include <iterator>
+#include <optional>
 #include <utility>
 
 #include "core/graph/op_identifier_utils.h"
@@ -65,6 +66,15 @@ auto SelectorActionRegistry::LookUpByOpType(const std::string& op_type) const
                  [](const std::pair<std::string, const Entry*> value) { return value.second; });
   return result;
 }
+
+std::vector<std::string> SelectorActionRegistry::OpTypes() const {
+  std::vector<std::string> result{};
+  for (auto it = op_type_to_entry_.begin(); it != op_type_to_entry_.end();
+       it = op_type_to_entry_.equal_range(it->first).second) {
+    result.push_back(it->first);
+  }
+  return result;
+}
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 SelectorActionTransformer::SelectorActionTransformer(const std::string& name,
@@ -188,19 +198,41 @@ static Status MatchAndProcess(
 Status SelectorActionTransformer::ApplySelectorsAndActions(
     Graph& graph, bool& modified, int graph_level,
     const logging::Logger& logger,
-    const SatRuntimeOptimizationSaveContext* save_context) const {
-  GraphViewer graph_viewer(graph);
+    const SatRuntimeOptimizationSaveContext* save_context,
+    const NodesToVisit* nodes) const {
+  const InlinedHashSet<NodeIndex>* nodes_in_graph = nullptr;
+  if (nodes) {
+    const auto it = nodes->find(&graph);
+    if (it == nodes->end()) {
+      return Status::OK();
+    }
+    nodes_in_graph = &it->second;
+  }
 
-  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+  // the given nodes are visited in the order of their indices, as sorting the whole graph topologically would cost
+  // more than visiting them. the selectors only look up nodes and initializers in the graph viewer.
+  std::optional<GraphViewer> graph_viewer;
+  std::vector<NodeIndex> order;
+  if (nodes_in_graph) {
+    graph_viewer.emplace(graph, GraphViewer::UnorderedTag{});
+    order.assign(nodes_in_graph->begin(), nodes_in_graph->end());
+    std::sort(order.begin(), order.end());
+  } else {
+    graph_viewer.emplace(graph);
+    order = graph_viewer->GetNodesInTopologicalOrder();
+  }
+
+  for (auto index : order) {
     auto* node = graph.GetNode(index);
     if (node == nullptr) {
       continue;  // was removed by this transformer
     }
 
-    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+    ORT_RETURN_IF_ERROR(nodes ? RecurseToNodes(*node, *nodes, modified, graph_level, logger)
+                              : Recurse(*node, modified, graph_level, logger));
 
     if (graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
-      ORT_RETURN_IF_ERROR(MatchAndProcess(graph, graph_viewer, *node, modified, logger,
+      ORT_RETURN_IF_ERROR(MatchAndProcess(graph, *graph_viewer, *node, modified, logger,
                                           Name(), selector_action_registry_, save_context));
     }
   }
@@ -318,4 +350,29 @@ Status SelectorActionTransformer::ApplyImpl(Graph& graph, bool& modified, int gr
 #endif
 }
 
+Status SelectorActionTransformer::ApplyToNodesImpl(Graph& graph, const NodesToVisit& nodes, bool& modified,
+                                                   int graph_level, const logging::Logger& logger) const {
+#if !defined(ORT_MINIMAL_BUILD)
+  if (!std::holds_alternative<SatRuntimeOptimizationLoadContext>(apply_context_)) {
+    const auto* save_context = std::get_if<SatRuntimeOptimizationSaveContext>(&apply_context_);
+    return ApplySelectorsAndActions(graph, modified, graph_level, logger, save_context, &nodes);
+  }
+#else
+  ORT_UNUSED_PARAMETER(nodes);
+#endif
+
+  // saved runtime optimizations are replayed for the whole graph
+  return ApplyImpl(graph, modified, graph_level, logger);
+}
+
+std::vector<std::string> SelectorActionTransformer::TargetOpTypes() const {
+#if !defined(ORT_MINIMAL_BUILD)
+  if (!std::holds_alternative<SatRuntimeOptimizationLoadContext>(apply_context_)) {
+    return selector_action_registry_.OpTypes();
+  }
+#endif
+
+  return {};
+}
+
 }  // namespace onnxruntime
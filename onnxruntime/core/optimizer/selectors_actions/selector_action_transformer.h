@@ -96,6 +96,9 @@ class SelectorActionRegistry {
 #if !defined(ORT_MINIMAL_BUILD)
   // return registered Entry or nullptr if not found
   auto LookUpByOpType(const std::string& op_type) const -> std::vector<gsl::not_null<const Entry*>>;
+
+  // return the op types with registered entries
+  std::vector<std::string> OpTypes() const;
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
  private:
@@ -120,14 +123,23 @@ class SelectorActionTransformer : public GraphTransformer {
   // can't copy/assign selector_action_registry_
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(SelectorActionTransformer);
 
+ public:
+  // the op types the selectors are registered for, or none when replaying saved runtime optimizations
+  std::vector<std::string> TargetOpTypes() const override;
+
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
+  Status ApplyToNodesImpl(Graph& graph, const NodesToVisit& nodes, bool& modified, int graph_level,
+                          const logging::Logger& logger) const override;
+
 #if !defined(ORT_MINIMAL_BUILD)
 
-  // apply optimizations by selecting nodes from graph and running or saving the associated actions
+  // apply optimizations by selecting nodes from graph and running or saving the associated actions.
+  // if nodes is not null, only the given nodes are selected from.
   Status ApplySelectorsAndActions(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger,
-                                  const SatRuntimeOptimizationSaveContext* save_context) const;
+                                  const SatRuntimeOptimizationSaveContext* save_context,
+                                  const NodesToVisit* nodes = nullptr) const;
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
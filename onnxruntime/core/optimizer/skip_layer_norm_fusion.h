@@ -19,6 +19,9 @@ class SkipLayerNormFusion : public GraphTransformer {
       : GraphTransformer("SkipLayerNormFusion", compatible_execution_providers) {}
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  std::vector<std::string> TargetOpTypes() const override { return {"LayerNormalization"}; }
+  int MatchRadius() const override { return 2; }
 };
 
 }  // namespace onnxruntime
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/atomic_file_write.h"
+
+#include <cstdio>
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+
+int RenameFile(const PathString& from, const PathString& to) {
+#ifdef _WIN32
+  return _wrename(from.c_str(), to.c_str());
+#else
+  return std::rename(from.c_str(), to.c_str());
+#endif
+}
+
+int RemoveFile(const PathString& path) {
+#ifdef _WIN32
+  return _wremove(path.c_str());
+#else
+  return std::remove(path.c_str());
+#endif
+}
+
+}  // namespace
+
+PathString GetTemporaryFilePath(const PathString& file_path, const std::string& tag) {
+  std::string suffix = ".tmp" + std::to_string(Env::Default().GetSelfPid());
+  if (!tag.empty()) {
+    suffix += "_" + tag;
+  }
+
+  return file_path + ToPathString(suffix);
+}
+
+Status ReplaceWithTemporaryFile(const PathString& temporary_file, const PathString& file_path) {
+  // the file is removed first where rename does not replace an existing file
+  if (RenameFile(temporary_file, file_path) != 0) {
+    RemoveFile(file_path);
+    if (RenameFile(temporary_file, file_path) != 0) {
+      RemoveFile(temporary_file);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace file ", ToUTF8String(file_path));
+    }
+  }
+
+  return Status::OK();
+}
+
+void RemoveTemporaryFile(const PathString& temporary_file) {
+  RemoveFile(temporary_file);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+
+namespace onnxruntime {
+
+// Helpers to replace a file that other processes may read or write at the same time. The new content is written to a
+// temporary file next to the file, which then replaces the file in a single step, so that readers see either the
+// previous or the complete new file.
+
+// Returns the path of a temporary file next to file_path. The path is unique to the process, and to tag within the
+// process, so that concurrent writers of the file do not write to the same temporary file.
+PathString GetTemporaryFilePath(const PathString& file_path, const std::string& tag = "");
+
+// Replaces file_path with temporary_file. The temporary file is removed if it can not replace the file.
+Status ReplaceWithTemporaryFile(const PathString& temporary_file, const PathString& file_path) ORT_MUST_USE_RESULT;
+
+// Removes a temporary file that is not used to replace its file.
+void RemoveTemporaryFile(const PathString& temporary_file);
+
+}  // namespace onnxruntime
@@ -72,6 +72,15 @@ struct ThreadOptions {
   // processor group [0,1,2,3] may only contain half of the physical cores.
   std::vector<size_t> affinity;
 
+  // NUMA node of each thread, indexed like affinity. If the threads span more than one node, the thread pool prefers
+  // stealing work from threads of the same node and kernels can keep a copy of their weights on each node.
+  // If the vector is empty, all the threads are treated as being on the same node.
+  std::vector<int> numa_nodes;
+
+  // If the threads span more than one NUMA node, kernels that prepack their weights keep a copy on each node, read by
+  // the threads of that node.
+  bool replicate_weights_per_numa_node = false;
+
   // Set or unset denormal as zero.
   bool set_denormal_as_zero = false;
 
@@ -122,6 +131,33 @@ class Env {
   // This function doesn't support systems with more than 64 logical processors
   virtual std::vector<size_t> GetThreadAffinityMasks() const = 0;
 
+  // Returns the logical processors of each NUMA node, indexed by node id. Returns an empty vector if the topology is
+  // unknown, in which case all the processors should be treated as being on one node.
+  virtual std::vector<std::vector<size_t>> GetNumaNodeProcessors() const { return {}; }
+
+  // Binds the pages entirely within [address, address + length) to the NUMA node, moving the pages that are already
+  // allocated. Pages allocated later are allocated on the node.
+  virtual common::Status BindMemoryToNumaNode(void* address, size_t length, int node) const {
+    ORT_UNUSED_PARAMETER(address);
+    ORT_UNUSED_PARAMETER(length);
+    ORT_UNUSED_PARAMETER(node);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Binding memory to a NUMA node is not supported.");
+  }
+
+  // Allocates length bytes of zeroed memory in pages of its own that are bound to the NUMA node before they are
+  // touched. Free it with FreeNumaNodeMemory.
+  virtual common::Status AllocateNumaNodeMemory(size_t length, int node, void*& address) const {
+    ORT_UNUSED_PARAMETER(length);
+    ORT_UNUSED_PARAMETER(node);
+    address = nullptr;
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Allocating memory on a NUMA node is not supported.");
+  }
+
+  virtual void FreeNumaNodeMemory(void* address, size_t length) const {
+    ORT_UNUSED_PARAMETER(address);
+    ORT_UNUSED_PARAMETER(length);
+  }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
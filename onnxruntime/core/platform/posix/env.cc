@@ -31,6 +31,10 @@ limitations under the License.
 #include <utility>  // for std::forward
 #include <vector>
 #include <assert.h>
+#include <fstream>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -121,6 +125,47 @@ int nftw_remove(
   return result;
 }
 
+#if defined(__linux__)
+// Parses a list of ids and ranges of ids, e.g. "0-3,8,10-11", the format of the cpulist and node lists in sysfs.
+bool ParseIdList(const std::string& list, std::vector<size_t>& ids) {
+  const auto parse_id = [](const std::string& str, size_t& id) {
+    if (str.empty() || !std::all_of(str.begin(), str.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      return false;
+    }
+    id = static_cast<size_t>(std::strtoull(str.c_str(), nullptr, 10));
+    return true;
+  };
+
+  std::istringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+
+    const auto dash = range.find('-');
+    size_t first, last;
+    if (!parse_id(range.substr(0, dash), first) ||
+        !parse_id(dash == std::string::npos ? range : range.substr(dash + 1), last) ||
+        last < first) {
+      return false;
+    }
+
+    for (size_t id = first; id <= last; ++id) {
+      ids.push_back(id);
+    }
+  }
+
+  return true;
+}
+
+bool ReadIdListFile(const std::string& path, std::vector<size_t>& ids) {
+  std::ifstream file(path);
+  std::string list;
+  return file && std::getline(file, list) && ParseIdList(list, ids);
+}
+#endif
+
 template <typename T>
 struct Freer {
   void operator()(T* p) { ::free(p); }
@@ -245,6 +290,81 @@ class PosixEnv : public Env {
     return ret;
   }
 
+#if defined(__linux__)
+  std::vector<std::vector<size_t>> GetNumaNodeProcessors() const override {
+    // node ids may have gaps, e.g. when a node is offline. the processors of a missing node are left empty.
+    std::vector<size_t> node_ids;
+    if (!ReadIdListFile("/sys/devices/system/node/online", node_ids) || node_ids.empty()) {
+      return {};
+    }
+
+    std::vector<std::vector<size_t>> node_processors(node_ids.back() + 1);
+    for (const size_t node_id : node_ids) {
+      // a node with memory but no processors has an empty list
+      if (!ReadIdListFile("/sys/devices/system/node/node" + std::to_string(node_id) + "/cpulist",
+                          node_processors[node_id])) {
+        return {};
+      }
+    }
+
+    return node_processors;
+  }
+
+  common::Status BindMemoryToNumaNode(void* address, size_t length, int node) const override {
+    // defined in <linux/mempolicy.h>, which is not used so the build does not depend on the kernel headers.
+    constexpr int kMpolBind = 2;
+    constexpr unsigned kMpolMfMove = 1 << 1;
+    constexpr size_t kBitsPerMaskWord = sizeof(unsigned long) * 8;
+
+    ORT_RETURN_IF(node < 0, "Invalid NUMA node ", node);
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (reinterpret_cast<uintptr_t>(address) + page_size - 1) / page_size * page_size;
+    const auto end = (reinterpret_cast<uintptr_t>(address) + length) / page_size * page_size;
+    if (end <= begin) {
+      return Status::OK();
+    }
+
+    std::vector<unsigned long> node_mask(static_cast<size_t>(node) / kBitsPerMaskWord + 1);
+    node_mask.back() |= 1UL << (static_cast<size_t>(node) % kBitsPerMaskWord);
+    if (syscall(SYS_mbind, begin, end - begin, kMpolBind, node_mask.data(), node_mask.size() * kBitsPerMaskWord + 1,
+                kMpolMfMove) != 0) {
+      auto [err_no, err_msg] = GetSystemError();
+      return common::Status(common::SYSTEM, err_no, "mbind to NUMA node " + std::to_string(node) + " failed: " + err_msg);
+    }
+
+    return Status::OK();
+  }
+
+  common::Status AllocateNumaNodeMemory(size_t length, int node, void*& address) const override {
+    address = nullptr;
+    ORT_RETURN_IF(length == 0, "Cannot allocate 0 bytes on NUMA node ", node);
+
+    // an anonymous mapping does not share its pages with other allocations, and none of them is touched until the
+    // policy is set
+    void* mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+      auto [err_no, err_msg] = GetSystemError();
+      return common::Status(common::SYSTEM, err_no, "mmap of " + std::to_string(length) + " bytes failed: " + err_msg);
+    }
+
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto status = BindMemoryToNumaNode(mapped, (length + page_size - 1) / page_size * page_size, node);
+    if (!status.IsOK()) {
+      munmap(mapped, length);
+      return status;
+    }
+
+    address = mapped;
+    return Status::OK();
+  }
+
+  void FreeNumaNodeMemory(void* address, size_t length) const override {
+    if (address != nullptr) {
+      munmap(address, length);
+    }
+  }
+#endif
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -3,9 +3,11 @@
 
 #include "core/providers/cpu/math/gemm.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
+#include "core/common/safeint.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
 
 namespace onnxruntime {
 
@@ -70,6 +72,36 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Gemm<double>);
 
+// MLFloat16 runs through MlasHalfGemm, which keeps the data in fp16 and accumulates in fp32.
+// See MatMul<MLFloat16> for how this differs from the Cast-wrapped fp32 Gemm it replaces.
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    7,
+    8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    9,
+    10,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    11,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Gemm,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+
 bool GemmPackBFp32(AllocatorPtr& alloc,
                    const Tensor& tensor_b,
                    bool trans_b,
@@ -108,6 +140,141 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
   return true;
 }
 
+bool GemmPrepareForSavedPackedBFp32(const Tensor& tensor_b,
+                                    bool trans_b,
+                                    size_t saved_size,
+                                    size_t& packed_b_size,
+                                    TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const TensorShape& shape = tensor_b.Shape();
+  const size_t K = trans_b ? static_cast<size_t>(shape[1]) : static_cast<size_t>(shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(shape[0]) : static_cast<size_t>(shape[1]);
+  const size_t size = MlasGemmPackBSize(N, K);
+  if (size == 0 || size != saved_size) {
+    return false;
+  }
+
+  packed_b_size = size;
+  b_shape = shape;
+  return true;
+}
+
+bool GemmPackBFp16(AllocatorPtr& alloc,
+                   const Tensor& tensor_b,
+                   bool trans_b,
+                   BufferUniquePtr& packed_b,
+                   size_t& packed_b_size,
+                   TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+  b_shape = tensor_b.Shape();
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  packed_b_size = MlasHalfGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+
+  // Zero the padding so the buffer hashes the same when shared between sessions.
+  memset(packed_b_data, 0, packed_b_size);
+
+  packed_b = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  MlasHalfGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                    N,
+                    K,
+                    reinterpret_cast<const MLAS_FP16*>(tensor_b.Data<MLFloat16>()),
+                    trans_b ? K : N,
+                    packed_b_data);
+  return true;
+}
+
+bool GemmPackBSparseFp32(AllocatorPtr& alloc,
+                         const Tensor& tensor_b,
+                         bool trans_b,
+                         float min_sparsity,
+                         BufferUniquePtr& packed_b,
+                         size_t& packed_b_size,
+                         TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2 || min_sparsity <= 0.0f) {
+    return false;
+  }
+
+  const TensorShape& shape = tensor_b.Shape();
+  const size_t K = trans_b ? static_cast<size_t>(shape[1]) : static_cast<size_t>(shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(shape[0]) : static_cast<size_t>(shape[1]);
+  if (N == 0 || K == 0) {
+    return false;
+  }
+
+  const float* b_data = tensor_b.Data<float>();
+  const CBLAS_TRANSPOSE trans = trans_b ? CblasTrans : CblasNoTrans;
+  const size_t ldb = trans_b ? K : N;
+
+  // The cost is estimated in 1x4 blocks: the kernels process a single value about 2.5 times faster than a 1x4
+  // block, so unstructured weights need more zeros to beat the dense kernel.
+  const double dense_blocks = static_cast<double>(K) * static_cast<double>((N + 3) / 4);
+  const double cost_1x4 = static_cast<double>(MlasGemmSparseCountBlocks(trans, 4, N, K, b_data, ldb));
+  const double cost_1x1 = static_cast<double>(MlasGemmSparseCountBlocks(trans, 1, N, K, b_data, ldb)) * 0.4;
+
+  const size_t blk_n = cost_1x4 <= cost_1x1 ? 4 : 1;
+  if (std::min(cost_1x4, cost_1x1) > dense_blocks * (1.0 - static_cast<double>(min_sparsity))) {
+    return false;
+  }
+
+  b_shape = shape;
+  packed_b_size = MlasGemmSparsePackBSize(trans, blk_n, N, K, b_data, ldb);
+
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+
+  // Zero the padding so the buffer hashes the same when shared between sessions.
+  memset(packed_b_data, 0, packed_b_size);
+
+  packed_b = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  MlasGemmSparsePackB(trans, blk_n, N, K, b_data, ldb, packed_b_data);
+  return true;
+}
+
+PackedBNumaReplicas::~PackedBNumaReplicas() {
+  for (const float* replica : replicas_) {
+    Env::Default().FreeNumaNodeMemory(const_cast<float*>(replica), size_);
+  }
+}
+
+gsl::span<const float* const> PackedBNumaReplicas::Get(const float* packed_b, size_t size,
+                                                       const concurrency::ThreadPool* thread_pool) {
+  if (!concurrency::ThreadPool::ShouldReplicateWeightsPerNumaNode(thread_pool)) {
+    return {};
+  }
+
+  std::call_once(once_, [&]() {
+    const int num_nodes = concurrency::ThreadPool::NumNumaNodes(thread_pool);
+    size_ = size;
+    replicas_.resize(num_nodes);
+    for (int node = 0; node < num_nodes; ++node) {
+      void* replica = nullptr;
+      auto status = Env::Default().AllocateNumaNodeMemory(size, node, replica);
+      if (!status.IsOK()) {
+        LOGS_DEFAULT(WARNING) << "Prepacked weights are not replicated on NUMA node " << node << ": "
+                              << status.ErrorMessage();
+        continue;
+      }
+
+      memcpy(replica, packed_b, size);
+      replicas_[node] = static_cast<const float*>(replica);
+    }
+  });
+
+  return replicas_;
+}
+
 template <typename T>
 void Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           int64_t M, int64_t N, int64_t K,
@@ -145,6 +312,37 @@ template void Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE
                                        float* y_data,
                                        concurrency::ThreadPool* thread_pool);
 
+template <typename T>
+void Gemm<T>::TuneSgemm(const OpKernelInfo& /*info*/) {
+}
+
+template <>
+void Gemm<float>::TuneSgemm(const OpKernelInfo& info) {
+  const auto a_shape = GetStaticInputShape(info, 0);
+  const auto b_shape = GetStaticInputShape(info, 1);
+  if (!a_shape || !b_shape || a_shape->NumDimensions() != 2 || b_shape->NumDimensions() != 2) {
+    return;
+  }
+
+  const bool trans_a = trans_A_ != CblasNoTrans;
+  const bool trans_b = trans_B_ != CblasNoTrans;
+  const int64_t K = (*a_shape)[trans_a ? 0 : 1];
+  if (K != (*b_shape)[trans_b ? 1 : 0]) {
+    return;
+  }
+
+  // a constant B is prepacked
+  const Tensor* b = nullptr;
+  SgemmTuningKey key;
+  key.M = static_cast<size_t>((*a_shape)[trans_a ? 1 : 0]);
+  key.N = static_cast<size_t>((*b_shape)[trans_b ? 0 : 1]);
+  key.K = static_cast<size_t>(K);
+  key.trans_a = trans_a;
+  key.trans_b = trans_b;
+  key.b_is_packed = info.TryGetConstantInput(1, &b);
+  sgemm_tuning_ = TuneSgemmForKernel(info, key);
+}
+
 template <typename T>
 Status Gemm<T>::PrePack(const Tensor& /* tensor */, int /* input_idx */, AllocatorPtr /*alloc_for_caching*/,
                         /*out*/ bool& is_packed,
@@ -159,10 +357,28 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
                             /*out*/ PrePackedWeights* prepacked_weights) {
   is_packed = false;
 
+  // only pack Matrix B
+  if (input_idx == 1) {
+    is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size_, b_shape_);
+    bool share_prepacked_weights = (prepacked_weights != nullptr);
+    if (is_packed && share_prepacked_weights) {
+      prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size_);
+    }
+  }
+  return Status::OK();
+}
+
+template <>
+Status Gemm<MLFloat16>::PrePack(const Tensor& tensor, int input_idx,
+                                AllocatorPtr alloc, /*out*/ bool& is_packed,
+                                /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-    is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    is_packed = GemmPackBFp16(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
@@ -180,6 +396,24 @@ Status Gemm<T>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& /*prepac
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::PrepareForSavedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                                const std::vector<size_t>& /*buffer_sizes*/,
+                                                /*out*/ bool& can_use_saved_buffers) {
+  can_use_saved_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::PrepareForSavedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                    const std::vector<size_t>& buffer_sizes,
+                                                    /*out*/ bool& can_use_saved_buffers) {
+  can_use_saved_buffers = input_idx == 1 && buffer_sizes.size() == 1 &&
+                          GemmPrepareForSavedPackedBFp32(tensor, trans_B_ != CblasNoTrans, buffer_sizes[0],
+                                                         packed_b_size_, b_shape_);
+  return Status::OK();
+}
+
 template <>
 Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
                                               int input_idx,
@@ -193,6 +427,19 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <>
+Status Gemm<MLFloat16>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                  int input_idx,
+                                                  /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(T* y_data, size_t y_size, concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -276,24 +523,37 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   const float* c_data = C != nullptr ? C->Data<float>() : nullptr;
   const TensorShape* c_shape = C != nullptr ? &C->Shape() : nullptr;
 
-  if (B) {
+  const MLAS_SGEMM_TUNING_PARAMS* tuning =
+      sgemm_tuning_.Get(static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K));
+
+  if (B && !mlas_activation_ && tuning == nullptr) {
     ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
                 c_data, c_shape, y_data, thread_pool);
   } else {
     GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
-    MlasGemm(
-        trans_A_,
-        static_cast<size_t>(M),
-        static_cast<size_t>(N),
-        static_cast<size_t>(K),
-        alpha_,
-        A->Data<float>(),
-        static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K),
-        packed_b_.get(),
-        c_data != nullptr ? beta_ : 0.0f,
-        y_data,
-        static_cast<size_t>(N),
-        thread_pool);
+
+    MLAS_SGEMM_DATA_PARAMS data;
+    data.A = A->Data<float>();
+    data.lda = static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K);
+    if (B) {
+      data.B = B->Data<float>();
+      data.ldb = static_cast<size_t>(trans_B_ != CblasNoTrans ? K : N);
+    } else {
+      data.B = static_cast<const float*>(packed_b_.get());
+      data.BIsPacked = true;
+      const auto packed_b_replicas = packed_b_numa_replicas_.Get(data.B, packed_b_size_, thread_pool);
+      data.BNumaReplicas = packed_b_replicas.data();
+      data.BNumaReplicaCount = packed_b_replicas.size();
+    }
+    data.C = y_data;
+    data.ldc = static_cast<size_t>(N);
+    data.alpha = alpha_;
+    data.beta = c_data != nullptr ? beta_ : 0.0f;
+    data.Activation = mlas_activation_ ? &*mlas_activation_ : nullptr;
+    data.Tuning = tuning;
+
+    MlasGemm(trans_A_, trans_B_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+             data, thread_pool);
   }
 
   ComputeActivation(y_data, M * N, thread_pool);
@@ -301,4 +561,79 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+template <>
+Status Gemm<MLFloat16>::Compute(OpKernelContext* context) const {
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  const auto* A = context->Input<Tensor>(0);
+  const auto* B = packed_b_ ? nullptr : context->Input<Tensor>(1);
+  const auto* C = context->Input<Tensor>(2);
+
+  // Bias could be missing. Treat as scalar 0 if that is the case.
+  GemmHelper helper(A->Shape(), trans_A_ != CblasNoTrans, B ? B->Shape() : b_shape_, trans_B_ != CblasNoTrans,
+                    C != nullptr ? C->Shape() : TensorShape({}));
+
+  if (!helper.State().IsOK())
+    return helper.State();
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  auto Y = context->Output(0, {helper.M(), helper.N()});
+
+  // if input is empty tensor, return as nothing need to be calculated and we've set the shape for the output
+  if (M == 0 || N == 0)
+    return Status::OK();
+
+  auto* y_data = reinterpret_cast<MLAS_FP16*>(Y->MutableData<MLFloat16>());
+  const auto* a_data = reinterpret_cast<const MLAS_FP16*>(A->Data<MLFloat16>());
+
+  // MlasHalfGemm takes A untransposed, so transpose A into a temporary buffer if needed.
+  BufferUniquePtr a_transposed;
+  if (trans_A_ != CblasNoTrans) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+    auto* a_transposed_data = static_cast<MLAS_FP16*>(alloc->Alloc(SafeInt<size_t>(M) * K * sizeof(MLAS_FP16)));
+    a_transposed = BufferUniquePtr(a_transposed_data, BufferDeleter(std::move(alloc)));
+    MlasTranspose(reinterpret_cast<const uint16_t*>(a_data), reinterpret_cast<uint16_t*>(a_transposed_data), K, M);
+    a_data = a_transposed_data;
+  }
+
+  // Broadcast the bias into the output, then let the multiply scale it by beta.
+  float beta = 0.0f;
+  if (C != nullptr && beta_ != 0.0f) {
+    const auto* c_data = reinterpret_cast<const MLAS_FP16*>(C->Data<MLFloat16>());
+    const auto& c_shape = C->Shape();
+    for (size_t m = 0; m < M; m++) {
+      MLAS_FP16* y_row = y_data + m * N;
+      if (c_shape.Size() == 1) {
+        std::fill_n(y_row, N, c_data[0]);
+      } else if (c_shape.NumDimensions() == 1 || c_shape[0] == 1) {
+        std::copy_n(c_data, N, y_row);
+      } else if (c_shape[1] == 1) {
+        std::fill_n(y_row, N, c_data[m]);
+      } else {
+        std::copy_n(c_data + m * N, N, y_row);
+      }
+    }
+    beta = beta_;
+  }
+
+  MLAS_HALF_GEMM_DATA_PARAMS data;
+  data.A = a_data;
+  data.lda = K;
+  data.B = packed_b_ ? packed_b_.get() : static_cast<const void*>(B->Data<MLFloat16>());
+  data.ldb = trans_B_ != CblasNoTrans ? K : N;
+  data.BIsPacked = bool(packed_b_);
+  data.C = y_data;
+  data.ldc = N;
+  data.alpha = alpha_;
+  data.beta = beta;
+
+  MlasHalfGemm(trans_B_, M, N, K, data, thread_pool);
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
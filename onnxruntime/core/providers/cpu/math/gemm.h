@@ -3,12 +3,17 @@
 
 #pragma once
 
+#include <optional>
+
 #include "gemm_base.h"
 
 #include "core/framework/op_kernel.h"
 #include "core/common/common.h"
 #include "core/util/math.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/activation/activations.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
+#include "core/providers/cpu/math/sgemm_autotuner.h"
 
 namespace onnxruntime {
 
@@ -16,6 +21,7 @@ template <typename T>
 class Gemm : protected GemmBase, public OpKernel {
  public:
   Gemm(const OpKernelInfo& info) : GemmBase(info), OpKernel(info) {
+    TuneSgemm(info);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -28,6 +34,10 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status PrepareForSavedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                         const std::vector<size_t>& buffer_sizes,
+                                         /*out*/ bool& can_use_saved_buffers) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           int64_t M, int64_t N, int64_t K,
                           float alpha,
@@ -40,11 +50,27 @@ class Gemm : protected GemmBase, public OpKernel {
  protected:
   TensorShape b_shape_;
   BufferUniquePtr packed_b_;
+  // Only set and used by the float kernel.
+  size_t packed_b_size_{0};
+  mutable PackedBNumaReplicas packed_b_numa_replicas_;
 
   // For fused gemm + activation
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 
+  // For fused gemm + activation applied by MLAS to each block of the output as it is computed
+  std::optional<MLAS_ACTIVATION> mlas_activation_;
+
+  SgemmTunedParams sgemm_tuning_;
+
   void ComputeActivation(T* y_data, size_t y_size, concurrency::ThreadPool* thread_pool) const;
+
+ private:
+  // Tunes the MLAS SGEMM for the shapes of the inputs in the model, see kOrtSessionOptionsConfigGemmAutotune.
+  // Only the float kernel is tuned.
+  void TuneSgemm(const OpKernelInfo& info);
 };
 
+template <>
+void Gemm<float>::TuneSgemm(const OpKernelInfo& info);
+
 }  // namespace onnxruntime
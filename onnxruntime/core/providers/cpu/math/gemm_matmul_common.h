@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "core/framework/op_kernel.h"
 
 namespace onnxruntime {
@@ -14,4 +16,53 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    size_t& packed_b_size,
                    TensorShape& b_shape);
 
+// Sets b_shape and packed_b_size for a weight that GemmPackBFp32 packed in an earlier session into a buffer of
+// saved_size bytes, so that the buffer can be used without packing the weight again. Returns false, without changing
+// them, if GemmPackBFp32 would not pack the weight into a buffer of that size.
+bool GemmPrepareForSavedPackedBFp32(const Tensor& tensor_b,
+                                    bool trans_b,
+                                    size_t saved_size,
+                                    size_t& packed_b_size,
+                                    TensorShape& b_shape);
+
+// Packs a 2D fp16 weight for MlasHalfGemmBatch. The packed weight stays in fp16.
+bool GemmPackBFp16(AllocatorPtr& alloc,
+                   const Tensor& tensor_b,
+                   bool trans_b,
+                   BufferUniquePtr& packed_b,
+                   size_t& packed_b_size,
+                   TensorShape& b_shape);
+
+// Packs a 2D fp32 weight for MlasGemmSparseBatch if it has enough zeros, i.e. if its estimated sparse cost is below
+// that of a weight with a min_sparsity fraction of zero 1x4 blocks. Returns false if the weight is not packed.
+bool GemmPackBSparseFp32(AllocatorPtr& alloc,
+                         const Tensor& tensor_b,
+                         bool trans_b,
+                         float min_sparsity,
+                         BufferUniquePtr& packed_b,
+                         size_t& packed_b_size,
+                         TensorShape& b_shape);
+
+// Keeps a copy of a prepacked fp32 weight on each NUMA node of an intra-op thread pool that replicates weights
+// (see concurrency::ThreadPool::ShouldReplicateWeightsPerNumaNode), so each thread reads the copy local to its node.
+// The copies are made on first use, as the thread pool is not known when the weight is prepacked. They are not
+// allocated from an arena, whose pages would be shared with other allocations, but from pages of their own that
+// Env::AllocateNumaNodeMemory binds to the node before the copy touches them.
+class PackedBNumaReplicas {
+ public:
+  PackedBNumaReplicas() = default;
+  ~PackedBNumaReplicas();
+
+  // Returns the copies of the size bytes at packed_b indexed by NUMA node, or an empty span if thread_pool does not
+  // replicate weights. The entry of a node whose memory could not be allocated is null.
+  gsl::span<const float* const> Get(const float* packed_b, size_t size, const concurrency::ThreadPool* thread_pool);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PackedBNumaReplicas);
+
+  std::once_flag once_;
+  size_t size_{0};
+  std::vector<const float*> replicas_;
+};
+
 };  // namespace onnxruntime
@@ -24,6 +24,13 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     MatMul<double>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1, 8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 // opset 9 supports more types
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     MatMul,
@@ -59,6 +66,14 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
         .TypeConstraint("T", BuildKernelDefConstraints<int64_t, uint64_t>()),
     MatMul<int64_t>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    9,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     MatMul,
     13,
@@ -89,6 +104,13 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("T", BuildKernelDefConstraints<int64_t, uint64_t>()),
     MatMul<int64_t>);
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
@@ -126,6 +148,34 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+void MatMul<float>::TuneSgemm(const OpKernelInfo& info) {
+  const auto a_shape = GetStaticInputShape(info, 0);
+  const auto b_shape = GetStaticInputShape(info, 1);
+  if (!a_shape || !b_shape) {
+    return;
+  }
+
+  const bool trans_a = trans_a_attr_ && a_shape->NumDimensions() != 1;
+  const bool trans_b = trans_b_attr_ && b_shape->NumDimensions() != 1;
+
+  MatMulComputeHelper helper;
+  if (!helper.Compute(*a_shape, *b_shape, trans_a, trans_b, trans_batch_a_, trans_batch_b_).IsOK()) {
+    return;
+  }
+
+  // a constant 2D B is prepacked
+  const Tensor* b = nullptr;
+  SgemmTuningKey key;
+  key.M = static_cast<size_t>(helper.M());
+  key.N = static_cast<size_t>(helper.N());
+  key.K = static_cast<size_t>(helper.K());
+  key.batch_size = helper.OutputOffsets().size();
+  key.trans_a = trans_a;
+  key.trans_b = trans_b;
+  key.b_is_packed = b_shape->NumDimensions() == 2 && info.TryGetConstantInput(1, &b);
+  sgemm_tuning_ = TuneSgemmForKernel(info, key);
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -133,12 +183,16 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
 
   // only pack Matrix B
   if (input_idx == 1) {
-    size_t packed_b_size;
-    is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+    // the sparse kernels read the rows of A, so they do not handle transA
+    packed_b_is_sparse_ = trans_a_attr_ == 0 &&
+                          GemmPackBSparseFp32(alloc, tensor, trans_b_attr_ != 0, sparse_weight_threshold_,
+                                              packed_b_, packed_b_size_, b_shape_);
+    is_packed = packed_b_is_sparse_ ||
+                GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size_, b_shape_);
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
-      prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size_);
     }
   }
   return Status::OK();
@@ -157,6 +211,21 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::PrepareForSavedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                      const std::vector<size_t>& buffer_sizes,
+                                                      /*out*/ bool& can_use_saved_buffers) {
+  // the format of a sparse packed B is chosen from its values, which are not checked here, so only a dense packed B
+  // is restored
+  can_use_saved_buffers = input_idx == 1 && buffer_sizes.size() == 1 && sparse_weight_threshold_ == 0.0f &&
+                          GemmPrepareForSavedPackedBFp32(tensor, trans_b_attr_ != 0, buffer_sizes[0],
+                                                         packed_b_size_, b_shape_);
+  if (can_use_saved_buffers) {
+    packed_b_is_sparse_ = false;
+  }
+
+  return Status::OK();
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -187,9 +256,34 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
 
+  if (packed_b_is_sparse_) {
+    std::vector<MLAS_SGEMM_SPARSE_DATA_PARAMS> data(max_len);
+    for (size_t i = 0; i < max_len; i++) {
+      data[i].A = a_data + helper.LeftOffsets()[i];
+      data[i].lda = lda;
+      data[i].PackedB = packed_b_.get();
+      data[i].C = y_data + helper.OutputOffsets()[i];
+      data[i].ldc = N;
+      data[i].alpha = alpha_attr_;
+    }
+    MlasGemmSparseBatch(M, N, K, data.data(), max_len, thread_pool);
+
+    return Status::OK();
+  }
+
+  gsl::span<const float* const> packed_b_replicas;
+  if (packed_b_) {
+    packed_b_replicas = packed_b_numa_replicas_.Get(static_cast<const float*>(packed_b_.get()), packed_b_size_,
+                                                    thread_pool);
+  }
+
+  const MLAS_SGEMM_TUNING_PARAMS* tuning = sgemm_tuning_.Get(M, N, K);
+
   std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
   for (size_t i = 0; i < max_len; i++) {
     data[i].BIsPacked = bool(packed_b_);
+    data[i].BNumaReplicas = packed_b_replicas.data();
+    data[i].BNumaReplicaCount = packed_b_replicas.size();
     data[i].A = a_data + helper.LeftOffsets()[i];
     data[i].lda = lda;
     data[i].B = data[i].BIsPacked ? (float*)packed_b_.get() : b_data + helper.RightOffsets()[i];
@@ -198,6 +292,7 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
     data[i].ldc = N;
     data[i].alpha = alpha_attr_;
     data[i].beta = 0.0f;
+    data[i].Tuning = tuning;
   }
   MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
                 M, N, K, data.data(), max_len, thread_pool);
@@ -205,4 +300,74 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+Status MatMul<MLFloat16>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
+                                  /*out*/ bool& is_packed,
+                                  /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only pack Matrix B
+  if (input_idx == 1) {
+    size_t packed_b_size;
+    is_packed = GemmPackBFp16(alloc, tensor, false, packed_b_, packed_b_size, b_shape_);
+    bool share_prepacked_weights = (prepacked_weights != nullptr);
+    if (is_packed && share_prepacked_weights) {
+      prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+    }
+  }
+  return Status::OK();
+}
+
+Status MatMul<MLFloat16>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                    int input_idx,
+                                                    /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
+  const auto& b_shape = b ? b->Shape() : b_shape_;
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto* a_data = reinterpret_cast<const MLAS_FP16*>(a->Data<MLFloat16>());
+  const auto* b_data = b ? reinterpret_cast<const MLAS_FP16*>(b->Data<MLFloat16>()) : nullptr;
+  auto* y_data = reinterpret_cast<MLAS_FP16*>(y->MutableData<MLFloat16>());
+
+  const size_t max_len = helper.OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  std::vector<MLAS_HALF_GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].BIsPacked = bool(packed_b_);
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    data[i].B = data[i].BIsPacked ? packed_b_.get() : static_cast<const void*>(b_data + helper.RightOffsets()[i]);
+    data[i].ldb = N;
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
+  }
+  MlasHalfGemmBatch(CblasNoTrans, M, N, K, data.data(), max_len, thread_pool);
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -3,7 +3,11 @@
 
 #pragma once
 
+#include "core/common/parse_string.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
+#include "core/providers/cpu/math/sgemm_autotuner.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -27,6 +31,13 @@ class MatMul<float> final : public OpKernel {
     info.GetAttrOrDefault<int64_t>("transBatchB", &trans_batch_b_attr, 0);
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
+    const std::string sparse_weight_threshold_str =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsConfigMatMulSparseWeightThreshold, "0");
+    ORT_ENFORCE(TryParseStringWithClassicLocale(sparse_weight_threshold_str, sparse_weight_threshold_) &&
+                    sparse_weight_threshold_ >= 0.0f && sparse_weight_threshold_ <= 1.0f,
+                "Invalid value for ", kOrtSessionOptionsConfigMatMulSparseWeightThreshold, ": ",
+                sparse_weight_threshold_str);
+    TuneSgemm(info);
   }
 
   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
@@ -36,11 +47,26 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status PrepareForSavedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                         const std::vector<size_t>& buffer_sizes,
+                                         /*out*/ bool& can_use_saved_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
+  // Tunes the MLAS SGEMM for the shapes of the inputs in the model, see kOrtSessionOptionsConfigGemmAutotune.
+  void TuneSgemm(const OpKernelInfo& info);
+
   TensorShape b_shape_;
   BufferUniquePtr packed_b_;
+  size_t packed_b_size_{0};
+  mutable PackedBNumaReplicas packed_b_numa_replicas_;
+
+  // B is packed for MlasGemmSparseBatch if it has at least this fraction of zeros.
+  float sparse_weight_threshold_{0.0f};
+  bool packed_b_is_sparse_{false};
+
+  SgemmTunedParams sgemm_tuning_;
 
   // For FusedMatMul contrib ops
   float alpha_attr_;
@@ -50,4 +76,29 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_b_;
 };
 
+// fp16 MatMul through MlasHalfGemm. A constant B is prepacked and kept in fp16.
+//
+// The products accumulate in fp32 and each output is rounded to fp16 once, so a single node matches an fp32 MatMul
+// of the same fp16 values. Before the fp16 MatMul, Gemm and Conv kernels existed, InsertCastTransformer ran these
+// nodes in fp32 between Cast nodes, and a chain of them kept its intermediate results in fp32. The chain now rounds
+// to fp16 after every node, in exchange for dropping the Cast nodes and their conversion passes over each tensor.
+template <>
+class MatMul<MLFloat16> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  TensorShape b_shape_;
+  BufferUniquePtr packed_b_;
+};
+
 }  // namespace onnxruntime
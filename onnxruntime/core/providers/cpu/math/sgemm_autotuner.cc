@@ -0,0 +1,382 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/sgemm_autotuner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/platform/atomic_file_write.h"
+#include "core/platform/threadpool.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Shapes with more work per batch are not tuned, as timing them would take too long.
+constexpr double kMaxTunedFlops = 4e9;
+constexpr size_t kMaxTunedBufferElements = size_t{1} << 26;
+
+// Each sample runs the batch for at least this many flops so it is long enough to time.
+constexpr double kFlopsPerSample = 50e6;
+constexpr int kMaxRunsPerSample = 64;
+constexpr int kSamples = 3;
+
+// A candidate replaces the current best only if it is faster by this ratio, so noise does not move the result
+// away from the MLAS heuristics.
+constexpr double kMinSpeedup = 0.98;
+
+// The partition of N by MLAS is aligned to this many columns (MLAS_SGEMM_STRIDEN_THREAD_ALIGN).
+constexpr size_t kThreadAlignN = 16;
+
+constexpr size_t kPackedBAlignment = 64;
+
+constexpr const char* kCacheFileHeader =
+    "# SGEMM tuning cache: cpu M N K batch trans_a trans_b b_is_packed threads StrideN StrideK ThreadCountM "
+    "ThreadCountN";
+
+bool HasSameValues(const MLAS_SGEMM_TUNING_PARAMS& a, const MLAS_SGEMM_TUNING_PARAMS& b) {
+  return a.StrideN == b.StrideN && a.StrideK == b.StrideK && a.ThreadCountM == b.ThreadCountM &&
+         a.ThreadCountN == b.ThreadCountN;
+}
+
+// Runs an SGEMM batch of a given shape on random data.
+class SgemmBenchmark {
+ public:
+  SgemmBenchmark(const SgemmTuningKey& key, concurrency::ThreadPool* thread_pool)
+      : key_(key), thread_pool_(thread_pool), data_(key.batch_size) {
+    const size_t a_size = key.M * key.K;
+    const size_t b_size = key.K * key.N;
+    const size_t c_size = key.M * key.N;
+
+    std::mt19937 generator(static_cast<unsigned>(key.M * key.N * key.K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    a_.resize(a_size * key.batch_size);
+    std::generate(a_.begin(), a_.end(), [&]() { return distribution(generator); });
+    c_.resize(c_size * key.batch_size);
+
+    // A prepacked B is shared by the whole batch.
+    std::vector<float> b(key.b_is_packed ? b_size : b_size * key.batch_size);
+    std::generate(b.begin(), b.end(), [&]() { return distribution(generator); });
+
+    const float* packed_b = nullptr;
+    if (key.b_is_packed) {
+      const size_t packed_b_size = MlasGemmPackBSize(key.N, key.K);
+      packed_b_buffer_.resize(packed_b_size + kPackedBAlignment);
+      void* aligned = packed_b_buffer_.data();
+      size_t space = packed_b_buffer_.size();
+      std::align(kPackedBAlignment, packed_b_size, aligned, space);
+      MlasGemmPackB(key.trans_b ? CblasTrans : CblasNoTrans, key.N, key.K, b.data(), key.trans_b ? key.K : key.N,
+                    aligned);
+      packed_b = static_cast<const float*>(aligned);
+    } else {
+      b_ = std::move(b);
+    }
+
+    for (size_t i = 0; i < key.batch_size; i++) {
+      data_[i].A = a_.data() + i * a_size;
+      data_[i].lda = key.trans_a ? key.M : key.K;
+      data_[i].BIsPacked = key.b_is_packed;
+      data_[i].B = key.b_is_packed ? packed_b : b_.data() + i * b_size;
+      data_[i].ldb = key.trans_b ? key.K : key.N;
+      data_[i].C = c_.data() + i * c_size;
+      data_[i].ldc = key.N;
+    }
+
+    const double flops = 2.0 * static_cast<double>(a_size) * static_cast<double>(key.N) *
+                         static_cast<double>(key.batch_size);
+    runs_per_sample_ = static_cast<int>(std::clamp(kFlopsPerSample / std::max(flops, 1.0), 1.0,
+                                                   static_cast<double>(kMaxRunsPerSample)));
+  }
+
+  // Returns the best time of a run of the batch with the parameters, in seconds.
+  double Time(const MLAS_SGEMM_TUNING_PARAMS& params) {
+    for (auto& data : data_) {
+      data.Tuning = &params;
+    }
+
+    Run();
+
+    double best = std::numeric_limits<double>::max();
+    for (int sample = 0; sample < kSamples; sample++) {
+      const auto start = std::chrono::steady_clock::now();
+      for (int run = 0; run < runs_per_sample_; run++) {
+        Run();
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count() / runs_per_sample_);
+    }
+    return best;
+  }
+
+ private:
+  void Run() {
+    MlasGemmBatch(key_.trans_a ? CblasTrans : CblasNoTrans, key_.trans_b ? CblasTrans : CblasNoTrans,
+                  key_.M, key_.N, key_.K, data_.data(), data_.size(), thread_pool_);
+  }
+
+  const SgemmTuningKey key_;
+  concurrency::ThreadPool* thread_pool_;
+  std::vector<float> a_;
+  std::vector<float> b_;
+  std::vector<float> c_;
+  std::vector<uint8_t> packed_b_buffer_;
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data_;
+  int runs_per_sample_{1};
+};
+
+// Partitions of each operation of the batch over the threads left to it by the batch, and over fewer threads for
+// operations too small to make use of them.
+std::vector<MLAS_SGEMM_TUNING_PARAMS> GetPartitionCandidates(const SgemmTuningKey& key) {
+  std::vector<MLAS_SGEMM_TUNING_PARAMS> candidates;
+
+  const size_t blocked_n = (key.N + kThreadAlignN - 1) / kThreadAlignN;
+  const size_t threads_per_gemm =
+      (static_cast<size_t>(key.thread_count) + key.batch_size - 1) / key.batch_size;
+
+  for (size_t threads = threads_per_gemm; threads >= 1; threads /= 2) {
+    for (size_t thread_count_m = 1; thread_count_m <= threads; thread_count_m++) {
+      if (threads % thread_count_m != 0) {
+        continue;
+      }
+      const size_t thread_count_n = threads / thread_count_m;
+      if (thread_count_m <= key.M && thread_count_n <= blocked_n) {
+        MLAS_SGEMM_TUNING_PARAMS params;
+        params.ThreadCountM = thread_count_m;
+        params.ThreadCountN = thread_count_n;
+        candidates.push_back(params);
+      }
+    }
+  }
+
+  return candidates;
+}
+
+// Shapes of the B panel for an unpacked B, filling the panel or half of it. Shapes where a stride exceeds the
+// matrix by more than twice are left out, as they block the operation the same as a smaller stride.
+std::vector<std::pair<size_t, size_t>> GetStrideCandidates(const SgemmTuningKey& key) {
+  std::vector<std::pair<size_t, size_t>> candidates;
+  if (key.b_is_packed) {
+    return candidates;
+  }
+
+  const size_t max_panel_size = MlasSgemmTuningMaximumPanelSize();
+  const size_t max_stride_k = key.trans_a ? MlasSgemmTuningMaximumStrideK() : max_panel_size;
+
+  for (size_t stride_n = kThreadAlignN; stride_n <= max_panel_size; stride_n *= 2) {
+    for (size_t panel_size : {max_panel_size, max_panel_size / 2}) {
+      const size_t stride_k = panel_size / stride_n;
+      if (stride_k == 0 || stride_k > max_stride_k || stride_n / 2 >= key.N || stride_k / 2 >= key.K) {
+        continue;
+      }
+      candidates.emplace_back(stride_n, stride_k);
+    }
+  }
+
+  return candidates;
+}
+
+}  // namespace
+
+SgemmAutotuner& SgemmAutotuner::Instance() {
+  static SgemmAutotuner autotuner;
+  return autotuner;
+}
+
+MLAS_SGEMM_TUNING_PARAMS SgemmAutotuner::GetTuning(const SgemmTuningKey& key, const std::string& cache_file,
+                                                   concurrency::ThreadPool* thread_pool) {
+  // Tuning is serialized so the candidates are not timed against each other.
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!cache_file.empty() && loaded_cache_files_.insert(cache_file).second) {
+    LoadCacheFile(cache_file);
+  }
+
+  auto it = tunings_.find(key);
+  if (it == tunings_.end()) {
+    it = tunings_.emplace(key, Tune(key, thread_pool)).first;
+  }
+
+  // the shape may have been tuned for another cache file, and then belongs to this one too
+  if (!cache_file.empty() && cache_file_keys_[cache_file].insert(key).second) {
+    SaveCacheFile(cache_file);
+  }
+
+  return it->second;
+}
+
+MLAS_SGEMM_TUNING_PARAMS SgemmAutotuner::Tune(const SgemmTuningKey& key,
+                                              concurrency::ThreadPool* thread_pool) const {
+  MLAS_SGEMM_TUNING_PARAMS best;
+
+  const double flops = 2.0 * static_cast<double>(key.M) * static_cast<double>(key.N) *
+                       static_cast<double>(key.K) * static_cast<double>(key.batch_size);
+  const size_t buffer_elements = (key.M * key.K + key.K * key.N + key.M * key.N) * key.batch_size;
+  if (flops == 0.0 || flops > kMaxTunedFlops || buffer_elements > kMaxTunedBufferElements) {
+    return best;
+  }
+
+  SgemmBenchmark benchmark(key, thread_pool);
+  double best_time = benchmark.Time(best);
+
+  auto try_candidate = [&](const MLAS_SGEMM_TUNING_PARAMS& candidate) {
+    if (HasSameValues(candidate, best)) {
+      return;
+    }
+    const double time = benchmark.Time(candidate);
+    if (time < best_time * kMinSpeedup) {
+      best = candidate;
+      best_time = time;
+    }
+  };
+
+  // Search the partition with the default blocking, then the blocking with the best partition.
+  for (const auto& candidate : GetPartitionCandidates(key)) {
+    try_candidate(candidate);
+  }
+
+  const MLAS_SGEMM_TUNING_PARAMS best_partition = best;
+  for (const auto& strides : GetStrideCandidates(key)) {
+    MLAS_SGEMM_TUNING_PARAMS candidate = best_partition;
+    candidate.StrideN = strides.first;
+    candidate.StrideK = strides.second;
+    try_candidate(candidate);
+  }
+
+  LOGS_DEFAULT(VERBOSE) << "SGEMM tuning for M=" << key.M << " N=" << key.N << " K=" << key.K
+                        << " batch=" << key.batch_size << " threads=" << key.thread_count
+                        << ": StrideN=" << best.StrideN << " StrideK=" << best.StrideK
+                        << " ThreadCountM=" << best.ThreadCountM << " ThreadCountN=" << best.ThreadCountN;
+
+  return best;
+}
+
+void SgemmAutotuner::LoadCacheFile(const std::string& cache_file) {
+  std::ifstream file(cache_file);
+  if (!file) {
+    // the file is created by the first save
+    return;
+  }
+
+  const std::string& cpu_key = CPUIDInfo::GetCPUIDInfo().GetCpuModelKey();
+  auto& foreign_lines = foreign_cache_lines_[cache_file];
+  auto& file_keys = cache_file_keys_[cache_file];
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::istringstream fields(line);
+    std::string line_cpu_key;
+    SgemmTuningKey key;
+    MLAS_SGEMM_TUNING_PARAMS params;
+    if (!(fields >> line_cpu_key >> key.M >> key.N >> key.K >> key.batch_size >> key.trans_a >> key.trans_b >>
+          key.b_is_packed >> key.thread_count >> params.StrideN >> params.StrideK >> params.ThreadCountM >>
+          params.ThreadCountN)) {
+      LOGS_DEFAULT(WARNING) << "Ignoring invalid line in SGEMM tuning cache " << cache_file << ": " << line;
+      continue;
+    }
+
+    if (line_cpu_key == cpu_key) {
+      tunings_.emplace(key, params);
+      file_keys.insert(key);
+    } else {
+      foreign_lines.push_back(line);
+    }
+  }
+}
+
+void SgemmAutotuner::SaveCacheFile(const std::string& cache_file) const {
+  const std::string& cpu_key = CPUIDInfo::GetCPUIDInfo().GetCpuModelKey();
+  // the saves of a process are serialized by mutex_
+  const PathString temp_file = GetTemporaryFilePath(ToPathString(cache_file));
+
+  {
+    std::ofstream file(temp_file, std::ios::trunc);
+    file << kCacheFileHeader << "\n";
+
+    auto foreign_lines = foreign_cache_lines_.find(cache_file);
+    if (foreign_lines != foreign_cache_lines_.end()) {
+      for (const auto& line : foreign_lines->second) {
+        file << line << "\n";
+      }
+    }
+
+    // only the entries of this file, as the process may also use other cache files
+    for (const SgemmTuningKey& key : cache_file_keys_.at(cache_file)) {
+      const MLAS_SGEMM_TUNING_PARAMS& params = tunings_.at(key);
+      file << cpu_key << " " << key.M << " " << key.N << " " << key.K << " " << key.batch_size << " "
+           << key.trans_a << " " << key.trans_b << " " << key.b_is_packed << " " << key.thread_count << " "
+           << params.StrideN << " " << params.StrideK << " " << params.ThreadCountM << " " << params.ThreadCountN
+           << "\n";
+    }
+
+    if (!file.flush()) {
+      LOGS_DEFAULT(WARNING) << "Failed to write SGEMM tuning cache " << ToUTF8String(temp_file);
+      file.close();
+      RemoveTemporaryFile(temp_file);
+      return;
+    }
+  }
+
+  const Status status = ReplaceWithTemporaryFile(temp_file, ToPathString(cache_file));
+  if (!status.IsOK()) {
+    LOGS_DEFAULT(WARNING) << "Failed to write SGEMM tuning cache: " << status.ErrorMessage();
+  }
+}
+
+std::optional<TensorShape> GetStaticInputShape(const OpKernelInfo& info, size_t input_idx) {
+  const auto& input_defs = info.node().InputDefs();
+  if (input_idx >= input_defs.size() || !input_defs[input_idx]->Exists()) {
+    return std::nullopt;
+  }
+
+  const auto* shape_proto = input_defs[input_idx]->Shape();
+  if (shape_proto == nullptr) {
+    return std::nullopt;
+  }
+
+  TensorShape shape = utils::GetTensorShapeFromTensorShapeProto(*shape_proto);
+  for (size_t i = 0; i < shape.NumDimensions(); i++) {
+    if (shape[i] < 0) {
+      return std::nullopt;
+    }
+  }
+  return shape;
+}
+
+SgemmTunedParams TuneSgemmForKernel(const OpKernelInfo& info, const SgemmTuningKey& key) {
+  const ConfigOptions& config_options = info.GetConfigOptions();
+  const std::string autotune = config_options.GetConfigOrDefault(kOrtSessionOptionsConfigGemmAutotune, "0");
+  ORT_ENFORCE(autotune == "0" || autotune == "1", "Invalid value for ", kOrtSessionOptionsConfigGemmAutotune, ": ",
+              autotune);
+  if (autotune != "1") {
+    return {};
+  }
+
+  SgemmTuningKey thread_key = key;
+  thread_key.thread_count = concurrency::ThreadPool::DegreeOfParallelism(info.GetThreadPool());
+
+  const MLAS_SGEMM_TUNING_PARAMS params = SgemmAutotuner::Instance().GetTuning(
+      thread_key, config_options.GetConfigOrDefault(kOrtSessionOptionsConfigGemmAutotuneCacheFile, ""),
+      info.GetThreadPool());
+
+  if (HasSameValues(params, MLAS_SGEMM_TUNING_PARAMS{})) {
+    return {};
+  }
+  return SgemmTunedParams(key.M, key.N, key.K, params);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+// Shape of a batch of SGEMM operations run by MlasGemmBatch, and the degree of parallelism of the thread pool
+// running it.
+struct SgemmTuningKey {
+  size_t M{0};
+  size_t N{0};
+  size_t K{0};
+  size_t batch_size{1};
+  bool trans_a{false};
+  bool trans_b{false};
+  bool b_is_packed{false};
+  int thread_count{1};
+
+  bool operator<(const SgemmTuningKey& other) const {
+    return std::tie(M, N, K, batch_size, trans_a, trans_b, b_is_packed, thread_count) <
+           std::tie(other.M, other.N, other.K, other.batch_size, other.trans_a, other.trans_b, other.b_is_packed,
+                    other.thread_count);
+  }
+};
+
+// MLAS tuning parameters found for the shape of a kernel, applied while the shape at run time matches.
+class SgemmTunedParams {
+ public:
+  SgemmTunedParams() = default;
+
+  SgemmTunedParams(size_t M, size_t N, size_t K, const MLAS_SGEMM_TUNING_PARAMS& params)
+      : M_(M), N_(N), K_(K), params_(params), valid_(true) {}
+
+  // Returns the parameters to set in MLAS_SGEMM_DATA_PARAMS::Tuning, or null to use the MLAS heuristics.
+  const MLAS_SGEMM_TUNING_PARAMS* Get(size_t M, size_t N, size_t K) const {
+    return valid_ && M == M_ && N == N_ && K == K_ ? &params_ : nullptr;
+  }
+
+ private:
+  size_t M_{0};
+  size_t N_{0};
+  size_t K_{0};
+  MLAS_SGEMM_TUNING_PARAMS params_;
+  bool valid_{false};
+};
+
+// Times candidate MLAS_SGEMM_TUNING_PARAMS for each distinct SGEMM shape and keeps the fastest for the life of the
+// process. The results can be persisted in a cache file shared by processes, where they are keyed by processor model.
+class SgemmAutotuner {
+ public:
+  static SgemmAutotuner& Instance();
+
+  // Returns the parameters found for the key, tuning them on thread_pool if they are not cached. cache_file may be
+  // empty. All zero parameters select the MLAS heuristics.
+  MLAS_SGEMM_TUNING_PARAMS GetTuning(const SgemmTuningKey& key, const std::string& cache_file,
+                                     concurrency::ThreadPool* thread_pool);
+
+ private:
+  SgemmAutotuner() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SgemmAutotuner);
+
+  MLAS_SGEMM_TUNING_PARAMS Tune(const SgemmTuningKey& key, concurrency::ThreadPool* thread_pool) const;
+
+  void LoadCacheFile(const std::string& cache_file);
+  void SaveCacheFile(const std::string& cache_file) const;
+
+  std::mutex mutex_;
+  std::map<SgemmTuningKey, MLAS_SGEMM_TUNING_PARAMS> tunings_;
+  std::set<std::string> loaded_cache_files_;
+  // Keys of the entries of each cache file for this processor: those loaded from it and those requested with it.
+  std::map<std::string, std::set<SgemmTuningKey>> cache_file_keys_;
+  // Entries of the cache files for other processors, written back unchanged.
+  std::map<std::string, std::vector<std::string>> foreign_cache_lines_;
+};
+
+// Returns the shape of the input of the kernel's node in the model if all its dimensions are known.
+std::optional<TensorShape> GetStaticInputShape(const OpKernelInfo& info, size_t input_idx);
+
+// Returns the parameters tuned for an SGEMM batch run by the kernel if "session.gemm_autotune" is enabled for its
+// session, or an instance that always returns null.
+SgemmTunedParams TuneSgemmForKernel(const OpKernelInfo& info, const SgemmTuningKey& key);
+
+}  // namespace onnxruntime
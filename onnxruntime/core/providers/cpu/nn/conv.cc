@@ -17,7 +17,10 @@
 
 #include "core/providers/cpu/nn/conv.h"
 
+#include <algorithm>
+
 #include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -152,20 +155,101 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  if (input_idx != 1 || !prepack_winograd_filter_) {
+    return Status::OK();
+  }
+
+  // Only 3x3 convolutions with unit strides and dilations can use the Winograd algorithm.
+  const auto& shape = tensor.Shape();
+  const auto has_unit_values = [](const TensorShapeVector& values) {
+    return std::all_of(values.begin(), values.end(), [](int64_t value) { return value == 1; });
+  };
+  if (shape.NumDimensions() != 4 || shape[2] != 3 || shape[3] != 3 || conv_attrs_.group <= 0 ||
+      shape[0] % conv_attrs_.group != 0 ||
+      !has_unit_values(conv_attrs_.strides) || !has_unit_values(conv_attrs_.dilations)) {
+    return Status::OK();
+  }
+
+  // MLAS only selects the Winograd algorithm, and so only packs the filter, with enough filters and input channels.
+  const auto group_count = static_cast<size_t>(conv_attrs_.group);
+  const auto filter_count = static_cast<size_t>(shape[0]) / group_count;
+  const auto input_channels = static_cast<size_t>(shape[1]);
+  const size_t packed_size_4x4 = MlasConvWinogradPackFilterSize(4, group_count, filter_count, input_channels);
+  const size_t packed_size_2x2 = MlasConvWinogradPackFilterSize(2, group_count, filter_count, input_channels);
+  if (packed_size_4x4 == 0 || packed_size_2x2 == 0) {
+    return Status::OK();
+  }
+
+  const size_t filter_bytes = tensor.SizeInBytes();
+  const size_t packed_bytes_4x4 = SafeInt<size_t>(sizeof(float)) * packed_size_4x4;
+  const size_t packed_bytes_2x2 = SafeInt<size_t>(sizeof(float)) * packed_size_2x2;
+
+  auto* filter_data = alloc->Alloc(filter_bytes);
+  packed_filter_ = BufferUniquePtr(filter_data, BufferDeleter(alloc));
+  memcpy(filter_data, tensor.DataRaw(), filter_bytes);
+
+  auto* packed_data_4x4 = alloc->Alloc(packed_bytes_4x4);
+  packed_winograd_filter_4x4_ = BufferUniquePtr(packed_data_4x4, BufferDeleter(alloc));
+  MlasConvWinogradPackFilter(4, group_count, filter_count, input_channels, tensor.Data<float>(),
+                             static_cast<float*>(packed_data_4x4));
+
+  auto* packed_data_2x2 = alloc->Alloc(packed_bytes_2x2);
+  packed_winograd_filter_2x2_ = BufferUniquePtr(packed_data_2x2, BufferDeleter(std::move(alloc)));
+  MlasConvWinogradPackFilter(2, group_count, filter_count, input_channels, tensor.Data<float>(),
+                             static_cast<float*>(packed_data_2x2));
+
+  filter_shape_ = shape;
+  is_packed = true;
+
+  bool share_prepacked_weights = (prepacked_weights != nullptr);
+  if (share_prepacked_weights) {
+    prepacked_weights->buffers_.push_back(std::move(packed_filter_));
+    prepacked_weights->buffer_sizes_.push_back(filter_bytes);
+    prepacked_weights->buffers_.push_back(std::move(packed_winograd_filter_4x4_));
+    prepacked_weights->buffer_sizes_.push_back(packed_bytes_4x4);
+    prepacked_weights->buffers_.push_back(std::move(packed_winograd_filter_2x2_));
+    prepacked_weights->buffer_sizes_.push_back(packed_bytes_2x2);
+  }
+
+  return Status::OK();
+}
+
+Status Conv<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_filter_ = std::move(prepacked_buffers[0]);
+    packed_winograd_filter_4x4_ = std::move(prepacked_buffers[1]);
+    packed_winograd_filter_2x2_ = std::move(prepacked_buffers[2]);
+  }
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
-  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* W = packed_filter_ ? nullptr : context->Input<Tensor>(1);
+  const auto& W_shape = W ? W->Shape() : filter_shape_;
+  const auto* Wdata = W ? W->Data<float>() : static_cast<const float*>(packed_filter_.get());
   const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
   const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   // kernel_shape is an optional attribute and has to be inferred from W if not provided
   TensorShapeVector kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   ConvPadVector pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -232,13 +316,21 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     Beta,
                     thread_pool);
 
+    // Use the filter transformed by PrePack, which removes it from the working buffer.
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd && packed_filter_ != nullptr) {
+      const auto& packed_winograd_filter = Parameters.u.Winograd.OutputTileSize == 4 ? packed_winograd_filter_4x4_
+                                                                                      : packed_winograd_filter_2x2_;
+      Parameters.u.Winograd.PackedFilter = static_cast<const float*>(packed_winograd_filter.get());
+      WorkingBufferSize -= Parameters.u.Winograd.FilterBufferSize;
+    }
+
     auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(SafeInt<size_t>(sizeof(float)) * WorkingBufferSize)
                                                : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
 
     MlasConv(&Parameters,
              Xdata,
-             W->Data<float>(),
+             Wdata,
              Bdata,
              static_cast<float*>(working_buffer.get()),
              Ydata,
@@ -249,7 +341,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
     const int64_t kernel_size = TensorShape(kernel_shape).Size();
     const int64_t X_offset = C / conv_attrs_.group * input_image_size;
     const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / conv_attrs_.group;
-    const int64_t W_offset = W->Shape().Size() / conv_attrs_.group;
+    const int64_t W_offset = W_shape.Size() / conv_attrs_.group;
     const int64_t kernel_dim = C / conv_attrs_.group * kernel_size;
     const int64_t col_buffer_size = kernel_dim * output_image_size;
 
@@ -278,7 +370,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
             output_image_size,
             kernel_dim,
             1,
-            W->Data<float>() + group_id * W_offset,
+            Wdata + group_id * W_offset,
             col_buffer_data,
             Beta,
             Ydata + group_id * Y_offset,
@@ -295,6 +387,188 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<MLFloat16>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                                /*out*/ bool& is_packed,
+                                /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  if (input_idx != 1) {
+    return Status::OK();
+  }
+
+  const size_t filter_bytes = tensor.SizeInBytes();
+  if (filter_bytes == 0) {
+    return Status::OK();
+  }
+
+  auto* filter_data = alloc->Alloc(filter_bytes);
+  packed_filter_ = BufferUniquePtr(filter_data, BufferDeleter(std::move(alloc)));
+  memcpy(filter_data, tensor.DataRaw(), filter_bytes);
+
+  filter_shape_ = tensor.Shape();
+  is_packed = true;
+
+  bool share_prepacked_weights = (prepacked_weights != nullptr);
+  if (share_prepacked_weights) {
+    prepacked_weights->buffers_.push_back(std::move(packed_filter_));
+    prepacked_weights->buffer_sizes_.push_back(filter_bytes);
+  }
+
+  return Status::OK();
+}
+
+Status Conv<MLFloat16>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                  int input_idx,
+                                                  /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_filter_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status Conv<MLFloat16>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const Tensor* W = packed_filter_ ? nullptr : context->Input<Tensor>(1);
+  const auto& W_shape = W ? W->Shape() : filter_shape_;
+  const Tensor* B = context->Input<Tensor>(2);  // optional. nullptr if not provided
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
+
+  ConvPadVector pads(conv_attrs_.pads);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  TensorShapeVector Y_dims({N, M});
+  TensorShape input_shape = X->Shape().Slice(2);
+  ORT_RETURN_IF_ERROR(conv_attrs_.InferPadsAndOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
+  Tensor* Y = context->Output(0, Y_dims);
+  TensorShape output_shape = Y->Shape().Slice(2);
+
+  // Bail out early if one of the dimensions is zero.
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const int64_t input_image_size = input_shape.Size();
+  const int64_t output_image_size = output_shape.Size();
+  const int64_t kernel_size = TensorShape(kernel_shape).Size();
+  const int64_t X_offset = C / conv_attrs_.group * input_image_size;
+  const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / conv_attrs_.group;
+  const int64_t W_offset = W_shape.Size() / conv_attrs_.group;
+  const int64_t kernel_dim = C / conv_attrs_.group * kernel_size;
+  const int64_t col_buffer_size = kernel_dim * output_image_size;
+  const int64_t group_filter_count = M / conv_attrs_.group;
+
+  const size_t kernel_rank = kernel_shape.size();
+
+  BufferUniquePtr col_buffer;
+
+  // Pointwise convolutions can use the original input tensor in place,
+  // otherwise a temporary buffer is required for the im2col transform.
+  if (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+    auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(MLAS_FP16)) * col_buffer_size);
+    col_buffer = BufferUniquePtr(col_data, BufferDeleter(std::move(alloc)));
+  }
+
+  // The im2col transform only moves values, so it runs on the raw fp16 bits. A zero bit pattern is +0.0.
+  auto* col_buffer_data = static_cast<MLAS_FP16*>(col_buffer.get());
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  const auto* Xdata = reinterpret_cast<const MLAS_FP16*>(X->Data<MLFloat16>());
+  const auto* Wdata = W ? reinterpret_cast<const MLAS_FP16*>(W->Data<MLFloat16>())
+                        : static_cast<const MLAS_FP16*>(packed_filter_.get());
+  const auto* Bdata = B != nullptr ? reinterpret_cast<const MLAS_FP16*>(B->Data<MLFloat16>()) : nullptr;
+  auto* Ydata = reinterpret_cast<MLAS_FP16*>(Y->MutableData<MLFloat16>());
+
+  for (int image_id = 0; image_id < N; ++image_id) {
+    for (int group_id = 0; group_id < conv_attrs_.group; ++group_id) {
+      if (col_buffer_data != nullptr) {
+        if (kernel_rank == 2) {
+          math::Im2col<uint16_t, StorageOrder::NCHW>()(
+              Xdata + group_id * X_offset,
+              C / conv_attrs_.group,
+              input_shape[0],
+              input_shape[1],
+              kernel_shape[0],
+              kernel_shape[1],
+              dilations[0],
+              dilations[1],
+              pads[0],
+              pads[1],
+              pads[2],
+              pads[3],
+              strides[0],
+              strides[1],
+              col_buffer_data);
+        } else {
+          math::Im2col<uint16_t, StorageOrder::NCHW>()(
+              Xdata + group_id * X_offset,
+              input_shape.GetDims().data(),
+              output_shape.GetDims().data(),
+              kernel_dim,
+              kernel_shape.data(),
+              strides.data(),
+              dilations.data(),
+              pads.data(),
+              static_cast<int>(kernel_shape.size()),
+              col_buffer_data);
+        }
+      }
+
+      // Seed the output with the bias so the multiply accumulates on top of it.
+      MLAS_FP16* group_y = Ydata + group_id * Y_offset;
+      if (Bdata != nullptr) {
+        for (int64_t m = 0; m < group_filter_count; m++) {
+          std::fill_n(group_y + m * output_image_size, output_image_size, Bdata[group_id * group_filter_count + m]);
+        }
+      }
+
+      MLAS_HALF_GEMM_DATA_PARAMS data;
+      data.A = Wdata + group_id * W_offset;
+      data.lda = static_cast<size_t>(kernel_dim);
+      data.B = col_buffer_data == nullptr ? Xdata + group_id * X_offset : col_buffer_data;
+      data.ldb = static_cast<size_t>(output_image_size);
+      data.C = group_y;
+      data.ldc = static_cast<size_t>(output_image_size);
+      data.beta = Bdata != nullptr ? 1.0f : 0.0f;
+
+      MlasHalfGemm(CblasNoTrans,
+                   static_cast<size_t>(group_filter_count),
+                   static_cast<size_t>(output_image_size),
+                   static_cast<size_t>(kernel_dim),
+                   data,
+                   thread_pool);
+    }
+
+    Xdata += X_offset * conv_attrs_.group;
+    Ydata += Y_offset * conv_attrs_.group;
+  }
+
+  return Status::OK();
+}
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Conv,
     1, 10,
@@ -307,4 +581,18 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Conv<float>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Conv,
+    1, 10,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Conv<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Conv,
+    11,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Conv<MLFloat16>);
+
 }  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -26,14 +27,61 @@ class Conv<float> : public OpKernel {
  public:
   Conv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    prepack_winograd_filter_ =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsConfigConvWinogradPrepack, "0") == "1";
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
-  
+
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // See kOrtSessionOptionsConfigConvWinogradPrepack.
+  bool prepack_winograd_filter_;
+
+  // Set if the filter is pre-packed for the Winograd algorithm, which releases the filter initializer. The filter is
+  // still needed by the shapes that MlasConvPrepare runs with another algorithm, so a copy is kept in packed_filter_.
+  TensorShape filter_shape_;
+  BufferUniquePtr packed_filter_;
+  // The filter transformed for F(4x4,3x3) and F(2x2,3x3).
+  BufferUniquePtr packed_winograd_filter_4x4_;
+  BufferUniquePtr packed_winograd_filter_2x2_;
+};
+
+// fp16 convolution through im2col and MlasHalfGemm, which accumulates in fp32.
+// See MatMul<MLFloat16> for how this differs from the Cast-wrapped fp32 Conv it replaces.
+template <>
+class Conv<MLFloat16> : public OpKernel {
+ public:
+  Conv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
+  }
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  ConvAttributes conv_attrs_;
+
+  // The filter is matrix A of MlasHalfGemm, which reads A unpacked, so the pre-packed filter is a copy in the
+  // original layout. Pre-packing still releases the filter initializer and lets sessions share the filter.
+  TensorShape filter_shape_;
+  BufferUniquePtr packed_filter_;
 };
 
 }  // namespace onnxruntime
@@ -5,6 +5,7 @@
 
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -74,6 +75,13 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
     inv_std_dev_data = inv_std_dev->MutableData<U>();
   }
 
+  if constexpr (std::is_same<T, float>::value && std::is_same<U, float>::value) {
+    MlasLayerNorm(X_data, scale_data, bias_data, Y_data, mean_data, inv_std_dev_data,
+                  static_cast<size_t>(norm_count), static_cast<size_t>(norm_size), epsilon, simplified,
+                  p_ctx->GetOperatorThreadPool());
+    return Status::OK();
+  }
+
   concurrency::ThreadPool::TryBatchParallelFor(
       p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
       [&](ptrdiff_t task_idx) {
@@ -4,6 +4,7 @@
 #include "core/common/inlined_containers.h"
 #include "core/providers/cpu/reduction/reduction_ops.h"
 #include "core/providers/common.h"
+#include "core/mlas/inc/mlas.h"
 //TODO: fix the warnings
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(disable : 26451)
@@ -281,6 +282,109 @@ void ReduceAggregatorBase::FastReduceRKR(const Tensor&, const gsl::span<const in
   ValidateMustBeOverloaded();
 }
 
+// The fast reductions of float tensors use the MLAS kernels: KR reduces contiguous rows, RK and KRK reduce the
+// columns of one or a batch of matrices along their rows. The partial results are combined in a fixed order, so
+// sums do not depend on the number of threads.
+static void MlasFastReduce(MLAS_REDUCE_KIND kind, FastReduceKind fast_kind, const Tensor& input,
+                           const gsl::span<const int64_t>& fast_shape, Tensor& output, concurrency::ThreadPool* tp) {
+  const float* data = input.Data<float>();
+  float* out = output.MutableData<float>();
+  switch (fast_kind) {
+    case FastReduceKind::kKR:
+      MlasReduceRows(kind, data, out, gsl::narrow<size_t>(fast_shape[0]), gsl::narrow<size_t>(fast_shape[1]), tp);
+      break;
+    case FastReduceKind::kRK:
+      MlasReduceColumns(kind, data, out, 1, gsl::narrow<size_t>(fast_shape[0]), gsl::narrow<size_t>(fast_shape[1]), tp);
+      break;
+    case FastReduceKind::kKRK:
+      MlasReduceColumns(kind, data, out, gsl::narrow<size_t>(fast_shape[0]), gsl::narrow<size_t>(fast_shape[1]),
+                        gsl::narrow<size_t>(fast_shape[2]), tp);
+      break;
+    default:
+      ValidateMustBeOverloaded();
+  }
+}
+
+template <>
+void ReduceAggregatorSum<float>::FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp) {
+  MlasFastReduce(MlasReduceSum, FastReduceKind::kKR, input, fast_shape, output, tp);
+}
+
+template <>
+void ReduceAggregatorSum<float>::FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp) {
+  MlasFastReduce(MlasReduceSum, FastReduceKind::kRK, input, fast_shape, output, tp);
+}
+
+template <>
+void ReduceAggregatorSum<float>::FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                               Tensor& output, concurrency::ThreadPool* tp) {
+  MlasFastReduce(MlasReduceSum, FastReduceKind::kKRK, input, fast_shape, output, tp);
+}
+
+template <>
+void ReduceAggregatorMax<float>::FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp) {
+  MlasFastReduce(MlasReduceMaximum, FastReduceKind::kKR, input, fast_shape, output, tp);
+}
+
+template <>
+void ReduceAggregatorMax<float>::FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp) {
+  MlasFastReduce(MlasReduceMaximum, FastReduceKind::kRK, input, fast_shape, output, tp);
+}
+
+template <>
+void ReduceAggregatorMax<float>::FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                               Tensor& output, concurrency::ThreadPool* tp) {
+  MlasFastReduce(MlasReduceMaximum, FastReduceKind::kKRK, input, fast_shape, output, tp);
+}
+
+template <>
+void ReduceAggregatorMin<float>::FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp) {
+  MlasFastReduce(MlasReduceMinimum, FastReduceKind::kKR, input, fast_shape, output, tp);
+}
+
+template <>
+void ReduceAggregatorMin<float>::FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp) {
+  MlasFastReduce(MlasReduceMinimum, FastReduceKind::kRK, input, fast_shape, output, tp);
+}
+
+template <>
+void ReduceAggregatorMin<float>::FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                               Tensor& output, concurrency::ThreadPool* tp) {
+  MlasFastReduce(MlasReduceMinimum, FastReduceKind::kKRK, input, fast_shape, output, tp);
+}
+
+template <>
+void ReduceAggregatorArgMinMax<float, int64_t>::FastArgReduce(FastReduceKind kind, const Tensor& input,
+                                                              const gsl::span<const int64_t>& fast_shape,
+                                                              Tensor& output, concurrency::ThreadPool* tp,
+                                                              bool is_max, bool select_last_index) {
+  const MLAS_REDUCE_KIND reduce_kind = is_max ? MlasReduceMaximum : MlasReduceMinimum;
+  const float* data = input.Data<float>();
+  int64_t* out = output.MutableData<int64_t>();
+  switch (kind) {
+    case FastReduceKind::kKR:
+      MlasArgReduceRows(reduce_kind, select_last_index, data, out, gsl::narrow<size_t>(fast_shape[0]),
+                        gsl::narrow<size_t>(fast_shape[1]), tp);
+      break;
+    case FastReduceKind::kRK:
+      MlasArgReduceColumns(reduce_kind, select_last_index, data, out, 1, gsl::narrow<size_t>(fast_shape[0]),
+                           gsl::narrow<size_t>(fast_shape[1]), tp);
+      break;
+    case FastReduceKind::kKRK:
+      MlasArgReduceColumns(reduce_kind, select_last_index, data, out, gsl::narrow<size_t>(fast_shape[0]),
+                           gsl::narrow<size_t>(fast_shape[1]), gsl::narrow<size_t>(fast_shape[2]), tp);
+      break;
+    default:
+      ValidateMustBeOverloaded();
+  }
+}
+
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
                                  gsl::span<const int64_t> reduced_axes,
                                  ResultsNoTransposePrepareForReduce& results) {
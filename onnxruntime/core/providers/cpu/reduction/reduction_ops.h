@@ -282,6 +282,19 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
   }
 };
 
+#ifndef SHARED_PROVIDER
+// The float fast reductions use the MLAS reduction kernels.
+template <>
+void ReduceAggregatorSum<float>::FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp);
+template <>
+void ReduceAggregatorSum<float>::FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp);
+template <>
+void ReduceAggregatorSum<float>::FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                               Tensor& output, concurrency::ThreadPool* tp);
+#endif
+
 template <typename T, typename TVAL = T>
 class ReduceAggregatorSumSquare : public ReduceAggregator<T, TVAL> {
  public:
@@ -444,6 +457,19 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
   }
 };
 
+#ifndef SHARED_PROVIDER
+// The float fast reductions use the MLAS reduction kernels.
+template <>
+void ReduceAggregatorMax<float>::FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp);
+template <>
+void ReduceAggregatorMax<float>::FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp);
+template <>
+void ReduceAggregatorMax<float>::FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                               Tensor& output, concurrency::ThreadPool* tp);
+#endif
+
 template <typename T, typename TVAL = int64_t>
 class ReduceAggregatorArgMinMax : public ReduceAggregator<T, TVAL> {
  protected:
@@ -459,8 +485,53 @@ class ReduceAggregatorArgMinMax : public ReduceAggregator<T, TVAL> {
   inline void enforce(const ResultsNoTransposePrepareForReduce& res) {
     ORT_ENFORCE(res.projected_index.size() == 0, "Only one axis is allowed for reduction.");
   }
+
+ protected:
+  // Fast reduction, only implemented for float with the MLAS arg reduction kernels.
+  static inline FastReduceKind WhichFastArgReduce() {
+    return std::is_same<T, float>::value && std::is_same<TVAL, int64_t>::value
+               ? FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK
+               : FastReduceKind::kNone;
+  }
+
+  static void FastArgReduce(FastReduceKind kind, const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp, bool is_max, bool select_last_index) {
+    ORT_UNUSED_PARAMETER(kind);
+    ORT_UNUSED_PARAMETER(is_max);
+    ORT_UNUSED_PARAMETER(select_last_index);
+    ReduceAggregatorBase::FastReduceKR(input, fast_shape, output, tp);
+  }
 };
 
+#ifndef SHARED_PROVIDER
+template <>
+void ReduceAggregatorArgMinMax<float, int64_t>::FastArgReduce(FastReduceKind kind, const Tensor& input,
+                                                              const gsl::span<const int64_t>& fast_shape,
+                                                              Tensor& output, concurrency::ThreadPool* tp,
+                                                              bool is_max, bool select_last_index);
+#endif
+
+// Declares the fast reductions of an arg reduction aggregator.
+#define REDUCE_AGGREGATOR_ARG_FAST_REDUCE(is_max, select_last_index)                                        \
+  static inline FastReduceKind WhichFastReduce() {                                                          \
+    return ReduceAggregatorArgMinMax<T, TVAL>::WhichFastArgReduce();                                        \
+  }                                                                                                         \
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,                 \
+                           Tensor& output, concurrency::ThreadPool* tp) {                                   \
+    ReduceAggregatorArgMinMax<T, TVAL>::FastArgReduce(FastReduceKind::kKR, input, fast_shape, output, tp,   \
+                                                      is_max, select_last_index);                           \
+  }                                                                                                         \
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,                 \
+                           Tensor& output, concurrency::ThreadPool* tp) {                                   \
+    ReduceAggregatorArgMinMax<T, TVAL>::FastArgReduce(FastReduceKind::kRK, input, fast_shape, output, tp,   \
+                                                      is_max, select_last_index);                           \
+  }                                                                                                         \
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,                \
+                            Tensor& output, concurrency::ThreadPool* tp) {                                  \
+    ReduceAggregatorArgMinMax<T, TVAL>::FastArgReduce(FastReduceKind::kKRK, input, fast_shape, output, tp,  \
+                                                      is_max, select_last_index);                           \
+  }
+
 template <typename T, typename TVAL = int64_t>
 class ReduceAggregatorArgMax : public ReduceAggregatorArgMinMax<T, TVAL> {
  public:
@@ -476,6 +547,9 @@ class ReduceAggregatorArgMax : public ReduceAggregatorArgMinMax<T, TVAL> {
     }
     ++this->index_;
   }
+
+  // Fast reduction
+  REDUCE_AGGREGATOR_ARG_FAST_REDUCE(true, false)
 };
 
 template <typename T, typename TVAL = int64_t>
@@ -495,6 +569,9 @@ class ReduceAggregatorArgMaxLastIndex : public ReduceAggregatorArgMax<T, TVAL> {
     }
     ++this->index_;
   }
+
+  // Fast reduction
+  REDUCE_AGGREGATOR_ARG_FAST_REDUCE(true, true)
 };
 
 template <typename T, typename TVAL = int64_t>
@@ -512,6 +589,9 @@ class ReduceAggregatorArgMin : public ReduceAggregatorArgMinMax<T, TVAL> {
     }
     ++this->index_;
   }
+
+  // Fast reduction
+  REDUCE_AGGREGATOR_ARG_FAST_REDUCE(false, false)
 };
 
 template <typename T, typename TVAL = int64_t>
@@ -531,6 +611,9 @@ class ReduceAggregatorArgMinLastIndex : public ReduceAggregatorArgMin<T, TVAL> {
     }
     ++this->index_;
   }
+
+  // Fast reduction
+  REDUCE_AGGREGATOR_ARG_FAST_REDUCE(false, true)
 };
 
 template <typename T>
@@ -619,6 +702,19 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
   }
 };
 
+#ifndef SHARED_PROVIDER
+// The float fast reductions use the MLAS reduction kernels.
+template <>
+void ReduceAggregatorMin<float>::FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp);
+template <>
+void ReduceAggregatorMin<float>::FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                              Tensor& output, concurrency::ThreadPool* tp);
+template <>
+void ReduceAggregatorMin<float>::FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                               Tensor& output, concurrency::ThreadPool* tp);
+#endif
+
 template <typename T>
 class ReduceAggregatorProd : public ReduceAggregator<T, T> {
  public:
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/async_run_queue.h"
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+AsyncRunQueue::AsyncRunQueue(const ORTCHAR_T* name, int num_threads) : num_threads_(num_threads) {
+  ORT_ENFORCE(num_threads > 0, "The number of threads running async requests must be positive. Got ", num_threads);
+  // the degree of parallelism of a ThreadPool counts the thread scheduling the work, which does not run requests here.
+  thread_pool_ = std::make_unique<concurrency::ThreadPool>(&Env::Default(), ThreadOptions(), name, num_threads + 1,
+                                                           false);
+}
+
+AsyncRunQueue::~AsyncRunQueue() {
+  std::deque<Request> pending;
+  {
+    std::unique_lock<OrtMutex> lock(mutex_);
+    pending.swap(requests_);
+    threads_done_cv_.wait(lock, [this]() { return num_active_threads_ == 0; });
+  }
+
+  for (auto& request : pending) {
+    request(true);
+  }
+}
+
+void AsyncRunQueue::Enqueue(Request request) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    requests_.push_back(std::move(request));
+    if (num_active_threads_ == num_threads_) {
+      // picked up by a running thread when it completes its current request
+      return;
+    }
+
+    ++num_active_threads_;
+  }
+
+  concurrency::ThreadPool::Schedule(thread_pool_.get(), [this]() { RunRequests(); });
+}
+
+void AsyncRunQueue::RunRequests() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  while (!requests_.empty()) {
+    Request request = std::move(requests_.front());
+    requests_.pop_front();
+    lock.unlock();
+    request(false);
+    lock.lock();
+  }
+
+  if (--num_active_threads_ == 0) {
+    threads_done_cv_.notify_all();
+  }
+}
+
+}  // namespace onnxruntime
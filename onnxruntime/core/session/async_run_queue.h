@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+/*
+Runs the requests of InferenceSession::RunAsync on a dedicated thread pool.
+
+The queue of a ThreadPool is bounded and a pool with a full queue runs the work on the thread scheduling it, which
+would block the caller of RunAsync. So the requests are kept in an unbounded queue here, and the pool is only given
+one task per thread, which runs requests until the queue is empty.
+*/
+class AsyncRunQueue {
+ public:
+  // cancelled is true if the queue was destroyed before the request could run.
+  using Request = std::function<void(bool cancelled)>;
+
+  AsyncRunQueue(const ORTCHAR_T* name, int num_threads);
+
+  // Cancels the pending requests and waits for the running ones to complete.
+  ~AsyncRunQueue();
+
+  void Enqueue(Request request);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(AsyncRunQueue);
+
+  void RunRequests();
+
+  const int num_threads_;
+
+  OrtMutex mutex_;
+  OrtCondVar threads_done_cv_;
+  std::deque<Request> requests_;
+  int num_active_threads_{0};
+
+  std::unique_ptr<concurrency::ThreadPool> thread_pool_;
+};
+
+}  // namespace onnxruntime
@@ -4,6 +4,8 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -32,6 +34,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/op_metrics.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/utils.h"
 #include "core/graph/graph_viewer.h"
@@ -43,6 +46,7 @@
 #include "core/optimizer/selectors_actions/selector_action_transformer_apply_contexts.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/optimizer/transpose_optimizer/optimizer_utils.h"
+#include "core/platform/atomic_file_write.h"
 #include "core/platform/Barrier.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
@@ -52,11 +56,13 @@
 #include "core/providers/dml/DmlExecutionProvider/src/DmlGraphFusionTransformer.h"
 #include "core/providers/dml/DmlExecutionProvider/src/GraphTransformer.h"
 #endif
+#include "core/session/async_run_queue.h"
 #include "core/session/environment.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/session_cache.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/util/thread_utils.h"
 
@@ -128,6 +134,19 @@ bool HasControlflowNodes(const Graph& graph) {
   return false;
 }
 
+// Whether the initializers of an ONNX model file are to refer to a memory mapping of the file.
+// They would be saved with memory addresses as the location of their data if the optimized model is saved as ONNX.
+bool UseMmapForInitializers(const SessionOptions& session_options) {
+#if defined(DISABLE_EXTERNAL_INITIALIZERS)
+  ORT_UNUSED_PARAMETER(session_options);
+  return false;
+#else
+  return session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseMmapForInitializers, "0") ==
+             "1" &&
+         session_options.optimized_model_filepath.empty();
+#endif
+}
+
 Status GetMinimalBuildOptimizationHandling(
     std::string_view config_value, bool saving_ort_format,
     InferenceSession::MinimalBuildOptimizationHandling& minimal_build_optimization_handling) {
@@ -160,6 +179,73 @@ Status GetMinimalBuildOptimizationHandling(
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+// The name of the first dim of a graph input or output, or an empty string if it is not a named dynamic dim.
+std::string GetBatchDimParam(const NodeArg& node_arg) {
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr || shape->dim_size() == 0 || !shape->dim(0).has_dim_param()) {
+    return {};
+  }
+
+  return shape->dim(0).dim_param();
+}
+
+// Whether each output element of every node only depends on the input elements at the same position, so that zero
+// padding the inputs along a dim leaves the other output elements as they are.
+bool HasOnlyElementwiseNodes(const Graph& graph) {
+  static const std::unordered_set<std::string> elementwise_ops{
+      "Abs", "Add", "And", "Cast", "Ceil", "Clip", "Div", "Elu", "Equal", "Erf", "Exp", "Floor", "Greater",
+      "HardSigmoid", "Identity", "LeakyRelu", "Less", "Log", "Max", "Min", "Mul", "Neg", "Not", "Or", "Pow",
+      "Reciprocal", "Relu", "Selu", "Sigmoid", "Sign", "Softplus", "Sqrt", "Sub", "Tanh", "Where"};
+  for (const auto& node : graph.Nodes()) {
+    if ((node.Domain() != kOnnxDomain && node.Domain() != kOnnxDomainAlias) ||
+        elementwise_ops.count(node.OpType()) == 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Finds the input dim that each dim after the first of each graph output follows, by the names of the dims.
+// Returns false if an output has a dim that is neither fixed nor follows an input dim, so can not be cropped.
+bool GetBatchOutputDims(const Graph& graph,
+                        std::unordered_map<std::string, std::vector<RequestBatcherOptions::InputDim>>& output_dims) {
+  std::unordered_map<std::string, RequestBatcherOptions::InputDim> input_dims;
+  for (const auto* input : graph.GetInputs()) {
+    const auto* shape = input->Shape();
+    for (int dim = 1; shape != nullptr && dim < shape->dim_size(); ++dim) {
+      if (shape->dim(dim).has_dim_param()) {
+        input_dims.emplace(shape->dim(dim).dim_param(),
+                           RequestBatcherOptions::InputDim{input->Name(), static_cast<size_t>(dim)});
+      }
+    }
+  }
+
+  for (const auto* output : graph.GetOutputs()) {
+    const auto* shape = output->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+
+    auto& dims = output_dims[output->Name()];
+    for (int dim = 1; dim < shape->dim_size(); ++dim) {
+      if (shape->dim(dim).has_dim_value()) {
+        dims.emplace_back();
+        continue;
+      }
+
+      auto it = shape->dim(dim).has_dim_param() ? input_dims.find(shape->dim(dim).dim_param()) : input_dims.end();
+      if (it == input_dims.end()) {
+        return false;
+      }
+
+      dims.push_back(it->second);
+    }
+  }
+
+  return true;
+}
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -249,6 +335,10 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 #if !defined(ORT_MINIMAL_BUILD)
   // Update the number of steps for the graph transformer manager using the "finalized" session options
   ORT_ENFORCE(graph_transformation_mgr_.SetSteps(session_options_.max_num_graph_transformation_steps).IsOK());
+  const bool incremental_graph_transformation =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIncrementalGraphTransformation,
+                                                         "0") == "1";
+  ORT_ENFORCE(graph_transformation_mgr_.SetUseWorklist(incremental_graph_transformation).IsOK());
 #endif
 
   bool set_denormal_as_zero =
@@ -289,6 +379,11 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_vec_len == 0;
         to.allow_spinning = allow_intra_op_spinning;
+        to.numa_aware =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaAware, "0") == "1";
+        to.replicate_weights_per_numa_node =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaReplicatePrepackedWeights,
+                                                               "0") == "1";
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
 
@@ -394,7 +489,8 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
       insert_cast_transformer_("CastFloat16Transformer"),
       logging_manager_(session_env.GetLoggingManager()),
       environment_(session_env) {
-  auto status = Model::Load(model_location_, model_proto_);
+  auto status = UseMmapForInitializers(session_options) ? LoadMappedOnnxModelProto(model_location_, model_proto_)
+                                                        : Model::Load(model_location_, model_proto_);
   ORT_ENFORCE(status.IsOK(), "Given model could not be parsed while creating inference session. Error message: ",
               status.ErrorMessage());
   is_model_proto_parsed_ = true;
@@ -439,6 +535,9 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  // cancel the queued RunAsync requests and wait for the running ones while the session is still intact
+  async_run_queue_.reset();
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -695,6 +794,14 @@ common::Status InferenceSession::LoadOnnxModel(const PathString& model_uri) {
 #endif
     const bool strict_shape_type_inference = session_options_.config_options.GetConfigOrDefault(
                                                  kOrtSessionOptionsConfigStrictShapeTypeInference, "0") == "1";
+    if (UseMmapForInitializers(session_options_)) {
+      ONNX_NAMESPACE::ModelProto model_proto;
+      ORT_RETURN_IF_ERROR(LoadMappedOnnxModelProto(model_location_, model_proto));
+      return onnxruntime::Model::Load(std::move(model_proto), model_location_, model,
+                                      HasLocalSchema() ? &custom_schema_registries_ : nullptr, *session_logger_,
+                                      ModelOptions(true, strict_shape_type_inference));
+    }
+
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
                                     *session_logger_,
                                     ModelOptions(true, strict_shape_type_inference));
@@ -709,6 +816,43 @@ common::Status InferenceSession::LoadOnnxModel(const PathString& model_uri) {
   return Status::OK();
 }
 
+common::Status InferenceSession::LoadMappedOnnxModelProto(const PathString& model_uri,
+                                                          ONNX_NAMESPACE::ModelProto& model_proto) {
+  const Env& env = Env::Default();
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(model_uri.c_str(), file_length));
+  ORT_RETURN_IF(file_length > static_cast<size_t>(std::numeric_limits<int>::max()),
+                "Model file ", ToUTF8String(model_uri), " is too large to be parsed as a protobuf.");
+
+  Env::MappedMemoryPtr mapped_bytes;
+  const auto status = env.MapFileIntoMemory(model_uri.c_str(), 0, file_length, mapped_bytes);
+  if (!status.IsOK()) {
+    LOGS_DEFAULT(WARNING) << "Reading the model file as it could not be memory mapped: " << status.ErrorMessage();
+    return Model::Load(model_uri, model_proto);
+  }
+
+  ORT_RETURN_IF_ERROR(Model::LoadFromBytes(static_cast<int>(file_length), mapped_bytes.get(), model_proto));
+  const gsl::span<const uint8_t> model_bytes(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), file_length);
+
+  // the walk over the model bytes rejects valid but unusual encodings, e.g. a graph field that is repeated.
+  // the model proto is left as parsed then, and the initializers keep their copy.
+  size_t num_initializers = 0;
+  const auto use_status = utils::UseModelBytesForInitializers(model_bytes, model_proto, num_initializers);
+  if (!use_status.IsOK()) {
+    LOGS_DEFAULT(WARNING) << "Initializers can not be used in place from the memory mapped model file: "
+                          << use_status.ErrorMessage();
+    return Status::OK();
+  }
+
+  LOGS_DEFAULT(INFO) << num_initializers << " initializers refer to the memory mapped model file.";
+
+  if (num_initializers > 0) {
+    onnx_model_mapped_bytes_ = std::move(mapped_bytes);
+  }
+
+  return Status::OK();
+}
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -763,6 +907,12 @@ common::Status InferenceSession::Load(const void* model_data, int model_data_len
                            "Invoke Load().");
   }
 
+  // the session cache is keyed by a hash of the model bytes, which are not kept
+  if (!session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "")
+           .empty()) {
+    model_bytes_hash_ = session_cache::HashModelBytes(model_data, static_cast<size_t>(model_data_len));
+  }
+
   auto loader = [this, model_data, model_data_len](std::shared_ptr<onnxruntime::Model>& model) {
     ModelProto model_proto;
 
@@ -1013,6 +1163,23 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
 
   ORT_RETURN_IF_ERROR(load_ort_format_model_bytes());
 
+  // if we're using the bytes directly because kOrtSessionOptionsConfigUseORTModelBytesDirectly was set and the user
+  // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
+  // will be empty.
+  // if that is the case we also allow creating initializers that directly use those bytes.
+  const auto& config_options = session_options_.config_options;
+  const bool use_ort_model_bytes_for_initializers =
+      ort_format_model_bytes_data_holder_.empty() &&
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+
+  ORT_RETURN_IF_ERROR(LoadOrtModelFromBytes(use_ort_model_bytes_for_initializers));
+
+  is_model_loaded_ = true;
+
+  return Status::OK();
+}
+
+Status InferenceSession::LoadOrtModelFromBytes(bool use_ort_model_bytes_for_initializers) {
   // Verify the ort_format_model_bytes_ is a valid InferenceSessionBuffer before we access the data
   flatbuffers::Verifier verifier(ort_format_model_bytes_.data(), ort_format_model_bytes_.size());
   ORT_RETURN_IF_NOT(fbs::VerifyInferenceSessionBuffer(verifier), "ORT model verification failed.");
@@ -1038,47 +1205,190 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   const auto* fbs_model = fbs_session->model();
   ORT_RETURN_IF(nullptr == fbs_model, "Missing Model. Invalid ORT format model.");
 
-  // if we're using the bytes directly because kOrtSessionOptionsConfigUseORTModelBytesDirectly was set and the user
-  // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
-  // will be empty.
-  // if that is the case we also allow creating initializers that directly use those bytes.
-  const auto& config_options = session_options_.config_options;
-  using_ort_model_bytes_for_initializers_ =
-      ort_format_model_bytes_data_holder_.empty() &&
-      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+  // load the kernel type string resolver first so that a failure leaves any existing model in place
+  KernelTypeStrResolver kernel_type_str_resolver{};
+  if (const auto* fbs_kernel_type_str_resolver = fbs_session->kernel_type_str_resolver();
+      fbs_kernel_type_str_resolver != nullptr) {
+    ORT_RETURN_IF_ERROR(kernel_type_str_resolver.LoadFromOrtFormat(*fbs_kernel_type_str_resolver));
+  }
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  ORT_RETURN_IF_ERROR(
+      kernel_type_str_resolver_utils::AddLayoutTransformationRequiredOpsToKernelTypeStrResolver(
+          kernel_type_str_resolver));
+#endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
   // need to go from unique_ptr to shared_ptr when moving into model_
   std::unique_ptr<Model> tmp_model;
 #if !defined(ORT_MINIMAL_BUILD)
   ORT_RETURN_IF_ERROR(Model::LoadFromOrtFormat(*fbs_model,
                                                HasLocalSchema() ? &custom_schema_registries_ : nullptr,
-                                               using_ort_model_bytes_for_initializers_,
+                                               use_ort_model_bytes_for_initializers,
                                                *session_logger_, tmp_model));
 #else
-  ORT_RETURN_IF_ERROR(Model::LoadFromOrtFormat(*fbs_model, using_ort_model_bytes_for_initializers_, *session_logger_,
+  ORT_RETURN_IF_ERROR(Model::LoadFromOrtFormat(*fbs_model, use_ort_model_bytes_for_initializers, *session_logger_,
                                                tmp_model));
 #endif
 
   ORT_RETURN_IF_ERROR(SaveModelMetadata(*tmp_model));
   model_ = std::move(tmp_model);
+  using_ort_model_bytes_for_initializers_ = use_ort_model_bytes_for_initializers;
 
-  KernelTypeStrResolver kernel_type_str_resolver{};
-  if (const auto* fbs_kernel_type_str_resolver = fbs_session->kernel_type_str_resolver();
-      fbs_kernel_type_str_resolver != nullptr) {
-    ORT_RETURN_IF_ERROR(kernel_type_str_resolver.LoadFromOrtFormat(*fbs_kernel_type_str_resolver));
-  }
-#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
-  ORT_RETURN_IF_ERROR(
-      kernel_type_str_resolver_utils::AddLayoutTransformationRequiredOpsToKernelTypeStrResolver(
-          kernel_type_str_resolver));
-#endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
   kernel_registry_manager_.SetKernelTypeStrResolver(std::move(kernel_type_str_resolver));
 
-  is_model_loaded_ = true;
+  return Status::OK();
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+Status InferenceSession::LoadFromSessionCache() {
+  const std::string cache_dir =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "");
+  if (cache_dir.empty() || !ort_format_model_bytes_.empty()) {
+    // no cache, or the model is already in ORT format
+    return Status::OK();
+  }
+
+#if !defined(DISABLE_EXTERNAL_INITIALIZERS)
+  if (!session_options_.external_initializers.empty()) {
+    LOGS(*session_logger_, INFO) << "The session cache is not used as the session has external initializers.";
+    return Status::OK();
+  }
+#endif
+
+  std::string model_hash = model_bytes_hash_;
+  if (model_hash.empty()) {
+    if (model_location_.empty()) {
+      LOGS(*session_logger_, INFO) << "The session cache is only used for models loaded from a file or from bytes.";
+      return Status::OK();
+    }
+
+    ORT_RETURN_IF_ERROR(session_cache::HashModelFile(model_location_, model_hash));
+  }
+
+  // the weights of large models are in external data files, which can change while the model file stays the same
+  ORT_RETURN_IF_ERROR(session_cache::AddExternalDataHashes(model_->MainGraph(), model_location_, model_hash));
+
+  const Env& env = Env::Default();
+  if (!env.FolderExists(cache_dir)) {
+    ORT_RETURN_IF_ERROR(env.CreateFolder(cache_dir));
+  }
+
+  const PathString cache_file = session_cache::GetCacheFilePath(cache_dir, model_hash, session_options_,
+                                                                optimizers_to_disable_, execution_providers_);
+
+  size_t num_bytes = 0;
+  if (!env.GetFileLength(cache_file.c_str(), num_bytes).IsOK()) {
+    // the optimized model is written to the cache file once the model is optimized, and the pre-packed weights
+    // once the kernels pre-packed them
+    session_cache_file_ = cache_file;
+    session_cache_prepacked_weights_file_ = session_cache::GetPrePackedWeightsFilePath(cache_file);
+    return Status::OK();
+  }
+
+  // the initializers of the model refer to the mapped file, which is kept for the lifetime of the session
+  Env::MappedMemoryPtr mapped_bytes;
+  Status status = env.MapFileIntoMemory(cache_file.c_str(), 0, num_bytes, mapped_bytes);
+  if (status.IsOK()) {
+    ort_format_model_bytes_ = gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_bytes.get()),
+                                                       num_bytes);
+    status = LoadOrtModelFromBytes(true);
+  } else {
+    status = LoadOrtModelBytes(cache_file, ort_format_model_bytes_, ort_format_model_bytes_data_holder_);
+    if (status.IsOK()) {
+      status = LoadOrtModelFromBytes(false);
+    }
+  }
+
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Replacing invalid session cache file " << ToUTF8String(cache_file) << ": "
+                                    << status.ErrorMessage();
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+    session_cache_file_ = cache_file;
+    session_cache_prepacked_weights_file_ = session_cache::GetPrePackedWeightsFilePath(cache_file);
+    return Status::OK();
+  }
+
+  ort_format_model_mapped_bytes_ = std::move(mapped_bytes);
+  // the ONNX model the initializers referred to before is replaced
+  onnx_model_mapped_bytes_.reset();
+  LOGS(*session_logger_, INFO) << "Using the optimized model from session cache file " << ToUTF8String(cache_file);
+
+  LoadSessionCachePrePackedWeights(cache_file);
 
   return Status::OK();
 }
 
+void InferenceSession::LoadSessionCachePrePackedWeights(const PathString& cache_file) {
+  const Env& env = Env::Default();
+  const PathString file = session_cache::GetPrePackedWeightsFilePath(cache_file);
+
+  // a session that pre-packed nothing writes no file. looking for the file again is cheaper than pre-packing.
+  size_t num_bytes = 0;
+  Status status = env.GetFileLength(file.c_str(), num_bytes);
+  Env::MappedMemoryPtr mapped_bytes;
+  if (status.IsOK()) {
+    status = env.MapFileIntoMemory(file.c_str(), 0, num_bytes, mapped_bytes);
+  }
+
+  if (status.IsOK()) {
+    status = session_cache::ParsePrePackedWeights(
+        gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes),
+        session_cache_prepacked_weights_);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Replacing invalid pre-packed weights file " << ToUTF8String(file) << ": "
+                                      << status.ErrorMessage();
+    }
+  }
+
+  if (!status.IsOK()) {
+    session_cache_prepacked_weights_.clear();
+    session_cache_prepacked_weights_file_ = file;
+    return;
+  }
+
+  session_cache_prepacked_weights_mapped_bytes_ = std::move(mapped_bytes);
+  LOGS(*session_logger_, INFO) << "Using the pre-packed weights from session cache file " << ToUTF8String(file);
+}
+
+void InferenceSession::WriteSessionCachePrePackedWeights() {
+  const auto& prepacked_weights = session_state_->GetPrePackedWeightsToSave();
+  if (prepacked_weights.empty()) {
+    return;
+  }
+
+  const PathString temporary_file =
+      GetTemporaryFilePath(session_cache_prepacked_weights_file_, std::to_string(session_id_));
+  Status status = session_cache::SavePrePackedWeights(prepacked_weights, temporary_file);
+  if (status.IsOK()) {
+    status = ReplaceWithTemporaryFile(temporary_file, session_cache_prepacked_weights_file_);
+  }
+
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to write pre-packed weights file "
+                                    << ToUTF8String(session_cache_prepacked_weights_file_) << ": "
+                                    << status.ErrorMessage();
+    RemoveTemporaryFile(temporary_file);
+  }
+}
+
+void InferenceSession::WriteSessionCacheFile(PathString& temporary_file) {
+  if (session_state_->GetFuncMgr().NumFuncs() > 0) {
+    LOGS(*session_logger_, INFO) << "The optimized model is not cached as it contains compiled nodes.";
+    return;
+  }
+
+  // unique across the sessions of all the processes sharing the cache directory
+  temporary_file = GetTemporaryFilePath(session_cache_file_, std::to_string(session_id_));
+  const Status status = SaveToOrtFormat(temporary_file);
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to write session cache file " << ToUTF8String(temporary_file) << ": "
+                                    << status.ErrorMessage();
+    RemoveTemporaryFile(temporary_file);
+    temporary_file.clear();
+  }
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 bool InferenceSession::IsInitialized() const {
   std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
   return is_inited_;
@@ -1195,6 +1505,18 @@ static void ResolveMemoryPatternFlags(SessionState& session_state) {
     }
   }
 }
+
+static Status GenerateStaticMemoryPatterns(SessionState& session_state) {
+  ORT_RETURN_IF_ERROR(session_state.GenerateStaticMemoryPatterns());
+
+  for (const auto& entry : session_state.GetSubgraphSessionStateMap()) {
+    for (const auto& name_to_subgraph_session_state : entry.second) {
+      ORT_RETURN_IF_ERROR(GenerateStaticMemoryPatterns(*name_to_subgraph_session_state.second));
+    }
+  }
+
+  return Status::OK();
+}
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(push)
 // VC++ reports: "Releasing unheld lock 'l' in function 'onnxruntime::InferenceSession::Initialize'". But I don't see anything wrong.
@@ -1230,6 +1552,11 @@ common::Status InferenceSession::Initialize() {
       have_cpu_ep = execution_providers_.Get(onnxruntime::kCpuExecutionProvider) != nullptr;
     }
 
+#if !defined(ORT_MINIMAL_BUILD)
+    // Replace the model with its optimized version from the session cache if there is one.
+    ORT_RETURN_IF_ERROR_SESSIONID_(LoadFromSessionCache());
+#endif
+
     // Verify that there are no external initializers in the graph if external data is disabled.
     onnxruntime::Graph& graph = model_->MainGraph();
 #ifdef DISABLE_EXTERNAL_INITIALIZERS
@@ -1312,6 +1639,23 @@ common::Status InferenceSession::Initialize() {
         session_options_.enable_mem_reuse,
         prepacked_weights_container_);
 
+    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
+      session_state_->SetUseDataflowExecutor(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseDataflowExecutor, "0") == "1");
+    }
+
+    if (session_state_->GetEnableMemoryPattern()) {
+      MemoryPatternCacheOptions mem_pattern_cache_options;
+      ORT_RETURN_IF_ERROR_SESSIONID_(MemoryPatternCacheOptions::ParseBuckets(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternBuckets, ""),
+          mem_pattern_cache_options.bucket_kind, mem_pattern_cache_options.bucket_boundaries));
+      const std::string cache_size_str =
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternCacheSize, "0");
+      ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(cache_size_str, mem_pattern_cache_options.max_entries),
+                        "Invalid value for ", kOrtSessionOptionsConfigMemoryPatternCacheSize, ": ", cache_size_str);
+      session_state_->SetMemoryPatternCacheOptions(mem_pattern_cache_options);
+    }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
     // Don't want to pollute SessionState constructor since memory profile is enabled optionally.
     session_state_->SetMemoryProfiler(&memory_profiler_);
@@ -1378,6 +1722,10 @@ common::Status InferenceSession::Initialize() {
       }
 #endif
 
+      graph.SetSkipUnchangedInference(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigResolveSkipUnchangedInference,
+                                                             "0") == "1");
+
       // apply any transformations to the main graph and any subgraphs
       ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
                                                     execution_providers_, kernel_registry_manager_,
@@ -1443,12 +1791,55 @@ common::Status InferenceSession::Initialize() {
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
     }
 
-    ORT_RETURN_IF_ERROR_SESSIONID_(
+#if !defined(ORT_MINIMAL_BUILD)
+    // Write the optimized model to the session cache while the graph still has its initializers. The file replaces
+    // the cache file once the session state is finalized.
+    PathString session_cache_temporary_file;
+    if (!session_cache_file_.empty()) {
+      WriteSessionCacheFile(session_cache_temporary_file);
+      if (session_cache_temporary_file.empty()) {
+        // the pre-packed weights go with the cache file
+        session_cache_prepacked_weights_file_.clear();
+      }
+    }
+
+    // the kernels that can take pre-packed weights from an earlier session skip PrePack, the others pre-pack
+    // into weights the session state keeps so that they can be saved
+    if (!session_cache_prepacked_weights_file_.empty()) {
+      session_state_->SetKeepPrePackedWeightsToSave(true);
+    } else if (!session_cache_prepacked_weights_.empty()) {
+      session_state_->SetSavedPrePackedWeights(std::move(session_cache_prepacked_weights_));
+      session_cache_prepacked_weights_.clear();
+    }
+#endif
+
+    const Status finalize_status =
         session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                              session_options_,
                                              // need to keep the initializers if saving the optimized model
                                              !saving_model,
-                                             saving_ort_format));
+                                             saving_ort_format);
+
+#if !defined(ORT_MINIMAL_BUILD)
+    // written before the cache file so that sessions that load the cache file find the weights
+    if (finalize_status.IsOK() && !session_cache_prepacked_weights_file_.empty()) {
+      WriteSessionCachePrePackedWeights();
+    }
+
+    if (!session_cache_temporary_file.empty()) {
+      if (finalize_status.IsOK()) {
+        // concurrent sessions see either no cache file or the complete file
+        const Status replace_status = ReplaceWithTemporaryFile(session_cache_temporary_file, session_cache_file_);
+        if (!replace_status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Failed to write session cache file: " << replace_status.ErrorMessage();
+        }
+      } else {
+        RemoveTemporaryFile(session_cache_temporary_file);
+      }
+    }
+#endif
+
+    ORT_RETURN_IF_ERROR_SESSIONID_(finalize_status);
 
 #if !defined(ORT_MINIMAL_BUILD)
     if (saving_model) {
@@ -1479,6 +1870,17 @@ common::Status InferenceSession::Initialize() {
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigStaticMemoryPlanning, "0") == "1") {
+      ORT_RETURN_IF_ERROR_SESSIONID_(GenerateStaticMemoryPatterns(*session_state_));
+    }
+
+    ORT_RETURN_IF_ERROR_SESSIONID_(CreateRequestBatcher());
+
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableOpMetrics, "0") == "1") {
+      op_metrics_ = std::make_unique<OpMetrics>(session_state_->GetGraphViewer());
+      session_state_->SetOpMetrics(op_metrics_.get());
+    }
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
@@ -1546,6 +1948,116 @@ int InferenceSession::GetCurrentNumRuns() const {
   return current_num_runs_.load();
 }
 
+MemoryPatternCacheStats InferenceSession::GetMemoryPatternCacheStats() const {
+  return session_state_ ? session_state_->GetMemoryPatternCacheStats() : MemoryPatternCacheStats{};
+}
+
+SharedWeightStats InferenceSession::GetSharedWeightStats() const {
+  return session_state_ ? session_state_->GetSharedWeightStats() : SharedWeightStats{};
+}
+
+common::Status InferenceSession::GetScratchBufferSize(gsl::span<const std::string> feed_names,
+                                                      gsl::span<const OrtValue> feeds,
+                                                      const OrtMemoryInfo& location, size_t& size) const {
+  size = 0;
+  if (!is_inited_) {
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+
+  // the memory pattern is only used if every feed is a tensor
+  if (!session_state_->GetEnableMemoryPattern() ||
+      std::any_of(feeds.begin(), feeds.end(), [](const OrtValue& feed) { return !feed.IsTensor(); })) {
+    return Status::OK();
+  }
+
+  size = session_state_->GetMemoryPatternPeakSize(feeds, location);
+  return Status::OK();
+}
+
+StaticMemoryPlanSummary InferenceSession::GetStaticMemoryPlanSummary() const {
+  return session_state_ ? session_state_->GetStaticMemoryPlanSummary() : StaticMemoryPlanSummary{};
+}
+
+RequestBatcherStats InferenceSession::GetRequestBatcherStats() const {
+  return request_batcher_ ? request_batcher_->GetStats() : RequestBatcherStats{};
+}
+
+common::Status InferenceSession::GetOpMetrics(std::string& metrics) const {
+  ORT_RETURN_IF_NOT(op_metrics_, "Op metrics are not enabled. Set ", kOrtSessionOptionsConfigEnableOpMetrics,
+                    " to 1 in the session options to enable them.");
+  metrics = op_metrics_->ToJson();
+  return Status::OK();
+}
+
+common::Status InferenceSession::ResetOpMetrics() {
+  ORT_RETURN_IF_NOT(op_metrics_, "Op metrics are not enabled. Set ", kOrtSessionOptionsConfigEnableOpMetrics,
+                    " to 1 in the session options to enable them.");
+  op_metrics_->Reset();
+  return Status::OK();
+}
+
+common::Status InferenceSession::CreateRequestBatcher() {
+  RequestBatcherOptions options;
+  const std::string max_batch_size_str =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigBatchingMaxBatchSize, "0");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_batch_size_str, options.max_batch_size) &&
+                        options.max_batch_size >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigBatchingMaxBatchSize, ": ", max_batch_size_str);
+  if (options.max_batch_size == 0) {
+    return Status::OK();
+  }
+
+  const std::string max_wait_str =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigBatchingMaxWaitUs, "1000");
+  int64_t max_wait_us = 0;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_wait_str, max_wait_us) && max_wait_us >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigBatchingMaxWaitUs, ": ", max_wait_str);
+  options.max_wait = std::chrono::microseconds(max_wait_us);
+  options.pad_ragged_dims =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigBatchingPadRaggedDims, "0") == "1";
+
+  // the inputs of the requests are concatenated along their first dim and the outputs are split along theirs, so
+  // every input and output needs the same named batch dim first
+  const Graph& graph = model_->MainGraph();
+  const std::string batch_dim = graph.GetInputs().empty() ? std::string() : GetBatchDimParam(*graph.GetInputs()[0]);
+  const auto has_batch_dim = [&batch_dim](const NodeArg* node_arg) {
+    return GetBatchDimParam(*node_arg) == batch_dim;
+  };
+  if (batch_dim.empty() || !std::all_of(graph.GetInputs().cbegin(), graph.GetInputs().cend(), has_batch_dim) ||
+      !std::all_of(graph.GetOutputs().cbegin(), graph.GetOutputs().cend(), has_batch_dim)) {
+    LOGS(*session_logger_, WARNING) << kOrtSessionOptionsConfigBatchingMaxBatchSize
+                                    << " is set but the inputs and outputs of the model do not all have the same named"
+                                    << " dynamic batch dim first. Requests are not batched.";
+    return Status::OK();
+  }
+
+  // padding is only safe if the padded elements can not mix into the others and the outputs can be cropped back
+  if (options.pad_ragged_dims &&
+      (!HasOnlyElementwiseNodes(graph) ||
+       !GetBatchOutputDims(graph, options.output_dims))) {
+    LOGS(*session_logger_, WARNING) << kOrtSessionOptionsConfigBatchingPadRaggedDims
+                                    << " is set but the model has nodes that are not elementwise or outputs whose"
+                                    << " dims do not follow the input dims. Ragged inputs are not padded.";
+    options.pad_ragged_dims = false;
+    options.output_dims.clear();
+  }
+
+  auto* cpu_provider = execution_providers_.Get(onnxruntime::kCpuExecutionProvider);
+  ORT_RETURN_IF(cpu_provider == nullptr, "Request batching requires the CPU execution provider.");
+  request_batcher_ = std::make_unique<RequestBatcher>(
+      options, cpu_provider->GetAllocator(0, OrtMemTypeDefault),
+      [this](const RunOptions& run_options, gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches) {
+        return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, nullptr);
+      });
+
+  LOGS(*session_logger_, INFO) << "Batching concurrent requests up to a batch size of " << options.max_batch_size
+                               << ", waiting up to " << max_wait_us << "us";
+  return Status::OK();
+}
+
 const std::vector<std::string>& InferenceSession::GetRegisteredProviderTypes() const {
   return execution_providers_.GetIds();
 }
@@ -1844,6 +2356,21 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  if (request_batcher_ != nullptr && p_fetches != nullptr && p_fetches_device_info == nullptr &&
+      run_options.scratch_buffer == nullptr && RequestBatcher::CanBatch(feeds, *p_fetches)) {
+    // an invalid request fails on its own instead of failing the batch it would join
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+    return request_batcher_->Run(run_options, feed_names, feeds, output_names, *p_fetches);
+  }
+
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -1951,9 +2478,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
       session_state_->IncrementGraphExecutionCounter();
 #endif
 
+      const ScratchBuffer scratch_buffer{run_options.scratch_buffer, run_options.scratch_buffer_size,
+                                         run_options.scratch_buffer_location};
       ORT_CHECK_AND_SET_RETVAL(utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
                                                    session_options_.execution_mode, run_options.terminate, run_logger,
-                                                   run_options.only_execute_path_to_fetches));
+                                                   run_options.only_execute_path_to_fetches,
+                                                   run_options.scratch_buffer ? &scratch_buffer : nullptr));
     }
     ORT_CATCH(const std::exception& e) {
       ORT_HANDLE_EXCEPTION([&]() {
@@ -2112,6 +2642,66 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions* run_options, std::vector<std::string> feed_names,
+                                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                                          std::vector<OrtValue> fetches, RunAsyncCallback callback) {
+  ORT_RETURN_IF_NOT(callback, "A callback is required to run asynchronously.");
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(async_run_queue_mutex_);
+    if (!async_run_queue_) {
+      // by default as many requests run at the same time as the intra-op thread pool has threads
+      int num_threads = concurrency::ThreadPool::DegreeOfParallelism(GetIntraOpThreadPoolToUse());
+      std::string num_threads_str;
+      if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigRunAsyncThreads,
+                                                            num_threads_str)) {
+        ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(num_threads_str, num_threads) && num_threads > 0,
+                          "Invalid value for ", kOrtSessionOptionsConfigRunAsyncThreads, ": ", num_threads_str);
+      }
+
+      std::basic_ostringstream<ORTCHAR_T> ss;
+      ss << ORT_TSTR("session-") << session_id_ << ORT_TSTR("-run-async");
+      async_run_thread_pool_name_ = ss.str();
+      async_run_queue_ = std::make_unique<AsyncRunQueue>(async_run_thread_pool_name_.c_str(), num_threads);
+      LOGS(*session_logger_, INFO) << "Created " << num_threads << " threads to run async requests";
+    }
+  }
+
+  async_run_queue_->Enqueue(
+      [this, run_options, feed_names = std::move(feed_names), feeds = std::move(feeds),
+       output_names = std::move(output_names), fetches = std::move(fetches),
+       callback = std::move(callback)](bool cancelled) mutable {
+        if (cancelled) {
+          callback(ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The session was destroyed before the request could run."),
+                   fetches);
+          return;
+        }
+
+        RunOptions default_run_options;
+        Status status;
+        ORT_TRY {
+          status = Run(run_options != nullptr ? *run_options : default_run_options, feed_names, feeds, output_names,
+                       &fetches, nullptr);
+        }
+        ORT_CATCH(const std::exception& e) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, e.what());
+          });
+        }
+
+        callback(status, fetches);
+      });
+
+  return Status::OK();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
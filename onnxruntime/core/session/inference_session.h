@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -23,6 +24,8 @@
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/framework/session_options.h"
+#include "core/platform/env.h"
+#include "core/session/request_batcher.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
@@ -51,7 +54,9 @@ struct OrtCustomOpDomain {
 namespace onnxruntime {
 class IExecutionProvider;  // forward decl
 class IOBinding;
+class AsyncRunQueue;
 class CustomRegistry;
+class OpMetrics;
 struct Notification;
 
 namespace logging {
@@ -340,6 +345,23 @@ class InferenceSession {
   virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding) ORT_MUST_USE_RESULT;
   common::Status Run(IOBinding& io_binding) ORT_MUST_USE_RESULT;
 
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+   * Queue a Run of a pre-loaded and pre-intialized model and return without waiting for it to complete.
+   * Requests are run in the order they are queued, by threads dedicated to them that are created by the first call.
+   * The number of threads is set by the "session.run_async_threads" session config entry, and defaults to the number
+   * of threads of the intra-op thread pool.
+   * @param run_options must remain valid until the callback is called. nullptr to use the default options.
+   * @param fetches optional pre-allocated outputs, as for Run.
+   * @param callback called from one of the threads with the status and the outputs of the run. It is called with an
+   *        error status if the session is destroyed before the request runs.
+   * @return OK if the request was queued.
+   */
+  common::Status RunAsync(const RunOptions* run_options, std::vector<std::string> feed_names,
+                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                          std::vector<OrtValue> fetches, RunAsyncCallback callback) ORT_MUST_USE_RESULT;
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -398,6 +420,54 @@ class InferenceSession {
    */
   int GetCurrentNumRuns() const;
 
+  /**
+   * Get the counters of the memory pattern cache of the main graph.
+   */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
+  /**
+   * Get the weights of the session that are shared with other sessions, and the bytes this saves, when
+   * kOrtSessionOptionsConfigShareWeightsAcrossSessions is set. Empty otherwise.
+   */
+  SharedWeightStats GetSharedWeightStats() const;
+
+  /**
+   * Get the size of the scratch buffer on location that a Run with the given feeds can use in place of allocating
+   * the buffer for its intermediate tensors. See OrtRunOptions::scratch_buffer.
+   * @param feed_names names of the inputs, in the order they will be passed to Run.
+   * @param feeds inputs with the shapes of the Run.
+   * @param size 0 if the memory pattern for these input shapes is not known yet. It is generated by the first Run
+   *        with them, or at initialization if kOrtSessionOptionsConfigStaticMemoryPlanning is set.
+   * @return OK if success.
+   */
+  common::Status GetScratchBufferSize(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                      const OrtMemoryInfo& location, size_t& size) const;
+
+  /**
+   * Get the sizes of the memory pattern planned at initialization when kOrtSessionOptionsConfigStaticMemoryPlanning
+   * is set. Empty if nothing was planned.
+   */
+  StaticMemoryPlanSummary GetStaticMemoryPlanSummary() const;
+
+  /**
+   * Get the counters of the request batching enabled by kOrtSessionOptionsConfigBatchingMaxBatchSize.
+   * Empty if batching is not enabled.
+   */
+  RequestBatcherStats GetRequestBatcherStats() const;
+
+  /**
+   * Get the latency histograms and allocation counts of the nodes of the main graph, per node and per op type,
+   * as JSON. Requires kOrtSessionOptionsConfigEnableOpMetrics to be set.
+   * @param metrics Set to the metrics. See OpMetrics::ToJson for the format.
+   * @return OK if success.
+   */
+  common::Status GetOpMetrics(std::string& metrics) const ORT_MUST_USE_RESULT;
+
+  /**
+   * Clear the metrics returned by GetOpMetrics.
+   */
+  common::Status ResetOpMetrics() ORT_MUST_USE_RESULT;
+
   /**
    * Get the names of registered Execution Providers. The returned vector is ordered by Execution Provider
    * priority. The first provider in the vector has the highest priority.
@@ -561,6 +631,11 @@ class InferenceSession {
 
   common::Status LoadOnnxModel(const PathString& model_uri) ORT_MUST_USE_RESULT;
 
+  // Parses the ONNX model file from a memory mapping of it kept in onnx_model_mapped_bytes_, with the initializers
+  // referring to their raw data in the mapping. Falls back to reading the file if it cannot be mapped.
+  common::Status LoadMappedOnnxModelProto(const PathString& model_uri,
+                                          ONNX_NAMESPACE::ModelProto& model_proto) ORT_MUST_USE_RESULT;
+
   bool HasLocalSchema() const {
     return !custom_schema_registries_.empty();
   }
@@ -587,6 +662,27 @@ class InferenceSession {
 
   common::Status LoadOrtModelWithLoader(std::function<Status()> load_ort_format_model_bytes) ORT_MUST_USE_RESULT;
 
+  // Creates the model from the ORT format model in ort_format_model_bytes_.
+  common::Status LoadOrtModelFromBytes(bool use_ort_model_bytes_for_initializers) ORT_MUST_USE_RESULT;
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // Replaces the ONNX model with the optimized model from the session cache if the cache is enabled and has it.
+  // Otherwise sets session_cache_file_ to the file the optimized model is to be written to.
+  common::Status LoadFromSessionCache() ORT_MUST_USE_RESULT;
+
+  // Maps the pre-packed weights file of the session cache file the model was loaded from into
+  // session_cache_prepacked_weights_. Otherwise sets session_cache_prepacked_weights_file_ to the file the weights
+  // are to be written to.
+  void LoadSessionCachePrePackedWeights(const PathString& cache_file);
+
+  // Writes the weights the kernels pre-packed to session_cache_prepacked_weights_file_.
+  void WriteSessionCachePrePackedWeights();
+
+  // Writes the optimized model to a temporary file next to session_cache_file_. temporary_file is left empty if the
+  // model is not written.
+  void WriteSessionCacheFile(PathString& temporary_file);
+#endif
+
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
   // If a new logger is created, it will also be stored in new_run_logger,
   // which must remain valid for the duration of the execution.
@@ -606,6 +702,14 @@ class InferenceSession {
   common::Status ValidateOutputs(gsl::span<const std::string> output_names,
                                  const std::vector<OrtValue>* p_fetches) const ORT_MUST_USE_RESULT;
 
+  // Run without batching the request.
+  common::Status RunImpl(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                         gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                         std::vector<OrtValue>* p_fetches,
+                         const std::vector<OrtDevice>* p_fetches_device_info) ORT_MUST_USE_RESULT;
+
+  common::Status CreateRequestBatcher() ORT_MUST_USE_RESULT;
+
   common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms) ORT_MUST_USE_RESULT;
 
   template <typename T>
@@ -696,6 +800,17 @@ class InferenceSession {
   onnxruntime::concurrency::ThreadPool* external_intra_op_thread_pool_{};
   onnxruntime::concurrency::ThreadPool* external_inter_op_thread_pool_{};
 
+  // Merges concurrent Run calls if kOrtSessionOptionsConfigBatchingMaxBatchSize is set.
+  std::unique_ptr<RequestBatcher> request_batcher_;
+
+  // Metrics of the nodes of the main graph if kOrtSessionOptionsConfigEnableOpMetrics is set.
+  std::unique_ptr<OpMetrics> op_metrics_;
+
+  // Runs the requests of RunAsync. Created by the first call.
+  std::basic_string<ORTCHAR_T> async_run_thread_pool_name_;
+  std::unique_ptr<AsyncRunQueue> async_run_queue_;  // GUARDED_BY(async_run_queue_mutex_) until created
+  onnxruntime::OrtMutex async_run_queue_mutex_;
+
   // initialized from session options
   // Determines which threadpools will be intialized and used for the duration of this session.
   // If true, use the per session ones, or else the global threadpools.
@@ -798,6 +913,27 @@ class InferenceSession {
 
   bool using_ort_model_bytes_for_initializers_{false};
 
+  // The mapped session cache file the ORT format model bytes point to, if the model is from the session cache.
+  Env::MappedMemoryPtr ort_format_model_mapped_bytes_;
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // Hash of the bytes of an ONNX model loaded from memory, for the session cache key.
+  std::string model_bytes_hash_;
+
+  // Session cache file to write the optimized model to, if the session cache is enabled and does not have it.
+  PathString session_cache_file_;
+
+  // Session cache file to write the pre-packed weights to, if the session cache is enabled and does not have them.
+  PathString session_cache_prepacked_weights_file_;
+
+  // The pre-packed weights from the session cache, handed to the session state, and the mapped file they point to.
+  InlinedHashMap<std::string, PrePackedWeights> session_cache_prepacked_weights_;
+  Env::MappedMemoryPtr session_cache_prepacked_weights_mapped_bytes_;
+
+  // The mapped ONNX model file the initializers point to, if "session.use_mmap_for_initializers" is set.
+  Env::MappedMemoryPtr onnx_model_mapped_bytes_;
+#endif
+
   // Container to store pre-packed weights to share between sessions.
   // The life-cycle of the cache itself is maintained by the user and the user will ensure
   // the cache is valid until any session reliant on it is still in scope.
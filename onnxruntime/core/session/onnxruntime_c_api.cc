@@ -756,17 +756,18 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArray, _In_ const OrtEnv* env, _In
   API_IMPL_END
 }
 
-ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
-                    _In_reads_(input_len) const char* const* input_names,
-                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
-                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
-                    _Inout_updates_all_(output_names_len) OrtValue** output) {
-  API_IMPL_BEGIN
-  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+namespace {
+// Copies the arguments of Run and RunAsync
+OrtStatus* GetRunArguments(_In_reads_(input_len) const char* const* input_names,
+                           _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                           _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                           _In_reads_(output_names_len) OrtValue* const* output,
+                           std::vector<std::string>& feed_names, std::vector<OrtValue>& feeds,
+                           std::vector<std::string>& output_names, std::vector<OrtValue>& fetches) {
   constexpr int queue_id = 0;
 
-  std::vector<std::string> feed_names(input_len);
-  std::vector<OrtValue> feeds(input_len);
+  feed_names.resize(input_len);
+  feeds.resize(input_len);
 
   for (size_t i = 0; i != input_len; ++i) {
     if (input_names[i] == nullptr || input_names[i][0] == '\0') {
@@ -780,7 +781,7 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
   }
 
   // Create output feed
-  std::vector<std::string> output_names(output_names_len);
+  output_names.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
       return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
@@ -788,7 +789,7 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
     output_names[i] = output_names1[i];
   }
 
-  std::vector<OrtValue> fetches(output_names_len);
+  fetches.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output[i] != nullptr) {
       ::OrtValue& value = *(output[i]);
@@ -797,6 +798,40 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
       fetches[i] = value;
     }
   }
+
+  return nullptr;
+}
+
+void SetRunOutputs(std::vector<OrtValue>& fetches, _Inout_updates_all_(fetches.size()) OrtValue** output) {
+  constexpr int queue_id = 0;
+  for (size_t i = 0; i != fetches.size(); ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+}
+}  // namespace
+
+ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  if (auto* status = GetRunArguments(input_names, input, input_len, output_names1, output_names_len, output,
+                                     feed_names, feeds, output_names, fetches)) {
+    return status;
+  }
+
   Status status;
   if (run_options == nullptr) {
     OrtRunOptions op;
@@ -807,15 +842,68 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
 
   if (!status.IsOK())
     return ToOrtStatus(status);
-  for (size_t i = 0; i != output_names_len; ++i) {
-    ::OrtValue& value = fetches[i];
-    if (value.Fence())
-      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
-    if (output[i] == nullptr) {
-      output[i] = new OrtValue(value);
+  SetRunOutputs(fetches, output);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output,
+                    _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  if (callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be null");
+  }
+
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  if (auto* status = GetRunArguments(input_names, input, input_len, output_names1, output_names_len, output,
+                                     feed_names, feeds, output_names, fetches)) {
+    return status;
+  }
+
+  auto status = session->RunAsync(
+      run_options, std::move(feed_names), std::move(feeds), std::move(output_names), std::move(fetches),
+      [output, callback, user_data](const Status& run_status, std::vector<OrtValue>& run_fetches) {
+        if (!run_status.IsOK()) {
+          callback(user_data, nullptr, 0, ToOrtStatus(run_status));
+          return;
+        }
+
+        SetRunOutputs(run_fetches, output);
+        callback(user_data, output, run_fetches.size(), nullptr);
+      });
+
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetScratchBufferSize, _In_ const OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_ const OrtMemoryInfo* mem_info, _Out_ size_t* size) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names(input_len);
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
     }
+
+    feed_names[i] = input_names[i];
+    feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
   }
-  return nullptr;
+
+  return ToOrtStatus(session->GetScratchBufferSize(feed_names, feeds, *mem_info, *size));
   API_IMPL_END
 }
 
@@ -1300,6 +1388,25 @@ ORT_API_STATUS_IMPL(OrtApis::SessionEndProfiling, _In_ OrtSession* sess, _Inout_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetOpMetrics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string metrics;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetOpMetrics(metrics));
+  *out = StrDup(metrics, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionResetOpMetrics, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->ResetOpMetrics());
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetModelMetadata, _In_ const OrtSession* sess,
                     _Outptr_ OrtModelMetadata** out) {
   API_IMPL_BEGIN
@@ -2146,6 +2253,10 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->max_dead_bytes_per_chunk = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "initial_growth_chunk_size_bytes") == 0) {
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_local_cache_bytes") == 0) {
+      cfg->thread_local_cache_bytes = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_local_cache_max_alloc_bytes") == 0) {
+      cfg->thread_local_cache_max_alloc_bytes = static_cast<int>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2583,7 +2694,12 @@ static constexpr OrtApi ort_api_1_to_12 = {
     &OrtApis::UpdateCANNProviderOptions,
     &OrtApis::GetCANNProviderOptionsAsString,
     &OrtApis::ReleaseCANNProviderOptions,
-    &OrtApis::MemoryInfoGetDeviceType    
+    &OrtApis::MemoryInfoGetDeviceType,
+    &OrtApis::RunOptionsSetScratchBuffer,
+    &OrtApis::SessionGetScratchBufferSize,
+    &OrtApis::RunAsync,
+    &OrtApis::SessionGetOpMetrics,
+    &OrtApis::SessionResetOpMetrics
 };
 
 // Asserts to do a some checks to ensure older Versions of the OrtApi never change (will detect an addition or deletion but not if they cancel out each other)
@@ -403,4 +403,22 @@ ORT_API(void, ReleaseCANNProviderOptions, _Frees_ptr_opt_ OrtCANNProviderOptions
 
 ORT_API(void, MemoryInfoGetDeviceType, _In_ const OrtMemoryInfo* ptr, _Out_ OrtMemoryInfoDeviceType* out);
 
+ORT_API_STATUS_IMPL(RunOptionsSetScratchBuffer, _Inout_ OrtRunOptions* options, _In_opt_ const OrtMemoryInfo* mem_info,
+                    _In_opt_ void* buffer, size_t buffer_size);
+ORT_API_STATUS_IMPL(SessionGetScratchBufferSize, _In_ const OrtSession* session,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                    _In_ const OrtMemoryInfo* mem_info, _Out_ size_t* size);
+
+ORT_API_STATUS_IMPL(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output,
+                    _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data);
+
+ORT_API_STATUS_IMPL(SessionGetOpMetrics, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(SessionResetOpMetrics, _Inout_ OrtSession* session);
+
 }  // namespace OrtApis
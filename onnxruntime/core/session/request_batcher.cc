@@ -0,0 +1,358 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Copies src into dst, whose dims are each at least those of src. The elements of dst outside of src are not written.
+void CopyPadded(const uint8_t* src, gsl::span<const int64_t> src_dims, uint8_t* dst,
+                gsl::span<const int64_t> dst_dims, size_t element_size) {
+  const auto src_inner_dims = src_dims.subspan(1);
+  const auto dst_inner_dims = dst_dims.subspan(1);
+  const size_t src_row_size = TensorShape(src_inner_dims).Size() * element_size;
+  if (std::equal(src_inner_dims.begin(), src_inner_dims.end(), dst_inner_dims.begin())) {
+    memcpy(dst, src, static_cast<size_t>(src_dims[0]) * src_row_size);
+    return;
+  }
+
+  const size_t dst_row_size = TensorShape(dst_inner_dims).Size() * element_size;
+  for (int64_t i = 0; i < src_dims[0]; ++i) {
+    CopyPadded(src + i * src_row_size, src_inner_dims, dst + i * dst_row_size, dst_inner_dims, element_size);
+  }
+}
+
+// Copies the part of src that dst covers into dst, whose dims are each at most those of src.
+void CopyCropped(const uint8_t* src, gsl::span<const int64_t> src_dims, uint8_t* dst,
+                 gsl::span<const int64_t> dst_dims, size_t element_size) {
+  const auto src_inner_dims = src_dims.subspan(1);
+  const auto dst_inner_dims = dst_dims.subspan(1);
+  const size_t dst_row_size = TensorShape(dst_inner_dims).Size() * element_size;
+  if (std::equal(src_inner_dims.begin(), src_inner_dims.end(), dst_inner_dims.begin())) {
+    memcpy(dst, src, static_cast<size_t>(dst_dims[0]) * dst_row_size);
+    return;
+  }
+
+  const size_t src_row_size = TensorShape(src_inner_dims).Size() * element_size;
+  for (int64_t i = 0; i < dst_dims[0]; ++i) {
+    CopyCropped(src + i * src_row_size, src_inner_dims, dst + i * dst_row_size, dst_inner_dims, element_size);
+  }
+}
+
+void AppendToKey(std::string& key, const std::string& name) {
+  key.append(std::to_string(name.size())).append(":").append(name);
+}
+
+}  // namespace
+
+RequestBatcher::RequestBatcher(const RequestBatcherOptions& options, AllocatorPtr allocator, RunFn run_fn)
+    : options_(options), allocator_(std::move(allocator)), run_fn_(std::move(run_fn)) {
+  ORT_ENFORCE(options_.max_batch_size > 0, "The maximum batch size must be positive.");
+}
+
+bool RequestBatcher::CanBatch(gsl::span<const OrtValue> feeds, const std::vector<OrtValue>& fetches) {
+  if (feeds.empty()) {
+    return false;
+  }
+
+  int64_t num_rows = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return false;
+    }
+
+    const Tensor& tensor = feed.Get<Tensor>();
+    if (tensor.IsDataTypeString() || tensor.Location().device.Type() != OrtDevice::CPU ||
+        tensor.Shape().NumDimensions() == 0 || tensor.Shape()[0] == 0 ||
+        (num_rows != -1 && tensor.Shape()[0] != num_rows)) {
+      return false;
+    }
+
+    num_rows = tensor.Shape()[0];
+  }
+
+  return std::none_of(fetches.cbegin(), fetches.cend(), [](const OrtValue& fetch) { return fetch.IsAllocated(); });
+}
+
+bool RequestBatcher::CanPad(gsl::span<const std::string> feed_names,
+                            gsl::span<const std::string> output_names) const {
+  if (!options_.pad_ragged_dims) {
+    return false;
+  }
+
+  for (const auto& output_name : output_names) {
+    auto it = options_.output_dims.find(output_name);
+    if (it == options_.output_dims.end()) {
+      return false;
+    }
+
+    for (const auto& input_dim : it->second) {
+      if (!input_dim.input_name.empty() &&
+          std::find(feed_names.begin(), feed_names.end(), input_dim.input_name) == feed_names.end()) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+std::string RequestBatcher::GetBatchKey(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                        gsl::span<const OrtValue> feeds,
+                                        gsl::span<const std::string> output_names) const {
+  // the batch runs with the RunOptions of its first request
+  std::string key = std::to_string(run_options.run_log_severity_level) + "," +
+                    std::to_string(run_options.run_log_verbosity_level) + "," +
+                    (run_options.only_execute_path_to_fetches ? "1" : "0");
+#ifdef ENABLE_TRAINING
+  key.append(run_options.training_mode ? ",1" : ",0");
+#endif
+  key.append(";");
+  AppendToKey(key, run_options.run_tag);
+  const std::map<std::string, std::string> run_configs(run_options.config_options.configurations.cbegin(),
+                                                       run_options.config_options.configurations.cend());
+  for (const auto& run_config : run_configs) {
+    AppendToKey(key, run_config.first);
+    AppendToKey(key, run_config.second);
+  }
+
+  const bool pad = CanPad(feed_names, output_names);
+  key.append(pad ? "|pad|" : "|");
+  for (size_t i = 0; i < feed_names.size(); ++i) {
+    AppendToKey(key, feed_names[i]);
+    const Tensor& tensor = feeds[i].Get<Tensor>();
+    key.append(std::to_string(tensor.GetElementType())).append(",").append(std::to_string(tensor.Shape().NumDimensions()));
+    if (!pad) {
+      for (size_t dim = 1; dim < tensor.Shape().NumDimensions(); ++dim) {
+        key.append(",").append(std::to_string(tensor.Shape()[dim]));
+      }
+    }
+
+    key.append(";");
+  }
+
+  key.append("|");
+  for (const auto& output_name : output_names) {
+    AppendToKey(key, output_name);
+  }
+
+  return key;
+}
+
+void RequestBatcher::CloseBatch(BatchMap::iterator it) {
+  it->second->closed = true;
+  it->second->cv.notify_all();
+  open_batches_.erase(it);
+}
+
+common::Status RequestBatcher::Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                   gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                   std::vector<OrtValue>& fetches) {
+  const int64_t num_rows = feeds[0].Get<Tensor>().Shape()[0];
+  if (num_rows >= options_.max_batch_size || run_options.terminate) {
+    return run_fn_(run_options, feed_names, feeds, output_names, &fetches);
+  }
+
+  Request request{feeds, num_rows, &fetches, std::chrono::steady_clock::now(), Status::OK()};
+  const std::string key = GetBatchKey(run_options, feed_names, feeds, output_names);
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+  auto it = open_batches_.find(key);
+  if (it != open_batches_.end() && it->second->num_rows + num_rows > options_.max_batch_size) {
+    // the request does not fit. run the open batch now instead of waiting for more requests.
+    CloseBatch(it);
+    it = open_batches_.end();
+  }
+
+  const bool is_first_request = it == open_batches_.end();
+  if (is_first_request) {
+    it = open_batches_.emplace(key, std::make_shared<Batch>()).first;
+  }
+
+  std::shared_ptr<Batch> batch = it->second;
+  batch->requests.push_back(&request);
+  batch->num_rows += num_rows;
+  if (batch->num_rows == options_.max_batch_size) {
+    CloseBatch(it);
+  }
+
+  if (!is_first_request) {
+    batch->cv.wait(lock, [&batch]() { return batch->done; });
+    return request.status;
+  }
+
+  const auto deadline = request.enqueue_time + options_.max_wait;
+  while (!batch->closed) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      // an open batch is always the one in the map for its key
+      CloseBatch(open_batches_.find(key));
+      break;
+    }
+
+    batch->cv.wait_for(lock, deadline - now);
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  for (const auto* batched_request : batch->requests) {
+    const auto queue_time_us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(start_time - batched_request->enqueue_time).count());
+    stats_.total_queue_time_us += queue_time_us;
+    stats_.max_queue_time_us = std::max(stats_.max_queue_time_us, queue_time_us);
+  }
+
+  stats_.num_requests += batch->requests.size();
+  stats_.num_batches += 1;
+  stats_.num_rows += static_cast<uint64_t>(batch->num_rows);
+  lock.unlock();
+
+  Status status = RunBatch(run_options, feed_names, output_names, *batch);
+  if (!status.IsOK()) {
+    for (auto* batched_request : batch->requests) {
+      batched_request->status = status;
+    }
+  }
+
+  lock.lock();
+  batch->done = true;
+  batch->cv.notify_all();
+  return request.status;
+}
+
+common::Status RequestBatcher::RunBatch(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                        gsl::span<const std::string> output_names, Batch& batch) {
+  if (batch.requests.size() == 1) {
+    auto& request = *batch.requests.front();
+    return run_fn_(run_options, feed_names, request.feeds, output_names, request.fetches);
+  }
+
+  std::vector<OrtValue> batch_feeds(feed_names.size());
+  for (size_t i = 0; i < feed_names.size(); ++i) {
+    ORT_RETURN_IF_ERROR(ConcatFeeds(batch, i, batch_feeds[i]));
+  }
+
+  std::vector<OrtValue> batch_fetches;
+  ORT_RETURN_IF_ERROR(run_fn_(run_options, feed_names, batch_feeds, output_names, &batch_fetches));
+
+  for (auto* request : batch.requests) {
+    request->fetches->resize(output_names.size());
+  }
+
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    ORT_RETURN_IF_ERROR(SplitFetch(batch, feed_names, output_names[i], i, batch_fetches[i]));
+  }
+
+  return Status::OK();
+}
+
+common::Status RequestBatcher::ConcatFeeds(const Batch& batch, size_t feed_idx, OrtValue& batch_feed) const {
+  const Tensor& first = batch.requests.front()->feeds[feed_idx].Get<Tensor>();
+  TensorShapeVector dims = first.Shape().AsShapeVector();
+  dims[0] = batch.num_rows;
+  bool is_ragged = false;
+  for (const auto* request : batch.requests) {
+    const auto& shape = request->feeds[feed_idx].Get<Tensor>().Shape();
+    for (size_t dim = 1; dim < dims.size(); ++dim) {
+      if (shape[dim] != dims[dim]) {
+        is_ragged = true;
+        dims[dim] = std::max(dims[dim], shape[dim]);
+      }
+    }
+  }
+
+  const TensorShape batch_shape(dims);
+  Tensor::InitOrtValue(first.DataType(), batch_shape, allocator_, batch_feed);
+  Tensor& batch_tensor = *batch_feed.GetMutable<Tensor>();
+  auto* dst = static_cast<uint8_t*>(batch_tensor.MutableDataRaw());
+  if (is_ragged) {
+    memset(dst, 0, batch_tensor.SizeInBytes());
+  }
+
+  const size_t element_size = first.DataType()->Size();
+  const size_t row_size = static_cast<size_t>(batch_shape.SizeFromDimension(1)) * element_size;
+  for (const auto* request : batch.requests) {
+    const Tensor& tensor = request->feeds[feed_idx].Get<Tensor>();
+    CopyPadded(static_cast<const uint8_t*>(tensor.DataRaw()), tensor.Shape().GetDims(), dst, batch_shape.GetDims(),
+               element_size);
+    dst += static_cast<size_t>(request->num_rows) * row_size;
+  }
+
+  return Status::OK();
+}
+
+common::Status RequestBatcher::SplitFetch(const Batch& batch, gsl::span<const std::string> feed_names,
+                                          const std::string& output_name, size_t fetch_idx,
+                                          OrtValue& batch_fetch) const {
+  ORT_RETURN_IF_NOT(batch_fetch.IsTensor(), "Output ", output_name,
+                    " is not a tensor and can not be split between the batched requests.");
+
+  Tensor& tensor = *batch_fetch.GetMutable<Tensor>();
+  const auto& shape = tensor.Shape();
+  ORT_RETURN_IF_NOT(shape.NumDimensions() > 0 && shape[0] == batch.num_rows, "The first dim of output ",
+                    output_name, " is not the batch dim. Output shape: ", shape, " Batch size: ", batch.num_rows);
+
+  // the input dims that the output is cropped to, if the inputs may have been padded
+  const std::vector<RequestBatcherOptions::InputDim>* input_dims = nullptr;
+  if (CanPad(feed_names, gsl::make_span(&output_name, 1))) {
+    input_dims = &options_.output_dims.at(output_name);
+    ORT_RETURN_IF_NOT(input_dims->size() + 1 == shape.NumDimensions(), "Output ", output_name, " has shape ", shape,
+                      " but ", input_dims->size() + 1, " dims were expected.");
+  }
+
+  const size_t element_size = tensor.DataType()->Size();
+  const size_t row_size = static_cast<size_t>(shape.SizeFromDimension(1)) * element_size;
+  auto* data = static_cast<uint8_t*>(tensor.MutableDataRaw());
+  const auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  for (auto* request : batch.requests) {
+    TensorShapeVector dims = shape.AsShapeVector();
+    dims[0] = request->num_rows;
+    bool is_cropped = false;
+    for (size_t dim = 1; input_dims != nullptr && dim < dims.size(); ++dim) {
+      const auto& input_dim = (*input_dims)[dim - 1];
+      if (input_dim.input_name.empty()) {
+        continue;
+      }
+
+      const size_t feed_idx = static_cast<size_t>(
+          std::find(feed_names.begin(), feed_names.end(), input_dim.input_name) - feed_names.begin());
+      const auto& feed_shape = request->feeds[feed_idx].Get<Tensor>().Shape();
+      const int64_t request_dim = feed_shape[input_dim.dim];
+      ORT_RETURN_IF_NOT(request_dim <= dims[dim], "Dim ", dim, " of output ", output_name, " of shape ", shape,
+                        " is smaller than dim ", input_dim.dim, " of input ", input_dim.input_name, " of shape ",
+                        feed_shape);
+      is_cropped = is_cropped || request_dim != dims[dim];
+      dims[dim] = request_dim;
+    }
+
+    const TensorShape request_shape(dims);
+    auto& fetch = (*request->fetches)[fetch_idx];
+    if (is_cropped) {
+      Tensor::InitOrtValue(tensor.DataType(), request_shape, allocator_, fetch);
+      CopyCropped(data, shape.GetDims(), static_cast<uint8_t*>(fetch.GetMutable<Tensor>()->MutableDataRaw()),
+                  request_shape.GetDims(), element_size);
+    } else {
+      auto slice = std::make_unique<Tensor>(tensor.DataType(), request_shape, data, tensor.Location());
+      // the slice keeps the batch output alive
+      fetch.Init(slice.release(), ml_tensor, [batch_fetch](void* p) { delete static_cast<Tensor*>(p); });
+    }
+
+    data += static_cast<size_t>(request->num_rows) * row_size;
+  }
+
+  return Status::OK();
+}
+
+RequestBatcherStats RequestBatcher::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+struct RequestBatcherOptions {
+  // The input dim that a dim of an output follows.
+  struct InputDim {
+    // empty if the output dim does not follow an input dim
+    std::string input_name;
+    size_t dim{0};
+  };
+
+  // Maximum number of rows in a batch, i.e. the sum of the batch dims of its requests.
+  int64_t max_batch_size{0};
+  // How long the first request of a batch waits for other requests to join it.
+  std::chrono::microseconds max_wait{1000};
+  // Batch requests whose inputs differ in dims other than the batch dim, by padding them with zeros to the largest
+  // value in the batch, and crop the outputs of each request back to the dims of its inputs.
+  // Only set this for models in which the padded elements can not change the other elements of the outputs.
+  bool pad_ragged_dims{false};
+  // For each output, the input dims that its dims other than the batch dim follow. An output is cropped to the dims of
+  // the inputs of each request. Requests with an output or input that is not in here are not padded.
+  std::unordered_map<std::string, std::vector<InputDim>> output_dims;
+};
+
+struct RequestBatcherStats {
+  uint64_t num_requests{0};
+  uint64_t num_batches{0};
+  // Sum of the batch dims of the batches. The fill rate is num_rows / (num_batches * max_batch_size).
+  uint64_t num_rows{0};
+  // Time from a request joining a batch to the batch starting to run.
+  uint64_t total_queue_time_us{0};
+  uint64_t max_queue_time_us{0};
+};
+
+/*
+Merges concurrent Run calls into a single run of a larger batch.
+
+The first request of a batch waits until the batch is full or max_wait has passed, concatenates the inputs of all the
+requests in the batch along their first dim, runs the batch and splits the outputs along their first dim. The other
+requests wait for it and return their part of the outputs, which shares the buffer of the batch output.
+
+Requests are merged if they have the same input and output names, in the same order, and their inputs have the same
+element types and ranks. Unless pad_ragged_dims is set, the inputs must also have the same dims other than the first.
+
+Requests are also merged only if their RunOptions are the same other than the terminate flag, as the batch runs with
+the RunOptions of its first request. A request whose terminate flag is set is not batched. Setting the terminate flag
+of a request that joined a batch other than as its first request does not stop the batch.
+*/
+class RequestBatcher {
+ public:
+  using RunFn = std::function<common::Status(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                             gsl::span<const OrtValue> feeds,
+                                             gsl::span<const std::string> output_names,
+                                             std::vector<OrtValue>* p_fetches)>;
+
+  // run_fn runs a request or a batch without batching it. allocator is used for the batched inputs.
+  RequestBatcher(const RequestBatcherOptions& options, AllocatorPtr allocator, RunFn run_fn);
+
+  // Returns true if every feed is a tensor in CPU memory, other than a string tensor, with the same non-zero first
+  // dim, and no fetch is pre-allocated.
+  static bool CanBatch(gsl::span<const OrtValue> feeds, const std::vector<OrtValue>& fetches);
+
+  // Runs the request as part of a batch and returns once the batch has run. CanBatch must be true for the request.
+  common::Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                     gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                     std::vector<OrtValue>& fetches);
+
+  RequestBatcherStats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RequestBatcher);
+
+  struct Request {
+    gsl::span<const OrtValue> feeds;
+    int64_t num_rows;
+    std::vector<OrtValue>* fetches;
+    std::chrono::steady_clock::time_point enqueue_time;
+    common::Status status;
+  };
+
+  struct Batch {
+    std::vector<Request*> requests;
+    int64_t num_rows{0};
+    // no other request can join the batch
+    bool closed{false};
+    // the batch has run and the requests have their status and outputs
+    bool done{false};
+    OrtCondVar cv;
+  };
+
+  using BatchMap = std::unordered_map<std::string, std::shared_ptr<Batch>>;
+
+  std::string GetBatchKey(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                          gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names) const;
+
+  // Whether the outputs of the request can be cropped back to the dims of its inputs after padding them.
+  bool CanPad(gsl::span<const std::string> feed_names, gsl::span<const std::string> output_names) const;
+
+  void CloseBatch(BatchMap::iterator it);  // REQUIRES(mutex_)
+
+  common::Status RunBatch(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                          gsl::span<const std::string> output_names, Batch& batch);
+
+  common::Status ConcatFeeds(const Batch& batch, size_t feed_idx, OrtValue& batch_feed) const;
+
+  common::Status SplitFetch(const Batch& batch, gsl::span<const std::string> feed_names,
+                            const std::string& output_name, size_t fetch_idx, OrtValue& batch_fetch) const;
+
+  const RequestBatcherOptions options_;
+  const AllocatorPtr allocator_;
+  const RunFn run_fn_;
+
+  mutable OrtMutex mutex_;
+  BatchMap open_batches_;      // GUARDED_BY(mutex_)
+  RequestBatcherStats stats_;  // GUARDED_BY(mutex_)
+};
+
+}  // namespace onnxruntime
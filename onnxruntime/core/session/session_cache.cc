@@ -0,0 +1,392 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/session/session_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/cpuid_info.h"
+#include "core/flatbuffers/ort_format_version.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor_external_data_info.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/platform/path_lib.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+namespace session_cache {
+
+namespace {
+
+// Bytes hashed per MurmurHash3 call, each call seeded with the previous hash. Fixed so that a model gets the same
+// hash from memory and from a file read in chunks of this size.
+constexpr size_t kHashChunkSize = size_t{1} << 24;
+
+struct ModelHash {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  size_t length = 0;
+
+  void Update(const void* data, size_t size) {
+    MurmurHash3::x86_128(data, static_cast<int>(size), hash[0], &hash);
+    length += size;
+  }
+
+  std::string ToString() const {
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (const uint32_t h : hash) {
+      ss << std::setw(8) << h;
+    }
+    ss << "-" << std::dec << length;
+    return ss.str();
+  }
+};
+
+// Layout of the pre-packed weights file, all the numbers being uint64_t in the byte order of the machine:
+//   magic, number of distinct weights, number of entries
+//   per distinct weights: weights_key length and bytes, number of buffers, then offset and size of each buffer
+//   per entry: index of its weights, key length and bytes
+//   the buffers, each at an offset aligned to kPrePackedBufferAlignment from the start of the file
+constexpr uint64_t kPrePackedWeightsMagic = 0x313057505054524fULL;  // "ORTPPW01"
+constexpr uint64_t kPrePackedBufferAlignment = 64;
+// the offset of a null buffer, which some kernels leave as a place holder
+constexpr uint64_t kNullBufferOffset = std::numeric_limits<uint64_t>::max();
+
+uint64_t AlignPrePackedBufferOffset(uint64_t offset) {
+  return (offset + kPrePackedBufferAlignment - 1) / kPrePackedBufferAlignment * kPrePackedBufferAlignment;
+}
+
+void WriteUInt64(std::ostream& out, uint64_t value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::ostream& out, const std::string& value) {
+  WriteUInt64(out, value.size());
+  out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool HaveSameBuffers(const PrePackedWeights& a, const PrePackedWeights& b) {
+  if (a.buffer_sizes_ != b.buffer_sizes_) {
+    return false;
+  }
+
+  for (size_t i = 0; i < a.buffers_.size(); ++i) {
+    const void* a_buffer = a.buffers_[i].get();
+    const void* b_buffer = b.buffers_[i].get();
+    if ((a_buffer == nullptr) != (b_buffer == nullptr) ||
+        (a_buffer != nullptr && std::memcmp(a_buffer, b_buffer, a.buffer_sizes_[i]) != 0)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+class PrePackedWeightsReader {
+ public:
+  explicit PrePackedWeightsReader(gsl::span<const uint8_t> bytes) : bytes_(bytes) {}
+
+  Status ReadUInt64(uint64_t& value) {
+    ORT_RETURN_IF(bytes_.size() - offset_ < sizeof(value), "Unexpected end of the pre-packed weights file.");
+    std::memcpy(&value, bytes_.data() + offset_, sizeof(value));
+    offset_ += sizeof(value);
+    return Status::OK();
+  }
+
+  Status ReadString(std::string& value) {
+    uint64_t length = 0;
+    ORT_RETURN_IF_ERROR(ReadUInt64(length));
+    ORT_RETURN_IF(bytes_.size() - offset_ < length, "Unexpected end of the pre-packed weights file.");
+    value.assign(reinterpret_cast<const char*>(bytes_.data() + offset_), static_cast<size_t>(length));
+    offset_ += static_cast<size_t>(length);
+    return Status::OK();
+  }
+
+  Status GetBuffer(uint64_t offset, uint64_t size, void*& buffer) const {
+    if (offset == kNullBufferOffset) {
+      ORT_RETURN_IF(size != 0, "A null pre-packed buffer has a size.");
+      buffer = nullptr;
+      return Status::OK();
+    }
+
+    ORT_RETURN_IF(offset > bytes_.size() || size > bytes_.size() - offset || offset % kPrePackedBufferAlignment != 0,
+                  "A pre-packed buffer is out of the bounds of the pre-packed weights file.");
+    // the kernels only read pre-packed buffers
+    buffer = const_cast<uint8_t*>(bytes_.data() + offset);
+    return Status::OK();
+  }
+
+ private:
+  gsl::span<const uint8_t> bytes_;
+  size_t offset_ = 0;
+};
+
+}  // namespace
+
+std::string HashModelBytes(const void* data, size_t length) {
+  ModelHash model_hash;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t offset = 0; offset < length; offset += kHashChunkSize) {
+    model_hash.Update(bytes + offset, std::min(kHashChunkSize, length - offset));
+  }
+
+  return model_hash.ToString();
+}
+
+Status HashModelFile(const PathString& model_path, std::string& hash) {
+  std::ifstream file(model_path, std::ifstream::in | std::ifstream::binary);
+  ORT_RETURN_IF_NOT(file, "Failed to open model file ", ToUTF8String(model_path));
+
+  ModelHash model_hash;
+  std::vector<char> buffer(kHashChunkSize);
+  while (file) {
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    const auto count = static_cast<size_t>(file.gcount());
+    if (count > 0) {
+      model_hash.Update(buffer.data(), count);
+    }
+  }
+
+  ORT_RETURN_IF_NOT(file.eof(), "Failed to read model file ", ToUTF8String(model_path));
+
+  hash = model_hash.ToString();
+  return Status::OK();
+}
+
+Status AddExternalDataHashes(const Graph& graph, const PathString& model_path, std::string& model_hash) {
+  std::set<PathString> external_data_files;
+  std::vector<const Graph*> graphs{&graph};
+  while (!graphs.empty()) {
+    const Graph* current = graphs.back();
+    graphs.pop_back();
+    for (const auto& initializer : current->GetAllInitializedTensors()) {
+      const ONNX_NAMESPACE::TensorProto& tensor_proto = *initializer.second;
+      if (!utils::HasExternalData(tensor_proto)) {
+        continue;
+      }
+
+      std::unique_ptr<ExternalDataInfo> external_data_info;
+      ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
+      // data in memory is in the model bytes, which are hashed already
+      if (external_data_info->GetRelPath() != utils::kTensorProtoMemoryAddressTag) {
+        external_data_files.insert(external_data_info->GetRelPath());
+      }
+    }
+
+    for (const auto& node : current->Nodes()) {
+      for (const auto& subgraph : node.GetSubgraphs()) {
+        graphs.push_back(subgraph.get());
+      }
+    }
+  }
+
+  for (const auto& file : external_data_files) {
+    std::string file_hash;
+    ORT_RETURN_IF_ERROR(HashModelFile(ReplaceFilename(model_path, file), file_hash));
+    model_hash += ":" + ToUTF8String(file) + "=" + file_hash;
+  }
+
+  return Status::OK();
+}
+
+PathString GetCacheFilePath(const std::string& cache_dir, const std::string& model_hash,
+                            const SessionOptions& session_options,
+                            const InlinedHashSet<std::string>& optimizers_to_disable,
+                            const ExecutionProviders& execution_providers) {
+  std::ostringstream key;
+  key << "ort:" << ORT_VERSION << ":" << kOrtModelVersion << "\n";
+  key << "model:" << model_hash << "\n";
+  key << "level:" << static_cast<int>(session_options.graph_optimization_level) << "\n";
+
+  std::vector<std::string> disabled(optimizers_to_disable.begin(), optimizers_to_disable.end());
+  std::sort(disabled.begin(), disabled.end());
+  for (const auto& name : disabled) {
+    key << "disabled:" << name << "\n";
+  }
+
+  for (const auto& free_dim : session_options.free_dimension_overrides) {
+    key << "free_dim:" << static_cast<int>(free_dim.dim_identifer_type) << ":" << free_dim.dim_identifier << "="
+        << free_dim.dim_value << "\n";
+  }
+
+  // the cache location itself does not change the optimized graph
+  const std::map<std::string, std::string> config_entries(session_options.config_options.configurations.begin(),
+                                                          session_options.config_options.configurations.end());
+  for (const auto& entry : config_entries) {
+    if (entry.first != kOrtSessionOptionsConfigOptimizedModelCacheDir) {
+      key << "config:" << entry.first << "=" << entry.second << "\n";
+    }
+  }
+
+  for (const auto& provider : execution_providers) {
+    key << "ep:" << provider->Type() << "\n";
+    const ProviderOptions provider_options = provider->GetProviderOptions();
+    const std::map<std::string, std::string> sorted_options(provider_options.begin(), provider_options.end());
+    for (const auto& option : sorted_options) {
+      key << "ep_option:" << option.first << "=" << option.second << "\n";
+    }
+  }
+
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  key << "cpu:" << cpuid_info.GetCpuModelKey() << ":" << cpuid_info.HasAVX() << cpuid_info.HasAVX2()
+      << cpuid_info.HasAVX512f() << cpuid_info.HasAVX512Skylake() << cpuid_info.HasF16C()
+      << cpuid_info.HasSSE3() << cpuid_info.HasSSE4_1() << cpuid_info.HasArmNeonDot() << "\n";
+
+  const std::string key_str = key.str();
+  const std::string file_name = HashModelBytes(key_str.data(), key_str.size()) + ".ort";
+  return ConcatPathComponent<ORTCHAR_T>(ToPathString(cache_dir), ToPathString(file_name));
+}
+
+PathString GetPrePackedWeightsFilePath(const PathString& cache_file) {
+  return cache_file + ORT_TSTR(".prepacked");
+}
+
+Status SavePrePackedWeights(const std::vector<SessionState::SavedPrePackedWeights>& prepacked_weights,
+                            const PathString& file) {
+  // the distinct weights, and the index of the weights of each entry
+  std::vector<const SessionState::SavedPrePackedWeights*> distinct_weights;
+  std::unordered_multimap<std::string, size_t> distinct_weights_by_key;
+  std::vector<uint64_t> entry_weights(prepacked_weights.size());
+  uint64_t header_size = 3 * sizeof(uint64_t);
+  for (size_t i = 0; i < prepacked_weights.size(); ++i) {
+    const auto& entry = prepacked_weights[i];
+    const auto range = distinct_weights_by_key.equal_range(entry.weights_key);
+    auto same = std::find_if(range.first, range.second, [&](const auto& candidate) {
+      return HaveSameBuffers(*distinct_weights[candidate.second]->weights, *entry.weights);
+    });
+    if (same != range.second) {
+      entry_weights[i] = same->second;
+    } else {
+      entry_weights[i] = distinct_weights.size();
+      distinct_weights_by_key.emplace(entry.weights_key, distinct_weights.size());
+      distinct_weights.push_back(&entry);
+      header_size += 2 * sizeof(uint64_t) + entry.weights_key.size() +
+                     2 * sizeof(uint64_t) * entry.weights->buffers_.size();
+    }
+
+    header_size += 2 * sizeof(uint64_t) + entry.key.size();
+  }
+
+  std::ofstream out(file, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  ORT_RETURN_IF_NOT(out, "Failed to open pre-packed weights file ", ToUTF8String(file));
+
+  WriteUInt64(out, kPrePackedWeightsMagic);
+  WriteUInt64(out, distinct_weights.size());
+  WriteUInt64(out, prepacked_weights.size());
+
+  uint64_t data_end = header_size;
+  for (const auto* weights : distinct_weights) {
+    WriteString(out, weights->weights_key);
+    WriteUInt64(out, weights->weights->buffers_.size());
+    for (size_t i = 0; i < weights->weights->buffers_.size(); ++i) {
+      if (weights->weights->buffers_[i] == nullptr) {
+        WriteUInt64(out, kNullBufferOffset);
+        WriteUInt64(out, 0);
+      } else {
+        data_end = AlignPrePackedBufferOffset(data_end);
+        WriteUInt64(out, data_end);
+        WriteUInt64(out, weights->weights->buffer_sizes_[i]);
+        data_end += weights->weights->buffer_sizes_[i];
+      }
+    }
+  }
+
+  for (size_t i = 0; i < prepacked_weights.size(); ++i) {
+    WriteUInt64(out, entry_weights[i]);
+    WriteString(out, prepacked_weights[i].key);
+  }
+
+  uint64_t offset = header_size;
+  const char padding[kPrePackedBufferAlignment] = {};
+  for (const auto* weights : distinct_weights) {
+    for (size_t i = 0; i < weights->weights->buffers_.size(); ++i) {
+      if (weights->weights->buffers_[i] != nullptr) {
+        const uint64_t aligned_offset = AlignPrePackedBufferOffset(offset);
+        out.write(padding, static_cast<std::streamsize>(aligned_offset - offset));
+        out.write(static_cast<const char*>(weights->weights->buffers_[i].get()),
+                  static_cast<std::streamsize>(weights->weights->buffer_sizes_[i]));
+        offset = aligned_offset + weights->weights->buffer_sizes_[i];
+      }
+    }
+  }
+
+  out.close();
+  ORT_RETURN_IF_NOT(out, "Failed to write pre-packed weights file ", ToUTF8String(file));
+  return Status::OK();
+}
+
+Status ParsePrePackedWeights(gsl::span<const uint8_t> bytes,
+                             InlinedHashMap<std::string, PrePackedWeights>& prepacked_weights) {
+  PrePackedWeightsReader reader(bytes);
+  uint64_t magic = 0;
+  uint64_t num_weights = 0;
+  uint64_t num_entries = 0;
+  ORT_RETURN_IF_ERROR(reader.ReadUInt64(magic));
+  ORT_RETURN_IF(magic != kPrePackedWeightsMagic, "Not a pre-packed weights file.");
+  ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_weights));
+  ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_entries));
+  // each weights and entry takes at least 16 bytes, which bounds the counts before anything is allocated
+  ORT_RETURN_IF(num_weights > bytes.size() / 16 || num_entries > bytes.size() / 16,
+                "Unexpected end of the pre-packed weights file.");
+
+  struct Buffer {
+    void* data;
+    size_t size;
+  };
+  std::vector<std::vector<Buffer>> weights_buffers(static_cast<size_t>(num_weights));
+  for (auto& buffers : weights_buffers) {
+    std::string weights_key;
+    uint64_t num_buffers = 0;
+    ORT_RETURN_IF_ERROR(reader.ReadString(weights_key));
+    ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_buffers));
+    ORT_RETURN_IF(num_buffers > bytes.size() / 16, "Unexpected end of the pre-packed weights file.");
+    buffers.resize(static_cast<size_t>(num_buffers));
+    for (auto& buffer : buffers) {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      ORT_RETURN_IF_ERROR(reader.ReadUInt64(offset));
+      ORT_RETURN_IF_ERROR(reader.ReadUInt64(size));
+      ORT_RETURN_IF_ERROR(reader.GetBuffer(offset, size, buffer.data));
+      buffer.size = static_cast<size_t>(size);
+    }
+  }
+
+  InlinedHashMap<std::string, PrePackedWeights> result;
+  result.reserve(static_cast<size_t>(num_entries));
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    uint64_t weights_index = 0;
+    std::string key;
+    ORT_RETURN_IF_ERROR(reader.ReadUInt64(weights_index));
+    ORT_RETURN_IF_ERROR(reader.ReadString(key));
+    ORT_RETURN_IF(weights_index >= num_weights, "Invalid weights index in the pre-packed weights file.");
+
+    PrePackedWeights weights;
+    for (const auto& buffer : weights_buffers[static_cast<size_t>(weights_index)]) {
+      // the buffers are owned by the mapped file
+      weights.buffers_.emplace_back(buffer.data, BufferDeleter(nullptr));
+      weights.buffer_sizes_.push_back(buffer.size);
+    }
+
+    result.insert_or_assign(std::move(key), std::move(weights));
+  }
+
+  prepacked_weights = std::move(result);
+  return Status::OK();
+}
+
+}  // namespace session_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
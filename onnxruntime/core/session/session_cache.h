@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/path_string.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/session_options.h"
+#include "core/framework/session_state.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+// Helpers for the session cache enabled with "session.optimized_model_cache_dir".
+// The cache keeps the optimized graph of ONNX models as ORT format files, named by a key that covers everything
+// that can change the optimized graph, so that later sessions for the same model, options, execution providers and
+// processor load the file instead of optimizing the model again.
+namespace session_cache {
+
+// Returns a hash of the model bytes. The same bytes give the same hash whether they come from memory or a file.
+std::string HashModelBytes(const void* data, size_t length);
+
+// Computes the hash of a file, like HashModelBytes of its content, without holding the whole file in memory.
+Status HashModelFile(const PathString& model_path, std::string& hash) ORT_MUST_USE_RESULT;
+
+// Appends the paths and content hashes of the files holding the external data of the initializers of the graph and
+// its subgraphs to model_hash, so that the hash changes with the data. The paths are relative to model_path, which is
+// empty if the model is not loaded from a file.
+Status AddExternalDataHashes(const Graph& graph, const PathString& model_path,
+                             std::string& model_hash) ORT_MUST_USE_RESULT;
+
+// Returns the path of the cache file for the model with the given hash.
+PathString GetCacheFilePath(const std::string& cache_dir, const std::string& model_hash,
+                            const SessionOptions& session_options,
+                            const InlinedHashSet<std::string>& optimizers_to_disable,
+                            const ExecutionProviders& execution_providers);
+
+// Returns the path of the file holding the pre-packed weights of the sessions that load the given cache file.
+PathString GetPrePackedWeightsFilePath(const PathString& cache_file);
+
+// Writes the pre-packed weights to file. Weights with the same content, found by their weights_key, are written once.
+Status SavePrePackedWeights(const std::vector<SessionState::SavedPrePackedWeights>& prepacked_weights,
+                            const PathString& file) ORT_MUST_USE_RESULT;
+
+// Reads the pre-packed weights written by SavePrePackedWeights from the bytes of the file, keyed by their key.
+// The buffers point into bytes, which has to outlive them.
+Status ParsePrePackedWeights(gsl::span<const uint8_t> bytes,
+                             InlinedHashMap<std::string, PrePackedWeights>& prepacked_weights) ORT_MUST_USE_RESULT;
+
+}  // namespace session_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -13,6 +13,47 @@
 
 namespace onnxruntime {
 namespace concurrency {
+// Sets the NUMA node of each thread, the first being the caller thread. If the affinity of the threads is not given,
+// the threads are spread over the NUMA nodes in contiguous blocks of about the same size and each one is bound to a
+// processor of its node. Otherwise the node of each thread is the node of its processor.
+static void SetNumaNodes(Env* env, int thread_pool_size, bool has_explicit_affinity, ThreadOptions& to) {
+  const auto node_processors = env->GetNumaNodeProcessors();
+  std::vector<int> nodes;
+  for (size_t node = 0; node < node_processors.size(); ++node) {
+    if (!node_processors[node].empty()) {
+      nodes.push_back(static_cast<int>(node));
+    }
+  }
+
+  if (nodes.size() < 2) {
+    return;
+  }
+
+  if (has_explicit_affinity) {
+    for (const size_t processor : to.affinity) {
+      int processor_node = -1;
+      for (const int node : nodes) {
+        const auto& processors = node_processors[node];
+        if (std::find(processors.begin(), processors.end(), processor) != processors.end()) {
+          processor_node = node;
+          break;
+        }
+      }
+      to.numa_nodes.push_back(processor_node);
+    }
+    return;
+  }
+
+  to.affinity.clear();
+  std::vector<size_t> num_node_threads(nodes.size());
+  for (size_t i = 0; i < static_cast<size_t>(thread_pool_size); ++i) {
+    const size_t node_idx = i * nodes.size() / static_cast<size_t>(thread_pool_size);
+    const auto& processors = node_processors[nodes[node_idx]];
+    to.numa_nodes.push_back(nodes[node_idx]);
+    to.affinity.push_back(processors[num_node_threads[node_idx]++ % processors.size()]);
+  }
+}
+
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   if (options.thread_pool_size == 1)
@@ -30,6 +71,10 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
     if (options.auto_set_affinity)
       to.affinity = cpu_list;
   }
+  if (options.numa_aware) {
+    SetNumaNodes(env, options.thread_pool_size, options.affinity_vec_len != 0, to);
+  }
+  to.replicate_weights_per_numa_node = options.replicate_weights_per_numa_node;
   to.set_denormal_as_zero = options.set_denormal_as_zero;
 
   // set custom thread management members
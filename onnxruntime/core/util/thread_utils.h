@@ -32,6 +32,13 @@ struct OrtThreadPoolParams {
   // Set or unset denormal as zero
   bool set_denormal_as_zero = false;
 
+  // If it is true and the processors span more than one NUMA node, spread the threads over the nodes, each thread
+  // bound to a processor of its node unless affinity_vec is set, and prefer stealing work from the same node.
+  bool numa_aware = false;
+  // If it is true and the threads span more than one NUMA node, kernels keep a copy of their prepacked weights
+  // on each node.
+  bool replicate_weights_per_numa_node = false;
+
   // members to manage custom threads
   OrtCustomCreateThreadFn custom_create_thread_fn = nullptr;
   void* custom_thread_creation_options = nullptr;
@@ -1102,7 +1102,11 @@ void addObjectMethods(py::module& m, Environment& env, ExecutionProviderRegistra
         ort_arena_cfg->max_dead_bytes_per_chunk = kvp.second.cast<int>();
       } else if (key == "initial_growth_chunk_size_bytes") {
         ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
-        } else {
+      } else if (key == "thread_local_cache_bytes") {
+        ort_arena_cfg->thread_local_cache_bytes = kvp.second.cast<int>();
+      } else if (key == "thread_local_cache_max_alloc_bytes") {
+        ort_arena_cfg->thread_local_cache_max_alloc_bytes = kvp.second.cast<int>();
+      } else {
         ORT_THROW("Invalid OrtArenaCfg option: ", key);
       }
     }
@@ -1112,7 +1116,9 @@ void addObjectMethods(py::module& m, Environment& env, ExecutionProviderRegistra
       .def_readwrite("arena_extend_strategy", &OrtArenaCfg::arena_extend_strategy)
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
-      .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes);
+      .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
+      .def_readwrite("thread_local_cache_bytes", &OrtArenaCfg::thread_local_cache_bytes)
+      .def_readwrite("thread_local_cache_max_alloc_bytes", &OrtArenaCfg::thread_local_cache_max_alloc_bytes);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
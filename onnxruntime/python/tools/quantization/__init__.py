@@ -1,4 +1,5 @@
 from .calibrate import CalibraterBase, CalibrationDataReader, CalibrationMethod, MinMaxCalibrater, create_calibrator
+from .matmul_nbits_quantizer import MatMulNBitsQuantizer
 from .qdq_quantizer import QDQQuantizer
 from .quant_utils import QuantFormat, QuantType, write_calibration_table
 from .quantize import (
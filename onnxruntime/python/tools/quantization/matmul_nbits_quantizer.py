@@ -0,0 +1,262 @@
+# -------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See License.txt in the project root for
+# license information.
+# --------------------------------------------------------------------------
+
+import argparse
+import logging
+import os
+from typing import List, Optional, Tuple
+
+import numpy as np
+import onnx
+import onnx.numpy_helper as onnx_numpy_helper
+from onnx.onnx_pb import GraphProto, ModelProto, NodeProto, TensorProto
+
+from .onnx_model import ONNXModel
+from .quant_utils import ms_domain
+
+logger = logging.getLogger(__name__)
+
+
+def quantize_blockwise(
+    fp32weight: np.ndarray, block_size: int, bits: int = 4, is_symmetric: bool = True
+) -> Tuple[np.ndarray, np.ndarray, Optional[np.ndarray]]:
+    """Quantize a [K, N] float weight matrix blockwise along K to the layout consumed by MatMulNBits.
+
+    Each column is split into ceil(K / block_size) blocks that have their own scale and zero point. A symmetric block
+    uses the default zero point 2^(bits - 1). An asymmetric block is quantized over its value range extended to
+    include zero, so padding a partial block with zeros does not change its parameters.
+
+    Returns:
+        packed: uint8 array of shape [N, k_blocks, block_size * bits / 8].
+        scales: float32 array of shape [N * k_blocks].
+        zero_points: uint8 array of shape [N * ceil(k_blocks * bits / 8)], or None if is_symmetric.
+    """
+    if bits not in (4, 8):
+        raise ValueError(f"bits must be 4 or 8, got {bits}")
+    if block_size < 16 or (block_size & (block_size - 1)) != 0:
+        raise ValueError(f"block_size must be a power of 2 not smaller than 16, got {block_size}")
+    if fp32weight.ndim != 2:
+        raise ValueError(f"weight must be 2-D, got shape {fp32weight.shape}")
+
+    k, n = fp32weight.shape
+    k_blocks = (k + block_size - 1) // block_size
+    max_value = (1 << bits) - 1
+    default_zero_point = 1 << (bits - 1)
+
+    padded = np.zeros((k_blocks * block_size, n), dtype=np.float32)
+    padded[:k, :] = fp32weight
+    blocks = padded.T.reshape(n, k_blocks, block_size)
+
+    minimum = np.minimum(blocks.min(axis=2), 0.0).astype(np.float32)
+    maximum = np.maximum(blocks.max(axis=2), 0.0).astype(np.float32)
+
+    if is_symmetric:
+        scales = (np.maximum(-minimum, maximum) / np.float32(default_zero_point - 1)).astype(np.float32)
+        zero_points = np.full((n, k_blocks), default_zero_point, dtype=np.int32)
+    else:
+        scales = ((maximum - minimum) / np.float32(max_value)).astype(np.float32)
+        with np.errstate(divide="ignore", invalid="ignore"):
+            zero_points = np.where(scales != 0, np.rint(-minimum / scales), 0).astype(np.int32)
+        zero_points = np.clip(zero_points, 0, max_value)
+
+    with np.errstate(divide="ignore"):
+        reciprocal_scales = np.where(scales != 0, np.float32(1.0) / scales, np.float32(0.0)).astype(np.float32)
+
+    quantized = np.rint(blocks * reciprocal_scales[:, :, np.newaxis]).astype(np.int32) + zero_points[:, :, np.newaxis]
+    quantized = np.clip(quantized, 0, max_value).astype(np.uint8)
+
+    if bits == 4:
+        packed = quantized[:, :, 0::2] | (quantized[:, :, 1::2] << 4)
+    else:
+        packed = quantized
+
+    packed_zero_points = None
+    if not is_symmetric:
+        zero_points = zero_points.astype(np.uint8)
+        if bits == 4:
+            if k_blocks % 2 != 0:
+                zero_points = np.concatenate([zero_points, np.zeros((n, 1), dtype=np.uint8)], axis=1)
+            zero_points = zero_points[:, 0::2] | (zero_points[:, 1::2] << 4)
+        packed_zero_points = zero_points.reshape(-1)
+
+    return packed, scales.reshape(-1), packed_zero_points
+
+
+class MatMulNBitsQuantizer:
+    """Replace MatMul nodes with a constant 2-D float weight by MatMulNBits nodes with blockwise quantized weights.
+
+    The activations stay in float; only the weights are quantized to 4 or 8 bits with a scale (and optionally a zero
+    point) per block of block_size elements along the K dimension.
+    """
+
+    def __init__(
+        self,
+        model: ModelProto,
+        block_size: int = 32,
+        bits: int = 4,
+        is_symmetric: bool = False,
+        nodes_to_exclude: Optional[List[str]] = None,
+    ):
+        self.model = ONNXModel(model)
+        self.block_size = block_size
+        self.bits = bits
+        self.is_symmetric = is_symmetric
+        self.nodes_to_exclude = set(nodes_to_exclude or [])
+
+    @staticmethod
+    def __get_initializer(name, graph_path: List[GraphProto]) -> Tuple[Optional[TensorProto], Optional[GraphProto]]:
+        for gid in range(len(graph_path) - 1, -1, -1):
+            graph = graph_path[gid]
+            for tensor in graph.initializer:
+                if tensor.name == name:
+                    return tensor, graph
+        return None, None
+
+    def _q4_matmul_node_weight(self, node: NodeProto, graph_stack: List[GraphProto]) -> NodeProto:
+        """If the node is a MatMul with a quantizable weight, return its MatMulNBits replacement, else the node."""
+        if node.op_type != "MatMul" or node.name in self.nodes_to_exclude:
+            return node
+
+        inputB = node.input[1]  # noqa: N806
+        B, Bs_graph = MatMulNBitsQuantizer.__get_initializer(inputB, graph_stack)  # noqa: N806
+        if B is None or B.data_type != TensorProto.FLOAT or len(B.dims) != 2:
+            logger.debug(f"MatMul {node.name} does not have a constant 2-D float weight, skipping it.")
+            return node
+
+        B_array = onnx_numpy_helper.to_array(B)  # noqa: N806
+        k, n = B_array.shape
+
+        packed, scales, zero_points = quantize_blockwise(B_array, self.block_size, self.bits, self.is_symmetric)
+
+        B_quant = onnx_numpy_helper.from_array(packed)  # noqa: N806
+        B_quant.name = B.name + f"_Q{self.bits}"
+        for input in Bs_graph.input:
+            if input.name == inputB:
+                Bs_graph.input.remove(input)
+                break
+
+        scales_tensor = onnx_numpy_helper.from_array(scales)
+        scales_tensor.name = B.name + "_scales"
+        Bs_graph.initializer.extend([B_quant, scales_tensor])
+
+        input_names = [node.input[0], B_quant.name, scales_tensor.name]
+        if zero_points is not None:
+            zp_tensor = onnx_numpy_helper.from_array(zero_points)
+            zp_tensor.name = B.name + "_zero_points"
+            Bs_graph.initializer.extend([zp_tensor])
+            input_names.append(zp_tensor.name)
+
+        return onnx.helper.make_node(
+            "MatMulNBits",
+            inputs=input_names,
+            outputs=[node.output[0]],
+            name=node.name + f"_Q{self.bits}" if node.name else "",
+            domain=ms_domain,
+            K=k,
+            N=n,
+            bits=self.bits,
+            block_size=self.block_size,
+        )
+
+    def _process_subgraph(self, graph_stack: List[GraphProto]):
+        new_nodes = []
+        graph = graph_stack[-1]
+
+        for node in graph.node:
+            graph_attrs = [
+                attr
+                for attr in node.attribute
+                if attr.type == onnx.AttributeProto.GRAPH or attr.type == onnx.AttributeProto.GRAPHS
+            ]
+            if graph_attrs:
+                for attr in node.attribute:
+                    if attr.type == onnx.AttributeProto.GRAPH:
+                        graph_stack.append(attr.g)
+                        self._process_subgraph(graph_stack)
+                    elif attr.type == onnx.AttributeProto.GRAPHS:
+                        for subgraph in attr.graphs:
+                            graph_stack.append(subgraph)
+                            self._process_subgraph(graph_stack)
+
+            new_nodes.append(self._q4_matmul_node_weight(node, graph_stack))
+
+        graph.ClearField("node")
+        graph.node.extend(new_nodes)
+        graph_stack.pop()
+        return graph
+
+    def process(self):
+        # use a stack to keep track of sub-graphs
+        graph_stack = [self.model.graph()]
+        opset_import = self.model.opset_import()
+
+        has_ms_domain = False
+        for opset in opset_import:
+            if opset.domain == ms_domain:
+                has_ms_domain = True
+        if not has_ms_domain:
+            opset_import.extend([onnx.helper.make_opsetid(ms_domain, 1)])
+
+        self._process_subgraph(graph_stack)
+        self.model.clean_initializers()
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description="""Blockwise weight-only quantization of MatMul nodes.
+Each MatMul with a constant 2-D float weight is replaced by a MatMulNBits node. The weights are quantized
+to 4 or 8 bits with a scale (and optionally a zero point) per block along the K dimension, while the
+activations stay in float."""
+    )
+
+    parser.add_argument("--input_model", required=True, help="Path to the input model file")
+    parser.add_argument("--output_model", required=True, help="Path to the output model file")
+    parser.add_argument("--block_size", required=False, default=32, type=int, help="Block size for quantization")
+    parser.add_argument("--bits", required=False, default=4, type=int, choices=[4, 8], help="Bits per weight")
+    parser.add_argument(
+        "--symmetric",
+        required=False,
+        default=False,
+        action="store_true",
+        help="Quantize the weights symmetrically, without zero points",
+    )
+    parser.add_argument("-v", "--verbose", required=False, action="store_true")
+    parser.set_defaults(verbose=False)
+    parser.add_argument(
+        "--nodes_to_exclude",
+        nargs="+",
+        type=str,
+        required=False,
+        default=[],
+        help="Specify the nodes to be excluded from quantization with node names",
+    )
+    parser.add_argument(
+        "--use_external_data_format",
+        required=False,
+        default=False,
+        action="store_true",
+        help="Save the quantized model with its weights in an external data file",
+    )
+
+    return parser.parse_args()
+
+
+if __name__ == "__main__":
+    args = parse_args()
+    if args.verbose:
+        logger.setLevel(logging.DEBUG)
+
+    input_model_path = args.input_model
+    output_model_path = args.output_model
+
+    if os.path.exists(output_model_path):
+        logger.error(f"file {output_model_path} already exists")
+        raise Exception(f"file {output_model_path} already exists")
+
+    model = onnx.load(input_model_path)
+    quant = MatMulNBitsQuantizer(model, args.block_size, args.bits, args.symmetric, args.nodes_to_exclude)
+    quant.process()
+    quant.model.save_model_to_file(output_model_path, args.use_external_data_format)
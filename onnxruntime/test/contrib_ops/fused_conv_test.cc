@@ -117,6 +117,58 @@ TEST(FusedConvTest, Conv2D_HardSigmoid) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, providers_except_cpu);
 }
 
+// The GELU and QuickGelu activations are only fused for the CPU EP.
+TEST(FusedConvTest, Conv2D_Gelu) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      1,                            // group
+      vector<int64_t>{2, 2},        // kernel_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      "Gelu"                        // activation
+  };
+
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+  vector<int64_t> X_shape = {1, 1, 3, 3};
+  vector<float> W = {0.125f, 0.125f, 0.125f, 0.125f, -0.125f, -0.125f, -0.125f, -0.125f};
+  vector<int64_t> W_shape = {2, 1, 2, 2};
+  vector<int64_t> Y_shape = {1, 2, 2, 2};
+  auto expected_vals = {1.399789f, 1.954500f, 2.995950f, 3.499186f, -0.100211f, -0.045500f, -0.004050f, -0.000814f};
+  TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, providers_except_cpu);
+
+  attrs.activation = "FastGelu";
+  auto expected_fast_gelu_vals = {1.399572f, 1.954598f, 2.996363f, 3.499384f,
+                                  -0.100428f, -0.045402f, -0.003637f, -0.000616f};
+  TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_fast_gelu_vals, Y_shape, providers_except_cpu);
+}
+
+TEST(FusedConvTest, Conv2D_QuickGelu) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      1,                            // group
+      vector<int64_t>{2, 2},        // kernel_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      "QuickGelu"                   // activation
+  };
+
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+  vector<int64_t> X_shape = {1, 1, 3, 3};
+  vector<float> W = {0.125f, 0.125f, 0.125f, 0.125f, -0.125f, -0.125f, -0.125f, -0.125f};
+  vector<int64_t> W_shape = {2, 1, 2, 2};
+  vector<int64_t> Y_shape = {1, 2, 2, 2};
+  auto expected_vals = {1.391662f, 1.935659f, 2.981929f, 3.490967f, -0.108338f, -0.064341f, -0.018071f, -0.009033f};
+  TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, providers_except_cpu);
+
+  // SiLU is QuickGelu with alpha = 1.
+  attrs.activation_parameters = {1.0f};
+  auto expected_silu_vals = {1.226362f, 1.761594f, 2.857722f, 3.397407f,
+                             -0.273638f, -0.238406f, -0.142278f, -0.102593f};
+  TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_silu_vals, Y_shape, providers_except_cpu);
+}
+
 TEST(FusedConvTest, Conv2D_Relu) {
   ConvOpAndTestAttributes attrs = {
       "",                           // auto_pad
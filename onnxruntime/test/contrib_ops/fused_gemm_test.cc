@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+static void RunFusedGemmTest(const std::string& activation, const std::vector<float>& activation_params,
+                             const std::vector<float>& expected_vals) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("activation", activation);
+  if (!activation_params.empty()) {
+    test.AddAttribute("activation_params", activation_params);
+  }
+
+  test.AddInput<float>("A", {2, 2}, {1.0f, 2.0f, -1.0f, -2.0f});
+  test.AddInput<float>("B", {2, 2}, {1.0f, 0.0f, 0.0f, 1.0f});
+  test.AddOutput<float>("Y", {2, 2}, expected_vals);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(FusedGemmTest, QuickGelu) {
+  RunFusedGemmTest("QuickGelu", {}, {0.845796f, 1.935659f, -0.154204f, -0.064341f});
+
+  // SiLU is QuickGelu with alpha = 1, passed through activation_params like FusedConv.
+  RunFusedGemmTest("QuickGelu", {1.0f}, {0.731059f, 1.761594f, -0.268941f, -0.238406f});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/mlas/inc/mlas.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Quantizes a random [K, N] weight matrix with MLAS and checks MatMulNBits against a float MatMul of A with the
+// dequantized weights.
+void RunMatMulNBitsTest(const std::vector<int64_t>& a_leading_dims, int64_t K, int64_t N, int64_t block_size,
+                        int64_t bits, bool has_zero_point) {
+  RandomValueGenerator random{};
+
+  std::vector<int64_t> a_dims = a_leading_dims;
+  a_dims.push_back(K);
+  int64_t M = 1;
+  for (int64_t dim : a_leading_dims) {
+    M *= dim;
+  }
+
+  std::vector<float> a_data = random.Uniform<float>(a_dims, -1.0f, 1.0f);
+  std::vector<float> b_data = random.Uniform<float>({K, N}, -1.0f, 1.0f);
+
+  size_t quant_b_data_size;
+  size_t quant_b_scale_count;
+  size_t quant_b_zero_point_size;
+  MlasSQNBitGemmQuantBSizes(static_cast<size_t>(bits), static_cast<size_t>(block_size), static_cast<size_t>(N),
+                            static_cast<size_t>(K), &quant_b_data_size, &quant_b_scale_count,
+                            &quant_b_zero_point_size);
+
+  std::vector<uint8_t> quant_b_data(quant_b_data_size);
+  std::vector<float> quant_b_scale(quant_b_scale_count);
+  std::vector<uint8_t> quant_b_zero_point(quant_b_zero_point_size);
+
+  MlasSQNBitGemmQuantizeB(static_cast<size_t>(bits), static_cast<size_t>(block_size), b_data.data(),
+                          static_cast<size_t>(N), static_cast<size_t>(N), static_cast<size_t>(K),
+                          quant_b_data.data(), quant_b_scale.data(),
+                          has_zero_point ? quant_b_zero_point.data() : nullptr);
+
+  // Dequantize the weights to compute the expected output.
+  const int64_t k_blocks = (K + block_size - 1) / block_size;
+  const int64_t blob_size = block_size * bits / 8;
+  const int64_t zero_point_stride = static_cast<int64_t>(quant_b_zero_point_size) / N;
+  auto get_value = [bits](const uint8_t* data, int64_t index) -> int32_t {
+    if (bits == 4) {
+      return (data[index / 2] >> ((index % 2) * 4)) & 0x0F;
+    }
+    return data[index];
+  };
+
+  std::vector<float> dequantized_b(static_cast<size_t>(K * N));
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t k = 0; k < K; k++) {
+      const int64_t block = k / block_size;
+      const int32_t zero_point = has_zero_point
+                                     ? get_value(quant_b_zero_point.data() + n * zero_point_stride, block)
+                                     : (1 << (bits - 1));
+      const int32_t value = get_value(quant_b_data.data() + (n * k_blocks + block) * blob_size, k % block_size);
+      dequantized_b[k * N + n] = static_cast<float>(value - zero_point) * quant_b_scale[n * k_blocks + block];
+    }
+  }
+
+  std::vector<float> expected(static_cast<size_t>(M * N));
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a_data[m * K + k] * dequantized_b[k * N + n];
+      }
+      expected[m * N + n] = sum;
+    }
+  }
+
+  std::vector<int64_t> y_dims = a_leading_dims;
+  y_dims.push_back(N);
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", bits);
+  test.AddInput<float>("A", a_dims, a_data);
+  test.AddInput<uint8_t>("B", {N, k_blocks, blob_size}, quant_b_data, true);
+  test.AddInput<float>("scales", {N * k_blocks}, quant_b_scale, true);
+  if (has_zero_point) {
+    test.AddInput<uint8_t>("zero_points", {static_cast<int64_t>(quant_b_zero_point_size)}, quant_b_zero_point, true);
+  } else {
+    test.AddOptionalInputEdge<uint8_t>();
+  }
+  test.AddOutput<float>("Y", y_dims, expected);
+  test.SetOutputAbsErr("Y", 1e-4f);
+  test.Run();
+}
+
+}  // namespace
+
+TEST(MatMulNBits, Float4Bit_Symmetric) {
+  for (int64_t block_size : {16, 32, 64, 128}) {
+    RunMatMulNBitsTest({1}, 64, 16, block_size, 4, false);
+    RunMatMulNBitsTest({4}, 96, 33, block_size, 4, false);
+  }
+}
+
+TEST(MatMulNBits, Float4Bit_ZeroPoint) {
+  for (int64_t block_size : {16, 32, 64, 128}) {
+    RunMatMulNBitsTest({1}, 64, 16, block_size, 4, true);
+    RunMatMulNBitsTest({2, 3}, 100, 17, block_size, 4, true);
+  }
+}
+
+TEST(MatMulNBits, Float8Bit) {
+  for (bool has_zero_point : {false, true}) {
+    RunMatMulNBitsTest({1}, 128, 32, 32, 8, has_zero_point);
+    RunMatMulNBitsTest({5}, 70, 20, 64, 8, has_zero_point);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -2,9 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/framework/bfc_arena.h"
+#include "test/util/include/asserts.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <cstring>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -298,5 +301,189 @@ TEST(BFCArenaTest, TestBackoffDoesntHang) {
   BFCArena a(std::unique_ptr<IAllocator>(new BadAllocator()), 10 * 1024 * 1024);
   EXPECT_THROW(a.Alloc(1024), OnnxRuntimeException) << "Arena should be unable to allocate memory";
 }
+
+static std::unique_ptr<BFCArena> CreateArenaWithThreadCache(int thread_local_cache_bytes,
+                                                            int thread_local_cache_max_alloc_bytes = 64 * 1024) {
+  return std::make_unique<BFCArena>(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+                                    BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+                                    BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+                                    BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+                                    BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+                                    thread_local_cache_bytes, thread_local_cache_max_alloc_bytes);
+}
+
+TEST(BFCArenaTest, ThreadCacheReusesFreedChunks) {
+  auto a = CreateArenaWithThreadCache(1 << 20);
+
+  void* first = a->Alloc(1000);
+  a->Free(first);
+  // same size class, served from the cache
+  void* second = a->Alloc(900);
+  EXPECT_EQ(first, second);
+  // larger than the size class of 1000 bytes
+  void* third = a->Alloc(1100);
+  EXPECT_NE(first, third);
+  // not cacheable
+  void* large = a->Alloc(1 << 20);
+
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_caches, 1);
+  EXPECT_EQ(stats.thread_cache_hits, 1);
+  EXPECT_EQ(stats.thread_cache_misses, 2);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  // allocations served by the cache are counted too
+  EXPECT_EQ(stats.num_allocs, 4);
+
+  a->Free(second);
+  a->Free(third);
+  a->Free(large);
+
+  // cached chunks stay in use as far as the arena is concerned
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.thread_cache_bytes, 1024 + 1280);
+  EXPECT_EQ(stats.bytes_in_use, 1024 + 1280);
+
+  ASSERT_STATUS_OK(a->Shrink());
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheReturnsChunksOverBudget) {
+  constexpr int kBudget = 16 * 1024;
+  auto a = CreateArenaWithThreadCache(kBudget);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 64; ++i) {
+    ptrs.push_back(a->Alloc(1024));
+  }
+
+  for (void* p : ptrs) {
+    a->Free(p);
+  }
+
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_GT(stats.thread_cache_flushes, 0);
+  EXPECT_LE(stats.thread_cache_bytes, kBudget);
+  EXPECT_EQ(stats.bytes_in_use, stats.thread_cache_bytes);
+}
+
+TEST(BFCArenaTest, ThreadCacheReturnsUnusedChunks) {
+  auto a = CreateArenaWithThreadCache(1 << 20);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 8; ++i) {
+    ptrs.push_back(a->Alloc(1024));
+  }
+
+  for (void* p : ptrs) {
+    a->Free(p);
+  }
+
+  // only one of the cached chunks is needed from now on, so the others are returned to the arena
+  for (int i = 0; i < 4096; ++i) {
+    a->Free(a->Alloc(1024));
+  }
+
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_GT(stats.thread_cache_flushes, 0);
+  EXPECT_EQ(stats.thread_cache_bytes, 1024);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+}
+
+TEST(BFCArenaTest, ThreadCacheReleasedOnThreadExit) {
+  auto a = CreateArenaWithThreadCache(1 << 20);
+
+  void* in_use = nullptr;
+  std::thread([&]() {
+    for (int i = 0; i < 4; ++i) {
+      a->Free(a->Alloc(512));
+    }
+
+    in_use = a->Alloc(512);
+  }).join();
+
+  // the free chunks of the exited thread were returned to the arena
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_caches, 0);
+  EXPECT_EQ(stats.thread_cache_hits, 4);
+  EXPECT_EQ(stats.num_allocs, 5);
+  EXPECT_EQ(stats.bytes_in_use, 512);
+
+  // and the chunk it handed out is freed to the arena directly
+  a->Free(in_use);
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheCrossThreadFree) {
+  auto a = CreateArenaWithThreadCache(1 << 20);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; ++i) {
+    ptrs.push_back(a->Alloc(512));
+  }
+
+  // freed by another thread, so the chunks go back to the cache of this thread
+  std::thread([&]() {
+    for (void* p : ptrs) {
+      a->Free(p);
+    }
+  }).join();
+
+  for (int i = 0; i < 16; ++i) {
+    void* p = a->Alloc(512);
+    EXPECT_NE(std::find(ptrs.begin(), ptrs.end(), p), ptrs.end());
+  }
+
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_caches, 1);
+  EXPECT_EQ(stats.thread_cache_hits, 16);
+}
+
+TEST(BFCArenaTest, ThreadCacheConcurrentAllocations) {
+  auto a = CreateArenaWithThreadCache(256 * 1024);
+
+  constexpr int kNumThreads = 8;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&a, t]() {
+      std::vector<void*> ptrs;
+      for (int iter = 0; iter < 100; ++iter) {
+        for (size_t size = 64; size <= 128 * 1024; size *= 2) {
+          void* p = a->Alloc(size + t);
+          memset(p, t, size + t);
+          ptrs.push_back(p);
+        }
+
+        for (void* p : ptrs) {
+          a->Free(p);
+        }
+
+        ptrs.clear();
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // the caches are released when their threads exit
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_caches, 0);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  EXPECT_GT(stats.thread_cache_hits, stats.thread_cache_misses);
+
+  ASSERT_STATUS_OK(a->Shrink());
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
 }  // namespace test
 }  // namespace onnxruntime
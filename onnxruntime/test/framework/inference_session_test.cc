@@ -29,6 +29,7 @@
 #include "core/graph/op.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/platform/env.h"
+#include "core/platform/path_lib.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #ifdef USE_CUDA
@@ -55,6 +56,7 @@
 #include "test/optimizer/dummy_graph_transformer.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/inference_session_wrapper.h"
+#include "test/util/include/temp_dir.h"
 
 #include "gtest/gtest.h"
 
@@ -492,6 +494,313 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+static std::vector<PathString> GetSessionCacheFiles(const PathString& cache_dir) {
+  std::vector<PathString> files;
+  LoopDir(cache_dir, [&](const ORTCHAR_T* filename, OrtFileType f_type) -> bool {
+    if (f_type == OrtFileType::TYPE_REG) {
+      files.push_back(ConcatPathComponent<ORTCHAR_T>(cache_dir, filename));
+    }
+    return true;
+  });
+  return files;
+}
+
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  const PathString test_model = ORT_TSTR("testdata/transform/abs-id-max.onnx");
+  TemporaryDirectory cache_dir(ORT_TSTR("optimized_model_cache_test"));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCache";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir.Path()).c_str()));
+
+  auto count_identity_nodes = [&](const SessionOptions& session_options, bool load_from_bytes) {
+    InferenceSessionWrapper session_object{session_options, GetEnvironment()};
+    if (load_from_bytes) {
+      std::ifstream model_file(test_model, ios::in | ios::binary);
+      std::vector<char> model_bytes((std::istreambuf_iterator<char>(model_file)), std::istreambuf_iterator<char>());
+      EXPECT_STATUS_OK(session_object.Load(model_bytes.data(), static_cast<int>(model_bytes.size())));
+    } else {
+      EXPECT_STATUS_OK(session_object.Load(test_model));
+    }
+    EXPECT_STATUS_OK(session_object.Initialize());
+    return CountOpsInGraph(session_object.GetGraph())["Identity"];
+  };
+
+  // the first session optimizes the model and writes it to the cache
+  ASSERT_EQ(count_identity_nodes(so, false), 0);
+  const auto cache_files = GetSessionCacheFiles(cache_dir.Path());
+  ASSERT_EQ(cache_files.size(), 1u);
+  const PathString& cache_file = cache_files[0];
+
+  // replace the cached model with the unoptimized model, so that the sessions using the cache keep the Identity nodes
+  SessionOptions so_noopt;
+  so_noopt.graph_optimization_level = TransformerLevel::Default;
+  so_noopt.optimized_model_filepath = cache_file;
+  ASSERT_GT(count_identity_nodes(so_noopt, false), 0);
+
+  ASSERT_GT(count_identity_nodes(so, false), 0);
+  ASSERT_GT(count_identity_nodes(so, true), 0);
+
+  // an invalid cache file is ignored and replaced
+  {
+    std::ofstream file(cache_file, ios::out | ios::binary | ios::trunc);
+    file << "not an ORT format model";
+  }
+  ASSERT_EQ(count_identity_nodes(so, false), 0);
+  ASSERT_EQ(count_identity_nodes(so, false), 0);
+  size_t cache_file_length = 0;
+  ASSERT_STATUS_OK(Env::Default().GetFileLength(cache_file.c_str(), cache_file_length));
+  ASSERT_GT(cache_file_length, strlen("not an ORT format model"));
+
+  // other options are cached separately
+  so.graph_optimization_level = TransformerLevel::Default;
+  ASSERT_GT(count_identity_nodes(so, false), 0);
+  ASSERT_EQ(GetSessionCacheFiles(cache_dir.Path()).size(), 2u);
+}
+
+TEST(InferenceSessionTests, OptimizedModelCacheWithExternalData) {
+  TemporaryDirectory model_dir(ORT_TSTR("optimized_model_cache_external_data_test"));
+  TemporaryDirectory cache_dir(ORT_TSTR("optimized_model_cache_external_data_test_cache"));
+  const PathString model_path = ConcatPathComponent<ORTCHAR_T>(model_dir.Path(), ORT_TSTR("gather.onnx"));
+  const PathString data_path = ConcatPathComponent<ORTCHAR_T>(model_dir.Path(), ORT_TSTR("data.bin"));
+
+  // output = data[indices] with data in an external data file
+  {
+    ONNX_NAMESPACE::ModelProto model;
+    model.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+    model.add_opset_import()->set_version(13);
+    ONNX_NAMESPACE::GraphProto& graph = *model.mutable_graph();
+    graph.set_name("gather");
+
+    ONNX_NAMESPACE::TensorProto& data = *graph.add_initializer();
+    data.set_name("data");
+    data.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_UINT8);
+    data.add_dims(4);
+    data.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
+    auto* location = data.add_external_data();
+    location->set_key("location");
+    location->set_value("data.bin");
+
+    ONNX_NAMESPACE::NodeProto& node = *graph.add_node();
+    node.set_op_type("Gather");
+    node.add_input("data");
+    node.add_input("indices");
+    node.add_output("output");
+
+    ONNX_NAMESPACE::ValueInfoProto& indices = *graph.add_input();
+    indices.set_name("indices");
+    indices.mutable_type()->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    indices.mutable_type()->mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+    ONNX_NAMESPACE::ValueInfoProto& output = *graph.add_output();
+    output.set_name("output");
+    output.mutable_type()->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_UINT8);
+
+    std::ofstream model_file(model_path, ios::out | ios::binary | ios::trunc);
+    ASSERT_TRUE(model.SerializeToOstream(&model_file));
+  }
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCacheWithExternalData";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir.Path()).c_str()));
+
+  auto run_with_data = [&](const std::string& data) {
+    {
+      std::ofstream data_file(data_path, ios::out | ios::binary | ios::trunc);
+      data_file << data;
+    }
+
+    InferenceSession session_object{so, GetEnvironment()};
+    EXPECT_STATUS_OK(session_object.Load(model_path));
+    EXPECT_STATUS_OK(session_object.Initialize());
+
+    OrtValue indices;
+    CreateMLValue<int64_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1}, {2}, &indices);
+    NameMLValMap feeds{{"indices", indices}};
+    const std::vector<std::string> output_names{"output"};
+    std::vector<OrtValue> fetches;
+    EXPECT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+    return fetches[0].Get<Tensor>().Data<uint8_t>()[0];
+  };
+
+  EXPECT_EQ(run_with_data(std::string("\x01\x02\x03\x04", 4)), 3);
+  EXPECT_EQ(run_with_data(std::string("\x01\x02\x03\x04", 4)), 3);
+  ASSERT_EQ(GetSessionCacheFiles(cache_dir.Path()).size(), 1u);
+
+  // the model file is unchanged but the weights are not, so the cached model is not used
+  EXPECT_EQ(run_with_data(std::string("\x05\x06\x07\x08", 4)), 7);
+  ASSERT_EQ(GetSessionCacheFiles(cache_dir.Path()).size(), 2u);
+}
+
+TEST(InferenceSessionTests, OptimizedModelCacheWithPrePackedWeights) {
+  TemporaryDirectory model_dir(ORT_TSTR("optimized_model_cache_prepacked_weights_test"));
+  TemporaryDirectory cache_dir(ORT_TSTR("optimized_model_cache_prepacked_weights_test_cache"));
+  const PathString model_path = ConcatPathComponent<ORTCHAR_T>(model_dir.Path(), ORT_TSTR("matmul.onnx"));
+
+  // Y = X * W with the constant W pre-packed by the MatMul kernel
+  constexpr int64_t K = 4;
+  constexpr int64_t N = 3;
+  {
+    ONNX_NAMESPACE::ModelProto model;
+    model.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+    model.add_opset_import()->set_version(13);
+    ONNX_NAMESPACE::GraphProto& graph = *model.mutable_graph();
+    graph.set_name("matmul");
+
+    ONNX_NAMESPACE::TensorProto& weights = *graph.add_initializer();
+    weights.set_name("W");
+    weights.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    weights.add_dims(K);
+    weights.add_dims(N);
+    for (int64_t i = 0; i < K * N; ++i) {
+      weights.add_float_data(static_cast<float>(i));
+    }
+
+    ONNX_NAMESPACE::NodeProto& node = *graph.add_node();
+    node.set_op_type("MatMul");
+    node.set_name("matmul");
+    node.add_input("X");
+    node.add_input("W");
+    node.add_output("Y");
+
+    ONNX_NAMESPACE::ValueInfoProto& input = *graph.add_input();
+    input.set_name("X");
+    input.mutable_type()->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    input.mutable_type()->mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+    input.mutable_type()->mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(K);
+    ONNX_NAMESPACE::ValueInfoProto& output = *graph.add_output();
+    output.set_name("Y");
+    output.mutable_type()->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+    std::ofstream model_file(model_path, ios::out | ios::binary | ios::trunc);
+    ASSERT_TRUE(model.SerializeToOstream(&model_file));
+  }
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCacheWithPrePackedWeights";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir.Path()).c_str()));
+
+  // returns the number of pre-packed weights the session used from the cache, after checking its output
+  auto run = [&]() {
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    EXPECT_STATUS_OK(session_object.Load(model_path));
+    EXPECT_STATUS_OK(session_object.Initialize());
+
+    OrtValue x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, K}, {1.f, 2.f, 3.f, 4.f},
+                         &x);
+    NameMLValMap feeds{{"X", x}};
+    const std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    EXPECT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+    const float* y = fetches[0].Get<Tensor>().Data<float>();
+    EXPECT_EQ(y[0], 60.f);
+    EXPECT_EQ(y[1], 70.f);
+    EXPECT_EQ(y[2], 80.f);
+    return session_object.GetSessionState().GetUsedSavedPrePackedWeightCounter();
+  };
+
+  // the first session writes the optimized model and the pre-packed weights, which the next one uses
+  ASSERT_EQ(run(), 0u);
+  const auto cache_files = GetSessionCacheFiles(cache_dir.Path());
+  ASSERT_EQ(cache_files.size(), 2u);
+  ASSERT_EQ(run(), 1u);
+
+  // an invalid pre-packed weights file is ignored and replaced
+  const PathString& prepacked_weights_file = cache_files[0].size() > cache_files[1].size() ? cache_files[0]
+                                                                                             : cache_files[1];
+  {
+    std::ofstream file(prepacked_weights_file, ios::out | ios::binary | ios::trunc);
+    file << "not a pre-packed weights file";
+  }
+  ASSERT_EQ(run(), 0u);
+  ASSERT_EQ(run(), 1u);
+  ASSERT_EQ(GetSessionCacheFiles(cache_dir.Path()).size(), 2u);
+}
+
+TEST(InferenceSessionTests, UseMmapForInitializers) {
+  TemporaryDirectory model_dir(ORT_TSTR("use_mmap_for_initializers_test"));
+  const PathString model_path = ConcatPathComponent<ORTCHAR_T>(model_dir.Path(), ORT_TSTR("gather.onnx"));
+
+  // a uint8 initializer is used in place wherever the raw data lands in the file
+  constexpr int64_t num_rows = 100;
+  constexpr int64_t row_size = 3;
+  {
+    ONNX_NAMESPACE::ModelProto model;
+    model.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+    model.add_opset_import()->set_version(13);
+    ONNX_NAMESPACE::GraphProto& graph = *model.mutable_graph();
+    graph.set_name("gather");
+
+    ONNX_NAMESPACE::TensorProto& data = *graph.add_initializer();
+    data.set_name("data");
+    data.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_UINT8);
+    data.add_dims(num_rows);
+    data.add_dims(row_size);
+    std::string raw_data(num_rows * row_size, '\0');
+    for (size_t i = 0; i < raw_data.size(); ++i) {
+      raw_data[i] = static_cast<char>(i);
+    }
+    data.set_raw_data(raw_data);
+
+    ONNX_NAMESPACE::NodeProto& node = *graph.add_node();
+    node.set_op_type("Gather");
+    node.add_input("data");
+    node.add_input("indices");
+    node.add_output("output");
+
+    ONNX_NAMESPACE::ValueInfoProto& indices = *graph.add_input();
+    indices.set_name("indices");
+    indices.mutable_type()->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    indices.mutable_type()->mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+    ONNX_NAMESPACE::ValueInfoProto& output = *graph.add_output();
+    output.set_name("output");
+    output.mutable_type()->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_UINT8);
+
+    std::ofstream model_file(model_path, ios::out | ios::binary | ios::trunc);
+    ASSERT_TRUE(model.SerializeToOstream(&model_file));
+  }
+
+  for (const bool use_mmap : {false, true}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.UseMmapForInitializers";
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseMmapForInitializers,
+                                                      use_mmap ? "1" : "0"));
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(model_path));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    if (use_mmap) {
+      // the initializer refers to the mapped model file instead of memory allocated by the session
+      const SessionState& session_state = session_object.GetSessionState();
+      int data_idx = -1;
+      ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("data", data_idx));
+      const Tensor& data = session_state.GetInitializedTensors().at(data_idx).Get<Tensor>();
+      EXPECT_EQ(data.Location().alloc_type, OrtDeviceAllocator);
+    }
+
+    OrtValue indices;
+    CreateMLValue<int64_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {7, 99},
+                           &indices);
+    NameMLValMap feeds{{"indices", indices}};
+    const std::vector<std::string> output_names{"output"};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+
+    ASSERT_EQ(fetches.size(), 1u);
+    const Tensor& output = fetches[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), TensorShape({2, row_size}));
+    // the values of the last rows wrap around
+    const std::vector<uint8_t> expected{21, 22, 23, 41, 42, 43};
+    EXPECT_EQ(std::vector<uint8_t>(output.Data<uint8_t>(), output.Data<uint8_t>() + output.Shape().Size()),
+              expected);
+  }
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -2943,5 +3252,112 @@ TEST(InferenceSessionTests, InterThreadPoolWithDenormalAsZero) {
   VerifyThreadPoolWithDenormalAsZero(session2.GetInterOpThreadPoolToUse(), false);
 }
 
+TEST(InferenceSessionTests, RunWithScratchBuffer) {
+  // M = (X + Y) + Z. the output of the first Add is the only tensor placed by the memory pattern.
+  onnxruntime::Model model("graph_1", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input_arg_x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& input_arg_y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& input_arg_z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+  auto& sum_arg = graph.GetOrCreateNodeArg("node_1_out_1", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("M", &float_tensor);
+  graph.AddNode("node_1", "Add", "node 1.", {&input_arg_x, &input_arg_y}, {&sum_arg});
+  graph.AddNode("node_2", "Add", "node 2.", {&sum_arg, &input_arg_z}, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunWithScratchBuffer";
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<int64_t> dims = {3, 2};
+  std::vector<float> values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<std::string> feed_names{"X", "Y", "Z"};
+  std::vector<OrtValue> feeds(feed_names.size());
+  for (auto& feed : feeds) {
+    CreateMLValue<float>(allocator, dims, values, &feed);
+  }
+
+  std::vector<std::string> output_names{"M"};
+  std::vector<float> expected_values = {3.0f, 6.0f, 9.0f, 12.0f, 15.0f, 18.0f};
+
+  // the memory pattern is generated by the first run
+  size_t scratch_buffer_size = 0;
+  ASSERT_STATUS_OK(session_object.GetScratchBufferSize(feed_names, feeds, allocator->Info(), scratch_buffer_size));
+  EXPECT_EQ(scratch_buffer_size, 0u);
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(run_options, feed_names, feeds, output_names, &fetches, nullptr));
+  VerifyOutputs(fetches, dims, expected_values);
+
+  ASSERT_STATUS_OK(session_object.GetScratchBufferSize(feed_names, feeds, allocator->Info(), scratch_buffer_size));
+  ASSERT_GE(scratch_buffer_size, values.size() * sizeof(float));
+
+  std::vector<float> scratch_buffer(scratch_buffer_size / sizeof(float), -1.0f);
+  run_options.scratch_buffer = scratch_buffer.data();
+  run_options.scratch_buffer_size = scratch_buffer_size;
+  run_options.scratch_buffer_location = allocator->Info();
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(run_options, feed_names, feeds, output_names, &fetches, nullptr));
+  VerifyOutputs(fetches, dims, expected_values);
+
+  // X + Y was written to the scratch buffer
+  const std::vector<float> expected_sum = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+  EXPECT_EQ(std::vector<float>(scratch_buffer.begin(), scratch_buffer.begin() + expected_sum.size()), expected_sum);
+
+  // a buffer smaller than the memory pattern requires fails the run rather than being replaced by an allocation
+  run_options.scratch_buffer_size = scratch_buffer_size - 1;
+  fetches.clear();
+  auto status = session_object.Run(run_options, feed_names, feeds, output_names, &fetches, nullptr);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("is too small"));
+}
+
+TEST(InferenceSessionTests, RunWithScratchBufferInParallelMode) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunWithScratchBufferInParallelMode";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 2;
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(allocator, dims_mul_x, values_mul_x, &ml_value);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value));
+
+  // the parallel executors do not use memory patterns, so the buffer is rejected rather than silently ignored
+  std::vector<float> scratch_buffer(64);
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+  run_options.scratch_buffer = scratch_buffer.data();
+  run_options.scratch_buffer_size = scratch_buffer.size() * sizeof(float);
+  run_options.scratch_buffer_location = allocator->Info();
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  auto status = session_object.Run(run_options, feeds, output_names, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("cannot be used in parallel execution mode"));
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "test/framework/test_utils.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::vector<OrtValue> CreateFeeds(const std::vector<std::vector<int64_t>>& shapes) {
+  auto alloc = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<OrtValue> feeds(shapes.size());
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    AllocateMLValue<float>(alloc, shapes[i], &feeds[i]);
+  }
+
+  return feeds;
+}
+
+static MemoryPatternGroup CreatePatternGroup(size_t peak_size) {
+  MemoryPatternGroup group;
+  group.locations.push_back(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault)->Info());
+  MemPatternPlanner planner{false};
+  planner.TraceAllocation(0, peak_size);
+  group.patterns.push_back(planner.GenerateMemPattern());
+  return group;
+}
+
+TEST(MemoryPatternCacheTest, ParseBuckets) {
+  MemoryPatternCacheOptions::BucketKind kind;
+  std::vector<int64_t> boundaries;
+
+  ASSERT_STATUS_OK(MemoryPatternCacheOptions::ParseBuckets("", kind, boundaries));
+  EXPECT_EQ(kind, MemoryPatternCacheOptions::BucketKind::kNone);
+
+  ASSERT_STATUS_OK(MemoryPatternCacheOptions::ParseBuckets("pow2", kind, boundaries));
+  EXPECT_EQ(kind, MemoryPatternCacheOptions::BucketKind::kPowerOfTwo);
+
+  ASSERT_STATUS_OK(MemoryPatternCacheOptions::ParseBuckets("16,32,128", kind, boundaries));
+  EXPECT_EQ(kind, MemoryPatternCacheOptions::BucketKind::kList);
+  EXPECT_EQ(boundaries, (std::vector<int64_t>{16, 32, 128}));
+
+  EXPECT_FALSE(MemoryPatternCacheOptions::ParseBuckets("32,16", kind, boundaries).IsOK());
+  EXPECT_FALSE(MemoryPatternCacheOptions::ParseBuckets("16,abc", kind, boundaries).IsOK());
+  EXPECT_FALSE(MemoryPatternCacheOptions::ParseBuckets("0", kind, boundaries).IsOK());
+}
+
+TEST(MemoryPatternCacheTest, RoundUpDim) {
+  MemoryPatternCache cache;
+  EXPECT_EQ(cache.RoundUpDim(33), 33);
+
+  MemoryPatternCacheOptions options;
+  options.bucket_kind = MemoryPatternCacheOptions::BucketKind::kPowerOfTwo;
+  cache.SetOptions(options);
+  EXPECT_EQ(cache.RoundUpDim(0), 0);
+  EXPECT_EQ(cache.RoundUpDim(1), 1);
+  EXPECT_EQ(cache.RoundUpDim(33), 64);
+  EXPECT_EQ(cache.RoundUpDim(64), 64);
+
+  options.bucket_kind = MemoryPatternCacheOptions::BucketKind::kList;
+  options.bucket_boundaries = {16, 48};
+  cache.SetOptions(options);
+  EXPECT_EQ(cache.RoundUpDim(1), 16);
+  EXPECT_EQ(cache.RoundUpDim(17), 48);
+  EXPECT_EQ(cache.RoundUpDim(49), 49);
+}
+
+TEST(MemoryPatternCacheTest, KeyIncludesRank) {
+  MemoryPatternCache cache;
+  auto a = CreateFeeds({{2, 3}, {4}});
+  auto b = CreateFeeds({{2}, {3, 4}});
+  EXPECT_NE(cache.CalculateKey(a), cache.CalculateKey(b));
+
+  // the XOR of the dims used to collide for these
+  auto c = CreateFeeds({{1, 2}});
+  auto d = CreateFeeds({{2, 1}});
+  EXPECT_NE(cache.CalculateKey(c), cache.CalculateKey(d));
+}
+
+TEST(MemoryPatternCacheTest, BucketsShareEntry) {
+  MemoryPatternCache cache;
+  MemoryPatternCacheOptions options;
+  options.bucket_kind = MemoryPatternCacheOptions::BucketKind::kPowerOfTwo;
+  cache.SetOptions(options);
+
+  auto seq_33 = CreateFeeds({{1, 33}});
+  auto seq_60 = CreateFeeds({{1, 60}});
+  auto seq_65 = CreateFeeds({{1, 65}});
+  EXPECT_EQ(cache.CalculateKey(seq_33), cache.CalculateKey(seq_60));
+  EXPECT_NE(cache.CalculateKey(seq_33), cache.CalculateKey(seq_65));
+
+  bool needs_planning = false;
+  EXPECT_EQ(cache.Find(cache.CalculateKey(seq_33), needs_planning), nullptr);
+  EXPECT_TRUE(needs_planning);
+  cache.Insert(cache.CalculateKey(seq_33), CreatePatternGroup(132));
+
+  auto patterns = cache.Find(cache.CalculateKey(seq_60), needs_planning);
+  ASSERT_NE(patterns, nullptr);
+  EXPECT_FALSE(needs_planning);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.num_entries, 1u);
+}
+
+TEST(MemoryPatternCacheTest, TooSmallEntryIsReplaced) {
+  MemoryPatternCache cache;
+  constexpr int64_t key = 1;
+  cache.Insert(key, CreatePatternGroup(128));
+
+  // a usable entry is not replaced
+  auto first = cache.Insert(key, CreatePatternGroup(64));
+  EXPECT_EQ(first->patterns[0].PeakSize(), 128u);
+
+  cache.MarkTooSmall(key);
+  bool needs_planning = false;
+  auto patterns = cache.Find(key, needs_planning);
+  // the previous pattern stays usable while the new one is planned
+  ASSERT_EQ(patterns, first);
+  EXPECT_TRUE(needs_planning);
+
+  auto regrown = cache.Insert(key, CreatePatternGroup(256));
+  EXPECT_EQ(regrown->patterns[0].PeakSize(), 256u);
+  EXPECT_EQ(cache.Find(key, needs_planning), regrown);
+  EXPECT_FALSE(needs_planning);
+  // a frame that started with the old pattern still holds it
+  EXPECT_EQ(first->patterns[0].PeakSize(), 128u);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.regrowths, 1u);
+  EXPECT_EQ(stats.num_entries, 1u);
+}
+
+TEST(MemoryPatternCacheTest, EvictsLeastRecentlyUsed) {
+  MemoryPatternCache cache;
+  MemoryPatternCacheOptions options;
+  options.max_entries = 2;
+  cache.SetOptions(options);
+
+  cache.Insert(1, CreatePatternGroup(16));
+  cache.Insert(2, CreatePatternGroup(16));
+
+  bool needs_planning = false;
+  ASSERT_NE(cache.Find(1, needs_planning), nullptr);
+
+  // 2 is the least recently used
+  cache.Insert(3, CreatePatternGroup(16));
+  EXPECT_NE(cache.Find(1, needs_planning), nullptr);
+  EXPECT_EQ(cache.Find(2, needs_planning), nullptr);
+  EXPECT_NE(cache.Find(3, needs_planning), nullptr);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.num_entries, 2u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_metrics.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(OpMetricsTest, HistogramBuckets) {
+  // small values have a bucket each
+  for (uint64_t value = 0; value < LatencyHistogram::kSubBuckets; ++value) {
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(value), value);
+  }
+
+  // every value is within its bucket and the buckets are contiguous
+  uint64_t previous_upper_bound = LatencyHistogram::kSubBuckets - 1;
+  for (size_t index = LatencyHistogram::kSubBuckets; index < LatencyHistogram::kNumBuckets - 1; ++index) {
+    const uint64_t upper_bound = LatencyHistogram::GetBucketUpperBound(index);
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(previous_upper_bound + 1), index);
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(upper_bound), index);
+    previous_upper_bound = upper_bound;
+  }
+
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(uint64_t{1} << 62), LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(OpMetricsTest, HistogramPercentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.GetPercentile(50), 0u);
+
+  for (uint64_t value = 1; value <= 100; ++value) {
+    histogram.Record(value * 1000);
+  }
+
+  EXPECT_EQ(histogram.Count(), 100u);
+  EXPECT_EQ(histogram.Total(), 5050u * 1000);
+  EXPECT_EQ(histogram.Max(), 100u * 1000);
+
+  // within the bucket width of the exact percentile
+  const auto p50 = histogram.GetPercentile(50);
+  EXPECT_GE(p50, 50u * 1000);
+  EXPECT_LE(p50, 50u * 1000 * 9 / 8);
+  EXPECT_EQ(histogram.GetPercentile(100), 100u * 1000);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Count(), 0u);
+  EXPECT_EQ(histogram.GetPercentile(99), 0u);
+}
+
+// Y = X + X
+static void CreateAddModel(std::string& model_data) {
+  onnxruntime::Model model("add", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("add_node", "Add", "", {&input_arg, &input_arg}, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+}
+
+static void RunSessionAndCheckOpMetrics(SessionOptions& so) {
+  std::string model_data;
+  CreateAddModel(model_data);
+
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableOpMetrics, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  OrtValue feed;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {1, 2}, &feed);
+  NameMLValMap feeds{{"X", feed}};
+  const std::vector<std::string> output_names{"Y"};
+  for (int i = 0; i < 3; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions(), feeds, output_names, &fetches));
+  }
+
+  std::string metrics;
+  ASSERT_STATUS_OK(session_object.GetOpMetrics(metrics));
+  EXPECT_NE(metrics.find("{\"name\": \"Add\", \"count\": 3,"), std::string::npos) << metrics;
+  EXPECT_NE(metrics.find("{\"name\": \"add_node\", \"op_type\": \"Add\", \"count\": 3,"), std::string::npos)
+      << metrics;
+
+  ASSERT_STATUS_OK(session_object.ResetOpMetrics());
+  ASSERT_STATUS_OK(session_object.GetOpMetrics(metrics));
+  EXPECT_EQ(metrics, "{\"op_types\": [], \"nodes\": []}");
+}
+
+TEST(OpMetricsTest, Session) {
+  SessionOptions so;
+  so.session_logid = "OpMetricsTest.Session";
+  RunSessionAndCheckOpMetrics(so);
+}
+
+TEST(OpMetricsTest, SessionParallelExecutor) {
+  SessionOptions so;
+  so.session_logid = "OpMetricsTest.SessionParallelExecutor";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 2;
+  RunSessionAndCheckOpMetrics(so);
+}
+
+TEST(OpMetricsTest, SessionDataflowExecutor) {
+  SessionOptions so;
+  so.session_logid = "OpMetricsTest.SessionDataflowExecutor";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseDataflowExecutor, "1"));
+  RunSessionAndCheckOpMetrics(so);
+}
+
+TEST(OpMetricsTest, SessionRequiresOption) {
+  std::string model_data;
+  CreateAddModel(model_data);
+
+  SessionOptions so;
+  so.session_logid = "OpMetricsTest.SessionRequiresOption";
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::string metrics;
+  EXPECT_FALSE(session_object.GetOpMetrics(metrics).IsOK());
+  EXPECT_FALSE(session_object.ResetOpMetrics().IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -3,7 +3,10 @@
 
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/test_environment.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
 
@@ -145,5 +148,119 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                          testing::Values(1, 0));
+
+// test that the status from TestOp is correctly returned when the DataflowExecutor is used
+TEST(DataflowExecutor, TestStatusPropagation) {
+  auto registry = std::make_shared<CustomRegistry>();
+  std::vector<OpSchema> schemas{TestOp::OpSchema()};
+  Status status;
+  ASSERT_TRUE((status = registry->RegisterOpSet(schemas, TestOp::OpDomain, 10, 11)).IsOK()) << status;
+  KernelCreateFn kernel_create_fn = [](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) { out = std::make_unique<typename TestOp::OpKernelImpl>(info); return Status::OK(); };
+  auto kernel_def = TestOp::KernelDef();
+  ASSERT_TRUE((status = registry->RegisterCustomKernel(kernel_def, kernel_create_fn)).IsOK()) << status;
+
+  onnxruntime::SessionOptions so;
+  so.session_logid = "DataflowExecutor.TestStatusPropagation";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseDataflowExecutor, "1"));
+
+  {  // test success
+    OpTester tester{"TestOp", 10, TestOp::OpDomain};
+    tester.AddCustomOpRegistry(registry);
+
+    tester.AddInput<int64_t>("action", {1}, {/*success*/ 0});
+    tester.AddOutput<int64_t>("action_out", {1}, {0});
+    tester.Run(so, OpTester::ExpectResult::kExpectSuccess, {}, {kTensorrtExecutionProvider});
+  }
+
+  {  // test failure
+    OpTester tester{"TestOp", 10, TestOp::OpDomain};
+    tester.AddCustomOpRegistry(registry);
+
+    tester.AddInput<int64_t>("action", {1}, {/*failure*/ 1});
+    tester.AddOutput<int64_t>("action_out", {1}, {0});
+    tester.Run(so, OpTester::ExpectResult::kExpectFailure, "Action was 1", {kTensorrtExecutionProvider});
+  }
+
+  {  // test exception
+    OpTester tester{"TestOp", 10, TestOp::OpDomain};
+    tester.AddCustomOpRegistry(registry);
+
+    tester.AddInput<int64_t>("action", {1}, {/*exception*/ 2});
+    tester.AddOutput<int64_t>("action_out", {1}, {0});
+    tester.Run(so, OpTester::ExpectResult::kExpectFailure, "Throwing as action was 2", {kTensorrtExecutionProvider});
+  }
+}
+
+// X -> num_branches x (Relu -> Neg -> Neg) -> chain of Adds -> Y, so Y = num_branches * relu(X)
+static void CreateWideBranchModel(int num_branches, std::string& model_data) {
+  onnxruntime::Model model("wide_branches", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  NodeArg* sum_arg = nullptr;
+  for (int i = 0; i < num_branches; ++i) {
+    const std::string branch = "branch_" + std::to_string(i);
+    auto& relu_out = graph.GetOrCreateNodeArg(branch + "_relu", &float_tensor);
+    auto& neg_out = graph.GetOrCreateNodeArg(branch + "_neg", &float_tensor);
+    auto& branch_out = graph.GetOrCreateNodeArg(branch + "_out", &float_tensor);
+    graph.AddNode(branch + "_relu", "Relu", "relu", {&input_arg}, {&relu_out});
+    graph.AddNode(branch + "_neg_0", "Neg", "neg", {&relu_out}, {&neg_out});
+    graph.AddNode(branch + "_neg_1", "Neg", "neg", {&neg_out}, {&branch_out});
+
+    if (sum_arg == nullptr) {
+      sum_arg = &branch_out;
+    } else {
+      auto& add_out = graph.GetOrCreateNodeArg(i == num_branches - 1 ? "Y" : branch + "_sum", &float_tensor);
+      graph.AddNode(branch + "_add", "Add", "add", {sum_arg, &branch_out}, {&add_out});
+      sum_arg = &add_out;
+    }
+  }
+
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+}
+
+TEST(DataflowExecutor, WideBranches) {
+  constexpr int num_branches = 16;
+  std::string model_data;
+  CreateWideBranchModel(num_branches, model_data);
+
+  SessionOptions so;
+  so.session_logid = "DataflowExecutor.WideBranches";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 4;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseDataflowExecutor, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {4},
+                       {-1.0f, 0.0f, 1.0f, 2.0f}, &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+  std::vector<std::string> output_names{"Y"};
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+
+  // run repeatedly so a race between branches has a chance to show up
+  for (int i = 0; i < 10; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    auto result = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    const std::vector<float> expected{0.0f, 0.0f, 1.0f * num_branches, 2.0f * num_branches};
+    ASSERT_EQ(std::vector<float>(result.begin(), result.end()), expected);
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,363 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/session/request_batcher.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static OrtValue CreateFeed(const std::vector<int64_t>& dims, const std::vector<float>& values) {
+  OrtValue feed;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims, values, &feed);
+  return feed;
+}
+
+static std::vector<float> GetValues(const OrtValue& value) {
+  auto span = value.Get<Tensor>().DataAsSpan<float>();
+  return std::vector<float>(span.begin(), span.end());
+}
+
+// returns the input as the output and records the shapes of the batches
+class IdentityRunner {
+ public:
+  RequestBatcher::RunFn GetRunFn() {
+    return [this](const RunOptions&, gsl::span<const std::string>, gsl::span<const OrtValue> feeds,
+                  gsl::span<const std::string>, std::vector<OrtValue>* p_fetches) {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      batch_shapes_.push_back(feeds[0].Get<Tensor>().Shape());
+      p_fetches->assign(1, feeds[0]);
+      return Status::OK();
+    };
+  }
+
+  std::vector<TensorShape> GetBatchShapes() {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    return batch_shapes_;
+  }
+
+ private:
+  OrtMutex mutex_;
+  std::vector<TensorShape> batch_shapes_;
+};
+
+static std::vector<std::vector<OrtValue>> RunConcurrently(RequestBatcher& batcher, const std::vector<OrtValue>& feeds,
+                                                          std::vector<Status>& statuses) {
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<std::vector<OrtValue>> fetches(feeds.size());
+  statuses.resize(feeds.size());
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      statuses[i] = batcher.Run(RunOptions(), feed_names, gsl::make_span(&feeds[i], 1), output_names, fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return fetches;
+}
+
+TEST(RequestBatcherTest, CanBatch) {
+  std::vector<OrtValue> fetches(1);
+  std::vector<OrtValue> feeds{CreateFeed({2, 3}, std::vector<float>(6)), CreateFeed({2}, {1, 2})};
+  EXPECT_TRUE(RequestBatcher::CanBatch(feeds, fetches));
+
+  // different batch dims
+  feeds = {CreateFeed({2, 3}, std::vector<float>(6)), CreateFeed({3}, {1, 2, 3})};
+  EXPECT_FALSE(RequestBatcher::CanBatch(feeds, fetches));
+
+  // no batch dim
+  feeds = {CreateFeed({}, {1})};
+  EXPECT_FALSE(RequestBatcher::CanBatch(feeds, fetches));
+
+  feeds = {CreateFeed({2}, {1, 2})};
+  std::vector<OrtValue> preallocated_fetches{CreateFeed({2}, {1, 2})};
+  EXPECT_FALSE(RequestBatcher::CanBatch(feeds, preallocated_fetches));
+}
+
+TEST(RequestBatcherTest, MergesConcurrentRequests) {
+  IdentityRunner runner;
+  RequestBatcherOptions options;
+  options.max_batch_size = 4;
+  // the batch runs once it is full
+  options.max_wait = std::chrono::seconds(30);
+  RequestBatcher batcher(options, TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), runner.GetRunFn());
+
+  std::vector<OrtValue> feeds;
+  for (int i = 0; i < 3; ++i) {
+    feeds.push_back(CreateFeed({1, 2}, {static_cast<float>(i), static_cast<float>(i)}));
+  }
+  feeds.push_back(CreateFeed({1, 2}, {3, 3}));
+
+  std::vector<Status> statuses;
+  auto fetches = RunConcurrently(batcher, feeds, statuses);
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ASSERT_STATUS_OK(statuses[i]);
+    ASSERT_EQ(fetches[i].size(), 1u);
+    EXPECT_EQ(fetches[i][0].Get<Tensor>().Shape(), TensorShape({1, 2}));
+    EXPECT_EQ(GetValues(fetches[i][0]), GetValues(feeds[i]));
+  }
+
+  ASSERT_EQ(runner.GetBatchShapes(), std::vector<TensorShape>{TensorShape({4, 2})});
+  auto stats = batcher.GetStats();
+  EXPECT_EQ(stats.num_requests, 4u);
+  EXPECT_EQ(stats.num_batches, 1u);
+  EXPECT_EQ(stats.num_rows, 4u);
+}
+
+TEST(RequestBatcherTest, PadsRaggedDims) {
+  IdentityRunner runner;
+  RequestBatcherOptions options;
+  options.max_batch_size = 2;
+  options.max_wait = std::chrono::seconds(30);
+  options.pad_ragged_dims = true;
+  options.output_dims = {{"Y", {{"X", 1}}}};
+  RequestBatcher batcher(options, TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), runner.GetRunFn());
+
+  std::vector<OrtValue> feeds{CreateFeed({1, 2}, {1, 2}), CreateFeed({1, 3}, {3, 4, 5})};
+  std::vector<Status> statuses;
+  auto fetches = RunConcurrently(batcher, feeds, statuses);
+  ASSERT_STATUS_OK(statuses[0]);
+  ASSERT_STATUS_OK(statuses[1]);
+
+  // the outputs are cropped back to the dims of the inputs of each request
+  EXPECT_EQ(fetches[0][0].Get<Tensor>().Shape(), TensorShape({1, 2}));
+  EXPECT_EQ(GetValues(fetches[0][0]), (std::vector<float>{1, 2}));
+  EXPECT_EQ(fetches[1][0].Get<Tensor>().Shape(), TensorShape({1, 3}));
+  EXPECT_EQ(GetValues(fetches[1][0]), (std::vector<float>{3, 4, 5}));
+  ASSERT_EQ(runner.GetBatchShapes(), std::vector<TensorShape>{TensorShape({2, 3})});
+}
+
+TEST(RequestBatcherTest, DoesNotPadOutputsThatCanNotBeCropped) {
+  IdentityRunner runner;
+  RequestBatcherOptions options;
+  options.max_batch_size = 2;
+  options.max_wait = std::chrono::milliseconds(1);
+  options.pad_ragged_dims = true;
+  RequestBatcher batcher(options, TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), runner.GetRunFn());
+
+  std::vector<OrtValue> feeds{CreateFeed({1, 2}, {1, 2}), CreateFeed({1, 3}, {3, 4, 5})};
+  std::vector<Status> statuses;
+  auto fetches = RunConcurrently(batcher, feeds, statuses);
+  ASSERT_STATUS_OK(statuses[0]);
+  ASSERT_STATUS_OK(statuses[1]);
+  EXPECT_EQ(GetValues(fetches[0][0]), (std::vector<float>{1, 2}));
+  EXPECT_EQ(GetValues(fetches[1][0]), (std::vector<float>{3, 4, 5}));
+  EXPECT_EQ(batcher.GetStats().num_batches, 2u);
+}
+
+TEST(RequestBatcherTest, MergesOnlySameRunOptions) {
+  IdentityRunner runner;
+  RequestBatcherOptions options;
+  options.max_batch_size = 2;
+  options.max_wait = std::chrono::milliseconds(1);
+  RequestBatcher batcher(options, TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), runner.GetRunFn());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> feeds{CreateFeed({1, 1}, {1}), CreateFeed({1, 1}, {2})};
+  std::vector<RunOptions> run_options(2);
+  run_options[1].run_tag = "other";
+  std::vector<std::vector<OrtValue>> fetches(2);
+  std::vector<Status> statuses(2);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 2; ++i) {
+    threads.emplace_back([&, i]() {
+      statuses[i] = batcher.Run(run_options[i], feed_names, gsl::make_span(&feeds[i], 1), output_names, fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_STATUS_OK(statuses[0]);
+  ASSERT_STATUS_OK(statuses[1]);
+  EXPECT_EQ(batcher.GetStats().num_batches, 2u);
+}
+
+TEST(RequestBatcherTest, RunsPartialBatchAfterMaxWait) {
+  IdentityRunner runner;
+  RequestBatcherOptions options;
+  options.max_batch_size = 8;
+  options.max_wait = std::chrono::milliseconds(1);
+  RequestBatcher batcher(options, TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), runner.GetRunFn());
+
+  std::vector<OrtValue> feeds{CreateFeed({2, 1}, {1, 2})};
+  std::vector<Status> statuses;
+  auto fetches = RunConcurrently(batcher, feeds, statuses);
+  ASSERT_STATUS_OK(statuses[0]);
+  EXPECT_EQ(GetValues(fetches[0][0]), (std::vector<float>{1, 2}));
+
+  auto stats = batcher.GetStats();
+  EXPECT_EQ(stats.num_batches, 1u);
+  EXPECT_EQ(stats.num_rows, 2u);
+  EXPECT_GE(stats.max_queue_time_us, 1000u);
+}
+
+TEST(RequestBatcherTest, OutputWithoutBatchDimFailsBatch) {
+  RequestBatcherOptions options;
+  options.max_batch_size = 2;
+  options.max_wait = std::chrono::seconds(30);
+  RequestBatcher batcher(options, TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault),
+                         [](const RunOptions&, gsl::span<const std::string>, gsl::span<const OrtValue>,
+                            gsl::span<const std::string>, std::vector<OrtValue>* p_fetches) {
+                           p_fetches->assign(1, CreateFeed({}, {1}));
+                           return Status::OK();
+                         });
+
+  std::vector<OrtValue> feeds{CreateFeed({1}, {1}), CreateFeed({1}, {2})};
+  std::vector<Status> statuses;
+  RunConcurrently(batcher, feeds, statuses);
+  EXPECT_FALSE(statuses[0].IsOK());
+  EXPECT_FALSE(statuses[1].IsOK());
+}
+
+// Y = X + X with X of shape {batch_dim, second_dim}
+static void CreateAddModel(bool dynamic_batch_dim, bool dynamic_second_dim, std::string& model_data) {
+  onnxruntime::Model model("add", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto* batch_dim = float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  if (dynamic_batch_dim) {
+    batch_dim->set_dim_param("batch");
+  } else {
+    batch_dim->set_dim_value(1);
+  }
+  auto* second_dim = float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  if (dynamic_second_dim) {
+    second_dim->set_dim_param("sequence");
+  } else {
+    second_dim->set_dim_value(2);
+  }
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("add", "Add", "", {&input_arg, &input_arg}, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+}
+
+TEST(RequestBatcherTest, Session) {
+  std::string model_data;
+  CreateAddModel(true, false, model_data);
+
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.Session";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigBatchingMaxBatchSize, "4"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigBatchingMaxWaitUs, "30000000"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<std::thread> threads;
+  std::vector<Status> statuses(2);
+  std::vector<std::vector<OrtValue>> fetches(2);
+  for (size_t i = 0; i < 2; ++i) {
+    threads.emplace_back([&, i]() {
+      const float value = static_cast<float>(i + 1);
+      std::vector<OrtValue> feeds{CreateFeed({2, 2}, std::vector<float>(4, value))};
+      statuses[i] = session_object.Run(RunOptions(), feed_names, feeds, output_names, &fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_STATUS_OK(statuses[i]);
+    EXPECT_EQ(GetValues(fetches[i][0]), std::vector<float>(4, 2.0f * (i + 1)));
+  }
+
+  auto stats = session_object.GetRequestBatcherStats();
+  EXPECT_EQ(stats.num_requests, 2u);
+  EXPECT_EQ(stats.num_batches, 1u);
+  EXPECT_EQ(stats.num_rows, 4u);
+}
+
+TEST(RequestBatcherTest, SessionPadsRaggedDims) {
+  std::string model_data;
+  CreateAddModel(true, true, model_data);
+
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.SessionPadsRaggedDims";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigBatchingMaxBatchSize, "2"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigBatchingMaxWaitUs, "30000000"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigBatchingPadRaggedDims, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<std::thread> threads;
+  std::vector<Status> statuses(2);
+  std::vector<std::vector<OrtValue>> fetches(2);
+  for (size_t i = 0; i < 2; ++i) {
+    threads.emplace_back([&, i]() {
+      const int64_t length = static_cast<int64_t>(i + 1);
+      std::vector<OrtValue> feeds{CreateFeed({1, length}, std::vector<float>(i + 1, 1.0f))};
+      statuses[i] = session_object.Run(RunOptions(), feed_names, feeds, output_names, &fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_STATUS_OK(statuses[i]);
+    EXPECT_EQ(fetches[i][0].Get<Tensor>().Shape(), TensorShape({1, static_cast<int64_t>(i + 1)}));
+    EXPECT_EQ(GetValues(fetches[i][0]), std::vector<float>(i + 1, 2.0f));
+  }
+
+  EXPECT_EQ(session_object.GetRequestBatcherStats().num_batches, 1u);
+}
+
+TEST(RequestBatcherTest, SessionWithoutDynamicBatchDimRunsUnbatched) {
+  std::string model_data;
+  CreateAddModel(false, false, model_data);
+
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.SessionWithoutDynamicBatchDimRunsUnbatched";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigBatchingMaxBatchSize, "4"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> feeds{CreateFeed({1, 2}, {1, 2})};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(RunOptions(), feed_names, feeds, output_names, &fetches));
+  EXPECT_EQ(GetValues(fetches[0]), (std::vector<float>{2, 4}));
+  EXPECT_EQ(session_object.GetRequestBatcherStats().num_requests, 0u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -77,7 +77,7 @@ TEST_P(SessionStateAddGetKernelTest, AddGetKernelTest) {
   auto kernel_def = KernelDefBuilder().SetName("Variable").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
 
   OpKernelInfo p_info(node, *kernel_def, *cpu_execution_provider, s.GetConstantInitializedTensors(),
-                      s.GetOrtValueNameIdxMap(), s.GetDataTransferMgr());
+                      s.GetOrtValueNameIdxMap(), s.GetDataTransferMgr(), s.GetConfigOptions());
   unique_ptr<TestOpKernel> p_kernel;
   p_kernel.reset(new TestOpKernel(p_info));
   size_t orig_num_outputs = p_kernel->Node().OutputDefs().size();
@@ -106,8 +106,10 @@ class TestParam {
   int ir_version;
   bool enable_mem_pattern;
   int thread_count;
+  bool parallel_initialization = false;
 };
-TestParam param_list[] = {{3, true, 0}, {4, true, 0}, {3, false, 0}, {4, false, 0}, {3, true, 1}, {4, true, 1}, {3, false, 1}, {4, false, 1}};
+TestParam param_list[] = {{3, true, 0}, {4, true, 0}, {3, false, 0}, {4, false, 0}, {3, true, 1}, {4, true, 1}, {3, false, 1}, {4, false, 1},
+                          {3, true, 0, true}, {4, false, 0, true}};
 }  // namespace
 class SessionStateTestP : public testing::TestWithParam<TestParam> {};
 // Test that we separate out constant and non-constant initializers correctly
@@ -147,7 +149,10 @@ TEST_P(SessionStateTestP, TestInitializerProcessing) {
                                  layout_transformer::TransformLayoutForEP);
   ASSERT_TRUE(status.IsOK()) << status;
 
-  ASSERT_STATUS_OK(session_state.FinalizeSessionState(oss.str(), krm));
+  SessionOptions sess_options;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigParallelInitialization] =
+      param.parallel_initialization ? "1" : "0";
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(oss.str(), krm, sess_options));
 
   const auto& initialized_tensors = session_state.GetInitializedTensors();
   const auto& const_initialized_tensors = session_state.GetConstantInitializedTensors();
@@ -465,6 +470,7 @@ static void PlaceAllNodesToCPUEP(Graph& graph) {
 struct PrepackingTestParam {
   bool test_subgraph;
   bool test_prepacking;
+  bool parallel_initialization = false;
 };
 
 class SessionStatePrepackingTest : public testing::TestWithParam<PrepackingTestParam> {};
@@ -522,6 +528,8 @@ TEST_P(SessionStatePrepackingTest, PrePackingTest) {
 
   SessionOptions sess_options;
   sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = test_param.test_prepacking ? "0" : "1";
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigParallelInitialization] =
+      test_param.parallel_initialization ? "1" : "0";
   ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
                                                       kernel_registry_manager,
                                                       sess_options));
@@ -781,7 +789,9 @@ INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          testing::Values(PrepackingTestParam{false, false},
                                          PrepackingTestParam{false, true},
                                          PrepackingTestParam{true, false},
-                                         PrepackingTestParam{true, true}));
+                                         PrepackingTestParam{true, true},
+                                         PrepackingTestParam{false, true, true},
+                                         PrepackingTestParam{true, true, true}));
 #endif
 
 }  // namespace test
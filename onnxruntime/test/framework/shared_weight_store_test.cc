@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_weight_store.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static void AddInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                           const std::vector<float>& values) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (auto dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+
+  tensor_proto.set_raw_data(values.data(), values.size() * sizeof(float));
+  graph.AddInitializedTensor(tensor_proto);
+}
+
+// Y = MatMul(X, W) + B + C with X of shape {1, 2}. W and B are the same in every model, C is given.
+static void CreateModel(float c, std::string& model_data) {
+  onnxruntime::Model model("shared_weights", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  AddInitializer(graph, "W", {2, 2}, {1, 2, 3, 4});
+  AddInitializer(graph, "B", {2}, {10, 20});
+  AddInitializer(graph, "C", {2}, {c, c});
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& w = graph.GetOrCreateNodeArg("W", nullptr);
+  auto& b = graph.GetOrCreateNodeArg("B", nullptr);
+  auto& cc = graph.GetOrCreateNodeArg("C", nullptr);
+  auto& matmul_out = graph.GetOrCreateNodeArg("matmul_out", nullptr);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("matmul", "MatMul", "", {&x, &w}, {&matmul_out});
+  graph.AddNode("add_b", "Add", "", {&matmul_out, &b}, {&add_out});
+  graph.AddNode("add_c", "Add", "", {&add_out, &cc}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+}
+
+static std::unique_ptr<InferenceSession> CreateSession(float c) {
+  std::string model_data;
+  CreateModel(c, model_data);
+
+  SessionOptions so;
+  so.session_logid = "SharedWeightStoreTest";
+  // keep the initializers as they are so that the pre-packed weights and the shared initializers are predictable
+  so.graph_optimization_level = TransformerLevel::Default;
+  EXPECT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigShareWeightsAcrossSessions, "1"));
+
+  auto session = std::make_unique<InferenceSession>(so, GetEnvironment());
+  std::stringstream model_stream(model_data);
+  EXPECT_STATUS_OK(session->Load(model_stream));
+  EXPECT_STATUS_OK(session->Initialize());
+  return session;
+}
+
+static std::vector<float> RunModel(InferenceSession& session) {
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 2}, {1, 1}, &x);
+  NameMLValMap feeds{{"X", x}};
+  std::vector<OrtValue> fetches;
+  EXPECT_STATUS_OK(session.Run(RunOptions(), feeds, std::vector<std::string>{"Y"}, &fetches));
+  if (fetches.size() != 1) {
+    return {};
+  }
+
+  auto span = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  return std::vector<float>(span.begin(), span.end());
+}
+
+TEST(SharedWeightStoreTest, SharesWeightsBetweenSessions) {
+  auto& store = SharedWeightStore::Instance();
+  const size_t num_initializers = store.NumInitializers();
+  const size_t num_prepacked_weights = store.NumPrePackedWeights();
+
+  auto session1 = CreateSession(100);
+  auto stats1 = session1->GetSharedWeightStats();
+  EXPECT_EQ(stats1.num_shared_initializers, 0u);
+  EXPECT_EQ(stats1.num_shared_prepacked_weights, 0u);
+
+  auto session2 = CreateSession(200);
+  auto stats2 = session2->GetSharedWeightStats();
+  // B is shared. W is only held as the weight MatMul pre-packs, and C differs.
+  EXPECT_EQ(stats2.num_shared_initializers, 1u);
+  EXPECT_EQ(stats2.shared_initializer_bytes, 2 * sizeof(float));
+  // the 2 columns of W are packed as 16 columns of 2 rows of floats
+  EXPECT_EQ(stats2.num_shared_prepacked_weights, 1u);
+  EXPECT_EQ(stats2.shared_prepacked_weight_bytes, 16 * 2 * sizeof(float));
+
+  EXPECT_EQ(RunModel(*session1), (std::vector<float>{114, 126}));
+  EXPECT_EQ(RunModel(*session2), (std::vector<float>{214, 226}));
+
+  // the weights are freed with the last session using them
+  session1.reset();
+  EXPECT_EQ(RunModel(*session2), (std::vector<float>{214, 226}));
+  session2.reset();
+  EXPECT_EQ(store.NumInitializers(), num_initializers);
+  EXPECT_EQ(store.NumPrePackedWeights(), num_prepacked_weights);
+}
+
+TEST(SharedWeightStoreTest, CanShareInitializer) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  tensor_proto.add_dims(1);
+  tensor_proto.add_float_data(1.f);
+  EXPECT_FALSE(SharedWeightStore::CanShareInitializer(tensor_proto));
+
+  tensor_proto.clear_float_data();
+  const float value = 1.f;
+  tensor_proto.set_raw_data(&value, sizeof(value));
+  EXPECT_TRUE(SharedWeightStore::CanShareInitializer(tensor_proto));
+}
+
+TEST(SharedWeightStoreTest, DistinguishesShapes) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  tensor_proto.add_dims(4);
+  const std::vector<float> values{1, 2, 3, 4};
+  tensor_proto.set_raw_data(values.data(), values.size() * sizeof(float));
+
+  auto& store = SharedWeightStore::Instance();
+  OrtValue value1;
+  bool is_shared = true;
+  ASSERT_STATUS_OK(store.GetOrAddInitializer(tensor_proto, value1, is_shared));
+  EXPECT_FALSE(is_shared);
+
+  OrtValue value2;
+  ASSERT_STATUS_OK(store.GetOrAddInitializer(tensor_proto, value2, is_shared));
+  EXPECT_TRUE(is_shared);
+  EXPECT_EQ(value1.Get<Tensor>().DataRaw(), value2.Get<Tensor>().DataRaw());
+
+  // same data with other dims
+  tensor_proto.clear_dims();
+  tensor_proto.add_dims(2);
+  tensor_proto.add_dims(2);
+  OrtValue value3;
+  ASSERT_STATUS_OK(store.GetOrAddInitializer(tensor_proto, value3, is_shared));
+  EXPECT_FALSE(is_shared);
+  EXPECT_EQ(value3.Get<Tensor>().Shape(), TensorShape({2, 2}));
+  EXPECT_EQ(value3.Get<Tensor>().DataAsSpan<float>()[3], 4.f);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_planner.h"
+#include "core/framework/static_memory_planner.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static AllocPlanPerValue::ProgramCounter CreateCounter(std::initializer_list<std::pair<size_t, size_t>> intervals) {
+  AllocPlanPerValue::ProgramCounter counter;
+  for (const auto& interval : intervals) {
+    counter.AddStart(interval.first);
+    counter.AddEnd(interval.second);
+  }
+
+  return counter;
+}
+
+TEST(StaticMemoryPlannerTest, OverlappingTimeSchedules) {
+  auto a = CreateCounter({{0, 1}});
+  auto b = CreateCounter({{1, 2}});
+  auto c = CreateCounter({{2, 3}});
+  auto d = CreateCounter({{0, 0}, {3, 4}});
+
+  // a value freed after a step overlaps the values allocated in that step
+  EXPECT_TRUE(StaticMemoryPlanner::OverlappingTimeSchedules(a, b));
+  EXPECT_FALSE(StaticMemoryPlanner::OverlappingTimeSchedules(a, c));
+  EXPECT_TRUE(StaticMemoryPlanner::OverlappingTimeSchedules(c, d));
+  EXPECT_FALSE(StaticMemoryPlanner::OverlappingTimeSchedules(b, d));
+}
+
+TEST(StaticMemoryPlannerTest, LowerPeakThanTracedPattern) {
+  // step 0: a and b are allocated, a is freed. step 1: c is allocated.
+  auto a = CreateCounter({{0, 0}});
+  auto b = CreateCounter({{0, 2}});
+  auto c = CreateCounter({{1, 2}});
+
+  MemPatternPlanner traced{false};
+  traced.TraceAllocation(0, 64);
+  traced.TraceAllocation(1, 32);
+  traced.TraceFree(0);
+  traced.TraceAllocation(2, 96);
+  // c does not fit in the hole left by a
+  EXPECT_EQ(traced.GenerateMemPattern().PeakSize(), 64u + 32u + 96u);
+
+  StaticMemoryPlanner planner;
+  planner.AddValue(0, 64, a);
+  planner.AddValue(1, 32, b);
+  planner.AddValue(2, 96, c);
+  auto pattern = planner.GenerateMemPattern();
+
+  // c is placed first and a shares its block
+  EXPECT_EQ(pattern.PeakSize(), 96u + 32u);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 96u);
+}
+
+TEST(StaticMemoryPlannerTest, ReusedBufferGapIsShared) {
+  // a buffer used by two values in steps 0-1 and 4-5 is free in between
+  auto reused = CreateCounter({{0, 1}, {4, 5}});
+  auto in_gap = CreateCounter({{2, 3}});
+  auto overlapping = CreateCounter({{1, 4}});
+
+  StaticMemoryPlanner planner;
+  planner.AddValue(0, 128, reused);
+  planner.AddValue(1, 128, in_gap);
+  planner.AddValue(2, 64, overlapping);
+  auto pattern = planner.GenerateMemPattern();
+
+  EXPECT_EQ(pattern.PeakSize(), 128u + 64u);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 128u);
+}
+
+// X -> MatMul(W1) -> MatMul(W2) -> MatMul(W3) -> Y with all weights set to 1
+static void CreateMatMulChainModel(const std::string& batch_dim, std::string& model_data) {
+  onnxruntime::Model model("matmul_chain", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto* batch = input_type.mutable_tensor_type()->mutable_shape()->add_dim();
+  if (batch_dim.empty()) {
+    batch->set_dim_value(4);
+  } else {
+    batch->set_dim_param(batch_dim);
+  }
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(8);
+
+  NodeArg* layer_input = &graph.GetOrCreateNodeArg("X", &input_type);
+  const std::vector<std::pair<int64_t, int64_t>> weight_dims{{8, 16}, {16, 8}, {8, 8}};
+  for (size_t i = 0; i < weight_dims.size(); ++i) {
+    const std::string suffix = std::to_string(i);
+    ONNX_NAMESPACE::TensorProto weight;
+    weight.set_name("W" + suffix);
+    weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    weight.add_dims(weight_dims[i].first);
+    weight.add_dims(weight_dims[i].second);
+    for (int64_t j = 0; j < weight_dims[i].first * weight_dims[i].second; ++j) {
+      weight.add_float_data(1.0f);
+    }
+    graph.AddInitializedTensor(weight);
+
+    auto& weight_arg = graph.GetOrCreateNodeArg(weight.name(), nullptr);
+    auto& output_arg = graph.GetOrCreateNodeArg(i == weight_dims.size() - 1 ? "Y" : "T" + suffix, nullptr);
+    graph.AddNode("matmul_" + suffix, "MatMul", "", {layer_input, &weight_arg}, {&output_arg});
+    layer_input = &output_arg;
+  }
+
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+}
+
+static void RunMatMulChainModel(InferenceSession& session_object) {
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {4, 8},
+                       std::vector<float>(32, 1.0f), &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+  std::vector<std::string> output_names{"Y"};
+
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+  ASSERT_EQ(fetches.size(), 1u);
+  auto result = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  ASSERT_EQ(std::vector<float>(result.begin(), result.end()), std::vector<float>(32, 8.0f * 16.0f * 8.0f));
+}
+
+TEST(StaticMemoryPlannerTest, SessionWithStaticShapes) {
+  std::string model_data;
+  CreateMatMulChainModel("", model_data);
+
+  SessionOptions so;
+  so.session_logid = "StaticMemoryPlannerTest.SessionWithStaticShapes";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlanning, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // T0 and T1. Y is allocated by the caller or as an output.
+  auto summary = session_object.GetStaticMemoryPlanSummary();
+  EXPECT_EQ(summary.num_planned_values, 2u);
+  EXPECT_GT(summary.peak_size, 0u);
+  EXPECT_LE(summary.peak_size, summary.mem_pattern_planner_peak_size);
+
+  for (int i = 0; i < 3; ++i) {
+    RunMatMulChainModel(session_object);
+  }
+
+  // the pattern planned at initialization is used instead of planning one from the first run
+  auto stats = session_object.GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.misses, 0u);
+  EXPECT_EQ(stats.num_entries, 0u);
+}
+
+TEST(StaticMemoryPlannerTest, SessionWithDynamicShapes) {
+  std::string model_data;
+  CreateMatMulChainModel("batch", model_data);
+
+  SessionOptions so;
+  so.session_logid = "StaticMemoryPlannerTest.SessionWithDynamicShapes";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlanning, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // nothing is planned and the pattern is planned from the first run as usual
+  EXPECT_EQ(session_object.GetStaticMemoryPlanSummary().num_planned_values, 0u);
+  RunMatMulChainModel(session_object);
+  EXPECT_EQ(session_object.GetMemoryPatternCacheStats().num_entries, 1u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -334,5 +334,88 @@ TEST(TensorProtoUtilsTest, ConstantTensorProtoWithExternalData) {
   TestConstantNodeConversionWithExternalData<float>(TensorProto_DataType_FLOAT);
   TestConstantNodeConversionWithExternalData<double>(TensorProto_DataType_DOUBLE);
 }
+
+static TensorProto CreateRawDataInitializer(const std::string& name, size_t num_bytes) {
+  TensorProto initializer;
+  initializer.set_name(name);
+  initializer.set_data_type(TensorProto_DataType_UINT8);
+  initializer.add_dims(static_cast<int64_t>(num_bytes));
+  std::string raw_data(num_bytes, '\0');
+  for (size_t i = 0; i < num_bytes; ++i) {
+    raw_data[i] = static_cast<char>(i * 7 + name.size());
+  }
+  initializer.set_raw_data(raw_data);
+  return initializer;
+}
+
+TEST(TensorProtoUtilsTest, UseModelBytesForInitializers) {
+  ModelProto model;
+  GraphProto& graph = *model.mutable_graph();
+  *graph.add_initializer() = CreateRawDataInitializer("large", 256);
+  *graph.add_initializer() = CreateRawDataInitializer("small", 16);
+
+  NodeProto& node = *graph.add_node();
+  node.set_op_type("If");
+  AttributeProto& then_branch = *node.add_attribute();
+  then_branch.set_name("then_branch");
+  then_branch.set_type(AttributeProto_AttributeType_GRAPH);
+  *then_branch.mutable_g()->add_initializer() = CreateRawDataInitializer("subgraph_large", 1000);
+  AttributeProto& graphs = *node.add_attribute();
+  graphs.set_name("graphs");
+  graphs.set_type(AttributeProto_AttributeType_GRAPHS);
+  graphs.add_graphs();
+  *graphs.add_graphs()->add_initializer() = CreateRawDataInitializer("graphs_large", 300);
+
+  const std::string model_bytes = model.SerializeAsString();
+  const auto model_bytes_span = gsl::make_span(reinterpret_cast<const uint8_t*>(model_bytes.data()),
+                                               model_bytes.size());
+
+  ModelProto parsed_model;
+  ASSERT_TRUE(parsed_model.ParseFromString(model_bytes));
+  size_t num_initializers = 0;
+  ASSERT_STATUS_OK(UseModelBytesForInitializers(model_bytes_span, parsed_model, num_initializers));
+  EXPECT_EQ(num_initializers, 3u);
+
+  const GraphProto& parsed_graph = parsed_model.graph();
+  const TensorProto* const initializers[] = {&parsed_graph.initializer(0), &parsed_graph.initializer(1),
+                                             &parsed_graph.node(0).attribute(0).g().initializer(0),
+                                             &parsed_graph.node(0).attribute(1).graphs(1).initializer(0)};
+  const TensorProto* const original_initializers[] = {&graph.initializer(0), &graph.initializer(1),
+                                                      &then_branch.g().initializer(0),
+                                                      &graphs.graphs(1).initializer(0)};
+  for (size_t i = 0; i < 4; ++i) {
+    const TensorProto& initializer = *initializers[i];
+    const std::string& raw_data = original_initializers[i]->raw_data();
+    EXPECT_EQ(HasExternalData(initializer), i != 1) << initializer.name();
+
+    if (HasExternalData(initializer)) {
+      // the data is in place in the model bytes
+      void* data = nullptr;
+      SafeInt<size_t> data_len = 0;
+      OrtCallback deleter;
+      ASSERT_STATUS_OK(GetExtDataFromTensorProto(Env::Default(), nullptr, initializer, data, data_len, deleter));
+      EXPECT_GE(static_cast<const char*>(data), model_bytes.data());
+      EXPECT_LE(static_cast<const char*>(data) + raw_data.size(), model_bytes.data() + model_bytes.size());
+      EXPECT_FALSE(initializer.has_raw_data());
+    }
+
+    std::vector<uint8_t> unpacked;
+    ASSERT_STATUS_OK(UnpackInitializerData(initializer, Path(), unpacked));
+    EXPECT_EQ(std::string(unpacked.begin(), unpacked.end()), raw_data) << initializer.name();
+  }
+
+  // bytes of another model are rejected without changing the model
+  ModelProto other_model;
+  *other_model.mutable_graph()->add_initializer() = CreateRawDataInitializer("large", 256);
+  const std::string other_model_bytes = other_model.SerializeAsString();
+  ModelProto unchanged_model;
+  ASSERT_TRUE(unchanged_model.ParseFromString(model_bytes));
+  EXPECT_FALSE(UseModelBytesForInitializers(gsl::make_span(reinterpret_cast<const uint8_t*>(other_model_bytes.data()),
+                                                           other_model_bytes.size()),
+                                            unchanged_model, num_initializers)
+                   .IsOK());
+  EXPECT_EQ(num_initializers, 0u);
+  EXPECT_TRUE(unchanged_model.graph().initializer(0).has_raw_data());
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -1750,6 +1750,83 @@ TEST_F(GraphTest, ReplaceInitializedTensor) {
   }
 }
 
+// Resolve only runs the type and shape inference of the nodes for which something it reads changed,
+// which has to cover the changes transformers make in place.
+TEST_F(GraphTest, ResolveInfersChangedAttributesAndDownstreamNodes) {
+  Model model("graph", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_int32;
+  SetTypeAndShape(tensor_int32.mutable_tensor_type(), TensorProto_DataType_INT32, {2, 3});
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &tensor_int32);
+  auto& cast_arg = graph.GetOrCreateNodeArg("cast_out", nullptr);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& cast_node = graph.AddNode("cast", "Cast", "cast", {&input_arg}, {&cast_arg});
+  cast_node.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.AddNode("identity", "Identity", "identity", {&cast_arg}, {&output_arg});
+
+  // the types are overridden in both resolves, so only the changed attribute makes the inference of Cast run again
+  Graph::ResolveOptions options;
+  options.override_types = true;
+  options.skip_unchanged_inference = true;
+  ASSERT_STATUS_OK(graph.Resolve(options));
+  EXPECT_EQ(*output_arg.Type(), "tensor(float)");
+
+  // change the attribute without going through Node::AddAttribute
+  cast_node.GetMutableAttributes()["to"].set_i(TensorProto_DataType_INT64);
+  graph.SetGraphResolveNeeded();
+
+  ASSERT_STATUS_OK(graph.Resolve(options));
+  EXPECT_EQ(*cast_arg.Type(), "tensor(int64)");
+  EXPECT_EQ(*output_arg.Type(), "tensor(int64)");
+  EXPECT_EQ(utils::GetTensorShapeFromTensorShapeProto(*output_arg.Shape()), TensorShape({2, 3}));
+}
+
+TEST_F(GraphTest, ResolveInfersNodesWithReplacedInitializerData) {
+  Model model("graph", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  SetTypeAndShape(tensor_float.mutable_tensor_type(), TensorProto_DataType_FLOAT, {6});
+
+  ONNX_NAMESPACE::TensorProto shape{};
+  shape.set_name("shape");
+  shape.set_data_type(TensorProto_DataType_INT64);
+  shape.add_dims(2);
+  shape.add_int64_data(2);
+  shape.add_int64_data(3);
+  graph.AddInitializedTensor(shape);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& shape_arg = graph.GetOrCreateNodeArg("shape", nullptr);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("reshape", "Reshape", "reshape", {&input_arg, &shape_arg}, {&output_arg});
+
+  Graph::ResolveOptions options;
+  options.skip_unchanged_inference = true;
+  ASSERT_STATUS_OK(graph.Resolve(options));
+  EXPECT_EQ(utils::GetTensorShapeFromTensorShapeProto(*output_arg.Shape()), TensorShape({2, 3}));
+
+  // the initializer keeps its TensorProto, only the data changes
+  shape.clear_int64_data();
+  shape.add_int64_data(1);
+  shape.add_int64_data(6);
+  ASSERT_STATUS_OK(graph.ReplaceInitializedTensor(shape));
+  graph.SetGraphResolveNeeded();
+
+  // the inferred shape conflicts with the existing one, so the dims are merged leniently into unknown dims
+  ASSERT_STATUS_OK(graph.Resolve(options));
+  ASSERT_EQ(output_arg.Shape()->dim_size(), 2);
+  EXPECT_FALSE(utils::HasDimValue(output_arg.Shape()->dim(0)));
+  EXPECT_FALSE(utils::HasDimValue(output_arg.Shape()->dim(1)));
+
+  output_arg.ClearShape();
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve(options));
+  EXPECT_EQ(utils::GetTensorShapeFromTensorShapeProto(*output_arg.Shape()), TensorShape({1, 6}));
+}
+
 #if !defined(ORT_MINIMAL_BUILD) && !defined(DISABLE_EXTERNAL_INITIALIZERS)
 
 namespace {
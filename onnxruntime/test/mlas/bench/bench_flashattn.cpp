@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <cmath>
+#include <stdexcept>
+
+static const std::vector<std::string> attention_bench_arg_names = {"B", "N", "S", "H", "Causal"};
+
+//
+// Compares the fused attention kernel with the unfused path used by the
+// attention operators: Q x K' into a BxNxSxS* score buffer, an in-place softmax,
+// then the score buffer x V. The "ScratchBytes" counter reports the temporary
+// memory each path needs beyond the inputs and the output.
+//
+
+void ATTENTION(benchmark::State& state, bool fused) {
+  const size_t B = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t S = static_cast<size_t>(state.range(2));
+  const size_t H = static_cast<size_t>(state.range(3));
+  const bool causal = state.range(4) != 0;
+  if (B == 0 || N == 0 || S == 0 || H == 0) throw std::invalid_argument("Dimensions must be greater than 0!");
+
+  auto Q = RandomVectorUniform(B * N * S * H, -1.0f, 1.0f);
+  auto K = RandomVectorUniform(B * N * S * H, -1.0f, 1.0f);
+  auto V = RandomVectorUniform(B * N * S * H, -1.0f, 1.0f);
+  std::vector<float> Output(B * S * N * H);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(H));
+
+  if (fused) {
+    MLAS_FLASH_ATTENTION_PARAMETERS params;
+    params.BatchCount = B;
+    params.HeadCount = N;
+    params.SequenceLength = S;
+    params.KvSequenceLength = S;
+    params.QkHeadSize = H;
+    params.VHeadSize = H;
+    params.Scale = scale;
+    params.Causal = causal;
+    params.Query = Q.data();
+    params.Key = K.data();
+    params.Value = V.data();
+    params.KeyBias = nullptr;
+    params.Output = Output.data();
+
+    for (auto _ : state) {
+      MlasFlashAttention(&params, nullptr);
+    }
+
+    state.counters["ScratchBytes"] = 0;
+
+  } else {
+    std::vector<float> probs(B * N * S * S);
+    std::vector<float> out_tmp(B * N * S * H);
+
+    for (auto _ : state) {
+      for (size_t i = 0; i < B * N; i++) {
+        float* p = probs.data() + i * S * S;
+        MlasGemm(CblasNoTrans, CblasTrans, S, S, H, scale, Q.data() + i * S * H, H, K.data() + i * S * H, H,
+                 0.0f, p, S, nullptr);
+        if (causal) {
+          for (size_t s = 0; s < S; s++) {
+            std::fill(p + s * S + s + 1, p + (s + 1) * S, -10000.0f);
+          }
+        }
+      }
+      MlasComputeSoftmax(probs.data(), probs.data(), B * N * S, S, false, nullptr);
+      for (size_t i = 0; i < B * N; i++) {
+        MlasGemm(CblasNoTrans, CblasNoTrans, S, H, S, 1.0f, probs.data() + i * S * S, S, V.data() + i * S * H, H,
+                 0.0f, out_tmp.data() + i * S * H, H, nullptr);
+      }
+      for (size_t b = 0; b < B; b++) {
+        for (size_t n = 0; n < N; n++) {
+          for (size_t s = 0; s < S; s++) {
+            std::copy_n(out_tmp.data() + ((b * N + n) * S + s) * H, H, Output.data() + ((b * S + s) * N + n) * H);
+          }
+        }
+      }
+    }
+
+    state.counters["ScratchBytes"] = static_cast<double>((probs.size() + out_tmp.size()) * sizeof(float));
+  }
+}
+
+static void AttentionSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(attention_bench_arg_names);
+  ArgsProduct(b, {{1}, {12}, {128, 512, 1024, 2048, 4096}, {64}, {0, 1}});
+}
+
+BENCHMARK_CAPTURE(ATTENTION, Unfused, false)->Apply(AttentionSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ATTENTION, Fused, true)->Apply(AttentionSizes)->UseRealTime();
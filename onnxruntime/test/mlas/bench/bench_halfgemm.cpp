@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> halfgemm_bench_arg_names = {"M", "N", "K"};
+
+//
+// Half precision GEMM with matrix B prepacked, the way the CPU MatMul and Gemm
+// kernels run it for constant weights. Compare with SGEMM PACKB_NoTransA.
+//
+
+void HALFGEMM(benchmark::State& state, bool pack_b) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  auto A_float = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B_float = RandomVectorUniform(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<MLAS_FP16> A(A_float.size());
+  std::vector<MLAS_FP16> B(B_float.size());
+  std::vector<MLAS_FP16> C(static_cast<size_t>(M * N));
+  MlasConvertFloatToHalfBuffer(A_float.data(), A.data(), A.size());
+  MlasConvertFloatToHalfBuffer(B_float.data(), B.data(), B.size());
+
+  std::vector<uint8_t> B_packed;
+
+  MLAS_HALF_GEMM_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = K;
+  data.C = C.data();
+  data.ldc = N;
+
+  if (pack_b) {
+    B_packed.resize(MlasHalfGemmPackBSize(N, K));
+    MlasHalfGemmPackB(CblasNoTrans, N, K, B.data(), N, B_packed.data());
+    data.B = B_packed.data();
+    data.BIsPacked = true;
+  } else {
+    data.B = B.data();
+    data.ldb = N;
+  }
+
+  MlasHalfGemm(CblasNoTrans, M, N, K, data, nullptr);
+
+  for (auto _ : state) {
+    MlasHalfGemm(CblasNoTrans, M, N, K, data, nullptr);
+  }
+}
+
+static void HalfGemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(halfgemm_bench_arg_names);
+  ArgsProduct(b, {{1, 63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+BENCHMARK_CAPTURE(HALFGEMM, PACKB, true)->Apply(HalfGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, NOPACKB, false)->Apply(HalfGemmSizeProducts)->UseRealTime();
@@ -4,6 +4,7 @@
 #include "mlas.h"
 #include "bench_util.h"
 
+#include <cstring>
 #include <stdexcept>
 #include <numeric>
 
@@ -38,8 +39,9 @@ static const std::vector<std::string>& ArgNamesForConv(size_t rank) {
   return rank_to_args_name[rank];
 }
 
-// dummy for some strange build error when using Bench capture
-void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
+// The algorithm is empty to use the one selected by MlasConvPrepare. For the convolutions that use the Winograd
+// algorithm, it can be "packed" to use a filter packed ahead of time or "im2col" to use the GEMM based algorithm.
+void SCONV_NCHW(benchmark::State& state, const char* algorithm) {
   const int64_t rank = state.range(0);                       // Rank
   const int64_t batch_size = state.range(1);                 // N
   const int64_t groups = state.range(2);                     // G
@@ -114,6 +116,25 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
 
   auto X = RandomVectorUniform(x_shape, -2.0, 2.0);
   auto F = RandomVectorUniform(f_shape, -1.0, 1.0);
+
+  std::vector<float> packed_filter;
+  if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+    if (strcmp(algorithm, "packed") == 0) {
+      const size_t output_tile_size = Parameters.u.Winograd.OutputTileSize;
+      packed_filter.resize(MlasConvWinogradPackFilterSize(output_tile_size, static_cast<size_t>(groups),
+                                                          static_cast<size_t>(output_channels_per_group),
+                                                          static_cast<size_t>(input_channels_per_group)));
+      MlasConvWinogradPackFilter(output_tile_size, static_cast<size_t>(groups),
+                                 static_cast<size_t>(output_channels_per_group),
+                                 static_cast<size_t>(input_channels_per_group), F.data(), packed_filter.data());
+      Parameters.u.Winograd.PackedFilter = packed_filter.data();
+      WorkingBufferSize -= Parameters.u.Winograd.FilterBufferSize;
+    } else if (strcmp(algorithm, "im2col") == 0) {
+      // expand the whole input and invoke the GEMM as done for these shapes before the Winograd algorithm
+      Parameters.Algorithm = MlasConvAlgorithmExpandThenGemm;
+      WorkingBufferSize = Parameters.OutputSize * Parameters.K;
+    }
+  }
   int64_t y_size = std::accumulate(y_shape.begin(), y_shape.end(), 1LL, std::multiplies<int64_t>());
   std::vector<float> Y(static_cast<size_t>(y_size));
   std::vector<float> working_buffer(WorkingBufferSize);
@@ -246,3 +267,20 @@ static void General_Conv2d(benchmark::internal::Benchmark* b) {
 }
 
 BENCHMARK_CAPTURE(SCONV_NCHW, 2d, "")->Apply(General_Conv2d)->UseRealTime();
+
+// 3x3 convolutions with unit strides that use the Winograd algorithm.
+static void Winograd(benchmark::internal::Benchmark* b) {
+  b->ArgNames(ArgNamesForConv(2));
+  //    Rank, N, G,  Cpg, Fpg,  I,   , K, , P, , , , S, , D, ,
+  b->Args({2, 1, 1,   64,  64, 56, 56, 3,3, 1,1,1,1, 1,1, 1,1});  // ResNet50 Conv 2.X
+  b->Args({2, 1, 1,  128, 128, 28, 28, 3,3, 1,1,1,1, 1,1, 1,1});  // ResNet50 Conv 3.X
+  b->Args({2, 1, 1,  256, 256, 14, 14, 3,3, 1,1,1,1, 1,1, 1,1});  // ResNet50 Conv 4.X
+  b->Args({2, 1, 1,  512, 512,  7,  7, 3,3, 1,1,1,1, 1,1, 1,1});  // ResNet50 Conv 5.X
+  b->Args({2, 1, 1,   32,  64,104,104, 3,3, 1,1,1,1, 1,1, 1,1});  // YOLO
+  b->Args({2, 1, 1,  128, 256, 26, 26, 3,3, 1,1,1,1, 1,1, 1,1});  // YOLO
+  b->Args({2, 4, 1,   64,  64, 56, 56, 3,3, 1,1,1,1, 1,1, 1,1});
+}
+
+BENCHMARK_CAPTURE(SCONV_NCHW, Winograd, "")->Apply(Winograd)->UseRealTime();
+BENCHMARK_CAPTURE(SCONV_NCHW, Winograd_PackedFilter, "packed")->Apply(Winograd)->UseRealTime();
+BENCHMARK_CAPTURE(SCONV_NCHW, Winograd_Im2Col, "im2col")->Apply(Winograd)->UseRealTime();
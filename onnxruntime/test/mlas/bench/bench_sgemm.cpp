@@ -3,11 +3,14 @@
 
 #include "mlas.h"
 #include "bench_util.h"
+#include "core/util/thread_utils.h"
 
 #include <stdexcept>
+#include <memory>
 #include <numeric>
 
 static const std::vector<std::string> sgemm_bench_arg_names = {"M", "N", "K"};
+static const std::vector<std::string> sgemm_batch_bench_arg_names = {"M", "N", "K", "Batch", "Threads"};
 
 void SGEMM(benchmark::State& state, bool pack_b, bool trans_a, bool trans_b, float alpha = 1.0f, float beta = 0.0f) {
   if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
@@ -118,3 +121,57 @@ BENCHMARK_CAPTURE(SGEMM, GEMV_ABTrans, false, true, true)->Apply(GemmSizeWithOne
 
 BENCHMARK_CAPTURE(SGEMM, PACKB_NoTransA, true, false, false)->Apply(GemmSizeProducts)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, PACKB_TransA, true, true, false)->Apply(GemmSizeProducts)->UseRealTime();
+
+//
+// Batches of small operations, such as the per head matrix multiplications of
+// attention. With broadcast_b, all the operations of the batch share matrix B.
+//
+
+void SGEMM_BATCH(benchmark::State& state, bool broadcast_b) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  if (state.range(3) <= 0) throw std::invalid_argument("Batch must greater than 0!");
+  if (state.range(4) <= 0) throw std::invalid_argument("Threads must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  const size_t batch = static_cast<size_t>(state.range(3));
+  const size_t threads = static_cast<size_t>(state.range(4));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = int(threads);
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  auto A = RandomVectorUniform(static_cast<size_t>(M * K * batch), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(N * K * (broadcast_b ? 1 : batch)), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(M * N * batch));
+
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(batch);
+  for (size_t i = 0; i < batch; i++) {
+    data[i].A = A.data() + M * K * i;
+    data[i].lda = K;
+    data[i].B = B.data() + (broadcast_b ? 0 : N * K * i);
+    data[i].ldb = N;
+    data[i].C = C.data() + M * N * i;
+    data[i].ldc = N;
+  }
+
+  MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, data.data(), batch, tp.get());
+
+  for (auto _ : state) {
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, data.data(), batch, tp.get());
+  }
+}
+
+static void GemmBatchSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sgemm_batch_bench_arg_names);
+  ArgsProduct(b, {{16, 64, 128}, {64}, {64}, {12, 96, 1024}, {1, 4, 8}});
+  ArgsProduct(b, {{64}, {16, 128}, {64}, {96, 1024}, {1, 8}});
+}
+
+BENCHMARK_CAPTURE(SGEMM_BATCH, DistinctB, false)->Apply(GemmBatchSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM_BATCH, BroadcastB, true)->Apply(GemmBatchSizeProducts)->UseRealTime();
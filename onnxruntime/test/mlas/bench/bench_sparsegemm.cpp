@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <random>
+#include <stdexcept>
+
+static const std::vector<std::string> sparsegemm_bench_arg_names = {"M", "N", "K", "Sparsity"};
+
+//
+// Matrix multiply with a sparse packed weight matrix B. "Sparsity" is the
+// percentage of zero blocks of matrix B; compare the time with SGEMM
+// PACKB_NoTransA for the same M, N and K.
+//
+
+void SPARSEGEMM(benchmark::State& state, size_t BlkN) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  const float Sparsity = static_cast<float>(state.range(3)) / 100.0f;
+
+  auto A = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(M * N));
+
+  std::default_random_engine generator(static_cast<unsigned>(N * K));
+  std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+  for (size_t k = 0; k < K; k++) {
+    for (size_t n = 0; n < N; n += BlkN) {
+      if (distribution(generator) < Sparsity) {
+        std::fill_n(B.data() + k * N + n, std::min(BlkN, N - n), 0.0f);
+      }
+    }
+  }
+
+  std::vector<float> PackedB(MlasGemmSparsePackBSize(CblasNoTrans, BlkN, N, K, B.data(), N) / sizeof(float) + 1);
+  MlasGemmSparsePackB(CblasNoTrans, BlkN, N, K, B.data(), N, PackedB.data());
+
+  MLAS_SGEMM_SPARSE_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = K;
+  data.PackedB = PackedB.data();
+  data.C = C.data();
+  data.ldc = N;
+
+  MlasGemmSparseBatch(M, N, K, &data, 1, nullptr);
+
+  for (auto _ : state) {
+    MlasGemmSparseBatch(M, N, K, &data, 1, nullptr);
+  }
+}
+
+static void SparseGemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sparsegemm_bench_arg_names);
+  ArgsProduct(b, {{1, 16, 128}, {1024, 4096}, {1024, 4096}, {0, 50, 80, 90}});
+}
+
+BENCHMARK_CAPTURE(SPARSEGEMM, 1x1, 1)->Apply(SparseGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SPARSEGEMM, 1x4, 4)->Apply(SparseGemmSizeProducts)->UseRealTime();
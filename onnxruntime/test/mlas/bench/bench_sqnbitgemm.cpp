@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> sqnbitgemm_bench_arg_names = {"M", "N", "K", "BlkLen"};
+
+//
+// Matrix multiply with a blockwise quantized weight matrix B. The "WeightBytes"
+// counter reports the size of matrix B read by each multiply; compare the time
+// with SGEMM PACKB_NoTransA for the same M, N and K.
+//
+
+void SQNBITGEMM(benchmark::State& state, size_t BlkBitWidth, bool with_zero_point) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  const size_t BlkLen = static_cast<size_t>(state.range(3));
+
+  if (!MlasIsSQNBitGemmAvailable(BlkBitWidth, BlkLen)) {
+    state.SkipWithError("Unsupported blockwise quantization parameters");
+    return;
+  }
+
+  auto A = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(M * N));
+
+  size_t quant_b_data_size;
+  size_t quant_b_scale_count;
+  size_t quant_b_zero_point_size;
+  MlasSQNBitGemmQuantBSizes(BlkBitWidth, BlkLen, N, K, &quant_b_data_size, &quant_b_scale_count,
+                            &quant_b_zero_point_size);
+
+  std::vector<uint8_t> quant_b_data(quant_b_data_size);
+  std::vector<float> quant_b_scale(quant_b_scale_count);
+  std::vector<uint8_t> quant_b_zero_point(with_zero_point ? quant_b_zero_point_size : 0);
+
+  MlasSQNBitGemmQuantizeB(BlkBitWidth, BlkLen, B.data(), N, N, K, quant_b_data.data(), quant_b_scale.data(),
+                          with_zero_point ? quant_b_zero_point.data() : nullptr);
+
+  MLAS_SQNBIT_GEMM_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = K;
+  data.QuantBData = quant_b_data.data();
+  data.QuantBScale = quant_b_scale.data();
+  data.QuantBZeroPoint = with_zero_point ? quant_b_zero_point.data() : nullptr;
+  data.C = C.data();
+  data.ldc = N;
+
+  MlasSQNBitGemmBatch(M, N, K, BlkBitWidth, BlkLen, &data, 1, nullptr);
+
+  for (auto _ : state) {
+    MlasSQNBitGemmBatch(M, N, K, BlkBitWidth, BlkLen, &data, 1, nullptr);
+  }
+
+  state.counters["WeightBytes"] = static_cast<double>(quant_b_data.size() + quant_b_scale.size() * sizeof(float) +
+                                                      quant_b_zero_point.size());
+}
+
+static void SQNBitGemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sqnbitgemm_bench_arg_names);
+  ArgsProduct(b, {{1, 16, 1023}, {1024, 4096}, {1024, 4096}, {32, 128}});
+}
+
+BENCHMARK_CAPTURE(SQNBITGEMM, 4Bit_Symmetric, 4, false)->Apply(SQNBitGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SQNBITGEMM, 4Bit_ZeroPoint, 4, true)->Apply(SQNBitGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SQNBITGEMM, 8Bit_Symmetric, 8, false)->Apply(SQNBitGemmSizeProducts)->UseRealTime();
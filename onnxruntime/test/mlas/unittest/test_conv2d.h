@@ -5,6 +5,8 @@
 
 #include "test_util.h"
 
+#include <cmath>
+
 template <bool Threaded>
 class MlasConv2DTest : public MlasTestBase {
  protected:
@@ -60,6 +62,8 @@ class MlasConv2DTest : public MlasTestBase {
                     0.0f,
                     threadpool_);
 
+    UsedWinograd = (Parameters.Algorithm == MlasConvAlgorithmWinograd);
+
     MlasConv(&Parameters,
              Input,
              Filter,
@@ -157,6 +161,9 @@ class MlasConv2DTest : public MlasTestBase {
 
   MLAS_THREADPOOL* threadpool_;
 
+  // Set by MlasConv2D if the Winograd algorithm was used, whose output is not bit exact.
+  bool UsedWinograd = false;
+
  public:
   static const char* GetTestSuiteName() {
     static const std::string suite_name(Threaded ? "Conv2d_Threaded" : "Conv2d_SingleThread");
@@ -215,6 +222,8 @@ class MlasConv2DTest : public MlasTestBase {
     float* Output = BufferOutput.GetBuffer(OutputElements);
     float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
 
+    UsedWinograd = false;
+
     MlasConv2D(BatchCount,
                GroupCount,
                InputChannels,
@@ -246,7 +255,27 @@ class MlasConv2DTest : public MlasTestBase {
                     Bias,
                     OutputReference);
 
-    ASSERT_EQ(memcmp(Output, OutputReference, OutputElements * sizeof(float)), 0)
+    bool OutputMatches;
+
+    if (UsedWinograd) {
+      //
+      // The Winograd transforms change the order of the operations, so compare
+      // with a tolerance relative to the magnitude of the output.
+      //
+
+      float MaximumReference = 1.0f;
+      for (size_t i = 0; i < OutputElements; i++) {
+        MaximumReference = std::max(MaximumReference, std::fabs(OutputReference[i]));
+      }
+
+      const float Tolerance = 1e-5f * MaximumReference;
+      OutputMatches = std::equal(Output, Output + OutputElements, OutputReference,
+                                 [Tolerance](float a, float b) { return std::fabs(a - b) <= Tolerance; });
+    } else {
+      OutputMatches = memcmp(Output, OutputReference, OutputElements * sizeof(float)) == 0;
+    }
+
+    ASSERT_TRUE(OutputMatches)
         << "B" << BatchCount << "/"
         << "G" << GroupCount << "/"
         << "Cpg" << InputChannels << "/"
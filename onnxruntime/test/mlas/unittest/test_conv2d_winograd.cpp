@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_conv2d.h"
+#include "test_conv2d_fixture.h"
+
+//
+// Runs the convolutions that are eligible for the Winograd algorithm with the
+// filter packed by MlasConvWinogradPackFilter, as done by the Conv kernel.
+//
+template <bool Threaded>
+class MlasWinogradConv2DTest : public MlasConv2DTest<Threaded> {
+ protected:
+  void MlasConv2D(size_t BatchCount,
+                  size_t GroupCount,
+                  size_t InputChannels,
+                  size_t InputHeight,
+                  size_t InputWidth,
+                  size_t FilterCount,
+                  size_t KernelHeight,
+                  size_t KernelWidth,
+                  size_t PaddingLeftHeight,
+                  size_t PaddingLeftWidth,
+                  size_t PaddingRightHeight,
+                  size_t PaddingRightWidth,
+                  size_t DilationHeight,
+                  size_t DilationWidth,
+                  size_t StrideHeight,
+                  size_t StrideWidth,
+                  size_t OutputHeight,
+                  size_t OutputWidth,
+                  const float* Input,
+                  const float* Filter,
+                  const float* Bias,
+                  float* Output) override {
+    int64_t InputShape[] = {int64_t(InputHeight), int64_t(InputWidth)};
+    int64_t KernelShape[] = {int64_t(KernelHeight), int64_t(KernelWidth)};
+    int64_t DilationShape[] = {int64_t(DilationHeight), int64_t(DilationWidth)};
+    int64_t Padding[] = {int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth)};
+    int64_t StrideShape[] = {int64_t(StrideHeight), int64_t(StrideWidth)};
+    int64_t OutputShape[] = {int64_t(OutputHeight), int64_t(OutputWidth)};
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters,
+                    2,
+                    BatchCount,
+                    GroupCount,
+                    InputChannels,
+                    InputShape,
+                    KernelShape,
+                    DilationShape,
+                    Padding,
+                    StrideShape,
+                    OutputShape,
+                    FilterCount,
+                    &Activation,
+                    &WorkingBufferSize,
+                    0.0f,
+                    this->threadpool_);
+
+    ASSERT_EQ(Parameters.Algorithm, MlasConvAlgorithmWinograd);
+    this->UsedWinograd = true;
+
+    const size_t OutputTileSize = Parameters.u.Winograd.OutputTileSize;
+    const size_t PackedFilterElements =
+        MlasConvWinogradPackFilterSize(OutputTileSize, GroupCount, FilterCount, InputChannels);
+    ASSERT_GT(PackedFilterElements, size_t(0));
+
+    float* PackedFilter = BufferPackedFilter.GetBuffer(PackedFilterElements);
+    MlasConvWinogradPackFilter(OutputTileSize, GroupCount, FilterCount, InputChannels, Filter, PackedFilter);
+
+    Parameters.u.Winograd.PackedFilter = PackedFilter;
+    WorkingBufferSize -= Parameters.u.Winograd.FilterBufferSize;
+
+    MlasConv(&Parameters,
+             Input,
+             Filter,
+             Bias,
+             this->BufferWorking.GetBuffer(WorkingBufferSize),
+             Output,
+             this->threadpool_);
+  }
+
+  MatrixGuardBuffer<float> BufferPackedFilter;
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "Conv2d_Winograd_Threaded" : "Conv2d_Winograd_SingleThread");
+    return suite_name.c_str();
+  }
+
+  static size_t RegisterShortExecuteTests() {
+    size_t test_registered = 0;
+    using Fixture = Conv2dShortExecuteTest<MlasWinogradConv2DTest<Threaded>>;
+
+    // F(2x2,3x3) is used for outputs smaller than 8x8 and F(4x4,3x3) otherwise.
+    for (unsigned i : {4, 6, 7, 8, 13, 16, 28}) {
+      test_registered += Fixture::RegisterSingleTest(1, 1, 32, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+      test_registered += Fixture::RegisterSingleTest(1, 1, 32, i + 2, i + 2, 48, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+    }
+
+    test_registered += Fixture::RegisterSingleTest(1, 1, 48, 17, 9, 40, 3, 3, 0, 1, 2, 0, 1, 1, 1, 1);
+    test_registered += Fixture::RegisterSingleTest(2, 1, 32, 14, 14, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    test_registered += Fixture::RegisterSingleTest(3, 2, 32, 21, 19, 48, 3, 3, 2, 1, 1, 2, 1, 1, 1, 1);
+    test_registered += Fixture::RegisterSingleTest(1, 1, 64, 56, 56, 64, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    test_registered += Fixture::RegisterSingleTest(1, 1, 256, 14, 14, 256, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    test_registered += Fixture::RegisterSingleTest(1, 1, 512, 7, 7, 512, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    return test_registered;
+  }
+};
+
+template <> MlasWinogradConv2DTest<false>* MlasTestFixture<MlasWinogradConv2DTest<false>>::mlas_tester(nullptr);
+template <> MlasWinogradConv2DTest<true>* MlasTestFixture<MlasWinogradConv2DTest<true>>::mlas_tester(nullptr);
+
+static size_t Conv2dWinogradRegistShortExecute() {
+  size_t count = MlasWinogradConv2DTest<false>::RegisterShortExecuteTests();
+  if (GetMlasThreadPool() != nullptr) {
+    count += MlasWinogradConv2DTest<true>::RegisterShortExecuteTests();
+  }
+  return count;
+}
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  // the long execute tests of the Conv2d suites cover the Winograd algorithm with unpacked filters
+  return is_short_execute ? Conv2dWinogradRegistShortExecute() : 0;
+});
@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferKeyBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t B, size_t N, size_t S, size_t PastS, size_t QkH, size_t VH, bool Causal, bool UseKeyBias) {
+    const size_t KvS = PastS + S;
+
+    MLAS_FLASH_ATTENTION_PARAMETERS Parameters;
+    Parameters.BatchCount = B;
+    Parameters.HeadCount = N;
+    Parameters.SequenceLength = S;
+    Parameters.KvSequenceLength = KvS;
+    Parameters.QkHeadSize = QkH;
+    Parameters.VHeadSize = VH;
+    Parameters.Scale = 1.0f / std::sqrt(float(QkH));
+    Parameters.Causal = Causal;
+
+    float* Query = BufferQuery.GetBuffer(B * N * S * QkH);
+    float* Key = BufferKey.GetBuffer(B * N * KvS * QkH);
+    float* Value = BufferValue.GetBuffer(B * N * KvS * VH);
+    float* KeyBias = BufferKeyBias.GetBuffer(B * KvS);
+    float* Output = BufferOutput.GetBuffer(B * S * N * VH);
+    float* OutputReference = BufferOutputReference.GetBuffer(B * S * N * VH);
+
+    std::default_random_engine generator(static_cast<unsigned>(B * N * S * KvS * QkH * VH));
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    for (size_t i = 0; i < B * N * S * QkH; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < B * N * KvS * QkH; i++) {
+      Key[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < B * N * KvS * VH; i++) {
+      Value[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < B * KvS; i++) {
+      // Mask roughly one in five keys the way the attention kernels do.
+      KeyBias[i] = (i % 5 == 3) ? -10000.0f : 0.0f;
+    }
+
+    Parameters.Query = Query;
+    Parameters.Key = Key;
+    Parameters.Value = Value;
+    Parameters.KeyBias = UseKeyBias ? KeyBias : nullptr;
+    Parameters.Output = Output;
+
+    MlasFlashAttention(&Parameters, threadpool_);
+    ReferenceAttention(&Parameters, OutputReference);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-4f;
+
+    for (size_t i = 0; i < B * S * N * VH; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << "B=" << B << " N=" << N << " S=" << S << " PastS=" << PastS << " QkH=" << QkH << " VH=" << VH
+          << " Causal=" << Causal << " KeyBias=" << UseKeyBias << " @" << i
+          << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+  void ReferenceAttention(const MLAS_FLASH_ATTENTION_PARAMETERS* Parameters, float* Output) {
+    const size_t N = Parameters->HeadCount;
+    const size_t S = Parameters->SequenceLength;
+    const size_t KvS = Parameters->KvSequenceLength;
+    const size_t QkH = Parameters->QkHeadSize;
+    const size_t VH = Parameters->VHeadSize;
+
+    std::vector<double> Scores(KvS);
+
+    for (size_t b = 0; b < Parameters->BatchCount; b++) {
+      for (size_t n = 0; n < N; n++) {
+        const float* q = Parameters->Query + (b * N + n) * S * QkH;
+        const float* k = Parameters->Key + (b * N + n) * KvS * QkH;
+        const float* v = Parameters->Value + (b * N + n) * KvS * VH;
+
+        for (size_t s = 0; s < S; s++) {
+          size_t KvLimit = Parameters->Causal ? (KvS - S + s + 1) : KvS;
+          double Maximum = std::numeric_limits<double>::lowest();
+
+          for (size_t j = 0; j < KvLimit; j++) {
+            double Sum = 0.0;
+            for (size_t h = 0; h < QkH; h++) {
+              Sum += double(q[s * QkH + h]) * double(k[j * QkH + h]);
+            }
+            Sum *= Parameters->Scale;
+            if (Parameters->KeyBias != nullptr) {
+              Sum += Parameters->KeyBias[b * KvS + j];
+            }
+            Scores[j] = Sum;
+            Maximum = std::max(Maximum, Sum);
+          }
+
+          double Denominator = 0.0;
+          for (size_t j = 0; j < KvLimit; j++) {
+            Scores[j] = std::exp(Scores[j] - Maximum);
+            Denominator += Scores[j];
+          }
+
+          float* o = Output + ((b * S + s) * N + n) * VH;
+          for (size_t h = 0; h < VH; h++) {
+            double Sum = 0.0;
+            for (size_t j = 0; j < KvLimit; j++) {
+              Sum += Scores[j] * double(v[j * VH + h]);
+            }
+            o[h] = float(Sum / Denominator);
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (bool Causal : {false, true}) {
+      for (bool UseKeyBias : {false, true}) {
+        Test(1, 1, 1, 0, 8, 8, Causal, UseKeyBias);
+        Test(1, 2, 7, 0, 16, 16, Causal, UseKeyBias);
+        Test(2, 3, 33, 0, 32, 24, Causal, UseKeyBias);
+        Test(1, 4, 1, 200, 64, 64, Causal, UseKeyBias);
+        Test(2, 2, 5, 130, 40, 40, Causal, UseKeyBias);
+        Test(1, 2, 150, 0, 64, 64, Causal, UseKeyBias);
+        Test(1, 1, 64, 300, 16, 48, Causal, UseKeyBias);
+      }
+    }
+  }
+};
+
+template <> MlasFlashAttentionTest<false>* MlasTestFixture<MlasFlashAttentionTest<false>>::mlas_tester(nullptr);
+template <> MlasFlashAttentionTest<true>* MlasTestFixture<MlasFlashAttentionTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
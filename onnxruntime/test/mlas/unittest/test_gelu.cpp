@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasBiasActivationTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+
+  static float ReferenceActivation(const MLAS_ACTIVATION& Activation, float Value) {
+    double x = Value;
+    switch (Activation.ActivationKind) {
+      case MlasGeluErfActivation:
+        return float(0.5 * x * (1.0 + std::erf(x * M_SQRT1_2)));
+      case MlasGeluTanhActivation:
+        return float(0.5 * x * (1.0 + std::tanh(0.7978845608028654 * (x + 0.044715 * x * x * x))));
+      case MlasSwishActivation:
+        return float(x / (1.0 + std::exp(-double(Activation.Parameters.Swish.alpha) * x)));
+      case MlasReluActivation:
+        return std::max(Value, 0.0f);
+      default:
+        return Value;
+    }
+  }
+
+  static void CheckOutput(const MLAS_ACTIVATION& Activation, const float* Output, const float* OutputReference,
+                          size_t Count, const char* Context) {
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-5f;
+
+    for (size_t i = 0; i < Count; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << Context << " kind:" << int(Activation.ActivationKind) << " i:" << i
+          << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+  void TestBiasActivation(const MLAS_ACTIVATION& Activation, size_t M, size_t N, bool UseBias,
+                          float MinimumValue, float MaximumValue) {
+    float* Input = BufferInput.GetBuffer(M * N);
+    float* Bias = BufferBias.GetBuffer(N);
+    float* Output = BufferOutput.GetBuffer(M * N);
+    float* OutputReference = BufferOutputReference.GetBuffer(M * N);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N));
+    std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+    for (size_t i = 0; i < M * N; i++) {
+      Input[i] = distribution(generator);
+    }
+
+    for (size_t n = 0; n < N; n++) {
+      Bias[n] = distribution(generator) * 0.25f;
+    }
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float Value = Input[m * N + n] + (UseBias ? Bias[n] : 0.0f);
+        OutputReference[m * N + n] = ReferenceActivation(Activation, Value);
+      }
+    }
+
+    MlasComputeBiasActivation(&Activation, Input, UseBias ? Bias : nullptr, Output, M, N);
+    CheckOutput(Activation, Output, OutputReference, M * N, "MlasComputeBiasActivation");
+
+    //
+    // Test the in place form.
+    //
+
+    std::copy_n(Input, M * N, Output);
+    MlasComputeBiasActivation(&Activation, Output, UseBias ? Bias : nullptr, Output, M, N);
+    CheckOutput(Activation, Output, OutputReference, M * N, "MlasComputeBiasActivation in place");
+  }
+
+  void TestActivationStrided(const MLAS_ACTIVATION& Activation, size_t M, size_t N, size_t ldc) {
+    float* Buffer = BufferOutput.GetBuffer(M * ldc);
+    float* Bias = BufferBias.GetBuffer(M);
+    float* OutputReference = BufferOutputReference.GetBuffer(M * ldc);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * ldc));
+    std::uniform_real_distribution<float> distribution(-6.0f, 6.0f);
+
+    for (size_t i = 0; i < M * ldc; i++) {
+      Buffer[i] = distribution(generator);
+    }
+
+    for (size_t m = 0; m < M; m++) {
+      Bias[m] = distribution(generator);
+    }
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < ldc; n++) {
+        float Value = Buffer[m * ldc + n];
+        OutputReference[m * ldc + n] = (n < N) ? ReferenceActivation(Activation, Value + Bias[m]) : Value;
+      }
+    }
+
+    MlasActivation(&Activation, Buffer, Bias, M, N, ldc);
+    CheckOutput(Activation, Buffer, OutputReference, M * ldc, "MlasActivation");
+  }
+
+  void TestGemmActivation(const MLAS_ACTIVATION& Activation, size_t M, size_t N, size_t K) {
+    float* A = BufferInput.GetBuffer(M * K);
+    float* B = BufferBias.GetBuffer(K * N);
+    float* C = BufferOutput.GetBuffer(M * N);
+    float* CReference = BufferOutputReference.GetBuffer(M * N);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < M * K; i++) {
+      A[i] = distribution(generator);
+    }
+
+    for (size_t i = 0; i < K * N; i++) {
+      B[i] = distribution(generator);
+    }
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = K;
+    Data.B = B;
+    Data.ldb = N;
+    Data.C = CReference;
+    Data.ldc = N;
+
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, Data, GetMlasThreadPool());
+
+    for (size_t i = 0; i < M * N; i++) {
+      CReference[i] = ReferenceActivation(Activation, CReference[i]);
+    }
+
+    Data.C = C;
+    Data.Activation = &Activation;
+
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, Data, GetMlasThreadPool());
+    CheckOutput(Activation, C, CReference, M * N, "MlasGemm");
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("BiasActivation");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    MLAS_ACTIVATION Activations[5];
+
+    Activations[0].ActivationKind = MlasGeluErfActivation;
+    Activations[1].ActivationKind = MlasGeluTanhActivation;
+    Activations[2].ActivationKind = MlasSwishActivation;
+    Activations[2].Parameters.Swish.alpha = 1.0f;
+    Activations[3].ActivationKind = MlasSwishActivation;
+    Activations[3].Parameters.Swish.alpha = 1.702f;
+    Activations[4].ActivationKind = MlasReluActivation;
+
+    for (const MLAS_ACTIVATION& Activation : Activations) {
+      for (size_t n = 1; n < 40; n++) {
+        TestBiasActivation(Activation, 1, n, true, -6.0f, 6.0f);
+        TestBiasActivation(Activation, 1, n, false, -6.0f, 6.0f);
+      }
+
+      TestBiasActivation(Activation, 7, 77, true, -100.0f, 100.0f);
+      TestBiasActivation(Activation, 16, 768, true, -10.0f, 10.0f);
+      TestBiasActivation(Activation, 3, 3072, false, -3.0f, 3.0f);
+
+      TestActivationStrided(Activation, 5, 19, 19);
+      TestActivationStrided(Activation, 9, 33, 40);
+
+      TestGemmActivation(Activation, 1, 63, 17);
+      TestGemmActivation(Activation, 37, 129, 64);
+      TestGemmActivation(Activation, 128, 256, 32);
+    }
+  }
+};
+
+template <>
+MlasBiasActivationTest* MlasTestFixture<MlasBiasActivationTest>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasBiasActivationTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasHalfConvertTest : public MlasTestBase {
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("HalfConvert");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    //
+    // Every half precision value converts to single precision and back to
+    // itself. NaNs are only required to stay NaNs.
+    //
+
+    std::vector<MLAS_FP16> Half(65536);
+    std::vector<float> Float(65536);
+    std::vector<MLAS_FP16> RoundTrip(65536);
+
+    for (size_t i = 0; i < Half.size(); i++) {
+      Half[i] = static_cast<MLAS_FP16>(i);
+    }
+
+    MlasConvertHalfToFloatBuffer(Half.data(), Float.data(), Half.size());
+    MlasConvertFloatToHalfBuffer(Float.data(), RoundTrip.data(), Float.size());
+
+    for (size_t i = 0; i < Half.size(); i++) {
+      const bool IsNaN = (i & 0x7C00) == 0x7C00 && (i & 0x3FF) != 0;
+      if (IsNaN) {
+        ASSERT_TRUE(std::isnan(Float[i])) << "half 0x" << std::hex << i;
+        ASSERT_TRUE((RoundTrip[i] & 0x7C00) == 0x7C00 && (RoundTrip[i] & 0x3FF) != 0) << "half 0x" << std::hex << i;
+      } else {
+        ASSERT_EQ(RoundTrip[i], Half[i]) << "half 0x" << std::hex << i << " float " << Float[i];
+      }
+    }
+
+    ASSERT_EQ(Float[0x3C00], 1.0f);
+    ASSERT_EQ(Float[0xC000], -2.0f);
+    ASSERT_EQ(Float[0x7BFF], 65504.0f);
+    ASSERT_EQ(Float[0x0001], std::ldexp(1.0f, -24));
+
+    //
+    // Values between half precision values round to nearest even, and values
+    // past the largest half precision value overflow to infinity.
+    //
+
+    const float Values[] = {1.0f + std::ldexp(1.0f, -11), 1.0f + 3 * std::ldexp(1.0f, -11),
+                            65519.0f, 65520.0f, 1e10f, -1e10f, std::ldexp(1.0f, -25), std::ldexp(3.0f, -25)};
+    const MLAS_FP16 Expected[] = {0x3C00, 0x3C02, 0x7BFF, 0x7C00, 0x7C00, 0xFC00, 0x0000, 0x0002};
+    const size_t Count = sizeof(Values) / sizeof(Values[0]);
+
+    // Convert a buffer long enough to exercise the vector paths.
+    std::vector<float> Source(Count * 5);
+    std::vector<MLAS_FP16> Destination(Source.size());
+
+    for (size_t i = 0; i < Source.size(); i++) {
+      Source[i] = Values[i % Count];
+    }
+
+    MlasConvertFloatToHalfBuffer(Source.data(), Destination.data(), Source.size());
+
+    for (size_t i = 0; i < Source.size(); i++) {
+      ASSERT_EQ(Destination[i], Expected[i % Count]) << "value " << Source[i];
+    }
+  }
+};
+
+template <bool Packed, bool Threaded>
+class MlasHalfGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<MLAS_FP16> BufferA;
+  MatrixGuardBuffer<MLAS_FP16> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<MLAS_FP16> BufferC;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t M, size_t N, size_t K, CBLAS_TRANSPOSE TransB, float alpha, float beta) {
+    const size_t lda = K + 1;
+    const size_t ldb = (TransB == CblasNoTrans ? N : K) + 3;
+    const size_t ldc = N + 2;
+
+    MLAS_FP16* A = BufferA.GetBuffer(M * lda);
+    MLAS_FP16* B = BufferB.GetBuffer((TransB == CblasNoTrans ? K : N) * ldb);
+    MLAS_FP16* C = BufferC.GetBuffer(M * ldc);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K + TransB));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    std::vector<float> FloatA(M * lda);
+    std::vector<float> FloatB((TransB == CblasNoTrans ? K : N) * ldb);
+    std::vector<float> FloatC(M * ldc);
+
+    for (auto& v : FloatA) v = distribution(generator);
+    for (auto& v : FloatB) v = distribution(generator);
+    for (auto& v : FloatC) v = distribution(generator);
+
+    MlasConvertFloatToHalfBuffer(FloatA.data(), A, FloatA.size());
+    MlasConvertFloatToHalfBuffer(FloatB.data(), B, FloatB.size());
+    MlasConvertFloatToHalfBuffer(FloatC.data(), C, FloatC.size());
+    MlasConvertHalfToFloatBuffer(A, FloatA.data(), FloatA.size());
+    MlasConvertHalfToFloatBuffer(B, FloatB.data(), FloatB.size());
+    MlasConvertHalfToFloatBuffer(C, FloatC.data(), FloatC.size());
+
+    MLAS_HALF_GEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.C = C;
+    Data.ldc = ldc;
+    Data.alpha = alpha;
+    Data.beta = beta;
+
+    if (Packed) {
+      void* PackedB = BufferBPacked.GetBuffer(MlasHalfGemmPackBSize(N, K), true);
+      MlasHalfGemmPackB(TransB, N, K, B, ldb, PackedB);
+      Data.B = PackedB;
+      Data.BIsPacked = true;
+    } else {
+      Data.B = B;
+      Data.ldb = ldb;
+    }
+
+    MlasHalfGemm(TransB, M, N, K, Data, threadpool_);
+
+    std::vector<float> Result(M * ldc);
+    MlasConvertHalfToFloatBuffer(C, Result.data(), Result.size());
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double Sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          double b = (TransB == CblasNoTrans) ? FloatB[k * ldb + n] : FloatB[n * ldb + k];
+          Sum += double(FloatA[m * lda + k]) * b;
+        }
+        const double Expected = alpha * Sum + beta * double(FloatC[m * ldc + n]);
+        const float Actual = Result[m * ldc + n];
+
+        // The result is rounded once to half precision; allow for the single
+        // precision accumulation error on top of that.
+        const double Tolerance = std::fabs(Expected) * 1e-3 + 1e-5 * K + 1e-3;
+
+        ASSERT_NEAR(Actual, Expected, Tolerance)
+            << "M=" << M << " N=" << N << " K=" << K << " TransB=" << (TransB != CblasNoTrans)
+            << " alpha=" << alpha << " beta=" << beta << " @[" << m << "," << n << "]";
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("HalfGemm") + (Packed ? "_Packed" : "_NoPack") +
+                                        (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  MlasHalfGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (CBLAS_TRANSPOSE TransB : {CblasNoTrans, CblasTrans}) {
+      Test(1, 1, 1, TransB, 1.0f, 0.0f);
+      Test(1, 17, 3, TransB, 1.0f, 0.0f);
+      Test(5, 16, 31, TransB, 0.5f, 1.0f);
+      Test(33, 65, 17, TransB, 1.0f, 0.0f);
+      Test(1, 300, 511, TransB, 1.0f, 0.0f);
+      Test(64, 100, 257, TransB, 1.0f, -0.5f);
+      Test(77, 129, 600, TransB, 2.0f, 0.0f);
+      Test(3, 5, 0, TransB, 1.0f, 0.5f);
+    }
+  }
+};
+
+template <> MlasHalfConvertTest* MlasTestFixture<MlasHalfConvertTest>::mlas_tester(nullptr);
+template <> MlasHalfGemmTest<false, false>* MlasTestFixture<MlasHalfGemmTest<false, false>>::mlas_tester(nullptr);
+template <> MlasHalfGemmTest<false, true>* MlasTestFixture<MlasHalfGemmTest<false, true>>::mlas_tester(nullptr);
+template <> MlasHalfGemmTest<true, false>* MlasTestFixture<MlasHalfGemmTest<true, false>>::mlas_tester(nullptr);
+template <> MlasHalfGemmTest<true, true>* MlasTestFixture<MlasHalfGemmTest<true, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasHalfConvertTest>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasHalfGemmTest<false, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasHalfGemmTest<true, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasHalfGemmTest<false, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasHalfGemmTest<true, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSkip;
+  MatrixGuardBuffer<float> BufferSkipBias;
+  MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferMean;
+  MatrixGuardBuffer<float> BufferInvStdDev;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t N, size_t D, float MinimumValue, float MaximumValue) {
+    float* Input = BufferInput.GetBuffer(N * D);
+    float* Skip = BufferSkip.GetBuffer(N * D);
+    float* SkipBias = BufferSkipBias.GetBuffer(D);
+    float* Scale = BufferScale.GetBuffer(D);
+    float* Bias = BufferBias.GetBuffer(D);
+
+    std::default_random_engine generator(static_cast<unsigned>(N * D));
+    std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+    std::uniform_real_distribution<float> parameter_distribution(-2.0f, 2.0f);
+
+    for (size_t nd = 0; nd < N * D; nd++) {
+      Input[nd] = distribution(generator);
+      Skip[nd] = parameter_distribution(generator);
+    }
+
+    for (size_t d = 0; d < D; d++) {
+      SkipBias[d] = parameter_distribution(generator);
+      Scale[d] = parameter_distribution(generator);
+      Bias[d] = parameter_distribution(generator);
+    }
+
+    Test(Input, nullptr, nullptr, Scale, Bias, N, D, false);
+    Test(Input, nullptr, nullptr, Scale, nullptr, N, D, false);
+    Test(Input, nullptr, nullptr, Scale, nullptr, N, D, true);
+    Test(Input, Skip, nullptr, Scale, Bias, N, D, false);
+    Test(Input, Skip, SkipBias, Scale, Bias, N, D, false);
+    Test(Input, Skip, SkipBias, Scale, nullptr, N, D, false);
+  }
+
+  void Test(const float* Input, const float* Skip, const float* SkipBias, const float* Scale,
+            const float* Bias, size_t N, size_t D, bool Simplified) {
+    constexpr float Epsilon = 1e-5f;
+
+    float* Output = BufferOutput.GetBuffer(N * D);
+    float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+    float* Mean = BufferMean.GetBuffer(N);
+    float* InvStdDev = BufferInvStdDev.GetBuffer(N);
+
+    std::vector<float> MeanReference(N);
+    std::vector<float> InvStdDevReference(N);
+
+    if (Skip != nullptr) {
+      MlasSkipLayerNorm(Input, Skip, SkipBias, Scale, Bias, Output, N, D, Epsilon, threadpool_);
+    } else {
+      MlasLayerNorm(Input, Scale, Bias, Output, Mean, InvStdDev, N, D, Epsilon, Simplified, threadpool_);
+    }
+
+    ReferenceLayerNorm(Input, Skip, SkipBias, Scale, Bias, OutputReference, MeanReference.data(),
+                       InvStdDevReference.data(), N, D, Epsilon, Simplified);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-5f;
+
+    for (size_t nd = 0; nd < N * D; nd++) {
+      float diff = std::fabs(Output[nd] - OutputReference[nd]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[nd]) * RelativeTolerance)
+          << "Skip:" << (Skip != nullptr) << " SkipBias:" << (SkipBias != nullptr) << " Bias:" << (Bias != nullptr)
+          << " Simplified:" << Simplified << " difference " << N << "/" << D
+          << ", got: " << Output[nd] << ", expecting: " << OutputReference[nd];
+    }
+
+    if (Skip == nullptr) {
+      for (size_t n = 0; n < N; n++) {
+        ASSERT_NEAR(Mean[n], MeanReference[n], AbsoluteTolerance + std::fabs(MeanReference[n]) * RelativeTolerance)
+            << "mean " << N << "/" << D << " row " << n;
+        ASSERT_NEAR(InvStdDev[n], InvStdDevReference[n], InvStdDevReference[n] * 1e-4f)
+            << "inverse standard deviation " << N << "/" << D << " row " << n;
+      }
+    }
+  }
+
+  void ReferenceLayerNorm(const float* Input, const float* Skip, const float* SkipBias, const float* Scale,
+                          const float* Bias, float* Output, float* Mean, float* InvStdDev,
+                          size_t N, size_t D, float Epsilon, bool Simplified) {
+    std::vector<double> Row(D);
+
+    for (size_t n = 0; n < N; n++) {
+      double Sum = 0.0;
+
+      for (size_t d = 0; d < D; d++) {
+        double Value = Input[n * D + d];
+        if (Skip != nullptr) {
+          Value += Skip[n * D + d];
+        }
+        if (SkipBias != nullptr) {
+          Value += SkipBias[d];
+        }
+        Row[d] = Value;
+        Sum += Value;
+      }
+
+      double RowMean = Simplified ? 0.0 : Sum / D;
+      double Variance = 0.0;
+
+      for (size_t d = 0; d < D; d++) {
+        Variance += (Row[d] - RowMean) * (Row[d] - RowMean);
+      }
+
+      double RowInvStdDev = 1.0 / std::sqrt(Variance / D + Epsilon);
+
+      for (size_t d = 0; d < D; d++) {
+        double Value = (Row[d] - RowMean) * RowInvStdDev * Scale[d];
+        if (Bias != nullptr) {
+          Value += Bias[d];
+        }
+        Output[n * D + d] = float(Value);
+      }
+
+      Mean[n] = float(RowMean);
+      InvStdDev[n] = float(RowInvStdDev);
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "LayerNorm_Threaded" : "LayerNorm_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasLayerNormTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (size_t d = 1; d < 72; d++) {
+      Test(1, d, -10.f, 10.f);
+    }
+
+    Test(3, 128, 20.f, 30.f);
+    Test(63, 95, -150.f, 190.f);
+    Test(16, 768, -1.f, 1.f);
+    Test(128, 1024, -5.f, 5.f);
+  }
+};
+
+template <> MlasLayerNormTest<false>* MlasTestFixture<MlasLayerNormTest<false>>::mlas_tester(nullptr);
+template <> MlasLayerNormTest<true>* MlasTestFixture<MlasLayerNormTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasLayerNormTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
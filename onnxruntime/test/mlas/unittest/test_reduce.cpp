@@ -0,0 +1,249 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Reductions of rows and columns, checked against scalar loops. Sums are
+// compared with a tolerance, the maximum, minimum and arg reductions exactly,
+// including the handling of NaN and of ties. The threaded variants are also
+// checked to match the single threaded results bit for bit.
+//
+
+template <bool Threaded>
+class MlasReduceTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputSingleThread;
+  MatrixGuardBuffer<int64_t> BufferIndices;
+  MatrixGuardBuffer<int64_t> BufferIndicesSingleThread;
+  MLAS_THREADPOOL* threadpool_;
+
+  static bool SameValue(float a, float b) {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+  }
+
+  static bool Select(MLAS_REDUCE_KIND Kind, bool SelectLastIndex, float Value, float Best) {
+    if (Kind == MlasReduceMaximum) {
+      return SelectLastIndex ? Value >= Best : Value > Best;
+    } else {
+      return SelectLastIndex ? Value <= Best : Value < Best;
+    }
+  }
+
+  //
+  // Fills the input with small integers, so that the arg reductions see ties,
+  // and with an occasional NaN.
+  //
+
+  float* FillInput(size_t Count, bool WithNaN) {
+    float* Input = BufferInput.GetBuffer(Count);
+
+    std::default_random_engine generator(static_cast<unsigned>(Count));
+    std::uniform_int_distribution<int> distribution(-50, 50);
+
+    for (size_t i = 0; i < Count; i++) {
+      Input[i] = static_cast<float>(distribution(generator)) * 0.25f;
+    }
+
+    if (WithNaN) {
+      for (size_t i = 0; i < Count; i += 37) {
+        Input[i] = std::numeric_limits<float>::quiet_NaN();
+      }
+    }
+
+    return Input;
+  }
+
+  void TestRows(MLAS_REDUCE_KIND Kind, size_t Rows, size_t RowLength, bool WithNaN) {
+    const float* Input = FillInput(Rows * RowLength, WithNaN);
+    float* Output = BufferOutput.GetBuffer(Rows);
+
+    MlasReduceRows(Kind, Input, Output, Rows, RowLength, threadpool_);
+
+    for (size_t r = 0; r < Rows; r++) {
+      const float* row = Input + r * RowLength;
+
+      if (Kind == MlasReduceSum) {
+        double Sum = 0.0;
+        double Magnitude = 0.0;
+        for (size_t i = 0; i < RowLength; i++) {
+          Sum += row[i];
+          Magnitude += std::fabs(row[i]);
+        }
+        ASSERT_NEAR(Output[r], Sum, Magnitude * 1e-6 + 1e-6)
+            << "Rows=" << Rows << " RowLength=" << RowLength << " @" << r;
+      } else {
+        float Best = row[0];
+        for (size_t i = 1; i < RowLength; i++) {
+          if (Select(Kind, false, row[i], Best)) {
+            Best = row[i];
+          }
+        }
+        ASSERT_TRUE(SameValue(Output[r], Best))
+            << "Kind=" << Kind << " Rows=" << Rows << " RowLength=" << RowLength << " @" << r
+            << " got " << Output[r] << " expected " << Best;
+      }
+    }
+
+    if (Threaded) {
+      float* OutputSingleThread = BufferOutputSingleThread.GetBuffer(Rows);
+      MlasReduceRows(Kind, Input, OutputSingleThread, Rows, RowLength, nullptr);
+      ASSERT_EQ(memcmp(Output, OutputSingleThread, Rows * sizeof(float)), 0)
+          << "Kind=" << Kind << " Rows=" << Rows << " RowLength=" << RowLength;
+    }
+  }
+
+  void TestColumns(MLAS_REDUCE_KIND Kind, size_t Batch, size_t Rows, size_t Columns, bool WithNaN) {
+    const float* Input = FillInput(Batch * Rows * Columns, WithNaN);
+    float* Output = BufferOutput.GetBuffer(Batch * Columns);
+
+    MlasReduceColumns(Kind, Input, Output, Batch, Rows, Columns, threadpool_);
+
+    for (size_t b = 0; b < Batch; b++) {
+      for (size_t c = 0; c < Columns; c++) {
+        const float* column = Input + b * Rows * Columns + c;
+        const float Value = Output[b * Columns + c];
+
+        if (Kind == MlasReduceSum) {
+          double Sum = 0.0;
+          double Magnitude = 0.0;
+          for (size_t r = 0; r < Rows; r++) {
+            Sum += column[r * Columns];
+            Magnitude += std::fabs(column[r * Columns]);
+          }
+          ASSERT_NEAR(Value, Sum, Magnitude * 1e-6 + 1e-6)
+              << "Batch=" << Batch << " Rows=" << Rows << " Columns=" << Columns << " @" << b << "," << c;
+        } else {
+          float Best = column[0];
+          for (size_t r = 1; r < Rows; r++) {
+            if (Select(Kind, false, column[r * Columns], Best)) {
+              Best = column[r * Columns];
+            }
+          }
+          ASSERT_TRUE(SameValue(Value, Best))
+              << "Kind=" << Kind << " Batch=" << Batch << " Rows=" << Rows << " Columns=" << Columns
+              << " @" << b << "," << c << " got " << Value << " expected " << Best;
+        }
+      }
+    }
+
+    if (Threaded) {
+      float* OutputSingleThread = BufferOutputSingleThread.GetBuffer(Batch * Columns);
+      MlasReduceColumns(Kind, Input, OutputSingleThread, Batch, Rows, Columns, nullptr);
+      ASSERT_EQ(memcmp(Output, OutputSingleThread, Batch * Columns * sizeof(float)), 0)
+          << "Kind=" << Kind << " Batch=" << Batch << " Rows=" << Rows << " Columns=" << Columns;
+    }
+  }
+
+  void TestArgRows(MLAS_REDUCE_KIND Kind, bool SelectLastIndex, size_t Rows, size_t RowLength, bool WithNaN) {
+    const float* Input = FillInput(Rows * RowLength, WithNaN);
+    int64_t* Indices = BufferIndices.GetBuffer(Rows);
+
+    MlasArgReduceRows(Kind, SelectLastIndex, Input, Indices, Rows, RowLength, threadpool_);
+
+    for (size_t r = 0; r < Rows; r++) {
+      const float* row = Input + r * RowLength;
+      float Best = row[0];
+      int64_t BestIndex = 0;
+      for (size_t i = 1; i < RowLength; i++) {
+        if (Select(Kind, SelectLastIndex, row[i], Best)) {
+          Best = row[i];
+          BestIndex = static_cast<int64_t>(i);
+        }
+      }
+      ASSERT_EQ(Indices[r], BestIndex)
+          << "Kind=" << Kind << " SelectLastIndex=" << SelectLastIndex << " Rows=" << Rows
+          << " RowLength=" << RowLength << " @" << r;
+    }
+  }
+
+  void TestArgColumns(MLAS_REDUCE_KIND Kind, bool SelectLastIndex, size_t Batch, size_t Rows, size_t Columns,
+                      bool WithNaN) {
+    const float* Input = FillInput(Batch * Rows * Columns, WithNaN);
+    int64_t* Indices = BufferIndices.GetBuffer(Batch * Columns);
+
+    MlasArgReduceColumns(Kind, SelectLastIndex, Input, Indices, Batch, Rows, Columns, threadpool_);
+
+    for (size_t b = 0; b < Batch; b++) {
+      for (size_t c = 0; c < Columns; c++) {
+        const float* column = Input + b * Rows * Columns + c;
+        float Best = column[0];
+        int64_t BestIndex = 0;
+        for (size_t r = 1; r < Rows; r++) {
+          if (Select(Kind, SelectLastIndex, column[r * Columns], Best)) {
+            Best = column[r * Columns];
+            BestIndex = static_cast<int64_t>(r);
+          }
+        }
+        ASSERT_EQ(Indices[b * Columns + c], BestIndex)
+            << "Kind=" << Kind << " SelectLastIndex=" << SelectLastIndex << " Batch=" << Batch
+            << " Rows=" << Rows << " Columns=" << Columns << " @" << b << "," << c;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("Reduce") + (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  MlasReduceTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    static const size_t RowShapes[][2] = {
+        {1, 1}, {3, 7}, {5, 100}, {64, 33}, {2, 20000}, {1, 300000}, {7, 70000}, {300, 1000}};
+
+    static const size_t ColumnShapes[][3] = {
+        {1, 1, 1}, {1, 5, 3}, {2, 17, 33}, {3, 300, 130}, {1, 3000, 4},
+        {1, 100000, 2}, {4, 600, 257}, {1, 70000, 20}, {64, 20, 7}};
+
+    for (bool WithNaN : {false, true}) {
+      for (MLAS_REDUCE_KIND Kind : {MlasReduceSum, MlasReduceMaximum, MlasReduceMinimum}) {
+        if (WithNaN && Kind == MlasReduceSum) {
+          continue;
+        }
+
+        for (const auto& Shape : RowShapes) {
+          TestRows(Kind, Shape[0], Shape[1], WithNaN);
+        }
+
+        for (const auto& Shape : ColumnShapes) {
+          TestColumns(Kind, Shape[0], Shape[1], Shape[2], WithNaN);
+        }
+
+        if (Kind == MlasReduceSum) {
+          continue;
+        }
+
+        for (bool SelectLastIndex : {false, true}) {
+          for (const auto& Shape : RowShapes) {
+            TestArgRows(Kind, SelectLastIndex, Shape[0], Shape[1], WithNaN);
+          }
+
+          for (const auto& Shape : ColumnShapes) {
+            TestArgColumns(Kind, SelectLastIndex, Shape[0], Shape[1], Shape[2], WithNaN);
+          }
+        }
+      }
+    }
+  }
+};
+
+template <>
+MlasReduceTest<false>* MlasTestFixture<MlasReduceTest<false>>::mlas_tester(nullptr);
+template <>
+MlasReduceTest<true>* MlasTestFixture<MlasReduceTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasReduceTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasReduceTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Batches of small operations, where matrix B is shared by all the operations
+// (broadcast) or by some of them, checked against the operations run one at a
+// time.
+//
+
+template <bool Threaded>
+class MlasSgemmBatchTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K, size_t BatchSize,
+            size_t DistinctB, float alpha, float beta, const MLAS_ACTIVATION* Activation) {
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+    const size_t ldc = N + 1;
+
+    const float* A = BufferA.GetBuffer(M * K * BatchSize);
+    const float* B = BufferB.GetBuffer(K * N * DistinctB);
+    float* C = BufferC.GetBuffer(M * ldc * BatchSize);
+    float* CReference = BufferCReference.GetBuffer(M * ldc * BatchSize);
+
+    std::fill_n(C, M * ldc * BatchSize, 0.25f);
+    std::fill_n(CReference, M * ldc * BatchSize, 0.25f);
+
+    std::vector<MLAS_SGEMM_DATA_PARAMS> Data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].A = A + i * M * K;
+      Data[i].lda = lda;
+      Data[i].B = B + (i % DistinctB) * K * N;
+      Data[i].ldb = ldb;
+      Data[i].C = CReference + i * M * ldc;
+      Data[i].ldc = ldc;
+      Data[i].alpha = alpha;
+      Data[i].beta = beta;
+      Data[i].Activation = Activation;
+
+      MlasGemm(TransA, TransB, M, N, K, Data[i], nullptr);
+
+      Data[i].C = C + i * M * ldc;
+    }
+
+    MlasGemmBatch(TransA, TransB, M, N, K, Data.data(), BatchSize, threadpool_);
+
+    for (size_t i = 0; i < M * ldc * BatchSize; i++) {
+      ASSERT_NEAR(C[i], CReference[i], std::fabs(CReference[i]) * 1e-6f + 1e-6f)
+          << "M=" << M << " N=" << N << " K=" << K << " BatchSize=" << BatchSize << " DistinctB=" << DistinctB
+          << " TransA=" << (TransA == CblasTrans) << " TransB=" << (TransB == CblasTrans) << " @" << i;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("SgemmBatch") + (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  MlasSgemmBatchTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    MLAS_ACTIVATION Relu;
+    Relu.ActivationKind = MlasReluActivation;
+
+    for (CBLAS_TRANSPOSE TransA : {CblasNoTrans, CblasTrans}) {
+      for (CBLAS_TRANSPOSE TransB : {CblasNoTrans, CblasTrans}) {
+        for (size_t DistinctB : {1, 2, 64}) {
+          Test(TransA, TransB, 64, 64, 64, 64, DistinctB, 1.0f, 0.0f, nullptr);
+          Test(TransA, TransB, 1, 64, 64, 64, DistinctB, 1.0f, 0.0f, nullptr);
+          Test(TransA, TransB, 7, 17, 33, 64, DistinctB, 0.5f, 1.0f, nullptr);
+          Test(TransA, TransB, 16, 100, 130, 64, DistinctB, 1.0f, 0.5f, &Relu);
+          Test(TransA, TransB, 12, 256, 80, 64, DistinctB, 1.0f, 0.0f, nullptr);
+          Test(TransA, TransB, 5, 16, 700, 64, DistinctB, 1.0f, 0.0f, nullptr);
+          Test(TransA, TransB, 3, 300, 100, 64, DistinctB, 1.0f, 0.0f, nullptr);
+          Test(TransA, TransB, 8, 8, 0, 64, DistinctB, 1.0f, 0.5f, nullptr);
+        }
+        Test(TransA, TransB, 32, 32, 32, 3, 1, 1.0f, 0.0f, nullptr);
+      }
+    }
+  }
+};
+
+template <>
+MlasSgemmBatchTest<false>* MlasTestFixture<MlasSgemmBatchTest<false>>::mlas_tester(nullptr);
+template <>
+MlasSgemmBatchTest<true>* MlasTestFixture<MlasSgemmBatchTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmBatchTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmBatchTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
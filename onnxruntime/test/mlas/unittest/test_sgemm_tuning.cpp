@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasSgemmTuningTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+
+  void Test(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K,
+            const MLAS_SGEMM_TUNING_PARAMS& Tuning) {
+    const size_t lda = (TransA == CblasNoTrans) ? K + 1 : M + 1;
+    const size_t ldb = (TransB == CblasNoTrans) ? N + 2 : K + 2;
+    const size_t ldc = N + 3;
+
+    const float* A = BufferA.GetBuffer(((TransA == CblasNoTrans) ? M : K) * lda);
+    const float* B = BufferB.GetBuffer(((TransB == CblasNoTrans) ? K : N) * ldb);
+    float* C = BufferC.GetBuffer(M * ldc);
+    float* CReference = BufferCReference.GetBuffer(M * ldc);
+
+    std::fill_n(C, M * ldc, -0.5f);
+    std::fill_n(CReference, M * ldc, -0.5f);
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.B = B;
+    Data.ldb = ldb;
+    Data.C = CReference;
+    Data.ldc = ldc;
+    Data.alpha = 1.0f;
+    Data.beta = 0.5f;
+
+    MlasGemm(TransA, TransB, M, N, K, Data, GetMlasThreadPool());
+
+    Data.C = C;
+    Data.Tuning = &Tuning;
+
+    MlasGemm(TransA, TransB, M, N, K, Data, GetMlasThreadPool());
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        ASSERT_NEAR(C[m * ldc + n], CReference[m * ldc + n], std::fabs(CReference[m * ldc + n]) * 1e-5f + 1e-4f)
+            << "M=" << M << " N=" << N << " K=" << K << " TransA=" << (TransA == CblasTrans)
+            << " TransB=" << (TransB == CblasTrans) << " StrideN=" << Tuning.StrideN
+            << " StrideK=" << Tuning.StrideK << " ThreadCountM=" << Tuning.ThreadCountM
+            << " ThreadCountN=" << Tuning.ThreadCountN << " @[" << m << "," << n << "]";
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SgemmTuning");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    const size_t MaximumPanelSize = MlasSgemmTuningMaximumPanelSize();
+    const size_t MaximumStrideK = MlasSgemmTuningMaximumStrideK();
+
+    std::vector<MLAS_SGEMM_TUNING_PARAMS> Candidates;
+
+    for (size_t StrideN = 16; StrideN <= MaximumPanelSize; StrideN *= 2) {
+      MLAS_SGEMM_TUNING_PARAMS Tuning;
+      Tuning.StrideN = StrideN;
+      Tuning.StrideK = MaximumPanelSize / StrideN;
+      Candidates.push_back(Tuning);
+    }
+
+    for (size_t ThreadCountM : {1, 2, 3}) {
+      for (size_t ThreadCountN : {1, 2}) {
+        MLAS_SGEMM_TUNING_PARAMS Tuning;
+        Tuning.StrideN = 64;
+        Tuning.StrideK = 48;
+        Tuning.ThreadCountM = ThreadCountM;
+        Tuning.ThreadCountN = ThreadCountN;
+        Candidates.push_back(Tuning);
+      }
+    }
+
+    //
+    // Unsupported values are ignored.
+    //
+
+    MLAS_SGEMM_TUNING_PARAMS Unsupported;
+    Unsupported.StrideN = 24;
+    Unsupported.StrideK = MaximumStrideK * 2;
+    Unsupported.ThreadCountM = 1000;
+    Unsupported.ThreadCountN = 1000;
+    Candidates.push_back(Unsupported);
+
+    for (const MLAS_SGEMM_TUNING_PARAMS& Tuning : Candidates) {
+      for (CBLAS_TRANSPOSE TransA : {CblasNoTrans, CblasTrans}) {
+        for (CBLAS_TRANSPOSE TransB : {CblasNoTrans, CblasTrans}) {
+          Test(TransA, TransB, 1, 33, 70, Tuning);
+          Test(TransA, TransB, 7, 100, 300, Tuning);
+          Test(TransA, TransB, 37, 129, 513, Tuning);
+          Test(TransA, TransB, 64, 17, 1100, Tuning);
+        }
+      }
+    }
+  }
+};
+
+template <>
+MlasSgemmTuningTest* MlasTestFixture<MlasSgemmTuningTest>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasSgemmTuningTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <size_t BlkN, bool Threaded>
+class MlasSparseGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferPackedB;
+  MatrixGuardBuffer<float> BufferC;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t M, size_t N, size_t K, float Density, CBLAS_TRANSPOSE TransB, float alpha) {
+    const size_t lda = K + 3;
+    const size_t ldb = (TransB == CblasNoTrans) ? N + 2 : K + 2;
+    const size_t ldc = N + 1;
+
+    float* A = BufferA.GetBuffer(M * lda);
+    float* B = BufferB.GetBuffer(((TransB == CblasNoTrans) ? K : N) * ldb);
+    float* C = BufferC.GetBuffer(M * ldc);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K + BlkN));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> density_distribution(0.0f, 1.0f);
+
+    for (size_t i = 0; i < M * lda; i++) {
+      A[i] = distribution(generator);
+    }
+
+    auto GetB = [&](size_t k, size_t n) -> float& {
+      return (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+    };
+
+    size_t ExpectedBlockCount = 0;
+
+    for (size_t k = 0; k < K; k++) {
+      for (size_t n = 0; n < N; n += BlkN) {
+        const bool NonZero = density_distribution(generator) < Density;
+        for (size_t nn = n; nn < std::min(n + BlkN, N); nn++) {
+          GetB(k, nn) = NonZero ? distribution(generator) : 0.0f;
+        }
+        ExpectedBlockCount += NonZero ? 1 : 0;
+      }
+    }
+
+    ASSERT_EQ(MlasGemmSparseCountBlocks(TransB, BlkN, N, K, B, ldb), ExpectedBlockCount)
+        << "M=" << M << " N=" << N << " K=" << K << " BlkN=" << BlkN;
+
+    const size_t PackedBSize = MlasGemmSparsePackBSize(TransB, BlkN, N, K, B, ldb);
+    void* PackedB = BufferPackedB.GetBuffer(PackedBSize, true);
+    MlasGemmSparsePackB(TransB, BlkN, N, K, B, ldb, PackedB);
+
+    //
+    // Fill matrix C to check that the output is overwritten.
+    //
+
+    std::fill_n(C, M * ldc, -0.5f);
+
+    MLAS_SGEMM_SPARSE_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.PackedB = PackedB;
+    Data.C = C;
+    Data.ldc = ldc;
+    Data.alpha = alpha;
+
+    MlasGemmSparseBatch(M, N, K, &Data, 1, threadpool_);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double Sum = 0.0;
+        double AbsSum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          const double Product = double(A[m * lda + k]) * double(GetB(k, n));
+          Sum += Product;
+          AbsSum += std::fabs(Product);
+        }
+
+        ASSERT_NEAR(C[m * ldc + n], Sum * alpha, (AbsSum * 1e-5 + 1e-5) * std::fabs(alpha))
+            << "M=" << M << " N=" << N << " K=" << K << " BlkN=" << BlkN << " Density=" << Density
+            << " TransB=" << (TransB == CblasTrans) << " @[" << m << "," << n << "]";
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("SparseGemm") + (BlkN == 1 ? "1x1" : "1x4") +
+                                        (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  MlasSparseGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (CBLAS_TRANSPOSE TransB : {CblasNoTrans, CblasTrans}) {
+      for (float Density : {0.0f, 0.1f, 0.5f, 1.0f}) {
+        Test(1, 1, 1, Density, TransB, 1.0f);
+        Test(1, 17, 15, Density, TransB, 1.0f);
+        Test(3, 64, 256, Density, TransB, 0.5f);
+        Test(8, 31, 257, Density, TransB, 1.0f);
+        Test(9, 33, 100, Density, TransB, 1.0f);
+        Test(16, 130, 300, Density, TransB, 2.0f);
+        Test(33, 100, 600, Density, TransB, 1.0f);
+        Test(5, 7, 0, Density, TransB, 1.0f);
+      }
+    }
+  }
+};
+
+template <> MlasSparseGemmTest<1, false>* MlasTestFixture<MlasSparseGemmTest<1, false>>::mlas_tester(nullptr);
+template <> MlasSparseGemmTest<1, true>* MlasTestFixture<MlasSparseGemmTest<1, true>>::mlas_tester(nullptr);
+template <> MlasSparseGemmTest<4, false>* MlasTestFixture<MlasSparseGemmTest<4, false>>::mlas_tester(nullptr);
+template <> MlasSparseGemmTest<4, true>* MlasTestFixture<MlasSparseGemmTest<4, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSparseGemmTest<1, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSparseGemmTest<4, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSparseGemmTest<1, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasSparseGemmTest<4, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
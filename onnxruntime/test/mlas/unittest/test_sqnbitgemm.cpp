@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <size_t BlkBitWidth, bool Threaded>
+class MlasSQNBitGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferQuantBData;
+  MatrixGuardBuffer<float> BufferQuantBScale;
+  MatrixGuardBuffer<uint8_t> BufferQuantBZeroPoint;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferC;
+  MLAS_THREADPOOL* threadpool_;
+
+  //
+  // Dequantizes matrix B with the layout documented in mlas.h, independently
+  // of the library routines.
+  //
+  void DequantizeB(size_t BlkLen, size_t N, size_t K, const uint8_t* QuantBData, const float* QuantBScale,
+                   const uint8_t* QuantBZeroPoint, std::vector<float>& B) {
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t BlkDataSize = BlkLen * BlkBitWidth / 8;
+    const size_t ZeroPointStride = (BlkBitWidth == 4) ? (BlockCountK + 1) / 2 : BlockCountK;
+
+    auto GetValue = [](const uint8_t* Data, size_t Index) -> int32_t {
+      if (BlkBitWidth == 4) {
+        return (Data[Index / 2] >> ((Index % 2) * 4)) & 0x0F;
+      }
+      return Data[Index];
+    };
+
+    B.resize(K * N);
+
+    for (size_t n = 0; n < N; n++) {
+      for (size_t k = 0; k < K; k++) {
+        const size_t BlockIndex = k / BlkLen;
+        const int32_t ZeroPoint = (QuantBZeroPoint != nullptr)
+                                      ? GetValue(QuantBZeroPoint + n * ZeroPointStride, BlockIndex)
+                                      : (1 << (BlkBitWidth - 1));
+        const int32_t Value = GetValue(QuantBData + (n * BlockCountK + BlockIndex) * BlkDataSize, k % BlkLen);
+        B[k * N + n] = float(Value - ZeroPoint) * QuantBScale[n * BlockCountK + BlockIndex];
+      }
+    }
+  }
+
+  void Test(size_t M, size_t N, size_t K, size_t BlkLen, bool WithZeroPoint, bool WithBias) {
+    const size_t lda = K + 3;
+    const size_t ldc = N + 1;
+
+    float* A = BufferA.GetBuffer(M * lda);
+    float* B = BufferB.GetBuffer(K * N);
+    float* Bias = BufferBias.GetBuffer(N);
+    float* C = BufferC.GetBuffer(M * ldc);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K + BlkLen));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < M * lda; i++) {
+      A[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < K * N; i++) {
+      B[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < N; i++) {
+      Bias[i] = distribution(generator);
+    }
+
+    size_t QuantBDataSize;
+    size_t QuantBScaleCount;
+    size_t QuantBZeroPointSize;
+    MlasSQNBitGemmQuantBSizes(BlkBitWidth, BlkLen, N, K, &QuantBDataSize, &QuantBScaleCount, &QuantBZeroPointSize);
+
+    uint8_t* QuantBData = BufferQuantBData.GetBuffer(QuantBDataSize);
+    float* QuantBScale = BufferQuantBScale.GetBuffer(QuantBScaleCount);
+    uint8_t* QuantBZeroPoint = WithZeroPoint ? BufferQuantBZeroPoint.GetBuffer(QuantBZeroPointSize) : nullptr;
+
+    MlasSQNBitGemmQuantizeB(BlkBitWidth, BlkLen, B, N, N, K, QuantBData, QuantBScale, QuantBZeroPoint);
+
+    //
+    // The quantization error is bounded by half a step of each block.
+    //
+
+    std::vector<float> DequantizedB;
+    DequantizeB(BlkLen, N, K, QuantBData, QuantBScale, QuantBZeroPoint, DequantizedB);
+
+    for (size_t k = 0; k < K; k++) {
+      for (size_t n = 0; n < N; n++) {
+        const float Step = QuantBScale[n * ((K + BlkLen - 1) / BlkLen) + k / BlkLen];
+        ASSERT_LE(std::fabs(DequantizedB[k * N + n] - B[k * N + n]), Step * 0.5f + 1e-6f)
+            << "quantize K=" << K << " N=" << N << " BlkLen=" << BlkLen << " @[" << k << "," << n << "]";
+      }
+    }
+
+    MLAS_SQNBIT_GEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.QuantBData = QuantBData;
+    Data.QuantBScale = QuantBScale;
+    Data.QuantBZeroPoint = QuantBZeroPoint;
+    Data.Bias = WithBias ? Bias : nullptr;
+    Data.C = C;
+    Data.ldc = ldc;
+
+    MlasSQNBitGemmBatch(M, N, K, BlkBitWidth, BlkLen, &Data, 1, threadpool_);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double Sum = WithBias ? double(Bias[n]) : 0.0;
+        double AbsSum = std::fabs(Sum);
+        for (size_t k = 0; k < K; k++) {
+          const double Product = double(A[m * lda + k]) * double(DequantizedB[k * N + n]);
+          Sum += Product;
+          AbsSum += std::fabs(Product);
+        }
+
+        ASSERT_NEAR(C[m * ldc + n], Sum, AbsSum * 1e-5 + 1e-5)
+            << "M=" << M << " N=" << N << " K=" << K << " BlkLen=" << BlkLen << " ZeroPoint=" << WithZeroPoint
+            << " Bias=" << WithBias << " @[" << m << "," << n << "]";
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("SQNBitGemm") + (BlkBitWidth == 4 ? "4Bit" : "8Bit") +
+                                        (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  MlasSQNBitGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (size_t BlkLen : {16, 32, 64, 128, 256}) {
+      for (bool WithZeroPoint : {false, true}) {
+        Test(1, 1, 1, BlkLen, WithZeroPoint, false);
+        Test(1, 17, 15, BlkLen, WithZeroPoint, true);
+        Test(1, 64, 256, BlkLen, WithZeroPoint, false);
+        Test(1, 130, 300, BlkLen, WithZeroPoint, true);
+        Test(2, 33, 100, BlkLen, WithZeroPoint, true);
+        Test(7, 16, 512, BlkLen, WithZeroPoint, false);
+        Test(33, 100, 257, BlkLen, WithZeroPoint, true);
+        Test(5, 7, 0, BlkLen, WithZeroPoint, true);
+      }
+    }
+  }
+};
+
+template <> MlasSQNBitGemmTest<4, false>* MlasTestFixture<MlasSQNBitGemmTest<4, false>>::mlas_tester(nullptr);
+template <> MlasSQNBitGemmTest<4, true>* MlasTestFixture<MlasSQNBitGemmTest<4, true>>::mlas_tester(nullptr);
+template <> MlasSQNBitGemmTest<8, false>* MlasTestFixture<MlasSQNBitGemmTest<8, false>>::mlas_tester(nullptr);
+template <> MlasSQNBitGemmTest<8, true>* MlasTestFixture<MlasSQNBitGemmTest<8, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSQNBitGemmTest<4, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSQNBitGemmTest<8, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSQNBitGemmTest<4, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasSQNBitGemmTest<8, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
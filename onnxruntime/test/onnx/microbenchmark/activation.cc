@@ -4,6 +4,7 @@
 #include "core/session/ort_env.h"
 #include "core/graph/model.h"
 #include "core/graph/graph.h"
+#include "core/framework/config_options.h"
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/data_transfer_manager.h"
@@ -36,6 +37,8 @@ struct KernelAndDef {
   std::unique_ptr<KernelDef> def;
   std::unique_ptr<Model> model;
   std::unique_ptr<logging::Logger> test_logger;
+  // the kernel info keeps a reference to the config options, so they must outlive the kernel
+  std::unique_ptr<ConfigOptions> config_options = std::make_unique<ConfigOptions>();
   std::unique_ptr<OpKernel> kernel;
   std::unique_ptr<OrtValueNameIdxMap> ort_value_idx_map = std::make_unique<OrtValueNameIdxMap>();
   std::unique_ptr<Allocs> a = std::make_unique<Allocs>();
@@ -69,7 +72,7 @@ struct KernelAndDef {
                   .SetDomain(domain)
                   .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
                   .Build();
-    OpKernelInfo info(main_node, *out.def, *out.a, {}, {}, {});
+    OpKernelInfo info(main_node, *out.def, *out.a, {}, {}, {}, *out.config_options);
     out.kernel = std::make_unique<KernelType>(info);
     return out;
   }
@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/model.h>
+#include <core/session/onnxruntime_c_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+#include <core/session/ort_env.h>
+
+#include <string>
+#include <vector>
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+#define ORT_BREAK_ON_ERROR(expr)                                \
+  do {                                                          \
+    OrtStatus* onnx_status = (expr);                            \
+    if (onnx_status != NULL) {                                  \
+      state.SkipWithError(g_ort->GetErrorMessage(onnx_status)); \
+      g_ort->ReleaseStatus(onnx_status);                        \
+      return;                                                   \
+    }                                                           \
+  } while (0);
+
+// Graph with num_branches independent towers of kTowerDepth MatMul+Relu layers whose results are summed:
+//   X -> [MatMul(W) -> Relu] x kTowerDepth -> ... -> Sum -> Y
+// The towers are the shape of a multi-tower recommender model, and only parallel executors can overlap them.
+static constexpr int kTowerDepth = 4;
+static constexpr int64_t kHiddenSize = 128;
+
+static std::string CreateWideBranchModel(int num_branches) {
+  auto logger = env->GetLoggingManager()->CreateLogger("executor_benchmark");
+  onnxruntime::Model model("wide_branches", false, *logger);
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kHiddenSize);
+
+  ONNX_NAMESPACE::TensorProto weight;
+  weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  weight.add_dims(kHiddenSize);
+  weight.add_dims(kHiddenSize);
+  for (int64_t i = 0; i < kHiddenSize * kHiddenSize; ++i) {
+    weight.add_float_data(static_cast<float>(i % 7) * 0.01f);
+  }
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  std::vector<onnxruntime::NodeArg*> tower_outputs;
+  for (int b = 0; b < num_branches; ++b) {
+    onnxruntime::NodeArg* layer_input = &input_arg;
+    for (int d = 0; d < kTowerDepth; ++d) {
+      const std::string prefix = "tower_" + std::to_string(b) + "_" + std::to_string(d);
+      weight.set_name(prefix + "_W");
+      graph.AddInitializedTensor(weight);
+      auto& weight_arg = graph.GetOrCreateNodeArg(weight.name(), nullptr);
+      auto& matmul_out = graph.GetOrCreateNodeArg(prefix + "_matmul", &float_tensor);
+      auto& relu_out = graph.GetOrCreateNodeArg(prefix + "_relu", &float_tensor);
+      graph.AddNode(prefix + "_matmul", "MatMul", "", {layer_input, &weight_arg}, {&matmul_out});
+      graph.AddNode(prefix + "_relu", "Relu", "", {&matmul_out}, {&relu_out});
+      layer_input = &relu_out;
+    }
+    tower_outputs.push_back(layer_input);
+  }
+
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("sum", "Sum", "", tower_outputs, {&output_arg});
+
+  auto status = graph.Resolve();
+  if (!status.IsOK()) {
+    ORT_THROW(status.ErrorMessage());
+  }
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  return model_data;
+}
+
+enum class ExecutorKind {
+  kSequential,
+  kParallel,
+  kDataflow,
+};
+
+static void RunWideBranchModel(benchmark::State& state, ExecutorKind executor_kind) {
+  const int num_branches = static_cast<int>(state.range(0));
+  const std::string model_data = CreateWideBranchModel(num_branches);
+
+  OrtSessionOptions* session_options;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BREAK_ON_ERROR(g_ort->SetIntraOpNumThreads(session_options, 1));
+  if (executor_kind != ExecutorKind::kSequential) {
+    ORT_BREAK_ON_ERROR(g_ort->SetSessionExecutionMode(session_options, ORT_PARALLEL));
+    ORT_BREAK_ON_ERROR(g_ort->SetInterOpNumThreads(session_options, 0));
+  }
+  if (executor_kind == ExecutorKind::kDataflow) {
+    ORT_BREAK_ON_ERROR(g_ort->AddSessionConfigEntry(session_options, kOrtSessionOptionsConfigUseDataflowExecutor,
+                                                    "1"));
+  }
+
+  OrtSession* session;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionFromArray(env, model_data.data(), model_data.size(), session_options,
+                                                   &session));
+
+  OrtMemoryInfo* memory_info;
+  ORT_BREAK_ON_ERROR(g_ort->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info));
+  std::vector<float> input_data(kHiddenSize, 1.0f);
+  const int64_t input_shape[] = {1, kHiddenSize};
+  OrtValue* input_tensor = nullptr;
+  ORT_BREAK_ON_ERROR(g_ort->CreateTensorWithDataAsOrtValue(memory_info, input_data.data(),
+                                                           input_data.size() * sizeof(float), input_shape, 2,
+                                                           ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &input_tensor));
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  for (auto _ : state) {
+    OrtValue* output_tensor = nullptr;
+    ORT_BREAK_ON_ERROR(g_ort->Run(session, nullptr, input_names, &input_tensor, 1, output_names, 1,
+                                  &output_tensor));
+    g_ort->ReleaseValue(output_tensor);
+  }
+
+  g_ort->ReleaseValue(input_tensor);
+  g_ort->ReleaseMemoryInfo(memory_info);
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+static void BM_WideBranches_SequentialExecutor(benchmark::State& state) {
+  RunWideBranchModel(state, ExecutorKind::kSequential);
+}
+
+static void BM_WideBranches_ParallelExecutor(benchmark::State& state) {
+  RunWideBranchModel(state, ExecutorKind::kParallel);
+}
+
+static void BM_WideBranches_DataflowExecutor(benchmark::State& state) {
+  RunWideBranchModel(state, ExecutorKind::kDataflow);
+}
+
+BENCHMARK(BM_WideBranches_SequentialExecutor)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->RangeMultiplier(2)
+    ->Range(2, 64);
+
+BENCHMARK(BM_WideBranches_ParallelExecutor)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->RangeMultiplier(2)
+    ->Range(2, 64);
+
+BENCHMARK(BM_WideBranches_DataflowExecutor)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->RangeMultiplier(2)
+    ->Range(2, 64);
@@ -0,0 +1,260 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/graph_viewer.h>
+#include <core/graph/model.h>
+#include <core/session/onnxruntime_c_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+#include <core/session/ort_env.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+#define ORT_BREAK_ON_ERROR(expr)                                \
+  do {                                                          \
+    OrtStatus* onnx_status = (expr);                            \
+    if (onnx_status != NULL) {                                  \
+      state.SkipWithError(g_ort->GetErrorMessage(onnx_status)); \
+      g_ort->ReleaseStatus(onnx_status);                        \
+      return;                                                   \
+    }                                                           \
+  } while (0);
+
+// Graphs with the structure of large models, built with small weights so that the graph work dominates:
+// - transformer: layers of self attention and feed forward blocks with residual connections
+// - GNN: layers that gather the node states along kEdgeTypes edge types, transform them and sum the messages
+static constexpr int64_t kSequenceLength = 16;
+static constexpr int64_t kHiddenSize = 32;
+static constexpr int kEdgeTypes = 8;
+
+class GraphBuilder {
+ public:
+  explicit GraphBuilder(onnxruntime::Graph& graph) : graph_(graph) {}
+
+  onnxruntime::NodeArg* Weight(const std::string& name, std::vector<int64_t> dims) {
+    ONNX_NAMESPACE::TensorProto weight;
+    weight.set_name(name);
+    weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    int64_t size = 1;
+    for (const auto dim : dims) {
+      weight.add_dims(dim);
+      size *= dim;
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      weight.add_float_data(static_cast<float>(i % 7) * 0.01f);
+    }
+    graph_.AddInitializedTensor(weight);
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  onnxruntime::NodeArg* Indices(const std::string& name, int64_t count, int64_t stride) {
+    ONNX_NAMESPACE::TensorProto indices;
+    indices.set_name(name);
+    indices.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    indices.add_dims(count);
+    for (int64_t i = 0; i < count; ++i) {
+      indices.add_int64_data((i * stride) % count);
+    }
+    graph_.AddInitializedTensor(indices);
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  onnxruntime::Node& Add(const std::string& op_type, const std::vector<onnxruntime::NodeArg*>& inputs,
+                         onnxruntime::NodeArg*& output) {
+    const std::string name = op_type + "_" + std::to_string(num_nodes_++);
+    output = &graph_.GetOrCreateNodeArg(name + "_out", nullptr);
+    return graph_.AddNode(name, op_type, "", inputs, {output});
+  }
+
+ private:
+  onnxruntime::Graph& graph_;
+  int num_nodes_ = 0;
+};
+
+static std::unique_ptr<onnxruntime::Model> CreateTransformerModel(const onnxruntime::logging::Logger& logger,
+                                                                  int num_layers) {
+  auto model = std::make_unique<onnxruntime::Model>("transformer", false, logger);
+  auto& graph = model->MainGraph();
+  GraphBuilder builder(graph);
+
+  ONNX_NAMESPACE::TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kSequenceLength);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kHiddenSize);
+
+  onnxruntime::NodeArg* h = &graph.GetOrCreateNodeArg("X", &input_type);
+  for (int l = 0; l < num_layers; ++l) {
+    const std::string prefix = "layer_" + std::to_string(l) + "_";
+    onnxruntime::NodeArg *q, *k, *v, *kt, *scores, *probs, *attention, *projected, *residual, *hidden, *activated,
+        *ffn;
+    builder.Add("MatMul", {h, builder.Weight(prefix + "Wq", {kHiddenSize, kHiddenSize})}, q);
+    builder.Add("MatMul", {h, builder.Weight(prefix + "Wk", {kHiddenSize, kHiddenSize})}, k);
+    builder.Add("MatMul", {h, builder.Weight(prefix + "Wv", {kHiddenSize, kHiddenSize})}, v);
+    builder.Add("Transpose", {k}, kt).AddAttribute("perm", std::vector<int64_t>{1, 0});
+    builder.Add("MatMul", {q, kt}, scores);
+    builder.Add("Softmax", {scores}, probs).AddAttribute("axis", static_cast<int64_t>(-1));
+    builder.Add("MatMul", {probs, v}, attention);
+    builder.Add("MatMul", {attention, builder.Weight(prefix + "Wo", {kHiddenSize, kHiddenSize})}, projected);
+    builder.Add("Add", {projected, h}, residual);
+    builder.Add("MatMul", {residual, builder.Weight(prefix + "W1", {kHiddenSize, 4 * kHiddenSize})}, hidden);
+    builder.Add("Relu", {hidden}, activated);
+    builder.Add("MatMul", {activated, builder.Weight(prefix + "W2", {4 * kHiddenSize, kHiddenSize})}, ffn);
+    builder.Add("Add", {ffn, residual}, h);
+  }
+
+  return model;
+}
+
+static std::unique_ptr<onnxruntime::Model> CreateGnnModel(const onnxruntime::logging::Logger& logger,
+                                                          int num_layers) {
+  constexpr int64_t kNumNodes = 64;
+
+  auto model = std::make_unique<onnxruntime::Model>("gnn", false, logger);
+  auto& graph = model->MainGraph();
+  GraphBuilder builder(graph);
+
+  ONNX_NAMESPACE::TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kNumNodes);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kHiddenSize);
+
+  std::vector<onnxruntime::NodeArg*> edge_indices;
+  for (int e = 0; e < kEdgeTypes; ++e) {
+    edge_indices.push_back(builder.Indices("edges_" + std::to_string(e), kNumNodes, 2 * e + 1));
+  }
+
+  onnxruntime::NodeArg* h = &graph.GetOrCreateNodeArg("X", &input_type);
+  for (int l = 0; l < num_layers; ++l) {
+    std::vector<onnxruntime::NodeArg*> messages;
+    for (int e = 0; e < kEdgeTypes; ++e) {
+      const std::string prefix = "layer_" + std::to_string(l) + "_edge_" + std::to_string(e) + "_";
+      onnxruntime::NodeArg *gathered, *message;
+      builder.Add("Gather", {h, edge_indices[e]}, gathered).AddAttribute("axis", static_cast<int64_t>(0));
+      builder.Add("MatMul", {gathered, builder.Weight(prefix + "W", {kHiddenSize, kHiddenSize})}, message);
+      messages.push_back(message);
+    }
+
+    onnxruntime::NodeArg* aggregated;
+    builder.Add("Sum", messages, aggregated);
+    builder.Add("Relu", {aggregated}, h);
+  }
+
+  return model;
+}
+
+using CreateModelFn = std::unique_ptr<onnxruntime::Model> (*)(const onnxruntime::logging::Logger&, int);
+
+// Resolve after a change of one node in the middle of the graph, like the changes of a graph transformer:
+// an Identity node is inserted before the node and removed again.
+// The second argument selects whether Resolve skips the inference of unchanged nodes (1) or infers all nodes (0).
+static void RunResolveAfterChange(benchmark::State& state, CreateModelFn create_model) {
+  auto logger = env->GetLoggingManager()->CreateLogger("graph_resolve_benchmark");
+  auto model = create_model(*logger, static_cast<int>(state.range(0)));
+  auto& graph = model->MainGraph();
+  onnxruntime::Graph::ResolveOptions options;
+  options.skip_unchanged_inference = state.range(1) != 0;
+  auto status = graph.Resolve(options);
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  const std::vector<onnxruntime::NodeIndex> order = onnxruntime::GraphViewer(graph).GetNodesInTopologicalOrder();
+  onnxruntime::Node& consumer = *graph.GetNode(order[order.size() / 2]);
+  onnxruntime::NodeArg* original_input = consumer.MutableInputDefs()[0];
+
+  for (auto _ : state) {
+    auto& identity_output = graph.GetOrCreateNodeArg("inserted_identity_out", original_input->TypeAsProto());
+    auto& identity = graph.AddNode("inserted_identity", "Identity", "", {original_input}, {&identity_output});
+    consumer.MutableInputDefs()[0] = &identity_output;
+    graph.SetGraphResolveNeeded();
+    status = graph.Resolve(options);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      return;
+    }
+
+    consumer.MutableInputDefs()[0] = original_input;
+    graph.RemoveEdge(identity.Index(), consumer.Index(), 0, 0);
+    graph.RemoveNode(identity.Index());
+    graph.SetGraphResolveNeeded();
+    status = graph.Resolve(options);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      return;
+    }
+  }
+}
+
+// Session creation, which resolves the graph again after each graph transformation that changes it.
+// The second argument selects whether those resolves skip the inference of unchanged nodes (1) or infer all nodes (0).
+static void RunCreateSession(benchmark::State& state, CreateModelFn create_model) {
+  std::string model_data;
+  {
+    auto logger = env->GetLoggingManager()->CreateLogger("graph_resolve_benchmark");
+    auto model = create_model(*logger, static_cast<int>(state.range(0)));
+    auto status = model->MainGraph().Resolve();
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      return;
+    }
+    model->ToProto().SerializeToString(&model_data);
+  }
+
+  OrtSessionOptions* session_options;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BREAK_ON_ERROR(g_ort->AddSessionConfigEntry(session_options, kOrtSessionOptionsConfigResolveSkipUnchangedInference,
+                                                  state.range(1) != 0 ? "1" : "0"));
+  for (auto _ : state) {
+    OrtSession* session;
+    ORT_BREAK_ON_ERROR(g_ort->CreateSessionFromArray(env, model_data.data(), model_data.size(), session_options,
+                                                     &session));
+    state.PauseTiming();
+    g_ort->ReleaseSession(session);
+    state.ResumeTiming();
+  }
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+static void BM_ResolveAfterChange_Transformer(benchmark::State& state) {
+  RunResolveAfterChange(state, CreateTransformerModel);
+}
+
+static void BM_ResolveAfterChange_Gnn(benchmark::State& state) {
+  RunResolveAfterChange(state, CreateGnnModel);
+}
+
+static void BM_CreateSession_Transformer(benchmark::State& state) {
+  RunCreateSession(state, CreateTransformerModel);
+}
+
+static void BM_CreateSession_Gnn(benchmark::State& state) {
+  RunCreateSession(state, CreateGnnModel);
+}
+
+BENCHMARK(BM_ResolveAfterChange_Transformer)
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->ArgNames({"layers", "skip_unchanged"})
+    ->ArgsProduct({{4, 16, 64}, {0, 1}});
+
+BENCHMARK(BM_ResolveAfterChange_Gnn)
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->ArgNames({"layers", "skip_unchanged"})
+    ->ArgsProduct({{4, 16, 64}, {0, 1}});
+
+BENCHMARK(BM_CreateSession_Transformer)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMillisecond)
+    ->ArgNames({"layers", "skip_unchanged"})
+    ->ArgsProduct({{4, 16, 64}, {0, 1}});
+
+BENCHMARK(BM_CreateSession_Gnn)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMillisecond)
+    ->ArgNames({"layers", "skip_unchanged"})
+    ->ArgsProduct({{4, 16, 64}, {0, 1}});
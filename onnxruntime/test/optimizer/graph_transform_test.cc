@@ -1421,6 +1421,44 @@ TEST_F(GraphTransformationTests, Gemm_LeakyRelu_Fusion) {
   ASSERT_TRUE(op_to_count["Gemm"] == 0);
   ASSERT_TRUE(op_to_count["com.microsoft.FusedGemm"] == 1);
 }
+
+TEST_F(GraphTransformationTests, Gemm_Gelu_Fusion) {
+  auto build_test_case = [&](bool fast_gelu_with_bias) {
+    return [fast_gelu_with_bias](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{4, 8}});
+      auto* weight_arg = builder.MakeInitializer<float>({8, 16}, -1.0f, 1.0f);
+      auto* gemm_out = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Gemm", {input_arg, weight_arg}, {gemm_out});
+      if (fast_gelu_with_bias) {
+        auto* bias_arg = builder.MakeInitializer<float>({16}, -1.0f, 1.0f);
+        builder.AddNode("FastGelu", {gemm_out, bias_arg}, {output_arg}, kMSDomain);
+      } else {
+        builder.AddNode("Gelu", {gemm_out}, {output_arg}, kMSDomain);
+      }
+    };
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    ASSERT_EQ(CountOpsInGraph(graph)["Gemm"], 1);
+  };
+
+  auto post_graph_checker = [](bool expect_fused) {
+    return [expect_fused](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      ASSERT_EQ(op_to_count["com.microsoft.FusedGemm"], expect_fused ? 1 : 0);
+      ASSERT_EQ(op_to_count["Gemm"], expect_fused ? 0 : 1);
+    };
+  };
+
+  TestGraphTransformer(build_test_case(false), 13, *logger_, std::make_unique<GemmActivationFusion>(),
+                       TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker(true));
+
+  // FusedGemm cannot add the FastGelu bias.
+  TestGraphTransformer(build_test_case(true), 13, *logger_, std::make_unique<GemmActivationFusion>(),
+                       TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker(false));
+}
 #endif
 
 // (A')'B' = AB'
@@ -10,6 +10,9 @@
 #include "core/graph/model.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/graph_transformer_mgr.h"
+#include "core/optimizer/graph_transformer_utils.h"
+#include "core/optimizer/identity_elimination.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "dummy_graph_transformer.h"
 #include "test/framework/test_utils.h"
 #include "test/test_environment.h"
@@ -71,5 +74,112 @@ TEST(RuleBasedGraphTransformerTest, TestSettingStepsInGraphTransformerManager) {
   ASSERT_STATUS_OK(graph_transformation_mgr.GetSteps(steps_queried));
   ASSERT_EQ(steps_queried, static_cast<unsigned> (10));
 }
+
+TEST(RuleBasedGraphTransformerTest, TestWorklistInGraphTransformerManager) {
+  // applying the transformers to the changed nodes only gives the same graph as applying them to all the nodes
+  const std::vector<PathString> model_uris = {
+      ORT_TSTR("testdata/transform/abs-2id-max.onnx"),
+      ORT_TSTR("testdata/transform/scan9_sum.onnx"),
+      ORT_TSTR("testdata/transform/fusion/fuse-conv-bn-mul-add-unsqueeze.onnx"),
+      ORT_TSTR("testdata/transform/fusion/conv_add_relu.onnx"),
+  };
+
+  CPUExecutionProvider cpu_ep(CPUExecutionProviderInfo{});
+  const auto& logger = DefaultLoggingManager().DefaultLogger();
+
+  for (const auto& model_uri : model_uris) {
+    OpCountMap op_counts[2];
+    for (const bool use_worklist : {false, true}) {
+      std::shared_ptr<Model> model;
+      ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, logger));
+      Graph& graph = model->MainGraph();
+
+      onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+      ASSERT_STATUS_OK(graph_transformation_mgr.SetUseWorklist(use_worklist));
+      for (const auto level : {TransformerLevel::Level1, TransformerLevel::Level2}) {
+        for (auto& transformer : optimizer_utils::GenerateTransformers(level, {}, cpu_ep)) {
+          ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(transformer), level));
+        }
+        ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, level, logger));
+      }
+
+      op_counts[use_worklist ? 1 : 0] = CountOpsInGraph(graph);
+    }
+
+    EXPECT_EQ(op_counts[0], op_counts[1]) << ToUTF8String(model_uri);
+  }
+}
+
+// Rewrite rule that counts the nodes it is evaluated on, and never applies.
+class CountingRewriteRule : public RewriteRule {
+ public:
+  explicit CountingRewriteRule(size_t& visits) noexcept : RewriteRule("CountingRule"), visits_(visits) {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {};
+  }
+
+ private:
+  size_t& visits_;
+
+  bool SatisfyCondition(const Graph& /*graph*/, const Node& /*node*/, const logging::Logger& /*logger*/) const override {
+    ++visits_;
+    return false;
+  }
+
+  Status Apply(Graph& /*graph*/, Node& /*node*/, RewriteRuleEffect& /*rule_effect*/,
+               const logging::Logger& /*logger*/) const override {
+    return Status::OK();
+  }
+};
+
+TEST(RuleBasedGraphTransformerTest, TestWorklistSkipsUnchangedNodes) {
+  constexpr size_t kNumAbsNodes = 20;
+  const auto& logger = DefaultLoggingManager().DefaultLogger();
+
+  size_t visits[2] = {0, 0};
+  for (const bool use_worklist : {false, true}) {
+    Model model("worklist", false, logger);
+    Graph& graph = model.MainGraph();
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+    // a chain of Abs nodes with an Identity node in the middle
+    NodeArg* input = &graph.GetOrCreateNodeArg("X", &float_tensor);
+    for (size_t i = 0; i < kNumAbsNodes; ++i) {
+      if (i == kNumAbsNodes / 2) {
+        NodeArg* output = &graph.GetOrCreateNodeArg("identity_out", &float_tensor);
+        graph.AddNode("identity", "Identity", "", {input}, {output});
+        input = output;
+      }
+      NodeArg* output = &graph.GetOrCreateNodeArg("abs_" + std::to_string(i) + "_out", &float_tensor);
+      graph.AddNode("abs_" + std::to_string(i), "Abs", "", {input}, {output});
+      input = output;
+    }
+    ASSERT_STATUS_OK(graph.Resolve());
+
+    auto eliminate_identity = std::make_unique<RuleBasedGraphTransformer>("EliminateIdentityTransformer");
+    ASSERT_STATUS_OK(eliminate_identity->Register(std::make_unique<EliminateIdentity>()));
+    size_t& counted_visits = visits[use_worklist ? 1 : 0];
+    auto counter = std::make_unique<RuleBasedGraphTransformer>("CountingTransformer");
+    ASSERT_STATUS_OK(counter->Register(std::make_unique<CountingRewriteRule>(counted_visits)));
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    ASSERT_STATUS_OK(graph_transformation_mgr.SetUseWorklist(use_worklist));
+    ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(eliminate_identity), TransformerLevel::Level1));
+    ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(counter), TransformerLevel::Level1));
+    ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, logger));
+
+    ASSERT_EQ(graph.NumberOfNodes(), static_cast<int>(kNumAbsNodes));
+  }
+
+  // the first step visits all the nodes, after the Identity node was removed. the second step visits all the nodes
+  // again, or with the worklist only the Abs nodes within 2 edges of the nodes the Identity node was between.
+  EXPECT_EQ(visits[0], 2 * kNumAbsNodes);
+  EXPECT_EQ(visits[1], kNumAbsNodes + 6);
+}
+
 }  // namespace test
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
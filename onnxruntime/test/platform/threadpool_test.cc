@@ -505,6 +505,46 @@ TEST(ThreadPoolTest, TestStagedMultiLoopSections_4Thread_100Loop) {
   TestStagedMultiLoopSections("TestStagedMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+TEST(ThreadPoolTest, TestNumaNodes) {
+  ThreadOptions to;
+  // the first entry is the caller thread
+  to.numa_nodes = {0, 0, 0, 1, 1};
+  to.replicate_weights_per_numa_node = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 5, true);
+  ASSERT_EQ(ThreadPool::NumNumaNodes(tp.get()), 2);
+  ASSERT_TRUE(ThreadPool::ShouldReplicateWeightsPerNumaNode(tp.get()));
+  ASSERT_EQ(ThreadPool::CurrentNumaNode(tp.get()), -1);
+
+  onnxruntime::OrtMutex mutex;
+  std::vector<int> nodes;
+  ThreadPool::TrySimpleParallelFor(tp.get(), 100, [&](std::ptrdiff_t) {
+    std::lock_guard<onnxruntime::OrtMutex> lock(mutex);
+    nodes.push_back(ThreadPool::CurrentNumaNode(tp.get()));
+  });
+  ASSERT_EQ(nodes.size(), 100u);
+  for (int node : nodes) {
+    ASSERT_TRUE(node >= -1 && node <= 1) << node;
+  }
+}
+
+TEST(ThreadPoolTest, TestSingleNumaNode) {
+  ThreadOptions to;
+  to.numa_nodes = {1, 1, 1};
+  to.replicate_weights_per_numa_node = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 3, true);
+  ASSERT_EQ(ThreadPool::NumNumaNodes(tp.get()), 1);
+  ASSERT_FALSE(ThreadPool::ShouldReplicateWeightsPerNumaNode(tp.get()));
+
+  Notification n;
+  int node = 0;
+  ThreadPool::Schedule(tp.get(), [&]() {
+    node = ThreadPool::CurrentNumaNode(tp.get());
+    n.Notify();
+  });
+  n.Wait();
+  ASSERT_EQ(node, -1);
+}
+
 #ifdef _WIN32
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
 #pragma warning(push)
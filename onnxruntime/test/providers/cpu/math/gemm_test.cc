@@ -45,8 +45,6 @@ TEST(GemmOpTest, GemmNoTrans_double) {
   TestGemmNoTrans<double>();
 }
 
-// Only CUDA and ROCM kernel has float 16 support
-#if defined(USE_CUDA) || defined(USE_ROCM)
 TEST(GemmOpTest, GemmNoTrans_f16) {
 #ifdef USE_CUDA
   int min_cuda_architecture = 530;
@@ -84,7 +82,90 @@ TEST(GemmOpTest, GemmNoTrans_f16) {
   test.AddOutput<MLFloat16>("Y", {2, 3}, f_Y);
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  //TensorRT: fp16 is not supported
 }
-#endif
+
+// Exercises the CPU fp16 path with transposed inputs, a broadcast bias and a prepacked B.
+TEST(GemmOpTest, GemmTransAB_BroadcastC_f16) {
+  OpTester test("Gemm", 13);
+
+  test.AddAttribute("transA", (int64_t)1);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("beta", 2.0f);
+
+  std::vector<float> A{1.0f, -1.0f,
+                       2.0f, -2.0f,
+                       3.0f, -3.0f,
+                       4.0f, -4.0f};
+  std::vector<float> B{1.0f, 2.0f, 3.0f, 4.0f,
+                       0.0f, 1.0f, 0.0f, 1.0f,
+                       -1.0f, -1.0f, -1.0f, -1.0f};
+  std::vector<float> C{1.0f, 2.0f, 3.0f};
+  std::vector<float> Y{17.0f, 7.0f, 1.0f,
+                       -13.0f, 1.0f, 11.0f};
+
+  std::vector<MLFloat16> f_A(8);
+  std::vector<MLFloat16> f_B(12);
+  std::vector<MLFloat16> f_C(3);
+  std::vector<MLFloat16> f_Y(6);
+  ConvertFloatToMLFloat16(A.data(), f_A.data(), 8);
+  ConvertFloatToMLFloat16(B.data(), f_B.data(), 12);
+  ConvertFloatToMLFloat16(C.data(), f_C.data(), 3);
+  ConvertFloatToMLFloat16(Y.data(), f_Y.data(), 6);
+
+  test.AddInput<MLFloat16>("A", {4, 2}, f_A);
+  test.AddInput<MLFloat16>("B", {3, 4}, f_B, true);
+  test.AddInput<MLFloat16>("C", {3}, f_C);
+  test.AddOutput<MLFloat16>("Y", {2, 3}, f_Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  //TensorRT: fp16 is not supported
+}
+
+// A transposed A large enough for the blocked transpose, and a long K that checks the fp32 accumulation: summing in
+// fp16 would drop every 0.25 added to 1024 and produce 1024 * (m + 1) instead of 1088 * (m + 1).
+TEST(GemmOpTest, GemmTransA_Accumulation_f16) {
+  OpTester test("Gemm", 13);
+
+  test.AddAttribute("transA", (int64_t)1);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+
+  constexpr int64_t M = 9;
+  constexpr int64_t N = 2;
+  constexpr int64_t K = 257;
+  std::vector<float> A(K * M);
+  for (int64_t k = 0; k < K; k++) {
+    for (int64_t m = 0; m < M; m++) {
+      A[k * M + m] = static_cast<float>(m + 1);
+    }
+  }
+  std::vector<float> B(K * N, 0.25f);
+  B[0] = 1024.0f;
+  B[1] = -1024.0f;
+  for (int64_t k = 1; k < K; k++) {
+    B[k * N + 1] = -0.25f;
+  }
+  std::vector<float> C{1.0f, 2.0f};
+  std::vector<float> Y(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    Y[m * N + 0] = 1088.0f * (m + 1) + 1.0f;
+    Y[m * N + 1] = -1088.0f * (m + 1) + 2.0f;
+  }
+
+  std::vector<MLFloat16> f_A(A.size());
+  std::vector<MLFloat16> f_B(B.size());
+  std::vector<MLFloat16> f_C(C.size());
+  std::vector<MLFloat16> f_Y(Y.size());
+  ConvertFloatToMLFloat16(A.data(), f_A.data(), static_cast<int>(A.size()));
+  ConvertFloatToMLFloat16(B.data(), f_B.data(), static_cast<int>(B.size()));
+  ConvertFloatToMLFloat16(C.data(), f_C.data(), static_cast<int>(C.size()));
+  ConvertFloatToMLFloat16(Y.data(), f_Y.data(), static_cast<int>(Y.size()));
+
+  test.AddInput<MLFloat16>("A", {K, M}, f_A);
+  test.AddInput<MLFloat16>("B", {K, N}, f_B, true);
+  test.AddInput<MLFloat16>("C", {N}, f_C);
+  test.AddOutput<MLFloat16>("Y", {M, N}, f_Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  //TensorRT: fp16 is not supported
+}
 
 #if defined(USE_CUDA) || defined(USE_ROCM)
 TEST(GemmOpTest, GemmNoTrans_bfloat16) {
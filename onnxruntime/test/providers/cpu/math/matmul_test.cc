@@ -1,7 +1,15 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
 #include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
@@ -191,7 +199,6 @@ TEST(MathOpTest, MatMulUint64Type) {
   RunMatMulTest<uint64_t>(9);
 }
 
-#if defined(USE_CUDA) || defined(USE_ROCM)
 TEST(MathOpTest, MatMul_Float16) {
 #ifdef USE_CUDA
   int min_cuda_architecture = 530;
@@ -220,7 +227,60 @@ TEST(MathOpTest, MatMul_Float16) {
   test.AddOutput<MLFloat16>("Y", {2, 3}, f_Y);
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  // TensorRT: fp16 is not supported
 }
-#endif
+
+// Broadcast A over a constant B so the CPU kernel uses its prepacked fp16 weights.
+TEST(MathOpTest, MatMul_Float16_BatchedConstantB) {
+  OpTester test("MatMul", 13);
+
+  std::vector<float> A{1.0f, 2.0f, 3.0f,
+                       -1.0f, 0.5f, 2.0f,
+                       0.0f, 0.0f, 1.0f,
+                       4.0f, -2.0f, 0.25f};
+  std::vector<float> B{1.0f, 0.0f,
+                       0.0f, 1.0f,
+                       2.0f, -1.0f};
+  std::vector<float> Y{7.0f, -1.0f,
+                       3.0f, -1.5f,
+                       2.0f, -1.0f,
+                       4.5f, -2.25f};
+
+  std::vector<MLFloat16> f_A(12);
+  std::vector<MLFloat16> f_B(6);
+  std::vector<MLFloat16> f_Y(8);
+  ConvertFloatToMLFloat16(A.data(), f_A.data(), 12);
+  ConvertFloatToMLFloat16(B.data(), f_B.data(), 6);
+  ConvertFloatToMLFloat16(Y.data(), f_Y.data(), 8);
+
+  test.AddInput<MLFloat16>("A", {2, 2, 3}, f_A);
+  test.AddInput<MLFloat16>("B", {3, 2}, f_B, true);
+  test.AddOutput<MLFloat16>("Y", {2, 2, 2}, f_Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  // TensorRT: fp16 is not supported
+}
+
+// The CPU kernel accumulates in fp32 and rounds each output to fp16 once, so the result matches an fp32 MatMul of
+// the same fp16 values. Accumulating in fp16 would drop every 0.25 added to 1024 and produce 1024 instead of 1088.
+TEST(MathOpTest, MatMul_Float16_Accumulation) {
+  OpTester test("MatMul", 13);
+
+  constexpr int64_t K = 257;
+  std::vector<float> A(2 * K, 1.0f);
+  A[K] = -1.0f;
+  std::vector<float> B(K, 0.25f);
+  B[0] = 1024.0f;
+  std::vector<float> Y{1088.0f, -960.0f};
+
+  std::vector<MLFloat16> f_A(A.size());
+  std::vector<MLFloat16> f_B(B.size());
+  std::vector<MLFloat16> f_Y(Y.size());
+  ConvertFloatToMLFloat16(A.data(), f_A.data(), static_cast<int>(A.size()));
+  ConvertFloatToMLFloat16(B.data(), f_B.data(), static_cast<int>(B.size()));
+  ConvertFloatToMLFloat16(Y.data(), f_Y.data(), static_cast<int>(Y.size()));
+
+  test.AddInput<MLFloat16>("A", {2, K}, f_A);
+  test.AddInput<MLFloat16>("B", {K, 1}, f_B, true);
+  test.AddOutput<MLFloat16>("Y", {2, 1}, f_Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  // TensorRT: fp16 is not supported
+}
 
 #if defined(USE_CUDA) || defined(USE_ROCM)
 TEST(MathOpTest, MatMul_BFloat16) {
@@ -321,7 +381,195 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights) {
   }
 }
 
+// A constant B with enough zeros is prepacked in the MLAS sparse format.
+TEST(MathOpTest, MatMulSparsePrepackedWeights) {
+  auto run_test = [](bool unstructured) {
+    constexpr int64_t M = 5, K = 20, N = 10;
+
+    // Zero 3 of every 4 1x4 blocks, or 9 of every 10 values.
+    std::vector<float> b(K * N);
+    for (int64_t k = 0; k < K; k++) {
+      for (int64_t n = 0; n < N; n++) {
+        const bool zero = unstructured ? (k * N + n) % 10 != 3 : (k + n / 4) % 4 != 0;
+        b[k * N + n] = zero ? 0.0f : static_cast<float>((k * 7 + n * 3) % 11) - 5.0f;
+      }
+    }
+
+    std::vector<float> a(2 * M * K);
+    for (size_t i = 0; i < a.size(); i++) {
+      a[i] = static_cast<float>(i % 9) * 0.5f - 2.0f;
+    }
+
+    std::vector<float> y(2 * M * N, 0.0f);
+    for (int64_t m = 0; m < 2 * M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        for (int64_t k = 0; k < K; k++) {
+          y[m * N + n] += a[m * K + k] * b[k * N + n];
+        }
+      }
+    }
+
+    // the kernel takes the sparse path as B is packed in the sparse format at the threshold of the session
+    AllocatorPtr alloc = std::make_shared<CPUAllocator>();
+    Tensor tensor_b(DataTypeImpl::GetType<float>(), TensorShape({K, N}), b.data(), alloc->Info());
+    BufferUniquePtr packed_b;
+    size_t packed_b_size = 0;
+    TensorShape b_shape;
+    ASSERT_TRUE(GemmPackBSparseFp32(alloc, tensor_b, false, 0.5f, packed_b, packed_b_size, b_shape));
+    EXPECT_GT(packed_b_size, 0u);
+
+    OpTester test("MatMul", 13);
+    test.AddInput<float>("A", {2, M, K}, a);
+    test.AddInput<float>("B", {K, N}, b, true);
+    test.AddOutput<float>("Y", {2, M, N}, y);
+
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigMatMulSparseWeightThreshold, "0.5"));
+
+    // share B so the weight the kernel pre-packs lands in the container of the tester, where its size is visible
+    OrtValue b_value;
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({K, N}), b.data(),
+                         OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator), b_value);
+    ASSERT_STATUS_OK(so.AddInitializer("B", &b_value));
+    test.EnableSharingOfPrePackedWeightsAcrossSessions();
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    size_t number_of_pre_packed_weights = 0;
+    size_t number_of_shared_pre_packed_weights = 0;
+    test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers, {},
+             &number_of_pre_packed_weights, &number_of_shared_pre_packed_weights);
+    EXPECT_EQ(number_of_pre_packed_weights, 1u);
+
+    // the kernel packed B in the sparse format, which differs in size from the dense packing
+    const auto& prepacked_weights_map = test.GetPrePackedWeightsShared().prepacked_weights_map_;
+    ASSERT_EQ(prepacked_weights_map.size(), 1u);
+    const auto& buffer_sizes = prepacked_weights_map.begin()->second.buffer_sizes_;
+    ASSERT_EQ(buffer_sizes.size(), 1u);
+    EXPECT_EQ(buffer_sizes[0], packed_b_size);
+    EXPECT_NE(buffer_sizes[0], MlasGemmPackBSize(N, K));
+  };
+
+  run_test(false);
+  run_test(true);
+
+  // a dense B is not packed in the sparse format
+  constexpr int64_t K = 20, N = 10;
+  std::vector<float> b(K * N, 1.0f);
+  AllocatorPtr alloc = std::make_shared<CPUAllocator>();
+  Tensor tensor_b(DataTypeImpl::GetType<float>(), TensorShape({K, N}), b.data(), alloc->Info());
+  BufferUniquePtr packed_b;
+  size_t packed_b_size = 0;
+  TensorShape b_shape;
+  EXPECT_FALSE(GemmPackBSparseFp32(alloc, tensor_b, false, 0.5f, packed_b, packed_b_size, b_shape));
+}
+
 #endif
 
+// The kernels tuned by "session.gemm_autotune" compute the same results and save the tuning cache.
+TEST(MathOpTest, MatMulGemmAutotune) {
+  constexpr int64_t K = 70, N = 130;
+  const std::string cache_file = "matmul_gemm_autotune_cache.txt";
+  const std::string reused_cache_file = "matmul_gemm_autotune_reused_cache.txt";
+  std::remove(cache_file.c_str());
+  std::remove(reused_cache_file.c_str());
+
+  std::vector<float> b(K * N);
+  for (size_t i = 0; i < b.size(); i++) {
+    b[i] = static_cast<float>(i % 11) - 5.0f;
+  }
+
+  auto run_test = [&](int64_t M, bool is_initializer, const std::string& file) {
+    std::vector<float> a(M * K);
+    for (size_t i = 0; i < a.size(); i++) {
+      a[i] = static_cast<float>(i % 9) * 0.5f - 2.0f;
+    }
+
+    std::vector<float> y(M * N, 0.0f);
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        for (int64_t k = 0; k < K; k++) {
+          y[m * N + n] += a[m * K + k] * b[k * N + n];
+        }
+      }
+    }
+
+    OpTester test("MatMul", 13);
+    test.AddInput<float>("A", {M, K}, a);
+    test.AddInput<float>("B", {K, N}, b, is_initializer);
+    test.AddOutput<float>("Y", {M, N}, y);
+
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigGemmAutotune, "1"));
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigGemmAutotuneCacheFile, file.c_str()));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  };
+
+  auto read_file = [](const std::string& file) {
+    std::ifstream stream(file);
+    std::stringstream contents;
+    contents << stream.rdbuf();
+    return contents.str();
+  };
+
+  constexpr int64_t M = 33;
+  run_test(M, false, cache_file);
+  run_test(M, true, cache_file);
+
+  // find the entry tuned for the prepacked B:
+  // cpu M N K batch trans_a trans_b b_is_packed threads StrideN StrideK ThreadCountM ThreadCountN
+  std::istringstream lines(read_file(cache_file));
+  std::string line, cpu_key;
+  size_t entry_m = 0, entry_n = 0, entry_k = 0, batch = 0, threads = 0;
+  bool trans_a = false, trans_b = false, b_is_packed = false;
+  bool found = false;
+  while (!found && std::getline(lines, line)) {
+    std::istringstream fields(line);
+    found = line[0] != '#' &&
+            static_cast<bool>(fields >> cpu_key >> entry_m >> entry_n >> entry_k >> batch >> trans_a >> trans_b >>
+                              b_is_packed >> threads) &&
+            entry_m == static_cast<size_t>(M) && entry_n == static_cast<size_t>(N) &&
+            entry_k == static_cast<size_t>(K) && b_is_packed;
+  }
+  ASSERT_TRUE(found) << "No entry tuned for the MatMul in " << cache_file;
+
+  // A session with another shape reads the entry for it from its cache file instead of tuning it, so the file is
+  // not written again.
+  constexpr int64_t reused_M = 47;
+  std::ostringstream reused_entry;
+  reused_entry << cpu_key << " " << reused_M << " " << N << " " << K << " " << batch << " " << trans_a << " "
+               << trans_b << " " << b_is_packed << " " << threads << " 0 0 1 1\n";
+  {
+    std::ofstream reused_cache(reused_cache_file, std::ios::trunc);
+    reused_cache << reused_entry.str();
+  }
+
+  run_test(reused_M, true, reused_cache_file);
+  EXPECT_EQ(read_file(reused_cache_file), reused_entry.str());
+
+  // Tuning a new shape rewrites the file with its own entries only, not those of the other cache file.
+  constexpr int64_t tuned_M = 21;
+  run_test(tuned_M, true, reused_cache_file);
+  std::istringstream reused_lines(read_file(reused_cache_file));
+  bool found_reused = false, found_tuned = false;
+  while (std::getline(reused_lines, line)) {
+    std::istringstream fields(line);
+    if (line[0] == '#' || !(fields >> cpu_key >> entry_m)) {
+      continue;
+    }
+    EXPECT_NE(entry_m, static_cast<size_t>(M)) << "Entry of " << cache_file << " written to " << reused_cache_file;
+    found_reused |= entry_m == static_cast<size_t>(reused_M);
+    found_tuned |= entry_m == static_cast<size_t>(tuned_M);
+  }
+  EXPECT_TRUE(found_reused);
+  EXPECT_TRUE(found_tuned);
+
+  std::remove(cache_file.c_str());
+  std::remove(reused_cache_file.c_str());
+}
+
 }  // namespace test
 }  // namespace onnxruntime
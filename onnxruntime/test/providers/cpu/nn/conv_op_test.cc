@@ -4,7 +4,9 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/framework/test_utils.h"
+#include "test/util/include/default_providers.h"
 
 using namespace std;
 namespace onnxruntime {
@@ -66,6 +68,53 @@ void TestConvOp(const ConvOpAndTestAttributes& attributes,
   test.Run(expect_result, err_str, excluded_providers);
 }
 
+// Runs the same convolution with float16 tensors.
+void TestConvOpFp16(const ConvOpAndTestAttributes& attributes,
+                    const vector<vector<float>>& inputs,
+                    const vector<vector<int64_t>>& input_shapes,
+                    const std::initializer_list<float>& expected_output,
+                    const vector<int64_t>& expected_output_shape,
+                    bool weight_is_initializer = false) {
+  OpTester test("Conv", 11);
+  test.AddAttribute("group", attributes.group);
+  test.AddAttribute("kernel_shape", attributes.kernel_shape);
+
+  if (!attributes.dilations.empty()) {
+    test.AddAttribute("dilations", attributes.dilations);
+  }
+
+  if (!attributes.pads.empty()) {
+    test.AddAttribute("pads", attributes.pads);
+  } else {
+    test.AddAttribute("auto_pad", attributes.auto_pad);
+  }
+
+  if (!attributes.strides.empty()) {
+    test.AddAttribute("strides", attributes.strides);
+  }
+
+  auto to_fp16 = [](const vector<float>& values) {
+    vector<MLFloat16> converted(values.size());
+    ConvertFloatToMLFloat16(values.data(), converted.data(), static_cast<int>(values.size()));
+    return converted;
+  };
+
+  ORT_ENFORCE(inputs.size() <= 3, "Our name array is only setup to handle 3 inputs");
+  const char* szNames[] = {"X", "W", "B"};
+  test.AddInput<MLFloat16>(szNames[0], input_shapes[0], to_fp16(inputs[0]));
+  test.AddInput<MLFloat16>(szNames[1], input_shapes[1], to_fp16(inputs[1]), weight_is_initializer);
+  if (inputs.size() == 3)
+    test.AddInput<MLFloat16>(szNames[2], input_shapes[2], to_fp16(inputs[2]));
+
+  test.AddOutput<MLFloat16>("Y", expected_output_shape, to_fp16(vector<float>(expected_output)));
+
+  std::unordered_set<std::string> excluded_providers(attributes.excluded_providers);
+  // TensorRT: fp16 is not supported
+  excluded_providers.insert(kTensorrtExecutionProvider);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", excluded_providers);
+}
+
 }  // namespace
 
 // Conv
@@ -193,6 +242,30 @@ TEST(ConvTest, Conv1D_Bias) {
   TestConvOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape, true);
 }
 
+TEST(ConvTest, Conv1D_Bias_Fp16) {
+  ConvOpAndTestAttributes attrs = {
+      "",                     // auto_pad
+      vector<int64_t>{2},     // dilations
+      1,                      // group
+      vector<int64_t>{1},     // kernel_shape
+      vector<int64_t>{1, 1},  // pads
+      vector<int64_t>{3},     // strides
+      {}                      // excluded EPs
+  };
+
+  vector<float> X = {0.5f, 0.25f, -0.125f, 1.0f, 2.0f, -1.0f, 0.75f, 1.5f, -0.5f,
+                     1.0f, -2.0f, 0.5f, 0.25f, -0.25f, 1.0f, 0.125f, 2.0f, 1.0f};
+  vector<int64_t> X_shape = {1, 2, 9};
+  vector<float> W = {0.5f, -1.0f};
+  vector<int64_t> W_shape = {1, 2, 1};
+  vector<float> B = {0.25f};
+  vector<int64_t> B_shape = {1};
+  vector<int64_t> Y_shape = {1, 1, 4};
+  auto expected_vals = {0.25f, -0.3125f, -1.25f, -1.0f};
+
+  TestConvOpFp16(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
+
 // Conv47
 TEST(ConvTest, Conv2D_1) {
   ConvOpAndTestAttributes attrs = {
@@ -342,6 +415,80 @@ TEST(ConvTest, Conv2D_Bias_1) {
   TestConvOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape, true);
 }
 
+TEST(ConvTest, Conv2D_Bias_1_Fp16) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      1,                            // group
+      vector<int64_t>{2, 2},        // kernel_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      {}                            // excluded EPs
+  };
+
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+  vector<int64_t> X_shape = {1, 1, 3, 3};
+  vector<float> W = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+  vector<int64_t> W_shape = {2, 1, 2, 2};
+  vector<int64_t> Y_shape = {1, 2, 2, 2};
+  vector<float> B = {1.0f, -1.0f};
+  vector<int64_t> B_shape = {2};
+  auto expected_vals = {13.0f, 17.0f, 25.0f, 29.0f, 11.0f, 15.0f, 23.0f, 27.0f};
+
+  TestConvOpFp16(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+
+  TestConvOpFp16(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape, true);
+}
+
+// Grouped pointwise convolution, which multiplies the input tensor in place.
+TEST(ConvTest, Conv2D_Group_Pointwise_Fp16) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      2,                            // group
+      vector<int64_t>{1, 1},        // kernel_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      {}                            // excluded EPs
+  };
+
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f,
+                     -1.0f, 0.5f, 2.0f, 0.0f};
+  vector<int64_t> X_shape = {1, 2, 2, 2};
+  vector<float> W = {2.0f, -1.0f};
+  vector<int64_t> W_shape = {2, 1, 1, 1};
+  vector<int64_t> Y_shape = {1, 2, 2, 2};
+  auto expected_vals = {2.0f, 4.0f, 6.0f, 8.0f, 1.0f, -0.5f, -2.0f, 0.0f};
+
+  TestConvOpFp16(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
+}
+
+// The fp16 kernel accumulates in fp32 and rounds the output once. Accumulating in fp16 would drop every 0.25 added
+// to 1024 and produce 1024 instead of 1088. The filter is an initializer, so the kernel runs on its pre-packed copy.
+TEST(ConvTest, Conv2D_Pointwise_Fp16_Accumulation) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      1,                            // group
+      vector<int64_t>{1, 1},        // kernel_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      {}                            // excluded EPs
+  };
+
+  constexpr int64_t channels = 257;
+  vector<float> X(channels * 2, 0.25f);
+  X[0] = 1024.0f;
+  X[1] = 512.0f;
+  vector<int64_t> X_shape = {1, channels, 1, 2};
+  vector<float> W(channels, 1.0f);
+  vector<int64_t> W_shape = {1, channels, 1, 1};
+  vector<int64_t> Y_shape = {1, 1, 1, 2};
+  auto expected_vals = {1088.0f, 576.0f};
+
+  TestConvOpFp16(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
+}
+
 // Conv48
 TEST(ConvTest, Conv2D_Bias_2) {
   ConvOpAndTestAttributes attrs = {
@@ -645,6 +792,86 @@ TEST(ConvTest, Conv2D_group) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+// 3x3 convolution with enough channels for MLAS to use the Winograd algorithm, with outputs large enough for the
+// F(4x4,3x3) tiles and smaller ones that use F(2x2,3x3). With kOrtSessionOptionsConfigConvWinogradPrepack, the CPU
+// kernel pre-packs the filter when it is an initializer. Otherwise it transforms the filter on each run.
+TEST(ConvTest, Conv2D_Winograd) {
+  constexpr int64_t N = 2, C = 32, M = 48;
+
+  auto run_test = [](int64_t H, int64_t W) {
+    vector<float> X(static_cast<size_t>(N * C * H * W));
+    for (size_t i = 0; i < X.size(); ++i) {
+      X[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+    }
+    vector<float> Wt(static_cast<size_t>(M * C * 3 * 3));
+    for (size_t i = 0; i < Wt.size(); ++i) {
+      Wt[i] = static_cast<float>(static_cast<int>(i % 5) - 2) / 8.0f;
+    }
+    vector<float> B(static_cast<size_t>(M));
+    for (size_t i = 0; i < B.size(); ++i) {
+      B[i] = static_cast<float>(i) / 4.0f;
+    }
+
+    // pads of 1 at the top and left only
+    const int64_t OH = H - 1, OW = W - 1;
+    vector<float> expected(static_cast<size_t>(N * M * OH * OW));
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t m = 0; m < M; ++m) {
+        for (int64_t oh = 0; oh < OH; ++oh) {
+          for (int64_t ow = 0; ow < OW; ++ow) {
+            double sum = B[m];
+            for (int64_t c = 0; c < C; ++c) {
+              for (int64_t kh = 0; kh < 3; ++kh) {
+                for (int64_t kw = 0; kw < 3; ++kw) {
+                  const int64_t ih = oh + kh - 1;
+                  const int64_t iw = ow + kw - 1;
+                  if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                    sum += static_cast<double>(X[((n * C + c) * H + ih) * W + iw]) *
+                           Wt[((m * C + c) * 3 + kh) * 3 + kw];
+                  }
+                }
+              }
+            }
+            expected[((n * M + m) * OH + oh) * OW + ow] = static_cast<float>(sum);
+          }
+        }
+      }
+    }
+
+    for (bool weight_is_initializer : {false, true}) {
+      for (bool prepack : {false, true}) {
+        OpTester test("Conv", 11);
+        test.AddAttribute("group", int64_t{1});
+        test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+        test.AddAttribute("pads", vector<int64_t>{1, 1, 0, 0});
+        test.AddInput<float>("X", {N, C, H, W}, X);
+        test.AddInput<float>("W", {M, C, 3, 3}, Wt, weight_is_initializer);
+        test.AddInput<float>("B", {M}, B, weight_is_initializer);
+        test.AddOutput<float>("Y", {N, M, OH, OW}, expected);
+        // the Winograd transforms change the order of the operations
+        test.SetOutputAbsErr("Y", 1e-3f);
+
+        SessionOptions so;
+        ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigConvWinogradPrepack,
+                                                          prepack ? "1" : "0"));
+
+        std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+        execution_providers.push_back(DefaultCpuExecutionProvider());
+        size_t number_of_pre_packed_weights = 0;
+        size_t number_of_shared_pre_packed_weights = 0;
+        test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers, {},
+                 &number_of_pre_packed_weights, &number_of_shared_pre_packed_weights);
+        EXPECT_EQ(number_of_pre_packed_weights, weight_is_initializer && prepack ? 1u : 0u);
+      }
+    }
+  };
+
+  // F(4x4,3x3)
+  run_test(10, 9);
+  // F(2x2,3x3)
+  run_test(6, 7);
+}
+
 TEST(ConvTest, ConvDimWithZero) {
   ConvOpAndTestAttributes attrs = {
       "",                           // auto_pad
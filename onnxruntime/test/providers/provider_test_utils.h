@@ -803,6 +803,10 @@ class OpTester {
     return prepacked_weights_container_.GetNumberOfElements();
   }
 
+  const PrepackedWeightsContainer& GetPrePackedWeightsShared() const {
+    return prepacked_weights_container_;
+  }
+
   bool test_allow_released_onnx_opset_only_ = true;
 
  protected:
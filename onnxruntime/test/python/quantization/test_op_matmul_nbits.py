@@ -0,0 +1,116 @@
+#!/usr/bin/env python
+# coding: utf-8
+# -------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See License.txt in the project root for
+# license information.
+# --------------------------------------------------------------------------
+
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+import onnx
+from onnx import TensorProto, helper, numpy_helper
+from op_test_utils import TestDataFeeds, check_model_correctness, check_op_type_count
+
+from onnxruntime.quantization import MatMulNBitsQuantizer
+from onnxruntime.quantization.matmul_nbits_quantizer import quantize_blockwise
+
+
+class TestOpMatMulNBits(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls._tmp_model_dir = tempfile.TemporaryDirectory(prefix="test_matmulnbits.")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls._tmp_model_dir.cleanup()
+
+    def input_feeds(self, n, name2shape):
+        input_data_list = []
+        for _i in range(n):
+            inputs = {}
+            for name, shape in name2shape.items():
+                inputs.update({name: np.random.rand(*shape).astype(np.float32)})
+            input_data_list.extend([inputs])
+        dr = TestDataFeeds(input_data_list)
+        return dr
+
+    def construct_model_matmul(self, output_model_path, k, n):
+        #    (input)
+        #       |
+        #     MatMul
+        #       |
+        #     MatMul  (second weight kept in float through nodes_to_exclude)
+        #       |
+        #    (output)
+        input_name = "input"
+        output_name = "output"
+        initializers = []
+
+        def make_matmul(input_name, weight_shape, weight_name, output_name, node_name):
+            weight_data = np.random.normal(0, 0.1, weight_shape).astype(np.float32)
+            initializers.append(numpy_helper.from_array(weight_data, name=weight_name))
+            return onnx.helper.make_node("MatMul", [input_name, weight_name], [output_name], node_name)
+
+        matmul_node_1 = make_matmul(input_name, [k, n], "linear1.weight", "matmul_output_1", "MatMul_1")
+        matmul_node_2 = make_matmul("matmul_output_1", [n, n], "linear2.weight", output_name, "MatMul_2")
+
+        input_tensor = helper.make_tensor_value_info(input_name, TensorProto.FLOAT, [-1, k])
+        output_tensor = helper.make_tensor_value_info(output_name, TensorProto.FLOAT, [-1, n])
+
+        graph = helper.make_graph(
+            [matmul_node_1, matmul_node_2], "matmul_test", [input_tensor], [output_tensor], initializer=initializers
+        )
+        model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)])
+        model.ir_version = 7  # use stable onnx ir version
+
+        onnx.save(model, output_model_path)
+
+    def quant_test(self, model_fp32_path, block_size, bits, is_symmetric):
+        model_int_path = str(
+            Path(self._tmp_model_dir.name).joinpath(f"matmul_{bits}bits_{block_size}_{is_symmetric}.onnx").absolute()
+        )
+
+        model = onnx.load(model_fp32_path)
+        quant = MatMulNBitsQuantizer(model, block_size, bits, is_symmetric, nodes_to_exclude=["MatMul_2"])
+        quant.process()
+        quant.model.save_model_to_file(model_int_path, False)
+
+        check_op_type_count(self, model_int_path, MatMulNBits=1, MatMul=1)
+
+        data_reader = self.input_feeds(1, {"input": [4, 52]})
+        check_model_correctness(self, model_fp32_path, model_int_path, data_reader.get_next(), rtol=0.05, atol=0.05)
+
+    def test_quantize_matmul_4bits(self):
+        np.random.seed(13)
+        model_fp32_path = str(Path(self._tmp_model_dir.name).joinpath("matmul_fp32.onnx").absolute())
+        self.construct_model_matmul(model_fp32_path, 52, 48)
+        for block_size in (16, 32, 64):
+            self.quant_test(model_fp32_path, block_size, 4, is_symmetric=False)
+            self.quant_test(model_fp32_path, block_size, 4, is_symmetric=True)
+
+    def test_quantize_matmul_8bits(self):
+        np.random.seed(13)
+        model_fp32_path = str(Path(self._tmp_model_dir.name).joinpath("matmul_fp32.onnx").absolute())
+        self.construct_model_matmul(model_fp32_path, 52, 48)
+        self.quant_test(model_fp32_path, 32, 8, is_symmetric=False)
+        self.quant_test(model_fp32_path, 32, 8, is_symmetric=True)
+
+    def test_quantize_blockwise_layout(self):
+        # One column with a partial block: the padding quantizes to the zero point.
+        weight = np.array([[-1.0], [0.25], [1.0]], dtype=np.float32)
+        packed, scales, zero_points = quantize_blockwise(weight, 16, 4, is_symmetric=True)
+        self.assertEqual(packed.shape, (1, 1, 8))
+        np.testing.assert_allclose(scales, [1.0 / 7.0], rtol=1e-6)
+        self.assertIsNone(zero_points)
+        # -1.0 -> 1, 0.25 -> 10, 1.0 -> 15, padding -> 8
+        self.assertEqual(packed[0, 0, 0], 1 | (10 << 4))
+        self.assertEqual(packed[0, 0, 1], 15 | (8 << 4))
+        self.assertTrue(np.all(packed[0, 0, 2:] == (8 | (8 << 4))))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -7,6 +7,7 @@
 #include <fstream>
 #include <sstream>
 #include <atomic>
+#include <future>
 #include <mutex>
 #include <algorithm>
 #include <thread>
@@ -2162,3 +2163,55 @@ TEST(CApiTest, GH_11717) {
   EXPECT_NO_THROW(Ort::Session session(*ort_env, model_path, session_options));
 }
 #endif
+
+TEST(CApiTest, RunAsync) {
+  Ort::SessionOptions session_options;
+  session_options.AddConfigEntry(kOrtSessionOptionsConfigRunAsyncThreads, "2");
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+  Ort::MemoryInfo info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+  struct Request {
+    std::vector<float> input_data;
+    Ort::Value input{nullptr};
+    Ort::Value output{nullptr};
+    std::promise<bool> succeeded;
+  };
+
+  constexpr size_t num_requests = 8;
+  std::vector<Request> requests(num_requests);
+  const std::vector<int64_t> dims{3, 2};
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::RunOptions run_options;
+
+  for (size_t i = 0; i < num_requests; ++i) {
+    auto& request = requests[i];
+    request.input_data.assign(6, static_cast<float>(i));
+    request.input = Ort::Value::CreateTensor<float>(info, request.input_data.data(), request.input_data.size(),
+                                                    dims.data(), dims.size());
+    session.RunAsync(
+        run_options, input_names, &request.input, 1, output_names, &request.output, 1,
+        [](void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status) {
+          auto* completed = reinterpret_cast<Request*>(user_data);
+          if (status != nullptr) {
+            Ort::GetApi().ReleaseStatus(status);
+            completed->succeeded.set_value(false);
+            return;
+          }
+
+          completed->succeeded.set_value(num_outputs == 1 && outputs[0] != nullptr);
+        },
+        &request);
+  }
+
+  for (size_t i = 0; i < num_requests; ++i) {
+    auto& request = requests[i];
+    ASSERT_TRUE(request.succeeded.get_future().get());
+    ASSERT_TRUE(request.output.IsTensor());
+    const float* output_data = request.output.GetTensorData<float>();
+    // mul_1 multiplies X by a constant equal to {1, 2, 3, 4, 5, 6}
+    for (size_t j = 0; j < 6; ++j) {
+      EXPECT_EQ(output_data[j], static_cast<float>(i) * (j + 1));
+    }
+  }
+}